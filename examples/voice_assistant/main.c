@@ -492,10 +492,22 @@ static void pipeline_run_voice(voice_pipeline_t* pipeline) {
       continue;
     }
 
+    // Analyze the buffer once with the stream's VAD; wake word and STT each
+    // judge the frames by their own threshold
+    const ethervox_vad_frame_t* vad_frames = NULL;
+    uint32_t vad_frame_count = 0;
+    bool have_frames = pipeline->audio.vad &&
+                       ethervox_is_success(ethervox_vad_process(pipeline->audio.vad, audio_buffer.data,
+                                                                audio_buffer.size, &vad_frames,
+                                                                &vad_frame_count));
+
     if (!conversation_active) {
       ethervox_wake_result_t wake_result = {0};
-      if (ethervox_wake_process(&pipeline->wake, &audio_buffer, &wake_result) == 0 &&
-          wake_result.detected) {
+      ethervox_result_t wake_status =
+          have_frames ? ethervox_wake_process_frames(&pipeline->wake, &audio_buffer, vad_frames,
+                                                     vad_frame_count, &wake_result)
+                      : ethervox_wake_process(&pipeline->wake, &audio_buffer, &wake_result);
+      if (wake_status == 0 && wake_result.detected) {
         printf("\n🔔 Wake word detected! Listening for speech...\n");
         ethervox_wake_reset(&pipeline->wake);
         if (!stt_session_active) {
@@ -512,7 +524,10 @@ static void pipeline_run_voice(voice_pipeline_t* pipeline) {
       }
 
       ethervox_stt_result_t stt_result = {0};
-      ethervox_result_t stt_status = ethervox_stt_process(&pipeline->stt, &audio_buffer, &stt_result);
+      ethervox_result_t stt_status =
+          have_frames ? ethervox_stt_process_frames(&pipeline->stt, &audio_buffer, vad_frames,
+                                                    vad_frame_count, &stt_result)
+                      : ethervox_stt_process(&pipeline->stt, &audio_buffer, &stt_result);
 
       if (ethervox_is_success(stt_status) && (stt_result.is_final || stt_result.is_partial)) {
         const char* transcript = stt_result.text ? stt_result.text : "";
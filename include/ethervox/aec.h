@@ -11,7 +11,9 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "ethervox/error.h"
+#include "ethervox/reference_buffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,9 +39,10 @@ typedef struct ethervox_aec_s ethervox_aec_t;
 typedef struct {
     int sample_rate;              /**< Audio sample rate (e.g., 16000 Hz) */
     int frame_size;               /**< Samples per frame (e.g., 160 = 10ms @ 16kHz) */
-    int filter_length;            /**< Echo tail length in samples (e.g., 1024 = ~64ms) */
+    int filter_length;            /**< Echo tail length in samples after delay compensation (e.g., 512 = 32ms) */
     ethervox_aec_backend_t backend; /**< AEC backend to use */
     float suppression_level;      /**< Echo suppression strength (0.0-1.0, default 0.5) */
+    int max_delay_ms;             /**< Longest reference-to-echo delay to compensate (0 = assume aligned) */
 } ethervox_aec_config_t;
 
 /**
@@ -54,16 +57,29 @@ ethervox_aec_t* ethervox_aec_create(const ethervox_aec_config_t* config);
  * Set reference signal (speaker output / TTS)
  * 
  * Call this BEFORE playing TTS audio to prime the AEC with what will be heard.
- * The reference signal is used to predict and remove echo from microphone input.
+ * The samples are queued, untimed, in the AEC's reference buffer and consumed
+ * one frame per ethervox_aec_process() call.
  * 
  * @param aec AEC context
  * @param samples Reference audio samples (speaker output)
  * @param count Number of samples
  * 
- * @note Reference signal must be time-aligned with microphone input
+ * @note Do not combine with a driver that writes the reference buffer
+ *       (ethervox_aec_get_reference()): the buffer has a single producer.
  */
 void ethervox_aec_set_reference(ethervox_aec_t* aec, const float* samples, size_t count);
 
+/**
+ * Get the AEC's far-end reference buffer
+ * 
+ * Hand this to the playback path (ethervox_audio_runtime_t::echo_reference)
+ * so it records what reaches the speaker, stamped with its playback time.
+ * 
+ * @param aec AEC context
+ * @return Reference buffer, or NULL in passthrough mode
+ */
+ethervox_reference_buffer_t* ethervox_aec_get_reference(ethervox_aec_t* aec);
+
 /**
  * Process microphone input (remove echo)
  * 
@@ -77,6 +93,37 @@ void ethervox_aec_set_reference(ethervox_aec_t* aec, const float* samples, size_
  */
 ethervox_result_t ethervox_aec_process(ethervox_aec_t* aec, float* mic_input, size_t count);
 
+/**
+ * Process microphone input captured at a known time
+ * 
+ * Pulls the reference that was playing at capture_time_us from the reference
+ * buffer, shifts it by the estimated echo delay and cancels the echo.
+ * 
+ * @param aec AEC context
+ * @param mic_input Microphone samples (will be modified in-place)
+ * @param count Number of samples (must match frame_size from config)
+ * @param capture_time_us Capture time of mic_input[0] (0 = read the reference in FIFO order)
+ * @return ETHERVOX_SUCCESS on success, error code otherwise
+ */
+ethervox_result_t ethervox_aec_process_at(ethervox_aec_t* aec, float* mic_input, size_t count,
+                                          uint64_t capture_time_us);
+
+/**
+ * Get the echo delay currently compensated
+ * 
+ * @param aec AEC context
+ * @return Delay in samples applied to the reference, or -1 until the estimator locks
+ */
+int ethervox_aec_get_delay(const ethervox_aec_t* aec);
+
+/**
+ * Get the frame size ethervox_aec_process() expects
+ * 
+ * @param aec AEC context
+ * @return Samples per frame, or 0 for a NULL context
+ */
+int ethervox_aec_get_frame_size(const ethervox_aec_t* aec);
+
 /**
  * Check if AEC is currently active (TTS playing)
  * 
@@ -44,6 +44,18 @@ typedef struct {
   uint64_t timestamp_us;
 } ethervox_audio_buffer_t;
 
+// Capture engine health (see ethervox_audio_get_capture_stats())
+typedef struct {
+  uint64_t frames_captured;    // Frames taken from the device
+  uint64_t xruns;              // Device overruns recovered (the capture thread fell behind)
+  uint64_t samples_dropped;    // Samples lost because the reader fell behind the ring
+  uint32_t max_wakeup_gap_us;  // Longest interval between capture thread transfers
+  uint32_t period_frames;      // Device period
+  uint32_t buffer_frames;      // Device buffer
+  bool realtime;               // Capture thread runs under SCHED_FIFO
+  bool mmap;                   // Device read through mmap rather than copies
+} ethervox_audio_capture_stats_t;
+
 // Language identification result
 typedef struct {
   char language_code[ETHERVOX_LANG_CODE_LEN];  // ISO 639-1 code
@@ -55,6 +67,12 @@ typedef struct {
 struct ethervox_stt_result;
 typedef struct ethervox_stt_result ethervox_stt_result_t;
 
+// Forward declarations for the runtime's processing state
+struct ethervox_vad;
+struct ethervox_ns;
+struct ethervox_audio_ring;
+struct ethervox_reference_buffer_s;
+
 // Text-to-speech request
 typedef struct {
   const char* text;
@@ -76,6 +94,8 @@ typedef struct {
   ethervox_result_t (*stop_playback)(ethervox_audio_runtime_t* runtime);
   ethervox_result_t (*read_audio)(ethervox_audio_runtime_t* runtime, ethervox_audio_buffer_t* buffer);
   ethervox_result_t (*write_audio)(ethervox_audio_runtime_t* runtime, const ethervox_audio_buffer_t* buffer);
+  ethervox_result_t (*get_capture_stats)(ethervox_audio_runtime_t* runtime,
+                                         ethervox_audio_capture_stats_t* stats);
   void (*cleanup)(ethervox_audio_runtime_t* runtime);
 } ethervox_audio_driver_t;
 
@@ -92,6 +112,25 @@ struct ethervox_audio_runtime {
   char current_language[ETHERVOX_LANG_CODE_LEN];
   float language_confidence;
 
+  // Noise suppression applied by ethervox_audio_read() ahead of the VAD
+  // (NULL unless config.enable_noise_suppression, mono only)
+  struct ethervox_ns* noise_suppressor;
+
+  // The stream's voice activity detection, for loops that read this runtime
+  // with ethervox_audio_read(): run it on the reading thread and hand its
+  // frames to ethervox_wake_process_frames()/ethervox_stt_process_frames()
+  // (ethervox_audio_record_with_vad() uses it too). NULL for multichannel capture.
+  struct ethervox_vad* vad;
+
+  // Samples queued for the speaker, for drivers that play from a ring
+  // (NULL otherwise). Poll it to wait for playback, flush it to barge in.
+  struct ethervox_audio_ring* playback_ring;
+
+  // Echo canceller reference (see ethervox_aec_get_reference()). Drivers that
+  // support it copy every block they hand to the speaker here, stamped with
+  // its playback time on the capture clock. NULL when no AEC is attached.
+  struct ethervox_reference_buffer_s* echo_reference;
+
   // Callbacks
   void (*on_audio_data)(const ethervox_audio_buffer_t* buffer, void* user_data);
   void (*on_language_detected)(const ethervox_language_detect_t* result, void* user_data);
@@ -107,6 +146,8 @@ void ethervox_audio_cleanup(ethervox_audio_runtime_t* runtime);
 ethervox_result_t ethervox_audio_start_capture(ethervox_audio_runtime_t* runtime);
 ethervox_result_t ethervox_audio_stop_capture(ethervox_audio_runtime_t* runtime);
 ethervox_result_t ethervox_audio_read(ethervox_audio_runtime_t* runtime, ethervox_audio_buffer_t* buffer);
+ethervox_result_t ethervox_audio_get_capture_stats(ethervox_audio_runtime_t* runtime,
+                                                  ethervox_audio_capture_stats_t* stats);
 
 // Speech processing functions
 ethervox_result_t ethervox_tts_synthesize(ethervox_audio_runtime_t* runtime,
@@ -131,6 +172,10 @@ float ethervox_audio_calculate_rms_energy(const float* samples, uint32_t count);
 // Platform-specific driver registration
 ethervox_result_t ethervox_audio_register_platform_driver(ethervox_audio_runtime_t* runtime);
 
+// Platform driver, or the file driver when ETHERVOX_AUDIO_DRIVER=file
+// (see ethervox/audio_file_driver.h)
+ethervox_result_t ethervox_audio_register_driver(ethervox_audio_runtime_t* runtime);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,180 @@
+/**
+ * @file audio_buffer.h
+ * @brief Wait-free single-producer/single-consumer audio ring buffer
+ *
+ * One thread writes (typically a capture or playback callback), one thread
+ * reads. Neither side ever blocks or takes a lock, so the ring is safe to
+ * use from real-time audio callbacks.
+ *
+ * Capacity is a power of two and the read/write indices are free-running
+ * 64-bit sample positions, so they double as stream positions. Producer and
+ * consumer state live on separate cache lines.
+ *
+ * Zero-copy access goes through spans: begin_write/begin_read return the
+ * free or filled region as at most two contiguous segments (the second one
+ * is the part that wrapped), and end_write/end_read publish how much of it
+ * was used. write()/read() are copying conveniences on top.
+ *
+ * Full rings drop the newest samples (the consumer owns the old ones) and
+ * count an overrun; short reads count an underrun. The producer can attach
+ * a capture timestamp to each block it commits, and the consumer gets the
+ * timestamp of any stream position back, extrapolated at the sample rate.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_AUDIO_BUFFER_H
+#define ETHERVOX_AUDIO_BUFFER_H
+
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ethervox_audio_ring ethervox_audio_ring_t;
+
+/**
+ * Contiguous view into the ring (at most two segments)
+ */
+typedef struct {
+  float* data[2];         // First segment, then the wrapped remainder (NULL if none)
+  uint32_t size[2];       // Samples in each segment
+  uint64_t position;      // Stream position of data[0][0]
+  uint64_t timestamp_us;  // Capture time of data[0][0] (0 if no timestamps were written)
+} ethervox_audio_span_t;
+
+/**
+ * Ring statistics (safe to read from any thread)
+ */
+typedef struct {
+  uint64_t written;     // Samples committed by the producer
+  uint64_t read;        // Samples consumed (including flushed ones)
+  uint64_t overruns;    // Writes that did not fit
+  uint64_t dropped;     // Samples lost to overruns
+  uint64_t underruns;   // Reads that asked for more than was queued
+  uint64_t flushed;     // Samples discarded by ethervox_audio_ring_request_flush()
+  uint32_t high_water;  // Highest fill level the producer has seen
+} ethervox_audio_ring_stats_t;
+
+/**
+ * Create a ring
+ *
+ * @param min_capacity Samples to hold; rounded up to a power of two
+ * @param sample_rate Rate used to extrapolate timestamps (0 disables them)
+ * @return Ring, or NULL if out of memory or min_capacity is 0 or above 2^30
+ */
+ethervox_audio_ring_t* ethervox_audio_ring_create(uint32_t min_capacity, uint32_t sample_rate);
+
+/**
+ * Free a ring (neither side may be using it)
+ */
+void ethervox_audio_ring_destroy(ethervox_audio_ring_t* ring);
+
+/**
+ * Empty the ring and clear its statistics (neither side may be using it)
+ */
+void ethervox_audio_ring_reset(ethervox_audio_ring_t* ring);
+
+/**
+ * Samples the ring can hold
+ */
+uint32_t ethervox_audio_ring_capacity(const ethervox_audio_ring_t* ring);
+
+// ----------------------------------------------------------------------------
+// Producer side
+// ----------------------------------------------------------------------------
+
+/**
+ * Free space, as seen by the producer
+ */
+uint32_t ethervox_audio_ring_write_space(const ethervox_audio_ring_t* ring);
+
+/**
+ * Get the free region for writing in place
+ *
+ * @param span Output: free segments; position is the next write position
+ * @return Free samples (size[0] + size[1])
+ */
+uint32_t ethervox_audio_ring_begin_write(ethervox_audio_ring_t* ring, ethervox_audio_span_t* span);
+
+/**
+ * Publish samples written into the span from ethervox_audio_ring_begin_write()
+ *
+ * @param count Samples written (clamped to the free space)
+ * @param timestamp_us Capture time of the first sample, or 0 to keep extrapolating
+ */
+void ethervox_audio_ring_end_write(ethervox_audio_ring_t* ring, uint32_t count, uint64_t timestamp_us);
+
+/**
+ * Copy samples in; whatever does not fit is dropped and counted as an overrun
+ *
+ * @return Samples written
+ */
+uint32_t ethervox_audio_ring_write(ethervox_audio_ring_t* ring, const float* samples, uint32_t count,
+                                   uint64_t timestamp_us);
+
+// ----------------------------------------------------------------------------
+// Consumer side
+// ----------------------------------------------------------------------------
+
+/**
+ * Queued samples, as seen by the consumer (a pending flush counts as read)
+ */
+uint32_t ethervox_audio_ring_available(const ethervox_audio_ring_t* ring);
+
+/**
+ * Get the queued region for reading in place
+ *
+ * @param span Output: filled segments with their stream position and timestamp
+ * @return Queued samples (size[0] + size[1])
+ */
+uint32_t ethervox_audio_ring_begin_read(ethervox_audio_ring_t* ring, ethervox_audio_span_t* span);
+
+/**
+ * Release samples consumed from the span of ethervox_audio_ring_begin_read()
+ *
+ * @param count Samples consumed (clamped to what was queued)
+ */
+void ethervox_audio_ring_end_read(ethervox_audio_ring_t* ring, uint32_t count);
+
+/**
+ * Copy up to count samples out; a short read zero-fills the rest of out
+ * and counts an underrun
+ *
+ * @param timestamp_us Output: capture time of out[0] (may be NULL)
+ * @return Samples read
+ */
+uint32_t ethervox_audio_ring_read(ethervox_audio_ring_t* ring, float* out, uint32_t count,
+                                  uint64_t* timestamp_us);
+
+// ----------------------------------------------------------------------------
+// Any thread
+// ----------------------------------------------------------------------------
+
+/**
+ * Ask the consumer to discard everything written so far (e.g. stop queued
+ * playback on barge-in). Takes effect at the consumer's next access.
+ */
+void ethervox_audio_ring_request_flush(ethervox_audio_ring_t* ring);
+
+/**
+ * Capture time of a stream position, extrapolated from the latest
+ * timestamped write at the ring's sample rate (0 if none)
+ */
+uint64_t ethervox_audio_ring_timestamp_at(const ethervox_audio_ring_t* ring, uint64_t position);
+
+/**
+ * Read the ring statistics
+ */
+ethervox_result_t ethervox_audio_ring_get_stats(const ethervox_audio_ring_t* ring,
+                                                ethervox_audio_ring_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_AUDIO_BUFFER_H
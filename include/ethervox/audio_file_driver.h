@@ -0,0 +1,90 @@
+/**
+ * @file audio_file_driver.h
+ * @brief File-backed virtual audio device for headless, reproducible runs
+ *
+ * Implements the ethervox_audio_runtime_t driver vtable without hardware:
+ * capture plays a WAV file as the microphone (or silence), and playback is
+ * written to a WAV sink (or discarded). The pipeline above it (VAD, wake
+ * word, STT, AEC, TTS playback) runs unchanged, so the full chain can be
+ * exercised on CI machines and profiled on identical input.
+ *
+ * Real-time pacing delivers capture one period at a time on the wall clock,
+ * like a device, and drains playback at the sample rate. Fast pacing hands
+ * the reader whatever it asks for at once and runs on a virtual clock
+ * derived from the sample position. Jitter (late periods) and xruns (lost
+ * periods) can be injected from a seeded generator, so a run with the same
+ * configuration is the same run.
+ *
+ * Selected at run time with ETHERVOX_AUDIO_DRIVER=file (see
+ * ethervox_audio_register_driver()); the other ETHERVOX_AUDIO_* variables
+ * listed on ethervox_audio_file_config_t override the defaults.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_AUDIO_FILE_DRIVER_H
+#define ETHERVOX_AUDIO_FILE_DRIVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ethervox/audio.h"
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  ETHERVOX_AUDIO_FILE_REALTIME = 0,  // Capture and playback advance with the wall clock
+  ETHERVOX_AUDIO_FILE_FAST,          // As fast as the pipeline consumes (virtual clock)
+} ethervox_audio_file_pacing_t;
+
+/**
+ * File driver configuration (environment override in brackets)
+ */
+typedef struct {
+  const char* capture_path;   // 16-bit PCM WAV heard as the mic (any rate), NULL = silence [ETHERVOX_AUDIO_CAPTURE_FILE]
+  const char* playback_path;  // WAV receiving everything played, NULL = discard [ETHERVOX_AUDIO_PLAYBACK_FILE]
+  ethervox_audio_file_pacing_t pacing;  // [ETHERVOX_AUDIO_PACING=realtime|fast]
+  bool loop;                  // Restart the capture file when it ends [ETHERVOX_AUDIO_LOOP]
+  uint32_t tail_silence_ms;   // Silence after the file before end of stream [ETHERVOX_AUDIO_TAIL_MS]
+  uint32_t period_ms;         // Capture/playback block [ETHERVOX_AUDIO_PERIOD_MS]
+  uint32_t jitter_us;         // Each period is up to this late (real-time pacing) [ETHERVOX_AUDIO_JITTER_US]
+  uint32_t xrun_every_ms;     // Lose one capture period per this much audio, 0 = never [ETHERVOX_AUDIO_XRUN_MS]
+  uint32_t seed;              // Jitter generator seed [ETHERVOX_AUDIO_SEED]
+} ethervox_audio_file_config_t;
+
+/**
+ * Default configuration: silence in, playback discarded, real-time pacing,
+ * 10 ms periods, one second of tail silence, no faults
+ */
+ethervox_audio_file_config_t ethervox_audio_file_default_config(void);
+
+/**
+ * Install the file driver on a runtime (instead of the platform driver)
+ *
+ * Call before driver.init(), as with ethervox_audio_register_platform_driver().
+ * The configuration is copied, including the paths.
+ *
+ * @param runtime Runtime to install on
+ * @param config Configuration, or NULL for defaults plus environment overrides
+ * @return ETHERVOX_SUCCESS, or ETHERVOX_ERROR_NOT_SUPPORTED where threads are unavailable
+ */
+ethervox_result_t ethervox_audio_register_file_driver(ethervox_audio_runtime_t* runtime,
+                                                      const ethervox_audio_file_config_t* config);
+
+/**
+ * Check whether capture has delivered the whole file and its tail silence
+ *
+ * Reads return no samples from then on. Never true when looping, or for a
+ * runtime that is not using the file driver.
+ */
+bool ethervox_audio_file_capture_finished(const ethervox_audio_runtime_t* runtime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_AUDIO_FILE_DRIVER_H
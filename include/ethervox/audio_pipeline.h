@@ -0,0 +1,245 @@
+/**
+ * @file audio_pipeline.h
+ * @brief Declarative audio front end: capture -> beamform -> resample -> AEC
+ *        -> noise suppression -> VAD -> fan-out to wake word, STT and other sinks
+ *
+ * A pipeline is described by one config struct: which stages to run, which
+ * of them get a thread of their own (optionally pinned to a CPU and run
+ * under SCHED_FIFO), and the sinks that receive the cleaned stream. Stages
+ * without a thread run inline on the thread of the stage before them; a
+ * stage with a thread is fed through a bounded wait-free queue (see
+ * ethervox/audio_buffer.h), so a slow consumer drops blocks at its own
+ * queue instead of stalling capture.
+ *
+ * Audio moves in fixed blocks of block_ms at the pipeline rate. Capture
+ * beamforms a mic array (see ethervox/beamformer.h) or downmixes other
+ * multichannel input to mono, and resamples, on the capture thread, so every
+ * queue carries whole blocks and per-block metadata (capture time, VAD
+ * verdict and frames) travels alongside the samples. The VAD stage is the
+ * stream's one VAD; sinks reuse its frames instead of analyzing again.
+ *
+ * Sinks with a process callback are called with every block (or with
+ * block_ms of audio when they have their own thread). Sinks without one
+ * are taps: the caller drains them with ethervox_pipeline_read(), which
+ * suits loops that already own a thread (e.g. a dialogue turn).
+ *
+ * The default config keeps capture, AEC, noise suppression and VAD on one
+ * real-time thread (a few hundred microseconds per 10 ms block) and gives
+ * each sink a normal-priority thread, so a stalled STT decode or an LLM
+ * saturating the other cores never delays the front end.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_AUDIO_PIPELINE_H
+#define ETHERVOX_AUDIO_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ethervox/aec.h"
+#include "ethervox/audio.h"
+#include "ethervox/beamformer.h"
+#include "ethervox/error.h"
+#include "ethervox/noise_reduction.h"
+#include "ethervox/vad.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ETHERVOX_PIPELINE_MAX_SINKS 4
+
+/**
+ * Front-end stages, in stream order
+ */
+typedef enum {
+  ETHERVOX_PIPELINE_STAGE_CAPTURE = 0,      // Driver read, downmix when not beamforming (always its own thread)
+  ETHERVOX_PIPELINE_STAGE_BEAMFORM,         // Mic array -> steered mono (runs on the capture thread)
+  ETHERVOX_PIPELINE_STAGE_RESAMPLE,         // Capture rate -> pipeline rate (runs on the capture thread)
+  ETHERVOX_PIPELINE_STAGE_AEC,              // Echo cancellation
+  ETHERVOX_PIPELINE_STAGE_NOISE_SUPPRESSION,
+  ETHERVOX_PIPELINE_STAGE_VAD,
+  ETHERVOX_PIPELINE_STAGE_COUNT
+} ethervox_pipeline_stage_t;
+
+/**
+ * Where a stage or sink runs
+ */
+typedef struct {
+  bool own_thread;  // Dedicated thread fed by a queue (else inline on the upstream thread)
+  int cpu;          // Pin the thread to this CPU (-1 = any; Linux only)
+  int rt_priority;  // SCHED_FIFO priority (0 = normal scheduling; falls back to normal if not permitted)
+} ethervox_pipeline_thread_config_t;
+
+/**
+ * Audio handed to a sink
+ */
+typedef struct {
+  ethervox_audio_buffer_t audio;  // Mono, at the pipeline rate; timestamp_us is the capture time
+  uint64_t position;              // Stream position of audio.data[0] (samples since start)
+  float speech_probability;       // Highest VAD frame probability (0 without a VAD stage)
+  bool is_speech;                 // Any block voiced or in hangover (true without a VAD stage)
+  /**
+   * Frames the VAD stage completed in this audio, end_offset counted from
+   * audio.data (NULL when none did or there is no VAD stage). Consumers
+   * apply their own threshold to each probability, e.g. through
+   * ethervox_wake_process_frames() or ethervox_stt_process_frames(); valid
+   * for the call (taps: until the next read).
+   */
+  const ethervox_vad_frame_t* vad_frames;
+  uint32_t vad_frame_count;
+} ethervox_pipeline_block_t;
+
+/**
+ * A consumer of the cleaned stream
+ */
+typedef struct {
+  const char* name;  // For logs and metrics
+  /**
+   * Called with each block, on the sink's thread (or inline on the last
+   * stage's thread). The audio belongs to the pipeline and must not be
+   * modified or kept. NULL makes the sink a tap for ethervox_pipeline_read().
+   */
+  void (*process)(const ethervox_pipeline_block_t* block, void* user_data);
+  void* user_data;
+  uint32_t block_ms;  // Audio per call, rounded down to whole blocks (0 = one block; inline sinks get one block)
+  ethervox_pipeline_thread_config_t thread;  // Taps ignore this; they are always queued
+} ethervox_pipeline_sink_config_t;
+
+/**
+ * Pipeline description
+ */
+typedef struct {
+  ethervox_audio_runtime_t* runtime;  // Initialized capture source (borrowed; started and stopped with the pipeline)
+  uint32_t sample_rate;               // Pipeline rate; other capture rates are resampled
+  uint32_t block_ms;                  // Audio per block between stages
+  uint32_t queue_ms;                  // Capacity of each queue
+
+  bool beamforming;                                // Beamform multichannel capture (mono capture has no such stage)
+  ethervox_beamformer_config_t beamformer_config;  // Array geometry, one mic per capture channel
+
+  ethervox_aec_t* aec;  // Echo canceller (borrowed; NULL = no AEC stage); block must be whole AEC frames
+  bool noise_suppression;
+  ethervox_ns_config_t ns_config;
+  bool vad;
+  ethervox_vad_config_t vad_config;
+
+  ethervox_pipeline_thread_config_t threads[ETHERVOX_PIPELINE_STAGE_COUNT];  // BEAMFORM's and RESAMPLE's are ignored
+  ethervox_pipeline_sink_config_t sinks[ETHERVOX_PIPELINE_MAX_SINKS];
+  uint32_t sink_count;
+} ethervox_pipeline_config_t;
+
+/**
+ * Per-stage (or per-sink) health, safe to read from any thread
+ */
+typedef struct {
+  uint64_t blocks;            // Blocks processed
+  uint64_t dropped;           // Blocks lost because the input queue was full
+  uint32_t avg_process_us;    // Mean processing time per call
+  uint32_t max_process_us;
+  uint32_t avg_latency_us;    // Mean time from capture to the end of this stage
+  uint32_t max_latency_us;
+  uint32_t queue_depth;       // Blocks waiting in the input queue now (0 when inline)
+  uint32_t queue_high_water;  // Most blocks ever waiting
+  bool active;                // Stage is part of this pipeline
+  bool own_thread;
+  bool realtime;              // Thread runs under SCHED_FIFO
+} ethervox_pipeline_stage_metrics_t;
+
+typedef struct {
+  ethervox_pipeline_stage_metrics_t stages[ETHERVOX_PIPELINE_STAGE_COUNT];
+  ethervox_pipeline_stage_metrics_t sinks[ETHERVOX_PIPELINE_MAX_SINKS];
+  uint32_t sink_count;
+} ethervox_pipeline_metrics_t;
+
+typedef struct ethervox_pipeline ethervox_pipeline_t;
+
+/**
+ * Default description: 16 kHz, ETHERVOX_PIPELINE_* tunables, noise
+ * suppression and VAD on, beamforming on with the default geometry for the
+ * runtime's channel count, capture under SCHED_FIFO, no sinks
+ */
+ethervox_pipeline_config_t ethervox_pipeline_default_config(ethervox_audio_runtime_t* runtime);
+
+/**
+ * Add a sink to a description
+ *
+ * @return ETHERVOX_ERROR_INVALID_ARGUMENT past ETHERVOX_PIPELINE_MAX_SINKS sinks
+ */
+ethervox_result_t ethervox_pipeline_add_sink(ethervox_pipeline_config_t* config,
+                                             const ethervox_pipeline_sink_config_t* sink);
+
+/**
+ * Build a pipeline (allocates every queue and stage; nothing runs yet)
+ *
+ * @param pipeline_out Output: the pipeline
+ */
+ethervox_result_t ethervox_pipeline_create(const ethervox_pipeline_config_t* config,
+                                           ethervox_pipeline_t** pipeline_out);
+
+/**
+ * Start capture and every thread; queues and metrics start empty
+ */
+ethervox_result_t ethervox_pipeline_start(ethervox_pipeline_t* pipeline);
+
+/**
+ * Stop capture and every thread
+ *
+ * Blocks already captured still reach every stage and threaded sink before
+ * this returns (a slow sink's last call may be short, and its queue may take
+ * a while to drain); taps keep theirs for ethervox_pipeline_read().
+ */
+ethervox_result_t ethervox_pipeline_stop(ethervox_pipeline_t* pipeline);
+
+/**
+ * Whether the pipeline is running
+ */
+bool ethervox_pipeline_is_running(const ethervox_pipeline_t* pipeline);
+
+/**
+ * Take whole blocks from a tap
+ *
+ * Waits up to timeout_ms for at least one block, then returns as many whole
+ * blocks as are queued and fit in capacity.
+ *
+ * @param sink Index of the tap in config.sinks
+ * @param samples Where the audio is copied (block->audio.data points here)
+ * @param capacity Room in samples
+ * @param block Output: the audio (size 0 on timeout) and its metadata
+ * @return ETHERVOX_ERROR_NOT_INITIALIZED once the pipeline stopped (or
+ *         capture failed) and the tap is empty
+ */
+ethervox_result_t ethervox_pipeline_read(ethervox_pipeline_t* pipeline, uint32_t sink, float* samples,
+                                         uint32_t capacity, uint32_t timeout_ms,
+                                         ethervox_pipeline_block_t* block);
+
+/**
+ * Snapshot the per-stage and per-sink metrics
+ */
+ethervox_result_t ethervox_pipeline_get_metrics(const ethervox_pipeline_t* pipeline,
+                                                ethervox_pipeline_metrics_t* metrics);
+
+/**
+ * Latest direction of arrival from the beamforming stage (safe from any thread)
+ *
+ * @return ETHERVOX_ERROR_NOT_SUPPORTED when capture is not beamformed
+ */
+ethervox_result_t ethervox_pipeline_get_doa(const ethervox_pipeline_t* pipeline, ethervox_doa_t* doa);
+
+/**
+ * Name of a stage ("capture", "beamform", "resample", "aec", "noise_suppression", "vad")
+ */
+const char* ethervox_pipeline_stage_name(ethervox_pipeline_stage_t stage);
+
+/**
+ * Stop (if running) and free a pipeline (may be NULL)
+ */
+void ethervox_pipeline_destroy(ethervox_pipeline_t* pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_AUDIO_PIPELINE_H
@@ -10,6 +10,7 @@
 #define ETHERVOX_AUDIO_RECORDING_H
 
 #include "ethervox/audio.h"
+#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "ethervox/error.h"
@@ -45,9 +46,10 @@ ethervox_result_t ethervox_audio_record_to_file(
  * 
  * @param output_path Path to output WAV file
  * @param max_duration_seconds Maximum recording duration
- * @param silence_threshold Silence detection threshold (0.0-1.0)
+ * @param silence_threshold Speech probability a VAD frame needs (0.0-1.0, other values use the default)
  * @param silence_duration_ms Duration of silence to stop recording
- * @return ETHERVOX_SUCCESS on success, error code on failure
+ * @return ETHERVOX_SUCCESS on success, ETHERVOX_ERROR_NOT_FOUND if no speech was heard,
+ *         other error code on failure
  */
 ethervox_result_t ethervox_audio_record_with_vad(
     const char* output_path,
@@ -76,6 +78,45 @@ ethervox_result_t ethervox_audio_write_wav(
     int channels
 );
 
+/**
+ * Write a 16-bit PCM WAV header
+ *
+ * For files written incrementally: write the header with data_size 0,
+ * append samples, then seek to the start and write it again with the
+ * final size.
+ *
+ * @param fp File positioned at the header
+ * @param sample_rate Sample rate in Hz
+ * @param channels Number of channels
+ * @param data_size Bytes of sample data that follow
+ * @return ETHERVOX_SUCCESS on success, error code on failure
+ */
+ethervox_result_t ethervox_audio_write_wav_header(
+    FILE* fp,
+    int sample_rate,
+    int channels,
+    uint32_t data_size
+);
+
+/**
+ * Read a 16-bit PCM WAV file
+ *
+ * @param input_path Path to WAV file
+ * @param samples_out Interleaved float samples in [-1, 1] (caller frees)
+ * @param frames_out Number of frames (samples per channel)
+ * @param sample_rate_out Sample rate in Hz
+ * @param channels_out Number of channels
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_FILE_NOT_FOUND, or
+ *         ETHERVOX_ERROR_NOT_SUPPORTED for anything but 16-bit PCM
+ */
+ethervox_result_t ethervox_audio_read_wav(
+    const char* input_path,
+    float** samples_out,
+    uint32_t* frames_out,
+    uint32_t* sample_rate_out,
+    uint16_t* channels_out
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,7 +4,8 @@
  * 
  * Provides low-latency audio playback using platform-specific APIs:
  * - macOS: CoreAudio AudioQueue
- * - Linux: ALSA (future)
+ * - Linux/Raspberry Pi: ALSA (the "default" device, which is routed through
+ *   PulseAudio or PipeWire when one is running; ETHERVOX_ALSA_PLAYBACK overrides)
  * - Windows: WASAPI (future)
  */
 
@@ -14,6 +15,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "ethervox/error.h"
+#include "ethervox/reference_buffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +63,22 @@ ethervox_result_t audio_stream_player_wait(audio_stream_player_t* player);
  */
 void audio_stream_player_stop(audio_stream_player_t* player);
 
+/**
+ * Feed everything the player sends to the speaker to an echo canceller
+ *
+ * Each block is written with its playback time (CLOCK_MONOTONIC), so the
+ * capture side can read the matching reference with
+ * ethervox_reference_buffer_read_at(). Mono players only. Must be called
+ * while the player is not started.
+ *
+ * @param player Player context
+ * @param reference Reference buffer, e.g. from ethervox_aec_get_reference() (NULL detaches)
+ * @return ETHERVOX_SUCCESS, or ETHERVOX_ERROR_NOT_SUPPORTED where playback
+ *         times are not available
+ */
+ethervox_result_t audio_stream_player_set_echo_reference(audio_stream_player_t* player,
+                                                         ethervox_reference_buffer_t* reference);
+
 /**
  * Destroy player and free resources
  * @param player Player context
@@ -119,6 +119,159 @@ extern "C" {
 #endif
 #endif
 
+// Voice activity detection (shared per capture stream, see ethervox/vad.h).
+// A frame is speech when its log-energy over the adaptive noise floor, nudged
+// by spectral tilt, gives a speech probability of at least the threshold.
+#ifndef ETHERVOX_VAD_FRAME_MS
+#define ETHERVOX_VAD_FRAME_MS 20  // Analysis frame length (10, 20 or 30)
+#endif
+
+#ifndef ETHERVOX_VAD_SPEECH_RATIO
+#define ETHERVOX_VAD_SPEECH_RATIO 3.0f  // Frame RMS over the noise floor that gives probability 0.5
+#endif
+
+#ifndef ETHERVOX_VAD_MIN_RMS
+#define ETHERVOX_VAD_MIN_RMS 0.003f  // Absolute RMS floor (keeps a silent room from triggering)
+#endif
+
+#ifndef ETHERVOX_VAD_THRESHOLD
+#define ETHERVOX_VAD_THRESHOLD 0.5f  // Speech probability for a voiced frame
+#endif
+
+#ifndef ETHERVOX_VAD_HANGOVER_MS
+#define ETHERVOX_VAD_HANGOVER_MS 200  // Speech flag held after the last voiced frame
+#endif
+
+// Noise suppression (see ethervox/noise_reduction.h): STFT Wiener filter on
+// a minimum-statistics noise estimate, run after capture/AEC and before the VAD.
+#ifndef ETHERVOX_NS_FRAME_MS
+#define ETHERVOX_NS_FRAME_MS 32  // Analysis window; rounded up to a power-of-two FFT, 50% overlap
+#endif
+
+#ifndef ETHERVOX_NS_MIN_GAIN
+#define ETHERVOX_NS_MIN_GAIN 0.1f  // Gain floor per bin (-20 dB; higher keeps more noise, less artifacts)
+#endif
+
+#ifndef ETHERVOX_NS_NOISE_WINDOW_MS
+#define ETHERVOX_NS_NOISE_WINDOW_MS 1500  // Minimum-statistics search window (longest speech the floor ignores)
+#endif
+
+// Echo cancellation (see ethervox/aec.h). The far-end reference is matched to
+// the mic by playback/capture timestamps, then a GCC-PHAT estimator removes the
+// remaining device and acoustic delay, so the adaptive filter only has to
+// cover the room's echo tail.
+#ifndef ETHERVOX_AEC_FILTER_MS
+#define ETHERVOX_AEC_FILTER_MS 32  // Adaptive filter length (echo tail after delay compensation)
+#endif
+
+#ifndef ETHERVOX_AEC_MAX_DELAY_MS
+#define ETHERVOX_AEC_MAX_DELAY_MS 320  // Longest speaker-to-mic delay searched (Bluetooth needs ~250)
+#endif
+
+#ifndef ETHERVOX_AEC_DELAY_CONFIDENCE
+#define ETHERVOX_AEC_DELAY_CONFIDENCE 6.0f  // GCC-PHAT peak over the correlation RMS needed to lock
+#endif
+
+// ALSA capture engine (Linux). A dedicated thread moves each period from the
+// device into the capture ring as soon as poll() reports it, so capture keeps
+// pace while the LLM loads every core. ETHERVOX_ALSA_PERIOD_MS and
+// ETHERVOX_ALSA_PERIODS override the first two at run time.
+#ifndef ETHERVOX_CAPTURE_PERIOD_MS
+#define ETHERVOX_CAPTURE_PERIOD_MS 10  // Device period (wakeup interval of the capture thread)
+#endif
+
+#ifndef ETHERVOX_CAPTURE_PERIODS
+#define ETHERVOX_CAPTURE_PERIODS 8  // Device buffer in periods (how long the thread may stall before an xrun)
+#endif
+
+#ifndef ETHERVOX_CAPTURE_RT_PRIORITY
+#define ETHERVOX_CAPTURE_RT_PRIORITY 70  // SCHED_FIFO priority of the capture thread (0 = normal scheduling)
+#endif
+
+// Streaming playback (see ethervox/audio_stream_player.h). The device buffer
+// is kept to a few short periods so the first TTS chunk is heard quickly.
+#ifndef ETHERVOX_PLAYBACK_PERIOD_MS
+#define ETHERVOX_PLAYBACK_PERIOD_MS 10  // Samples handed to the device per write
+#endif
+
+#ifndef ETHERVOX_PLAYBACK_PERIODS
+#define ETHERVOX_PLAYBACK_PERIODS 4  // Device buffer length in periods (underrun headroom)
+#endif
+
+#ifndef ETHERVOX_PLAYBACK_QUEUE_MS
+#define ETHERVOX_PLAYBACK_QUEUE_MS 10000  // Synthesized audio queued ahead of the device before write() blocks
+#endif
+
+// Polyphase resampler (see ethervox/dsp.h). Taps grow with the decimation
+// factor so the anti-alias transition band stays the same width.
+#ifndef ETHERVOX_DSP_RESAMPLE_TAPS
+#define ETHERVOX_DSP_RESAMPLE_TAPS 24  // FIR taps per output sample when not decimating
+#endif
+
+#ifndef ETHERVOX_DSP_MAX_RESAMPLE_PHASES
+#define ETHERVOX_DSP_MAX_RESAMPLE_PHASES 1024  // Largest reduced interpolation factor (44100 -> 16000 needs 160)
+#endif
+
+// Audio front-end pipeline (see ethervox/audio_pipeline.h). Sink queues are
+// long enough to ride out a Whisper decode without dropping audio.
+#ifndef ETHERVOX_PIPELINE_BLOCK_MS
+#define ETHERVOX_PIPELINE_BLOCK_MS 10  // Audio per block between stages (a whole number of AEC and VAD frames)
+#endif
+
+#ifndef ETHERVOX_PIPELINE_QUEUE_MS
+#define ETHERVOX_PIPELINE_QUEUE_MS 10000  // Capacity of each stage and sink queue
+#endif
+
+#ifndef ETHERVOX_PIPELINE_RT_PRIORITY
+#define ETHERVOX_PIPELINE_RT_PRIORITY 60  // SCHED_FIFO priority of the front-end thread (below the capture driver's)
+#endif
+
+// Mic-array beamforming (see ethervox/beamformer.h). The default geometry
+// matches 4- and 6-mic circular HATs; set the real one for other arrays.
+#ifndef ETHERVOX_BEAMFORMER_ARRAY_RADIUS_M
+#define ETHERVOX_BEAMFORMER_ARRAY_RADIUS_M 0.0325f  // Default circular array radius (3+ mics)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_MIC_SPACING_M
+#define ETHERVOX_BEAMFORMER_MIC_SPACING_M 0.058f  // Default linear array spacing (2 mics)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_SPEED_OF_SOUND
+#define ETHERVOX_BEAMFORMER_SPEED_OF_SOUND 343.0f  // m/s at 20 C
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_FRAME_MS
+#define ETHERVOX_BEAMFORMER_FRAME_MS 32  // DOA/MVDR analysis window; rounded up to a power-of-two FFT
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_TAPS
+#define ETHERVOX_BEAMFORMER_TAPS 16  // Fractional-delay filter length (even)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_FRACTIONS
+#define ETHERVOX_BEAMFORMER_FRACTIONS 32  // Sub-sample delay steps in the filter bank
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_DOA_STEP_DEG
+#define ETHERVOX_BEAMFORMER_DOA_STEP_DEG 5.0f  // Azimuth grid resolution (peaks are refined between points)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_DOA_MIN_HZ
+#define ETHERVOX_BEAMFORMER_DOA_MIN_HZ 300.0f  // SRP-PHAT band (small arrays cannot resolve lower)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_DOA_MAX_HZ
+#define ETHERVOX_BEAMFORMER_DOA_MAX_HZ 4000.0f  // SRP-PHAT band (spatial aliasing above)
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_MIN_CONFIDENCE
+#define ETHERVOX_BEAMFORMER_MIN_CONFIDENCE 0.15f  // SRP-PHAT map contrast needed to re-steer
+#endif
+
+#ifndef ETHERVOX_BEAMFORMER_MVDR_LOADING
+#define ETHERVOX_BEAMFORMER_MVDR_LOADING 0.1f  // MVDR diagonal loading (higher = closer to delay and sum)
+#endif
+
 #ifndef ETHERVOX_MAX_PLUGINS
 #ifdef ETHERVOX_PLATFORM_EMBEDDED
 #define ETHERVOX_MAX_PLUGINS 8
@@ -221,6 +374,12 @@ extern "C" {
 // Exceeding 8 causes error -4. Recommended: 5 (good accuracy/speed balance)
 #endif
 
+// Decoder threads for streaming STT (0 = whisper.cpp default, min(4, cores));
+// measure per device tier with tests/benchmark_stt --threads
+#ifndef ETHERVOX_WHISPER_THREADS
+#define ETHERVOX_WHISPER_THREADS 0
+#endif
+
 // Quality thresholds - TUNED FOR SPEECH DETECTION
 #ifndef ETHERVOX_WHISPER_NO_SPEECH_THRESHOLD
 #define ETHERVOX_WHISPER_NO_SPEECH_THRESHOLD 0.55f  // Moderate filtering (0.5 too loose, 0.6 too strict)
@@ -264,25 +423,128 @@ extern "C" {
 #define ETHERVOX_WHISPER_OVERLAP_SIZE 3200  // 200ms at 16kHz
 #endif
 
+// Endpoint-driven chunking: the frame VAD (ETHERVOX_VAD_*) opens an utterance
+// on speech and decodes it once trailing silence is seen, instead of waiting
+// for fixed 3-second chunks. Set to 0 for time-based chunking (stream.cpp style).
+#ifndef ETHERVOX_WHISPER_ENDPOINT_MODE
+#define ETHERVOX_WHISPER_ENDPOINT_MODE 1
+#endif
+
+#ifndef ETHERVOX_WHISPER_VAD_START_MS
+#define ETHERVOX_WHISPER_VAD_START_MS 60  // Consecutive speech needed to open an utterance
+#endif
+
+#ifndef ETHERVOX_WHISPER_VAD_END_SILENCE_MS
+#define ETHERVOX_WHISPER_VAD_END_SILENCE_MS 500  // Trailing silence that ends an utterance
+#endif
+
+#ifndef ETHERVOX_WHISPER_VAD_MIN_SPEECH_MS
+#define ETHERVOX_WHISPER_VAD_MIN_SPEECH_MS 150  // Shorter bursts (clicks, coughs) are dropped undecoded
+#endif
+
+#ifndef ETHERVOX_WHISPER_VAD_PAD_MS
+#define ETHERVOX_WHISPER_VAD_PAD_MS 200  // Audio kept before speech start and after speech end
+#endif
+
+#ifndef ETHERVOX_WHISPER_MAX_UTTERANCE_MS
+#define ETHERVOX_WHISPER_MAX_UTTERANCE_MS 10000  // Decode mid-speech after this long (capped by the 10s buffer)
+#endif
+
+// Language identification in auto mode (whisper_lang_auto_detect on the chunk's mel)
+#ifndef ETHERVOX_WHISPER_LANG_REDETECT_INTERVAL
+#define ETHERVOX_WHISPER_LANG_REDETECT_INTERVAL 8  // Re-check every N chunks within a speaker turn (0 = turns only)
+#endif
+
+#ifndef ETHERVOX_WHISPER_LANG_SWITCH_MARGIN
+#define ETHERVOX_WHISPER_LANG_SWITCH_MARGIN 0.2f  // Probability lead a new language needs over the cached one
+#endif
+
+// Context carry: the previous chunk's final text tokens are passed to the
+// decoder as prompt_tokens instead of re-decoding an audio overlap
+#ifndef ETHERVOX_WHISPER_CONTEXT_CARRY
+#define ETHERVOX_WHISPER_CONTEXT_CARRY 1  // 0 = no_context with the audio overlap only
+#endif
+
+#ifndef ETHERVOX_WHISPER_PROMPT_MAX_TOKENS
+#define ETHERVOX_WHISPER_PROMPT_MAX_TOKENS 64  // Carried tokens (whisper allows up to n_text_ctx/2)
+#endif
+
+#ifndef ETHERVOX_WHISPER_CARRY_OVERLAP_MS
+#define ETHERVOX_WHISPER_CARRY_OVERLAP_MS 0  // Audio overlap kept alongside the token carry
+#endif
+
+// Hallucination guards for carried context (output failing them is re-decoded without the carry)
+#ifndef ETHERVOX_WHISPER_MAX_COMPRESSION_RATIO
+#define ETHERVOX_WHISPER_MAX_COMPRESSION_RATIO 2.4f  // Highly compressible text = repetition loop
+#endif
+
+#ifndef ETHERVOX_WHISPER_MAX_PHRASE_REPEATS
+#define ETHERVOX_WHISPER_MAX_PHRASE_REPEATS 4  // Same token phrase back-to-back this often = loop
+#endif
+
+// Offline file transcription: recordings are split at silences and the
+// segments decoded concurrently on whisper_states sharing one model
+#ifndef ETHERVOX_WHISPER_OFFLINE_MAX_SEGMENT_MS
+#define ETHERVOX_WHISPER_OFFLINE_MAX_SEGMENT_MS 28000  // Pack speech up to one 30 s encoder window
+#endif
+
+#ifndef ETHERVOX_WHISPER_OFFLINE_MIN_SILENCE_MS
+#define ETHERVOX_WHISPER_OFFLINE_MIN_SILENCE_MS 300  // Shortest pause that may separate segments
+#endif
+
+#ifndef ETHERVOX_WHISPER_OFFLINE_THREADS_PER_WORKER
+#define ETHERVOX_WHISPER_OFFLINE_THREADS_PER_WORKER 4  // Compute threads per whisper_state
+#endif
+
+// Shared STT model registry: sessions over the same model path share one
+// loaded model; an unreferenced model is kept this long for reuse
+#ifndef ETHERVOX_STT_MODEL_IDLE_EVICT_MS
+#define ETHERVOX_STT_MODEL_IDLE_EVICT_MS 120000  // 0 = free as soon as the last session ends
+#endif
+
+// Cascaded STT: a larger Whisper model re-decodes each final utterance from
+// the streaming first pass (config.rescore_model_path)
+#ifndef ETHERVOX_STT_RESCORE_WAIT_MS
+#define ETHERVOX_STT_RESCORE_WAIT_MS 1500  // Default wait for rescored text (-1 = always, 0 = never)
+#endif
+#ifndef ETHERVOX_STT_RESCORE_MAX_UTTERANCE_MS
+#define ETHERVOX_STT_RESCORE_MAX_UTTERANCE_MS 30000  // Longest window re-decoded (one Whisper window)
+#endif
+
 // ===========================================================================
 // Speaker Detection Configuration
 // ===========================================================================
 
-// Acoustic feature thresholds for speaker change detection
-#ifndef ETHERVOX_SPEAKER_ENERGY_CHANGE_THRESHOLD
-#define ETHERVOX_SPEAKER_ENERGY_CHANGE_THRESHOLD 0.5f  // Raised from 0.3 to 50% change (less sensitive)
+// Diarization: each transcript segment is embedded (mean MFCCs + YIN pitch)
+// and clustered online against the speakers heard so far. Distances are in
+// units of the session's frame-level feature spread.
+#ifndef ETHERVOX_SPEAKER_NEW_THRESHOLD
+#define ETHERVOX_SPEAKER_NEW_THRESHOLD 0.5f  // Farther than this from every speaker = new speaker
+#endif
+
+#ifndef ETHERVOX_SPEAKER_MERGE_THRESHOLD
+#define ETHERVOX_SPEAKER_MERGE_THRESHOLD 0.35f  // Speakers whose centroids drift this close are merged
+#endif
+
+#ifndef ETHERVOX_SPEAKER_MIN_SPEECH_MS
+#define ETHERVOX_SPEAKER_MIN_SPEECH_MS 300  // Shorter segments keep the current speaker
+#endif
+
+// YIN pitch tracker
+#ifndef ETHERVOX_SPEAKER_F0_MIN
+#define ETHERVOX_SPEAKER_F0_MIN 60  // Hz
 #endif
 
-#ifndef ETHERVOX_SPEAKER_PITCH_CHANGE_THRESHOLD
-#define ETHERVOX_SPEAKER_PITCH_CHANGE_THRESHOLD 0.20f  // Raised from 0.12 to 20% change (less sensitive)
+#ifndef ETHERVOX_SPEAKER_F0_MAX
+#define ETHERVOX_SPEAKER_F0_MAX 400  // Hz
 #endif
 
-#ifndef ETHERVOX_SPEAKER_PAUSE_THRESHOLD
-#define ETHERVOX_SPEAKER_PAUSE_THRESHOLD 50  // 500ms pause (in 10ms units)
+#ifndef ETHERVOX_SPEAKER_YIN_WINDOW
+#define ETHERVOX_SPEAKER_YIN_WINDOW 256  // Integration window (samples)
 #endif
 
-#ifndef ETHERVOX_SPEAKER_CHANGE_MIN_FACTORS
-#define ETHERVOX_SPEAKER_CHANGE_MIN_FACTORS 2  // Minimum factors required to confirm speaker change
+#ifndef ETHERVOX_SPEAKER_YIN_THRESHOLD
+#define ETHERVOX_SPEAKER_YIN_THRESHOLD 0.15f  // CMNDF dip that counts as periodic
 #endif
 
 // Maximum speakers to track in a session
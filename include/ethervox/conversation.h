@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "ethervox/error.h"
+#include "ethervox/stt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +53,8 @@ typedef struct {
     uint32_t sample_rate;              // Audio sample rate (16000 Hz typical)
     uint32_t max_alternatives;         // Number of recognition alternatives
     bool partial_results;              // Get interim results while speaking
+    const char* grammar;               // Command mode: listen on Vosk for these phrases only
+                                       // (see ethervox_tool_build_trigger_grammar); NULL = Whisper
 } ethervox_vosk_config_t;
 
 /**
@@ -78,6 +81,11 @@ typedef struct {
     bool enable_beep_on_wake;          // Play feedback when wake word detected
     bool enable_beep_on_listen_end;    // Play feedback when listening ends
     bool always_listening;             // Continuously transcribe without wake word (desktop mode)
+    
+    // Streaming transcript hook, e.g. to start prefilling the prompt before
+    // the user finishes speaking. Runs on the conversation thread.
+    ethervox_stt_partial_callback_t on_partial_transcript;
+    void* transcript_user_data;
 } ethervox_conversation_config_t;
 
 /**
@@ -199,6 +207,16 @@ void* ethervox_conversation_get_tts(ethervox_conversation_session_t* session);
  */
 void* ethervox_conversation_get_stt(ethervox_conversation_session_t* session);
 
+/**
+ * @brief Get the echo canceller from conversation session
+ * 
+ * For attaching other players' output as its echo reference.
+ * 
+ * @param session Conversation session
+ * @return AEC context (ethervox_aec_t, cast to void*) or NULL if AEC is disabled
+ */
+void* ethervox_conversation_get_aec(ethervox_conversation_session_t* session);
+
 #ifdef __cplusplus
 }
 #endif
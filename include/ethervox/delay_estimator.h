@@ -0,0 +1,100 @@
+/**
+ * @file delay_estimator.h
+ * @brief GCC-PHAT estimator of the far-end to microphone delay
+ *
+ * Finds how far the echo in the microphone signal lags the far-end reference
+ * (playback buffering, USB/Bluetooth latency and the acoustic path) so the
+ * echo canceller can be fed a reference that lines up with the echo.
+ *
+ * The reference and mic streams are cut into blocks; each block's
+ * cross-spectrum is accumulated with exponential smoothing while the far
+ * end is active, whitened (phase transform) and transformed back to a
+ * cross-correlation whose peak is the delay. A delay is reported once the
+ * peak stands clear of the correlation floor on two consecutive blocks.
+ */
+
+#ifndef ETHERVOX_DELAY_ESTIMATOR_H
+#define ETHERVOX_DELAY_ESTIMATOR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Opaque delay estimator
+ */
+typedef struct ethervox_delay_estimator_s ethervox_delay_estimator_t;
+
+/**
+ * Delay estimator configuration
+ */
+typedef struct {
+    uint32_t sample_rate;     /**< Sample rate of both streams */
+    uint32_t max_delay_ms;    /**< Longest delay searched (sets the block size) */
+    float smoothing;          /**< Cross-spectrum smoothing per block (0-1, higher is steadier) */
+    float min_confidence;     /**< Correlation peak over RMS floor needed to report a delay */
+    float min_reference_rms;  /**< Reference blocks quieter than this are not analysed */
+} ethervox_delay_estimator_config_t;
+
+/**
+ * Get default configuration (ETHERVOX_AUDIO_SAMPLE_RATE, ETHERVOX_AEC_MAX_DELAY_MS)
+ */
+ethervox_delay_estimator_config_t ethervox_delay_estimator_default_config(void);
+
+/**
+ * Create a delay estimator
+ *
+ * @param config Configuration (NULL for defaults)
+ * @return Estimator, or NULL on invalid configuration or allocation failure
+ */
+ethervox_delay_estimator_t* ethervox_delay_estimator_create(const ethervox_delay_estimator_config_t* config);
+
+/**
+ * Feed time-matched reference and microphone samples
+ *
+ * @param reference Far-end samples
+ * @param mic Microphone samples captured over the same interval
+ * @param count Samples in each
+ * @return true if the reported delay changed
+ */
+bool ethervox_delay_estimator_process(ethervox_delay_estimator_t* estimator,
+                                      const float* reference,
+                                      const float* mic,
+                                      size_t count);
+
+/**
+ * Current delay estimate in samples (mic lags reference), or -1 before lock
+ */
+int ethervox_delay_estimator_get_delay(const ethervox_delay_estimator_t* estimator);
+
+/**
+ * Peak-over-floor ratio of the latest analysed block (0 before the first)
+ */
+float ethervox_delay_estimator_get_confidence(const ethervox_delay_estimator_t* estimator);
+
+/**
+ * Samples per analysis block (how often the estimate can change)
+ */
+size_t ethervox_delay_estimator_block_size(const ethervox_delay_estimator_t* estimator);
+
+/**
+ * Forget the accumulated spectrum and the current estimate
+ */
+void ethervox_delay_estimator_reset(ethervox_delay_estimator_t* estimator);
+
+/**
+ * Destroy a delay estimator
+ *
+ * @param estimator Estimator (may be NULL)
+ */
+void ethervox_delay_estimator_destroy(ethervox_delay_estimator_t* estimator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ETHERVOX_DELAY_ESTIMATOR_H
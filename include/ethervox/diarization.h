@@ -0,0 +1,124 @@
+/**
+ * @file diarization.h
+ * @brief Speaker diarization for transcripts
+ *
+ * Frame features (MFCCs and a YIN F0 track) are computed on a worker thread
+ * while the STT decodes the same audio; once the decoder has produced
+ * segments, each segment is pooled into a speaker embedding and clustered
+ * online against the speakers heard so far. Speaker IDs are stable across
+ * the session, so a speaker who returns gets their earlier label back.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_DIARIZATION_H
+#define ETHERVOX_DIARIZATION_H
+
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ETHERVOX_DIARIZER_MFCC_COUNT 12  // Cepstra c1..c12 (c0/loudness is left out)
+#define ETHERVOX_DIARIZER_NEW_SPEAKER (-2)  // ethervox_diarizer_identify(): a voice not heard yet
+
+typedef struct ethervox_diarizer ethervox_diarizer_t;
+
+/**
+ * Segment speaker embedding
+ */
+typedef struct {
+  float mfcc[ETHERVOX_DIARIZER_MFCC_COUNT];  // Mean cepstrum over speech frames
+  float log_f0;                              // Median log F0 of voiced frames (0 = unvoiced)
+  uint32_t speech_frames;                    // Frames that passed the energy gate
+  uint32_t voiced_frames;                    // Speech frames with a YIN pitch
+} ethervox_speaker_embedding_t;
+
+/**
+ * Create a diarizer (16 kHz mono audio)
+ *
+ * @param max_speakers Speakers to distinguish before new voices join the nearest one
+ * @return Diarizer, or NULL if out of memory or the worker could not start
+ */
+ethervox_diarizer_t* ethervox_diarizer_create(uint32_t max_speakers);
+
+/**
+ * Stop the worker and free the diarizer
+ */
+void ethervox_diarizer_destroy(ethervox_diarizer_t* diarizer);
+
+/**
+ * Forget all speakers (new session)
+ */
+void ethervox_diarizer_reset(ethervox_diarizer_t* diarizer);
+
+/**
+ * Start feature extraction for a chunk of audio in the background
+ *
+ * The audio is copied, so the caller can decode the same buffer meanwhile.
+ * A previous chunk still being analyzed is finished first.
+ */
+ethervox_result_t ethervox_diarizer_submit(ethervox_diarizer_t* diarizer, const float* samples,
+                                           uint32_t sample_count);
+
+/**
+ * Pool the submitted chunk's frames in [start, end) into an embedding
+ *
+ * Waits for the background analysis if it is still running.
+ *
+ * @return ETHERVOX_SUCCESS, or ETHERVOX_ERROR_NOT_FOUND if the span holds
+ *         too little speech for a reliable embedding
+ */
+ethervox_result_t ethervox_diarizer_embed(ethervox_diarizer_t* diarizer, uint32_t start, uint32_t end,
+                                          ethervox_speaker_embedding_t* embedding);
+
+/**
+ * Assign the speaker of samples [start, end) of the submitted chunk
+ *
+ * The segment joins the closest known speaker or, if no speaker is close
+ * enough, starts a new one; speakers that drift together are merged.
+ *
+ * @return Speaker ID (0-based), or -1 if the span holds too little speech
+ */
+int ethervox_diarizer_assign(ethervox_diarizer_t* diarizer, uint32_t start, uint32_t end);
+
+/**
+ * Speaker of samples [start, end) of the submitted chunk, without adding
+ * the span to any speaker
+ *
+ * For decisions that must be made before the chunk is segmented (e.g.
+ * whether a new speaker turn needs its language re-identified).
+ *
+ * @return Speaker ID, ETHERVOX_DIARIZER_NEW_SPEAKER if no known speaker is
+ *         close enough, or -1 if the span holds too little speech
+ */
+int ethervox_diarizer_identify(ethervox_diarizer_t* diarizer, uint32_t start, uint32_t end);
+
+/**
+ * Distance between two embeddings under the session's feature scale
+ */
+float ethervox_diarizer_distance(const ethervox_diarizer_t* diarizer, const ethervox_speaker_embedding_t* a,
+                                 const ethervox_speaker_embedding_t* b);
+
+/**
+ * Number of distinct speakers heard so far
+ */
+uint32_t ethervox_diarizer_speaker_count(const ethervox_diarizer_t* diarizer);
+
+/**
+ * YIN fundamental frequency of one analysis window
+ *
+ * @param window At least ETHERVOX_SPEAKER_YIN_WINDOW + 16000 / ETHERVOX_SPEAKER_F0_MIN samples
+ * @return F0 in Hz, or 0 if the window is unvoiced
+ */
+float ethervox_diarizer_yin_f0(const float* window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_DIARIZATION_H
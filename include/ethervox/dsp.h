@@ -0,0 +1,199 @@
+/**
+ * @file dsp.h
+ * @brief Sample-format conversion, mixing, resampling and FFT kernels
+ *
+ * The per-sample inner loops of the audio path: S16 <-> float conversion,
+ * gain, mixing, downmix, rate conversion and FFT butterflies. Each has a
+ * scalar version and SSE2, AVX2 and NEON versions; the best one the CPU
+ * supports is picked on first use (AVX2 is checked at run time, so one
+ * x86-64 binary uses it where present and still runs where it is not).
+ *
+ * Float samples are in [-1, 1). S16 -> float divides by 32768; float -> S16
+ * clamps to [-1, 1], multiplies by 32767 and truncates, so values saturate
+ * instead of wrapping and every ISA produces identical integers.
+ *
+ * The resampler is a streaming polyphase FIR for rational ratios (e.g.
+ * 48000 -> 16000 is 1/3, 44100 -> 16000 is 160/441), so a 44.1/48 kHz mic or
+ * 22.05 kHz TTS voice can be brought to the 16 kHz pipeline rate block by
+ * block with no clicks at block edges. It never allocates after creation.
+ *
+ * The FFT is the one transform shared by AEC delay estimation, noise
+ * suppression, beamforming and diarization: radix-2 on split real and
+ * imaginary arrays, complex or real input, in place, with no allocation
+ * after creation.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_DSP_H
+#define ETHERVOX_DSP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  ETHERVOX_DSP_ISA_SCALAR = 0,
+  ETHERVOX_DSP_ISA_SSE2,
+  ETHERVOX_DSP_ISA_AVX2,
+  ETHERVOX_DSP_ISA_NEON,
+} ethervox_dsp_isa_t;
+
+/**
+ * Instruction set the kernels are currently using
+ */
+ethervox_dsp_isa_t ethervox_dsp_get_isa(void);
+
+/**
+ * Name of an instruction set ("scalar", "sse2", "avx2", "neon")
+ */
+const char* ethervox_dsp_isa_name(ethervox_dsp_isa_t isa);
+
+/**
+ * Switch the kernels to another instruction set (tests and benchmarks)
+ *
+ * Not synchronized with kernels running on other threads; switch before
+ * the audio threads start.
+ *
+ * @return ETHERVOX_ERROR_NOT_SUPPORTED if this CPU or build lacks it
+ */
+ethervox_result_t ethervox_dsp_set_isa(ethervox_dsp_isa_t isa);
+
+// ----------------------------------------------------------------------------
+// Conversion and mixing (in and out may not overlap unless stated)
+// ----------------------------------------------------------------------------
+
+/**
+ * S16 to float in [-1, 1)
+ */
+void ethervox_dsp_s16_to_float(const int16_t* in, float* out, size_t count);
+
+/**
+ * Float to S16, saturating
+ */
+void ethervox_dsp_float_to_s16(const float* in, int16_t* out, size_t count);
+
+/**
+ * samples *= gain (in place)
+ */
+void ethervox_dsp_gain(float* samples, size_t count, float gain);
+
+/**
+ * dst += src * gain
+ */
+void ethervox_dsp_mix(float* dst, const float* src, size_t count, float gain);
+
+/**
+ * Average interleaved channels to mono (out may equal in)
+ *
+ * @param frames Frames (samples per channel)
+ */
+void ethervox_dsp_downmix(const float* in, float* out, size_t frames, uint32_t channels);
+
+// ----------------------------------------------------------------------------
+// Resampler
+// ----------------------------------------------------------------------------
+
+typedef struct ethervox_resampler ethervox_resampler_t;
+
+/**
+ * Create a mono resampler
+ *
+ * @param in_rate Input rate in Hz
+ * @param out_rate Output rate in Hz
+ * @param max_input Most samples passed to one process() call
+ * @return Resampler, or NULL if the reduced ratio needs more than
+ *         ETHERVOX_DSP_MAX_RESAMPLE_PHASES filter phases, or out of memory
+ */
+ethervox_resampler_t* ethervox_resampler_create(uint32_t in_rate, uint32_t out_rate, size_t max_input);
+
+/**
+ * Largest output process() can produce for count input samples
+ */
+size_t ethervox_resampler_max_output(const ethervox_resampler_t* resampler, size_t count);
+
+/**
+ * Convert a block; all input is consumed
+ *
+ * @param in Input samples (at most max_input)
+ * @param out Output, with room for ethervox_resampler_max_output(count)
+ * @return Samples written to out
+ */
+size_t ethervox_resampler_process(ethervox_resampler_t* resampler, const float* in, size_t count, float* out);
+
+/**
+ * Input samples of delay the filter adds
+ */
+uint32_t ethervox_resampler_latency(const ethervox_resampler_t* resampler);
+
+/**
+ * Forget the stream history (start of a new, unrelated stream)
+ */
+void ethervox_resampler_reset(ethervox_resampler_t* resampler);
+
+/**
+ * Free a resampler (may be NULL)
+ */
+void ethervox_resampler_destroy(ethervox_resampler_t* resampler);
+
+// ----------------------------------------------------------------------------
+// FFT
+// ----------------------------------------------------------------------------
+
+typedef struct ethervox_fft ethervox_fft_t;
+
+/**
+ * Create tables for size-point transforms
+ *
+ * The tables are read-only once built, so one instance may be used from
+ * several threads at once.
+ *
+ * @param size Power of two, at least 4
+ * @return FFT, or NULL for an invalid size or out of memory
+ */
+ethervox_fft_t* ethervox_fft_create(uint32_t size);
+
+/**
+ * Transform length the FFT was created for
+ */
+uint32_t ethervox_fft_size(const ethervox_fft_t* fft);
+
+/**
+ * In-place complex FFT of size points in natural order
+ *
+ * The inverse is unscaled: inverse(forward(x)) == size * x.
+ */
+void ethervox_fft_complex(const ethervox_fft_t* fft, float* re, float* im, bool inverse);
+
+/**
+ * FFT of size real samples into bins 0..size/2
+ *
+ * @param re, im Output spectrum, size/2 + 1 entries each (not aliasing in)
+ */
+void ethervox_fft_real_forward(const ethervox_fft_t* fft, const float* in, float* re, float* im);
+
+/**
+ * Inverse of ethervox_fft_real_forward(), scaled so the round trip is exact
+ *
+ * @param re, im Spectrum, bins 0..size/2; overwritten as scratch
+ * @param out size real samples
+ */
+void ethervox_fft_real_inverse(const ethervox_fft_t* fft, float* re, float* im, float* out);
+
+/**
+ * Free an FFT (may be NULL)
+ */
+void ethervox_fft_destroy(ethervox_fft_t* fft);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_DSP_H
@@ -27,17 +27,68 @@ extern "C" {
 #define ETHERVOX_MEMORY_MAX_TAGS 16
 #define ETHERVOX_MEMORY_TAG_LEN 64
 #define ETHERVOX_MEMORY_MAX_ENTRIES 10000
-#define ETHERVOX_MEMORY_INDEX_BUCKETS 256
-#define ETHERVOX_MEMORY_HASH_BUCKETS 128
-#define ETHERVOX_MEMORY_MAX_BUCKET_SIZE 64
+
+// Tag bitmap containers switch from a sorted array to a bitset above this size
+#ifndef ETHERVOX_MEMORY_BITMAP_ARRAY_MAX
+#define ETHERVOX_MEMORY_BITMAP_ARRAY_MAX 4096
+#endif
+
+// Search recency decay: an entry this many seconds older than the newest
+// memory scores half the recency of the newest one
+#ifndef ETHERVOX_MEMORY_RECENCY_HALF_LIFE_S
+#define ETHERVOX_MEMORY_RECENCY_HALF_LIFE_S (7 * 24 * 3600)
+#endif
+
+// Share of text-query relevance taken by recency (the rest is similarity/importance)
+#ifndef ETHERVOX_MEMORY_RECENCY_QUERY_WEIGHT
+#define ETHERVOX_MEMORY_RECENCY_QUERY_WEIGHT 0.15f
+#endif
+
+// Near-duplicate detection: MinHash signature size and LSH banding
+// (ETHERVOX_MEMORY_MINHASH_SIZE must be a multiple of ETHERVOX_MEMORY_LSH_BANDS)
+#define ETHERVOX_MEMORY_MINHASH_SIZE 30
+#define ETHERVOX_MEMORY_LSH_BANDS 10
+
+// Jaccard similarity (word unigrams + bigrams) at which a new memory counts as a duplicate
+#ifndef ETHERVOX_MEMORY_DEDUP_THRESHOLD
+#define ETHERVOX_MEMORY_DEDUP_THRESHOLD 0.7f
+#endif
+
+// Importance added to an existing memory each time a duplicate is merged into it
+#ifndef ETHERVOX_MEMORY_DEDUP_IMPORTANCE_BOOST
+#define ETHERVOX_MEMORY_DEDUP_IMPORTANCE_BOOST 0.05f
+#endif
+
+#ifndef ETHERVOX_MEMORY_DEDUP_DEFAULT_MODE
+#define ETHERVOX_MEMORY_DEDUP_DEFAULT_MODE ETHERVOX_MEMORY_DEDUP_MERGE
+#endif
+
+// Verbatim logs (transcripts, summaries) and time-keyed entries (reminders that
+// differ only in their time or date, completed ones) are never deduplicated
+#ifndef ETHERVOX_MEMORY_DEDUP_EXEMPT_TAGS
+#define ETHERVOX_MEMORY_DEDUP_EXEMPT_TAGS \
+    "conversation", "transcript", "context_summary", "session_summary", \
+    "reminder", "completed", "event", "deadline"
+#endif
+
+// JSONL files at least this large are imported through the parallel mmap path
+#ifndef ETHERVOX_MEMORY_PARALLEL_IMPORT_MIN_BYTES
+#define ETHERVOX_MEMORY_PARALLEL_IMPORT_MIN_BYTES (1024 * 1024)
+#endif
+
+// Upper bound on import worker threads (0 passed to the API = one per online core)
+#ifndef ETHERVOX_MEMORY_IMPORT_MAX_THREADS
+#define ETHERVOX_MEMORY_IMPORT_MAX_THREADS 16
+#endif
 
 /**
- * Hash table bucket for fast lookups
+ * What happens when a new memory is a near-duplicate of an existing one
  */
-typedef struct {
-    uint32_t entry_indices[ETHERVOX_MEMORY_MAX_BUCKET_SIZE];  // Indices into entries array
-    uint32_t count;                                           // Number of entries in bucket
-} ethervox_memory_hash_bucket_t;
+typedef enum {
+    ETHERVOX_MEMORY_DEDUP_OFF = 0,           // Always add a new entry
+    ETHERVOX_MEMORY_DEDUP_MERGE,             // Bump the existing entry's importance, merge tags
+    ETHERVOX_MEMORY_DEDUP_REJECT             // Keep the existing entry untouched
+} ethervox_memory_dedup_mode_t;
 
 /**
  * Memory entry representing a single conversational fact/event
@@ -67,14 +118,54 @@ typedef struct {
 } ethervox_memory_search_result_t;
 
 /**
- * Memory index for fast tag-based lookup
+ * Roaring-style bitmap container: all ordinals sharing the same upper 16 bits.
+ * Holds a sorted array of the low 16 bits while sparse and a 65536-bit bitset
+ * once it grows past ETHERVOX_MEMORY_BITMAP_ARRAY_MAX values.
+ */
+typedef struct {
+    uint16_t key;                            // Upper 16 bits of every ordinal in the container
+    bool is_bitset;                          // Selects values (false) or words (true)
+    uint32_t cardinality;                    // Ordinals present in the container
+    uint32_t capacity;                       // Allocated slots in values
+    uint16_t* values;                        // Sorted low bits (array container)
+    uint64_t* words;                         // 1024-word bitset (bitset container)
+} ethervox_memory_bitmap_container_t;
+
+/**
+ * Compressed bitmap over entry ordinals (positions in the entries array)
+ */
+typedef struct {
+    ethervox_memory_bitmap_container_t* containers;  // Sorted by key
+    uint32_t container_count;
+    uint32_t container_capacity;
+    uint32_t cardinality;                    // Total ordinals across all containers
+} ethervox_memory_bitmap_t;
+
+/**
+ * Interned tag: the tag id is its position in the store's tag_index array
  */
 typedef struct {
     char tag[ETHERVOX_MEMORY_TAG_LEN];
-    uint64_t memory_ids[1024];               // IDs with this tag
-    uint32_t count;
+    ethervox_memory_bitmap_t entries;        // Ordinals of entries carrying this tag
+    uint32_t* by_time;                       // Same ordinals ordered by (timestamp, ordinal)
+    uint32_t by_time_count;
+    uint32_t by_time_capacity;
 } ethervox_memory_tag_index_t;
 
+/**
+ * Statistics reported by the parallel JSONL import path
+ */
+typedef struct {
+    uint64_t bytes_processed;                // Size of the mapped file
+    uint32_t lines_parsed;                   // Non-empty lines seen by workers
+    uint32_t entries_loaded;                 // ADD records merged into the store
+    uint32_t ops_applied;                    // delete/update/update_text records applied
+    uint32_t threads_used;                   // Worker threads actually started
+    uint32_t chunks;                         // Newline-aligned chunks the file was split into
+    double elapsed_ms;                       // Wall time from mmap to index rebuild
+    double throughput_mb_s;                  // bytes_processed / elapsed time
+} ethervox_memory_import_stats_t;
+
 /**
  * Main memory store structure
  */
@@ -87,19 +178,37 @@ typedef struct {
     uint32_t entry_count;
     uint32_t entry_capacity;
     
-    // Tag-based index for fast retrieval (legacy)
+    // Interned tags with per-tag entry bitmaps and time-ordered posting lists
+    // (rebuilt after compaction)
     ethervox_memory_tag_index_t* tag_index;
     uint32_t tag_index_count;
     uint32_t tag_index_capacity;
     
-    // Hash table indices for O(1) lookups
-    ethervox_memory_hash_bucket_t* tag_hash;      // Tag -> entry indices
-    ethervox_memory_hash_bucket_t* id_hash;       // ID -> entry index
+    // Open-addressing tag string -> tag id + 1 lookup (0 = empty slot)
+    uint32_t* tag_lookup;
+    uint32_t tag_lookup_capacity;
+    
+    // Entry ordinals ordered by (timestamp, ordinal) for recency/range queries
+    uint32_t* time_index;
+    uint32_t time_index_count;
+    uint32_t time_index_capacity;
+    
+    // Near-duplicate detection: MinHash signatures and LSH band chains per entry ordinal
+    ethervox_memory_dedup_mode_t dedup_mode;
+    float dedup_threshold;
+    uint32_t* dedup_signatures;              // ETHERVOX_MEMORY_MINHASH_SIZE per ordinal
+    uint32_t* dedup_band_keys;               // ETHERVOX_MEMORY_LSH_BANDS per ordinal
+    uint32_t* dedup_next;                    // Bucket chain link per (ordinal, band)
+    uint32_t* dedup_buckets;                 // Chain heads
+    uint32_t dedup_bucket_count;
+    uint32_t dedup_capacity;                 // Ordinals the per-entry arrays can hold
+    uint32_t dedup_indexed;                  // Ordinals [0, dedup_indexed) are linked
     
     // Statistics
     uint64_t total_memories_stored;
     uint64_t total_searches;
     uint64_t total_exports;
+    uint64_t total_duplicates;               // Inserts merged into or rejected by dedup
     
     // File persistence
     char storage_filepath[512];              // Current session file
@@ -181,6 +290,25 @@ ethervox_result_t ethervox_memory_store_add_with_tools(
     uint64_t* memory_id_out
 );
 
+/**
+ * Configure near-duplicate handling for subsequent inserts
+ * 
+ * New memories are sketched with MinHash and looked up in an LSH table;
+ * a match whose Jaccard similarity reaches the threshold is merged or
+ * rejected instead of adding a row. Both report the existing memory's ID.
+ * Entries tagged with ETHERVOX_MEMORY_DEDUP_EXEMPT_TAGS are never matched.
+ * 
+ * @param store Memory store
+ * @param mode OFF, MERGE (default) or REJECT
+ * @param threshold Jaccard similarity 0.0-1.0 (<= 0 = ETHERVOX_MEMORY_DEDUP_THRESHOLD)
+ * @return ETHERVOX_SUCCESS on success, error code on failure
+ */
+ethervox_result_t ethervox_memory_set_dedup(
+    ethervox_memory_store_t* store,
+    ethervox_memory_dedup_mode_t mode,
+    float threshold
+);
+
 /**
  * TOOL: memory_search - Query memories by tags and text similarity
  * 
@@ -203,6 +331,56 @@ ethervox_result_t ethervox_memory_search(
     uint32_t* result_count
 );
 
+/**
+ * Most recent memories by timestamp, newest first
+ * 
+ * Walks the time index from the newest entry, so cost is O(limit) without a
+ * tag filter instead of a scan over every entry.
+ * 
+ * @param store Memory store
+ * @param tag_filter Optional tags every result must carry (NULL = any)
+ * @param tag_filter_count Number of filter tags
+ * @param limit Maximum results to return (0 = 10)
+ * @param results Output: array of results (caller must free)
+ * @param result_count Output: number of results
+ * @return ETHERVOX_SUCCESS on success, error code on failure
+ */
+ethervox_result_t ethervox_memory_get_recent(
+    ethervox_memory_store_t* store,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t limit,
+    ethervox_memory_search_result_t** results,
+    uint32_t* result_count
+);
+
+/**
+ * Memories with start_time <= timestamp <= end_time, oldest first
+ * 
+ * The range bounds are found by binary search over the time index:
+ * O(log n + k) for k entries in the range.
+ * 
+ * @param store Memory store
+ * @param start_time Inclusive lower bound
+ * @param end_time Inclusive upper bound
+ * @param tag_filter Optional tags every result must carry (NULL = any)
+ * @param tag_filter_count Number of filter tags
+ * @param limit Maximum results to return (0 = no limit)
+ * @param results Output: array of results (caller must free)
+ * @param result_count Output: number of results
+ * @return ETHERVOX_SUCCESS on success, error code on failure
+ */
+ethervox_result_t ethervox_memory_get_range(
+    ethervox_memory_store_t* store,
+    time_t start_time,
+    time_t end_time,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t limit,
+    ethervox_memory_search_result_t** results,
+    uint32_t* result_count
+);
+
 /**
  * Update tags for an existing memory entry
  * 
@@ -286,6 +464,32 @@ ethervox_result_t ethervox_memory_import(
     uint32_t* turns_loaded
 );
 
+/**
+ * Import a JSONL session log using the parallel fast path
+ *
+ * The file is memory-mapped and split into chunks at newline boundaries.
+ * Worker threads parse the chunks into thread-local batches, which are then
+ * merged into the store in file order (so delete/update records still apply
+ * to the right entries). The tag index is rebuilt and the surviving entries
+ * are written to the session log once at the end.
+ *
+ * ethervox_memory_import() routes JSONL files of at least
+ * ETHERVOX_MEMORY_PARALLEL_IMPORT_MIN_BYTES here automatically.
+ *
+ * @param store Memory store
+ * @param filepath Input JSONL file path
+ * @param num_threads Worker threads (0 = one per online core,
+ *                    capped at ETHERVOX_MEMORY_IMPORT_MAX_THREADS)
+ * @param stats_out Output: throughput statistics (can be NULL)
+ * @return ETHERVOX_SUCCESS on success, error code on failure
+ */
+ethervox_result_t ethervox_memory_import_parallel(
+    ethervox_memory_store_t* store,
+    const char* filepath,
+    uint32_t num_threads,
+    ethervox_memory_import_stats_t* stats_out
+);
+
 /**
  * Platform-agnostic function to load the most recent previous session
  * Automatically finds and imports the latest .jsonl file from the storage directory
@@ -0,0 +1,90 @@
+/**
+ * @file noise_reduction.h
+ * @brief Streaming single-channel noise suppression
+ *
+ * Short-time Fourier transform with sqrt-Hann windows and 50% overlap-add.
+ * The noise power spectrum is tracked with minimum statistics (the minimum
+ * of the smoothed periodogram over a sliding window), and each bin is scaled
+ * by a Wiener gain driven by a decision-directed a priori SNR, which smooths
+ * the gain over time and keeps musical noise down.
+ *
+ * Every hop costs the same: one real FFT, one inverse FFT and a fixed number
+ * of operations per bin, all on buffers allocated at creation. At 16 kHz
+ * (512-point FFT, 16 ms hop) this is well under 5% of one Cortex-A72 core.
+ *
+ * Insert it after capture/AEC and before the VAD; ethervox_audio_read()
+ * applies it when ethervox_audio_config_t.enable_noise_suppression is set.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_NOISE_REDUCTION_H
+#define ETHERVOX_NOISE_REDUCTION_H
+
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ethervox_ns ethervox_ns_t;
+
+/**
+ * Noise suppressor configuration
+ */
+typedef struct {
+  uint32_t sample_rate;      // Mono input rate (Hz)
+  uint32_t frame_ms;         // Analysis window, rounded up to a power-of-two FFT
+  float min_gain;            // Gain floor per bin (0.0 - 1.0; 1.0 passes audio through)
+  uint32_t noise_window_ms;  // Minimum-statistics search window
+} ethervox_ns_config_t;
+
+/**
+ * Get default configuration (ETHERVOX_NS_* tunables, 16 kHz)
+ */
+ethervox_ns_config_t ethervox_ns_get_default_config(void);
+
+/**
+ * Create a noise suppressor
+ *
+ * @param config Configuration (NULL for defaults)
+ * @return Suppressor, or NULL if out of memory or the configuration is invalid
+ */
+ethervox_ns_t* ethervox_ns_create(const ethervox_ns_config_t* config);
+
+/**
+ * Free a noise suppressor
+ */
+void ethervox_ns_destroy(ethervox_ns_t* ns);
+
+/**
+ * Forget the noise estimate and flush the overlap-add buffers
+ */
+void ethervox_ns_reset(ethervox_ns_t* ns);
+
+/**
+ * Denoise the next samples of the stream in place
+ *
+ * Any count is accepted; the output lags the input by
+ * ethervox_ns_latency_samples() (zeros at the start of the stream).
+ */
+ethervox_result_t ethervox_ns_process(ethervox_ns_t* ns, float* samples, uint32_t count);
+
+/**
+ * Delay between a sample going in and its denoised version coming out
+ */
+uint32_t ethervox_ns_latency_samples(const ethervox_ns_t* ns);
+
+/**
+ * FFT length used by the suppressor
+ */
+uint32_t ethervox_ns_fft_size(const ethervox_ns_t* ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_NOISE_REDUCTION_H
@@ -1,10 +1,19 @@
 /**
  * @file reference_buffer.h
- * @brief Circular buffer for TTS reference signal storage
- * 
- * Thread-safe ring buffer used to store TTS output samples for AEC.
- * Allows TTS playback thread to write samples while microphone capture
- * thread reads time-aligned samples for echo cancellation.
+ * @brief Lock-free, timestamp-aligned buffer for the AEC far-end reference
+ *
+ * Stores what is being sent to the speaker so the microphone capture thread
+ * can read the matching samples for echo cancellation. One thread writes
+ * (the playback callback or TTS thread), one thread reads (the capture
+ * thread); neither takes a lock, so writing from a real-time audio callback
+ * is safe.
+ *
+ * Writers stamp each block with the time its first sample reaches the
+ * speaker, and readers ask for the samples that were playing at their
+ * capture time: stale samples are skipped and not-yet-played ones are
+ * replaced by silence. Writes and reads without timestamps fall back to
+ * plain FIFO order. Timestamps are in microseconds on the clock the capture
+ * driver stamps its buffers with.
  */
 
 #ifndef ETHERVOX_REFERENCE_BUFFER_H
@@ -12,6 +21,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,33 +33,62 @@ extern "C" {
 typedef struct ethervox_reference_buffer_s ethervox_reference_buffer_t;
 
 /**
- * Create reference buffer
- * 
+ * Create reference buffer for 16 kHz audio
+ *
  * @param capacity Buffer size in samples (e.g., 32000 = 2 seconds @ 16kHz)
  * @return Buffer handle, or NULL on allocation failure
  */
 ethervox_reference_buffer_t* ethervox_reference_buffer_create(size_t capacity);
 
+/**
+ * Create reference buffer for a given sample rate
+ *
+ * @param capacity Buffer size in samples; should cover the longest
+ *                 playback-to-capture delay plus one capture block
+ * @param sample_rate Rate used to convert between timestamps and samples
+ * @return Buffer handle, or NULL on allocation failure
+ */
+ethervox_reference_buffer_t* ethervox_reference_buffer_create_timed(size_t capacity, uint32_t sample_rate);
+
 /**
  * Write samples to buffer (from TTS playback thread)
- * 
- * Thread-safe: Can be called concurrently with read operations.
- * 
+ *
+ * Producer side: only one thread may write.
+ *
  * @param buffer Buffer handle
  * @param samples Audio samples to write
  * @param count Number of samples
  * @return Number of samples actually written (may be less if buffer full)
  */
-size_t ethervox_reference_buffer_write(ethervox_reference_buffer_t* buffer, 
-                                       const float* samples, 
+size_t ethervox_reference_buffer_write(ethervox_reference_buffer_t* buffer,
+                                       const float* samples,
                                        size_t count);
 
+/**
+ * Write samples stamped with their playback time
+ *
+ * Producer side: only one thread may write. If the buffer is full (the
+ * reader has stopped), the samples are dropped and everything already
+ * queued is discarded at the reader's next access, so it resumes on fresh
+ * audio rather than stale audio.
+ *
+ * @param buffer Buffer handle
+ * @param samples Audio samples handed to the speaker
+ * @param count Number of samples
+ * @param play_time_us Time samples[0] leaves the speaker (0 = continues the previous block)
+ * @return Number of samples actually written
+ */
+size_t ethervox_reference_buffer_write_at(ethervox_reference_buffer_t* buffer,
+                                          const float* samples,
+                                          size_t count,
+                                          uint64_t play_time_us);
+
 /**
  * Read samples from buffer (from microphone capture thread)
- * 
- * Thread-safe: Can be called concurrently with write operations.
- * Returns time-aligned samples for AEC processing.
- * 
+ *
+ * Consumer side: only one thread may read. A short read fills the rest of
+ * samples with silence.
+ *
  * @param buffer Buffer handle
  * @param samples Output buffer for samples
  * @param count Number of samples to read
@@ -59,9 +98,29 @@ size_t ethervox_reference_buffer_read(ethervox_reference_buffer_t* buffer,
                                       float* samples,
                                       size_t count);
 
+/**
+ * Read the samples that were playing at a capture time
+ *
+ * Consumer side: only one thread may read. Samples that played before
+ * capture_time_us are discarded; if the queued audio starts later, the
+ * output starts with silence. Offsets of a few milliseconds are absorbed
+ * rather than corrected, so callback jitter does not make the stream slip.
+ * Falls back to a FIFO read when either side has no timestamps.
+ *
+ * @param buffer Buffer handle
+ * @param samples Output buffer (count samples, zero-filled where nothing played)
+ * @param count Number of samples to read
+ * @param capture_time_us Capture time of the first microphone sample
+ * @return Number of reference samples copied (the rest is silence)
+ */
+size_t ethervox_reference_buffer_read_at(ethervox_reference_buffer_t* buffer,
+                                         float* samples,
+                                         size_t count,
+                                         uint64_t capture_time_us);
+
 /**
  * Get number of samples available for reading
- * 
+ *
  * @param buffer Buffer handle
  * @return Number of samples ready to read
  */
@@ -69,22 +128,24 @@ size_t ethervox_reference_buffer_available(const ethervox_reference_buffer_t* bu
 
 /**
  * Get remaining buffer capacity
- * 
+ *
  * @param buffer Buffer handle
- * @return Number of samples that can be written without blocking
+ * @return Number of samples that can be written without dropping
  */
 size_t ethervox_reference_buffer_space(const ethervox_reference_buffer_t* buffer);
 
 /**
  * Clear all data from buffer
- * 
+ *
+ * Safe from any thread; takes effect at the reader's next access.
+ *
  * @param buffer Buffer handle
  */
 void ethervox_reference_buffer_clear(ethervox_reference_buffer_t* buffer);
 
 /**
  * Check if buffer is empty
- * 
+ *
  * @param buffer Buffer handle
  * @return true if no samples available for reading
  */
@@ -92,7 +153,7 @@ bool ethervox_reference_buffer_is_empty(const ethervox_reference_buffer_t* buffe
 
 /**
  * Destroy reference buffer
- * 
+ *
  * @param buffer Buffer handle (may be NULL)
  */
 void ethervox_reference_buffer_destroy(ethervox_reference_buffer_t* buffer);
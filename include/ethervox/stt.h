@@ -10,10 +10,12 @@
 #define ETHERVOX_STT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "ethervox/audio.h"
 #include "ethervox/error.h"
+#include "ethervox/vad.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +42,14 @@ typedef struct {
   bool enable_punctuation;      // Add punctuation to results
   float vad_threshold;          // Voice activity detection threshold
   bool translate_to_english;    // Translate non-English speech to English (Whisper only)
+  const char* grammar;          // Vosk only: JSON phrase list for command mode (NULL = dictation)
+  uint32_t threads;             // Whisper decoder threads (0 = whisper.cpp default)
+
+  // Cascade: the backend above streams partials and endpoints; this larger
+  // Whisper model re-decodes each final utterance in the background
+  const char* rescore_model_path;  // NULL = single pass
+  int32_t rescore_wait_ms;         // How long a final result waits for rescoring
+                                   // (-1 = always, 0 = never; late text goes to the rescore callback)
 } ethervox_stt_config_t;
 
 /**
@@ -55,6 +65,19 @@ typedef struct ethervox_stt_result {
   const char* language;    // Detected language
 } ethervox_stt_result_t;
 
+/**
+ * Hypothesis callback, invoked from ethervox_stt_process() on the calling
+ * thread whenever the backend reports new partial or final text
+ */
+typedef void (*ethervox_stt_partial_callback_t)(const char* text, bool is_final, void* user_data);
+
+/**
+ * Rescore callback, invoked from the rescoring thread when the second pass
+ * changed an utterance whose final result was already returned
+ */
+typedef void (*ethervox_stt_rescore_callback_t)(const char* first_pass, const char* rescored,
+                                                void* user_data);
+
 /**
  * STT runtime
  */
@@ -64,6 +87,13 @@ typedef struct {
   bool is_initialized;
   bool is_processing;
 
+  // Streaming hypotheses
+  ethervox_stt_partial_callback_t partial_callback;
+  void* partial_user_data;
+
+  // Two-tier rescoring state (NULL = single pass)
+  void* cascade;
+
   // Audio buffering for streaming
   float* audio_accumulator;
   uint32_t accumulator_size;
@@ -107,6 +137,24 @@ ethervox_result_t ethervox_stt_process(ethervox_stt_runtime_t* runtime,
                          const ethervox_audio_buffer_t* audio_buffer,
                          ethervox_stt_result_t* result);
 
+/**
+ * Process audio the capture stream's VAD has already analyzed
+ *
+ * Use when the stream runs one VAD for every consumer (e.g. the audio
+ * pipeline's VAD stage, see ethervox_pipeline_block_t.vad_frames). The
+ * Whisper endpointer then skips its private VAD and compares each frame's
+ * probability with config.vad_threshold; Vosk endpoints on its own and
+ * ignores the frames.
+ *
+ * @param frames Frames completed in audio_buffer (may be NULL when frame_count is 0)
+ * @param frame_count Number of frames
+ * @return As ethervox_stt_process()
+ */
+ethervox_result_t ethervox_stt_process_frames(ethervox_stt_runtime_t* runtime,
+                                              const ethervox_audio_buffer_t* audio_buffer,
+                                              const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                                              ethervox_stt_result_t* result);
+
 /**
  * Finalize STT processing and get final result
  *
@@ -135,6 +183,40 @@ void ethervox_stt_result_free(ethervox_stt_result_t* result);
  */
 ethervox_result_t ethervox_stt_set_language(ethervox_stt_runtime_t* runtime, const char* language);
 
+/**
+ * Stream hypotheses to a callback as they are recognized
+ *
+ * Lets a consumer (e.g. the governor) start on the user's prompt before the
+ * utterance ends. Results are still returned from ethervox_stt_process().
+ *
+ * @param runtime STT runtime
+ * @param callback Hypothesis callback (NULL to disable)
+ * @param user_data Passed through to the callback
+ */
+void ethervox_stt_set_partial_callback(ethervox_stt_runtime_t* runtime,
+                                       ethervox_stt_partial_callback_t callback, void* user_data);
+
+/**
+ * Receive rescored text that arrived after rescore_wait_ms expired
+ * (no-op unless config.rescore_model_path enabled the cascade)
+ *
+ * @param runtime STT runtime
+ * @param callback Rescore callback (NULL to disable)
+ * @param user_data Passed through to the callback
+ */
+void ethervox_stt_set_rescore_callback(ethervox_stt_runtime_t* runtime,
+                                       ethervox_stt_rescore_callback_t callback, void* user_data);
+
+/**
+ * Restrict recognition to a phrase list (hot-switch without re-init)
+ *
+ * @param runtime STT runtime
+ * @param grammar JSON array of phrases, e.g. ["what time is it", "[unk]"];
+ *                NULL returns to free dictation
+ * @return ETHERVOX_SUCCESS, or ETHERVOX_ERROR_NOT_SUPPORTED for Whisper
+ */
+ethervox_result_t ethervox_stt_set_grammar(ethervox_stt_runtime_t* runtime, const char* grammar);
+
 /**
  * Cleanup STT engine
  */
@@ -143,8 +225,10 @@ void ethervox_stt_cleanup(ethervox_stt_runtime_t* runtime);
 // Backend-specific functions (internal)
 ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime);
 ethervox_result_t ethervox_stt_whisper_start(ethervox_stt_runtime_t* runtime);
+// frames: the stream VAD's frames for audio_buffer, or NULL to run the backend's own VAD
 ethervox_result_t ethervox_stt_whisper_process(ethervox_stt_runtime_t* runtime,
                                   const ethervox_audio_buffer_t* audio_buffer,
+                                  const ethervox_vad_frame_t* frames, uint32_t frame_count,
                                   ethervox_stt_result_t* result);
 ethervox_result_t ethervox_stt_whisper_finalize(ethervox_stt_runtime_t* runtime, ethervox_stt_result_t* result);
 void ethervox_stt_whisper_stop(ethervox_stt_runtime_t* runtime);
@@ -159,6 +243,63 @@ ethervox_result_t ethervox_stt_vosk_process(ethervox_stt_runtime_t* runtime,
 ethervox_result_t ethervox_stt_vosk_finalize(ethervox_stt_runtime_t* runtime, ethervox_stt_result_t* result);
 void ethervox_stt_vosk_stop(ethervox_stt_runtime_t* runtime);
 void ethervox_stt_vosk_cleanup(ethervox_stt_runtime_t* runtime);
+ethervox_result_t ethervox_stt_vosk_set_grammar(ethervox_stt_runtime_t* runtime, const char* grammar);
+
+// Shared model registry
+//
+// Loaded models are shared process-wide, keyed by backend loader and
+// canonical model path, so voice_tools and voice_conversation sessions over
+// the same model hold one copy. Each session keeps only its own decoder
+// state (whisper_state, VoskRecognizer). Models are loaded on first acquire
+// and freed once unreferenced for ETHERVOX_STT_MODEL_IDLE_EVICT_MS by a
+// background sweeper; ethervox_stt_model_trim() frees them sooner.
+
+typedef void* (*ethervox_stt_model_load_fn)(const char* model_path);
+typedef void (*ethervox_stt_model_free_fn)(void* model);
+
+/**
+ * Get a shared model, loading it if no session holds it yet
+ *
+ * @param model_path Model file or directory
+ * @param load Backend loader (also part of the registry key)
+ * @param free_model Backend destructor, called on eviction
+ * @param model Output: backend model handle (whisper_context*, VoskModel*)
+ * @return ETHERVOX_SUCCESS, or ETHERVOX_ERROR_STT_INIT if loading failed
+ */
+ethervox_result_t ethervox_stt_model_acquire(const char* model_path, ethervox_stt_model_load_fn load,
+                                             ethervox_stt_model_free_fn free_model, void** model);
+
+/**
+ * Drop a reference taken with ethervox_stt_model_acquire()
+ */
+void ethervox_stt_model_release(void* model);
+
+/**
+ * Free unreferenced models idle for at least idle_ms (0 = all idle models)
+ *
+ * @return Number of models freed
+ */
+uint32_t ethervox_stt_model_trim(uint32_t idle_ms);
+
+/**
+ * Number of models currently loaded (referenced or idle)
+ */
+uint32_t ethervox_stt_model_loaded_count(void);
+
+/**
+ * Path of the most recently loaded model for a backend loader, so a new
+ * session can reuse whatever model another mode already has in memory
+ *
+ * @return true if a model is loaded and its path fit in path_out
+ */
+bool ethervox_stt_model_find_loaded(ethervox_stt_model_load_fn load, char* path_out,
+                                    size_t path_size);
+
+// Backend model loaders for the registry
+void* ethervox_stt_whisper_load_model(const char* model_path);
+void ethervox_stt_whisper_free_model(void* model);
+void* ethervox_stt_vosk_load_model(const char* model_path);
+void ethervox_stt_vosk_free_model(void* model);
 
 // Testing utilities
 /**
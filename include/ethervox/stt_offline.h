@@ -0,0 +1,156 @@
+/**
+ * @file stt_offline.h
+ * @brief Parallel offline Whisper transcription of recorded audio
+ *
+ * Recordings (e.g. from ethervox_audio_record_to_file) are split at VAD
+ * silences and the segments decoded concurrently, one whisper_state per
+ * worker, all sharing a single whisper_context so the weights are loaded
+ * once. Results are stitched back in order with absolute timestamps.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#ifndef ETHERVOX_STT_OFFLINE_H
+#define ETHERVOX_STT_OFFLINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Offline transcription configuration
+ */
+typedef struct {
+  const char* model_path;       // Whisper GGML model
+  const char* language;         // Language code ("en", "de-DE") or "auto"
+  bool translate_to_english;    // Translate non-English speech to English
+  uint32_t workers;             // Concurrent whisper_states (0 = cores / threads_per_worker)
+  uint32_t threads_per_worker;  // Compute threads per state (0 = config default)
+  uint32_t max_segment_ms;      // Longest segment handed to one worker
+  uint32_t min_silence_ms;      // Shortest pause that may separate segments
+} ethervox_stt_offline_config_t;
+
+/**
+ * Span of the input audio decoded as one unit
+ */
+typedef struct {
+  uint32_t start;   // First sample
+  uint32_t length;  // Sample count
+} ethervox_stt_offline_span_t;
+
+/**
+ * One transcribed segment, timestamps relative to the start of the recording
+ */
+typedef struct {
+  uint64_t start_ms;
+  uint64_t end_ms;
+  char* text;
+  const char* language;  // Language the segment was decoded in (static string)
+} ethervox_stt_offline_segment_t;
+
+/**
+ * Offline transcription result
+ */
+typedef struct {
+  ethervox_stt_offline_segment_t* segments;  // In recording order
+  uint32_t segment_count;
+  char* text;                 // All segments joined with spaces
+  uint32_t spans;             // VAD spans decoded
+  uint32_t workers;           // Workers actually used
+  double audio_seconds;       // Duration of the input
+  double load_seconds;        // Model and state setup
+  double decode_seconds;      // Wall time spent decoding
+  double realtime_factor;     // decode_seconds / audio_seconds (< 1 = faster than realtime)
+} ethervox_stt_offline_result_t;
+
+/**
+ * Get default offline configuration (model_path must still be set)
+ */
+ethervox_stt_offline_config_t ethervox_stt_offline_get_default_config(void);
+
+/**
+ * Split 16 kHz mono audio into spans at VAD silences
+ *
+ * Frames are classified against a noise floor estimated from the whole
+ * recording, so quiet and loud recordings split alike. Utterances are
+ * padded and packed together up to max_segment_ms, cutting only inside
+ * pauses of at least min_silence_ms; an utterance longer than that is cut
+ * at its quietest frame. Audio without speech produces no spans.
+ *
+ * @param spans Output: allocated span array (caller must free, NULL if none)
+ * @param span_count Output: number of spans
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_INVALID_ARGUMENT or ETHERVOX_ERROR_OUT_OF_MEMORY
+ */
+ethervox_result_t ethervox_stt_offline_split(const float* samples, uint32_t sample_count,
+                                             uint32_t max_segment_ms, uint32_t min_silence_ms,
+                                             ethervox_stt_offline_span_t** spans,
+                                             uint32_t* span_count);
+
+/**
+ * Transcribe 16 kHz mono float samples
+ *
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_STT_INIT if the model cannot be
+ *         loaded, ETHERVOX_ERROR_STT_PROCESSING if a segment fails to decode,
+ *         or ETHERVOX_ERROR_NOT_SUPPORTED without whisper.cpp
+ */
+ethervox_result_t ethervox_stt_offline_transcribe(const ethervox_stt_offline_config_t* config,
+                                                  const float* samples, uint32_t sample_count,
+                                                  ethervox_stt_offline_result_t* result);
+
+/**
+ * Transcribe a 16 kHz 16-bit PCM WAV file (multi-channel input is downmixed)
+ */
+ethervox_result_t ethervox_stt_offline_transcribe_file(const ethervox_stt_offline_config_t* config,
+                                                       const char* wav_path,
+                                                       ethervox_stt_offline_result_t* result);
+
+/**
+ * Free offline transcription result
+ */
+void ethervox_stt_offline_result_free(ethervox_stt_offline_result_t* result);
+
+typedef struct ethervox_stt_offline_decoder ethervox_stt_offline_decoder_t;
+
+/**
+ * Create a decoder that keeps one whisper_state between calls
+ *
+ * For callers that decode many short clips (e.g. utterance rescoring): the
+ * model reference and the state are taken once instead of per
+ * ethervox_stt_offline_transcribe() call. config->workers is ignored and
+ * the model stays loaded until the decoder is destroyed. A decoder belongs
+ * to one thread at a time.
+ *
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_STT_INIT if the model or state
+ *         cannot be created, or ETHERVOX_ERROR_NOT_SUPPORTED without whisper.cpp
+ */
+ethervox_result_t ethervox_stt_offline_decoder_create(const ethervox_stt_offline_config_t* config,
+                                                      ethervox_stt_offline_decoder_t** decoder);
+
+/**
+ * Switch the language for subsequent decodes ("auto" or NULL detects per span)
+ */
+ethervox_result_t ethervox_stt_offline_decoder_set_language(ethervox_stt_offline_decoder_t* decoder,
+                                                            const char* language);
+
+/**
+ * Transcribe 16 kHz mono float samples on the decoder's state
+ */
+ethervox_result_t ethervox_stt_offline_decode(ethervox_stt_offline_decoder_t* decoder, const float* samples,
+                                              uint32_t sample_count, ethervox_stt_offline_result_t* result);
+
+/**
+ * Free the state and drop the model reference (may be NULL)
+ */
+void ethervox_stt_offline_decoder_destroy(ethervox_stt_offline_decoder_t* decoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_STT_OFFLINE_H
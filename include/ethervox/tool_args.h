@@ -0,0 +1,231 @@
+/**
+ * @file tool_args.h
+ * @brief Shared JSON argument parsing for tool wrappers
+ *
+ * A jsmn-style tokenizer records the type and byte span of every JSON value
+ * in a fixed token array - no allocation and no copying of the input. The
+ * governor opts into a heap array for calls that outgrow it. Tool
+ * wrappers read their arguments through typed accessors on that read-only
+ * view, or bind them into a C struct from a field table.
+ *
+ * The governor tokenizes each tool call once and publishes the "arguments"
+ * view for the duration of tool->execute(); ethervox_tool_args_parse() on
+ * the same args_json pointer reuses those tokens instead of rescanning.
+ * Tools called directly (tests, other callers) tokenize their input
+ * themselves, so the execute signature is unchanged.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#ifndef ETHERVOX_TOOL_ARGS_H
+#define ETHERVOX_TOOL_ARGS_H
+
+#include "ethervox/error.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum JSON tokens per view (objects, arrays, keys and values each take one)
+#ifndef ETHERVOX_TOOL_ARGS_MAX_TOKENS
+#define ETHERVOX_TOOL_ARGS_MAX_TOKENS 256
+#endif
+
+// Maximum container nesting accepted by the tokenizer
+#ifndef ETHERVOX_TOOL_ARGS_MAX_DEPTH
+#define ETHERVOX_TOOL_ARGS_MAX_DEPTH 32
+#endif
+
+typedef enum {
+  ETHERVOX_JSON_UNDEFINED = 0,
+  ETHERVOX_JSON_OBJECT,
+  ETHERVOX_JSON_ARRAY,
+  ETHERVOX_JSON_STRING,
+  ETHERVOX_JSON_PRIMITIVE  // Number, true, false or null
+} ethervox_json_type_t;
+
+/**
+ * One JSON value. Strings span their contents without the quotes (escapes
+ * are left in place); containers span their brackets.
+ */
+typedef struct {
+  ethervox_json_type_t type;
+  int32_t start;  // Byte offset of the first character
+  int32_t end;    // Byte offset one past the last character
+  int32_t size;   // Direct children (object keys and values, array elements)
+} ethervox_json_token_t;
+
+/**
+ * Tokenize the first JSON value in json[0..length)
+ *
+ * Trailing text after the value is ignored, so a tool call embedded in model
+ * output can be parsed in place.
+ *
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_INVALID_ARGUMENT for malformed
+ *         input, or ETHERVOX_ERROR_BUFFER_TOO_SMALL if max_tokens is exceeded
+ */
+ethervox_result_t ethervox_json_tokenize(const char* json, size_t length,
+                                         ethervox_json_token_t* tokens, uint32_t max_tokens,
+                                         uint32_t* token_count);
+
+/**
+ * Read-only view of a tokenized JSON object
+ *
+ * Token offsets are relative to the text they were produced from; `base` is
+ * subtracted to address `json` (non-zero when the view borrows the tokens of
+ * an enclosing document). `storage` is only used when the view owns its
+ * tokens; `heap` replaces it when ethervox_tool_args_parse_growable() had
+ * to spill a larger document.
+ */
+typedef struct {
+  const char* json;
+  int32_t base;
+  const ethervox_json_token_t* tokens;
+  uint32_t token_count;
+  ethervox_json_token_t* heap;
+  ethervox_json_token_t storage[ETHERVOX_TOOL_ARGS_MAX_TOKENS];
+} ethervox_tool_args_t;
+
+/**
+ * Open a view over a tool's args_json
+ *
+ * Reuses the governor's published tokens when args_json is the string it is
+ * executing; otherwise tokenizes into args->storage. NULL or empty input
+ * yields an empty object.
+ */
+ethervox_result_t ethervox_tool_args_parse(ethervox_tool_args_t* args, const char* args_json);
+
+/**
+ * Like ethervox_tool_args_parse(), but documents with more than
+ * ETHERVOX_TOOL_ARGS_MAX_TOKENS tokens are tokenized into a heap array
+ * instead of failing. Call ethervox_tool_args_release() when done.
+ *
+ * @return ETHERVOX_SUCCESS, ETHERVOX_ERROR_INVALID_ARGUMENT for malformed
+ *         or truncated input, or ETHERVOX_ERROR_OUT_OF_MEMORY
+ */
+ethervox_result_t ethervox_tool_args_parse_growable(ethervox_tool_args_t* args,
+                                                    const char* args_json);
+
+/** Free any heap tokens taken by ethervox_tool_args_parse_growable() */
+void ethervox_tool_args_release(ethervox_tool_args_t* args);
+
+/**
+ * Copy the object stored under key into text_out and make child a view of
+ * it that shares parent's tokens (used by the governor for "arguments")
+ *
+ * @return ETHERVOX_ERROR_NOT_FOUND if key is missing or not an object,
+ *         ETHERVOX_ERROR_BUFFER_TOO_SMALL if text_out cannot hold it
+ */
+ethervox_result_t ethervox_tool_args_object(const ethervox_tool_args_t* parent, const char* key,
+                                            char* text_out, size_t text_size,
+                                            ethervox_tool_args_t* child);
+
+/**
+ * Publish (or clear with NULL) the view the calling thread is about to
+ * execute. The view must outlive the tool call.
+ */
+void ethervox_tool_args_publish(const ethervox_tool_args_t* args);
+
+/** Type of the value stored under key, ETHERVOX_JSON_UNDEFINED if absent */
+ethervox_json_type_t ethervox_tool_args_type(const ethervox_tool_args_t* args, const char* key);
+
+/** True if key is present (with any value other than null) */
+bool ethervox_tool_args_has(const ethervox_tool_args_t* args, const char* key);
+
+/**
+ * Unescaped string value, truncated to out_size - 1 bytes. Numbers and
+ * booleans are returned as their literal text.
+ */
+bool ethervox_tool_args_get_string(const ethervox_tool_args_t* args, const char* key, char* out,
+                                   size_t out_size);
+
+/** Unescaped string value in a new buffer (caller must free), NULL if absent */
+char* ethervox_tool_args_dup_string(const ethervox_tool_args_t* args, const char* key);
+
+/** Integer value; numeric strings such as "42" are accepted */
+bool ethervox_tool_args_get_int(const ethervox_tool_args_t* args, const char* key, int64_t* out);
+
+/** Floating-point value; numeric strings are accepted */
+bool ethervox_tool_args_get_double(const ethervox_tool_args_t* args, const char* key, double* out);
+
+/** Boolean value; "true"/"false" strings and numbers are accepted */
+bool ethervox_tool_args_get_bool(const ethervox_tool_args_t* args, const char* key, bool* out);
+
+/**
+ * Array of strings into fixed-width slots (out + i * stride). A single
+ * string value counts as a one-element array. Empty strings are skipped.
+ *
+ * @return Number of strings written
+ */
+uint32_t ethervox_tool_args_get_string_array(const ethervox_tool_args_t* args, const char* key,
+                                             char* out, size_t stride, uint32_t max_count);
+
+/**
+ * Array of integers (numeric strings accepted). A single number counts as
+ * a one-element array.
+ *
+ * @return Number of integers written
+ */
+uint32_t ethervox_tool_args_get_int_array(const ethervox_tool_args_t* args, const char* key,
+                                          int64_t* out, uint32_t max_count);
+
+/** Raw JSON text of the value (strings without quotes), not NUL-terminated */
+bool ethervox_tool_args_get_raw(const ethervox_tool_args_t* args, const char* key,
+                                const char** start, size_t* length);
+
+/**
+ * Escape str for embedding between quotes in a JSON result (quotes not
+ * included). Use it when echoing an unescaped argument back to the model.
+ *
+ * @return New buffer (caller must free), NULL on allocation failure
+ */
+char* ethervox_json_escape(const char* str);
+
+// ---------------------------------------------------------------------------
+// Schema-driven binding
+// ---------------------------------------------------------------------------
+
+typedef enum {
+  ETHERVOX_TOOL_ARG_STRING,  // char[] member, truncated to fit
+  ETHERVOX_TOOL_ARG_INT,     // Signed integer member of any width
+  ETHERVOX_TOOL_ARG_UINT,    // Unsigned integer member of any width (negatives rejected)
+  ETHERVOX_TOOL_ARG_REAL,    // float or double member
+  ETHERVOX_TOOL_ARG_BOOL     // bool member
+} ethervox_tool_arg_type_t;
+
+typedef struct {
+  const char* key;
+  ethervox_tool_arg_type_t type;
+  size_t offset;
+  size_t size;
+  bool required;
+} ethervox_tool_arg_spec_t;
+
+// Field spec for struct member `member` read from JSON key `key`
+#define ETHERVOX_TOOL_ARG_FIELD(key, struct_type, member, arg_type, required)                 \
+  { (key), (arg_type), offsetof(struct_type, member), sizeof(((struct_type*)0)->member),      \
+    (required) }
+
+/**
+ * Bind arguments into the struct at out according to specs
+ *
+ * Members whose key is absent keep their current value, so callers fill in
+ * defaults first.
+ *
+ * @param failed_key Output: key that was missing or had the wrong type (can be NULL)
+ * @return ETHERVOX_ERROR_INVALID_ARGUMENT if a required key is missing or a
+ *         present value does not convert
+ */
+ethervox_result_t ethervox_tool_args_bind(const ethervox_tool_args_t* args,
+                                          const ethervox_tool_arg_spec_t* specs,
+                                          uint32_t spec_count, void* out, const char** failed_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_TOOL_ARGS_H
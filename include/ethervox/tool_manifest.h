@@ -279,6 +279,24 @@ ethervox_result_t ethervox_tool_build_index_prompt(
     uint8_t min_priority
 );
 
+/**
+ * Build a speech recognizer grammar from tool trigger phrases
+ * 
+ * Produces a JSON phrase list for STT command mode (ethervox_stt_set_grammar),
+ * e.g. ["what time is it", "remember this", "[unk]"]. Phrases are lowercased
+ * and stripped of punctuation; disabled tools are skipped.
+ * 
+ * @param registry Tool manifest registry
+ * @param output Output buffer for the grammar
+ * @param output_size Size of output buffer
+ * @return Number of bytes written (0 if no tool has triggers), or negative on error
+ */
+ethervox_result_t ethervox_tool_build_trigger_grammar(
+    const tool_manifest_registry_t* registry,
+    char* output,
+    size_t output_size
+);
+
 // ============================================================================
 // Runtime Management (Dynamic Enable/Disable)
 // ============================================================================
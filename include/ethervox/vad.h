@@ -0,0 +1,123 @@
+/**
+ * @file vad.h
+ * @brief Streaming frame-level voice activity detection
+ *
+ * Audio is cut into 10, 20 or 30 ms frames. Each frame's log-energy is
+ * compared with an adaptive noise floor and combined with its spectral tilt
+ * into a speech probability; a hangover keeps the speech flag up briefly
+ * after the last voiced frame so word endings are not clipped.
+ *
+ * An instance carries per-stream state (noise floor, hangover, partial
+ * frame) and is single-threaded, so a capture stream runs one, on one
+ * thread: the audio pipeline's VAD stage, or the loop that reads the
+ * stream. Its frames are handed downstream (ethervox_pipeline_block_t,
+ * ethervox_wake_process_frames(), ethervox_stt_process_frames()) and each
+ * consumer compares the probability against its own threshold and keeps
+ * its own hangover; voiced and is_speech reflect this instance's config.
+ * Consumers fed raw audio fall back to a private instance.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#ifndef ETHERVOX_VAD_H
+#define ETHERVOX_VAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ethervox/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ethervox_vad ethervox_vad_t;
+
+/**
+ * VAD configuration
+ */
+typedef struct {
+  uint32_t sample_rate;  // Mono input rate (Hz)
+  uint32_t frame_ms;     // 10, 20 or 30
+  float speech_ratio;    // Frame RMS over the noise floor that gives probability 0.5
+  float min_rms;         // Absolute RMS floor for speech
+  float threshold;       // Probability at which a frame counts as voiced
+  uint32_t hangover_ms;  // is_speech stays set this long after the last voiced frame
+} ethervox_vad_config_t;
+
+/**
+ * Per-frame analysis
+ */
+typedef struct {
+  float probability;    // Speech probability (0.0 - 1.0)
+  float rms;            // Frame RMS
+  float log_energy;     // Frame energy in dBFS
+  float noise_floor;    // Background RMS estimate after this frame
+  float zcr;            // Zero crossings per sample
+  float tilt;           // First-difference energy over 2x frame energy (~1 for white noise, low for voiced speech)
+  bool voiced;          // probability >= threshold
+  bool is_speech;       // voiced, or within the hangover of a voiced frame
+  uint32_t end_offset;  // Samples of the input buffer consumed up to the end of this frame
+  uint32_t length;      // Samples in the frame
+} ethervox_vad_frame_t;
+
+/**
+ * Get default VAD configuration (ETHERVOX_VAD_* tunables, 16 kHz)
+ */
+ethervox_vad_config_t ethervox_vad_get_default_config(void);
+
+/**
+ * Create a VAD
+ *
+ * @param config Configuration (NULL for defaults)
+ * @return VAD, or NULL if out of memory or the frame length is not 10, 20 or 30 ms
+ */
+ethervox_vad_t* ethervox_vad_create(const ethervox_vad_config_t* config);
+
+/**
+ * Free a VAD
+ */
+void ethervox_vad_destroy(ethervox_vad_t* vad);
+
+/**
+ * Forget the noise floor, hangover and any buffered partial frame
+ */
+void ethervox_vad_reset(ethervox_vad_t* vad);
+
+/**
+ * Samples per analysis frame
+ */
+uint32_t ethervox_vad_frame_samples(const ethervox_vad_t* vad);
+
+/**
+ * Analyze the next samples of the stream
+ *
+ * Samples left over after the last full frame are kept and completed by the
+ * next call. The frame array belongs to the VAD and stays valid until the
+ * next process call.
+ *
+ * @param frames Output: frames completed by these samples
+ * @param frame_count Output: number of frames
+ */
+ethervox_result_t ethervox_vad_process(ethervox_vad_t* vad, const float* samples, uint32_t count,
+                                       const ethervox_vad_frame_t** frames, uint32_t* frame_count);
+
+/**
+ * Frames analyzed since creation
+ */
+uint64_t ethervox_vad_frames_analyzed(const ethervox_vad_t* vad);
+
+/**
+ * Stateless frame features: rms, log_energy, zcr and tilt
+ *
+ * @param prev_sample Sample preceding the frame (0 at the start of a stream)
+ */
+void ethervox_vad_frame_features(const float* samples, uint32_t count, float prev_sample,
+                                 ethervox_vad_frame_t* frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ETHERVOX_VAD_H
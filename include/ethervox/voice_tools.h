@@ -50,8 +50,8 @@ typedef struct {
     // Memory store for saving transcripts
     void* memory_store;  // ethervox_memory_store_t*
     
-    // Background processing thread
-    void* capture_thread;  // pthread_t*
+    // Capture pipeline feeding STT on its own thread
+    void* capture_pipeline;  // ethervox_pipeline_t*
     
     // Speaker tracking
     int max_speaker_id;  // Highest speaker ID encountered in this session
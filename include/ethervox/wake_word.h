@@ -14,6 +14,7 @@
 
 #include "ethervox/audio.h"
 #include "ethervox/error.h"
+#include "ethervox/vad.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -101,6 +102,22 @@ ethervox_result_t ethervox_wake_process(ethervox_wake_runtime_t* runtime,
                           const ethervox_audio_buffer_t* audio_buffer,
                           ethervox_wake_result_t* result);
 
+/**
+ * Process audio the capture stream's VAD has already analyzed
+ *
+ * Use when the stream runs one VAD for every consumer (e.g. the audio
+ * pipeline's VAD stage, see ethervox_pipeline_block_t.vad_frames), so the
+ * detector's private VAD is skipped. Frame probabilities are compared with
+ * the detector's own threshold.
+ *
+ * @param frames Frames completed in audio_buffer (may be NULL when frame_count is 0)
+ * @param frame_count Number of frames
+ */
+ethervox_result_t ethervox_wake_process_frames(ethervox_wake_runtime_t* runtime,
+                                               const ethervox_audio_buffer_t* audio_buffer,
+                                               const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                                               ethervox_wake_result_t* result);
+
 /**
  * Record a reference template for wake word matching
  * 
@@ -4,8 +4,12 @@
  */
 
 #include "ethervox/aec.h"
+#include "ethervox/config.h"
+#include "ethervox/delay_estimator.h"
+#include "ethervox/dsp.h"
 #include "ethervox/logging.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -15,6 +19,10 @@
 #include <speex/speex_preprocess.h>
 #endif
 
+// The reference is shifted slightly less than the estimated delay so the
+// echo's onset falls inside the adaptive filter rather than just before it
+#define AEC_DELAY_MARGIN_MS 2
+
 struct ethervox_aec_s {
 #ifdef HAVE_SPEEXDSP
     SpeexEchoState* echo_state;        // Speex echo cancellation state
@@ -26,39 +34,30 @@ struct ethervox_aec_s {
     float* reference_frame;            // Reference signal buffer (one frame)
     float* input_frame;                // Input signal buffer (one frame)
     float* output_frame;               // Output signal buffer (one frame)
+    float* aligned_frame;              // Reference shifted by the estimated delay (one frame)
     
     int16_t* reference_i16;            // int16 conversion buffer for Speex
     int16_t* input_i16;                // int16 conversion buffer for Speex
     int16_t* output_i16;               // int16 conversion buffer for Speex
     
+    ethervox_reference_buffer_t* reference;  // Far-end samples, written by playback
+    ethervox_delay_estimator_t* estimator;   // NULL when max_delay_ms is 0
+    float* delay_line;                 // Recent reference, for the delay shift
+    uint32_t delay_mask;               // delay_line size - 1 (power of two)
+    uint32_t delay_pos;                // Next delay_line write position
+    int delay;                         // Applied shift in samples (-1 until locked)
+    
     bool active;                       // AEC enabled/disabled
 };
 
-// Convert float32 [-1.0, 1.0] to int16 [-32768, 32767]
-static void float_to_int16(const float* in, int16_t* out, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        float sample = in[i];
-        // Clamp to [-1.0, 1.0]
-        if (sample > 1.0f) sample = 1.0f;
-        if (sample < -1.0f) sample = -1.0f;
-        out[i] = (int16_t)(sample * 32767.0f);
-    }
-}
-
-// Convert int16 [-32768, 32767] to float32 [-1.0, 1.0]
-static void int16_to_float(const int16_t* in, float* out, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        out[i] = (float)in[i] / 32768.0f;
-    }
-}
-
 ethervox_aec_config_t ethervox_aec_default_config(void) {
     ethervox_aec_config_t config = {
         .sample_rate = 16000,
         .frame_size = 160,           // 10ms @ 16kHz
-        .filter_length = 1024,       // ~64ms echo tail
+        .filter_length = ETHERVOX_AEC_FILTER_MS * 16,  // Echo tail once the delay is compensated (16 samples/ms)
         .backend = ETHERVOX_AEC_SPEEX,
         .suppression_level = 0.5f,   // Moderate suppression
+        .max_delay_ms = ETHERVOX_AEC_MAX_DELAY_MS,
     };
     return config;
 }
@@ -105,6 +104,11 @@ ethervox_aec_t* ethervox_aec_create(const ethervox_aec_config_t* config) {
         return NULL;
     }
     
+    if (config->max_delay_ms < 0 || config->max_delay_ms > 2000) {
+        ETHERVOX_LOG_ERROR("Invalid max delay: %d ms (must be 0-2000)", config->max_delay_ms);
+        return NULL;
+    }
+    
     // Allocate AEC structure
     ethervox_aec_t* aec = (ethervox_aec_t*)calloc(1, sizeof(*aec));
     if (!aec) {
@@ -121,14 +125,44 @@ ethervox_aec_t* ethervox_aec_create(const ethervox_aec_config_t* config) {
     aec->reference_i16 = (int16_t*)calloc(config->frame_size, sizeof(int16_t));
     aec->input_i16 = (int16_t*)calloc(config->frame_size, sizeof(int16_t));
     aec->output_i16 = (int16_t*)calloc(config->frame_size, sizeof(int16_t));
+    aec->aligned_frame = (float*)calloc(config->frame_size, sizeof(float));
     
     if (!aec->reference_frame || !aec->input_frame || !aec->output_frame ||
-        !aec->reference_i16 || !aec->input_i16 || !aec->output_i16) {
+        !aec->reference_i16 || !aec->input_i16 || !aec->output_i16 || !aec->aligned_frame) {
         ETHERVOX_LOG_ERROR("Failed to allocate AEC buffers");
         ethervox_aec_destroy(aec);
         return NULL;
     }
     
+    // Reference buffer covers the longest delay plus 2 s of playback-ahead
+    uint32_t max_lag = (uint32_t)(config->sample_rate / 1000 * config->max_delay_ms);
+    aec->reference = ethervox_reference_buffer_create_timed(max_lag + config->sample_rate * 2,
+                                                            (uint32_t)config->sample_rate);
+    if (!aec->reference) {
+        ethervox_aec_destroy(aec);
+        return NULL;
+    }
+    
+    aec->delay = -1;
+    if (config->max_delay_ms > 0) {
+        ethervox_delay_estimator_config_t est_config = ethervox_delay_estimator_default_config();
+        est_config.sample_rate = (uint32_t)config->sample_rate;
+        est_config.max_delay_ms = (uint32_t)config->max_delay_ms;
+        aec->estimator = ethervox_delay_estimator_create(&est_config);
+        
+        uint32_t line = 1;
+        while (line < max_lag + (uint32_t)config->frame_size) {
+            line <<= 1;
+        }
+        aec->delay_line = (float*)calloc(line, sizeof(float));
+        aec->delay_mask = line - 1;
+        if (!aec->estimator || !aec->delay_line) {
+            ETHERVOX_LOG_ERROR("Failed to allocate AEC delay estimation");
+            ethervox_aec_destroy(aec);
+            return NULL;
+        }
+    }
+    
     // Create Speex echo state
     aec->echo_state = speex_echo_state_init(config->frame_size, config->filter_length);
     if (!aec->echo_state) {
@@ -161,12 +195,13 @@ ethervox_aec_t* ethervox_aec_create(const ethervox_aec_config_t* config) {
     
     aec->active = true;
     
-    ETHERVOX_LOG_INFO("Speex AEC created: %d Hz, frame=%d samples (%.1f ms), filter=%d samples (%.1f ms)",
+    ETHERVOX_LOG_INFO("Speex AEC created: %d Hz, frame=%d samples (%.1f ms), filter=%d samples (%.1f ms), max delay=%d ms",
                       config->sample_rate, 
                       config->frame_size,
                       (float)config->frame_size * 1000.0f / (float)config->sample_rate,
                       config->filter_length,
-                      (float)config->filter_length * 1000.0f / (float)config->sample_rate);
+                      (float)config->filter_length * 1000.0f / (float)config->sample_rate,
+                      config->max_delay_ms);
     
     return aec;
 }
@@ -181,25 +216,69 @@ void ethervox_aec_set_reference(ethervox_aec_t* aec, const float* reference, siz
         return;
     }
     
-    if (!reference || count != (size_t)aec->config.frame_size) {
-        ETHERVOX_LOG_ERROR("Invalid reference signal: expected %d samples, got %zu", 
-                           aec->config.frame_size, count);
+    if (!reference || count == 0) {
+        ETHERVOX_LOG_ERROR("Invalid reference signal: %zu samples", count);
         return;
     }
     
-    // Store reference frame
-    memcpy(aec->reference_frame, reference, count * sizeof(float));
+    // Queue in FIFO order; process() takes one frame per call
+    ethervox_reference_buffer_write(aec->reference, reference, count);
+}
+
+ethervox_reference_buffer_t* ethervox_aec_get_reference(ethervox_aec_t* aec) {
+    return aec ? aec->reference : NULL;
+}
+
+int ethervox_aec_get_delay(const ethervox_aec_t* aec) {
+    return aec ? aec->delay : -1;
+}
+
+int ethervox_aec_get_frame_size(const ethervox_aec_t* aec) {
+    return aec ? aec->config.frame_size : 0;
+}
+
+// Shift the reference by the estimated delay (less the margin) via the delay line
+static const float* align_reference(ethervox_aec_t* aec, const float* mic_input, size_t count) {
+    if (ethervox_delay_estimator_process(aec->estimator, aec->reference_frame, mic_input, count)) {
+        int margin = aec->config.sample_rate / 1000 * AEC_DELAY_MARGIN_MS;
+        int delay = ethervox_delay_estimator_get_delay(aec->estimator) - margin;
+        aec->delay = delay > 0 ? delay : 0;
+        
+        // The adaptive filter was converged for the old alignment
+        speex_echo_state_reset(aec->echo_state);
+        ETHERVOX_LOG_INFO("AEC echo delay compensated: %d samples (%.1f ms)", aec->delay,
+                          (float)aec->delay * 1000.0f / (float)aec->config.sample_rate);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        aec->delay_line[(aec->delay_pos + i) & aec->delay_mask] = aec->reference_frame[i];
+    }
+    uint32_t start = aec->delay_pos - (uint32_t)(aec->delay > 0 ? aec->delay : 0);
+    for (size_t i = 0; i < count; i++) {
+        aec->aligned_frame[i] = aec->delay_line[(start + i) & aec->delay_mask];
+    }
+    aec->delay_pos += (uint32_t)count;
+    
+    return aec->aligned_frame;
 }
 
 ethervox_result_t ethervox_aec_process(ethervox_aec_t* aec, 
                         float* mic_input, 
                         size_t count) {
+    return ethervox_aec_process_at(aec, mic_input, count, 0);
+}
+
+ethervox_result_t ethervox_aec_process_at(ethervox_aec_t* aec, 
+                        float* mic_input, 
+                        size_t count,
+                        uint64_t capture_time_us) {
     ETHERVOX_CHECK_PTR(aec);
     ETHERVOX_CHECK_PTR(mic_input);
     
     if (count != (size_t)aec->config.frame_size) {
-        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT,
-            "Frame size mismatch: expected %d, got %zu", aec->config.frame_size, count);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Frame size mismatch: expected %d, got %zu", aec->config.frame_size, count);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, msg);
     }
     
     // Passthrough mode or inactive - no modification needed
@@ -207,9 +286,13 @@ ethervox_result_t ethervox_aec_process(ethervox_aec_t* aec,
         return ETHERVOX_SUCCESS;
     }
     
+    // Far-end samples that were playing while this frame was captured
+    ethervox_reference_buffer_read_at(aec->reference, aec->reference_frame, count, capture_time_us);
+    const float* far_end = aec->estimator ? align_reference(aec, mic_input, count) : aec->reference_frame;
+    
     // Convert float to int16 for Speex
-    float_to_int16(aec->reference_frame, aec->reference_i16, count);
-    float_to_int16(mic_input, aec->input_i16, count);
+    ethervox_dsp_float_to_s16(far_end, aec->reference_i16, count);
+    ethervox_dsp_float_to_s16(mic_input, aec->input_i16, count);
     
     // Perform echo cancellation
     speex_echo_cancellation(aec->echo_state, 
@@ -240,7 +323,7 @@ ethervox_result_t ethervox_aec_process(ethervox_aec_t* aec,
     }
     
     // Convert back to float (in-place)
-    int16_to_float(aec->output_i16, mic_input, count);
+    ethervox_dsp_s16_to_float(aec->output_i16, mic_input, count);
     
     return ETHERVOX_SUCCESS;
 }
@@ -268,6 +351,12 @@ void ethervox_aec_reset(ethervox_aec_t* aec) {
     if (aec->output_frame) {
         memset(aec->output_frame, 0, aec->config.frame_size * sizeof(float));
     }
+    if (aec->delay_line) {
+        memset(aec->delay_line, 0, (aec->delay_mask + 1) * sizeof(float));
+    }
+    
+    // Drop queued reference; the delay estimate stays (same device, same path)
+    ethervox_reference_buffer_clear(aec->reference);
     
     ETHERVOX_LOG_DEBUG("AEC reset");
 }
@@ -291,6 +380,11 @@ void ethervox_aec_destroy(ethervox_aec_t* aec) {
     free(aec->reference_i16);
     free(aec->input_i16);
     free(aec->output_i16);
+    free(aec->aligned_frame);
+    free(aec->delay_line);
+    
+    ethervox_delay_estimator_destroy(aec->estimator);
+    ethervox_reference_buffer_destroy(aec->reference);
     
     free(aec);
     
@@ -310,11 +404,33 @@ void ethervox_aec_set_reference(ethervox_aec_t* aec, const float* reference, siz
     // No-op
 }
 
+ethervox_reference_buffer_t* ethervox_aec_get_reference(ethervox_aec_t* aec) {
+    return NULL;
+}
+
 ethervox_result_t ethervox_aec_process(ethervox_aec_t* aec, float* mic_input, size_t count) {
     // Passthrough - no processing
     return ETHERVOX_SUCCESS;
 }
 
+ethervox_result_t ethervox_aec_process_at(ethervox_aec_t* aec, float* mic_input, size_t count,
+                                          uint64_t capture_time_us) {
+    // Passthrough - no processing
+    return ETHERVOX_SUCCESS;
+}
+
+int ethervox_aec_get_delay(const ethervox_aec_t* aec) {
+    return -1;
+}
+
+int ethervox_aec_get_frame_size(const ethervox_aec_t* aec) {
+    return 0;
+}
+
+bool ethervox_aec_is_active(const ethervox_aec_t* aec) {
+    return false;
+}
+
 void ethervox_aec_reset(ethervox_aec_t* aec) {
     // No-op
 }
@@ -20,7 +20,10 @@
 #include <string.h>
 
 #include "ethervox/audio.h"
+#include "ethervox/audio_file_driver.h"
 #include "ethervox/error.h"
+#include "ethervox/noise_reduction.h"
+#include "ethervox/vad.h"
 
 static const float kEthervoxAudioLanguageConfidenceDefault = 0.85f;
 static const float kEthervoxAudioFinalConfidenceDefault = 0.90f;
@@ -40,6 +43,17 @@ ethervox_audio_config_t ethervox_audio_get_default_config(void) {
   return config;
 }
 
+// Pick the driver: hardware unless a file-backed run was asked for
+ethervox_result_t ethervox_audio_register_driver(ethervox_audio_runtime_t* runtime) {
+  ETHERVOX_CHECK_PTR(runtime);
+
+  const char* driver = getenv("ETHERVOX_AUDIO_DRIVER");
+  if (driver && strcmp(driver, "file") == 0) {
+    return ethervox_audio_register_file_driver(runtime, NULL);
+  }
+  return ethervox_audio_register_platform_driver(runtime);
+}
+
 // Initialize audio runtime
 ethervox_result_t ethervox_audio_init(ethervox_audio_runtime_t* runtime, const ethervox_audio_config_t* config) {
   ETHERVOX_CHECK_PTR(runtime);
@@ -48,8 +62,8 @@ ethervox_result_t ethervox_audio_init(ethervox_audio_runtime_t* runtime, const e
   memset(runtime, 0, sizeof(ethervox_audio_runtime_t));
   runtime->config = *config;
 
-  // Register platform-specific driver
-  ethervox_result_t result = ethervox_audio_register_platform_driver(runtime);
+  // Register platform-specific driver (or the file driver)
+  ethervox_result_t result = ethervox_audio_register_driver(runtime);
   if (ethervox_is_error(result)) {
     ETHERVOX_RETURN_ERROR(result, "Failed to register platform audio driver");
   }
@@ -66,6 +80,20 @@ ethervox_result_t ethervox_audio_init(ethervox_audio_runtime_t* runtime, const e
     }
   }
 
+  // Denoise the stream before anything downstream (VAD, wake word, STT) sees it
+  if (config->enable_noise_suppression && config->channels <= 1) {
+    ethervox_ns_config_t ns_config = ethervox_ns_get_default_config();
+    ns_config.sample_rate = config->sample_rate;
+    runtime->noise_suppressor = ethervox_ns_create(&ns_config);
+  }
+
+  // One VAD per capture stream, run by the thread that reads it
+  if (config->channels <= 1) {
+    ethervox_vad_config_t vad_config = ethervox_vad_get_default_config();
+    vad_config.sample_rate = config->sample_rate;
+    runtime->vad = ethervox_vad_create(&vad_config);
+  }
+
   return ETHERVOX_SUCCESS;
 }
 
@@ -150,7 +178,23 @@ ethervox_result_t ethervox_audio_read(ethervox_audio_runtime_t* runtime, ethervo
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio driver does not support read_audio");
   }
 
-  return runtime->driver.read_audio(runtime, buffer);
+  ethervox_result_t result = runtime->driver.read_audio(runtime, buffer);
+  if (ethervox_is_success(result) && runtime->noise_suppressor && buffer->data && buffer->channels <= 1) {
+    ethervox_ns_process(runtime->noise_suppressor, buffer->data, buffer->size);
+  }
+  return result;
+}
+
+ethervox_result_t ethervox_audio_get_capture_stats(ethervox_audio_runtime_t* runtime,
+                                                  ethervox_audio_capture_stats_t* stats) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(stats);
+
+  memset(stats, 0, sizeof(*stats));
+  if (!runtime->driver.get_capture_stats) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio driver does not report capture stats");
+  }
+  return runtime->driver.get_capture_stats(runtime, stats);
 }
 
 // Stop audio processing
@@ -189,6 +233,10 @@ void ethervox_audio_cleanup(ethervox_audio_runtime_t* runtime) {
     runtime->driver.cleanup(runtime);
   }
 
+  ethervox_ns_destroy(runtime->noise_suppressor);
+  runtime->noise_suppressor = NULL;
+  ethervox_vad_destroy(runtime->vad);
+  runtime->vad = NULL;
   runtime->is_initialized = false;
 }
 
@@ -0,0 +1,714 @@
+/**
+ * @file audio_file_driver.c
+ * @brief File-backed virtual audio device
+ *
+ * Capture and playback go through the same SPSC rings as the hardware
+ * drivers. Under real-time pacing a clock thread plays the part of the
+ * device: every period it moves one period of the capture file into the
+ * capture ring and one period of the playback ring into the sink. Under
+ * fast pacing there is no thread; reads pull straight from the file and
+ * writes go straight to the sink, and timestamps come from the sample
+ * position so every run produces the same stream.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include "ethervox/audio_file_driver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/config.h"
+#include "ethervox/logging.h"
+
+static uint32_t file_env_u32(const char* name, uint32_t fallback) {
+  const char* value = getenv(name);
+  if (!value || !*value) {
+    return fallback;
+  }
+  char* end = NULL;
+  unsigned long parsed = strtoul(value, &end, 10);
+  return (end && *end == '\0' && parsed <= UINT32_MAX) ? (uint32_t)parsed : fallback;
+}
+
+ethervox_audio_file_config_t ethervox_audio_file_default_config(void) {
+  ethervox_audio_file_config_t config = {.capture_path = NULL,
+                                         .playback_path = NULL,
+                                         .pacing = ETHERVOX_AUDIO_FILE_REALTIME,
+                                         .loop = false,
+                                         .tail_silence_ms = 1000,
+                                         .period_ms = 10,
+                                         .jitter_us = 0,
+                                         .xrun_every_ms = 0,
+                                         .seed = 1};
+  return config;
+}
+
+static ethervox_audio_file_config_t file_config_from_env(void) {
+  ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+  const char* capture = getenv("ETHERVOX_AUDIO_CAPTURE_FILE");
+  const char* playback = getenv("ETHERVOX_AUDIO_PLAYBACK_FILE");
+  const char* pacing = getenv("ETHERVOX_AUDIO_PACING");
+
+  config.capture_path = (capture && *capture) ? capture : NULL;
+  config.playback_path = (playback && *playback) ? playback : NULL;
+  if (pacing && strcmp(pacing, "fast") == 0) {
+    config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+  }
+  config.loop = file_env_u32("ETHERVOX_AUDIO_LOOP", 0) != 0;
+  config.tail_silence_ms = file_env_u32("ETHERVOX_AUDIO_TAIL_MS", config.tail_silence_ms);
+  config.period_ms = file_env_u32("ETHERVOX_AUDIO_PERIOD_MS", config.period_ms);
+  config.jitter_us = file_env_u32("ETHERVOX_AUDIO_JITTER_US", config.jitter_us);
+  config.xrun_every_ms = file_env_u32("ETHERVOX_AUDIO_XRUN_MS", config.xrun_every_ms);
+  config.seed = file_env_u32("ETHERVOX_AUDIO_SEED", config.seed);
+  return config;
+}
+
+#ifdef _WIN32
+
+ethervox_result_t ethervox_audio_register_file_driver(ethervox_audio_runtime_t* runtime,
+                                                      const ethervox_audio_file_config_t* config) {
+  ETHERVOX_CHECK_PTR(runtime);
+  (void)config;
+  (void)file_config_from_env;
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "File audio driver needs pthreads");
+}
+
+bool ethervox_audio_file_capture_finished(const ethervox_audio_runtime_t* runtime) {
+  (void)runtime;
+  return false;
+}
+
+#else
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "ethervox/audio_buffer.h"
+#include "ethervox/dsp.h"
+#include "ethervox/audio_recording.h"
+#include "ethervox/reference_buffer.h"
+
+static const uint64_t kFileVirtualClockOriginUs = 1000000ULL;  // Fast pacing: t of sample 0 (0 = unstamped)
+static const int kFileReadTimeoutMs = 100;                      // Longest a real-time read waits for a period
+static const uint32_t kFileRingSeconds = 10U;
+enum { kFileWriteBlock = 512 };                                  // Samples converted per write_audio step
+enum { kFileResampleBlock = 1024 };                              // Frames per resampler call when loading
+
+typedef struct {
+  ethervox_audio_file_config_t config;  // Paths point at the copies below
+  char* capture_path;
+  char* playback_path;
+  uint32_t sample_rate;
+  uint32_t channels;
+  uint32_t period_frames;
+
+  // Capture stream: the file, then tail silence (endless when looping or
+  // when there is no file). Positions count frames, including lost ones.
+  float* source;
+  uint32_t source_frames;
+  uint64_t position;
+  uint64_t end_position;
+  uint64_t next_xrun;
+  uint64_t xrun_interval;
+  atomic_bool finished;
+
+  // Playback sink
+  FILE* sink;
+  uint32_t sink_bytes;
+  int16_t* sink_scratch;
+
+  // Real-time pacing
+  ethervox_audio_ring_t* capture_ring;
+  ethervox_audio_ring_t* playback_ring;
+  float* period_buffer;
+  pthread_t clock_thread;
+  bool thread_started;
+  atomic_bool running;
+  atomic_bool is_recording;
+  atomic_bool is_playing;
+  pthread_mutex_t mutex;
+  pthread_cond_t delivered;
+  uint32_t rng;
+
+  atomic_uint_fast64_t frames_captured;
+  atomic_uint_fast64_t xruns;
+  atomic_uint_fast64_t samples_dropped;
+  atomic_uint_fast32_t max_wakeup_gap_us;
+} file_audio_state_t;
+
+static ethervox_result_t file_audio_read(ethervox_audio_runtime_t* runtime, ethervox_audio_buffer_t* buffer);
+
+static uint64_t file_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * ETHERVOX_PLATFORM_US_PER_SEC + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static void file_sleep_until(uint64_t deadline_us) {
+  uint64_t now = file_now_us();
+  if (deadline_us <= now) {
+    return;
+  }
+  uint64_t wait = deadline_us - now;
+  struct timespec ts = {(time_t)(wait / ETHERVOX_PLATFORM_US_PER_SEC),
+                        (long)(wait % ETHERVOX_PLATFORM_US_PER_SEC) * 1000L};
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+  }
+}
+
+static uint64_t file_frames_to_us(const file_audio_state_t* state, uint64_t frames) {
+  return frames * ETHERVOX_PLATFORM_US_PER_SEC / state->sample_rate;
+}
+
+// xorshift32: reproducible jitter for a given seed
+static uint32_t file_next_random(file_audio_state_t* state) {
+  uint32_t x = state->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  state->rng = x;
+  return x;
+}
+
+// Copy stream frames [position, position + frames) without fault injection
+static void file_copy_stream(const file_audio_state_t* state, uint64_t position, float* out,
+                             uint32_t frames) {
+  while (frames > 0) {
+    if (!state->source || (!state->config.loop && position >= state->source_frames)) {
+      memset(out, 0, (size_t)frames * state->channels * sizeof(float));
+      return;
+    }
+    uint32_t offset = (uint32_t)(position % state->source_frames);
+    uint32_t n = state->source_frames - offset;
+    if (n > frames) n = frames;
+    memcpy(out, state->source + (size_t)offset * state->channels, (size_t)n * state->channels * sizeof(float));
+    out += (size_t)n * state->channels;
+    position += n;
+    frames -= n;
+  }
+}
+
+// Take up to `frames` frames from the capture stream, losing a period at
+// each injected xrun. Returns the frames delivered (fewer only at the end).
+static uint32_t file_source_pull(file_audio_state_t* state, float* out, uint32_t frames,
+                                 uint64_t* first_position) {
+  uint32_t done = 0;
+  *first_position = state->position;
+
+  while (done < frames) {
+    if (state->position >= state->end_position) {
+      atomic_store(&state->finished, true);
+      break;
+    }
+    if (state->position >= state->next_xrun) {
+      // The "device" overran: this period never reaches the reader
+      state->position += state->period_frames;
+      state->next_xrun += state->xrun_interval;
+      atomic_fetch_add(&state->xruns, 1);
+      if (done == 0) {
+        *first_position = state->position;
+      }
+      continue;
+    }
+
+    uint64_t limit = state->end_position < state->next_xrun ? state->end_position : state->next_xrun;
+    uint32_t n = frames - done;
+    if ((uint64_t)n > limit - state->position) {
+      n = (uint32_t)(limit - state->position);
+    }
+    file_copy_stream(state, state->position, out + (size_t)done * state->channels, n);
+    state->position += n;
+    done += n;
+  }
+
+  atomic_fetch_add(&state->frames_captured, done);
+  return done;
+}
+
+// Append int16 samples to the sink, and hand the float version to the AEC
+static void file_sink_write(ethervox_audio_runtime_t* runtime, file_audio_state_t* state,
+                            const float* samples, uint32_t count, uint64_t play_time_us) {
+  if (runtime->echo_reference && state->channels == 1) {
+    ethervox_reference_buffer_write_at(runtime->echo_reference, samples, count, play_time_us);
+  }
+  if (!state->sink) {
+    return;
+  }
+  ethervox_dsp_float_to_s16(samples, state->sink_scratch, count);
+  state->sink_bytes += (uint32_t)(fwrite(state->sink_scratch, sizeof(int16_t), count, state->sink) *
+                                  sizeof(int16_t));
+}
+
+static void* file_clock_thread(void* arg) {
+  ethervox_audio_runtime_t* runtime = (ethervox_audio_runtime_t*)arg;
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  const uint32_t period_samples = state->period_frames * state->channels;
+  const uint64_t period_us = file_frames_to_us(state, state->period_frames);
+  uint64_t next_us = file_now_us();
+  uint64_t last_wake_us = 0;
+
+  while (atomic_load(&state->running)) {
+    // Each period is captured over [next, next + period) and delivered at its
+    // end, plus any injected lateness
+    uint64_t period_start_us = next_us;
+    next_us += period_us;
+    uint64_t late_us = state->config.jitter_us ? file_next_random(state) % (state->config.jitter_us + 1) : 0;
+    file_sleep_until(next_us + late_us);
+
+    uint64_t now_us = file_now_us();
+    if (last_wake_us != 0 && now_us - last_wake_us > atomic_load(&state->max_wakeup_gap_us)) {
+      atomic_store(&state->max_wakeup_gap_us, (uint_fast32_t)(now_us - last_wake_us));
+    }
+    last_wake_us = now_us;
+
+    if (atomic_load(&state->is_recording) && !atomic_load(&state->finished)) {
+      uint64_t first_position;
+      uint32_t frames = file_source_pull(state, state->period_buffer, state->period_frames, &first_position);
+      if (frames > 0) {
+        uint32_t count = frames * state->channels;
+        uint32_t written = ethervox_audio_ring_write(state->capture_ring, state->period_buffer, count,
+                                                     period_start_us);
+        if (written < count) {
+          atomic_fetch_add(&state->samples_dropped, count - written);
+        }
+      }
+      pthread_mutex_lock(&state->mutex);
+      pthread_cond_broadcast(&state->delivered);
+      pthread_mutex_unlock(&state->mutex);
+    }
+
+    // A device plays one period per period; only queued audio reaches the sink
+    if (atomic_load(&state->is_playing)) {
+      uint32_t queued = ethervox_audio_ring_available(state->playback_ring);
+      uint32_t count = queued < period_samples ? queued : period_samples;
+      if (count > 0) {
+        ethervox_audio_ring_read(state->playback_ring, state->period_buffer, count, NULL);
+        file_sink_write(runtime, state, state->period_buffer, count, now_us);
+      }
+    }
+  }
+  return NULL;
+}
+
+// Bring the (already channel-matched) capture file to the runtime rate, one
+// channel at a time, trimming the filter delay so sample 0 stays sample 0
+static ethervox_result_t file_resample_capture(file_audio_state_t* state, float** samples,
+                                               uint32_t* frames, uint32_t rate) {
+  const uint32_t channels = state->channels;
+  const uint32_t out_frames = (uint32_t)((uint64_t)*frames * state->sample_rate / rate);
+  ethervox_resampler_t* resampler = ethervox_resampler_create(rate, state->sample_rate, kFileResampleBlock);
+  float* out = (float*)malloc(((size_t)out_frames * channels + 1) * sizeof(float));
+  float* block_out = resampler ? (float*)malloc(ethervox_resampler_max_output(resampler, kFileResampleBlock) *
+                                                sizeof(float))
+                               : NULL;
+  if (!resampler || !out || !block_out) {
+    ethervox_result_t error = resampler ? ETHERVOX_ERROR_OUT_OF_MEMORY : ETHERVOX_ERROR_AUDIO_FORMAT_UNSUPPORTED;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Cannot resample capture file from %u Hz to %u Hz", rate, state->sample_rate);
+    ethervox_resampler_destroy(resampler);
+    free(out);
+    free(block_out);
+    ETHERVOX_RETURN_ERROR(error, msg);
+  }
+
+  const uint64_t delay = ((uint64_t)ethervox_resampler_latency(resampler) * state->sample_rate + rate / 2) / rate;
+  float block_in[kFileResampleBlock];
+  for (uint32_t c = 0; c < channels; c++) {
+    ethervox_resampler_reset(resampler);
+    uint64_t produced = 0;  // Output samples so far, including the filter delay
+    // Past the end of the file the filter is flushed with silence
+    for (uint32_t pos = 0; produced < delay + out_frames; pos += kFileResampleBlock) {
+      for (uint32_t i = 0; i < kFileResampleBlock; i++) {
+        uint64_t f = (uint64_t)pos + i;
+        block_in[i] = f < *frames ? (*samples)[f * channels + c] : 0.0f;
+      }
+      size_t n = ethervox_resampler_process(resampler, block_in, kFileResampleBlock, block_out);
+      for (size_t i = 0; i < n; i++, produced++) {
+        if (produced >= delay && produced < delay + out_frames) {
+          out[(size_t)(produced - delay) * channels + c] = block_out[i];
+        }
+      }
+    }
+  }
+
+  ETHERVOX_LOG_INFO("Capture file resampled from %u Hz to %u Hz", rate, state->sample_rate);
+  ethervox_resampler_destroy(resampler);
+  free(block_out);
+  free(*samples);
+  *samples = out;
+  *frames = out_frames;
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_load_capture(file_audio_state_t* state) {
+  float* samples = NULL;
+  uint32_t frames = 0, rate = 0;
+  uint16_t channels = 0;
+  ethervox_result_t result =
+      ethervox_audio_read_wav(state->capture_path, &samples, &frames, &rate, &channels);
+  if (ethervox_is_error(result)) {
+    return result;
+  }
+
+  if (channels != state->channels && state->channels != 1) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Capture file has %u channels, runtime expects %u",
+             channels, state->channels);
+    free(samples);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_FORMAT_UNSUPPORTED, msg);
+  }
+
+  // Mono runtime, multichannel file: average the channels in place
+  if (channels != state->channels) {
+    for (uint32_t f = 0; f < frames; f++) {
+      float sum = 0.0f;
+      for (uint16_t c = 0; c < channels; c++) {
+        sum += samples[(size_t)f * channels + c];
+      }
+      samples[f] = sum / (float)channels;
+    }
+  }
+
+  // A 44.1/48 kHz recording plays into a 16 kHz runtime like a resampling mic
+  if (rate != state->sample_rate) {
+    result = file_resample_capture(state, &samples, &frames, rate);
+    if (ethervox_is_error(result)) {
+      free(samples);
+      return result;
+    }
+  }
+
+  state->source = samples;
+  state->source_frames = frames;
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_init(ethervox_audio_runtime_t* runtime,
+                                         const ethervox_audio_config_t* config) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(config);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  if (state->thread_started || state->period_buffer) {
+    return ETHERVOX_ERROR_ALREADY_INITIALIZED;
+  }
+
+  state->sample_rate = config->sample_rate ? config->sample_rate : ETHERVOX_AUDIO_SAMPLE_RATE;
+  state->channels = config->channels ? config->channels : 1;
+  uint32_t period_ms = state->config.period_ms ? state->config.period_ms : 10;
+  state->period_frames = state->sample_rate * period_ms / 1000;
+  if (state->period_frames == 0) {
+    state->period_frames = 1;
+  }
+
+  if (state->capture_path) {
+    ethervox_result_t result = file_load_capture(state);
+    if (ethervox_is_error(result)) {
+      return result;
+    }
+  }
+  state->position = 0;
+  state->end_position = (state->source && !state->config.loop)
+                            ? state->source_frames + (uint64_t)state->sample_rate * state->config.tail_silence_ms / 1000
+                            : UINT64_MAX;
+  state->xrun_interval = (uint64_t)state->sample_rate * state->config.xrun_every_ms / 1000;
+  state->next_xrun = state->xrun_interval ? state->xrun_interval : UINT64_MAX;
+  state->rng = state->config.seed ? state->config.seed : 1;
+
+  uint32_t ring_samples = state->sample_rate * state->channels * kFileRingSeconds;
+  state->period_buffer = (float*)malloc((size_t)state->period_frames * state->channels * sizeof(float));
+  uint32_t scratch_samples = state->period_frames * state->channels;
+  if (scratch_samples < kFileWriteBlock) {
+    scratch_samples = kFileWriteBlock;
+  }
+  state->sink_scratch = (int16_t*)malloc((size_t)scratch_samples * sizeof(int16_t));
+  if (state->config.pacing == ETHERVOX_AUDIO_FILE_REALTIME) {
+    state->capture_ring = ethervox_audio_ring_create(ring_samples, state->sample_rate * state->channels);
+    state->playback_ring = ethervox_audio_ring_create(ring_samples, 0);
+  }
+  if (!state->period_buffer || !state->sink_scratch ||
+      (state->config.pacing == ETHERVOX_AUDIO_FILE_REALTIME && (!state->capture_ring || !state->playback_ring))) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate file audio buffers");
+  }
+
+  if (state->playback_path) {
+    state->sink = fopen(state->playback_path, "wb");
+    if (!state->sink) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FILE_WRITE, "Cannot create playback sink file");
+    }
+    ethervox_audio_write_wav_header(state->sink, (int)state->sample_rate, (int)state->channels, 0);
+  }
+
+  if (state->config.pacing == ETHERVOX_AUDIO_FILE_REALTIME) {
+    atomic_store(&state->running, true);
+    if (pthread_create(&state->clock_thread, NULL, file_clock_thread, runtime) != 0) {
+      atomic_store(&state->running, false);
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to start file audio clock thread");
+    }
+    state->thread_started = true;
+    runtime->playback_ring = state->playback_ring;
+  }
+
+  ETHERVOX_LOG_INFO("File audio driver: capture %s, playback %s, %s pacing, %u ms periods",
+                    state->capture_path ? state->capture_path : "(silence)",
+                    state->playback_path ? state->playback_path : "(discarded)",
+                    state->config.pacing == ETHERVOX_AUDIO_FILE_FAST ? "fast" : "real-time", period_ms);
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_start_capture(ethervox_audio_runtime_t* runtime) {
+  ETHERVOX_CHECK_PTR(runtime);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  if (!state->period_buffer) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_INITIALIZED, "File audio driver not initialized");
+  }
+  atomic_store(&state->is_recording, true);
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_stop_capture(ethervox_audio_runtime_t* runtime) {
+  ETHERVOX_CHECK_PTR(runtime);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  atomic_store(&state->is_recording, false);
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_start_playback(ethervox_audio_runtime_t* runtime) {
+  ETHERVOX_CHECK_PTR(runtime);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  atomic_store(&state->is_playing, true);
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_stop_playback(ethervox_audio_runtime_t* runtime) {
+  ETHERVOX_CHECK_PTR(runtime);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  atomic_store(&state->is_playing, false);
+  if (state->playback_ring) {
+    ethervox_audio_ring_request_flush(state->playback_ring);
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_read(ethervox_audio_runtime_t* runtime, ethervox_audio_buffer_t* buffer) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(buffer);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  if (!atomic_load(&state->is_recording)) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_INITIALIZED, "Capture not started");
+  }
+
+  // Callers without a buffer get one of config.buffer_size frames (freed
+  // with ethervox_audio_buffer_free), as from the hardware drivers
+  if (!buffer->data) {
+    uint32_t frames = runtime->config.buffer_size ? runtime->config.buffer_size : state->period_frames;
+    size_t samples = (size_t)frames * state->channels;
+    buffer->data = (float*)malloc(samples * sizeof(float));
+    if (!buffer->data) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture buffer");
+    }
+    buffer->size = (uint32_t)samples;
+  }
+
+  uint32_t capacity = buffer->size - buffer->size % state->channels;
+  buffer->channels = state->channels;
+
+  if (state->config.pacing == ETHERVOX_AUDIO_FILE_FAST) {
+    uint64_t first_position;
+    uint32_t frames = file_source_pull(state, buffer->data, capacity / state->channels, &first_position);
+    buffer->size = frames * state->channels;
+    buffer->timestamp_us = frames ? kFileVirtualClockOriginUs + file_frames_to_us(state, first_position) : 0;
+    return ETHERVOX_SUCCESS;
+  }
+
+  // Real time: wait for the clock thread's next period, like a device read
+  uint32_t wanted = state->period_frames * state->channels;
+  if (wanted > capacity) {
+    wanted = capacity;
+  }
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_nsec += (long)kFileReadTimeoutMs * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  pthread_mutex_lock(&state->mutex);
+  while (ethervox_audio_ring_available(state->capture_ring) < wanted && !atomic_load(&state->finished)) {
+    if (pthread_cond_timedwait(&state->delivered, &state->mutex, &deadline) == ETIMEDOUT) {
+      break;
+    }
+  }
+  pthread_mutex_unlock(&state->mutex);
+
+  uint32_t available = ethervox_audio_ring_available(state->capture_ring);
+  uint32_t to_read = available < capacity ? available : capacity;
+  to_read -= to_read % state->channels;
+  uint64_t timestamp_us = 0;
+  buffer->size = ethervox_audio_ring_read(state->capture_ring, buffer->data, to_read, &timestamp_us);
+  buffer->timestamp_us = timestamp_us;
+  return ETHERVOX_SUCCESS;
+}
+
+// Same contract as the hardware drivers: int16 samples, size in bytes
+static ethervox_result_t file_audio_write(ethervox_audio_runtime_t* runtime, const ethervox_audio_buffer_t* buffer) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(buffer);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+  if (buffer->size == 0) {
+    return ETHERVOX_SUCCESS;
+  }
+  ETHERVOX_CHECK_PTR(buffer->data);
+
+  atomic_store(&state->is_playing, true);
+  const int16_t* samples = (const int16_t*)buffer->data;
+  uint32_t remaining = buffer->size / sizeof(int16_t);
+  float block[kFileWriteBlock];
+
+  while (remaining > 0) {
+    uint32_t n = remaining < kFileWriteBlock ? remaining : kFileWriteBlock;
+    ethervox_dsp_s16_to_float(samples, block, n);
+
+    if (state->config.pacing == ETHERVOX_AUDIO_FILE_FAST) {
+      // Plays "now" on the virtual clock: where capture currently stands
+      uint64_t play_time_us = kFileVirtualClockOriginUs + file_frames_to_us(state, state->position);
+      file_sink_write(runtime, state, block, n, play_time_us);
+    } else {
+      uint32_t written = ethervox_audio_ring_write(state->playback_ring, block, n, 0);
+      if (written < n) {
+        ETHERVOX_LOG_WARN("File audio playback queue full, dropped %u samples", n - written);
+      }
+    }
+    samples += n;
+    remaining -= n;
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+static ethervox_result_t file_audio_get_capture_stats(ethervox_audio_runtime_t* runtime,
+                                                      ethervox_audio_capture_stats_t* stats) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(stats);
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+  ETHERVOX_CHECK_PTR(state);
+
+  stats->frames_captured = atomic_load(&state->frames_captured);
+  stats->xruns = atomic_load(&state->xruns);
+  stats->samples_dropped = atomic_load(&state->samples_dropped);
+  stats->max_wakeup_gap_us = (uint32_t)atomic_load(&state->max_wakeup_gap_us);
+  stats->period_frames = state->period_frames;
+  stats->buffer_frames = state->period_frames;
+  stats->realtime = false;
+  stats->mmap = false;
+  return ETHERVOX_SUCCESS;
+}
+
+static void file_audio_cleanup(ethervox_audio_runtime_t* runtime) {
+  if (!runtime || !runtime->platform_data) {
+    return;
+  }
+  file_audio_state_t* state = (file_audio_state_t*)runtime->platform_data;
+
+  if (state->thread_started) {
+    atomic_store(&state->running, false);
+    pthread_join(state->clock_thread, NULL);
+  }
+  if (runtime->playback_ring == state->playback_ring) {
+    runtime->playback_ring = NULL;
+  }
+
+  if (state->sink) {
+    // Patch the header now that the length is known
+    fseek(state->sink, 0, SEEK_SET);
+    ethervox_audio_write_wav_header(state->sink, (int)state->sample_rate, (int)state->channels,
+                                    state->sink_bytes);
+    fclose(state->sink);
+  }
+
+  ethervox_audio_ring_destroy(state->capture_ring);
+  ethervox_audio_ring_destroy(state->playback_ring);
+  pthread_mutex_destroy(&state->mutex);
+  pthread_cond_destroy(&state->delivered);
+  free(state->source);
+  free(state->period_buffer);
+  free(state->sink_scratch);
+  free(state->capture_path);
+  free(state->playback_path);
+  free(state);
+  runtime->platform_data = NULL;
+}
+
+static char* file_strdup(const char* s) {
+  if (!s) {
+    return NULL;
+  }
+  size_t len = strlen(s) + 1;
+  char* copy = (char*)malloc(len);
+  if (copy) {
+    memcpy(copy, s, len);
+  }
+  return copy;
+}
+
+ethervox_result_t ethervox_audio_register_file_driver(ethervox_audio_runtime_t* runtime,
+                                                      const ethervox_audio_file_config_t* config) {
+  ETHERVOX_CHECK_PTR(runtime);
+
+  file_audio_state_t* state = (file_audio_state_t*)calloc(1, sizeof(file_audio_state_t));
+  if (!state) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate file audio state");
+  }
+
+  state->config = config ? *config : file_config_from_env();
+  state->capture_path = file_strdup(state->config.capture_path);
+  state->playback_path = file_strdup(state->config.playback_path);
+  if ((state->config.capture_path && !state->capture_path) ||
+      (state->config.playback_path && !state->playback_path)) {
+    free(state->capture_path);
+    free(state->playback_path);
+    free(state);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to copy file audio paths");
+  }
+  state->config.capture_path = state->capture_path;
+  state->config.playback_path = state->playback_path;
+  pthread_mutex_init(&state->mutex, NULL);
+  pthread_cond_init(&state->delivered, NULL);
+
+  // The driver state exists before init() so that init() can see the config
+  runtime->platform_data = state;
+  runtime->driver.init = file_audio_init;
+  runtime->driver.start_capture = file_audio_start_capture;
+  runtime->driver.stop_capture = file_audio_stop_capture;
+  runtime->driver.start_playback = file_audio_start_playback;
+  runtime->driver.stop_playback = file_audio_stop_playback;
+  runtime->driver.read_audio = file_audio_read;
+  runtime->driver.write_audio = file_audio_write;
+  runtime->driver.get_capture_stats = file_audio_get_capture_stats;
+  runtime->driver.cleanup = file_audio_cleanup;
+
+  return ETHERVOX_SUCCESS;
+}
+
+bool ethervox_audio_file_capture_finished(const ethervox_audio_runtime_t* runtime) {
+  if (!runtime || runtime->driver.read_audio != file_audio_read || !runtime->platform_data) {
+    return false;
+  }
+  const file_audio_state_t* state = (const file_audio_state_t*)runtime->platform_data;
+  if (!atomic_load(&state->finished)) {
+    return false;
+  }
+  return !state->capture_ring || ethervox_audio_ring_available(state->capture_ring) == 0;
+}
+
+#endif  // _WIN32
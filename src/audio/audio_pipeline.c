@@ -0,0 +1,1250 @@
+/**
+ * @file audio_pipeline.c
+ * @brief Declarative audio front end with per-stage threads
+ *
+ * The capture thread reads the driver, beamforms or downmixes, resamples
+ * and cuts the stream into blocks, then runs the processing stages (AEC, noise
+ * suppression, VAD) and the fan-out inline until it reaches a stage or sink
+ * with a thread of its own; there it hands the block to that thread's
+ * queue and moves on. Each queue is an SPSC audio ring plus one metadata
+ * slot per block, indexed by stream position, so the metadata is published
+ * by the same release that publishes the samples.
+ *
+ * The VAD stage's frames ride along in the metadata (copied into per-slot
+ * storage at each queue), so the stream is analyzed once and every sink
+ * sees the same per-frame probabilities.
+ *
+ * Producers never block: a full queue drops the block (counted per stage)
+ * and a consumer is woken with a trylock'd signal. A wakeup lost to the
+ * trylock costs at most one block period, since consumers wait in slices
+ * of block_ms.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // cpu_set_t and pthread_setaffinity_np
+#endif
+
+#include "ethervox/audio_pipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/config.h"
+#include "ethervox/logging.h"
+
+static const char* const kPipelineStageNames[ETHERVOX_PIPELINE_STAGE_COUNT] = {
+    "capture", "beamform", "resample", "aec", "noise_suppression", "vad"};
+
+const char* ethervox_pipeline_stage_name(ethervox_pipeline_stage_t stage) {
+  return (stage >= 0 && stage < ETHERVOX_PIPELINE_STAGE_COUNT) ? kPipelineStageNames[stage] : "unknown";
+}
+
+ethervox_pipeline_config_t ethervox_pipeline_default_config(ethervox_audio_runtime_t* runtime) {
+  ethervox_pipeline_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.runtime = runtime;
+  config.sample_rate = 16000;
+  config.block_ms = ETHERVOX_PIPELINE_BLOCK_MS;
+  config.queue_ms = ETHERVOX_PIPELINE_QUEUE_MS;
+  config.noise_suppression = true;
+  config.ns_config = ethervox_ns_get_default_config();
+  config.vad = true;
+  config.vad_config = ethervox_vad_get_default_config();
+  config.beamforming = true;
+  config.beamformer_config = runtime ? ethervox_beamformer_default_config(runtime->config.channels,
+                                                                          runtime->config.sample_rate)
+                                     : ethervox_beamformer_default_config(1, config.sample_rate);
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    config.threads[i].own_thread = false;
+    config.threads[i].cpu = -1;
+    config.threads[i].rt_priority = 0;
+  }
+  config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].own_thread = true;
+  config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].rt_priority = ETHERVOX_PIPELINE_RT_PRIORITY;
+  return config;
+}
+
+ethervox_result_t ethervox_pipeline_add_sink(ethervox_pipeline_config_t* config,
+                                             const ethervox_pipeline_sink_config_t* sink) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(sink);
+  if (config->sink_count >= ETHERVOX_PIPELINE_MAX_SINKS) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Too many pipeline sinks");
+  }
+  config->sinks[config->sink_count++] = *sink;
+  return ETHERVOX_SUCCESS;
+}
+
+#ifdef _WIN32
+
+struct ethervox_pipeline {
+  int unused;
+};
+
+ethervox_result_t ethervox_pipeline_create(const ethervox_pipeline_config_t* config,
+                                           ethervox_pipeline_t** pipeline_out) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(pipeline_out);
+  *pipeline_out = NULL;
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio pipeline needs pthreads");
+}
+
+ethervox_result_t ethervox_pipeline_start(ethervox_pipeline_t* pipeline) {
+  (void)pipeline;
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio pipeline needs pthreads");
+}
+
+ethervox_result_t ethervox_pipeline_stop(ethervox_pipeline_t* pipeline) {
+  (void)pipeline;
+  return ETHERVOX_SUCCESS;
+}
+
+bool ethervox_pipeline_is_running(const ethervox_pipeline_t* pipeline) {
+  (void)pipeline;
+  return false;
+}
+
+ethervox_result_t ethervox_pipeline_read(ethervox_pipeline_t* pipeline, uint32_t sink, float* samples,
+                                         uint32_t capacity, uint32_t timeout_ms,
+                                         ethervox_pipeline_block_t* block) {
+  (void)pipeline;
+  (void)sink;
+  (void)samples;
+  (void)capacity;
+  (void)timeout_ms;
+  (void)block;
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio pipeline needs pthreads");
+}
+
+ethervox_result_t ethervox_pipeline_get_metrics(const ethervox_pipeline_t* pipeline,
+                                                ethervox_pipeline_metrics_t* metrics) {
+  (void)pipeline;
+  ETHERVOX_CHECK_PTR(metrics);
+  memset(metrics, 0, sizeof(*metrics));
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio pipeline needs pthreads");
+}
+
+ethervox_result_t ethervox_pipeline_get_doa(const ethervox_pipeline_t* pipeline, ethervox_doa_t* doa) {
+  (void)pipeline;
+  ETHERVOX_CHECK_PTR(doa);
+  memset(doa, 0, sizeof(*doa));
+  ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio pipeline needs pthreads");
+}
+
+void ethervox_pipeline_destroy(ethervox_pipeline_t* pipeline) {
+  (void)pipeline;
+}
+
+#else
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ethervox/audio_buffer.h"
+#include "ethervox/dsp.h"
+
+enum { kPipelineCaptureBlocks = 4 };  // Most capture-rate audio taken from the driver per read, in blocks
+
+// Travels with each block through the queues
+typedef struct {
+  uint64_t timestamp_us;  // Capture time of the first sample (0 = unknown)
+  uint64_t entered_us;    // When the capture thread cut the block
+  float speech_probability;
+  bool is_speech;
+  const ethervox_vad_frame_t* frames;  // VAD frames completed in the block(s), end_offset within them
+  uint32_t frame_count;
+} pipeline_meta_t;
+
+typedef struct {
+  ethervox_audio_ring_t* ring;
+  pipeline_meta_t* meta;         // One slot per block, indexed by stream position / block
+  ethervox_vad_frame_t* frames;  // slot_frames per meta slot (queues past the VAD stage)
+  uint32_t slot_frames;
+  uint32_t slots;
+  pthread_mutex_t mutex;
+  pthread_cond_t ready;
+} pipeline_queue_t;
+
+typedef struct {
+  atomic_uint_fast64_t blocks;
+  atomic_uint_fast64_t calls;
+  atomic_uint_fast64_t dropped;
+  atomic_uint_fast64_t process_us_total;
+  atomic_uint_fast64_t latency_us_total;
+  atomic_uint_fast32_t max_process_us;
+  atomic_uint_fast32_t max_latency_us;
+  atomic_bool realtime;
+} pipeline_counters_t;
+
+// A processing stage or a sink
+typedef struct {
+  struct ethervox_pipeline* pipeline;
+  int index;   // Stage or sink index
+  int order;   // Position among the active processing stages (stages only)
+  bool active;
+  bool is_sink;
+  ethervox_pipeline_thread_config_t thread;
+  ethervox_pipeline_sink_config_t sink;
+  uint32_t call_blocks;     // Blocks per sink call
+  pipeline_queue_t* queue;  // NULL when inline
+  float* scratch;           // Worker's copy of the blocks it dequeues
+  ethervox_vad_frame_t* frames;  // Their VAD frames (sinks only)
+  pthread_t tid;
+  bool thread_started;
+  pipeline_counters_t counters;
+} pipeline_node_t;
+
+struct ethervox_pipeline {
+  ethervox_pipeline_config_t config;
+  uint32_t block;  // Samples per block at the pipeline rate
+  uint32_t capture_rate;
+  uint32_t capture_channels;
+
+  // Capture thread state
+  pthread_t capture_tid;
+  bool capture_started;
+  float* capture_buffer;  // Interleaved, capture rate
+  uint32_t capture_capacity;
+  ethervox_beamformer_t* beamformer;
+  float* beamformed;      // Mono, capture rate
+  ethervox_resampler_t* resampler;
+  float* resampled;
+  float* pending;  // Mono at the pipeline rate, waiting to fill a block
+  uint32_t pending_count;
+  uint64_t pending_timestamp_us;
+  uint64_t capture_latency_us;  // Beamformer and resampler delay
+  uint64_t position;
+
+  // Stages
+  ethervox_ns_t* ns;
+  ethervox_vad_t* vad;
+  uint32_t block_frames;  // Most VAD frames a block can complete
+  uint32_t aec_frame;
+  bool last_speech;
+  uint64_t aec_failures;
+  pipeline_node_t stages[ETHERVOX_PIPELINE_STAGE_COUNT];
+  int active[ETHERVOX_PIPELINE_STAGE_COUNT];  // Processing stages in stream order
+  int active_count;
+  pipeline_node_t sinks[ETHERVOX_PIPELINE_MAX_SINKS];
+
+  atomic_bool running;
+  atomic_bool capture_failed;
+  atomic_bool flushed;  // Stopping: every stage has drained into the sink queues
+};
+
+static uint64_t pipeline_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * ETHERVOX_PLATFORM_US_PER_SEC + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static uint64_t pipeline_samples_to_us(uint64_t samples, uint32_t rate) {
+  return samples * ETHERVOX_PLATFORM_US_PER_SEC / rate;
+}
+
+// ----------------------------------------------------------------------------
+// Metrics
+// ----------------------------------------------------------------------------
+
+static void pipeline_atomic_max(atomic_uint_fast32_t* target, uint64_t value) {
+  uint_fast32_t clamped = value > UINT32_MAX ? UINT32_MAX : (uint_fast32_t)value;
+  uint_fast32_t current = atomic_load_explicit(target, memory_order_relaxed);
+  while (clamped > current &&
+         !atomic_compare_exchange_weak_explicit(target, &current, clamped, memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+static void pipeline_account(pipeline_counters_t* counters, uint32_t blocks, uint64_t process_us,
+                             uint64_t latency_us) {
+  atomic_fetch_add_explicit(&counters->blocks, blocks, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters->calls, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters->process_us_total, process_us, memory_order_relaxed);
+  atomic_fetch_add_explicit(&counters->latency_us_total, latency_us, memory_order_relaxed);
+  pipeline_atomic_max(&counters->max_process_us, process_us);
+  pipeline_atomic_max(&counters->max_latency_us, latency_us);
+}
+
+static void pipeline_reset_counters(pipeline_counters_t* counters) {
+  atomic_store(&counters->blocks, 0);
+  atomic_store(&counters->calls, 0);
+  atomic_store(&counters->dropped, 0);
+  atomic_store(&counters->process_us_total, 0);
+  atomic_store(&counters->latency_us_total, 0);
+  atomic_store(&counters->max_process_us, 0);
+  atomic_store(&counters->max_latency_us, 0);
+}
+
+// ----------------------------------------------------------------------------
+// Queues
+// ----------------------------------------------------------------------------
+
+static pipeline_queue_t* pipeline_queue_create(uint32_t samples, uint32_t block, uint32_t sample_rate,
+                                               uint32_t slot_frames) {
+  pipeline_queue_t* queue = (pipeline_queue_t*)calloc(1, sizeof(*queue));
+  if (!queue) {
+    return NULL;
+  }
+  queue->ring = ethervox_audio_ring_create(samples, sample_rate);
+  if (!queue->ring) {
+    free(queue);
+    return NULL;
+  }
+  // Blocks always start at multiples of block, so each slot has one owner
+  queue->slots = ethervox_audio_ring_capacity(queue->ring) / block;
+  queue->meta = (pipeline_meta_t*)calloc(queue->slots, sizeof(pipeline_meta_t));
+  queue->slot_frames = slot_frames;
+  if (slot_frames > 0) {
+    queue->frames = (ethervox_vad_frame_t*)calloc((size_t)queue->slots * slot_frames, sizeof(ethervox_vad_frame_t));
+  }
+  if (!queue->meta || (slot_frames > 0 && !queue->frames)) {
+    ethervox_audio_ring_destroy(queue->ring);
+    free(queue->meta);
+    free(queue->frames);
+    free(queue);
+    return NULL;
+  }
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->ready, NULL);
+  return queue;
+}
+
+static void pipeline_queue_destroy(pipeline_queue_t* queue) {
+  if (!queue) {
+    return;
+  }
+  pthread_cond_destroy(&queue->ready);
+  pthread_mutex_destroy(&queue->mutex);
+  ethervox_audio_ring_destroy(queue->ring);
+  free(queue->meta);
+  free(queue->frames);
+  free(queue);
+}
+
+static void pipeline_queue_reset(pipeline_queue_t* queue) {
+  ethervox_audio_ring_reset(queue->ring);
+  memset(queue->meta, 0, queue->slots * sizeof(pipeline_meta_t));
+}
+
+// Never blocks: a busy mutex means the consumer is awake and checking
+static void pipeline_queue_signal(pipeline_queue_t* queue) {
+  if (pthread_mutex_trylock(&queue->mutex) == 0) {
+    pthread_cond_broadcast(&queue->ready);
+    pthread_mutex_unlock(&queue->mutex);
+  }
+}
+
+static void pipeline_queue_push(ethervox_pipeline_t* pipeline, pipeline_node_t* node, const float* block,
+                                const pipeline_meta_t* meta) {
+  pipeline_queue_t* queue = node->queue;
+  const uint32_t count = pipeline->block;
+
+  ethervox_audio_span_t span;
+  if (ethervox_audio_ring_begin_write(queue->ring, &span) < count) {
+    // Whole blocks only, so positions stay block-aligned
+    atomic_fetch_add_explicit(&node->counters.dropped, 1, memory_order_relaxed);
+    return;
+  }
+  uint32_t slot = (uint32_t)((span.position / count) % queue->slots);
+  queue->meta[slot] = *meta;
+  queue->meta[slot].frames = NULL;  // Copied into the slot; pop points at the consumer's copy
+  queue->meta[slot].frame_count = meta->frame_count < queue->slot_frames ? meta->frame_count : queue->slot_frames;
+  if (queue->meta[slot].frame_count > 0) {
+    memcpy(queue->frames + (size_t)slot * queue->slot_frames, meta->frames,
+           queue->meta[slot].frame_count * sizeof(ethervox_vad_frame_t));
+  }
+  uint32_t first = span.size[0] < count ? span.size[0] : count;
+  memcpy(span.data[0], block, first * sizeof(float));
+  if (first < count) {
+    memcpy(span.data[1], block + first, (count - first) * sizeof(float));
+  }
+  ethervox_audio_ring_end_write(queue->ring, count, meta->timestamp_us);
+  pipeline_queue_signal(queue);
+}
+
+// Sleep up to wait_us or until the queue is signalled, unless count samples are already queued
+static void pipeline_queue_sleep(pipeline_queue_t* queue, uint32_t count, uint64_t wait_us) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += (time_t)(wait_us / ETHERVOX_PLATFORM_US_PER_SEC);
+  deadline.tv_nsec += (long)(wait_us % ETHERVOX_PLATFORM_US_PER_SEC) * 1000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  pthread_mutex_lock(&queue->mutex);
+  if (ethervox_audio_ring_available(queue->ring) < count) {
+    pthread_cond_timedwait(&queue->ready, &queue->mutex, &deadline);
+  }
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+// Wait until count samples are queued, the pipeline stops or the deadline passes
+static bool pipeline_queue_wait(ethervox_pipeline_t* pipeline, pipeline_queue_t* queue, uint32_t count,
+                                uint64_t deadline_us) {
+  const uint64_t slice_us = (uint64_t)pipeline->config.block_ms * ETHERVOX_PLATFORM_US_PER_MS;
+  while (ethervox_audio_ring_available(queue->ring) < count) {
+    uint64_t now_us = pipeline_now_us();
+    if (!atomic_load(&pipeline->running) || atomic_load(&pipeline->capture_failed) || now_us >= deadline_us) {
+      return false;
+    }
+    pipeline_queue_sleep(queue, count, deadline_us - now_us < slice_us ? deadline_us - now_us : slice_us);
+  }
+  return true;
+}
+
+// Take blocks whole blocks; meta covers all of them, and their VAD frames are
+// gathered into frames_out with end offsets rebased onto out
+static void pipeline_queue_pop(ethervox_pipeline_t* pipeline, pipeline_queue_t* queue, float* out, uint32_t blocks,
+                               ethervox_vad_frame_t* frames_out, pipeline_meta_t* meta, uint64_t* position) {
+  const uint32_t count = blocks * pipeline->block;
+  ethervox_audio_span_t span;
+  ethervox_audio_ring_begin_read(queue->ring, &span);
+
+  uint32_t frame_count = 0;
+  for (uint32_t b = 0; b < blocks; b++) {
+    uint32_t index = (uint32_t)((span.position / pipeline->block + b) % queue->slots);
+    const pipeline_meta_t* slot = &queue->meta[index];
+    if (b == 0) {
+      *meta = *slot;
+    } else {
+      meta->is_speech = meta->is_speech || slot->is_speech;
+      if (slot->speech_probability > meta->speech_probability) {
+        meta->speech_probability = slot->speech_probability;
+      }
+    }
+    for (uint32_t f = 0; frames_out && f < slot->frame_count; f++) {
+      ethervox_vad_frame_t* frame = &frames_out[frame_count++];
+      *frame = queue->frames[(size_t)index * queue->slot_frames + f];
+      frame->end_offset += b * pipeline->block;
+    }
+  }
+  meta->frames = frame_count > 0 ? frames_out : NULL;
+  meta->frame_count = frame_count;
+  *position = span.position;
+
+  uint32_t first = span.size[0] < count ? span.size[0] : count;
+  memcpy(out, span.data[0], first * sizeof(float));
+  if (first < count) {
+    memcpy(out + first, span.data[1], (count - first) * sizeof(float));
+  }
+  ethervox_audio_ring_end_read(queue->ring, count);
+}
+
+// ----------------------------------------------------------------------------
+// Stages
+// ----------------------------------------------------------------------------
+
+static void pipeline_process_stage(ethervox_pipeline_t* pipeline, int stage, float* block, pipeline_meta_t* meta) {
+  const uint32_t count = pipeline->block;
+
+  switch (stage) {
+    case ETHERVOX_PIPELINE_STAGE_AEC:
+      for (uint32_t offset = 0; offset < count; offset += pipeline->aec_frame) {
+        // Capture time of each frame lines it up with the playback reference
+        uint64_t frame_time_us =
+            meta->timestamp_us ? meta->timestamp_us + pipeline_samples_to_us(offset, pipeline->config.sample_rate)
+                               : 0;
+        ethervox_result_t result =
+            ethervox_aec_process_at(pipeline->config.aec, block + offset, pipeline->aec_frame, frame_time_us);
+        if (ethervox_is_error(result)) {
+          if (pipeline->aec_failures++ == 0) {
+            ETHERVOX_LOG_WARN("Pipeline AEC failed (%d); passing audio through", result);
+          }
+          break;
+        }
+      }
+      break;
+
+    case ETHERVOX_PIPELINE_STAGE_NOISE_SUPPRESSION:
+      ethervox_ns_process(pipeline->ns, block, count);
+      break;
+
+    case ETHERVOX_PIPELINE_STAGE_VAD: {
+      const ethervox_vad_frame_t* frames = NULL;
+      uint32_t frame_count = 0;
+      meta->speech_probability = 0.0f;
+      meta->is_speech = pipeline->last_speech;  // A block shorter than a frame keeps the last verdict
+      meta->frames = NULL;
+      meta->frame_count = 0;
+      if (ethervox_is_success(ethervox_vad_process(pipeline->vad, block, count, &frames, &frame_count)) &&
+          frame_count > 0) {
+        // Downstream consumers apply their own thresholds to these (valid until the next block)
+        meta->frames = frames;
+        meta->frame_count = frame_count;
+        meta->is_speech = false;
+        for (uint32_t i = 0; i < frame_count; i++) {
+          meta->is_speech = meta->is_speech || frames[i].is_speech;
+          if (frames[i].probability > meta->speech_probability) {
+            meta->speech_probability = frames[i].probability;
+          }
+        }
+        pipeline->last_speech = frames[frame_count - 1].is_speech;
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+static void pipeline_call_sink(pipeline_node_t* node, float* samples, uint32_t blocks, uint64_t position,
+                               const pipeline_meta_t* meta) {
+  ethervox_pipeline_t* pipeline = node->pipeline;
+  ethervox_pipeline_block_t out = {
+      .audio = {.data = samples, .size = blocks * pipeline->block, .channels = 1, .timestamp_us = meta->timestamp_us},
+      .position = position,
+      .speech_probability = meta->speech_probability,
+      .is_speech = meta->is_speech,
+      .vad_frames = meta->frames,
+      .vad_frame_count = meta->frame_count};
+
+  uint64_t start_us = pipeline_now_us();
+  node->sink.process(&out, node->sink.user_data);
+  uint64_t end_us = pipeline_now_us();
+  pipeline_account(&node->counters, blocks, end_us - start_us, end_us - meta->entered_us);
+}
+
+static void pipeline_fan_out(ethervox_pipeline_t* pipeline, float* block, const pipeline_meta_t* meta,
+                             uint64_t position) {
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    pipeline_node_t* node = &pipeline->sinks[i];
+    if (node->queue) {
+      pipeline_queue_push(pipeline, node, block, meta);
+    } else {
+      pipeline_call_sink(node, block, 1, position, meta);
+    }
+  }
+}
+
+// Run the processing stages from active[first] on, inline until one has its own queue
+static void pipeline_run(ethervox_pipeline_t* pipeline, int first, bool dequeued, float* block,
+                         pipeline_meta_t* meta, uint64_t position) {
+  for (int i = first; i < pipeline->active_count; i++) {
+    pipeline_node_t* node = &pipeline->stages[pipeline->active[i]];
+    if (node->queue && !(i == first && dequeued)) {
+      pipeline_queue_push(pipeline, node, block, meta);
+      return;
+    }
+    uint64_t start_us = pipeline_now_us();
+    pipeline_process_stage(pipeline, node->index, block, meta);
+    uint64_t end_us = pipeline_now_us();
+    pipeline_account(&node->counters, 1, end_us - start_us, end_us - meta->entered_us);
+  }
+  pipeline_fan_out(pipeline, block, meta, position);
+}
+
+// ----------------------------------------------------------------------------
+// Threads
+// ----------------------------------------------------------------------------
+
+static void* pipeline_stage_thread(void* arg) {
+  pipeline_node_t* node = (pipeline_node_t*)arg;
+  ethervox_pipeline_t* pipeline = node->pipeline;
+  const uint64_t slice_us = (uint64_t)pipeline->config.block_ms * ETHERVOX_PLATFORM_US_PER_MS;
+
+  while (atomic_load(&pipeline->running)) {
+    if (!pipeline_queue_wait(pipeline, node->queue, pipeline->block, pipeline_now_us() + slice_us)) {
+      if (atomic_load(&pipeline->capture_failed)) {
+        break;
+      }
+      continue;
+    }
+    pipeline_meta_t meta;
+    uint64_t position = 0;
+    pipeline_queue_pop(pipeline, node->queue, node->scratch, 1, NULL, &meta, &position);
+    pipeline_run(pipeline, node->order, true, node->scratch, &meta, position);
+  }
+  return NULL;
+}
+
+static void* pipeline_sink_thread(void* arg) {
+  pipeline_node_t* node = (pipeline_node_t*)arg;
+  ethervox_pipeline_t* pipeline = node->pipeline;
+  const uint32_t count = node->call_blocks * pipeline->block;
+  const uint64_t slice_us = (uint64_t)pipeline->config.block_ms * ETHERVOX_PLATFORM_US_PER_MS;
+
+  while (atomic_load(&pipeline->running)) {
+    if (!pipeline_queue_wait(pipeline, node->queue, count, pipeline_now_us() + slice_us)) {
+      if (atomic_load(&pipeline->capture_failed)) {
+        break;
+      }
+      continue;
+    }
+    pipeline_meta_t meta;
+    uint64_t position = 0;
+    pipeline_queue_pop(pipeline, node->queue, node->scratch, node->call_blocks, node->frames, &meta, &position);
+    pipeline_call_sink(node, node->scratch, node->call_blocks, position, &meta);
+  }
+
+  // Audio queued before the stop still belongs to the stream: once the stages
+  // upstream have drained, hand the sink everything left (the last call may be short)
+  while (!atomic_load(&pipeline->flushed)) {
+    pipeline_queue_sleep(node->queue, UINT32_MAX, slice_us);
+  }
+  uint32_t blocks;
+  while ((blocks = ethervox_audio_ring_available(node->queue->ring) / pipeline->block) > 0) {
+    if (blocks > node->call_blocks) {
+      blocks = node->call_blocks;
+    }
+    pipeline_meta_t meta;
+    uint64_t position = 0;
+    pipeline_queue_pop(pipeline, node->queue, node->scratch, blocks, node->frames, &meta, &position);
+    pipeline_call_sink(node, node->scratch, blocks, position, &meta);
+  }
+  return NULL;
+}
+
+// Append resampled capture to the pending block and run every block it completes
+static void pipeline_emit(ethervox_pipeline_t* pipeline, const float* samples, uint32_t count,
+                          uint64_t timestamp_us) {
+  const uint32_t rate = pipeline->config.sample_rate;
+
+  // Re-anchor the pending block on every timestamped read
+  if (timestamp_us) {
+    uint64_t start_us = timestamp_us > pipeline->capture_latency_us ? timestamp_us - pipeline->capture_latency_us
+                                                                    : timestamp_us;
+    uint64_t pending_us = pipeline_samples_to_us(pipeline->pending_count, rate);
+    pipeline->pending_timestamp_us = start_us > pending_us ? start_us - pending_us : start_us;
+  }
+
+  while (count > 0) {
+    uint32_t take = pipeline->block - pipeline->pending_count;
+    if (take > count) {
+      take = count;
+    }
+    memcpy(pipeline->pending + pipeline->pending_count, samples, take * sizeof(float));
+    pipeline->pending_count += take;
+    samples += take;
+    count -= take;
+
+    if (pipeline->pending_count == pipeline->block) {
+      pipeline_meta_t meta = {.timestamp_us = pipeline->pending_timestamp_us,
+                              .entered_us = pipeline_now_us(),
+                              .speech_probability = 0.0f,
+                              .is_speech = true};
+      uint64_t position = pipeline->position;
+      atomic_fetch_add_explicit(&pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].counters.blocks, 1,
+                                memory_order_relaxed);
+      pipeline_run(pipeline, 0, false, pipeline->pending, &meta, position);
+
+      pipeline->position += pipeline->block;
+      pipeline->pending_count = 0;
+      if (pipeline->pending_timestamp_us) {
+        pipeline->pending_timestamp_us += pipeline_samples_to_us(pipeline->block, rate);
+      }
+    }
+  }
+}
+
+static void pipeline_signal_all(ethervox_pipeline_t* pipeline) {
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    if (pipeline->stages[i].queue) {
+      pthread_mutex_lock(&pipeline->stages[i].queue->mutex);
+      pthread_cond_broadcast(&pipeline->stages[i].queue->ready);
+      pthread_mutex_unlock(&pipeline->stages[i].queue->mutex);
+    }
+  }
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    if (pipeline->sinks[i].queue) {
+      pthread_mutex_lock(&pipeline->sinks[i].queue->mutex);
+      pthread_cond_broadcast(&pipeline->sinks[i].queue->ready);
+      pthread_mutex_unlock(&pipeline->sinks[i].queue->mutex);
+    }
+  }
+}
+
+static void* pipeline_capture_thread(void* arg) {
+  ethervox_pipeline_t* pipeline = (ethervox_pipeline_t*)arg;
+  ethervox_audio_runtime_t* runtime = pipeline->config.runtime;
+  pipeline_node_t* capture = &pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE];
+  pipeline_node_t* beamform = &pipeline->stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM];
+  pipeline_node_t* resample = &pipeline->stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE];
+  const uint32_t channels = pipeline->capture_channels;
+
+  while (atomic_load(&pipeline->running)) {
+    ethervox_audio_buffer_t buffer = {
+        .data = pipeline->capture_buffer, .size = pipeline->capture_capacity, .channels = channels};
+    ethervox_result_t result = runtime->driver.read_audio(runtime, &buffer);
+    if (ethervox_is_error(result)) {
+      ETHERVOX_LOG_ERROR("Pipeline capture failed (%d); stopping the front end", result);
+      atomic_store(&pipeline->capture_failed, true);
+      pipeline_signal_all(pipeline);
+      break;
+    }
+    if (buffer.size == 0) {
+      // Drivers that return at once when nothing is queued
+      usleep(pipeline->config.block_ms * 500U);
+      continue;
+    }
+
+    uint64_t start_us = pipeline_now_us();
+    uint32_t frames = buffer.size / (buffer.channels ? buffer.channels : 1);
+    const float* mono = buffer.data;
+    pipeline_node_t* node = capture;
+    if (pipeline->beamformer && buffer.channels == channels) {
+      ethervox_beamformer_process(pipeline->beamformer, buffer.data, frames, pipeline->beamformed);
+      mono = pipeline->beamformed;
+      node = beamform;
+    } else if (buffer.channels > 1) {
+      ethervox_dsp_downmix(buffer.data, buffer.data, frames, buffer.channels);
+    }
+    uint64_t end_us = pipeline_now_us();
+    pipeline_account(&node->counters, 0, end_us - start_us, 0);
+
+    uint32_t count = frames;
+    if (pipeline->resampler) {
+      count = (uint32_t)ethervox_resampler_process(pipeline->resampler, mono, frames, pipeline->resampled);
+      mono = pipeline->resampled;
+      uint64_t resampled_us = pipeline_now_us();
+      pipeline_account(&resample->counters, 0, resampled_us - end_us, 0);
+    }
+    pipeline_emit(pipeline, mono, count, buffer.timestamp_us);
+  }
+  return NULL;
+}
+
+// SCHED_FIFO and CPU pinning when asked for and permitted, else a normal thread
+static int pipeline_start_thread(pthread_t* tid, void* (*entry)(void*), void* arg,
+                                 const ethervox_pipeline_thread_config_t* thread, const char* name,
+                                 atomic_bool* realtime) {
+  atomic_store(realtime, false);
+  int rc = -1;
+
+  if (thread->rt_priority > 0) {
+    pthread_attr_t attr;
+    struct sched_param param = {0};
+    int max_priority = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority = thread->rt_priority < max_priority ? thread->rt_priority : max_priority;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+    rc = pthread_create(tid, &attr, entry, arg);
+    pthread_attr_destroy(&attr);
+    if (rc == 0) {
+      atomic_store(realtime, true);
+    } else {
+      ETHERVOX_LOG_WARN("Pipeline %s: real-time priority unavailable (%s); running at normal priority", name,
+                        strerror(rc));
+    }
+  }
+  if (rc != 0) {
+    rc = pthread_create(tid, NULL, entry, arg);
+    if (rc != 0) {
+      return rc;
+    }
+  }
+
+  if (thread->cpu >= 0) {
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(thread->cpu, &cpus);
+    int pin = pthread_setaffinity_np(*tid, sizeof(cpus), &cpus);
+    if (pin != 0) {
+      ETHERVOX_LOG_WARN("Pipeline %s: cannot pin to CPU %d (%s)", name, thread->cpu, strerror(pin));
+    }
+#else
+    ETHERVOX_LOG_WARN("Pipeline %s: CPU pinning is not supported on this platform", name);
+#endif
+  }
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Lifecycle
+// ----------------------------------------------------------------------------
+
+static ethervox_result_t pipeline_init_sink(ethervox_pipeline_t* pipeline, uint32_t index, uint32_t queue_samples) {
+  pipeline_node_t* node = &pipeline->sinks[index];
+  node->sink = pipeline->config.sinks[index];
+  node->thread = node->sink.thread;
+  node->pipeline = pipeline;
+  node->index = (int)index;
+  node->is_sink = true;
+  node->active = true;
+  node->call_blocks = node->sink.block_ms / pipeline->config.block_ms;
+  if (node->call_blocks == 0) {
+    node->call_blocks = 1;
+  }
+
+  bool queued = !node->sink.process || node->sink.thread.own_thread;
+  if (!queued) {
+    node->call_blocks = 1;
+    return ETHERVOX_SUCCESS;
+  }
+  if (!node->sink.process) {
+    node->thread.own_thread = false;  // Taps are drained by the caller's thread
+  }
+
+  uint32_t samples = queue_samples;
+  if (samples < 2 * node->call_blocks * pipeline->block) {
+    samples = 2 * node->call_blocks * pipeline->block;
+  }
+  node->queue = pipeline_queue_create(samples, pipeline->block, pipeline->config.sample_rate, pipeline->block_frames);
+  if (!node->queue) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate pipeline sink queue");
+  }
+  if (node->sink.process) {
+    node->scratch = (float*)malloc((size_t)node->call_blocks * pipeline->block * sizeof(float));
+    if (!node->scratch) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate pipeline sink buffer");
+    }
+  }
+  if (pipeline->block_frames > 0) {
+    // A tap read may take every queued block
+    uint32_t blocks = node->sink.process ? node->call_blocks : node->queue->slots;
+    node->frames =
+        (ethervox_vad_frame_t*)malloc((size_t)blocks * pipeline->block_frames * sizeof(ethervox_vad_frame_t));
+    if (!node->frames) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate pipeline sink VAD frames");
+    }
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_pipeline_create(const ethervox_pipeline_config_t* config,
+                                           ethervox_pipeline_t** pipeline_out) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(pipeline_out);
+  ETHERVOX_CHECK_PTR(config->runtime);
+  *pipeline_out = NULL;
+
+  ethervox_audio_runtime_t* runtime = config->runtime;
+  if (!runtime->driver.read_audio || !runtime->driver.start_capture) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Audio driver cannot capture");
+  }
+  if (config->sample_rate == 0 || config->block_ms == 0 || config->sink_count > ETHERVOX_PIPELINE_MAX_SINKS ||
+      (uint64_t)config->sample_rate * config->block_ms % 1000 != 0) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Pipeline block must be a whole number of samples");
+  }
+  for (uint32_t i = 0; i < config->sink_count; i++) {
+    if (config->sinks[i].block_ms % config->block_ms != 0) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Sink block_ms must be a multiple of the pipeline block");
+    }
+  }
+
+  ethervox_pipeline_t* pipeline = (ethervox_pipeline_t*)calloc(1, sizeof(*pipeline));
+  if (!pipeline) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate pipeline");
+  }
+  pipeline->config = *config;
+  pipeline->block = config->sample_rate * config->block_ms / 1000;
+  pipeline->capture_rate = runtime->config.sample_rate ? runtime->config.sample_rate : config->sample_rate;
+  pipeline->capture_channels = runtime->config.channels ? runtime->config.channels : 1;
+  atomic_init(&pipeline->running, false);
+  atomic_init(&pipeline->capture_failed, false);
+  atomic_init(&pipeline->flushed, false);
+
+  ethervox_result_t result = ETHERVOX_ERROR_OUT_OF_MEMORY;
+  const char* failure = "Failed to allocate pipeline buffers";
+
+  // Capture, beamforming or downmix, and resampling always share the capture thread
+  uint32_t capture_frames = (uint32_t)((uint64_t)pipeline->capture_rate * config->block_ms / 1000) *
+                            kPipelineCaptureBlocks;
+  if (capture_frames == 0) {
+    capture_frames = kPipelineCaptureBlocks;
+  }
+  pipeline->capture_capacity = capture_frames * pipeline->capture_channels;
+  pipeline->capture_buffer = (float*)malloc(pipeline->capture_capacity * sizeof(float));
+  pipeline->pending = (float*)malloc(pipeline->block * sizeof(float));
+  if (!pipeline->capture_buffer || !pipeline->pending) {
+    goto fail;
+  }
+  if (config->beamforming && pipeline->capture_channels > 1) {
+    ethervox_beamformer_config_t bf_config = config->beamformer_config;
+    if (bf_config.channels != pipeline->capture_channels) {
+      result = ETHERVOX_ERROR_INVALID_ARGUMENT;
+      failure = "Beamformer geometry does not match the capture channels";
+      goto fail;
+    }
+    bf_config.sample_rate = pipeline->capture_rate;
+    pipeline->beamformer = ethervox_beamformer_create(&bf_config);
+    pipeline->beamformed = (float*)malloc(capture_frames * sizeof(float));
+    if (!pipeline->beamformer) {
+      result = ETHERVOX_ERROR_INVALID_ARGUMENT;
+      failure = "Failed to create pipeline beamformer";
+      goto fail;
+    }
+    if (!pipeline->beamformed) {
+      goto fail;
+    }
+    pipeline->capture_latency_us =
+        pipeline_samples_to_us(ethervox_beamformer_latency_samples(pipeline->beamformer), pipeline->capture_rate);
+  }
+  if (pipeline->capture_rate != config->sample_rate) {
+    pipeline->resampler = ethervox_resampler_create(pipeline->capture_rate, config->sample_rate, capture_frames);
+    if (!pipeline->resampler) {
+      result = ETHERVOX_ERROR_AUDIO_FORMAT_UNSUPPORTED;
+      failure = "Capture rate cannot be resampled to the pipeline rate";
+      goto fail;
+    }
+    pipeline->resampled = (float*)malloc(ethervox_resampler_max_output(pipeline->resampler, capture_frames) *
+                                         sizeof(float));
+    if (!pipeline->resampled) {
+      goto fail;
+    }
+    pipeline->capture_latency_us +=
+        pipeline_samples_to_us(ethervox_resampler_latency(pipeline->resampler), pipeline->capture_rate);
+  }
+
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline->stages[i].pipeline = pipeline;
+    pipeline->stages[i].index = i;
+    pipeline->stages[i].order = -1;
+    pipeline->stages[i].thread = config->threads[i];
+  }
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].active = true;
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].thread.own_thread = true;
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].active = pipeline->beamformer != NULL;
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].thread = pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].thread;
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].active = pipeline->resampler != NULL;
+  pipeline->stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].thread = pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].thread;
+
+  if (config->aec) {
+    int frame = ethervox_aec_get_frame_size(config->aec);
+    if (frame <= 0 || pipeline->block % (uint32_t)frame != 0) {
+      result = ETHERVOX_ERROR_INVALID_ARGUMENT;
+      failure = "Pipeline block must be a whole number of AEC frames";
+      goto fail;
+    }
+    pipeline->aec_frame = (uint32_t)frame;
+    pipeline->stages[ETHERVOX_PIPELINE_STAGE_AEC].active = true;
+  }
+  if (config->noise_suppression) {
+    ethervox_ns_config_t ns_config = config->ns_config;
+    ns_config.sample_rate = config->sample_rate;
+    pipeline->ns = ethervox_ns_create(&ns_config);
+    if (!pipeline->ns) {
+      failure = "Failed to create pipeline noise suppressor";
+      goto fail;
+    }
+    pipeline->stages[ETHERVOX_PIPELINE_STAGE_NOISE_SUPPRESSION].active = true;
+  }
+  if (config->vad) {
+    ethervox_vad_config_t vad_config = config->vad_config;
+    vad_config.sample_rate = config->sample_rate;
+    pipeline->vad = ethervox_vad_create(&vad_config);
+    if (!pipeline->vad) {
+      result = ETHERVOX_ERROR_INVALID_ARGUMENT;
+      failure = "Failed to create pipeline VAD";
+      goto fail;
+    }
+    uint32_t frame = ethervox_vad_frame_samples(pipeline->vad);
+    pipeline->block_frames = (pipeline->block + frame - 1) / frame;
+    pipeline->stages[ETHERVOX_PIPELINE_STAGE_VAD].active = true;
+  }
+
+  uint32_t queue_samples = (uint32_t)((uint64_t)config->sample_rate * config->queue_ms / 1000);
+  if (queue_samples < 2 * pipeline->block) {
+    queue_samples = 2 * pipeline->block;
+  }
+  for (int i = ETHERVOX_PIPELINE_STAGE_AEC; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_node_t* node = &pipeline->stages[i];
+    if (!node->active) {
+      continue;
+    }
+    node->order = pipeline->active_count;
+    pipeline->active[pipeline->active_count++] = i;
+    if (node->thread.own_thread) {
+      node->queue = pipeline_queue_create(queue_samples, pipeline->block, config->sample_rate, 0);
+      node->scratch = (float*)malloc(pipeline->block * sizeof(float));
+      if (!node->queue || !node->scratch) {
+        failure = "Failed to allocate pipeline stage queue";
+        goto fail;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < config->sink_count; i++) {
+    result = pipeline_init_sink(pipeline, i, queue_samples);
+    if (ethervox_is_error(result)) {
+      ethervox_pipeline_destroy(pipeline);
+      return result;
+    }
+  }
+
+  ETHERVOX_LOG_INFO("Audio pipeline: %u Hz %u-channel capture%s -> %u Hz, %u ms blocks, %d stage(s), %u sink(s)",
+                    pipeline->capture_rate, pipeline->capture_channels, pipeline->beamformer ? " (beamformed)" : "",
+                    config->sample_rate, config->block_ms, pipeline->active_count, config->sink_count);
+  *pipeline_out = pipeline;
+  return ETHERVOX_SUCCESS;
+
+fail:
+  ethervox_pipeline_destroy(pipeline);
+  ETHERVOX_RETURN_ERROR(result, failure);
+}
+
+ethervox_result_t ethervox_pipeline_start(ethervox_pipeline_t* pipeline) {
+  ETHERVOX_CHECK_PTR(pipeline);
+  if (atomic_load(&pipeline->running)) {
+    return ETHERVOX_SUCCESS;
+  }
+
+  // Nothing is running yet, so the queues can be emptied from here
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_reset_counters(&pipeline->stages[i].counters);
+    if (pipeline->stages[i].queue) {
+      pipeline_queue_reset(pipeline->stages[i].queue);
+    }
+  }
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    pipeline_reset_counters(&pipeline->sinks[i].counters);
+    if (pipeline->sinks[i].queue) {
+      pipeline_queue_reset(pipeline->sinks[i].queue);
+    }
+  }
+  if (pipeline->resampler) {
+    ethervox_resampler_reset(pipeline->resampler);
+  }
+  if (pipeline->beamformer) {
+    ethervox_beamformer_reset(pipeline->beamformer);
+  }
+  pipeline->pending_count = 0;
+  pipeline->pending_timestamp_us = 0;
+  pipeline->position = 0;
+  pipeline->last_speech = false;
+  atomic_store(&pipeline->capture_failed, false);
+  atomic_store(&pipeline->flushed, false);
+
+  ethervox_audio_runtime_t* runtime = pipeline->config.runtime;
+  ethervox_result_t result = runtime->driver.start_capture(runtime);
+  if (ethervox_is_error(result)) {
+    ETHERVOX_RETURN_ERROR(result, "Pipeline failed to start capture");
+  }
+  runtime->is_capturing = true;
+  atomic_store(&pipeline->running, true);
+
+  // Consumers first, so nothing the capture thread produces waits on a missing thread
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_node_t* node = &pipeline->stages[i];
+    if (!node->queue) {
+      continue;
+    }
+    if (pipeline_start_thread(&node->tid, pipeline_stage_thread, node, &node->thread, kPipelineStageNames[i],
+                              &node->counters.realtime) != 0) {
+      ethervox_pipeline_stop(pipeline);
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FAILED, "Failed to start pipeline stage thread");
+    }
+    node->thread_started = true;
+  }
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    pipeline_node_t* node = &pipeline->sinks[i];
+    if (!node->queue || !node->sink.process) {
+      continue;
+    }
+    const char* name = node->sink.name ? node->sink.name : "sink";
+    if (pipeline_start_thread(&node->tid, pipeline_sink_thread, node, &node->thread, name,
+                              &node->counters.realtime) != 0) {
+      ethervox_pipeline_stop(pipeline);
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FAILED, "Failed to start pipeline sink thread");
+    }
+    node->thread_started = true;
+  }
+
+  pipeline_node_t* capture = &pipeline->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE];
+  if (pipeline_start_thread(&pipeline->capture_tid, pipeline_capture_thread, pipeline, &capture->thread, "capture",
+                            &capture->counters.realtime) != 0) {
+    ethervox_pipeline_stop(pipeline);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FAILED, "Failed to start pipeline capture thread");
+  }
+  pipeline->capture_started = true;
+  atomic_store(&pipeline->stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].counters.realtime,
+               atomic_load(&capture->counters.realtime));
+  atomic_store(&pipeline->stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].counters.realtime,
+               atomic_load(&capture->counters.realtime));
+
+  ETHERVOX_LOG_INFO("Audio pipeline started (%s capture thread)",
+                    atomic_load(&capture->counters.realtime) ? "SCHED_FIFO" : "normal");
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_pipeline_stop(ethervox_pipeline_t* pipeline) {
+  ETHERVOX_CHECK_PTR(pipeline);
+
+  atomic_store(&pipeline->running, false);
+  pipeline_signal_all(pipeline);
+
+  // Producer first, then consumers in stream order. Each stage thread's
+  // leftovers are run from here so they reach the queues downstream.
+  if (pipeline->capture_started) {
+    pthread_join(pipeline->capture_tid, NULL);
+    pipeline->capture_started = false;
+  }
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_node_t* node = &pipeline->stages[i];
+    if (!node->thread_started) {
+      continue;
+    }
+    pthread_join(node->tid, NULL);
+    node->thread_started = false;
+    while (ethervox_audio_ring_available(node->queue->ring) >= pipeline->block) {
+      pipeline_meta_t meta;
+      uint64_t position = 0;
+      pipeline_queue_pop(pipeline, node->queue, node->scratch, 1, NULL, &meta, &position);
+      pipeline_run(pipeline, node->order, true, node->scratch, &meta, position);
+    }
+  }
+
+  // Sink threads finish what is queued before they exit
+  atomic_store(&pipeline->flushed, true);
+  pipeline_signal_all(pipeline);
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    if (pipeline->sinks[i].thread_started) {
+      pthread_join(pipeline->sinks[i].tid, NULL);
+      pipeline->sinks[i].thread_started = false;
+    }
+  }
+
+  ethervox_audio_runtime_t* runtime = pipeline->config.runtime;
+  if (runtime->is_capturing && runtime->driver.stop_capture) {
+    runtime->driver.stop_capture(runtime);
+    runtime->is_capturing = false;
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+bool ethervox_pipeline_is_running(const ethervox_pipeline_t* pipeline) {
+  return pipeline && atomic_load(&pipeline->running) && !atomic_load(&pipeline->capture_failed);
+}
+
+ethervox_result_t ethervox_pipeline_read(ethervox_pipeline_t* pipeline, uint32_t sink, float* samples,
+                                         uint32_t capacity, uint32_t timeout_ms,
+                                         ethervox_pipeline_block_t* block) {
+  ETHERVOX_CHECK_PTR(pipeline);
+  ETHERVOX_CHECK_PTR(samples);
+  ETHERVOX_CHECK_PTR(block);
+  memset(block, 0, sizeof(*block));
+  block->audio.data = samples;
+  block->audio.channels = 1;
+
+  if (sink >= pipeline->config.sink_count || pipeline->sinks[sink].sink.process) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Pipeline sink is not a tap");
+  }
+  uint32_t blocks = capacity / pipeline->block;
+  if (blocks == 0) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_BUFFER_TOO_SMALL, "Tap reads need room for one block");
+  }
+
+  pipeline_node_t* node = &pipeline->sinks[sink];
+  uint64_t start_us = pipeline_now_us();
+  if (!pipeline_queue_wait(pipeline, node->queue, pipeline->block,
+                           start_us + (uint64_t)timeout_ms * ETHERVOX_PLATFORM_US_PER_MS)) {
+    if (ethervox_audio_ring_available(node->queue->ring) < pipeline->block && !ethervox_pipeline_is_running(pipeline)) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_INITIALIZED, "Pipeline is not running");
+    }
+    return ETHERVOX_SUCCESS;
+  }
+
+  uint32_t queued = ethervox_audio_ring_available(node->queue->ring) / pipeline->block;
+  if (blocks > queued) {
+    blocks = queued;
+  }
+  pipeline_meta_t meta;
+  uint64_t position = 0;
+  pipeline_queue_pop(pipeline, node->queue, samples, blocks, node->frames, &meta, &position);
+
+  block->audio.size = blocks * pipeline->block;
+  block->audio.timestamp_us = meta.timestamp_us;
+  block->position = position;
+  block->speech_probability = meta.speech_probability;
+  block->is_speech = meta.is_speech;
+  block->vad_frames = meta.frames;
+  block->vad_frame_count = meta.frame_count;
+
+  uint64_t end_us = pipeline_now_us();
+  pipeline_account(&node->counters, blocks, 0, end_us - meta.entered_us);
+  return ETHERVOX_SUCCESS;
+}
+
+static void pipeline_fill_metrics(const ethervox_pipeline_t* pipeline, const pipeline_node_t* node,
+                                  ethervox_pipeline_stage_metrics_t* out) {
+  pipeline_counters_t* counters = (pipeline_counters_t*)&node->counters;
+  uint64_t calls = atomic_load(&counters->calls);
+  out->blocks = atomic_load(&counters->blocks);
+  out->dropped = atomic_load(&counters->dropped);
+  out->avg_process_us = calls ? (uint32_t)(atomic_load(&counters->process_us_total) / calls) : 0;
+  out->max_process_us = (uint32_t)atomic_load(&counters->max_process_us);
+  out->avg_latency_us = calls ? (uint32_t)(atomic_load(&counters->latency_us_total) / calls) : 0;
+  out->max_latency_us = (uint32_t)atomic_load(&counters->max_latency_us);
+  out->active = node->active;
+  out->own_thread = node->queue != NULL && (node->thread.own_thread || node->index == ETHERVOX_PIPELINE_STAGE_CAPTURE);
+  out->realtime = atomic_load(&counters->realtime);
+  if (node->queue) {
+    ethervox_audio_ring_stats_t stats;
+    ethervox_audio_ring_get_stats(node->queue->ring, &stats);
+    out->queue_depth = ethervox_audio_ring_available(node->queue->ring) / pipeline->block;
+    out->queue_high_water = stats.high_water / pipeline->block;
+  }
+}
+
+ethervox_result_t ethervox_pipeline_get_metrics(const ethervox_pipeline_t* pipeline,
+                                                ethervox_pipeline_metrics_t* metrics) {
+  ETHERVOX_CHECK_PTR(pipeline);
+  ETHERVOX_CHECK_PTR(metrics);
+  memset(metrics, 0, sizeof(*metrics));
+
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_fill_metrics(pipeline, &pipeline->stages[i], &metrics->stages[i]);
+  }
+  metrics->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].own_thread = true;
+  metrics->stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].blocks =
+      pipeline->beamformer ? metrics->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].blocks : 0;
+  metrics->stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].blocks =
+      pipeline->resampler ? metrics->stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].blocks : 0;
+
+  metrics->sink_count = pipeline->config.sink_count;
+  for (uint32_t i = 0; i < pipeline->config.sink_count; i++) {
+    pipeline_fill_metrics(pipeline, &pipeline->sinks[i], &metrics->sinks[i]);
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_pipeline_get_doa(const ethervox_pipeline_t* pipeline, ethervox_doa_t* doa) {
+  ETHERVOX_CHECK_PTR(pipeline);
+  ETHERVOX_CHECK_PTR(doa);
+  if (!pipeline->beamformer) {
+    memset(doa, 0, sizeof(*doa));
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Pipeline capture is not beamformed");
+  }
+  return ethervox_beamformer_get_doa(pipeline->beamformer, doa);
+}
+
+void ethervox_pipeline_destroy(ethervox_pipeline_t* pipeline) {
+  if (!pipeline) {
+    return;
+  }
+  if (atomic_load(&pipeline->running)) {
+    ethervox_pipeline_stop(pipeline);
+  }
+  for (int i = 0; i < ETHERVOX_PIPELINE_STAGE_COUNT; i++) {
+    pipeline_queue_destroy(pipeline->stages[i].queue);
+    free(pipeline->stages[i].scratch);
+  }
+  for (uint32_t i = 0; i < ETHERVOX_PIPELINE_MAX_SINKS; i++) {
+    pipeline_queue_destroy(pipeline->sinks[i].queue);
+    free(pipeline->sinks[i].scratch);
+    free(pipeline->sinks[i].frames);
+  }
+  ethervox_ns_destroy(pipeline->ns);
+  ethervox_vad_destroy(pipeline->vad);
+  ethervox_resampler_destroy(pipeline->resampler);
+  free(pipeline->resampled);
+  ethervox_beamformer_destroy(pipeline->beamformer);
+  free(pipeline->beamformed);
+  free(pipeline->pending);
+  free(pipeline->capture_buffer);
+  free(pipeline);
+}
+
+#endif  // _WIN32
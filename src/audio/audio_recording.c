@@ -11,8 +11,10 @@
 
 #include "ethervox/audio_recording.h"
 #include "ethervox/audio.h"
+#include "ethervox/dsp.h"
 #include "ethervox/logging.h"
 #include "ethervox/error.h"
+#include "ethervox/vad.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +28,8 @@
 #include <unistd.h>
 #endif
 
+#define VAD_RECORD_PRE_ROLL_MS 200  // Audio kept before speech onset and after its end
+
 // WAV file format structures (simple RIFF WAV header)
 typedef struct {
     char riff[4];           // "RIFF"
@@ -50,45 +54,16 @@ typedef struct {
 } wav_data_header_t;
 
 /**
- * Write audio buffer to WAV file
+ * Write a 16-bit PCM WAV header
  */
-ethervox_result_t ethervox_audio_write_wav(
-    const char* output_path,
-    const float* samples,
-    int num_samples,
+ethervox_result_t ethervox_audio_write_wav_header(
+    FILE* fp,
     int sample_rate,
-    int channels
+    int channels,
+    uint32_t data_size
 ) {
-    ETHERVOX_CHECK_PTR(output_path);
-    ETHERVOX_CHECK_PTR(samples);
-    if (num_samples <= 0) {
-        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Invalid sample count");
-    }
-
-    FILE* fp = fopen(output_path, "wb");
-    if (!fp) {
-        ETHERVOX_LOG_ERROR("Failed to create WAV file: %s", output_path);
-        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FILE_WRITE, "Cannot create WAV file");
-    }
+    ETHERVOX_CHECK_PTR(fp);
 
-    // Convert float samples to 16-bit PCM
-    int16_t* pcm_samples = (int16_t*)malloc(num_samples * sizeof(int16_t));
-    if (!pcm_samples) {
-        ETHERVOX_LOG_ERROR("Failed to allocate PCM buffer");
-        fclose(fp);
-        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "PCM buffer allocation failed");
-    }
-
-    for (int i = 0; i < num_samples; i++) {
-        // Clamp to [-1, 1] and convert to 16-bit
-        float sample = samples[i];
-        if (sample > 1.0f) sample = 1.0f;
-        if (sample < -1.0f) sample = -1.0f;
-        pcm_samples[i] = (int16_t)(sample * 32767.0f);
-    }
-
-    // Calculate sizes
-    uint32_t data_size = num_samples * sizeof(int16_t);
     uint32_t file_size = sizeof(wav_riff_header_t) + sizeof(wav_fmt_chunk_t) + 
                          sizeof(wav_data_header_t) + data_size - 8;
 
@@ -98,7 +73,6 @@ ethervox_result_t ethervox_audio_write_wav(
         .file_size = file_size,
         .wave = {'W', 'A', 'V', 'E'}
     };
-    fwrite(&riff, sizeof(riff), 1, fp);
 
     // Write format chunk
     wav_fmt_chunk_t fmt = {
@@ -111,14 +85,156 @@ ethervox_result_t ethervox_audio_write_wav(
         .block_align = channels * sizeof(int16_t),
         .bits_per_sample = 16
     };
-    fwrite(&fmt, sizeof(fmt), 1, fp);
 
     // Write data header
     wav_data_header_t data_hdr = {
         .data = {'d', 'a', 't', 'a'},
         .data_size = data_size
     };
-    fwrite(&data_hdr, sizeof(data_hdr), 1, fp);
+
+    if (fwrite(&riff, sizeof(riff), 1, fp) != 1 ||
+        fwrite(&fmt, sizeof(fmt), 1, fp) != 1 ||
+        fwrite(&data_hdr, sizeof(data_hdr), 1, fp) != 1) {
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FILE_WRITE, "Failed to write WAV header");
+    }
+    return ETHERVOX_SUCCESS;
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * Read a 16-bit PCM WAV file
+ */
+ethervox_result_t ethervox_audio_read_wav(
+    const char* input_path,
+    float** samples_out,
+    uint32_t* frames_out,
+    uint32_t* sample_rate_out,
+    uint16_t* channels_out
+) {
+    ETHERVOX_CHECK_PTR(input_path);
+    ETHERVOX_CHECK_PTR(samples_out);
+    ETHERVOX_CHECK_PTR(frames_out);
+
+    FILE* fp = fopen(input_path, "rb");
+    if (!fp) {
+        ETHERVOX_LOG_ERROR("Failed to open WAV file: %s", input_path);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FILE_NOT_FOUND, "Cannot open WAV file");
+    }
+
+    uint8_t header[12];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header, "RIFF", 4) != 0 ||
+        memcmp(header + 8, "WAVE", 4) != 0) {
+        fclose(fp);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Not a RIFF/WAVE file");
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0, data_size = 0;
+    bool have_fmt = false, have_data = false;
+    uint8_t chunk[8];
+    while (!have_data && fread(chunk, 1, sizeof(chunk), fp) == sizeof(chunk)) {
+        uint32_t size = read_le32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, sizeof(fmt), fp) != sizeof(fmt)) {
+                break;
+            }
+            format = (uint16_t)(fmt[0] | fmt[1] << 8);
+            channels = (uint16_t)(fmt[2] | fmt[3] << 8);
+            rate = read_le32(fmt + 4);
+            bits = (uint16_t)(fmt[14] | fmt[15] << 8);
+            have_fmt = true;
+            fseek(fp, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            data_size = size;
+            have_data = true;
+        } else {
+            fseek(fp, (long)(size + (size & 1)), SEEK_CUR);  // Chunks are word aligned
+        }
+    }
+
+    // 0xFFFE is WAVE_FORMAT_EXTENSIBLE, used by some recorders for plain PCM
+    if (!have_fmt || !have_data || (format != 1 && format != 0xFFFE) || bits != 16 ||
+        channels == 0 || rate == 0) {
+        ETHERVOX_LOG_ERROR("Unsupported WAV file %s: format=%u %u Hz %u-bit %u ch (need 16-bit PCM)",
+                           input_path, format, rate, bits, channels);
+        fclose(fp);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "WAV file is not 16-bit PCM");
+    }
+
+    // Recorders that were interrupted (or streaming writers) leave the header
+    // size unpatched, so trust the file length over the data chunk size
+    long data_pos = ftell(fp);
+    if (data_pos >= 0 && fseek(fp, 0, SEEK_END) == 0) {
+        long file_end = ftell(fp);
+        if (file_end >= data_pos && ((uint64_t)(file_end - data_pos) < data_size || data_size == 0)) {
+            data_size = (uint32_t)(file_end - data_pos);
+        }
+        fseek(fp, data_pos, SEEK_SET);
+    }
+
+    uint32_t frames = data_size / (2u * channels);
+    size_t count = (size_t)frames * channels;
+    int16_t* pcm = (int16_t*)malloc((count ? count : 1) * sizeof(int16_t));
+    float* samples = (float*)malloc((count ? count : 1) * sizeof(float));
+    if (!pcm || !samples) {
+        free(pcm);
+        free(samples);
+        fclose(fp);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "WAV sample allocation failed");
+    }
+
+    size_t got = fread(pcm, sizeof(int16_t), count, fp);
+    fclose(fp);
+    frames = (uint32_t)(got / channels);
+    ethervox_dsp_s16_to_float(pcm, samples, (size_t)frames * channels);
+    free(pcm);
+
+    *samples_out = samples;
+    *frames_out = frames;
+    if (sample_rate_out) *sample_rate_out = rate;
+    if (channels_out) *channels_out = channels;
+    return ETHERVOX_SUCCESS;
+}
+
+/**
+ * Write audio buffer to WAV file
+ */
+ethervox_result_t ethervox_audio_write_wav(
+    const char* output_path,
+    const float* samples,
+    int num_samples,
+    int sample_rate,
+    int channels
+) {
+    ETHERVOX_CHECK_PTR(output_path);
+    ETHERVOX_CHECK_PTR(samples);
+    if (num_samples <= 0) {
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Invalid sample count");
+    }
+
+    FILE* fp = fopen(output_path, "wb");
+    if (!fp) {
+        ETHERVOX_LOG_ERROR("Failed to create WAV file: %s", output_path);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_FILE_WRITE, "Cannot create WAV file");
+    }
+
+    // Convert float samples to 16-bit PCM
+    int16_t* pcm_samples = (int16_t*)malloc(num_samples * sizeof(int16_t));
+    if (!pcm_samples) {
+        ETHERVOX_LOG_ERROR("Failed to allocate PCM buffer");
+        fclose(fp);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "PCM buffer allocation failed");
+    }
+
+    ethervox_dsp_float_to_s16(samples, pcm_samples, (size_t)num_samples);
+
+    // Write header
+    uint32_t data_size = num_samples * sizeof(int16_t);
+    ethervox_audio_write_wav_header(fp, sample_rate, channels, data_size);
 
     // Write audio data
     fwrite(pcm_samples, 1, data_size, fp);
@@ -210,7 +326,9 @@ ethervox_result_t ethervox_audio_record_to_file(
         usleep(chunk_ms * 1000);  // Convert ms to microseconds
 #endif
         
-        // Read audio chunk
+        // Read audio chunk (size is the capacity going in, samples read coming out)
+        audio_buf.size = chunk_samples * 2;
+        audio_buf.channels = channels;
         ethervox_result_t read_result = ethervox_audio_read(&audio_runtime, &audio_buf);
         
         if (ethervox_is_success(read_result) && audio_buf.size > 0) {
@@ -261,7 +379,9 @@ ethervox_result_t ethervox_audio_record_to_file(
 /**
  * Record audio with automatic silence detection
  * 
- * TODO: Needs integration with audio capture system (same as above)
+ * Frames come from the capture stream's VAD. Audio before the first speech
+ * frame is dropped (keeping a short pre-roll), and recording stops once
+ * silence_duration_ms pass without speech.
  */
 ethervox_result_t ethervox_audio_record_with_vad(
     const char* output_path,
@@ -269,11 +389,131 @@ ethervox_result_t ethervox_audio_record_with_vad(
     float silence_threshold,
     int silence_duration_ms
 ) {
-    (void)silence_threshold;
-    (void)silence_duration_ms;
+    ETHERVOX_CHECK_PTR(output_path);
+    if (max_duration_seconds <= 0 || silence_duration_ms <= 0) {
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Invalid duration");
+    }
+    
+    const int sample_rate = 16000;
+    // A frame is speech at this probability (out-of-range values use the VAD default)
+    const float speech_threshold = (silence_threshold > 0.0f && silence_threshold < 1.0f)
+                                   ? silence_threshold : ETHERVOX_VAD_THRESHOLD;
+    
+    ethervox_audio_runtime_t audio_runtime = {0};
+    ethervox_audio_config_t config = ethervox_audio_get_default_config();
+    config.sample_rate = sample_rate;
+    config.channels = 1;
+    
+    ethervox_result_t result = ethervox_audio_init(&audio_runtime, &config);
+    if (ethervox_is_error(result)) {
+        ETHERVOX_LOG_ERROR("Failed to initialize audio runtime");
+        return result;
+    }
+    if (!audio_runtime.vad) {
+        ethervox_audio_cleanup(&audio_runtime);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "VAD allocation failed");
+    }
+    
+    result = ethervox_audio_start_capture(&audio_runtime);
+    if (ethervox_is_error(result)) {
+        ETHERVOX_LOG_ERROR("Failed to start audio capture");
+        ethervox_audio_cleanup(&audio_runtime);
+        return result;
+    }
+    
+    const int chunk_ms = 100;
+    const int total_chunks = max_duration_seconds * (1000 / chunk_ms);
+    const int chunk_samples = (sample_rate * chunk_ms) / 1000;
+    const int total_samples = sample_rate * max_duration_seconds;
+    const int pre_roll = VAD_RECORD_PRE_ROLL_MS * sample_rate / 1000;
+    const int frame_ms = (int)(ethervox_vad_frame_samples(audio_runtime.vad) * 1000 / sample_rate);
+    
+    float* recording_buffer = (float*)malloc(total_samples * sizeof(float));
+    ethervox_audio_buffer_t audio_buf = {0};
+    audio_buf.data = (float*)malloc(chunk_samples * 2 * sizeof(float));  // 2x for safety
+    if (!recording_buffer || !audio_buf.data) {
+        free(recording_buffer);
+        free(audio_buf.data);
+        ethervox_audio_stop_capture(&audio_runtime);
+        ethervox_audio_cleanup(&audio_runtime);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Recording buffer allocation failed");
+    }
+    
+    int samples_recorded = 0;
+    int speech_start = -1;  // First sample kept (pre-roll included)
+    int speech_end = 0;     // One past the last speech frame
+    int silence_ms = 0;
+    
+    ETHERVOX_LOG_INFO("Listening for speech (up to %d seconds)...", max_duration_seconds);
+    
+    for (int chunk = 0; chunk < total_chunks && samples_recorded < total_samples; chunk++) {
+#ifdef _WIN32
+        Sleep(chunk_ms);
+#else
+        usleep(chunk_ms * 1000);
+#endif
+        
+        audio_buf.size = chunk_samples * 2;
+        audio_buf.channels = 1;
+        ethervox_result_t read_result = ethervox_audio_read(&audio_runtime, &audio_buf);
+        if (ethervox_is_error(read_result) || audio_buf.size == 0) {
+            continue;
+        }
+        
+        int samples_to_copy = (int)audio_buf.size;
+        if (samples_recorded + samples_to_copy > total_samples) {
+            samples_to_copy = total_samples - samples_recorded;
+        }
+        memcpy(recording_buffer + samples_recorded, audio_buf.data, samples_to_copy * sizeof(float));
+        
+        const ethervox_vad_frame_t* frames = NULL;
+        uint32_t frame_count = 0;
+        if (ethervox_is_success(ethervox_vad_process(audio_runtime.vad, audio_buf.data, audio_buf.size,
+                                                     &frames, &frame_count))) {
+            for (uint32_t i = 0; i < frame_count; i++) {
+                int frame_end = samples_recorded + (int)frames[i].end_offset;
+                if (frames[i].probability >= speech_threshold) {
+                    if (speech_start < 0) {
+                        int onset = frame_end - (int)frames[i].length;
+                        speech_start = onset > pre_roll ? onset - pre_roll : 0;
+                        ETHERVOX_LOG_INFO("Speech detected, recording...");
+                    }
+                    speech_end = frame_end;
+                    silence_ms = 0;
+                } else if (speech_start >= 0) {
+                    silence_ms += frame_ms;
+                }
+            }
+        }
+        samples_recorded += samples_to_copy;
+        
+        if (speech_start >= 0 && silence_ms >= silence_duration_ms) {
+            ETHERVOX_LOG_INFO("Silence detected, stopping");
+            break;
+        }
+    }
+    
+    ethervox_audio_stop_capture(&audio_runtime);
+    ethervox_audio_cleanup(&audio_runtime);
+    free(audio_buf.data);
     
-    ETHERVOX_LOG_WARN("VAD recording not yet implemented");
+    if (speech_start < 0) {
+        free(recording_buffer);
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_FOUND, "No speech detected");
+    }
+    
+    // Keep the pre-roll's worth of trailing silence as well
+    int end = speech_end + pre_roll < samples_recorded ? speech_end + pre_roll : samples_recorded;
+    ETHERVOX_LOG_INFO("Recording complete: %.2fs of speech",
+                      (float)(end - speech_start) / (float)sample_rate);
+    
+    result = ethervox_audio_write_wav(output_path, recording_buffer + speech_start,
+                                      end - speech_start, sample_rate, 1);
+    free(recording_buffer);
     
-    // For now, fall back to simple recording
-    return ethervox_audio_record_to_file(output_path, max_duration_seconds, 16000, 1);
+    if (ethervox_is_success(result)) {
+        ETHERVOX_LOG_INFO("Successfully saved audio to: %s", output_path);
+    }
+    
+    return result;
 }
@@ -2,7 +2,8 @@
  * @file audio_stream_player.c
  * @brief Real-time streaming audio player implementation
  * 
- * macOS implementation using CoreAudio AudioQueue for low-latency playback
+ * macOS implementation using CoreAudio AudioQueue for low-latency playback;
+ * Linux implementation using ALSA with a dedicated playback thread
  */
 
 #include "ethervox/audio_stream_player.h"
@@ -244,6 +245,14 @@ void audio_stream_player_stop(audio_stream_player_t* player) {
     }
 }
 
+ethervox_result_t audio_stream_player_set_echo_reference(audio_stream_player_t* player,
+                                                         ethervox_reference_buffer_t* reference) {
+    ETHERVOX_CHECK_PTR(player);
+    (void)reference;
+    // Played audio reaches the AEC through the capture driver's echo_reference instead
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
 void audio_stream_player_destroy(audio_stream_player_t* player) {
     if (!player) return;
     
@@ -266,8 +275,463 @@ void audio_stream_player_destroy(audio_stream_player_t* player) {
     free(player);
 }
 
+#elif defined(ETHERVOX_PLATFORM_LINUX) || defined(ETHERVOX_PLATFORM_RPI)
+#include "ethervox/audio_buffer.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include <alsa/asoundlib.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define IDLE_AFTER_MS 500          // Silence fed to a running device before it is drained and parked
+#define DRAIN_TIMEOUT_SEC 5        // wait() gives up if the playback thread stops making progress
+
+/*
+ * Linux implementation: ALSA, fed by a dedicated playback thread.
+ *
+ * write() copies samples into a lock-free SPSC ring (the TTS thread is the
+ * producer, the playback thread the consumer) and returns; it only blocks
+ * when ETHERVOX_PLAYBACK_QUEUE_MS of audio is already waiting. The playback
+ * thread hands the device one ETHERVOX_PLAYBACK_PERIOD_MS period at a time
+ * and starts it after the first period, so the first chunk is heard within
+ * a period or two of being synthesized. Gaps between chunks are filled with
+ * silence to keep the device running; after IDLE_AFTER_MS of silence it is
+ * drained and parked. The mutex only guards the thread's sleep and drain
+ * handshakes, never the samples.
+ */
+struct audio_stream_player {
+    snd_pcm_t* pcm;
+    int sample_rate;
+    int channels;
+    snd_pcm_uframes_t period_frames;
+    ethervox_audio_ring_t* queue;        // Interleaved float samples awaiting the device
+    float* period_float;                 // One period read from the queue
+    int16_t* period_pcm;                 // The same period as S16 for the device
+    ethervox_reference_buffer_t* echo_reference;  // Written by the playback thread only
+    pthread_t thread;
+    bool started;
+    atomic_bool stopping;
+    atomic_bool drain_requested;
+    atomic_bool failed;                  // Device could not be recovered
+    atomic_uint_fast64_t underruns;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;                 // Samples queued, drain requested or stopping
+    pthread_cond_t drained;              // Queue played out after a drain request
+};
+
+static uint64_t player_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static void player_ring_doorbell(audio_stream_player_t* player) {
+    pthread_mutex_lock(&player->mutex);
+    pthread_cond_signal(&player->wake);
+    pthread_mutex_unlock(&player->mutex);
+}
+
+static snd_pcm_t* open_playback_device(void) {
+    const char* candidates[3];
+    size_t count = 0;
+    const char* env_device = getenv("ETHERVOX_ALSA_PLAYBACK");
+    if (env_device && *env_device) {
+        candidates[count++] = env_device;
+    }
+    candidates[count++] = "default";
+    candidates[count++] = "sysdefault";
+
+    for (size_t i = 0; i < count; i++) {
+        snd_pcm_t* pcm = NULL;
+        int err = snd_pcm_open(&pcm, candidates[i], SND_PCM_STREAM_PLAYBACK, 0);
+        if (err >= 0) {
+            ETHERVOX_LOG_INFO("[AudioStream] Using ALSA playback device '%s'", candidates[i]);
+            return pcm;
+        }
+        ETHERVOX_LOG_WARN("[AudioStream] Failed to open playback device '%s': %s",
+                          candidates[i], snd_strerror(err));
+    }
+    return NULL;
+}
+
+static int configure_device(audio_stream_player_t* player) {
+    snd_pcm_t* pcm = player->pcm;
+    snd_pcm_hw_params_t* hw;
+    snd_pcm_sw_params_t* sw;
+    snd_pcm_hw_params_alloca(&hw);
+    snd_pcm_sw_params_alloca(&sw);
+
+    unsigned int rate = (unsigned int)player->sample_rate;
+    snd_pcm_uframes_t period = (snd_pcm_uframes_t)player->sample_rate * ETHERVOX_PLAYBACK_PERIOD_MS / 1000;
+    snd_pcm_uframes_t buffer = period * ETHERVOX_PLAYBACK_PERIODS;
+    int dir = 0;
+    int err;
+
+    if ((err = snd_pcm_hw_params_any(pcm, hw)) < 0 ||
+        (err = snd_pcm_hw_params_set_access(pcm, hw, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0 ||
+        (err = snd_pcm_hw_params_set_format(pcm, hw, SND_PCM_FORMAT_S16_LE)) < 0 ||
+        (err = snd_pcm_hw_params_set_channels(pcm, hw, (unsigned int)player->channels)) < 0 ||
+        (err = snd_pcm_hw_params_set_rate_near(pcm, hw, &rate, &dir)) < 0 ||
+        (err = snd_pcm_hw_params_set_period_size_near(pcm, hw, &period, &dir)) < 0 ||
+        (err = snd_pcm_hw_params_set_buffer_size_near(pcm, hw, &buffer)) < 0 ||
+        (err = snd_pcm_hw_params(pcm, hw)) < 0) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Failed to configure playback device: %s", snd_strerror(err));
+        return err;
+    }
+    if (rate != (unsigned int)player->sample_rate) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Device does not support %d Hz (nearest %u Hz)",
+                           player->sample_rate, rate);
+        return -EINVAL;
+    }
+
+    snd_pcm_hw_params_get_period_size(hw, &period, &dir);
+    snd_pcm_hw_params_get_buffer_size(hw, &buffer);
+    player->period_frames = period;
+
+    // Start on the first period rather than a full buffer, and wake the
+    // thread whenever a period is free
+    if ((err = snd_pcm_sw_params_current(pcm, sw)) < 0 ||
+        (err = snd_pcm_sw_params_set_start_threshold(pcm, sw, period)) < 0 ||
+        (err = snd_pcm_sw_params_set_avail_min(pcm, sw, period)) < 0 ||
+        (err = snd_pcm_sw_params(pcm, sw)) < 0) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Failed to set playback thresholds: %s", snd_strerror(err));
+        return err;
+    }
+
+    ETHERVOX_LOG_DEBUG("[AudioStream] ALSA playback: %u Hz, %d ch, period %lu, buffer %lu frames",
+                       rate, player->channels, (unsigned long)period, (unsigned long)buffer);
+    return 0;
+}
+
+// Hand one period to the device, recovering from underruns and suspends
+static int write_period(audio_stream_player_t* player) {
+    const int16_t* data = player->period_pcm;
+    snd_pcm_uframes_t remaining = player->period_frames;
+
+    while (remaining > 0 && !atomic_load(&player->stopping)) {
+        snd_pcm_sframes_t written = snd_pcm_writei(player->pcm, data, remaining);
+        if (written == -EAGAIN) {
+            snd_pcm_wait(player->pcm, 100);
+            continue;
+        }
+        if (written < 0) {
+            if (written == -EPIPE) {
+                atomic_fetch_add(&player->underruns, 1);
+            }
+            int err = snd_pcm_recover(player->pcm, (int)written, 1);
+            if (err < 0) {
+                ETHERVOX_LOG_ERROR("[AudioStream] Playback device lost: %s", snd_strerror(err));
+                return err;
+            }
+            continue;
+        }
+        data += (size_t)written * (size_t)player->channels;
+        remaining -= (snd_pcm_uframes_t)written;
+    }
+    return 0;
+}
+
+// Convert period_float to S16, feed the echo reference and play it
+static int play_period(audio_stream_player_t* player) {
+    size_t samples = (size_t)player->period_frames * (size_t)player->channels;
+    ethervox_dsp_float_to_s16(player->period_float, player->period_pcm, samples);
+
+    if (player->echo_reference) {
+        // Everything already in the device plays first
+        snd_pcm_sframes_t delay = 0;
+        if (snd_pcm_delay(player->pcm, &delay) < 0 || delay < 0) {
+            delay = 0;
+        }
+        uint64_t play_time_us = player_now_us() +
+                                (uint64_t)delay * 1000000ULL / (uint64_t)player->sample_rate;
+        ethervox_reference_buffer_write_at(player->echo_reference, player->period_float,
+                                           player->period_frames, play_time_us);
+    }
+
+    return write_period(player);
+}
+
+// Let the device play out what it holds, then re-arm it for the next start
+static void park_device(audio_stream_player_t* player) {
+    snd_pcm_drain(player->pcm);
+    snd_pcm_prepare(player->pcm);
+}
+
+static void finish_drain(audio_stream_player_t* player) {
+    pthread_mutex_lock(&player->mutex);
+    atomic_store(&player->drain_requested, false);
+    pthread_cond_broadcast(&player->drained);
+    pthread_mutex_unlock(&player->mutex);
+}
+
+static void* playback_thread(void* arg) {
+    audio_stream_player_t* player = (audio_stream_player_t*)arg;
+    const uint32_t period_samples = (uint32_t)player->period_frames * (uint32_t)player->channels;
+    const uint32_t idle_periods = IDLE_AFTER_MS / ETHERVOX_PLAYBACK_PERIOD_MS;
+    bool running = false;         // Device holds audio
+    uint32_t silent_periods = 0;  // Consecutive fill-in periods while running
+
+    while (!atomic_load(&player->stopping)) {
+        uint32_t queued = ethervox_audio_ring_available(player->queue);
+
+        if (queued == 0) {
+            bool drain = atomic_load(&player->drain_requested);
+            if (running && (drain || silent_periods >= idle_periods)) {
+                park_device(player);
+                running = false;
+                silent_periods = 0;
+            }
+            if (drain) {
+                finish_drain(player);
+                continue;
+            }
+
+            if (!running) {
+                // Nothing to play: sleep until write(), wait() or stop() rings
+                pthread_mutex_lock(&player->mutex);
+                while (ethervox_audio_ring_available(player->queue) == 0 &&
+                       !atomic_load(&player->drain_requested) &&
+                       !atomic_load(&player->stopping)) {
+                    pthread_cond_wait(&player->wake, &player->mutex);
+                }
+                pthread_mutex_unlock(&player->mutex);
+                continue;
+            }
+
+            // Gap between chunks: keep the device fed rather than underrun
+            memset(player->period_float, 0, period_samples * sizeof(float));
+            silent_periods++;
+        } else {
+            // A short read (the tail of an utterance) is padded with silence
+            uint32_t take = queued < period_samples ? queued : period_samples;
+            take -= take % (uint32_t)player->channels;
+            if (take == 0) {
+                continue;
+            }
+            ethervox_audio_ring_read(player->queue, player->period_float, take, NULL);
+            memset(player->period_float + take, 0, (period_samples - take) * sizeof(float));
+            silent_periods = 0;
+        }
+
+        if (play_period(player) < 0) {
+            atomic_store(&player->failed, true);
+            break;
+        }
+        running = true;
+    }
+
+    if (atomic_load(&player->drain_requested)) {
+        finish_drain(player);
+    }
+    return NULL;
+}
+
+audio_stream_player_t* audio_stream_player_create(int sample_rate, int channels) {
+    if (sample_rate <= 0 || channels <= 0 || channels > 2) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Invalid format: %d Hz, %d channels", sample_rate, channels);
+        return NULL;
+    }
+
+    audio_stream_player_t* player = (audio_stream_player_t*)calloc(1, sizeof(audio_stream_player_t));
+    if (!player) return NULL;
+
+    player->sample_rate = sample_rate;
+    player->channels = channels;
+    atomic_init(&player->stopping, false);
+    atomic_init(&player->drain_requested, false);
+    atomic_init(&player->failed, false);
+    atomic_init(&player->underruns, 0);
+
+    player->pcm = open_playback_device();
+    if (!player->pcm || configure_device(player) < 0) {
+        if (player->pcm) snd_pcm_close(player->pcm);
+        free(player);
+        return NULL;
+    }
+
+    size_t period_samples = (size_t)player->period_frames * (size_t)channels;
+    uint32_t queue_samples = (uint32_t)((uint64_t)sample_rate * ETHERVOX_PLAYBACK_QUEUE_MS / 1000) *
+                             (uint32_t)channels;
+    player->queue = ethervox_audio_ring_create(queue_samples, 0);
+    player->period_float = (float*)malloc(period_samples * sizeof(float));
+    player->period_pcm = (int16_t*)malloc(period_samples * sizeof(int16_t));
+    if (!player->queue || !player->period_float || !player->period_pcm) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Failed to allocate playback queue");
+        ethervox_audio_ring_destroy(player->queue);
+        free(player->period_float);
+        free(player->period_pcm);
+        snd_pcm_close(player->pcm);
+        free(player);
+        return NULL;
+    }
+
+    pthread_mutex_init(&player->mutex, NULL);
+    pthread_cond_init(&player->wake, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&player->drained, &attr);
+    pthread_condattr_destroy(&attr);
+
+    return player;
+}
+
+ethervox_result_t audio_stream_player_start(audio_stream_player_t* player) {
+    ETHERVOX_CHECK_PTR(player);
+    if (player->started) {
+        return ETHERVOX_ERROR_ALREADY_INITIALIZED;
+    }
+
+    int err = snd_pcm_prepare(player->pcm);
+    if (err < 0) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Failed to prepare playback device: %s", snd_strerror(err));
+        return ETHERVOX_ERROR_AUDIO_INIT;
+    }
+
+    atomic_store(&player->stopping, false);
+    atomic_store(&player->failed, false);
+    if (pthread_create(&player->thread, NULL, playback_thread, player) != 0) {
+        ETHERVOX_LOG_ERROR("[AudioStream] Failed to create playback thread");
+        return ETHERVOX_ERROR_AUDIO_INIT;
+    }
+
+    player->started = true;
+    return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t audio_stream_player_write(audio_stream_player_t* player,
+                               const float* samples,
+                               size_t sample_count) {
+    ETHERVOX_CHECK_PTR(player);
+    if (!player->started || atomic_load(&player->stopping)) {
+        return ETHERVOX_ERROR_NOT_INITIALIZED;
+    }
+    if (atomic_load(&player->failed)) {
+        return ETHERVOX_ERROR_AUDIO_DEVICE_NOT_FOUND;
+    }
+    if (!samples || sample_count == 0) {
+        return ETHERVOX_SUCCESS;
+    }
+
+    size_t total = sample_count * (size_t)player->channels;
+    size_t offset = 0;
+    const struct timespec period_sleep = {0, ETHERVOX_PLAYBACK_PERIOD_MS * 1000000L};
+
+    while (offset < total) {
+        uint32_t space = ethervox_audio_ring_write_space(player->queue);
+        if (space == 0) {
+            // Queue full: let the device catch up
+            if (atomic_load(&player->stopping) || atomic_load(&player->failed)) {
+                return ETHERVOX_ERROR_NOT_INITIALIZED;
+            }
+            nanosleep(&period_sleep, NULL);
+            continue;
+        }
+
+        size_t chunk = total - offset;
+        if (chunk > space) chunk = space;
+        ethervox_audio_ring_write(player->queue, samples + offset, (uint32_t)chunk, 0);
+        offset += chunk;
+        player_ring_doorbell(player);
+    }
+
+    return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t audio_stream_player_wait(audio_stream_player_t* player) {
+    ETHERVOX_CHECK_PTR(player);
+    if (!player->started) {
+        return ETHERVOX_ERROR_NOT_INITIALIZED;
+    }
+
+    // The playback thread plays out the queue, drains the device and signals
+    ethervox_result_t result = ETHERVOX_SUCCESS;
+    pthread_mutex_lock(&player->mutex);
+    atomic_store(&player->drain_requested, true);
+    pthread_cond_signal(&player->wake);
+    while (atomic_load(&player->drain_requested) && !atomic_load(&player->failed)) {
+        // Queued audio plus the device buffer, with a margin for a stalled device
+        struct timespec timeout;
+        clock_gettime(CLOCK_MONOTONIC, &timeout);
+        timeout.tv_sec += DRAIN_TIMEOUT_SEC;
+
+        uint32_t queued_before = ethervox_audio_ring_available(player->queue);
+        int rc = pthread_cond_timedwait(&player->drained, &player->mutex, &timeout);
+        if (rc == ETIMEDOUT && ethervox_audio_ring_available(player->queue) >= queued_before) {
+            ETHERVOX_LOG_ERROR("[AudioStream] Wait timeout - %u samples still queued", queued_before);
+            atomic_store(&player->drain_requested, false);
+            result = ETHERVOX_ERROR_TIMEOUT;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&player->mutex);
+
+    if (atomic_load(&player->failed)) {
+        result = ETHERVOX_ERROR_AUDIO_DEVICE_NOT_FOUND;
+    }
+
+    uint64_t underruns = atomic_load(&player->underruns);
+    if (underruns > 0) {
+        ETHERVOX_LOG_DEBUG("[AudioStream] %llu playback underruns recovered so far",
+                           (unsigned long long)underruns);
+    }
+    return result;
+}
+
+void audio_stream_player_stop(audio_stream_player_t* player) {
+    if (!player) return;
+
+    pthread_mutex_lock(&player->mutex);
+    atomic_store(&player->stopping, true);
+    pthread_cond_broadcast(&player->wake);
+    pthread_mutex_unlock(&player->mutex);
+
+    if (player->started) {
+        pthread_join(player->thread, NULL);
+        player->started = false;
+
+        // Discard whatever the device and the queue still hold
+        snd_pcm_drop(player->pcm);
+        ethervox_audio_ring_reset(player->queue);
+        if (player->echo_reference) {
+            ethervox_reference_buffer_clear(player->echo_reference);
+        }
+    }
+}
+
+ethervox_result_t audio_stream_player_set_echo_reference(audio_stream_player_t* player,
+                                                         ethervox_reference_buffer_t* reference) {
+    ETHERVOX_CHECK_PTR(player);
+    if (player->started) {
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_ALREADY_INITIALIZED,
+                              "Echo reference must be set before playback starts");
+    }
+    if (reference && player->channels != 1) {
+        ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Echo reference needs a mono player");
+    }
+
+    player->echo_reference = reference;
+    return ETHERVOX_SUCCESS;
+}
+
+void audio_stream_player_destroy(audio_stream_player_t* player) {
+    if (!player) return;
+
+    audio_stream_player_stop(player);
+
+    snd_pcm_close(player->pcm);
+    ethervox_audio_ring_destroy(player->queue);
+    free(player->period_float);
+    free(player->period_pcm);
+    pthread_mutex_destroy(&player->mutex);
+    pthread_cond_destroy(&player->wake);
+    pthread_cond_destroy(&player->drained);
+    free(player);
+}
+
 #else
-// Stub implementation for non-macOS platforms
+// Stub implementation for other platforms
 struct audio_stream_player {
     int dummy;
 };
@@ -287,6 +751,9 @@ ethervox_result_t audio_stream_player_wait(audio_stream_player_t* player) {
     return ETHERVOX_ERROR_NOT_SUPPORTED; 
 }
 void audio_stream_player_stop(audio_stream_player_t* player) {}
+ethervox_result_t audio_stream_player_set_echo_reference(audio_stream_player_t* player, ethervox_reference_buffer_t* reference) {
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
 void audio_stream_player_destroy(audio_stream_player_t* player) { free(player); }
 
 #endif
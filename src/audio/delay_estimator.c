@@ -0,0 +1,291 @@
+/**
+ * @file delay_estimator.c
+ * @brief GCC-PHAT estimator of the far-end to microphone delay
+ *
+ * Each block holds hop new mic samples and the matching reference samples
+ * plus max_delay of reference history, zero-padded to a power-of-two FFT no
+ * shorter than both together, so lags 0..max_delay correlate without
+ * circular wrap. Both real blocks go through one complex FFT (reference in
+ * the real part, mic in the imaginary part) and are separated by symmetry.
+ */
+
+#include "ethervox/delay_estimator.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include "ethervox/logging.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+struct ethervox_delay_estimator_s {
+    ethervox_delay_estimator_config_t config;
+
+    uint32_t fft_size;      // N
+    uint32_t max_lag;       // Longest delay searched, in samples
+    uint32_t hop;           // New samples per block (N - max_lag)
+    uint32_t fill;          // Samples of the current block received so far
+
+    float* reference;       // [max_lag history | hop current], N long
+    float* mic;             // hop current mic samples
+    float* re;              // FFT work buffers
+    float* im;
+    float* cross_re;        // Smoothed cross-spectrum, bins 0..N/2
+    float* cross_im;
+    ethervox_fft_t* fft;
+
+    bool primed;            // cross_* holds at least one block
+    int delay;              // Reported delay (-1 until locked)
+    int candidate;          // Peak lag awaiting confirmation
+    int stable;             // Consecutive confident blocks at the candidate
+    float confidence;
+};
+
+ethervox_delay_estimator_config_t ethervox_delay_estimator_default_config(void) {
+    ethervox_delay_estimator_config_t config = {
+        .sample_rate = ETHERVOX_AUDIO_SAMPLE_RATE,
+        .max_delay_ms = ETHERVOX_AEC_MAX_DELAY_MS,
+        .smoothing = 0.6f,            // ~0.5 s memory at 16 kHz
+        .min_confidence = ETHERVOX_AEC_DELAY_CONFIDENCE,
+        .min_reference_rms = 0.003f,  // ~-50 dBFS: far end is playing
+    };
+    return config;
+}
+
+static float block_rms(const float* x, uint32_t count) {
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += (double)x[i] * x[i];
+    }
+    return (float)sqrt(sum / count);
+}
+
+// Analyse a complete block; returns true if the reported delay changed
+static bool analyse_block(ethervox_delay_estimator_t* est) {
+    const uint32_t n = est->fft_size;
+    const uint32_t half = n / 2;
+
+    // Only blocks with far-end audio (and something at the mic) carry delay information
+    if (block_rms(est->reference + est->max_lag, est->hop) < est->config.min_reference_rms ||
+        block_rms(est->mic, est->hop) < 1e-6f) {
+        return false;
+    }
+
+    memcpy(est->re, est->reference, n * sizeof(float));
+    memcpy(est->im, est->mic, est->hop * sizeof(float));
+    memset(est->im + est->hop, 0, (n - est->hop) * sizeof(float));
+    ethervox_fft_complex(est->fft, est->re, est->im, false);
+
+    // Split Z = FFT(ref + i*mic) into Y = FFT(ref) and X = FFT(mic), then
+    // smooth the cross-spectrum Y * conj(X)
+    const float beta = est->primed ? est->config.smoothing : 0.0f;
+    for (uint32_t k = 0; k <= half; k++) {
+        uint32_t nk = (n - k) & (n - 1);
+        float yr = 0.5f * (est->re[k] + est->re[nk]);
+        float yi = 0.5f * (est->im[k] - est->im[nk]);
+        float xr = 0.5f * (est->im[k] + est->im[nk]);
+        float xi = -0.5f * (est->re[k] - est->re[nk]);
+        float gr = yr * xr + yi * xi;
+        float gi = yi * xr - yr * xi;
+        est->cross_re[k] = beta * est->cross_re[k] + (1.0f - beta) * gr;
+        est->cross_im[k] = beta * est->cross_im[k] + (1.0f - beta) * gi;
+    }
+    est->primed = true;
+
+    // Phase transform: keep only the phase of each bin, so every frequency
+    // votes equally and the correlation peak is sharp. DC and Nyquist carry
+    // no delay information.
+    for (uint32_t k = 0; k <= half; k++) {
+        float mag = sqrtf(est->cross_re[k] * est->cross_re[k] + est->cross_im[k] * est->cross_im[k]);
+        if (k == 0 || k == half || mag < 1e-20f) {
+            est->re[k] = 0.0f;
+            est->im[k] = 0.0f;
+        } else {
+            est->re[k] = est->cross_re[k] / mag;
+            est->im[k] = est->cross_im[k] / mag;
+        }
+    }
+    for (uint32_t k = half + 1; k < n; k++) {
+        est->re[k] = est->re[n - k];
+        est->im[k] = -est->im[n - k];
+    }
+    ethervox_fft_complex(est->fft, est->re, est->im, true);
+
+    // re[m] now correlates ref[n + m] with mic[n]; an echo delayed by d
+    // samples peaks at m = max_lag - d
+    uint32_t peak_m = 0;
+    float peak = 0.0f;
+    for (uint32_t m = 0; m <= est->max_lag; m++) {
+        float v = fabsf(est->re[m]);
+        if (v > peak) {
+            peak = v;
+            peak_m = m;
+        }
+    }
+
+    double floor_sum = 0.0;
+    uint32_t floor_count = 0;
+    for (uint32_t m = 0; m <= est->max_lag; m++) {
+        if (m + 2 >= peak_m && m <= peak_m + 2) {
+            continue;
+        }
+        floor_sum += (double)est->re[m] * est->re[m];
+        floor_count++;
+    }
+    float floor_rms = floor_count ? (float)sqrt(floor_sum / floor_count) : 0.0f;
+    est->confidence = floor_rms > 0.0f ? peak / floor_rms : 0.0f;
+
+    if (est->confidence < est->config.min_confidence) {
+        est->stable = 0;
+        return false;
+    }
+
+    int lag = (int)(est->max_lag - peak_m);
+    if (est->stable > 0 && abs(lag - est->candidate) <= 1) {
+        est->stable++;
+    } else {
+        est->candidate = lag;
+        est->stable = 1;
+    }
+
+    // Two confident blocks in a row; ignore one-sample wobble
+    if (est->stable >= 2 && (est->delay < 0 || abs(lag - est->delay) > 1)) {
+        ETHERVOX_LOG_DEBUG("Echo delay %d -> %d samples (%.1f ms, confidence %.1f)",
+                           est->delay, lag, (float)lag * 1000.0f / (float)est->config.sample_rate,
+                           est->confidence);
+        est->delay = lag;
+        return true;
+    }
+
+    return false;
+}
+
+ethervox_delay_estimator_t* ethervox_delay_estimator_create(const ethervox_delay_estimator_config_t* config) {
+    ethervox_delay_estimator_config_t cfg = config ? *config : ethervox_delay_estimator_default_config();
+
+    if (cfg.sample_rate < 8000 || cfg.sample_rate > 96000) {
+        ETHERVOX_LOG_ERROR("Unsupported delay estimator sample rate: %u", cfg.sample_rate);
+        return NULL;
+    }
+    if (cfg.max_delay_ms == 0 || cfg.max_delay_ms > 2000) {
+        ETHERVOX_LOG_ERROR("Invalid max delay: %u ms (must be 1-2000)", cfg.max_delay_ms);
+        return NULL;
+    }
+    if (cfg.smoothing < 0.0f || cfg.smoothing >= 1.0f || cfg.min_confidence <= 0.0f) {
+        ETHERVOX_LOG_ERROR("Invalid delay estimator smoothing/confidence: %.2f/%.2f",
+                           cfg.smoothing, cfg.min_confidence);
+        return NULL;
+    }
+
+    ethervox_delay_estimator_t* est = (ethervox_delay_estimator_t*)calloc(1, sizeof(*est));
+    if (!est) {
+        ETHERVOX_LOG_ERROR("Failed to allocate delay estimator");
+        return NULL;
+    }
+    est->config = cfg;
+
+    // Block must hold the full lag range plus at least 100 ms of new audio
+    est->max_lag = (uint32_t)((uint64_t)cfg.sample_rate * cfg.max_delay_ms / 1000);
+    uint32_t bits = 0;
+    while ((1u << bits) < est->max_lag + cfg.sample_rate / 10) {
+        bits++;
+    }
+    est->fft_size = 1u << bits;
+    est->hop = est->fft_size - est->max_lag;
+
+    const uint32_t n = est->fft_size;
+    est->reference = (float*)calloc(n, sizeof(float));
+    est->mic = (float*)calloc(est->hop, sizeof(float));
+    est->re = (float*)calloc(n, sizeof(float));
+    est->im = (float*)calloc(n, sizeof(float));
+    est->cross_re = (float*)calloc(n / 2 + 1, sizeof(float));
+    est->cross_im = (float*)calloc(n / 2 + 1, sizeof(float));
+    est->fft = ethervox_fft_create(n);
+    if (!est->reference || !est->mic || !est->re || !est->im || !est->cross_re || !est->cross_im ||
+        !est->fft) {
+        ETHERVOX_LOG_ERROR("Failed to allocate delay estimator buffers (FFT size %u)", n);
+        ethervox_delay_estimator_destroy(est);
+        return NULL;
+    }
+
+    est->delay = -1;
+
+    ETHERVOX_LOG_DEBUG("Delay estimator created: max delay %u ms, FFT %u, block %u samples",
+                       cfg.max_delay_ms, n, est->hop);
+    return est;
+}
+
+bool ethervox_delay_estimator_process(ethervox_delay_estimator_t* est,
+                                      const float* reference,
+                                      const float* mic,
+                                      size_t count) {
+    if (!est || !reference || !mic) {
+        return false;
+    }
+
+    bool changed = false;
+    while (count > 0) {
+        uint32_t n = est->hop - est->fill;
+        if (n > count) {
+            n = (uint32_t)count;
+        }
+        memcpy(est->reference + est->max_lag + est->fill, reference, n * sizeof(float));
+        memcpy(est->mic + est->fill, mic, n * sizeof(float));
+        est->fill += n;
+        reference += n;
+        mic += n;
+        count -= n;
+
+        if (est->fill == est->hop) {
+            changed |= analyse_block(est);
+            // Newest max_lag reference samples become the next block's history
+            memmove(est->reference, est->reference + est->hop, est->max_lag * sizeof(float));
+            est->fill = 0;
+        }
+    }
+
+    return changed;
+}
+
+int ethervox_delay_estimator_get_delay(const ethervox_delay_estimator_t* est) {
+    return est ? est->delay : -1;
+}
+
+float ethervox_delay_estimator_get_confidence(const ethervox_delay_estimator_t* est) {
+    return est ? est->confidence : 0.0f;
+}
+
+size_t ethervox_delay_estimator_block_size(const ethervox_delay_estimator_t* est) {
+    return est ? est->hop : 0;
+}
+
+void ethervox_delay_estimator_reset(ethervox_delay_estimator_t* est) {
+    if (!est) {
+        return;
+    }
+
+    memset(est->reference, 0, est->fft_size * sizeof(float));
+    memset(est->cross_re, 0, (est->fft_size / 2 + 1) * sizeof(float));
+    memset(est->cross_im, 0, (est->fft_size / 2 + 1) * sizeof(float));
+    est->fill = 0;
+    est->primed = false;
+    est->delay = -1;
+    est->candidate = 0;
+    est->stable = 0;
+    est->confidence = 0.0f;
+}
+
+void ethervox_delay_estimator_destroy(ethervox_delay_estimator_t* est) {
+    if (!est) {
+        return;
+    }
+
+    free(est->reference);
+    free(est->mic);
+    free(est->re);
+    free(est->im);
+    free(est->cross_re);
+    free(est->cross_im);
+    ethervox_fft_destroy(est->fft);
+    free(est);
+}
@@ -22,6 +22,8 @@
 #include <math.h>
 
 #include "ethervox/audio.h"
+#include "ethervox/audio_buffer.h"
+#include "ethervox/dsp.h"
 
 #if defined(__ANDROID__)
 
@@ -316,12 +318,9 @@ typedef struct {
   size_t buffer_size;
   ethervox_audio_runtime_t* runtime;
   
-  // Ring buffer for synchronous reads (like macOS)
-  int16_t* ring_buffer;  // Store int16, convert to float on read
-  size_t ring_buffer_size;
-  size_t write_pos;
-  size_t read_pos;
-  pthread_mutex_t lock;
+  // Lock-free ring for synchronous reads (like macOS): the recorder
+  // callback produces, opensl_read_audio consumes
+  ethervox_audio_ring_t* capture_ring;
 } opensl_data_t;
 
 static void opensl_recorder_callback(SLAndroidSimpleBufferQueueItf bq, void* context) {
@@ -330,39 +329,34 @@ static void opensl_recorder_callback(SLAndroidSimpleBufferQueueItf bq, void* con
     return;
   }
 
-  // Copy int16 audio data to ring buffer for synchronous reads
-  pthread_mutex_lock(&data->lock);
-  
-  size_t sample_count = data->buffer_size;
-  for (size_t i = 0; i < sample_count; i++) {
-    data->ring_buffer[data->write_pos] = data->capture_buffer[i];
-    data->write_pos = (data->write_pos + 1) % data->ring_buffer_size;
-    
-    // Overwrite old data if buffer full
-    if (data->write_pos == data->read_pos) {
-      data->read_pos = (data->read_pos + 1) % data->ring_buffer_size;
-    }
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t timestamp_us = (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+
+  // Convert into the capture ring (no lock on the audio thread; if the
+  // reader has fallen 10 s behind, the newest samples are dropped)
+  ethervox_audio_span_t span;
+  uint32_t space = ethervox_audio_ring_begin_write(data->capture_ring, &span);
+  uint32_t count = data->buffer_size < space ? (uint32_t)data->buffer_size : space;
+  uint32_t first = count < span.size[0] ? count : span.size[0];
+  ethervox_dsp_s16_to_float(data->capture_buffer, span.data[0], first);
+  if (count > first) {
+    ethervox_dsp_s16_to_float(data->capture_buffer + first, span.data[1], count - first);
   }
-  
-  pthread_mutex_unlock(&data->lock);
+  ethervox_audio_ring_end_write(data->capture_ring, count, timestamp_us);
 
   // Also call user callback if set (for backward compatibility)
   if (data->runtime->on_audio_data) {
     // Convert int16 to float for the callback
     static float temp_buffer[16000];  // Max 1 second at 16kHz
     size_t count = (data->buffer_size < 16000) ? data->buffer_size : 16000;
-    for (size_t i = 0; i < count; i++) {
-      temp_buffer[i] = (float)data->capture_buffer[i] / 32768.0f;
-    }
+    ethervox_dsp_s16_to_float(data->capture_buffer, temp_buffer, count);
     
     ethervox_audio_buffer_t buffer;
     buffer.data = temp_buffer;
     buffer.size = (uint32_t)data->buffer_size;
     buffer.channels = data->runtime->config.channels;
-    
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    buffer.timestamp_us = (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+    buffer.timestamp_us = timestamp_us;
     
     data->runtime->on_audio_data(&buffer, data->runtime->user_data);
   }
@@ -387,18 +381,14 @@ static int opensl_init(ethervox_audio_runtime_t* runtime,
   audio_data->capture_buffer = (int16_t*)malloc(config->buffer_size * sizeof(int16_t) * config->channels);
   audio_data->playback_buffer = (float*)malloc(config->buffer_size * sizeof(float) * config->channels);
   
-  // Allocate ring buffer (10 seconds of audio at 16kHz)
-  audio_data->ring_buffer_size = config->sample_rate * 10;
-  audio_data->ring_buffer = (int16_t*)calloc(audio_data->ring_buffer_size, sizeof(int16_t));
-  audio_data->write_pos = 0;
-  audio_data->read_pos = 0;
-  pthread_mutex_init(&audio_data->lock, NULL);
+  // Capture ring (10 seconds of audio)
+  audio_data->capture_ring = ethervox_audio_ring_create(config->sample_rate * 10, config->sample_rate);
   
-  if (!audio_data->capture_buffer || !audio_data->playback_buffer || !audio_data->ring_buffer) {
+  if (!audio_data->capture_buffer || !audio_data->playback_buffer || !audio_data->capture_ring) {
     LOGE("Failed to allocate audio buffers");
     free(audio_data->capture_buffer);
     free(audio_data->playback_buffer);
-    free(audio_data->ring_buffer);
+    ethervox_audio_ring_destroy(audio_data->capture_ring);
     free(audio_data);
     return -1;
   }
@@ -409,6 +399,7 @@ static int opensl_init(ethervox_audio_runtime_t* runtime,
     LOGE("Failed to create OpenSL ES engine: %d", result);
     free(audio_data->capture_buffer);
     free(audio_data->playback_buffer);
+    ethervox_audio_ring_destroy(audio_data->capture_ring);
     free(audio_data);
     return -1;
   }
@@ -419,6 +410,7 @@ static int opensl_init(ethervox_audio_runtime_t* runtime,
     (*audio_data->engine_object)->Destroy(audio_data->engine_object);
     free(audio_data->capture_buffer);
     free(audio_data->playback_buffer);
+    ethervox_audio_ring_destroy(audio_data->capture_ring);
     free(audio_data);
     return -1;
   }
@@ -431,6 +423,7 @@ static int opensl_init(ethervox_audio_runtime_t* runtime,
     (*audio_data->engine_object)->Destroy(audio_data->engine_object);
     free(audio_data->capture_buffer);
     free(audio_data->playback_buffer);
+    ethervox_audio_ring_destroy(audio_data->capture_ring);
     free(audio_data);
     return -1;
   }
@@ -714,33 +707,16 @@ static int opensl_read_audio(ethervox_audio_runtime_t* runtime, ethervox_audio_b
     return -1;
   }
   
-  pthread_mutex_lock(&data->lock);
-  
-  // Calculate available samples in ring buffer
-  size_t available;
-  if (data->write_pos >= data->read_pos) {
-    available = data->write_pos - data->read_pos;
-  } else {
-    available = data->ring_buffer_size - data->read_pos + data->write_pos;
-  }
-  
+  uint32_t available = ethervox_audio_ring_available(data->capture_ring);
   if (available == 0) {
-    pthread_mutex_unlock(&data->lock);
     return 0; // No data available
   }
   
-  // Read up to buffer capacity
-  size_t to_read = (available < buffer->size) ? available : buffer->size;
-  
-  // Convert int16 to float32 normalized to [-1.0, 1.0] (like macOS)
-  for (size_t i = 0; i < to_read; i++) {
-    buffer->data[i] = (float)data->ring_buffer[data->read_pos] / 32768.0f;
-    data->read_pos = (data->read_pos + 1) % data->ring_buffer_size;
-  }
-  
-  pthread_mutex_unlock(&data->lock);
-  
-  buffer->size = to_read; // Update buffer with actual samples read
+  // Read up to buffer capacity (already float32 in [-1.0, 1.0], like macOS)
+  uint32_t to_read = (available < buffer->size) ? available : buffer->size;
+  uint64_t timestamp_us = 0;
+  buffer->size = ethervox_audio_ring_read(data->capture_ring, buffer->data, to_read, &timestamp_us);
+  buffer->timestamp_us = timestamp_us;
   return ETHERVOX_SUCCESS; // Return 0 for success, not sample count
 }
 
@@ -783,11 +759,7 @@ static void opensl_cleanup(ethervox_audio_runtime_t* runtime) {
   if (audio_data->playback_buffer) {
     free(audio_data->playback_buffer);
   }
-  if (audio_data->ring_buffer) {
-    free(audio_data->ring_buffer);
-  }
-  
-  pthread_mutex_destroy(&audio_data->lock);
+  ethervox_audio_ring_destroy(audio_data->capture_ring);
 
   free(audio_data);
   runtime->platform_data = NULL;
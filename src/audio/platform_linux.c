@@ -23,39 +23,409 @@
 
 #ifdef ETHERVOX_PLATFORM_LINUX
 #include <alsa/asoundlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "ethervox/audio_buffer.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
 
 static const size_t kLinuxMaxDeviceCandidates = 3U;
-static const unsigned int kLinuxDefaultPeriods = 2U;
+enum { kLinuxMaxPollDescriptors = 8 };
+static const int kLinuxCapturePollTimeoutMs = 500;  // Device stalled if no period arrives in this time
+static const int kLinuxReadTimeoutMs = 100;         // Longest ethervox_audio_read() waits for a period
+static const uint32_t kLinuxCaptureRingSeconds = 10U;
 
 typedef struct {
   snd_pcm_t* pcm_capture;
   snd_pcm_t* pcm_playback;
-  snd_pcm_uframes_t buffer_frames;
   bool is_recording;
   bool is_playing;
+
+  // Capture engine: the capture thread produces, linux_audio_read consumes
+  ethervox_audio_ring_t* capture_ring;
+  int16_t* capture_scratch;      // Copy buffer when the device has no mmap access
+  pthread_t capture_thread;
+  int stop_fd;                   // eventfd: wakes the capture thread to exit
+  int data_fd;                   // eventfd: a period reached the ring (or capture failed)
+  atomic_bool capture_running;
+  atomic_bool capture_failed;
+  uint32_t sample_rate;
+  uint32_t device_rate;          // Differs from sample_rate when the device cannot run at it
+  uint32_t channels;
+  ethervox_resampler_t* resampler;  // device_rate -> sample_rate (mono only), else NULL
+  float* resample_in;
+  float* resample_out;
+  snd_pcm_uframes_t period_frames;
+  snd_pcm_uframes_t buffer_frames;
+  bool mmap_access;
+  bool realtime;
+
+  // Capture statistics (written by the capture thread, read from any thread)
+  atomic_uint_fast64_t frames_captured;
+  atomic_uint_fast64_t xruns;
+  atomic_uint_fast64_t samples_dropped;
+  atomic_uint_fast32_t max_wakeup_gap_us;
 } linux_audio_data_t;
 
+// Monotonic, to match the playback times the streaming player writes to the
+// echo reference (wall-clock steps would misalign the AEC)
+static uint64_t linux_get_timestamp_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * ETHERVOX_PLATFORM_US_PER_SEC + (uint64_t)ts.tv_nsec /
+                                                        ETHERVOX_PLATFORM_US_PER_MS;
+}
+
+static unsigned int linux_env_uint(const char* name, unsigned int fallback) {
+  const char* value = getenv(name);
+  if (!value || !*value) {
+    return fallback;
+  }
+  char* end = NULL;
+  unsigned long parsed = strtoul(value, &end, 10);
+  return (end && *end == '\0' && parsed > 0 && parsed <= 1000) ? (unsigned int)parsed : fallback;
+}
+
 static ethervox_result_t linux_audio_init(ethervox_audio_runtime_t* runtime,
                             const ethervox_audio_config_t* config) {
   linux_audio_data_t* audio_data = (linux_audio_data_t*)calloc(1, sizeof(linux_audio_data_t));
   if (!audio_data) {
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate Linux audio state");
   }
-  runtime->platform_data = audio_data;
 
-  audio_data->buffer_frames = config->buffer_size;
+  audio_data->sample_rate = config->sample_rate ? config->sample_rate : ETHERVOX_AUDIO_SAMPLE_RATE;
+  audio_data->channels = config->channels ? config->channels : 1;
+  audio_data->stop_fd = -1;
+  audio_data->data_fd = -1;
+
+  audio_data->capture_ring = ethervox_audio_ring_create(
+      audio_data->sample_rate * audio_data->channels * kLinuxCaptureRingSeconds,
+      audio_data->sample_rate * audio_data->channels);
+  if (!audio_data->capture_ring) {
+    free(audio_data);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture ring buffer");
+  }
+
+  runtime->platform_data = audio_data;
   printf("Linux ALSA audio driver initialized\n");
   return ETHERVOX_SUCCESS;
 }
 
+static int linux_configure_capture(linux_audio_data_t* audio_data) {
+  snd_pcm_t* pcm = audio_data->pcm_capture;
+  snd_pcm_hw_params_t* hw_params;
+  snd_pcm_sw_params_t* sw_params;
+  snd_pcm_hw_params_alloca(&hw_params);
+  snd_pcm_sw_params_alloca(&sw_params);
+
+  unsigned int period_ms = linux_env_uint("ETHERVOX_ALSA_PERIOD_MS", ETHERVOX_CAPTURE_PERIOD_MS);
+  unsigned int periods = linux_env_uint("ETHERVOX_ALSA_PERIODS", ETHERVOX_CAPTURE_PERIODS);
+  unsigned int sample_rate = audio_data->sample_rate;
+  snd_pcm_uframes_t period;
+  snd_pcm_uframes_t buffer;
+  int err;
+
+  // Prefer mmap so periods are converted straight out of the DMA buffer;
+  // plugins that cannot map fall back to copying reads
+  snd_pcm_hw_params_any(pcm, hw_params);
+  audio_data->mmap_access =
+      snd_pcm_hw_params_set_access(pcm, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0;
+  if (!audio_data->mmap_access &&
+      (err = snd_pcm_hw_params_set_access(pcm, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0) {
+    printf("ALSA: no usable capture access mode: %s\n", snd_strerror(err));
+    return err;
+  }
+
+  if ((err = snd_pcm_hw_params_set_format(pcm, hw_params, SND_PCM_FORMAT_S16_LE)) < 0 ||
+      (err = snd_pcm_hw_params_set_channels(pcm, hw_params, audio_data->channels)) < 0 ||
+      (err = snd_pcm_hw_params_set_rate_near(pcm, hw_params, &sample_rate, 0)) < 0) {
+    printf("Cannot set hardware parameters: %s\n", snd_strerror(err));
+    return err;
+  }
+
+  // Period and buffer are durations, so size them at the rate the device accepted
+  period = (snd_pcm_uframes_t)sample_rate * period_ms / 1000;
+  buffer = period * (periods < 2 ? 2 : periods);
+  if ((err = snd_pcm_hw_params_set_period_size_near(pcm, hw_params, &period, 0)) < 0 ||
+      (err = snd_pcm_hw_params_set_buffer_size_near(pcm, hw_params, &buffer)) < 0 ||
+      (err = snd_pcm_hw_params(pcm, hw_params)) < 0) {
+    printf("Cannot set hardware parameters: %s\n", snd_strerror(err));
+    return err;
+  }
+  if (sample_rate != audio_data->sample_rate && audio_data->channels != 1) {
+    printf("ALSA: capture device does not support %u Hz (nearest %u Hz)\n",
+           audio_data->sample_rate, sample_rate);
+    return -EINVAL;
+  }
+
+  snd_pcm_hw_params_get_period_size(hw_params, &audio_data->period_frames, 0);
+  snd_pcm_hw_params_get_buffer_size(hw_params, &audio_data->buffer_frames);
+  audio_data->device_rate = sample_rate;
+
+  // Raw hw devices often only run at 44.1/48 kHz: convert on the capture thread
+  if (sample_rate != audio_data->sample_rate) {
+    audio_data->resampler =
+        ethervox_resampler_create(sample_rate, audio_data->sample_rate, audio_data->buffer_frames);
+    audio_data->resample_in = (float*)malloc((size_t)audio_data->buffer_frames * sizeof(float));
+    audio_data->resample_out = (float*)malloc(
+        ethervox_resampler_max_output(audio_data->resampler, audio_data->buffer_frames) * sizeof(float));
+    if (!audio_data->resampler || !audio_data->resample_in || !audio_data->resample_out) {
+      printf("ALSA: cannot resample capture from %u Hz to %u Hz\n", sample_rate, audio_data->sample_rate);
+      return -ENOMEM;
+    }
+    printf("ALSA: capture device runs at %u Hz, resampling to %u Hz\n", sample_rate, audio_data->sample_rate);
+  }
+
+  // Wake once per period; the thread starts the stream itself
+  if ((err = snd_pcm_sw_params_current(pcm, sw_params)) < 0 ||
+      (err = snd_pcm_sw_params_set_avail_min(pcm, sw_params, audio_data->period_frames)) < 0 ||
+      (err = snd_pcm_sw_params_set_start_threshold(pcm, sw_params, audio_data->buffer_frames * 2)) < 0 ||
+      (err = snd_pcm_sw_params(pcm, sw_params)) < 0) {
+    printf("Cannot set software parameters: %s\n", snd_strerror(err));
+    return err;
+  }
+
+  printf("ALSA: capture %u Hz, %u ch, period %lu frames, buffer %lu frames, %s access\n",
+         sample_rate, audio_data->channels, (unsigned long)audio_data->period_frames,
+         (unsigned long)audio_data->buffer_frames, audio_data->mmap_access ? "mmap" : "read");
+  return 0;
+}
+
+// Convert device frames into the ring (no allocation, locking or logging:
+// this runs on the real-time thread). A full ring drops the newest samples.
+static void linux_capture_push(linux_audio_data_t* audio_data, const int16_t* samples,
+                               snd_pcm_uframes_t frames, uint64_t timestamp_us) {
+  uint32_t count = (uint32_t)frames * audio_data->channels;
+
+  if (audio_data->resampler) {
+    ethervox_dsp_s16_to_float(samples, audio_data->resample_in, frames);
+    uint32_t produced = (uint32_t)ethervox_resampler_process(audio_data->resampler, audio_data->resample_in,
+                                                             frames, audio_data->resample_out);
+    uint32_t written =
+        ethervox_audio_ring_write(audio_data->capture_ring, audio_data->resample_out, produced, timestamp_us);
+    if (written < produced) {
+      atomic_fetch_add(&audio_data->samples_dropped, produced - written);
+    }
+    atomic_fetch_add(&audio_data->frames_captured, frames);
+    return;
+  }
+
+  ethervox_audio_span_t span;
+  uint32_t space = ethervox_audio_ring_begin_write(audio_data->capture_ring, &span);
+  uint32_t n = count < space ? count : space;
+  uint32_t first = n < span.size[0] ? n : span.size[0];
+
+  ethervox_dsp_s16_to_float(samples, span.data[0], first);
+  if (n > first) {
+    ethervox_dsp_s16_to_float(samples + first, span.data[1], n - first);
+  }
+  ethervox_audio_ring_end_write(audio_data->capture_ring, n, timestamp_us);
+
+  if (n < count) {
+    atomic_fetch_add(&audio_data->samples_dropped, count - n);
+  }
+  atomic_fetch_add(&audio_data->frames_captured, frames);
+}
+
+// Move `avail` frames out of the device; returns 0 or a negative ALSA error
+static int linux_capture_transfer(linux_audio_data_t* audio_data, snd_pcm_uframes_t avail,
+                                  uint64_t timestamp_us) {
+  snd_pcm_t* pcm = audio_data->pcm_capture;
+
+  while (avail > 0) {
+    snd_pcm_uframes_t frames = avail;
+
+    if (audio_data->mmap_access) {
+      const snd_pcm_channel_area_t* areas = NULL;
+      snd_pcm_uframes_t offset = 0;
+      int err = snd_pcm_mmap_begin(pcm, &areas, &offset, &frames);
+      if (err < 0) {
+        return err;
+      }
+
+      const int16_t* samples =
+          (const int16_t*)((const char*)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8);
+      linux_capture_push(audio_data, samples, frames, timestamp_us);
+
+      snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pcm, offset, frames);
+      if (committed < 0) {
+        return (int)committed;
+      }
+      if ((snd_pcm_uframes_t)committed != frames) {
+        return -EPIPE;
+      }
+    } else {
+      if (frames > audio_data->buffer_frames) {
+        frames = audio_data->buffer_frames;
+      }
+      snd_pcm_sframes_t got = snd_pcm_readi(pcm, audio_data->capture_scratch, frames);
+      if (got < 0) {
+        return got == -EAGAIN ? 0 : (int)got;
+      }
+      frames = (snd_pcm_uframes_t)got;
+      linux_capture_push(audio_data, audio_data->capture_scratch, frames, timestamp_us);
+    }
+
+    timestamp_us += (uint64_t)frames * ETHERVOX_PLATFORM_US_PER_SEC / audio_data->device_rate;
+    avail -= frames;
+  }
+
+  return 0;
+}
+
+static int linux_capture_recover(linux_audio_data_t* audio_data, int err) {
+  if (err == -EPIPE) {
+    atomic_fetch_add(&audio_data->xruns, 1);
+  }
+  err = snd_pcm_recover(audio_data->pcm_capture, err, 1);
+  if (err < 0) {
+    return err;
+  }
+  // Capture does not restart on its own after prepare
+  return snd_pcm_start(audio_data->pcm_capture);
+}
+
+static void linux_signal_reader(linux_audio_data_t* audio_data) {
+  ssize_t rc = write(audio_data->data_fd, &(uint64_t){1}, sizeof(uint64_t));
+  (void)rc;
+}
+
+static void* linux_capture_thread(void* arg) {
+  linux_audio_data_t* audio_data = (linux_audio_data_t*)arg;
+  snd_pcm_t* pcm = audio_data->pcm_capture;
+
+  struct pollfd fds[kLinuxMaxPollDescriptors + 1];
+  int pcm_fd_count = snd_pcm_poll_descriptors_count(pcm);
+  if (pcm_fd_count <= 0 || pcm_fd_count > kLinuxMaxPollDescriptors) {
+    pcm_fd_count = 0;
+  } else {
+    pcm_fd_count = snd_pcm_poll_descriptors(pcm, fds, (unsigned int)pcm_fd_count);
+  }
+  fds[pcm_fd_count].fd = audio_data->stop_fd;
+  fds[pcm_fd_count].events = POLLIN;
+
+  int err = snd_pcm_start(pcm);
+  uint64_t last_transfer_us = 0;
+
+  while (err >= 0 && atomic_load(&audio_data->capture_running)) {
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm);
+    if (avail < 0) {
+      err = linux_capture_recover(audio_data, (int)avail);
+      last_transfer_us = 0;
+      continue;
+    }
+
+    if ((snd_pcm_uframes_t)avail < audio_data->period_frames) {
+      int rc = poll(fds, (nfds_t)pcm_fd_count + 1, kLinuxCapturePollTimeoutMs);
+      if (rc < 0 && errno != EINTR) {
+        err = -errno;
+      } else if (fds[pcm_fd_count].revents & POLLIN) {
+        break;
+      } else if (rc > 0) {
+        // Plugins (dmix, pulse, pipewire) translate or clear their events here
+        unsigned short revents = 0;
+        snd_pcm_poll_descriptors_revents(pcm, fds, (unsigned int)pcm_fd_count, &revents);
+      } else if (rc == 0 && snd_pcm_state(pcm) != SND_PCM_STATE_RUNNING) {
+        // No period and not running: restart rather than wait forever
+        err = linux_capture_recover(audio_data, -EPIPE);
+      }
+      continue;
+    }
+
+    // The oldest available frame was captured avail frames ago
+    uint64_t now_us = linux_get_timestamp_us();
+    uint64_t first_frame_us = now_us - (uint64_t)avail * ETHERVOX_PLATFORM_US_PER_SEC / audio_data->device_rate;
+
+    if (last_transfer_us != 0) {
+      uint64_t gap = now_us - last_transfer_us;
+      if (gap > atomic_load(&audio_data->max_wakeup_gap_us)) {
+        atomic_store(&audio_data->max_wakeup_gap_us, (uint_fast32_t)gap);
+      }
+    }
+    last_transfer_us = now_us;
+
+    err = linux_capture_transfer(audio_data, (snd_pcm_uframes_t)avail, first_frame_us);
+    if (err < 0) {
+      err = linux_capture_recover(audio_data, err);
+      last_transfer_us = 0;
+    }
+    linux_signal_reader(audio_data);
+  }
+
+  if (err < 0) {
+    atomic_store(&audio_data->capture_failed, true);
+    linux_signal_reader(audio_data);
+  }
+  snd_pcm_drop(pcm);
+  return NULL;
+}
+
+// SCHED_FIFO when permitted (root, CAP_SYS_NICE or an rtprio limit), else normal
+static int linux_start_capture_thread(linux_audio_data_t* audio_data) {
+  audio_data->realtime = false;
+
+  if (ETHERVOX_CAPTURE_RT_PRIORITY > 0) {
+    pthread_attr_t attr;
+    struct sched_param param = {0};
+    int max_priority = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority = ETHERVOX_CAPTURE_RT_PRIORITY < max_priority ? ETHERVOX_CAPTURE_RT_PRIORITY
+                                                                        : max_priority;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+    int rc = pthread_create(&audio_data->capture_thread, &attr, linux_capture_thread, audio_data);
+    pthread_attr_destroy(&attr);
+    if (rc == 0) {
+      audio_data->realtime = true;
+      return 0;
+    }
+    printf("ALSA: real-time capture priority unavailable (%s); add an rtprio limit for this user\n",
+           strerror(rc));
+  }
+
+  return pthread_create(&audio_data->capture_thread, NULL, linux_capture_thread, audio_data);
+}
+
+static void linux_close_capture(linux_audio_data_t* audio_data) {
+  if (audio_data->pcm_capture) {
+    snd_pcm_close(audio_data->pcm_capture);
+    audio_data->pcm_capture = NULL;
+  }
+  if (audio_data->stop_fd >= 0) {
+    close(audio_data->stop_fd);
+    audio_data->stop_fd = -1;
+  }
+  if (audio_data->data_fd >= 0) {
+    close(audio_data->data_fd);
+    audio_data->data_fd = -1;
+  }
+  free(audio_data->capture_scratch);
+  audio_data->capture_scratch = NULL;
+  ethervox_resampler_destroy(audio_data->resampler);
+  audio_data->resampler = NULL;
+  free(audio_data->resample_in);
+  audio_data->resample_in = NULL;
+  free(audio_data->resample_out);
+  audio_data->resample_out = NULL;
+}
+
 static ethervox_result_t linux_audio_start_capture(ethervox_audio_runtime_t* runtime) {
   ETHERVOX_CHECK_PTR(runtime);
   ETHERVOX_CHECK_PTR(runtime->platform_data);
   
   linux_audio_data_t* audio_data = (linux_audio_data_t*)runtime->platform_data;
+  if (audio_data->is_recording) {
+    return ETHERVOX_SUCCESS;
+  }
   int err;
-  snd_pcm_hw_params_t* hw_params = NULL;
 
   const char* env_device = getenv("ETHERVOX_ALSA_DEVICE");
   const char* candidates[kLinuxMaxDeviceCandidates];
@@ -78,7 +448,7 @@ static ethervox_result_t linux_audio_start_capture(ethervox_audio_runtime_t* run
       continue;
     }
 
-    err = snd_pcm_open(&audio_data->pcm_capture, device, SND_PCM_STREAM_CAPTURE, 0);
+    err = snd_pcm_open(&audio_data->pcm_capture, device, SND_PCM_STREAM_CAPTURE, SND_PCM_NONBLOCK);
     if (err >= 0) {
       opened_device = device;
       break;
@@ -94,45 +464,47 @@ static ethervox_result_t linux_audio_start_capture(ethervox_audio_runtime_t* run
 
   printf("ALSA: using capture device '%s'\n", opened_device);
 
-  // Allocate hardware parameters object
-  err = snd_pcm_hw_params_malloc(&hw_params);
-  if (err < 0) {
-    printf("Cannot allocate hardware parameters: %s\n", snd_strerror(err));
-    snd_pcm_close(audio_data->pcm_capture);
-    audio_data->pcm_capture = NULL;
-    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to allocate ALSA hw_params");
+  if (linux_configure_capture(audio_data) < 0) {
+    linux_close_capture(audio_data);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to configure ALSA capture");
   }
 
-  // Configure hardware parameters
-  snd_pcm_hw_params_any(audio_data->pcm_capture, hw_params);
-  snd_pcm_hw_params_set_access(audio_data->pcm_capture, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
-  snd_pcm_hw_params_set_format(audio_data->pcm_capture, hw_params, SND_PCM_FORMAT_S16_LE);
-  snd_pcm_hw_params_set_channels(audio_data->pcm_capture, hw_params, runtime->config.channels);
-
-  unsigned int sample_rate = runtime->config.sample_rate;
-  snd_pcm_hw_params_set_rate_near(audio_data->pcm_capture, hw_params, &sample_rate, 0);
-
-  snd_pcm_hw_params_set_periods(audio_data->pcm_capture, hw_params, kLinuxDefaultPeriods, 0);
-  snd_pcm_hw_params_set_period_size_near(audio_data->pcm_capture, hw_params,
-                                         &audio_data->buffer_frames, 0);
-
-  // Apply hardware parameters
-  err = snd_pcm_hw_params(audio_data->pcm_capture, hw_params);
-  snd_pcm_hw_params_free(hw_params);
-  if (err < 0) {
-    printf("Cannot set hardware parameters: %s\n", snd_strerror(err));
-    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to set ALSA hw_params");
+  audio_data->stop_fd = eventfd(0, EFD_CLOEXEC);
+  audio_data->data_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (!audio_data->mmap_access) {
+    audio_data->capture_scratch =
+        (int16_t*)malloc((size_t)audio_data->buffer_frames * audio_data->channels * sizeof(int16_t));
+  }
+  if (audio_data->stop_fd < 0 || audio_data->data_fd < 0 ||
+      (!audio_data->mmap_access && !audio_data->capture_scratch)) {
+    linux_close_capture(audio_data);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture engine");
   }
 
   // Prepare device
   err = snd_pcm_prepare(audio_data->pcm_capture);
   if (err < 0) {
     printf("Cannot prepare audio interface for use: %s\n", snd_strerror(err));
+    linux_close_capture(audio_data);
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to prepare ALSA capture");
   }
 
+  ethervox_audio_ring_reset(audio_data->capture_ring);
+  atomic_store(&audio_data->frames_captured, 0);
+  atomic_store(&audio_data->xruns, 0);
+  atomic_store(&audio_data->samples_dropped, 0);
+  atomic_store(&audio_data->max_wakeup_gap_us, 0);
+  atomic_store(&audio_data->capture_failed, false);
+  atomic_store(&audio_data->capture_running, true);
+
+  if (linux_start_capture_thread(audio_data) != 0) {
+    atomic_store(&audio_data->capture_running, false);
+    linux_close_capture(audio_data);
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "Failed to start ALSA capture thread");
+  }
+
   audio_data->is_recording = true;
-  printf("Linux audio capture started\n");
+  printf("Linux audio capture started (%s thread)\n", audio_data->realtime ? "SCHED_FIFO" : "normal");
   return ETHERVOX_SUCCESS;
 }
 
@@ -142,10 +514,19 @@ static ethervox_result_t linux_audio_stop_capture(ethervox_audio_runtime_t* runt
   
   linux_audio_data_t* audio_data = (linux_audio_data_t*)runtime->platform_data;
 
-  if (audio_data->pcm_capture) {
-    snd_pcm_close(audio_data->pcm_capture);
-    audio_data->pcm_capture = NULL;
+  if (audio_data->is_recording) {
+    atomic_store(&audio_data->capture_running, false);
+    ssize_t rc = write(audio_data->stop_fd, &(uint64_t){1}, sizeof(uint64_t));
+    (void)rc;
+    pthread_join(audio_data->capture_thread, NULL);
+
+    printf("Linux audio capture: %llu frames, %llu xruns, %llu samples dropped, max wakeup gap %u us\n",
+           (unsigned long long)atomic_load(&audio_data->frames_captured),
+           (unsigned long long)atomic_load(&audio_data->xruns),
+           (unsigned long long)atomic_load(&audio_data->samples_dropped),
+           (unsigned int)atomic_load(&audio_data->max_wakeup_gap_us));
   }
+  linux_close_capture(audio_data);
 
   audio_data->is_recording = false;
   printf("Linux audio capture stopped\n");
@@ -219,13 +600,6 @@ static ethervox_result_t linux_audio_stop_playback(ethervox_audio_runtime_t* run
   return ETHERVOX_SUCCESS;
 }
 
-static uint64_t linux_get_timestamp_us(void) {
-  struct timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  return (uint64_t)ts.tv_sec * ETHERVOX_PLATFORM_US_PER_SEC + (uint64_t)ts.tv_nsec /
-                                                        ETHERVOX_PLATFORM_US_PER_MS;
-}
-
 static ethervox_result_t linux_audio_read(ethervox_audio_runtime_t* runtime, ethervox_audio_buffer_t* buffer) {
   ETHERVOX_CHECK_PTR(runtime);
   ETHERVOX_CHECK_PTR(buffer);
@@ -236,48 +610,81 @@ static ethervox_result_t linux_audio_read(ethervox_audio_runtime_t* runtime, eth
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_INITIALIZED, "Capture not started");
   }
 
-  const uint32_t channels = runtime->config.channels;
-  const uint32_t frames_requested = runtime->config.buffer_size;
-  const size_t samples_total = (size_t)frames_requested * channels;
-  const size_t bytes_total = samples_total * sizeof(int16_t);
-
-  int16_t* capture_buffer = (int16_t*)malloc(bytes_total);
-  if (!capture_buffer) {
-    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture buffer");
+  // Callers without a buffer get one of config.buffer_size frames (freed
+  // with ethervox_audio_buffer_free)
+  if (!buffer->data) {
+    size_t samples = (size_t)runtime->config.buffer_size * audio_data->channels;
+    buffer->data = (float*)malloc(samples * sizeof(float));
+    if (!buffer->data) {
+      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture buffer");
+    }
+    buffer->size = (uint32_t)samples;
   }
 
-  uint32_t frames_read = 0;
-  while (frames_read < frames_requested) {
-    snd_pcm_sframes_t rc =
-        snd_pcm_readi(audio_data->pcm_capture, capture_buffer + (size_t)frames_read * channels,
-                      frames_requested - frames_read);
-
-    if (rc == -EPIPE) {
-      snd_pcm_prepare(audio_data->pcm_capture);
-      continue;
-    } else if (rc == -EAGAIN) {
-      continue;
-    } else if (rc < 0) {
-      printf("ALSA capture error: %s\n", snd_strerror((int)rc));
-      free(capture_buffer);
-      ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "ALSA read failed");
+  // Sleep until the capture thread delivers a period rather than make the
+  // caller spin; whatever has arrived by then is returned
+  uint32_t wanted = (uint32_t)((uint64_t)audio_data->period_frames * audio_data->sample_rate /
+                               audio_data->device_rate) * audio_data->channels;
+  if (wanted > buffer->size) {
+    wanted = buffer->size;
+  }
+  uint64_t deadline_us = linux_get_timestamp_us() + (uint64_t)kLinuxReadTimeoutMs * ETHERVOX_PLATFORM_US_PER_MS;
+  while (ethervox_audio_ring_available(audio_data->capture_ring) < wanted &&
+         !atomic_load(&audio_data->capture_failed)) {
+    uint64_t now_us = linux_get_timestamp_us();
+    if (now_us >= deadline_us) {
+      break;
     }
+    struct pollfd pfd = {.fd = audio_data->data_fd, .events = POLLIN};
+    if (poll(&pfd, 1, (int)((deadline_us - now_us + 999) / ETHERVOX_PLATFORM_US_PER_MS)) > 0) {
+      uint64_t count;
+      ssize_t rc = read(audio_data->data_fd, &count, sizeof(count));
+      (void)rc;
+    }
+  }
 
-    frames_read += (uint32_t)rc;
+  if (atomic_load(&audio_data->capture_failed) &&
+      ethervox_audio_ring_available(audio_data->capture_ring) == 0) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_AUDIO_INIT, "ALSA capture failed");
   }
 
-  buffer->data = (float*)capture_buffer;
-  buffer->size = (size_t)frames_read * channels * sizeof(int16_t);
-  buffer->channels = channels;
-  buffer->timestamp_us = linux_get_timestamp_us();
+  uint64_t timestamp_us = 0;
+  uint32_t available = ethervox_audio_ring_available(audio_data->capture_ring);
+  uint32_t to_read = available < buffer->size ? available : buffer->size;
+  to_read -= to_read % audio_data->channels;
+  buffer->size = ethervox_audio_ring_read(audio_data->capture_ring, buffer->data, to_read, &timestamp_us);
+  buffer->channels = audio_data->channels;
+  buffer->timestamp_us = timestamp_us;
 
   return ETHERVOX_SUCCESS;
 }
 
+static ethervox_result_t linux_audio_get_capture_stats(ethervox_audio_runtime_t* runtime,
+                                                       ethervox_audio_capture_stats_t* stats) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(runtime->platform_data);
+  ETHERVOX_CHECK_PTR(stats);
+
+  linux_audio_data_t* audio_data = (linux_audio_data_t*)runtime->platform_data;
+  stats->frames_captured = atomic_load(&audio_data->frames_captured);
+  stats->xruns = atomic_load(&audio_data->xruns);
+  stats->samples_dropped = atomic_load(&audio_data->samples_dropped);
+  stats->max_wakeup_gap_us = (uint32_t)atomic_load(&audio_data->max_wakeup_gap_us);
+  stats->period_frames = (uint32_t)audio_data->period_frames;
+  stats->buffer_frames = (uint32_t)audio_data->buffer_frames;
+  stats->realtime = audio_data->realtime;
+  stats->mmap = audio_data->mmap_access;
+  return ETHERVOX_SUCCESS;
+}
+
 static void linux_audio_cleanup(ethervox_audio_runtime_t* runtime) {
   linux_audio_data_t* audio_data = (linux_audio_data_t*)runtime->platform_data;
 
   if (audio_data) {
+    if (audio_data->is_recording) {
+      linux_audio_stop_capture(runtime);
+    }
+    ethervox_audio_ring_destroy(audio_data->capture_ring);
     free(audio_data);
     runtime->platform_data = NULL;
   }
@@ -293,9 +700,10 @@ ethervox_result_t ethervox_audio_register_platform_driver(ethervox_audio_runtime
   runtime->driver.start_playback = linux_audio_start_playback;
   runtime->driver.stop_playback = linux_audio_stop_playback;
   runtime->driver.read_audio = linux_audio_read;
+  runtime->driver.get_capture_stats = linux_audio_get_capture_stats;
   runtime->driver.cleanup = linux_audio_cleanup;
 
   return ETHERVOX_SUCCESS;
 }
 
-#endif  // ETHERVOX_PLATFORM_LINUX
\ No newline at end of file
+#endif  // ETHERVOX_PLATFORM_LINUX
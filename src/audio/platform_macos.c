@@ -18,10 +18,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <pthread.h>
 #include <AudioToolbox/AudioToolbox.h>
+#include <CoreAudio/HostTime.h>
 
 #include "ethervox/audio.h"
+#include "ethervox/audio_buffer.h"
+#include "ethervox/dsp.h"
+#include "ethervox/reference_buffer.h"
 #include "ethervox/error.h"
 
 #ifdef ETHERVOX_PLATFORM_MACOS
@@ -38,19 +41,17 @@ typedef struct {
   AudioQueueBufferRef playback_buffers[NUM_BUFFERS];
   bool is_playing;
   
-  // Ring buffer for captured audio
-  int16_t* ring_buffer;
-  size_t ring_buffer_size;
-  size_t write_pos;
-  size_t read_pos;
-  pthread_mutex_t lock;
+  // Captured audio: the input callback produces, macos_audio_read consumes
+  ethervox_audio_ring_t* capture_ring;
   
-  // Ring buffer for playback audio (TTS output)
-  int16_t* playback_ring_buffer;
-  size_t playback_ring_buffer_size;
-  size_t playback_write_pos;
-  size_t playback_read_pos;
-  pthread_mutex_t playback_lock;
+  // Playback audio (TTS output): macos_audio_write produces, the output callback consumes
+  ethervox_audio_ring_t* playback_ring;
+  
+  // Owning runtime, for the echo reference the AEC may attach after init
+  ethervox_audio_runtime_t* runtime;
+  
+  // Output callback scratch: the played block as float, for the echo reference
+  float reference_block[BUFFER_SIZE / sizeof(int16_t)];
   
   uint32_t sample_rate;
   uint8_t channels;
@@ -63,7 +64,6 @@ static void input_callback(void* user_data, AudioQueueRef queue,
                           UInt32 num_packets,
                           const AudioStreamPacketDescription* packet_desc) {
   (void)queue;
-  (void)start_time;
   (void)packet_desc;
   (void)num_packets;
   
@@ -72,23 +72,25 @@ static void input_callback(void* user_data, AudioQueueRef queue,
     return;
   }
   
-  // Copy audio data to ring buffer
-  int16_t* samples = (int16_t*)buffer->mAudioData;
-  size_t sample_count = buffer->mAudioDataByteSize / sizeof(int16_t);
-  
-  pthread_mutex_lock(&state->lock);
+  // Convert straight into the capture ring (no lock on the audio thread;
+  // if the reader has fallen 10 s behind, the newest samples are dropped)
+  const int16_t* samples = (const int16_t*)buffer->mAudioData;
+  uint32_t sample_count = buffer->mAudioDataByteSize / sizeof(int16_t);
   
-  for (size_t i = 0; i < sample_count; i++) {
-    state->ring_buffer[state->write_pos] = samples[i];
-    state->write_pos = (state->write_pos + 1) % state->ring_buffer_size;
-    
-    // Overwrite old data if buffer full
-    if (state->write_pos == state->read_pos) {
-      state->read_pos = (state->read_pos + 1) % state->ring_buffer_size;
-    }
+  ethervox_audio_span_t span;
+  uint32_t space = ethervox_audio_ring_begin_write(state->capture_ring, &span);
+  uint32_t count = sample_count < space ? sample_count : space;
+  uint32_t first = count < span.size[0] ? count : span.size[0];
+  ethervox_dsp_s16_to_float(samples, span.data[0], first);
+  if (count > first) {
+    ethervox_dsp_s16_to_float(samples + first, span.data[1], count - first);
   }
   
-  pthread_mutex_unlock(&state->lock);
+  uint64_t timestamp_us = 0;
+  if (start_time && (start_time->mFlags & kAudioTimeStampHostTimeValid)) {
+    timestamp_us = AudioConvertHostTimeToNanos(start_time->mHostTime) / 1000;
+  }
+  ethervox_audio_ring_end_write(state->capture_ring, count, timestamp_us);
   
   // Re-enqueue buffer for more recording
   AudioQueueEnqueueBuffer(queue, buffer, 0, NULL);
@@ -104,28 +106,25 @@ static ethervox_result_t macos_audio_init(ethervox_audio_runtime_t* runtime,
   state->sample_rate = config->sample_rate ? config->sample_rate : 16000;
   state->channels = config->channels ? config->channels : 1;
   
-  // Allocate capture ring buffer (10 seconds of audio)
-  state->ring_buffer_size = state->sample_rate * 10;
-  state->ring_buffer = (int16_t*)calloc(state->ring_buffer_size, sizeof(int16_t));
-  if (!state->ring_buffer) {
+  // Capture ring (10 seconds of audio)
+  state->capture_ring = ethervox_audio_ring_create(state->sample_rate * state->channels * 10, state->sample_rate);
+  if (!state->capture_ring) {
     free(state);
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate capture ring buffer");
   }
   
-  // Allocate playback ring buffer (60 seconds of audio for long TTS responses)
-  // This is ~1.9MB at 16kHz mono which is acceptable for desktop
-  state->playback_ring_buffer_size = state->sample_rate * 60;
-  state->playback_ring_buffer = (int16_t*)calloc(state->playback_ring_buffer_size, sizeof(int16_t));
-  if (!state->playback_ring_buffer) {
-    free(state->ring_buffer);
+  // Playback ring (60 seconds of audio for long TTS responses)
+  // This is ~4MB at 16kHz mono which is acceptable for desktop
+  state->playback_ring = ethervox_audio_ring_create(state->sample_rate * state->channels * 60, state->sample_rate);
+  if (!state->playback_ring) {
+    ethervox_audio_ring_destroy(state->capture_ring);
     free(state);
     ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_OUT_OF_MEMORY, "Failed to allocate playback ring buffer");
   }
-  
-  pthread_mutex_init(&state->lock, NULL);
-  pthread_mutex_init(&state->playback_lock, NULL);
 
+  state->runtime = runtime;
   runtime->platform_data = state;
+  runtime->playback_ring = state->playback_ring;
   // Debug message removed - too verbose for normal startup
   return ETHERVOX_SUCCESS;
 }
@@ -219,24 +218,36 @@ static void output_callback(void* user_data, AudioQueueRef queue,
   }
   
   int16_t* output = (int16_t*)buffer->mAudioData;
-  size_t max_samples = buffer->mAudioDataBytesCapacity / sizeof(int16_t);
-  size_t samples_written = 0;
-  
-  pthread_mutex_lock(&state->playback_lock);
+  uint32_t max_samples = buffer->mAudioDataBytesCapacity / sizeof(int16_t);
   
-  // Read available samples from playback ring buffer
-  while (samples_written < max_samples && state->playback_read_pos != state->playback_write_pos) {
-    output[samples_written++] = state->playback_ring_buffer[state->playback_read_pos];
-    state->playback_read_pos = (state->playback_read_pos + 1) % state->playback_ring_buffer_size;
+  // Drain the playback ring in place (no lock on the audio thread)
+  ethervox_audio_span_t span;
+  uint32_t available = ethervox_audio_ring_begin_read(state->playback_ring, &span);
+  uint32_t samples_written = available < max_samples ? available : max_samples;
+  uint32_t first = samples_written < span.size[0] ? samples_written : span.size[0];
+  ethervox_dsp_float_to_s16(span.data[0], output, first);
+  if (samples_written > first) {
+    ethervox_dsp_float_to_s16(span.data[1], output + first, samples_written - first);
   }
-  
-  pthread_mutex_unlock(&state->playback_lock);
+  ethervox_audio_ring_end_read(state->playback_ring, samples_written);
   
   // Fill remaining with silence
-  for (size_t i = samples_written; i < max_samples; i++) {
+  for (uint32_t i = samples_written; i < max_samples; i++) {
     output[i] = 0;
   }
   
+  // Give the echo canceller exactly what will be played (silence included,
+  // so its timeline has no gaps). This buffer is queued behind the others,
+  // so it reaches the speaker about NUM_BUFFERS - 1 buffers from now; the
+  // AEC's delay estimator absorbs the remaining device latency.
+  ethervox_reference_buffer_t* echo_reference = state->runtime->echo_reference;
+  if (echo_reference && state->channels == 1) {
+    ethervox_dsp_s16_to_float(output, state->reference_block, max_samples);
+    uint64_t play_time_us = AudioConvertHostTimeToNanos(AudioGetCurrentHostTime()) / 1000 +
+                            (uint64_t)(NUM_BUFFERS - 1) * max_samples * 1000000 / state->sample_rate;
+    ethervox_reference_buffer_write_at(echo_reference, state->reference_block, max_samples, play_time_us);
+  }
+  
   buffer->mAudioDataByteSize = max_samples * sizeof(int16_t);
   AudioQueueEnqueueBuffer(queue, buffer, 0, NULL);
 }
@@ -332,46 +343,23 @@ static ethervox_result_t macos_audio_write(ethervox_audio_runtime_t* runtime,
   }
   
   // Buffer data is int16_t samples (already converted from float32 in caller)
-  int16_t* samples = (int16_t*)buffer->data;
-  size_t sample_count = buffer->size / sizeof(int16_t);
-  size_t samples_written = 0;
-  size_t samples_dropped = 0;
-  
-  pthread_mutex_lock(&state->playback_lock);
-  
-  // Check available space in ring buffer
-  size_t write_pos = state->playback_write_pos;
-  size_t read_pos = state->playback_read_pos;
-  size_t available;
-  if (write_pos >= read_pos) {
-    available = state->playback_ring_buffer_size - (write_pos - read_pos) - 1;
-  } else {
-    available = read_pos - write_pos - 1;
-  }
+  const int16_t* samples = (const int16_t*)buffer->data;
+  uint32_t sample_count = buffer->size / sizeof(int16_t);
   
-  if (sample_count > available) {
-    // Not enough space - will need to drop old samples
-    samples_dropped = sample_count - available;
-    fprintf(stderr, "[Audio] Warning: Playback buffer near full, dropping %zu old samples\n", samples_dropped);
+  ethervox_audio_span_t span;
+  uint32_t space = ethervox_audio_ring_begin_write(state->playback_ring, &span);
+  uint32_t count = sample_count < space ? sample_count : space;
+  uint32_t first = count < span.size[0] ? count : span.size[0];
+  ethervox_dsp_s16_to_float(samples, span.data[0], first);
+  if (count > first) {
+    ethervox_dsp_s16_to_float(samples + first, span.data[1], count - first);
   }
+  ethervox_audio_ring_end_write(state->playback_ring, count, 0);
   
-  // Write samples to playback ring buffer
-  for (size_t i = 0; i < sample_count; i++) {
-    size_t next_write = (state->playback_write_pos + 1) % state->playback_ring_buffer_size;
-    
-    // Check if buffer is full
-    if (next_write == state->playback_read_pos) {
-      // Buffer full - drop oldest sample to make room
-      state->playback_read_pos = (state->playback_read_pos + 1) % state->playback_ring_buffer_size;
-    }
-    
-    state->playback_ring_buffer[state->playback_write_pos] = samples[i];
-    state->playback_write_pos = next_write;
-    samples_written++;
+  if (count < sample_count) {
+    fprintf(stderr, "[Audio] Warning: Playback buffer full, dropping %u samples\n", sample_count - count);
   }
   
-  pthread_mutex_unlock(&state->playback_lock);
-  
   return ETHERVOX_SUCCESS;
 }
 
@@ -380,34 +368,18 @@ static ethervox_result_t macos_audio_read(ethervox_audio_runtime_t* runtime, eth
   ETHERVOX_CHECK_PTR(state);
   ETHERVOX_CHECK_PTR(buffer);
   
-  pthread_mutex_lock(&state->lock);
-  
-  // Calculate available samples
-  size_t available;
-  if (state->write_pos >= state->read_pos) {
-    available = state->write_pos - state->read_pos;
-  } else {
-    available = state->ring_buffer_size - state->read_pos + state->write_pos;
-  }
-  
+  uint32_t available = ethervox_audio_ring_available(state->capture_ring);
   if (available == 0) {
-    pthread_mutex_unlock(&state->lock);
     buffer->size = 0;
     return ETHERVOX_SUCCESS; // No data available (not an error)
   }
   
-  // Read up to buffer capacity
-  size_t to_read = (available < buffer->size) ? available : buffer->size;
-  
-  for (size_t i = 0; i < to_read; i++) {
-    // Convert int16 to float32 normalized to [-1.0, 1.0]
-    buffer->data[i] = (float)state->ring_buffer[state->read_pos] / 32768.0f;
-    state->read_pos = (state->read_pos + 1) % state->ring_buffer_size;
-  }
-  
-  buffer->size = to_read;
-  
-  pthread_mutex_unlock(&state->lock);
+  // Read up to buffer capacity (samples are already float32 in [-1.0, 1.0])
+  uint32_t to_read = (available < buffer->size) ? available : buffer->size;
+  uint64_t timestamp_us = 0;
+  buffer->size = ethervox_audio_ring_read(state->capture_ring, buffer->data, to_read, &timestamp_us);
+  buffer->channels = state->channels;
+  buffer->timestamp_us = timestamp_us;
   
   return ETHERVOX_SUCCESS;
 }
@@ -431,10 +403,11 @@ static void macos_audio_cleanup(ethervox_audio_runtime_t* runtime) {
     AudioQueueDispose(state->playback_queue, true);
   }
   
-  pthread_mutex_destroy(&state->lock);
-  free(state->ring_buffer);
+  ethervox_audio_ring_destroy(state->capture_ring);
+  ethervox_audio_ring_destroy(state->playback_ring);
   free(state);
   runtime->platform_data = NULL;
+  runtime->playback_ring = NULL;
   printf("macOS CoreAudio driver cleaned up\n");
 }
 
@@ -1,201 +1,206 @@
 /**
  * @file reference_buffer.c
- * @brief Thread-safe circular buffer for TTS reference signal
+ * @brief Lock-free, timestamp-aligned buffer for the AEC far-end reference
+ *
+ * A thin layer over the SPSC audio ring: the ring already keeps free-running
+ * stream positions and maps them to timestamps, so aligning the reference to
+ * a capture time is a matter of skipping or padding to the matching position.
  */
 
 #include "ethervox/reference_buffer.h"
+#include "ethervox/audio_buffer.h"
+#include "ethervox/config.h"
 #include "ethervox/logging.h"
 
 #include <stdlib.h>
 #include <string.h>
-#include <pthread.h>
+
+// Alignment errors below this are left alone: callback timestamps jitter by a
+// few milliseconds, and re-aligning on every read would make the reference
+// slip back and forth under the echo canceller. The delay estimator takes up
+// the constant part of the error.
+#define REFERENCE_SLIP_TOLERANCE_US 4000
+
+// Timestamps further apart than this come from different clocks (or a
+// driver that does not stamp); fall back to FIFO order.
+#define REFERENCE_MAX_SKEW_US 5000000
 
 struct ethervox_reference_buffer_s {
-    float* data;           // Circular buffer storage
-    size_t capacity;       // Total buffer size in samples
-    size_t write_pos;      // Write position (head)
-    size_t read_pos;       // Read position (tail)
-    size_t count;          // Number of samples currently in buffer
-    pthread_mutex_t lock;  // Thread safety
+    ethervox_audio_ring_t* ring;  // Samples plus playback timestamps
+    uint32_t capacity;            // Requested capacity (the ring rounds up to a power of two)
+    uint32_t slack;               // Ring slots beyond the requested capacity
+    uint32_t sample_rate;
 };
 
-ethervox_reference_buffer_t* ethervox_reference_buffer_create(size_t capacity) {
-    if (capacity == 0) {
-        ETHERVOX_LOG_ERROR("Invalid buffer capacity: %zu", capacity);
+ethervox_reference_buffer_t* ethervox_reference_buffer_create_timed(size_t capacity, uint32_t sample_rate) {
+    if (capacity == 0 || capacity > (1u << 30) || sample_rate == 0) {
+        ETHERVOX_LOG_ERROR("Invalid reference buffer: capacity=%zu, rate=%u", capacity, sample_rate);
         return NULL;
     }
-    
+
     ethervox_reference_buffer_t* buffer = (ethervox_reference_buffer_t*)calloc(1, sizeof(*buffer));
     if (!buffer) {
         ETHERVOX_LOG_ERROR("Failed to allocate reference buffer structure");
         return NULL;
     }
-    
-    buffer->data = (float*)calloc(capacity, sizeof(float));
-    if (!buffer->data) {
+
+    buffer->ring = ethervox_audio_ring_create((uint32_t)capacity, sample_rate);
+    if (!buffer->ring) {
         ETHERVOX_LOG_ERROR("Failed to allocate reference buffer data: %zu samples", capacity);
         free(buffer);
         return NULL;
     }
-    
-    buffer->capacity = capacity;
-    buffer->write_pos = 0;
-    buffer->read_pos = 0;
-    buffer->count = 0;
-    
-    if (pthread_mutex_init(&buffer->lock, NULL) != 0) {
-        ETHERVOX_LOG_ERROR("Failed to initialize buffer mutex");
-        free(buffer->data);
-        free(buffer);
-        return NULL;
-    }
-    
-    ETHERVOX_LOG_DEBUG("Created reference buffer: capacity=%zu samples (%.1f seconds @ 16kHz)", 
-                       capacity, (float)capacity / 16000.0f);
-    
+
+    buffer->capacity = (uint32_t)capacity;
+    buffer->slack = ethervox_audio_ring_capacity(buffer->ring) - buffer->capacity;
+    buffer->sample_rate = sample_rate;
+
+    ETHERVOX_LOG_DEBUG("Created reference buffer: capacity=%zu samples (%.1f seconds @ %u Hz)",
+                       capacity, (float)capacity / (float)sample_rate, sample_rate);
+
     return buffer;
 }
 
-size_t ethervox_reference_buffer_write(ethervox_reference_buffer_t* buffer, 
-                                       const float* samples, 
+ethervox_reference_buffer_t* ethervox_reference_buffer_create(size_t capacity) {
+    return ethervox_reference_buffer_create_timed(capacity, ETHERVOX_AUDIO_SAMPLE_RATE);
+}
+
+// Free space within the requested capacity
+static uint32_t writable(const ethervox_reference_buffer_t* buffer) {
+    uint32_t space = ethervox_audio_ring_write_space(buffer->ring);
+    return space > buffer->slack ? space - buffer->slack : 0;
+}
+
+size_t ethervox_reference_buffer_write(ethervox_reference_buffer_t* buffer,
+                                       const float* samples,
                                        size_t count) {
     if (!buffer || !samples || count == 0) {
         return 0;
     }
-    
-    pthread_mutex_lock(&buffer->lock);
-    
-    // Calculate how many samples we can actually write
-    size_t available_space = buffer->capacity - buffer->count;
-    size_t to_write = (count < available_space) ? count : available_space;
-    
-    if (to_write == 0) {
-        // Buffer full - could either drop samples or overwrite old data
-        // For AEC, dropping is safer than desync
-        pthread_mutex_unlock(&buffer->lock);
-        ETHERVOX_LOG_WARN("Reference buffer full, dropping %zu samples", count);
-        return 0;
+
+    // For FIFO use, dropping the tail is safer than desync
+    uint32_t space = writable(buffer);
+    uint32_t to_write = count < space ? (uint32_t)count : space;
+    if (to_write > 0) {
+        ethervox_audio_ring_write(buffer->ring, samples, to_write, 0);
     }
-    
-    // Write samples in two parts if wrapping around
-    size_t first_part = buffer->capacity - buffer->write_pos;
-    if (first_part > to_write) {
-        first_part = to_write;
-    }
-    
-    memcpy(&buffer->data[buffer->write_pos], samples, first_part * sizeof(float));
-    
-    if (to_write > first_part) {
-        // Wrapped around - write remainder at beginning
-        size_t second_part = to_write - first_part;
-        memcpy(buffer->data, &samples[first_part], second_part * sizeof(float));
-    }
-    
-    buffer->write_pos = (buffer->write_pos + to_write) % buffer->capacity;
-    buffer->count += to_write;
-    
-    pthread_mutex_unlock(&buffer->lock);
-    
+
     if (to_write < count) {
-        ETHERVOX_LOG_WARN("Reference buffer partial write: %zu/%zu samples", to_write, count);
+        ETHERVOX_LOG_WARN("Reference buffer full, dropped %zu/%zu samples", count - to_write, count);
     }
-    
+
     return to_write;
 }
 
+size_t ethervox_reference_buffer_write_at(ethervox_reference_buffer_t* buffer,
+                                          const float* samples,
+                                          size_t count,
+                                          uint64_t play_time_us) {
+    if (!buffer || !samples || count == 0) {
+        return 0;
+    }
+
+    // Runs on the playback callback: no logging, and no partial writes. A full
+    // buffer means the reader stopped; have it drop the backlog when it returns.
+    if (count > writable(buffer)) {
+        ethervox_audio_ring_request_flush(buffer->ring);
+        return 0;
+    }
+
+    return ethervox_audio_ring_write(buffer->ring, samples, (uint32_t)count, play_time_us);
+}
+
 size_t ethervox_reference_buffer_read(ethervox_reference_buffer_t* buffer,
                                       float* samples,
                                       size_t count) {
     if (!buffer || !samples || count == 0) {
         return 0;
     }
-    
-    pthread_mutex_lock(&buffer->lock);
-    
-    // Calculate how many samples are available
-    size_t to_read = (count < buffer->count) ? count : buffer->count;
-    
-    if (to_read == 0) {
-        // Buffer empty - return silence
-        pthread_mutex_unlock(&buffer->lock);
+
+    // The ring zero-fills whatever is missing
+    return ethervox_audio_ring_read(buffer->ring, samples, (uint32_t)count, NULL);
+}
+
+size_t ethervox_reference_buffer_read_at(ethervox_reference_buffer_t* buffer,
+                                         float* samples,
+                                         size_t count,
+                                         uint64_t capture_time_us) {
+    if (!buffer || !samples || count == 0) {
+        return 0;
+    }
+
+    ethervox_audio_span_t span;
+    uint32_t queued = ethervox_audio_ring_begin_read(buffer->ring, &span);
+    if (queued == 0) {
         memset(samples, 0, count * sizeof(float));
         return 0;
     }
-    
-    // Read samples in two parts if wrapping around
-    size_t first_part = buffer->capacity - buffer->read_pos;
-    if (first_part > to_read) {
-        first_part = to_read;
-    }
-    
-    memcpy(samples, &buffer->data[buffer->read_pos], first_part * sizeof(float));
-    
-    if (to_read > first_part) {
-        // Wrapped around - read remainder from beginning
-        size_t second_part = to_read - first_part;
-        memcpy(&samples[first_part], buffer->data, second_part * sizeof(float));
-    }
-    
-    buffer->read_pos = (buffer->read_pos + to_read) % buffer->capacity;
-    buffer->count -= to_read;
-    
-    pthread_mutex_unlock(&buffer->lock);
-    
-    // Fill remainder with silence if we didn't read enough
-    if (to_read < count) {
-        memset(&samples[to_read], 0, (count - to_read) * sizeof(float));
-    }
-    
-    return to_read;
+
+    int64_t delta_us = (int64_t)(capture_time_us - span.timestamp_us);
+    if (capture_time_us == 0 || span.timestamp_us == 0 ||
+        delta_us > REFERENCE_MAX_SKEW_US || delta_us < -REFERENCE_MAX_SKEW_US) {
+        return ethervox_reference_buffer_read(buffer, samples, count);
+    }
+
+    size_t lead = 0;
+    if (delta_us >= REFERENCE_SLIP_TOLERANCE_US) {
+        // Queued samples already played before this capture: skip them
+        uint64_t late = ((uint64_t)delta_us * buffer->sample_rate + 500000) / 1000000;
+        uint32_t skip = late < queued ? (uint32_t)late : queued;
+        ethervox_audio_ring_end_read(buffer->ring, skip);
+        if (skip == queued) {
+            memset(samples, 0, count * sizeof(float));
+            return 0;
+        }
+    } else if (delta_us <= -REFERENCE_SLIP_TOLERANCE_US) {
+        // Playback starts partway through this capture block: lead with silence
+        uint64_t early = ((uint64_t)(-delta_us) * buffer->sample_rate + 500000) / 1000000;
+        lead = early < count ? (size_t)early : count;
+        memset(samples, 0, lead * sizeof(float));
+        if (lead == count) {
+            return 0;
+        }
+    }
+
+    return ethervox_audio_ring_read(buffer->ring, samples + lead, (uint32_t)(count - lead), NULL);
 }
 
 size_t ethervox_reference_buffer_available(const ethervox_reference_buffer_t* buffer) {
     if (!buffer) {
         return 0;
     }
-    
-    // No lock needed - single atomic read
-    return buffer->count;
+
+    return ethervox_audio_ring_available(buffer->ring);
 }
 
 size_t ethervox_reference_buffer_space(const ethervox_reference_buffer_t* buffer) {
     if (!buffer) {
         return 0;
     }
-    
-    // No lock needed - single atomic read
-    return buffer->capacity - buffer->count;
+
+    return writable(buffer);
 }
 
 void ethervox_reference_buffer_clear(ethervox_reference_buffer_t* buffer) {
     if (!buffer) {
         return;
     }
-    
-    pthread_mutex_lock(&buffer->lock);
-    
-    buffer->write_pos = 0;
-    buffer->read_pos = 0;
-    buffer->count = 0;
-    memset(buffer->data, 0, buffer->capacity * sizeof(float));
-    
-    pthread_mutex_unlock(&buffer->lock);
-    
+
+    ethervox_audio_ring_request_flush(buffer->ring);
     ETHERVOX_LOG_DEBUG("Reference buffer cleared");
 }
 
 bool ethervox_reference_buffer_is_empty(const ethervox_reference_buffer_t* buffer) {
-    return buffer ? (buffer->count == 0) : true;
+    return buffer ? (ethervox_audio_ring_available(buffer->ring) == 0) : true;
 }
 
 void ethervox_reference_buffer_destroy(ethervox_reference_buffer_t* buffer) {
     if (!buffer) {
         return;
     }
-    
-    pthread_mutex_destroy(&buffer->lock);
-    free(buffer->data);
+
+    ethervox_audio_ring_destroy(buffer->ring);
     free(buffer);
-    
+
     ETHERVOX_LOG_DEBUG("Reference buffer destroyed");
 }
@@ -0,0 +1,340 @@
+/**
+ * @file audio_buffer.c
+ * @brief Wait-free single-producer/single-consumer audio ring buffer
+ *
+ * The producer owns write_index, the consumer owns read_index; each
+ * publishes its index with a release store and reads the other's with an
+ * acquire load, so samples are visible before the index that covers them.
+ * Indices never wrap (64-bit), and masking with capacity - 1 gives the slot.
+ *
+ * The latest timestamp anchor (stream position, capture time) is guarded by
+ * a sequence counter: the producer never waits, and a reader that catches a
+ * write in progress simply loads the pair again.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/audio_buffer.h"
+#include "ethervox/logging.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <malloc.h>
+#endif
+
+#if !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_uint_least64_t ring_atomic_t;
+#define RING_LOAD(p) atomic_load_explicit((p), memory_order_relaxed)
+#define RING_LOAD_ACQUIRE(p) atomic_load_explicit((p), memory_order_acquire)
+#define RING_STORE(p, v) atomic_store_explicit((p), (v), memory_order_relaxed)
+#define RING_STORE_RELEASE(p, v) atomic_store_explicit((p), (v), memory_order_release)
+#define RING_FENCE_ACQUIRE() atomic_thread_fence(memory_order_acquire)
+#define RING_FENCE_RELEASE() atomic_thread_fence(memory_order_release)
+#elif defined(_MSC_VER)
+// MSVC without C11 atomics: x86/x64 loads and stores of aligned 64-bit
+// volatiles are atomic and ordered (/volatile:ms), so a compiler barrier is enough
+#include <intrin.h>
+typedef volatile uint64_t ring_atomic_t;
+#define RING_LOAD(p) (*(p))
+#define RING_LOAD_ACQUIRE(p) (*(p))
+#define RING_STORE(p, v) (*(p) = (v))
+#define RING_STORE_RELEASE(p, v) (_ReadWriteBarrier(), *(p) = (v))
+#define RING_FENCE_ACQUIRE() _ReadWriteBarrier()
+#define RING_FENCE_RELEASE() _ReadWriteBarrier()
+#else
+#error "audio_buffer.c needs C11 atomics"
+#endif
+
+#define RING_CACHE_LINE 64
+#define RING_MIN_CAPACITY 16u
+#define RING_MAX_CAPACITY (1u << 30)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RING_ALIGNED __declspec(align(RING_CACHE_LINE))
+#else
+#define RING_ALIGNED _Alignas(RING_CACHE_LINE)
+#endif
+
+struct ethervox_audio_ring {
+  // Fixed at creation
+  float* data;
+  uint32_t capacity;
+  uint32_t mask;
+  uint32_t sample_rate;
+
+  // Producer cache line
+  RING_ALIGNED ring_atomic_t write_index;
+  ring_atomic_t overruns;
+  ring_atomic_t dropped;
+  ring_atomic_t high_water;
+  ring_atomic_t anchor_seq;  // Odd while the anchor is being updated
+  ring_atomic_t anchor_position;
+  ring_atomic_t anchor_timestamp;
+
+  // Consumer cache line
+  RING_ALIGNED ring_atomic_t read_index;
+  ring_atomic_t underruns;
+  ring_atomic_t flushed;
+
+  // Written by whoever requests a flush, applied by the consumer
+  RING_ALIGNED ring_atomic_t flush_to;
+};
+
+static void* ring_aligned_alloc(size_t size) {
+  size = (size + RING_CACHE_LINE - 1) & ~(size_t)(RING_CACHE_LINE - 1);
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _aligned_malloc(size, RING_CACHE_LINE);
+#elif defined(_WIN32)
+  return __mingw_aligned_malloc(size, RING_CACHE_LINE);
+#else
+  void* ptr = NULL;
+  return posix_memalign(&ptr, RING_CACHE_LINE, size) == 0 ? ptr : NULL;
+#endif
+}
+
+static void ring_aligned_free(void* ptr) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  _aligned_free(ptr);
+#elif defined(_WIN32)
+  __mingw_aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+static void fill_span(const ethervox_audio_ring_t* ring, uint64_t start, uint32_t count,
+                      ethervox_audio_span_t* span) {
+  uint32_t offset = (uint32_t)(start & ring->mask);
+  uint32_t first = ring->capacity - offset;
+  if (first > count) first = count;
+  span->data[0] = ring->data + offset;
+  span->size[0] = first;
+  span->data[1] = count > first ? ring->data : NULL;
+  span->size[1] = count - first;
+  span->position = start;
+  span->timestamp_us = 0;
+}
+
+/**
+ * Consumer: apply a pending flush and return the read index
+ */
+static uint64_t consumer_index(ethervox_audio_ring_t* ring) {
+  uint64_t read = RING_LOAD(&ring->read_index);
+  uint64_t flush = RING_LOAD_ACQUIRE(&ring->flush_to);
+  if (flush > read) {
+    RING_STORE(&ring->flushed, RING_LOAD(&ring->flushed) + (flush - read));
+    RING_STORE_RELEASE(&ring->read_index, flush);
+    read = flush;
+  }
+  return read;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+ethervox_audio_ring_t* ethervox_audio_ring_create(uint32_t min_capacity, uint32_t sample_rate) {
+  if (min_capacity == 0 || min_capacity > RING_MAX_CAPACITY) {
+    ETHERVOX_LOG_ERROR("Invalid audio ring capacity: %u", min_capacity);
+    return NULL;
+  }
+
+  uint32_t capacity = RING_MIN_CAPACITY;
+  while (capacity < min_capacity) capacity <<= 1;
+
+  ethervox_audio_ring_t* ring = (ethervox_audio_ring_t*)ring_aligned_alloc(sizeof(*ring));
+  if (!ring) return NULL;
+  memset(ring, 0, sizeof(*ring));
+  ring->data = (float*)ring_aligned_alloc((size_t)capacity * sizeof(float));
+  if (!ring->data) {
+    ring_aligned_free(ring);
+    return NULL;
+  }
+  ring->capacity = capacity;
+  ring->mask = capacity - 1;
+  ring->sample_rate = sample_rate;
+  ethervox_audio_ring_reset(ring);
+  return ring;
+}
+
+void ethervox_audio_ring_destroy(ethervox_audio_ring_t* ring) {
+  if (!ring) return;
+  ring_aligned_free(ring->data);
+  ring_aligned_free(ring);
+}
+
+void ethervox_audio_ring_reset(ethervox_audio_ring_t* ring) {
+  if (!ring) return;
+  memset(ring->data, 0, (size_t)ring->capacity * sizeof(float));
+  RING_STORE(&ring->write_index, 0);
+  RING_STORE(&ring->overruns, 0);
+  RING_STORE(&ring->dropped, 0);
+  RING_STORE(&ring->high_water, 0);
+  RING_STORE(&ring->anchor_seq, 0);
+  RING_STORE(&ring->anchor_position, 0);
+  RING_STORE(&ring->anchor_timestamp, 0);
+  RING_STORE(&ring->read_index, 0);
+  RING_STORE(&ring->underruns, 0);
+  RING_STORE(&ring->flushed, 0);
+  RING_STORE_RELEASE(&ring->flush_to, 0);
+}
+
+uint32_t ethervox_audio_ring_capacity(const ethervox_audio_ring_t* ring) {
+  return ring ? ring->capacity : 0;
+}
+
+// ============================================================================
+// Producer
+// ============================================================================
+
+uint32_t ethervox_audio_ring_write_space(const ethervox_audio_ring_t* ring) {
+  if (!ring) return 0;
+  uint64_t write = RING_LOAD(&ring->write_index);
+  uint64_t read = RING_LOAD_ACQUIRE(&ring->read_index);
+  return ring->capacity - (uint32_t)(write - read);
+}
+
+uint32_t ethervox_audio_ring_begin_write(ethervox_audio_ring_t* ring, ethervox_audio_span_t* span) {
+  if (!ring || !span) return 0;
+  uint32_t space = ethervox_audio_ring_write_space(ring);
+  fill_span(ring, RING_LOAD(&ring->write_index), space, span);
+  return space;
+}
+
+void ethervox_audio_ring_end_write(ethervox_audio_ring_t* ring, uint32_t count, uint64_t timestamp_us) {
+  if (!ring) return;
+  uint32_t space = ethervox_audio_ring_write_space(ring);
+  if (count > space) count = space;
+  uint64_t write = RING_LOAD(&ring->write_index);
+
+  if (timestamp_us != 0) {
+    uint64_t seq = RING_LOAD(&ring->anchor_seq);
+    RING_STORE(&ring->anchor_seq, seq + 1);
+    RING_FENCE_RELEASE();
+    RING_STORE(&ring->anchor_position, write);
+    RING_STORE(&ring->anchor_timestamp, timestamp_us);
+    RING_STORE_RELEASE(&ring->anchor_seq, seq + 2);
+  }
+
+  uint32_t fill = ring->capacity - space + count;
+  if (fill > RING_LOAD(&ring->high_water)) RING_STORE(&ring->high_water, fill);
+  RING_STORE_RELEASE(&ring->write_index, write + count);
+}
+
+uint32_t ethervox_audio_ring_write(ethervox_audio_ring_t* ring, const float* samples, uint32_t count,
+                                   uint64_t timestamp_us) {
+  if (!ring || !samples || count == 0) return 0;
+
+  ethervox_audio_span_t span;
+  uint32_t space = ethervox_audio_ring_begin_write(ring, &span);
+  uint32_t n = count < space ? count : space;
+  uint32_t first = n < span.size[0] ? n : span.size[0];
+  memcpy(span.data[0], samples, first * sizeof(float));
+  if (n > first) memcpy(span.data[1], samples + first, (n - first) * sizeof(float));
+
+  if (n < count) {
+    RING_STORE(&ring->overruns, RING_LOAD(&ring->overruns) + 1);
+    RING_STORE(&ring->dropped, RING_LOAD(&ring->dropped) + (count - n));
+  }
+  ethervox_audio_ring_end_write(ring, n, timestamp_us);
+  return n;
+}
+
+// ============================================================================
+// Consumer
+// ============================================================================
+
+uint32_t ethervox_audio_ring_available(const ethervox_audio_ring_t* ring) {
+  if (!ring) return 0;
+  uint64_t read = RING_LOAD(&ring->read_index);
+  uint64_t flush = RING_LOAD_ACQUIRE(&ring->flush_to);
+  uint64_t write = RING_LOAD_ACQUIRE(&ring->write_index);
+  if (flush > read) read = flush;
+  return write > read ? (uint32_t)(write - read) : 0;
+}
+
+uint32_t ethervox_audio_ring_begin_read(ethervox_audio_ring_t* ring, ethervox_audio_span_t* span) {
+  if (!ring || !span) return 0;
+  uint64_t read = consumer_index(ring);
+  uint32_t available = (uint32_t)(RING_LOAD_ACQUIRE(&ring->write_index) - read);
+  fill_span(ring, read, available, span);
+  span->timestamp_us = ethervox_audio_ring_timestamp_at(ring, read);
+  return available;
+}
+
+void ethervox_audio_ring_end_read(ethervox_audio_ring_t* ring, uint32_t count) {
+  if (!ring) return;
+  uint64_t read = RING_LOAD(&ring->read_index);
+  uint32_t available = (uint32_t)(RING_LOAD_ACQUIRE(&ring->write_index) - read);
+  if (count > available) count = available;
+  RING_STORE_RELEASE(&ring->read_index, read + count);
+}
+
+uint32_t ethervox_audio_ring_read(ethervox_audio_ring_t* ring, float* out, uint32_t count,
+                                  uint64_t* timestamp_us) {
+  if (timestamp_us) *timestamp_us = 0;
+  if (!ring || !out || count == 0) return 0;
+
+  ethervox_audio_span_t span;
+  uint32_t available = ethervox_audio_ring_begin_read(ring, &span);
+  uint32_t n = count < available ? count : available;
+  uint32_t first = n < span.size[0] ? n : span.size[0];
+  memcpy(out, span.data[0], first * sizeof(float));
+  if (n > first) memcpy(out + first, span.data[1], (n - first) * sizeof(float));
+  ethervox_audio_ring_end_read(ring, n);
+
+  if (n < count) {
+    memset(out + n, 0, (count - n) * sizeof(float));
+    RING_STORE(&ring->underruns, RING_LOAD(&ring->underruns) + 1);
+  }
+  if (timestamp_us) *timestamp_us = span.timestamp_us;
+  return n;
+}
+
+// ============================================================================
+// Any thread
+// ============================================================================
+
+void ethervox_audio_ring_request_flush(ethervox_audio_ring_t* ring) {
+  if (!ring) return;
+  RING_STORE_RELEASE(&ring->flush_to, RING_LOAD_ACQUIRE(&ring->write_index));
+}
+
+uint64_t ethervox_audio_ring_timestamp_at(const ethervox_audio_ring_t* ring, uint64_t position) {
+  if (!ring) return 0;
+
+  uint64_t seq, anchor_position, anchor_timestamp;
+  do {
+    seq = RING_LOAD_ACQUIRE(&ring->anchor_seq);
+    anchor_position = RING_LOAD(&ring->anchor_position);
+    anchor_timestamp = RING_LOAD(&ring->anchor_timestamp);
+    RING_FENCE_ACQUIRE();
+  } while ((seq & 1) || seq != RING_LOAD(&ring->anchor_seq));
+
+  if (anchor_timestamp == 0) return 0;
+  if (ring->sample_rate == 0) return anchor_timestamp;
+
+  if (position >= anchor_position) {
+    return anchor_timestamp + (position - anchor_position) * 1000000ULL / ring->sample_rate;
+  }
+  uint64_t back = (anchor_position - position) * 1000000ULL / ring->sample_rate;
+  return back < anchor_timestamp ? anchor_timestamp - back : 0;
+}
+
+ethervox_result_t ethervox_audio_ring_get_stats(const ethervox_audio_ring_t* ring,
+                                                ethervox_audio_ring_stats_t* stats) {
+  ETHERVOX_CHECK_PTR(ring);
+  ETHERVOX_CHECK_PTR(stats);
+  stats->written = RING_LOAD_ACQUIRE(&ring->write_index);
+  stats->read = RING_LOAD_ACQUIRE(&ring->read_index);
+  stats->overruns = RING_LOAD(&ring->overruns);
+  stats->dropped = RING_LOAD(&ring->dropped);
+  stats->underruns = RING_LOAD(&ring->underruns);
+  stats->flushed = RING_LOAD(&ring->flushed);
+  stats->high_water = (uint32_t)RING_LOAD(&ring->high_water);
+  return ETHERVOX_SUCCESS;
+}
@@ -0,0 +1,895 @@
+/**
+ * @file beamformer.c
+ * @brief SRP-PHAT direction of arrival, fractional-delay delay-and-sum and
+ *        STFT MVDR beamforming
+ *
+ * Analysis runs every hop on the last FFT-size samples of each channel:
+ * channels are windowed with sqrt-Hann and transformed two at a time (one
+ * complex FFT carries a pair of real channels). For the DOA each bin is
+ * whitened to unit magnitude, so the power of the steered sum
+ * |sum_i X_i / |X_i| * exp(j w tau_i)|^2 over the band is, up to a
+ * constant, the sum of every pair's GCC-PHAT at the lags that direction
+ * implies. The per-mic phasors are advanced bin by bin, so no steering
+ * table is stored.
+ *
+ * Delay and sum works in the time domain on blocks of at most BF_CHUNK
+ * frames: channel i is delayed by C + (p_i . u) * rate / c samples, where C
+ * (the array radius in samples) keeps every delay non-negative, so sound
+ * from the steered direction lines up at a constant latency. Each delay is
+ * an integer part plus one of FRACTIONS windowed-sinc filters, applied one
+ * tap at a time as a vector multiply-add over the whole block.
+ *
+ * MVDR reuses the analysis spectra: the noise covariance of every bin is
+ * averaged over quiet hops, weights R^-1 d / (d^H R^-1 d) come from a
+ * Cholesky solve, and the weighted sum is resynthesized with sqrt-Hann
+ * overlap-add (exact reconstruction, one FFT length of latency). Until the
+ * covariance has seen enough quiet audio the weights are delay and sum.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/beamformer.h"
+#include "ethervox/dsp.h"
+#include "ethervox/logging.h"
+
+#if !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_uint_least64_t bf_atomic_t;
+#define BF_LOAD(p) atomic_load_explicit((p), memory_order_relaxed)
+#define BF_STORE(p, v) atomic_store_explicit((p), (v), memory_order_relaxed)
+#define BF_INIT(p, v) atomic_init((p), (v))
+#elif defined(_MSC_VER)
+// Aligned 64-bit volatile loads and stores are atomic on x86/x64
+typedef volatile uint64_t bf_atomic_t;
+#define BF_LOAD(p) (*(p))
+#define BF_STORE(p, v) (*(p) = (v))
+#define BF_INIT(p, v) (*(p) = (v))
+#else
+#error "beamformer.c needs C11 atomics"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define BF_MIN_FFT 64
+#define BF_MAX_FFT 4096
+#define BF_CHUNK 256             // Most frames run through the filter bank at once
+#define BF_SRP_SMOOTHING 0.7f    // SRP-PHAT map smoothing over loud hops
+#define BF_FLOOR_RISE 1.002f     // Background energy tracker rise per hop (~0.5 dB/s at 16 ms hops)
+#define BF_LOUD_RATIO 4.0f       // Hop energy over the background that counts as a talker (6 dB)
+#define BF_COV_SMOOTHING 0.95f   // Noise covariance smoothing over quiet hops
+#define BF_COV_MIN_HOPS 8        // Quiet hops before MVDR weights replace delay and sum
+#define BF_MVDR_UPDATE_HOPS 4    // Hops between MVDR weight updates
+#define BF_PHAT_EPS 1e-10f       // Bins quieter than this are left out of the DOA
+
+struct ethervox_beamformer {
+  ethervox_beamformer_config_t config;
+  uint32_t mics;
+  uint32_t fft_size;  // N
+  uint32_t hop;       // N / 2
+  uint32_t bins;      // N / 2 + 1
+  uint32_t band_lo;   // SRP-PHAT bins [band_lo, band_hi)
+  uint32_t band_hi;
+  bool linear;        // Mics on the x axis: azimuth 0-180 only
+
+  // FFT tables
+  float* window;      // sqrt-Hann, N
+  ethervox_fft_t* fft;
+
+  // Analysis stream
+  float* input;       // mics x N: last N samples per channel
+  uint32_t fill;      // Samples gathered toward the next hop
+  float* z_re;        // Complex FFT work buffers, N
+  float* z_im;
+  float* spec_re;     // mics x bins
+  float* spec_im;
+  float* white_re;    // mics x band: PHAT-whitened band
+  float* white_im;
+  float background;   // Tracked quiet-hop band energy
+  bool primed;        // Background seeded
+
+  // DOA
+  uint32_t grid;      // Azimuths evaluated
+  float* phase_re;    // grid x mics: exp(j w tau_i) at band_lo
+  float* phase_im;
+  float* step_re;     // grid x mics: phasor advance per bin
+  float* step_im;
+  float* srp;         // Smoothed map, grid
+  float* srp_frame;   // This hop's map, grid
+  bool located;       // A direction has been accepted
+  uint32_t estimates;
+  bf_atomic_t doa;    // Published: estimates << 32 | confidence << 16 | centidegrees
+  bf_atomic_t steer;  // 0 = track the DOA, else fixed centidegrees + 1
+  float azimuth_deg;  // Current steering
+
+  // Delay and sum
+  float centre_delay;  // C: delay that keeps every channel's delay >= 0 (samples)
+  float* fir;          // FRACTIONS x TAPS windowed-sinc delays
+  uint32_t history;    // Samples kept ahead of each channel's block
+  float* chan;         // mics x (history + BF_CHUNK)
+  float* faded;        // BF_CHUNK: output under the previous steering
+  uint32_t delay_int[ETHERVOX_BEAMFORMER_MAX_MICS];
+  uint32_t delay_frac[ETHERVOX_BEAMFORMER_MAX_MICS];
+  uint32_t old_int[ETHERVOX_BEAMFORMER_MAX_MICS];
+  uint32_t old_frac[ETHERVOX_BEAMFORMER_MAX_MICS];
+  uint32_t fade_pos;   // Samples into the crossfade (hop = none running)
+
+  // MVDR
+  float* cov_re;       // bins x mics x mics
+  float* cov_im;
+  float* w_re;         // bins x mics
+  float* w_im;
+  float* ola;          // Overlap-add accumulator, N
+  float* frame;        // Inverse FFT output, N
+  float* output;       // Finished samples played out during the next hop
+  uint32_t cov_hops;
+  uint32_t weight_age; // Hops since the weights were computed
+  bool weights_stale;
+};
+
+// ============================================================================
+// Geometry
+// ============================================================================
+
+static float bf_wrap_deg(float deg) {
+  deg = fmodf(deg, 360.0f);
+  return deg < 0.0f ? deg + 360.0f : deg;
+}
+
+// Arrival time at mic i relative to the array centre, in seconds (negative = earlier)
+static double bf_arrival(const ethervox_mic_position_t* mic, double azimuth_deg) {
+  double a = azimuth_deg * M_PI / 180.0;
+  return -((double)mic->x * cos(a) + (double)mic->y * sin(a)) / ETHERVOX_BEAMFORMER_SPEED_OF_SOUND;
+}
+
+void ethervox_beamformer_set_linear_array(ethervox_beamformer_config_t* config, float spacing_m) {
+  if (!config) return;
+  uint32_t n = config->channels < ETHERVOX_BEAMFORMER_MAX_MICS ? config->channels : ETHERVOX_BEAMFORMER_MAX_MICS;
+  for (uint32_t i = 0; i < n; i++) {
+    config->mics[i].x = ((float)i - 0.5f * (float)(n - 1)) * spacing_m;
+    config->mics[i].y = 0.0f;
+    config->mics[i].z = 0.0f;
+  }
+}
+
+void ethervox_beamformer_set_circular_array(ethervox_beamformer_config_t* config, float radius_m) {
+  if (!config) return;
+  uint32_t n = config->channels < ETHERVOX_BEAMFORMER_MAX_MICS ? config->channels : ETHERVOX_BEAMFORMER_MAX_MICS;
+  for (uint32_t i = 0; i < n; i++) {
+    double a = 2.0 * M_PI * (double)i / (double)n;
+    config->mics[i].x = (float)(radius_m * cos(a));
+    config->mics[i].y = (float)(radius_m * sin(a));
+    config->mics[i].z = 0.0f;
+  }
+}
+
+/**
+ * Windowed spectra of every channel's last N samples, two channels per FFT:
+ * for z = a + jb, A[k] = (Z[k] + conj Z[N-k]) / 2 and B[k] = (Z[k] - conj Z[N-k]) / 2j
+ */
+static void bf_analyze(ethervox_beamformer_t* bf) {
+  const uint32_t n = bf->fft_size;
+  for (uint32_t i = 0; i < bf->mics; i += 2) {
+    const float* a = bf->input + (size_t)i * n;
+    const float* b = i + 1 < bf->mics ? a + n : NULL;
+    for (uint32_t t = 0; t < n; t++) {
+      bf->z_re[t] = a[t] * bf->window[t];
+      bf->z_im[t] = b ? b[t] * bf->window[t] : 0.0f;
+    }
+    ethervox_fft_complex(bf->fft, bf->z_re, bf->z_im, false);
+
+    float* ar = bf->spec_re + (size_t)i * bf->bins;
+    float* ai = bf->spec_im + (size_t)i * bf->bins;
+    for (uint32_t k = 0; k < bf->bins; k++) {
+      uint32_t nk = (n - k) & (n - 1);
+      float zr = bf->z_re[k], zi = bf->z_im[k];
+      float cr = bf->z_re[nk], ci = -bf->z_im[nk];
+      ar[k] = 0.5f * (zr + cr);
+      ai[k] = 0.5f * (zi + ci);
+      if (b) {
+        ar[bf->bins + k] = 0.5f * (zi - ci);
+        ai[bf->bins + k] = -0.5f * (zr - cr);
+      }
+    }
+  }
+}
+
+// ============================================================================
+// Direction of arrival
+// ============================================================================
+
+static float bf_grid_deg(const ethervox_beamformer_t* bf, uint32_t g) {
+  return (float)g * bf->config.doa_step_deg;
+}
+
+/**
+ * Whiten the band of every channel and return its energy
+ */
+static float bf_whiten(ethervox_beamformer_t* bf) {
+  const uint32_t band = bf->band_hi - bf->band_lo;
+  float energy = 0.0f;
+  for (uint32_t i = 0; i < bf->mics; i++) {
+    const float* re = bf->spec_re + (size_t)i * bf->bins + bf->band_lo;
+    const float* im = bf->spec_im + (size_t)i * bf->bins + bf->band_lo;
+    float* wr = bf->white_re + (size_t)i * band;
+    float* wi = bf->white_im + (size_t)i * band;
+    for (uint32_t k = 0; k < band; k++) {
+      float p = re[k] * re[k] + im[k] * im[k];
+      energy += p;
+      float scale = p > BF_PHAT_EPS ? 1.0f / sqrtf(p) : 0.0f;
+      wr[k] = re[k] * scale;
+      wi[k] = im[k] * scale;
+    }
+  }
+  return energy;
+}
+
+/**
+ * Steered response power of the whitened band for every azimuth, scaled so
+ * a single plane wave from that azimuth scores 1 and uncorrelated noise 0
+ */
+static void bf_srp_phat(ethervox_beamformer_t* bf) {
+  const uint32_t m = bf->mics;
+  const uint32_t band = bf->band_hi - bf->band_lo;
+  const float autos = (float)m * (float)band;
+  const float pairs = (float)m * (float)(m - 1) * (float)band;
+  float cur_re[ETHERVOX_BEAMFORMER_MAX_MICS];
+  float cur_im[ETHERVOX_BEAMFORMER_MAX_MICS];
+
+  for (uint32_t g = 0; g < bf->grid; g++) {
+    const float* st_re = bf->step_re + (size_t)g * m;
+    const float* st_im = bf->step_im + (size_t)g * m;
+    memcpy(cur_re, bf->phase_re + (size_t)g * m, m * sizeof(float));
+    memcpy(cur_im, bf->phase_im + (size_t)g * m, m * sizeof(float));
+
+    float power = 0.0f;
+    for (uint32_t k = 0; k < band; k++) {
+      float sr = 0.0f, si = 0.0f;
+      for (uint32_t i = 0; i < m; i++) {
+        float xr = bf->white_re[(size_t)i * band + k];
+        float xi = bf->white_im[(size_t)i * band + k];
+        sr += xr * cur_re[i] - xi * cur_im[i];
+        si += xr * cur_im[i] + xi * cur_re[i];
+        float nr = cur_re[i] * st_re[i] - cur_im[i] * st_im[i];
+        cur_im[i] = cur_re[i] * st_im[i] + cur_im[i] * st_re[i];
+        cur_re[i] = nr;
+      }
+      power += sr * sr + si * si;
+    }
+    bf->srp_frame[g] = (power - autos) / pairs;
+  }
+}
+
+/**
+ * Peak of the smoothed map, refined with a parabola through its neighbours
+ *
+ * @param contrast Output: peak minus the map mean
+ */
+static float bf_find_peak(const ethervox_beamformer_t* bf, float* contrast) {
+  uint32_t best = 0;
+  float mean = 0.0f;
+  for (uint32_t g = 0; g < bf->grid; g++) {
+    mean += bf->srp[g];
+    if (bf->srp[g] > bf->srp[best]) best = g;
+  }
+  mean /= (float)bf->grid;
+  *contrast = fminf(fmaxf(bf->srp[best] - mean, 0.0f), 1.0f);
+
+  float offset = 0.0f;
+  bool has_left = bf->linear ? best > 0 : true;
+  bool has_right = bf->linear ? best + 1 < bf->grid : true;
+  if (has_left && has_right) {
+    float l = bf->srp[(best + bf->grid - 1) % bf->grid];
+    float c = bf->srp[best];
+    float r = bf->srp[(best + 1) % bf->grid];
+    float den = l - 2.0f * c + r;
+    if (den < 0.0f) offset = fminf(fmaxf(0.5f * (l - r) / den, -0.5f), 0.5f);
+  }
+  float deg = bf_grid_deg(bf, best) + offset * bf->config.doa_step_deg;
+  return bf->linear ? fminf(fmaxf(deg, 0.0f), 180.0f) : bf_wrap_deg(deg);
+}
+
+static void bf_publish(ethervox_beamformer_t* bf, float azimuth_deg, float confidence) {
+  uint64_t centideg = (uint64_t)lroundf(bf_wrap_deg(azimuth_deg) * 100.0f) % 36000u;
+  uint64_t conf = (uint64_t)lroundf(fminf(fmaxf(confidence, 0.0f), 1.0f) * 65535.0f);
+  BF_STORE(&bf->doa, ((uint64_t)bf->estimates << 32) | (conf << 16) | centideg);
+}
+
+// ============================================================================
+// Steering
+// ============================================================================
+
+static void bf_set_steering(ethervox_beamformer_t* bf, float azimuth_deg) {
+  const float rate = (float)bf->config.sample_rate;
+  const uint32_t fractions = ETHERVOX_BEAMFORMER_FRACTIONS;
+  bf->azimuth_deg = azimuth_deg;
+  bf->weights_stale = true;
+
+  uint32_t ints[ETHERVOX_BEAMFORMER_MAX_MICS];
+  uint32_t fracs[ETHERVOX_BEAMFORMER_MAX_MICS];
+  bool changed = false;
+  for (uint32_t i = 0; i < bf->mics; i++) {
+    float delay = bf->centre_delay - (float)bf_arrival(&bf->config.mics[i], azimuth_deg) * rate;
+    uint32_t steps = (uint32_t)lroundf(fmaxf(delay, 0.0f) * (float)fractions);
+    ints[i] = steps / fractions;
+    fracs[i] = steps % fractions;
+    changed = changed || ints[i] != bf->delay_int[i] || fracs[i] != bf->delay_frac[i];
+  }
+  if (!changed) return;
+
+  // Crossfade from the current delays over the next hop
+  memcpy(bf->old_int, bf->delay_int, sizeof(bf->old_int));
+  memcpy(bf->old_frac, bf->delay_frac, sizeof(bf->old_frac));
+  memcpy(bf->delay_int, ints, bf->mics * sizeof(uint32_t));
+  memcpy(bf->delay_frac, fracs, bf->mics * sizeof(uint32_t));
+  bf->fade_pos = 0;
+}
+
+/**
+ * SRP-PHAT for this hop: smooth the map over loud hops (and every hop until
+ * a first direction is found), publish confident peaks and steer to them
+ * unless the beam is fixed
+ */
+static void bf_locate(ethervox_beamformer_t* bf, bool loud) {
+  if (!loud && bf->located) return;
+
+  bf_srp_phat(bf);
+  if (bf->located) {
+    for (uint32_t g = 0; g < bf->grid; g++) {
+      bf->srp[g] = BF_SRP_SMOOTHING * bf->srp[g] + (1.0f - BF_SRP_SMOOTHING) * bf->srp_frame[g];
+    }
+  } else {
+    memcpy(bf->srp, bf->srp_frame, bf->grid * sizeof(float));
+  }
+
+  float confidence = 0.0f;
+  float azimuth = bf_find_peak(bf, &confidence);
+  if (confidence < bf->config.min_confidence) return;
+
+  bf->estimates++;
+  bf->located = true;
+  bf_publish(bf, azimuth, confidence);
+
+  uint64_t fixed = BF_LOAD(&bf->steer);
+  if (fixed == 0) {
+    float diff = fabsf(azimuth - bf->azimuth_deg);
+    if (fminf(diff, 360.0f - diff) >= 0.5f * bf->config.doa_step_deg) bf_set_steering(bf, azimuth);
+  }
+}
+
+// ============================================================================
+// Delay and sum
+// ============================================================================
+
+/**
+ * Average of every channel's delayed block: one vector multiply-add per tap
+ * over the whole block. Channel samples start at history, preceded by the
+ * history samples before them.
+ */
+static void bf_delay_and_sum(const ethervox_beamformer_t* bf, const uint32_t* ints, const uint32_t* fracs,
+                             uint32_t count, float* out) {
+  const uint32_t taps = ETHERVOX_BEAMFORMER_TAPS;
+  const uint32_t stride = bf->history + BF_CHUNK;
+  const float gain = 1.0f / (float)bf->mics;
+  memset(out, 0, count * sizeof(float));
+  for (uint32_t i = 0; i < bf->mics; i++) {
+    const float* x = bf->chan + (size_t)i * stride + bf->history - ints[i];
+    const float* h = bf->fir + (size_t)fracs[i] * taps;
+    for (uint32_t t = 0; t < taps; t++) {
+      ethervox_dsp_mix(out, x - t, count, h[t] * gain);
+    }
+  }
+}
+
+/**
+ * Windowed-sinc filters delaying by taps / 2 - 1 + f / FRACTIONS samples,
+ * normalized to unity gain at DC
+ */
+static void bf_build_filter_bank(ethervox_beamformer_t* bf) {
+  const uint32_t taps = ETHERVOX_BEAMFORMER_TAPS;
+  const double centre = (double)taps / 2.0 - 1.0;
+  for (uint32_t f = 0; f < ETHERVOX_BEAMFORMER_FRACTIONS; f++) {
+    float* h = bf->fir + (size_t)f * taps;
+    double sum = 0.0;
+    for (uint32_t t = 0; t < taps; t++) {
+      double u = (double)t - centre - (double)f / ETHERVOX_BEAMFORMER_FRACTIONS;
+      double sinc = fabs(u) < 1e-9 ? 1.0 : sin(M_PI * u) / (M_PI * u);
+      // Blackman window centred on the fractional delay, spanning taps samples
+      double w = 0.42 + 0.5 * cos(2.0 * M_PI * u / taps) + 0.08 * cos(4.0 * M_PI * u / taps);
+      h[t] = (float)(sinc * w);
+      sum += sinc * w;
+    }
+    for (uint32_t t = 0; t < taps; t++) h[t] = (float)(h[t] / sum);
+  }
+}
+
+// ============================================================================
+// MVDR
+// ============================================================================
+
+static void bf_update_covariance(ethervox_beamformer_t* bf) {
+  const uint32_t m = bf->mics;
+  const float a = bf->cov_hops == 0 ? 0.0f : BF_COV_SMOOTHING;
+  for (uint32_t k = 0; k < bf->bins; k++) {
+    float* rr = bf->cov_re + (size_t)k * m * m;
+    float* ri = bf->cov_im + (size_t)k * m * m;
+    for (uint32_t i = 0; i < m; i++) {
+      float xr = bf->spec_re[(size_t)i * bf->bins + k], xi = bf->spec_im[(size_t)i * bf->bins + k];
+      for (uint32_t j = i; j < m; j++) {
+        float yr = bf->spec_re[(size_t)j * bf->bins + k], yi = bf->spec_im[(size_t)j * bf->bins + k];
+        // X_i conj(X_j)
+        float pr = xr * yr + xi * yi;
+        float pi = xi * yr - xr * yi;
+        rr[i * m + j] = a * rr[i * m + j] + (1.0f - a) * pr;
+        ri[i * m + j] = a * ri[i * m + j] + (1.0f - a) * pi;
+        rr[j * m + i] = rr[i * m + j];
+        ri[j * m + i] = -ri[i * m + j];
+      }
+    }
+  }
+  bf->cov_hops++;
+}
+
+/**
+ * Weights for every bin towards the current azimuth: R^-1 d / (d^H R^-1 d)
+ * with diagonal loading, or d / M (delay and sum) while the covariance is
+ * young or a bin is numerically singular
+ */
+static void bf_update_weights(ethervox_beamformer_t* bf) {
+  const uint32_t m = bf->mics;
+  const bool adaptive = bf->cov_hops >= BF_COV_MIN_HOPS;
+  double tau[ETHERVOX_BEAMFORMER_MAX_MICS];
+  for (uint32_t i = 0; i < m; i++) tau[i] = bf_arrival(&bf->config.mics[i], bf->azimuth_deg);
+
+  float lr[ETHERVOX_BEAMFORMER_MAX_MICS * ETHERVOX_BEAMFORMER_MAX_MICS];
+  float li[ETHERVOX_BEAMFORMER_MAX_MICS * ETHERVOX_BEAMFORMER_MAX_MICS];
+  float dr[ETHERVOX_BEAMFORMER_MAX_MICS], di[ETHERVOX_BEAMFORMER_MAX_MICS];
+  float vr[ETHERVOX_BEAMFORMER_MAX_MICS], vi[ETHERVOX_BEAMFORMER_MAX_MICS];
+
+  for (uint32_t k = 0; k < bf->bins; k++) {
+    double omega = 2.0 * M_PI * (double)k * bf->config.sample_rate / (double)bf->fft_size;
+    for (uint32_t i = 0; i < m; i++) {
+      // Array response d_i = exp(-j w tau_i)
+      dr[i] = (float)cos(omega * tau[i]);
+      di[i] = (float)-sin(omega * tau[i]);
+    }
+    float* wr = bf->w_re + (size_t)k * m;
+    float* wi = bf->w_im + (size_t)k * m;
+
+    bool solved = false;
+    if (adaptive) {
+      const float* rr = bf->cov_re + (size_t)k * m * m;
+      const float* ri = bf->cov_im + (size_t)k * m * m;
+      float trace = 0.0f;
+      for (uint32_t i = 0; i < m; i++) trace += rr[i * m + i];
+      float loading = bf->config.mvdr_loading * trace / (float)m + FLT_MIN;
+
+      // Cholesky: R + loading I = L L^H
+      solved = true;
+      for (uint32_t j = 0; j < m && solved; j++) {
+        float diag = rr[j * m + j] + loading;
+        for (uint32_t p = 0; p < j; p++) diag -= lr[j * m + p] * lr[j * m + p] + li[j * m + p] * li[j * m + p];
+        if (!(diag > 0.0f)) {
+          solved = false;
+          break;
+        }
+        float ljj = sqrtf(diag);
+        lr[j * m + j] = ljj;
+        li[j * m + j] = 0.0f;
+        for (uint32_t i = j + 1; i < m; i++) {
+          float sr = rr[i * m + j], si = ri[i * m + j];
+          for (uint32_t p = 0; p < j; p++) {
+            // L_ip conj(L_jp)
+            sr -= lr[i * m + p] * lr[j * m + p] + li[i * m + p] * li[j * m + p];
+            si -= li[i * m + p] * lr[j * m + p] - lr[i * m + p] * li[j * m + p];
+          }
+          lr[i * m + j] = sr / ljj;
+          li[i * m + j] = si / ljj;
+        }
+      }
+
+      if (solved) {
+        // L y = d, then L^H v = y
+        for (uint32_t i = 0; i < m; i++) {
+          float sr = dr[i], si = di[i];
+          for (uint32_t p = 0; p < i; p++) {
+            sr -= lr[i * m + p] * vr[p] - li[i * m + p] * vi[p];
+            si -= lr[i * m + p] * vi[p] + li[i * m + p] * vr[p];
+          }
+          vr[i] = sr / lr[i * m + i];
+          vi[i] = si / lr[i * m + i];
+        }
+        for (uint32_t i = m; i-- > 0;) {
+          float sr = vr[i], si = vi[i];
+          for (uint32_t p = i + 1; p < m; p++) {
+            // conj(L_pi) v_p
+            sr -= lr[p * m + i] * vr[p] + li[p * m + i] * vi[p];
+            si -= lr[p * m + i] * vi[p] - li[p * m + i] * vr[p];
+          }
+          vr[i] = sr / lr[i * m + i];
+          vi[i] = si / lr[i * m + i];
+        }
+        // d^H v is real and positive for a positive definite R
+        float norm = 0.0f;
+        for (uint32_t i = 0; i < m; i++) norm += dr[i] * vr[i] + di[i] * vi[i];
+        solved = norm > FLT_MIN && isfinite(norm);
+        if (solved) {
+          for (uint32_t i = 0; i < m; i++) {
+            wr[i] = vr[i] / norm;
+            wi[i] = vi[i] / norm;
+          }
+        }
+      }
+    }
+    if (!solved) {
+      for (uint32_t i = 0; i < m; i++) {
+        wr[i] = dr[i] / (float)m;
+        wi[i] = di[i] / (float)m;
+      }
+    }
+  }
+  bf->weight_age = 0;
+  bf->weights_stale = false;
+}
+
+/**
+ * Y = w^H X per bin, inverse FFT, window and overlap-add into the next hop
+ */
+static void bf_synthesize(ethervox_beamformer_t* bf) {
+  const uint32_t n = bf->fft_size;
+  const uint32_t m = bf->mics;
+
+  for (uint32_t k = 0; k < bf->bins; k++) {
+    const float* wr = bf->w_re + (size_t)k * m;
+    const float* wi = bf->w_im + (size_t)k * m;
+    float yr = 0.0f, yi = 0.0f;
+    for (uint32_t i = 0; i < m; i++) {
+      float xr = bf->spec_re[(size_t)i * bf->bins + k], xi = bf->spec_im[(size_t)i * bf->bins + k];
+      yr += wr[i] * xr + wi[i] * xi;
+      yi += wr[i] * xi - wi[i] * xr;
+    }
+    if (k == 0 || k == n / 2) yi = 0.0f;
+    bf->z_re[k] = yr;
+    bf->z_im[k] = yi;
+  }
+  ethervox_fft_real_inverse(bf->fft, bf->z_re, bf->z_im, bf->frame);
+
+  for (uint32_t t = 0; t < n; t++) bf->ola[t] += bf->frame[t] * bf->window[t];
+  memcpy(bf->output, bf->ola, bf->hop * sizeof(float));
+  memmove(bf->ola, bf->ola + bf->hop, (n - bf->hop) * sizeof(float));
+  memset(bf->ola + n - bf->hop, 0, bf->hop * sizeof(float));
+}
+
+// ============================================================================
+// Stream
+// ============================================================================
+
+static void bf_process_hop(ethervox_beamformer_t* bf) {
+  bf_analyze(bf);
+
+  // Loud hops (a talker over the background) drive the DOA; quiet ones the noise covariance
+  float energy = bf_whiten(bf);
+  bool loud = false;
+  if (!bf->primed) {
+    if (energy > 0.0f) {
+      bf->background = energy;
+      bf->primed = true;
+    }
+  } else if (energy < bf->background) {
+    bf->background = energy;
+  } else {
+    loud = energy > BF_LOUD_RATIO * bf->background;
+    bf->background *= BF_FLOOR_RISE;
+  }
+
+  uint64_t fixed = BF_LOAD(&bf->steer);
+  if (fixed != 0) {
+    float azimuth = (float)(fixed - 1) / 100.0f;
+    if (azimuth != bf->azimuth_deg) bf_set_steering(bf, azimuth);
+  }
+  if (bf->primed) bf_locate(bf, loud);
+
+  if (bf->config.mode == ETHERVOX_BEAMFORMER_MVDR) {
+    if (bf->primed && !loud) bf_update_covariance(bf);
+    if (bf->weights_stale || ++bf->weight_age >= BF_MVDR_UPDATE_HOPS) bf_update_weights(bf);
+    bf_synthesize(bf);
+  }
+
+  const uint32_t n = bf->fft_size;
+  for (uint32_t i = 0; i < bf->mics; i++) {
+    float* x = bf->input + (size_t)i * n;
+    memmove(x, x + bf->hop, (n - bf->hop) * sizeof(float));
+  }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+ethervox_beamformer_config_t ethervox_beamformer_default_config(uint32_t channels, uint32_t sample_rate) {
+  ethervox_beamformer_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.sample_rate = sample_rate ? sample_rate : ETHERVOX_AUDIO_SAMPLE_RATE;
+  config.channels = channels;
+  config.mode = ETHERVOX_BEAMFORMER_DELAY_AND_SUM;
+  config.frame_ms = ETHERVOX_BEAMFORMER_FRAME_MS;
+  config.doa_step_deg = ETHERVOX_BEAMFORMER_DOA_STEP_DEG;
+  config.min_confidence = ETHERVOX_BEAMFORMER_MIN_CONFIDENCE;
+  config.mvdr_loading = ETHERVOX_BEAMFORMER_MVDR_LOADING;
+  if (channels > 2) {
+    ethervox_beamformer_set_circular_array(&config, ETHERVOX_BEAMFORMER_ARRAY_RADIUS_M);
+  } else {
+    ethervox_beamformer_set_linear_array(&config, ETHERVOX_BEAMFORMER_MIC_SPACING_M);
+  }
+  return config;
+}
+
+ethervox_beamformer_t* ethervox_beamformer_create(const ethervox_beamformer_config_t* config) {
+  if (!config) return NULL;
+  ethervox_beamformer_config_t cfg = *config;
+  if (cfg.channels < 2 || cfg.channels > ETHERVOX_BEAMFORMER_MAX_MICS) {
+    ETHERVOX_LOG_ERROR("Beamformer needs 2-%d mics (got %u)", ETHERVOX_BEAMFORMER_MAX_MICS, cfg.channels);
+    return NULL;
+  }
+  if (cfg.sample_rate == 0 || !(cfg.doa_step_deg > 0.0f) || cfg.min_confidence < 0.0f ||
+      cfg.mvdr_loading < 0.0f || (cfg.mode != ETHERVOX_BEAMFORMER_DELAY_AND_SUM && cfg.mode != ETHERVOX_BEAMFORMER_MVDR)) {
+    ETHERVOX_LOG_ERROR("Invalid beamformer configuration");
+    return NULL;
+  }
+
+  uint32_t fft_size = BF_MIN_FFT;
+  uint64_t window = (uint64_t)cfg.sample_rate * cfg.frame_ms / 1000;
+  while (fft_size < window && fft_size < BF_MAX_FFT) fft_size <<= 1;
+  if (window > BF_MAX_FFT) {
+    ETHERVOX_LOG_ERROR("Beamformer window too long (%u ms at %u Hz)", cfg.frame_ms, cfg.sample_rate);
+    return NULL;
+  }
+
+  ethervox_beamformer_t* bf = (ethervox_beamformer_t*)calloc(1, sizeof(*bf));
+  if (!bf) return NULL;
+  bf->config = cfg;
+  bf->mics = cfg.channels;
+  bf->fft_size = fft_size;
+  bf->hop = fft_size / 2;
+  bf->bins = bf->hop + 1;
+  BF_INIT(&bf->doa, 0);
+  BF_INIT(&bf->steer, 0);
+
+  double bin_hz = (double)cfg.sample_rate / fft_size;
+  double max_hz = fmin(ETHERVOX_BEAMFORMER_DOA_MAX_HZ, 0.45 * cfg.sample_rate);
+  bf->band_lo = (uint32_t)ceil(ETHERVOX_BEAMFORMER_DOA_MIN_HZ / bin_hz);
+  bf->band_hi = (uint32_t)floor(max_hz / bin_hz) + 1;
+  if (bf->band_lo < 1) bf->band_lo = 1;
+  if (bf->band_hi > bf->bins - 1) bf->band_hi = bf->bins - 1;
+  if (bf->band_hi <= bf->band_lo) {
+    ETHERVOX_LOG_ERROR("Beamformer DOA band is empty at %u Hz", cfg.sample_rate);
+    free(bf);
+    return NULL;
+  }
+
+  // Geometry: radius sets the delay range; mics all on the x axis only resolve 0-180 degrees
+  float radius = 0.0f;
+  bf->linear = true;
+  for (uint32_t i = 0; i < bf->mics; i++) {
+    const ethervox_mic_position_t* p = &cfg.mics[i];
+    radius = fmaxf(radius, sqrtf(p->x * p->x + p->y * p->y + p->z * p->z));
+    if (fabsf(p->y) > 1e-6f || fabsf(p->z) > 1e-6f) bf->linear = false;
+  }
+  bf->centre_delay = radius * (float)cfg.sample_rate / ETHERVOX_BEAMFORMER_SPEED_OF_SOUND;
+  bf->history = (uint32_t)ceilf(2.0f * bf->centre_delay) + ETHERVOX_BEAMFORMER_TAPS + 1;
+  bf->grid = (uint32_t)floorf((bf->linear ? 180.0f : 360.0f) / cfg.doa_step_deg + (bf->linear ? 1.0f : 0.0f));
+  if (bf->grid < 3) bf->grid = 3;
+
+  const uint32_t n = fft_size, m = bf->mics, band = bf->band_hi - bf->band_lo;
+  const size_t specs = (size_t)m * bf->bins;
+  bf->window = (float*)malloc(n * sizeof(float));
+  bf->fft = ethervox_fft_create(n);
+  bf->input = (float*)malloc((size_t)m * n * sizeof(float));
+  bf->z_re = (float*)malloc(n * sizeof(float));
+  bf->z_im = (float*)malloc(n * sizeof(float));
+  bf->spec_re = (float*)malloc(specs * sizeof(float));
+  bf->spec_im = (float*)malloc(specs * sizeof(float));
+  bf->white_re = (float*)malloc((size_t)m * band * sizeof(float));
+  bf->white_im = (float*)malloc((size_t)m * band * sizeof(float));
+  bf->phase_re = (float*)malloc((size_t)bf->grid * m * sizeof(float));
+  bf->phase_im = (float*)malloc((size_t)bf->grid * m * sizeof(float));
+  bf->step_re = (float*)malloc((size_t)bf->grid * m * sizeof(float));
+  bf->step_im = (float*)malloc((size_t)bf->grid * m * sizeof(float));
+  bf->srp = (float*)malloc(bf->grid * sizeof(float));
+  bf->srp_frame = (float*)malloc(bf->grid * sizeof(float));
+  bf->fir = (float*)malloc((size_t)ETHERVOX_BEAMFORMER_FRACTIONS * ETHERVOX_BEAMFORMER_TAPS * sizeof(float));
+  bf->chan = (float*)malloc((size_t)m * (bf->history + BF_CHUNK) * sizeof(float));
+  bf->faded = (float*)malloc(BF_CHUNK * sizeof(float));
+  if (cfg.mode == ETHERVOX_BEAMFORMER_MVDR) {
+    bf->cov_re = (float*)malloc(specs * m * sizeof(float));
+    bf->cov_im = (float*)malloc(specs * m * sizeof(float));
+    bf->w_re = (float*)malloc(specs * sizeof(float));
+    bf->w_im = (float*)malloc(specs * sizeof(float));
+    bf->ola = (float*)malloc(n * sizeof(float));
+    bf->frame = (float*)malloc(n * sizeof(float));
+    bf->output = (float*)malloc(bf->hop * sizeof(float));
+  }
+  if (!bf->window || !bf->fft || !bf->input || !bf->z_re || !bf->z_im ||
+      !bf->spec_re || !bf->spec_im || !bf->white_re || !bf->white_im || !bf->phase_re || !bf->phase_im ||
+      !bf->step_re || !bf->step_im || !bf->srp || !bf->srp_frame || !bf->fir || !bf->chan || !bf->faded ||
+      (cfg.mode == ETHERVOX_BEAMFORMER_MVDR &&
+       (!bf->cov_re || !bf->cov_im || !bf->w_re || !bf->w_im || !bf->ola || !bf->frame || !bf->output))) {
+    ethervox_beamformer_destroy(bf);
+    return NULL;
+  }
+
+  // Periodic sqrt-Hann: squared windows at 50% overlap sum to exactly one
+  for (uint32_t t = 0; t < n; t++) {
+    bf->window[t] = sqrtf(0.5f - 0.5f * cosf(2.0f * (float)M_PI * (float)t / (float)n));
+  }
+
+  // Steering phasors exp(j w_k tau_i(azimuth)) at band_lo and per bin
+  for (uint32_t g = 0; g < bf->grid; g++) {
+    for (uint32_t i = 0; i < m; i++) {
+      double tau = bf_arrival(&cfg.mics[i], bf_grid_deg(bf, g));
+      double step = 2.0 * M_PI * bin_hz * tau;
+      bf->phase_re[g * m + i] = (float)cos(step * bf->band_lo);
+      bf->phase_im[g * m + i] = (float)sin(step * bf->band_lo);
+      bf->step_re[g * m + i] = (float)cos(step);
+      bf->step_im[g * m + i] = (float)sin(step);
+    }
+  }
+  bf_build_filter_bank(bf);
+
+  ethervox_beamformer_reset(bf);
+  ETHERVOX_LOG_INFO("Beamformer: %u mics (%s array), %s, %u-point DOA over %u-%u Hz, %u azimuths",
+                    m, bf->linear ? "linear" : "planar",
+                    cfg.mode == ETHERVOX_BEAMFORMER_MVDR ? "MVDR" : "delay and sum", n,
+                    (unsigned)(bf->band_lo * bin_hz), (unsigned)(bf->band_hi * bin_hz), bf->grid);
+  return bf;
+}
+
+void ethervox_beamformer_destroy(ethervox_beamformer_t* beamformer) {
+  ethervox_beamformer_t* bf = beamformer;
+  if (!bf) return;
+  free(bf->window);
+  ethervox_fft_destroy(bf->fft);
+  free(bf->input);
+  free(bf->z_re);
+  free(bf->z_im);
+  free(bf->spec_re);
+  free(bf->spec_im);
+  free(bf->white_re);
+  free(bf->white_im);
+  free(bf->phase_re);
+  free(bf->phase_im);
+  free(bf->step_re);
+  free(bf->step_im);
+  free(bf->srp);
+  free(bf->srp_frame);
+  free(bf->fir);
+  free(bf->chan);
+  free(bf->faded);
+  free(bf->cov_re);
+  free(bf->cov_im);
+  free(bf->w_re);
+  free(bf->w_im);
+  free(bf->ola);
+  free(bf->frame);
+  free(bf->output);
+  free(bf);
+}
+
+void ethervox_beamformer_reset(ethervox_beamformer_t* beamformer) {
+  ethervox_beamformer_t* bf = beamformer;
+  if (!bf) return;
+  memset(bf->input, 0, (size_t)bf->mics * bf->fft_size * sizeof(float));
+  memset(bf->chan, 0, (size_t)bf->mics * (bf->history + BF_CHUNK) * sizeof(float));
+  memset(bf->srp, 0, bf->grid * sizeof(float));
+  bf->fill = 0;
+  bf->background = 0.0f;
+  bf->primed = false;
+  bf->located = false;
+  bf->estimates = 0;
+  BF_STORE(&bf->doa, 0);
+  bf->cov_hops = 0;
+  if (bf->ola) {
+    memset(bf->ola, 0, bf->fft_size * sizeof(float));
+    memset(bf->output, 0, bf->hop * sizeof(float));
+  }
+
+  // Broadside to the array (+y for a linear array, mic 0 otherwise) until a talker is heard
+  uint64_t fixed = BF_LOAD(&bf->steer);
+  float azimuth = fixed ? (float)(fixed - 1) / 100.0f : (bf->linear ? 90.0f : 0.0f);
+  memset(bf->delay_int, 0, sizeof(bf->delay_int));
+  memset(bf->delay_frac, 0, sizeof(bf->delay_frac));
+  bf->delay_int[0] = UINT32_MAX;  // Forces bf_set_steering to take the new delays
+  bf_set_steering(bf, azimuth);
+  bf->fade_pos = bf->hop;
+  if (bf->w_re) bf_update_weights(bf);
+}
+
+ethervox_result_t ethervox_beamformer_process(ethervox_beamformer_t* beamformer, const float* input,
+                                              uint32_t frames, float* output) {
+  ethervox_beamformer_t* bf = beamformer;
+  ETHERVOX_CHECK_PTR(bf);
+  if (frames == 0) return ETHERVOX_SUCCESS;
+  ETHERVOX_CHECK_PTR(input);
+  ETHERVOX_CHECK_PTR(output);
+
+  const uint32_t m = bf->mics;
+  const uint32_t n = bf->fft_size;
+  const uint32_t stride = bf->history + BF_CHUNK;
+  const bool mvdr = bf->config.mode == ETHERVOX_BEAMFORMER_MVDR;
+  uint32_t pos = 0;
+  while (pos < frames) {
+    // Blocks never straddle a hop, so steering changes land on block boundaries
+    uint32_t count = bf->hop - bf->fill;
+    if (count > BF_CHUNK) count = BF_CHUNK;
+    if (count > frames - pos) count = frames - pos;
+
+    const float* in = input + (size_t)pos * m;
+    for (uint32_t i = 0; i < m; i++) {
+      float* tail = bf->input + (size_t)i * n + (n - bf->hop) + bf->fill;
+      for (uint32_t f = 0; f < count; f++) tail[f] = in[(size_t)f * m + i];
+      if (!mvdr) memcpy(bf->chan + (size_t)i * stride + bf->history, tail, count * sizeof(float));
+    }
+
+    float* out = output + pos;
+    if (mvdr) {
+      memcpy(out, bf->output + bf->fill, count * sizeof(float));
+    } else {
+      bf_delay_and_sum(bf, bf->delay_int, bf->delay_frac, count, out);
+      if (bf->fade_pos < bf->hop) {
+        bf_delay_and_sum(bf, bf->old_int, bf->old_frac, count, bf->faded);
+        for (uint32_t f = 0; f < count; f++) {
+          float g = (float)(bf->fade_pos + f + 1) / (float)bf->hop;
+          out[f] = bf->faded[f] + g * (out[f] - bf->faded[f]);
+        }
+        bf->fade_pos += count;
+      }
+      for (uint32_t i = 0; i < m; i++) {
+        float* x = bf->chan + (size_t)i * stride;
+        memmove(x, x + count, bf->history * sizeof(float));
+      }
+    }
+
+    bf->fill += count;
+    pos += count;
+    if (bf->fill == bf->hop) {
+      bf_process_hop(bf);
+      bf->fill = 0;
+    }
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_beamformer_steer(ethervox_beamformer_t* beamformer, float azimuth_deg) {
+  ETHERVOX_CHECK_PTR(beamformer);
+  if (!isfinite(azimuth_deg)) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_INVALID_ARGUMENT, "Beam azimuth must be finite");
+  }
+  // Taken up at the next hop by the thread feeding audio
+  uint64_t fixed = azimuth_deg < 0.0f ? 0 : (uint64_t)lroundf(bf_wrap_deg(azimuth_deg) * 100.0f) % 36000u + 1;
+  BF_STORE(&beamformer->steer, fixed);
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_beamformer_get_doa(const ethervox_beamformer_t* beamformer, ethervox_doa_t* doa) {
+  ETHERVOX_CHECK_PTR(beamformer);
+  ETHERVOX_CHECK_PTR(doa);
+  uint64_t packed = BF_LOAD((bf_atomic_t*)&beamformer->doa);
+  doa->azimuth_deg = (float)(packed & 0xFFFFu) / 100.0f;
+  doa->confidence = (float)((packed >> 16) & 0xFFFFu) / 65535.0f;
+  doa->updates = (uint32_t)(packed >> 32);
+  return ETHERVOX_SUCCESS;
+}
+
+uint32_t ethervox_beamformer_latency_samples(const ethervox_beamformer_t* beamformer) {
+  if (!beamformer) return 0;
+  if (beamformer->config.mode == ETHERVOX_BEAMFORMER_MVDR) return beamformer->fft_size;
+  return (uint32_t)lroundf((float)ETHERVOX_BEAMFORMER_TAPS / 2.0f - 1.0f + beamformer->centre_delay);
+}
@@ -0,0 +1,887 @@
+/**
+ * @file dsp.c
+ * @brief Sample-format conversion, mixing, resampling and FFT kernels
+ *
+ * Every kernel has a scalar version plus SSE2, AVX2 and NEON versions
+ * collected into one table per instruction set. The first call picks the
+ * best table for this CPU: SSE2 and NEON are baseline where they are
+ * compiled in, AVX2 is compiled with a target attribute and only selected
+ * when the CPU reports it.
+ *
+ * Mixing uses separate multiply and add (no FMA) and conversion truncates,
+ * so all tables give the same results; only the resampler's dot product
+ * sums in a different order. FFT butterflies follow the same rule, so a
+ * transform is bit-identical on every instruction set.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include "ethervox/logging.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSP_HAVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define DSP_HAVE_AVX2 1
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)  // MSVC /arch:AVX2
+#define DSP_HAVE_AVX2 1
+#define DSP_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define DSP_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define DSP_S16_TO_FLOAT (1.0f / 32768.0f)
+#define DSP_FLOAT_TO_S16 32767.0f
+
+typedef struct {
+  ethervox_dsp_isa_t isa;
+  void (*s16_to_float)(const int16_t* in, float* out, size_t count);
+  void (*float_to_s16)(const float* in, int16_t* out, size_t count);
+  void (*gain)(float* samples, size_t count, float gain);
+  void (*mix)(float* dst, const float* src, size_t count, float gain);
+  void (*downmix_stereo)(const float* in, float* out, size_t frames);
+  float (*dot)(const float* a, const float* b, size_t count);
+  void (*butterfly)(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi, size_t count);
+} dsp_kernels_t;
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+static void scalar_s16_to_float(const int16_t* in, float* out, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    out[i] = (float)in[i] * DSP_S16_TO_FLOAT;
+  }
+}
+
+static inline int16_t scalar_to_s16(float s) {
+  // Written so NaN lands on -1, as min/max do in the SIMD versions
+  if (!(s > -1.0f)) s = -1.0f;
+  if (s > 1.0f) s = 1.0f;
+  return (int16_t)(s * DSP_FLOAT_TO_S16);
+}
+
+static void scalar_float_to_s16(const float* in, int16_t* out, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    out[i] = scalar_to_s16(in[i]);
+  }
+}
+
+static void scalar_gain(float* samples, size_t count, float gain) {
+  for (size_t i = 0; i < count; i++) {
+    samples[i] *= gain;
+  }
+}
+
+static void scalar_mix(float* dst, const float* src, size_t count, float gain) {
+  for (size_t i = 0; i < count; i++) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+static void scalar_downmix_stereo(const float* in, float* out, size_t frames) {
+  for (size_t f = 0; f < frames; f++) {
+    out[f] = (in[2 * f] + in[2 * f + 1]) * 0.5f;
+  }
+}
+
+static float scalar_dot(const float* a, const float* b, size_t count) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < count; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// Radix-2 butterflies: t = b * w, b = a - t, a = a + t
+static void scalar_butterfly(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi,
+                             size_t count) {
+  for (size_t k = 0; k < count; k++) {
+    float tr = br[k] * wr[k] - bi[k] * wi[k];
+    float ti = br[k] * wi[k] + bi[k] * wr[k];
+    br[k] = ar[k] - tr;
+    bi[k] = ai[k] - ti;
+    ar[k] += tr;
+    ai[k] += ti;
+  }
+}
+
+static const dsp_kernels_t kScalarKernels = {ETHERVOX_DSP_ISA_SCALAR, scalar_s16_to_float, scalar_float_to_s16,
+                                             scalar_gain,           scalar_mix,          scalar_downmix_stereo,
+                                             scalar_dot,            scalar_butterfly};
+
+// ============================================================================
+// SSE2
+// ============================================================================
+
+#ifdef DSP_HAVE_SSE2
+
+static void sse2_s16_to_float(const int16_t* in, float* out, size_t count) {
+  const __m128 scale = _mm_set1_ps(DSP_S16_TO_FLOAT);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i s = _mm_loadu_si128((const __m128i*)(in + i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  scalar_s16_to_float(in + i, out + i, count - i);
+}
+
+static void sse2_float_to_s16(const float* in, int16_t* out, size_t count) {
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(DSP_FLOAT_TO_S16);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi);
+    __m128i ia = _mm_cvttps_epi32(_mm_mul_ps(a, scale));
+    __m128i ib = _mm_cvttps_epi32(_mm_mul_ps(b, scale));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(ia, ib));
+  }
+  scalar_float_to_s16(in + i, out + i, count - i);
+}
+
+static void sse2_gain(float* samples, size_t count, float gain) {
+  const __m128 g = _mm_set1_ps(gain);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), g));
+  }
+  scalar_gain(samples + i, count - i, gain);
+}
+
+static void sse2_mix(float* dst, const float* src, size_t count, float gain) {
+  const __m128 g = _mm_set1_ps(gain);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 d = _mm_loadu_ps(dst + i);
+    _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+  }
+  scalar_mix(dst + i, src + i, count - i, gain);
+}
+
+static void sse2_downmix_stereo(const float* in, float* out, size_t frames) {
+  const __m128 half = _mm_set1_ps(0.5f);
+  size_t f = 0;
+  for (; f + 4 <= frames; f += 4) {
+    __m128 a = _mm_loadu_ps(in + 2 * f);
+    __m128 b = _mm_loadu_ps(in + 2 * f + 4);
+    __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(out + f, _mm_mul_ps(_mm_add_ps(left, right), half));
+  }
+  scalar_downmix_stereo(in + 2 * f, out + f, frames - f);
+}
+
+static float sse2_dot(const float* a, const float* b, size_t count) {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  return _mm_cvtss_f32(acc) + scalar_dot(a + i, b + i, count - i);
+}
+
+static void sse2_butterfly(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi,
+                           size_t count) {
+  size_t k = 0;
+  for (; k + 4 <= count; k += 4) {
+    __m128 xr = _mm_loadu_ps(br + k);
+    __m128 xi = _mm_loadu_ps(bi + k);
+    __m128 cr = _mm_loadu_ps(wr + k);
+    __m128 ci = _mm_loadu_ps(wi + k);
+    __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+    __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+    __m128 ur = _mm_loadu_ps(ar + k);
+    __m128 ui = _mm_loadu_ps(ai + k);
+    _mm_storeu_ps(br + k, _mm_sub_ps(ur, tr));
+    _mm_storeu_ps(bi + k, _mm_sub_ps(ui, ti));
+    _mm_storeu_ps(ar + k, _mm_add_ps(ur, tr));
+    _mm_storeu_ps(ai + k, _mm_add_ps(ui, ti));
+  }
+  scalar_butterfly(ar + k, ai + k, br + k, bi + k, wr + k, wi + k, count - k);
+}
+
+static const dsp_kernels_t kSse2Kernels = {ETHERVOX_DSP_ISA_SSE2, sse2_s16_to_float, sse2_float_to_s16,
+                                           sse2_gain,           sse2_mix,          sse2_downmix_stereo,
+                                           sse2_dot,            sse2_butterfly};
+
+#endif  // DSP_HAVE_SSE2
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+#ifdef DSP_HAVE_AVX2
+
+DSP_TARGET_AVX2 static void avx2_s16_to_float(const int16_t* in, float* out, size_t count) {
+  const __m256 scale = _mm256_set1_ps(DSP_S16_TO_FLOAT);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i)));
+    __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i + 8)));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+    _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+  }
+  scalar_s16_to_float(in + i, out + i, count - i);
+}
+
+DSP_TARGET_AVX2 static void avx2_float_to_s16(const float* in, int16_t* out, size_t count) {
+  const __m256 lo = _mm256_set1_ps(-1.0f);
+  const __m256 hi = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(DSP_FLOAT_TO_S16);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), lo), hi);
+    __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i + 8), lo), hi);
+    __m256i ia = _mm256_cvttps_epi32(_mm256_mul_ps(a, scale));
+    __m256i ib = _mm256_cvttps_epi32(_mm256_mul_ps(b, scale));
+    // packs works per 128-bit lane; restore sample order across lanes
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(ia, ib), 0xD8);
+    _mm256_storeu_si256((__m256i*)(out + i), packed);
+  }
+  scalar_float_to_s16(in + i, out + i, count - i);
+}
+
+DSP_TARGET_AVX2 static void avx2_gain(float* samples, size_t count, float gain) {
+  const __m256 g = _mm256_set1_ps(gain);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), g));
+  }
+  scalar_gain(samples + i, count - i, gain);
+}
+
+DSP_TARGET_AVX2 static void avx2_mix(float* dst, const float* src, size_t count, float gain) {
+  const __m256 g = _mm256_set1_ps(gain);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 d = _mm256_loadu_ps(dst + i);
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+  }
+  scalar_mix(dst + i, src + i, count - i, gain);
+}
+
+DSP_TARGET_AVX2 static float avx2_dot(const float* a, const float* b, size_t count) {
+  __m256 acc = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum) + scalar_dot(a + i, b + i, count - i);
+}
+
+DSP_TARGET_AVX2 static void avx2_butterfly(float* ar, float* ai, float* br, float* bi, const float* wr,
+                                           const float* wi, size_t count) {
+  size_t k = 0;
+  for (; k + 8 <= count; k += 8) {
+    __m256 xr = _mm256_loadu_ps(br + k);
+    __m256 xi = _mm256_loadu_ps(bi + k);
+    __m256 cr = _mm256_loadu_ps(wr + k);
+    __m256 ci = _mm256_loadu_ps(wi + k);
+    __m256 tr = _mm256_sub_ps(_mm256_mul_ps(xr, cr), _mm256_mul_ps(xi, ci));
+    __m256 ti = _mm256_add_ps(_mm256_mul_ps(xr, ci), _mm256_mul_ps(xi, cr));
+    __m256 ur = _mm256_loadu_ps(ar + k);
+    __m256 ui = _mm256_loadu_ps(ai + k);
+    _mm256_storeu_ps(br + k, _mm256_sub_ps(ur, tr));
+    _mm256_storeu_ps(bi + k, _mm256_sub_ps(ui, ti));
+    _mm256_storeu_ps(ar + k, _mm256_add_ps(ur, tr));
+    _mm256_storeu_ps(ai + k, _mm256_add_ps(ui, ti));
+  }
+  sse2_butterfly(ar + k, ai + k, br + k, bi + k, wr + k, wi + k, count - k);
+}
+
+// Stereo downmix is load/shuffle bound; the SSE2 version is as fast
+static const dsp_kernels_t kAvx2Kernels = {ETHERVOX_DSP_ISA_AVX2, avx2_s16_to_float, avx2_float_to_s16,
+                                           avx2_gain,           avx2_mix,          sse2_downmix_stereo,
+                                           avx2_dot,            avx2_butterfly};
+
+static int dsp_cpu_has_avx2(void) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return 1;  // Only compiled in for MSVC when the build already requires AVX2
+#endif
+}
+
+#endif  // DSP_HAVE_AVX2
+
+// ============================================================================
+// NEON
+// ============================================================================
+
+#ifdef DSP_HAVE_NEON
+
+static void neon_s16_to_float(const int16_t* in, float* out, size_t count) {
+  const float32x4_t scale = vdupq_n_f32(DSP_S16_TO_FLOAT);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t s = vld1q_s16(in + i);
+    vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), scale));
+    vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), scale));
+  }
+  scalar_s16_to_float(in + i, out + i, count - i);
+}
+
+static void neon_float_to_s16(const float* in, int16_t* out, size_t count) {
+  const float32x4_t lo = vdupq_n_f32(-1.0f);
+  const float32x4_t hi = vdupq_n_f32(1.0f);
+  const float32x4_t scale = vdupq_n_f32(DSP_FLOAT_TO_S16);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(in + i), lo), hi);
+    float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), lo), hi);
+    int32x4_t ia = vcvtq_s32_f32(vmulq_f32(a, scale));  // Truncates, like the C cast
+    int32x4_t ib = vcvtq_s32_f32(vmulq_f32(b, scale));
+    vst1q_s16(out + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+  }
+  scalar_float_to_s16(in + i, out + i, count - i);
+}
+
+static void neon_gain(float* samples, size_t count, float gain) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+  }
+  scalar_gain(samples + i, count - i, gain);
+}
+
+static void neon_mix(float* dst, const float* src, size_t count, float gain) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t d = vld1q_f32(dst + i);
+    vst1q_f32(dst + i, vaddq_f32(d, vmulq_n_f32(vld1q_f32(src + i), gain)));
+  }
+  scalar_mix(dst + i, src + i, count - i, gain);
+}
+
+static void neon_downmix_stereo(const float* in, float* out, size_t frames) {
+  size_t f = 0;
+  for (; f + 4 <= frames; f += 4) {
+    float32x4x2_t lr = vld2q_f32(in + 2 * f);
+    vst1q_f32(out + f, vmulq_n_f32(vaddq_f32(lr.val[0], lr.val[1]), 0.5f));
+  }
+  scalar_downmix_stereo(in + 2 * f, out + f, frames - f);
+}
+
+static float neon_dot(const float* a, const float* b, size_t count) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  float32x4_t acc = vaddq_f32(acc0, acc1);
+  float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  return vget_lane_f32(vpadd_f32(pair, pair), 0) + scalar_dot(a + i, b + i, count - i);
+}
+
+static void neon_butterfly(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi,
+                           size_t count) {
+  size_t k = 0;
+  for (; k + 4 <= count; k += 4) {
+    float32x4_t xr = vld1q_f32(br + k);
+    float32x4_t xi = vld1q_f32(bi + k);
+    float32x4_t cr = vld1q_f32(wr + k);
+    float32x4_t ci = vld1q_f32(wi + k);
+    float32x4_t tr = vsubq_f32(vmulq_f32(xr, cr), vmulq_f32(xi, ci));
+    float32x4_t ti = vaddq_f32(vmulq_f32(xr, ci), vmulq_f32(xi, cr));
+    float32x4_t ur = vld1q_f32(ar + k);
+    float32x4_t ui = vld1q_f32(ai + k);
+    vst1q_f32(br + k, vsubq_f32(ur, tr));
+    vst1q_f32(bi + k, vsubq_f32(ui, ti));
+    vst1q_f32(ar + k, vaddq_f32(ur, tr));
+    vst1q_f32(ai + k, vaddq_f32(ui, ti));
+  }
+  scalar_butterfly(ar + k, ai + k, br + k, bi + k, wr + k, wi + k, count - k);
+}
+
+static const dsp_kernels_t kNeonKernels = {ETHERVOX_DSP_ISA_NEON, neon_s16_to_float, neon_float_to_s16,
+                                           neon_gain,           neon_mix,          neon_downmix_stereo,
+                                           neon_dot,            neon_butterfly};
+
+#endif  // DSP_HAVE_NEON
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+// Written once per process (or by ethervox_dsp_set_isa); every value
+// written is a valid table, so a racing first use just picks twice. The
+// release store / acquire load pair makes the table a reader sees fully
+// visible on weakly ordered CPUs.
+#if !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+static _Atomic(const dsp_kernels_t*) g_kernels = NULL;
+#define DSP_KERNELS_LOAD() atomic_load_explicit(&g_kernels, memory_order_acquire)
+#define DSP_KERNELS_STORE(k) atomic_store_explicit(&g_kernels, (k), memory_order_release)
+#elif defined(_MSC_VER)
+// MSVC without C11 atomics: aligned pointer volatiles are atomic and
+// ordered on x86/x64 (/volatile:ms), a compiler barrier is enough
+#include <intrin.h>
+static const dsp_kernels_t* volatile g_kernels = NULL;
+#define DSP_KERNELS_LOAD() (g_kernels)
+#define DSP_KERNELS_STORE(k) (_ReadWriteBarrier(), g_kernels = (k))
+#else
+#error "dsp.c needs C11 atomics"
+#endif
+
+static const dsp_kernels_t* dsp_table(ethervox_dsp_isa_t isa) {
+  switch (isa) {
+    case ETHERVOX_DSP_ISA_SCALAR:
+      return &kScalarKernels;
+#ifdef DSP_HAVE_SSE2
+    case ETHERVOX_DSP_ISA_SSE2:
+      return &kSse2Kernels;
+#endif
+#ifdef DSP_HAVE_AVX2
+    case ETHERVOX_DSP_ISA_AVX2:
+      return dsp_cpu_has_avx2() ? &kAvx2Kernels : NULL;
+#endif
+#ifdef DSP_HAVE_NEON
+    case ETHERVOX_DSP_ISA_NEON:
+      return &kNeonKernels;
+#endif
+    default:
+      return NULL;
+  }
+}
+
+static const dsp_kernels_t* dsp(void) {
+  const dsp_kernels_t* kernels = DSP_KERNELS_LOAD();
+  if (!kernels) {
+    static const ethervox_dsp_isa_t preference[] = {ETHERVOX_DSP_ISA_AVX2, ETHERVOX_DSP_ISA_NEON,
+                                                    ETHERVOX_DSP_ISA_SSE2, ETHERVOX_DSP_ISA_SCALAR};
+    for (size_t i = 0; !kernels; i++) {
+      kernels = dsp_table(preference[i]);
+    }
+    DSP_KERNELS_STORE(kernels);
+  }
+  return kernels;
+}
+
+ethervox_dsp_isa_t ethervox_dsp_get_isa(void) {
+  return dsp()->isa;
+}
+
+const char* ethervox_dsp_isa_name(ethervox_dsp_isa_t isa) {
+  switch (isa) {
+    case ETHERVOX_DSP_ISA_SCALAR:
+      return "scalar";
+    case ETHERVOX_DSP_ISA_SSE2:
+      return "sse2";
+    case ETHERVOX_DSP_ISA_AVX2:
+      return "avx2";
+    case ETHERVOX_DSP_ISA_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+ethervox_result_t ethervox_dsp_set_isa(ethervox_dsp_isa_t isa) {
+  const dsp_kernels_t* kernels = dsp_table(isa);
+  if (!kernels) {
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_SUPPORTED, "Instruction set not available on this CPU");
+  }
+  DSP_KERNELS_STORE(kernels);
+  return ETHERVOX_SUCCESS;
+}
+
+void ethervox_dsp_s16_to_float(const int16_t* in, float* out, size_t count) {
+  dsp()->s16_to_float(in, out, count);
+}
+
+void ethervox_dsp_float_to_s16(const float* in, int16_t* out, size_t count) {
+  dsp()->float_to_s16(in, out, count);
+}
+
+void ethervox_dsp_gain(float* samples, size_t count, float gain) {
+  dsp()->gain(samples, count, gain);
+}
+
+void ethervox_dsp_mix(float* dst, const float* src, size_t count, float gain) {
+  dsp()->mix(dst, src, count, gain);
+}
+
+void ethervox_dsp_downmix(const float* in, float* out, size_t frames, uint32_t channels) {
+  if (channels == 2) {
+    dsp()->downmix_stereo(in, out, frames);
+  } else if (channels <= 1) {
+    if (out != in) memmove(out, in, frames * sizeof(float));
+  } else {
+    // Frame f is read before out[f] is written, and out[f] <= in[f * channels]
+    const float scale = 1.0f / (float)channels;
+    for (size_t f = 0; f < frames; f++) {
+      float sum = 0.0f;
+      for (uint32_t c = 0; c < channels; c++) {
+        sum += in[f * channels + c];
+      }
+      out[f] = sum * scale;
+    }
+  }
+}
+
+// ============================================================================
+// Polyphase resampler
+// ============================================================================
+
+// Conceptually the input is upsampled by `up` (zeros inserted), low-pass
+// filtered and decimated by `down`. Only the taps that meet nonzero input
+// are evaluated: output n uses filter phase (n * down) % up against the
+// `taps` newest input samples. Each phase's taps are stored reversed so the
+// inner loop is a plain dot product over the history window.
+struct ethervox_resampler {
+  uint32_t up;
+  uint32_t down;
+  uint32_t taps;
+  uint32_t phase;   // Phase of the next output
+  size_t skip;      // Input samples the next output lies beyond the current block
+  size_t max_input;
+  float* coeffs;    // up * taps
+  float* history;   // taps - 1 samples of history, then room for one block
+};
+
+static const double kResampleRolloff = 0.92;  // Passband edge as a fraction of the output Nyquist
+static const double kResampleKaiserBeta = 8.0;  // ~80 dB stopband
+
+static uint32_t dsp_gcd(uint32_t a, uint32_t b) {
+  while (b) {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind (Kaiser window)
+static double dsp_bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 50; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < sum * 1e-12) break;
+  }
+  return sum;
+}
+
+ethervox_resampler_t* ethervox_resampler_create(uint32_t in_rate, uint32_t out_rate, size_t max_input) {
+  if (in_rate == 0 || out_rate == 0 || max_input == 0) {
+    ETHERVOX_LOG_ERROR("Invalid resampler configuration: %u -> %u Hz", in_rate, out_rate);
+    return NULL;
+  }
+  uint32_t g = dsp_gcd(in_rate, out_rate);
+  uint32_t up = out_rate / g;
+  uint32_t down = in_rate / g;
+  if (up > ETHERVOX_DSP_MAX_RESAMPLE_PHASES) {
+    ETHERVOX_LOG_ERROR("Resampling %u -> %u Hz needs %u filter phases (max %u)", in_rate, out_rate, up,
+                       ETHERVOX_DSP_MAX_RESAMPLE_PHASES);
+    return NULL;
+  }
+
+  // Keep the transition band a fixed fraction of the narrower Nyquist
+  uint32_t factor = up > down ? up : down;
+  uint32_t taps = (uint32_t)(((uint64_t)ETHERVOX_DSP_RESAMPLE_TAPS * factor + up - 1) / up);
+  taps = (taps + 7) & ~7u;
+
+  ethervox_resampler_t* r = (ethervox_resampler_t*)calloc(1, sizeof(*r));
+  if (!r) return NULL;
+  r->up = up;
+  r->down = down;
+  r->taps = taps;
+  r->max_input = max_input;
+  r->coeffs = (float*)malloc((size_t)up * taps * sizeof(float));
+  r->history = (float*)calloc(taps - 1 + max_input, sizeof(float));
+  if (!r->coeffs || !r->history) {
+    ethervox_resampler_destroy(r);
+    return NULL;
+  }
+
+  // Windowed sinc at the upsampled rate, cut off below the lower Nyquist
+  size_t length = (size_t)up * taps;
+  double cutoff = 0.5 * kResampleRolloff / (double)factor;  // Cycles per upsampled sample
+  double center = (double)length / 2.0;  // Exactly taps / 2 input samples of delay
+  double window_norm = dsp_bessel_i0(kResampleKaiserBeta);
+  double sum = 0.0;
+  double* prototype = (double*)malloc(length * sizeof(double));
+  if (!prototype) {
+    ethervox_resampler_destroy(r);
+    return NULL;
+  }
+  for (size_t j = 0; j < length; j++) {
+    double t = (double)j - center;
+    double x = 2.0 * cutoff * t;
+    double sinc = fabs(x) < 1e-12 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+    double w = t / center;
+    double window = dsp_bessel_i0(kResampleKaiserBeta * sqrt(1.0 - w * w)) / window_norm;
+    prototype[j] = sinc * window;
+    sum += prototype[j];
+  }
+
+  // Each phase sees 1/up of the taps, so unity DC gain needs sum == up
+  double gain = (double)up / sum;
+  for (uint32_t p = 0; p < up; p++) {
+    for (uint32_t j = 0; j < taps; j++) {
+      r->coeffs[(size_t)p * taps + j] = (float)(prototype[p + (size_t)up * (taps - 1 - j)] * gain);
+    }
+  }
+  free(prototype);
+
+  ethervox_resampler_reset(r);
+  return r;
+}
+
+size_t ethervox_resampler_max_output(const ethervox_resampler_t* resampler, size_t count) {
+  if (!resampler) return 0;
+  return (size_t)(((uint64_t)count * resampler->up + resampler->down - 1) / resampler->down) + 1;
+}
+
+size_t ethervox_resampler_process(ethervox_resampler_t* resampler, const float* in, size_t count, float* out) {
+  if (!resampler || !in || !out || count > resampler->max_input) {
+    return 0;
+  }
+  const dsp_kernels_t* kernels = dsp();
+  const size_t keep = resampler->taps - 1;
+  const size_t total = keep + count;
+  float* history = resampler->history;
+  memcpy(history + keep, in, count * sizeof(float));
+
+  size_t produced = 0;
+  size_t newest = keep + resampler->skip;  // Index of the newest sample the next output uses
+  uint32_t phase = resampler->phase;
+  while (newest < total) {
+    out[produced++] =
+        kernels->dot(resampler->coeffs + (size_t)phase * resampler->taps, history + newest - keep, resampler->taps);
+    phase += resampler->down;
+    newest += phase / resampler->up;
+    phase %= resampler->up;
+  }
+  resampler->phase = phase;
+  resampler->skip = newest - total;
+  memmove(history, history + count, keep * sizeof(float));
+  return produced;
+}
+
+uint32_t ethervox_resampler_latency(const ethervox_resampler_t* resampler) {
+  return resampler ? resampler->taps / 2 : 0;
+}
+
+void ethervox_resampler_reset(ethervox_resampler_t* resampler) {
+  if (!resampler) return;
+  memset(resampler->history, 0, (resampler->taps - 1 + resampler->max_input) * sizeof(float));
+  resampler->phase = 0;
+  resampler->skip = 0;
+}
+
+void ethervox_resampler_destroy(ethervox_resampler_t* resampler) {
+  if (!resampler) return;
+  free(resampler->coeffs);
+  free(resampler->history);
+  free(resampler);
+}
+
+// ============================================================================
+// FFT
+// ============================================================================
+
+// Radix-2 decimation in time on split real/imaginary arrays. The stage
+// twiddles exp(-i pi k / h) of every stage sit in one table, stage h at
+// [h, 2h), so a table built for N also serves the N/2-point transform
+// behind the real FFT; bit reversal over N/2 is bitrev[2i] of the N table.
+struct ethervox_fft {
+  uint32_t size;
+  float* tw_re;      // size entries
+  float* tw_im;
+  float* split_re;   // exp(-2 pi i k / size), k = 0..size/2
+  float* split_im;
+  uint32_t* bitrev;  // size entries
+};
+
+ethervox_fft_t* ethervox_fft_create(uint32_t size) {
+  if (size < 4 || (size & (size - 1)) != 0) {
+    ETHERVOX_LOG_ERROR("FFT size must be a power of two >= 4, got %u", size);
+    return NULL;
+  }
+  ethervox_fft_t* fft = (ethervox_fft_t*)calloc(1, sizeof(*fft));
+  if (!fft) return NULL;
+  fft->size = size;
+  fft->tw_re = (float*)malloc(size * sizeof(float));
+  fft->tw_im = (float*)malloc(size * sizeof(float));
+  fft->split_re = (float*)malloc((size / 2 + 1) * sizeof(float));
+  fft->split_im = (float*)malloc((size / 2 + 1) * sizeof(float));
+  fft->bitrev = (uint32_t*)malloc(size * sizeof(uint32_t));
+  if (!fft->tw_re || !fft->tw_im || !fft->split_re || !fft->split_im || !fft->bitrev) {
+    ethervox_fft_destroy(fft);
+    return NULL;
+  }
+
+  fft->tw_re[0] = 1.0f;
+  fft->tw_im[0] = 0.0f;
+  for (uint32_t h = 1; h < size; h <<= 1) {
+    for (uint32_t k = 0; k < h; k++) {
+      double angle = -M_PI * (double)k / (double)h;
+      fft->tw_re[h + k] = (float)cos(angle);
+      fft->tw_im[h + k] = (float)sin(angle);
+    }
+  }
+  for (uint32_t k = 0; k <= size / 2; k++) {
+    double angle = -2.0 * M_PI * (double)k / (double)size;
+    fft->split_re[k] = (float)cos(angle);
+    fft->split_im[k] = (float)sin(angle);
+  }
+  uint32_t bits = 0;
+  while ((1u << bits) < size) bits++;
+  for (uint32_t i = 0; i < size; i++) {
+    uint32_t r = 0;
+    for (uint32_t j = 0; j < bits; j++) {
+      if (i & (1u << j)) r |= 1u << (bits - 1 - j);
+    }
+    fft->bitrev[i] = r;
+  }
+  return fft;
+}
+
+uint32_t ethervox_fft_size(const ethervox_fft_t* fft) {
+  return fft ? fft->size : 0;
+}
+
+// Forward transform of n = size / stride points, in place
+static void fft_run(const ethervox_fft_t* fft, float* re, float* im, uint32_t stride) {
+  const uint32_t n = fft->size / stride;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t j = fft->bitrev[i * stride];
+    if (j > i) {
+      float t = re[i]; re[i] = re[j]; re[j] = t;
+      t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+  }
+  const dsp_kernels_t* kernels = dsp();
+  for (uint32_t h = 1; h < n; h <<= 1) {
+    for (uint32_t start = 0; start < n; start += 2 * h) {
+      kernels->butterfly(re + start, im + start, re + start + h, im + start + h, fft->tw_re + h, fft->tw_im + h, h);
+    }
+  }
+}
+
+void ethervox_fft_complex(const ethervox_fft_t* fft, float* re, float* im, bool inverse) {
+  if (!fft || !re || !im) return;
+  // IFFT(x) = conj(FFT(conj(x))), up to the 1/N left to the caller
+  if (inverse) {
+    for (uint32_t i = 0; i < fft->size; i++) im[i] = -im[i];
+  }
+  fft_run(fft, re, im, 1);
+  if (inverse) {
+    for (uint32_t i = 0; i < fft->size; i++) im[i] = -im[i];
+  }
+}
+
+void ethervox_fft_real_forward(const ethervox_fft_t* fft, const float* in, float* re, float* im) {
+  if (!fft || !in || !re || !im) return;
+  // Even samples as the real part, odd as the imaginary part of an
+  // N/2-point complex transform Z
+  const uint32_t m = fft->size / 2;
+  for (uint32_t n = 0; n < m; n++) {
+    re[n] = in[2 * n];
+    im[n] = in[2 * n + 1];
+  }
+  fft_run(fft, re, im, 2);
+
+  // Split into even/odd sub-spectra, X[k] = E[k] + W^k O[k], with
+  // E = (Z[k] + conj Z[M-k]) / 2 and O = (Z[k] - conj Z[M-k]) / 2i. Bins k
+  // and M-k use the same two inputs, so they are done as a pair.
+  float z0 = re[0];
+  re[0] = z0 + im[0];
+  re[m] = z0 - im[0];
+  im[0] = 0.0f;
+  im[m] = 0.0f;
+  for (uint32_t k = 1; k <= m / 2; k++) {
+    uint32_t j = m - k;
+    float er = 0.5f * (re[k] + re[j]), ei = 0.5f * (im[k] - im[j]);
+    float or_ = 0.5f * (im[k] + im[j]), oi = -0.5f * (re[k] - re[j]);
+    // Bin j: E and O are the conjugates of bin k's
+    float tr = or_ * fft->split_re[k] - oi * fft->split_im[k];
+    float ti = or_ * fft->split_im[k] + oi * fft->split_re[k];
+    float ur = or_ * fft->split_re[j] + oi * fft->split_im[j];
+    float ui = or_ * fft->split_im[j] - oi * fft->split_re[j];
+    re[k] = er + tr;
+    im[k] = ei + ti;
+    if (j != k) {
+      re[j] = er + ur;
+      im[j] = -ei + ui;
+    }
+  }
+}
+
+void ethervox_fft_real_inverse(const ethervox_fft_t* fft, float* re, float* im, float* out) {
+  if (!fft || !re || !im || !out) return;
+  // Rebuild Z[k] = E[k] + i O[k] from bins k and M-k, with
+  // E = (X[k] + conj X[M-k]) / 2 and O = W^-k (X[k] - conj X[M-k]) / 2,
+  // stored conjugated so the forward transform computes the inverse
+  const uint32_t m = fft->size / 2;
+  for (uint32_t k = 0; k <= m / 2; k++) {
+    uint32_t j = m - k;
+    float xr = re[k], xi = im[k];
+    float cr = re[j], ci = -im[j];  // conj X[M-k]
+    float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+    float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+    float wr = fft->split_re[k], wi = -fft->split_im[k];
+    float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+    if (k > 0 && k < j) {
+      // Bin j: E is conj(E) and D is -conj(D) of bin k's
+      float vr = fft->split_re[j], vi = -fft->split_im[j];
+      float pr = -dr * vr - di * vi, pi = di * vr - dr * vi;
+      re[j] = er - pi;
+      im[j] = ei - pr;
+    }
+    re[k] = er - oi;
+    im[k] = -(ei + or_);
+  }
+  fft_run(fft, re, im, 2);
+
+  const float scale = 1.0f / (float)m;
+  for (uint32_t n = 0; n < m; n++) {
+    out[2 * n] = re[n] * scale;
+    out[2 * n + 1] = -im[n] * scale;
+  }
+}
+
+void ethervox_fft_destroy(ethervox_fft_t* fft) {
+  if (!fft) return;
+  free(fft->tw_re);
+  free(fft->tw_im);
+  free(fft->split_re);
+  free(fft->split_im);
+  free(fft->bitrev);
+  free(fft);
+}
@@ -0,0 +1,375 @@
+/**
+ * @file noise_reduction.c
+ * @brief Streaming STFT noise suppression (minimum statistics + Wiener gain)
+ *
+ * Per hop: window the last FFT-size samples with sqrt-Hann, take a real FFT
+ * (the shared one in dsp.c), update the noise estimate
+ * and gain for every bin, inverse transform, window again and overlap-add.
+ * sqrt-Hann at 50% overlap sums to one, so a gain of 1 reconstructs the
+ * input exactly, delayed by one FFT length.
+ *
+ * Noise: the periodogram is smoothed over time and its minimum tracked in
+ * NS_SUBWINDOWS sub-windows spanning the search window; the minimum times a
+ * bias factor is the noise power. Speech rarely keeps a bin busy for the
+ * whole window, so the floor stays on the background while people talk.
+ *
+ * Gain: decision-directed a priori SNR (Ephraim-Malah) fed to a Wiener
+ * filter, floored at min_gain.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/noise_reduction.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include "ethervox/logging.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NS_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NS_NEON 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define NS_MIN_FFT 64
+#define NS_MAX_FFT 4096
+#define NS_SUBWINDOWS 8          // Minimum-statistics sub-windows per search window
+#define NS_PSD_SMOOTHING 0.85f   // Periodogram smoothing over time
+#define NS_MINSTAT_BIAS 1.5f     // Minimum of a smoothed periodogram underestimates the mean
+#define NS_DD_ALPHA 0.98f        // Decision-directed weight of the previous clean estimate
+#define NS_XI_MIN 0.003f         // A priori SNR floor (-25 dB)
+#define NS_NOISE_EPS 1e-12f
+
+struct ethervox_ns {
+  ethervox_ns_config_t config;
+  uint32_t fft_size;   // N
+  uint32_t half;       // M = N / 2 (hop)
+  uint32_t bins;       // M + 1
+  uint32_t bins_pad;   // bins rounded up to the vector width
+  uint32_t frames_per_subwindow;
+
+  // Tables
+  float* window;       // sqrt-Hann, N
+  ethervox_fft_t* fft;
+
+  // Stream state
+  float* input;        // Last N input samples
+  float* ola;          // Overlap-add accumulator, N
+  float* output;       // Finished samples played out during the next hop, M
+  uint32_t fill;       // Input samples gathered toward the next hop
+
+  // Scratch
+  float* spec_re;      // Spectrum, bins_pad
+  float* spec_im;
+  float* frame;        // Time-domain frame, N
+
+  // Per-bin estimator state (bins_pad each)
+  float* psd;          // Smoothed periodogram
+  float* sub_min;      // Minimum within the current sub-window
+  float* win_min;      // Minimum over the finished sub-windows
+  float* sub_mins;     // NS_SUBWINDOWS x bins_pad ring of finished sub-window minima
+  float* clean_prev;   // |G Y|^2 of the previous frame
+  uint32_t sub_frame;  // Frames into the current sub-window
+  uint32_t sub_index;  // Next ring slot
+  bool primed;         // Estimator seeded from the first frame
+};
+
+// ============================================================================
+// Noise estimate and gain
+// ============================================================================
+
+/**
+ * Update the noise estimate from this frame's spectrum and apply the gain
+ * to it. Runs over bins_pad bins; padding bins hold zeros.
+ */
+static void apply_gain(ethervox_ns_t* ns) {
+  const uint32_t n = ns->bins_pad;
+  float* re = ns->spec_re;
+  float* im = ns->spec_im;
+  const float min_gain = ns->config.min_gain;
+  uint32_t k = 0;
+
+#if defined(NS_SSE2)
+  const __m128 smooth = _mm_set1_ps(NS_PSD_SMOOTHING);
+  const __m128 smooth_c = _mm_set1_ps(1.0f - NS_PSD_SMOOTHING);
+  const __m128 bias = _mm_set1_ps(NS_MINSTAT_BIAS);
+  const __m128 eps = _mm_set1_ps(NS_NOISE_EPS);
+  const __m128 alpha = _mm_set1_ps(NS_DD_ALPHA);
+  const __m128 alpha_c = _mm_set1_ps(1.0f - NS_DD_ALPHA);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 xi_min = _mm_set1_ps(NS_XI_MIN);
+  const __m128 g_min = _mm_set1_ps(min_gain);
+  for (; k + 4 <= n; k += 4) {
+    __m128 yr = _mm_loadu_ps(re + k);
+    __m128 yi = _mm_loadu_ps(im + k);
+    __m128 p = _mm_add_ps(_mm_mul_ps(yr, yr), _mm_mul_ps(yi, yi));
+    __m128 s = _mm_add_ps(_mm_mul_ps(smooth, _mm_loadu_ps(ns->psd + k)), _mm_mul_ps(smooth_c, p));
+    __m128 sub = _mm_min_ps(_mm_loadu_ps(ns->sub_min + k), s);
+    __m128 noise = _mm_max_ps(_mm_mul_ps(bias, _mm_min_ps(_mm_loadu_ps(ns->win_min + k), sub)), eps);
+    __m128 gamma = _mm_div_ps(p, noise);
+    __m128 xi = _mm_add_ps(_mm_mul_ps(alpha, _mm_div_ps(_mm_loadu_ps(ns->clean_prev + k), noise)),
+                           _mm_mul_ps(alpha_c, _mm_max_ps(_mm_sub_ps(gamma, one), zero)));
+    xi = _mm_max_ps(xi, xi_min);
+    __m128 g = _mm_max_ps(_mm_div_ps(xi, _mm_add_ps(one, xi)), g_min);
+    _mm_storeu_ps(ns->psd + k, s);
+    _mm_storeu_ps(ns->sub_min + k, sub);
+    _mm_storeu_ps(ns->clean_prev + k, _mm_mul_ps(_mm_mul_ps(g, g), p));
+    _mm_storeu_ps(re + k, _mm_mul_ps(yr, g));
+    _mm_storeu_ps(im + k, _mm_mul_ps(yi, g));
+  }
+#elif defined(NS_NEON)
+  const float32x4_t smooth = vdupq_n_f32(NS_PSD_SMOOTHING);
+  const float32x4_t smooth_c = vdupq_n_f32(1.0f - NS_PSD_SMOOTHING);
+  const float32x4_t bias = vdupq_n_f32(NS_MINSTAT_BIAS);
+  const float32x4_t eps = vdupq_n_f32(NS_NOISE_EPS);
+  const float32x4_t alpha = vdupq_n_f32(NS_DD_ALPHA);
+  const float32x4_t alpha_c = vdupq_n_f32(1.0f - NS_DD_ALPHA);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t xi_min = vdupq_n_f32(NS_XI_MIN);
+  const float32x4_t g_min = vdupq_n_f32(min_gain);
+  for (; k + 4 <= n; k += 4) {
+    float32x4_t yr = vld1q_f32(re + k);
+    float32x4_t yi = vld1q_f32(im + k);
+    float32x4_t p = vmlaq_f32(vmulq_f32(yr, yr), yi, yi);
+    float32x4_t s = vmlaq_f32(vmulq_f32(smooth_c, p), smooth, vld1q_f32(ns->psd + k));
+    float32x4_t sub = vminq_f32(vld1q_f32(ns->sub_min + k), s);
+    float32x4_t noise = vmaxq_f32(vmulq_f32(bias, vminq_f32(vld1q_f32(ns->win_min + k), sub)), eps);
+    // 1 / noise: estimate plus two Newton-Raphson steps (ARMv7 NEON has no divide)
+    float32x4_t inv = vrecpeq_f32(noise);
+    inv = vmulq_f32(inv, vrecpsq_f32(noise, inv));
+    inv = vmulq_f32(inv, vrecpsq_f32(noise, inv));
+    float32x4_t gamma = vmulq_f32(p, inv);
+    float32x4_t xi = vmlaq_f32(vmulq_f32(alpha_c, vmaxq_f32(vsubq_f32(gamma, one), zero)), alpha,
+                               vmulq_f32(vld1q_f32(ns->clean_prev + k), inv));
+    xi = vmaxq_f32(xi, xi_min);
+    float32x4_t den = vaddq_f32(one, xi);
+    float32x4_t inv_den = vrecpeq_f32(den);
+    inv_den = vmulq_f32(inv_den, vrecpsq_f32(den, inv_den));
+    inv_den = vmulq_f32(inv_den, vrecpsq_f32(den, inv_den));
+    float32x4_t g = vmaxq_f32(vmulq_f32(xi, inv_den), g_min);
+    vst1q_f32(ns->psd + k, s);
+    vst1q_f32(ns->sub_min + k, sub);
+    vst1q_f32(ns->clean_prev + k, vmulq_f32(vmulq_f32(g, g), p));
+    vst1q_f32(re + k, vmulq_f32(yr, g));
+    vst1q_f32(im + k, vmulq_f32(yi, g));
+  }
+#endif
+  for (; k < n; k++) {
+    float p = re[k] * re[k] + im[k] * im[k];
+    float s = NS_PSD_SMOOTHING * ns->psd[k] + (1.0f - NS_PSD_SMOOTHING) * p;
+    float sub = fminf(ns->sub_min[k], s);
+    float noise = fmaxf(NS_MINSTAT_BIAS * fminf(ns->win_min[k], sub), NS_NOISE_EPS);
+    float gamma = p / noise;
+    float xi = NS_DD_ALPHA * ns->clean_prev[k] / noise + (1.0f - NS_DD_ALPHA) * fmaxf(gamma - 1.0f, 0.0f);
+    xi = fmaxf(xi, NS_XI_MIN);
+    float g = fmaxf(xi / (1.0f + xi), min_gain);
+    ns->psd[k] = s;
+    ns->sub_min[k] = sub;
+    ns->clean_prev[k] = g * g * p;
+    re[k] *= g;
+    im[k] *= g;
+  }
+}
+
+/**
+ * Close the current sub-window: push its minimum into the ring, recompute
+ * the window minimum and start the next sub-window from the current PSD
+ */
+static void rotate_subwindow(ethervox_ns_t* ns) {
+  const uint32_t n = ns->bins_pad;
+  memcpy(ns->sub_mins + (size_t)ns->sub_index * n, ns->sub_min, n * sizeof(float));
+  ns->sub_index = (ns->sub_index + 1) % NS_SUBWINDOWS;
+
+  memcpy(ns->win_min, ns->sub_mins, n * sizeof(float));
+  for (uint32_t u = 1; u < NS_SUBWINDOWS; u++) {
+    const float* m = ns->sub_mins + (size_t)u * n;
+    for (uint32_t k = 0; k < n; k++) {
+      ns->win_min[k] = fminf(ns->win_min[k], m[k]);
+    }
+  }
+  memcpy(ns->sub_min, ns->psd, n * sizeof(float));
+}
+
+/**
+ * Seed the estimator from the first frame so the output starts attenuated
+ * rather than waiting a full search window
+ */
+static void prime(ethervox_ns_t* ns) {
+  const uint32_t n = ns->bins_pad;
+  for (uint32_t k = 0; k < n; k++) {
+    float p = ns->spec_re[k] * ns->spec_re[k] + ns->spec_im[k] * ns->spec_im[k];
+    ns->psd[k] = p;
+    ns->sub_min[k] = p;
+    ns->win_min[k] = p;
+    ns->clean_prev[k] = 0.0f;
+  }
+  for (uint32_t u = 0; u < NS_SUBWINDOWS; u++) {
+    memcpy(ns->sub_mins + (size_t)u * n, ns->psd, n * sizeof(float));
+  }
+  ns->primed = true;
+}
+
+static void process_hop(ethervox_ns_t* ns) {
+  const uint32_t n = ns->fft_size;
+  const uint32_t m = ns->half;
+
+  for (uint32_t i = 0; i < n; i++) ns->frame[i] = ns->input[i] * ns->window[i];
+  ethervox_fft_real_forward(ns->fft, ns->frame, ns->spec_re, ns->spec_im);
+  if (!ns->primed) prime(ns);
+  apply_gain(ns);
+  if (++ns->sub_frame >= ns->frames_per_subwindow) {
+    ns->sub_frame = 0;
+    rotate_subwindow(ns);
+  }
+  ethervox_fft_real_inverse(ns->fft, ns->spec_re, ns->spec_im, ns->frame);
+
+  for (uint32_t i = 0; i < n; i++) ns->ola[i] += ns->frame[i] * ns->window[i];
+  memcpy(ns->output, ns->ola, m * sizeof(float));
+  memmove(ns->ola, ns->ola + m, (n - m) * sizeof(float));
+  memset(ns->ola + n - m, 0, m * sizeof(float));
+  memmove(ns->input, ns->input + m, (n - m) * sizeof(float));
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+ethervox_ns_config_t ethervox_ns_get_default_config(void) {
+  ethervox_ns_config_t config = {.sample_rate = ETHERVOX_AUDIO_SAMPLE_RATE,
+                                 .frame_ms = ETHERVOX_NS_FRAME_MS,
+                                 .min_gain = ETHERVOX_NS_MIN_GAIN,
+                                 .noise_window_ms = ETHERVOX_NS_NOISE_WINDOW_MS};
+  return config;
+}
+
+ethervox_ns_t* ethervox_ns_create(const ethervox_ns_config_t* config) {
+  ethervox_ns_config_t cfg = config ? *config : ethervox_ns_get_default_config();
+  if (cfg.sample_rate == 0) cfg.sample_rate = ETHERVOX_AUDIO_SAMPLE_RATE;
+  if (cfg.min_gain < 0.0f || cfg.min_gain > 1.0f) {
+    ETHERVOX_LOG_ERROR("Noise suppression gain floor must be within 0-1 (got %.3f)", cfg.min_gain);
+    return NULL;
+  }
+
+  uint32_t fft_size = NS_MIN_FFT;
+  uint64_t window = (uint64_t)cfg.sample_rate * cfg.frame_ms / 1000;
+  while (fft_size < window && fft_size < NS_MAX_FFT) fft_size <<= 1;
+  if (window > NS_MAX_FFT) {
+    ETHERVOX_LOG_ERROR("Noise suppression window too long (%u ms at %u Hz)", cfg.frame_ms, cfg.sample_rate);
+    return NULL;
+  }
+
+  ethervox_ns_t* ns = (ethervox_ns_t*)calloc(1, sizeof(*ns));
+  if (!ns) return NULL;
+  ns->config = cfg;
+  ns->fft_size = fft_size;
+  ns->half = fft_size / 2;
+  ns->bins = ns->half + 1;
+  ns->bins_pad = (ns->bins + 3) & ~3u;
+
+  uint32_t hop_ms_x1000 = (uint32_t)((uint64_t)ns->half * 1000000 / cfg.sample_rate);
+  uint64_t window_frames = hop_ms_x1000 ? (uint64_t)cfg.noise_window_ms * 1000 / hop_ms_x1000 : 0;
+  ns->frames_per_subwindow = (uint32_t)(window_frames / NS_SUBWINDOWS);
+  if (ns->frames_per_subwindow == 0) ns->frames_per_subwindow = 1;
+
+  const uint32_t n = ns->fft_size, m = ns->half, b = ns->bins_pad;
+  ns->window = (float*)malloc(n * sizeof(float));
+  ns->fft = ethervox_fft_create(n);
+  ns->input = (float*)malloc(n * sizeof(float));
+  ns->ola = (float*)malloc(n * sizeof(float));
+  ns->output = (float*)malloc(m * sizeof(float));
+  ns->spec_re = (float*)calloc(b, sizeof(float));
+  ns->spec_im = (float*)calloc(b, sizeof(float));
+  ns->frame = (float*)malloc(n * sizeof(float));
+  ns->psd = (float*)malloc(b * sizeof(float));
+  ns->sub_min = (float*)malloc(b * sizeof(float));
+  ns->win_min = (float*)malloc(b * sizeof(float));
+  ns->sub_mins = (float*)malloc((size_t)NS_SUBWINDOWS * b * sizeof(float));
+  ns->clean_prev = (float*)malloc(b * sizeof(float));
+  if (!ns->window || !ns->fft || !ns->input || !ns->ola || !ns->output || !ns->spec_re || !ns->spec_im ||
+      !ns->frame || !ns->psd || !ns->sub_min || !ns->win_min || !ns->sub_mins || !ns->clean_prev) {
+    ethervox_ns_destroy(ns);
+    return NULL;
+  }
+
+  // Periodic sqrt-Hann: squared windows at 50% overlap sum to exactly one
+  for (uint32_t i = 0; i < n; i++) {
+    ns->window[i] = sqrtf(0.5f - 0.5f * cosf(2.0f * (float)M_PI * (float)i / (float)n));
+  }
+
+  ethervox_ns_reset(ns);
+  return ns;
+}
+
+void ethervox_ns_destroy(ethervox_ns_t* ns) {
+  if (!ns) return;
+  free(ns->window);
+  ethervox_fft_destroy(ns->fft);
+  free(ns->input);
+  free(ns->ola);
+  free(ns->output);
+  free(ns->spec_re);
+  free(ns->spec_im);
+  free(ns->frame);
+  free(ns->psd);
+  free(ns->sub_min);
+  free(ns->win_min);
+  free(ns->sub_mins);
+  free(ns->clean_prev);
+  free(ns);
+}
+
+void ethervox_ns_reset(ethervox_ns_t* ns) {
+  if (!ns) return;
+  memset(ns->input, 0, ns->fft_size * sizeof(float));
+  memset(ns->ola, 0, ns->fft_size * sizeof(float));
+  memset(ns->output, 0, ns->half * sizeof(float));
+  ns->fill = 0;
+  ns->sub_frame = 0;
+  ns->sub_index = 0;
+  ns->primed = false;
+}
+
+ethervox_result_t ethervox_ns_process(ethervox_ns_t* ns, float* samples, uint32_t count) {
+  ETHERVOX_CHECK_PTR(ns);
+  if (count == 0) return ETHERVOX_SUCCESS;
+  ETHERVOX_CHECK_PTR(samples);
+
+  const uint32_t m = ns->half;
+  float* tail = ns->input + (ns->fft_size - m);
+  uint32_t pos = 0;
+  while (pos < count) {
+    uint32_t n = m - ns->fill;
+    if (n > count - pos) n = count - pos;
+    memcpy(tail + ns->fill, samples + pos, n * sizeof(float));
+    memcpy(samples + pos, ns->output + ns->fill, n * sizeof(float));
+    ns->fill += n;
+    pos += n;
+    if (ns->fill == m) {
+      process_hop(ns);
+      ns->fill = 0;
+    }
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+uint32_t ethervox_ns_latency_samples(const ethervox_ns_t* ns) {
+  return ns ? ns->fft_size : 0;
+}
+
+uint32_t ethervox_ns_fft_size(const ethervox_ns_t* ns) {
+  return ns ? ns->fft_size : 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file vad.c
+ * @brief Streaming frame-level voice activity detection
+ *
+ * One pass per frame gathers energy, first-difference energy and zero
+ * crossings. The speech log-odds are the log RMS over the noise-floor
+ * threshold (ETHERVOX_VAD_SPEECH_RATIO x floor, at least ETHERVOX_VAD_MIN_RMS)
+ * plus a spectral tilt term: voiced speech keeps its energy in the low
+ * frequencies, while hiss and fans look like white noise (tilt ~1).
+ *
+ * The noise floor is seeded from the first frame, drops straight to any
+ * quieter frame and otherwise follows the background quickly through
+ * silence and slowly through speech. Loud frames with a white spectrum pull
+ * it up faster, so a new steady noise source stops reading as speech within
+ * a couple of seconds.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/vad.h"
+#include "ethervox/config.h"
+#include "ethervox/logging.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VAD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VAD_NEON 1
+#endif
+
+#define ENERGY_SLOPE 4.0f       // Log-odds per unit of ln(rms / threshold)
+#define TILT_PIVOT 0.6f         // Tilt that neither favours nor penalizes speech
+#define TILT_WEIGHT 1.5f        // Log-odds per unit of tilt below the pivot
+#define TILT_MAX 2.0f           // Tilt of a signal alternating every sample
+#define FLOOR_RATE_SILENCE 0.05f
+#define FLOOR_RATE_SPEECH 0.0005f
+#define FLOOR_RATE_FLAT 0.02f   // Voiced but noise-like frames (a fan switching on)
+#define FLAT_TILT 0.8f
+
+struct ethervox_vad {
+  ethervox_vad_config_t config;
+  uint32_t frame_samples;
+  uint32_t hangover_frames;
+
+  // Stream state
+  float* pending;          // Partial frame carried to the next call
+  uint32_t pending_count;
+  float prev_sample;       // Last sample of the previous frame (first difference)
+  float noise_floor;       // Background RMS (< 0 until the first frame)
+  uint32_t hangover_left;  // Frames is_speech stays set without a voiced frame
+  uint64_t frames_analyzed;
+
+  // Output of the last process call
+  ethervox_vad_frame_t* frames;
+  uint32_t frame_count;
+  uint32_t frame_capacity;
+};
+
+// ============================================================================
+// Feature kernel
+// ============================================================================
+
+/**
+ * Sum of squares, sum of squared first differences and zero crossings of a
+ * frame whose preceding sample is prev
+ */
+static void frame_sums(const float* x, uint32_t n, float prev, float* energy_out, float* diff_out,
+                       uint32_t* crossings_out) {
+  float energy = x[0] * x[0];
+  float diff = (x[0] - prev) * (x[0] - prev);
+  uint32_t crossings = x[0] * prev < 0.0f ? 1 : 0;
+  uint32_t i = 1;
+#if defined(VAD_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  __m128 acc_e = _mm_setzero_ps();
+  __m128 acc_d = _mm_setzero_ps();
+  __m128i acc_z = _mm_setzero_si128();
+  for (; i + 4 <= n; i += 4) {
+    __m128 cur = _mm_loadu_ps(x + i);
+    __m128 prv = _mm_loadu_ps(x + i - 1);
+    __m128 d = _mm_sub_ps(cur, prv);
+    acc_e = _mm_add_ps(acc_e, _mm_mul_ps(cur, cur));
+    acc_d = _mm_add_ps(acc_d, _mm_mul_ps(d, d));
+    // Sign change: the mask is all ones (-1) per crossing lane
+    acc_z = _mm_sub_epi32(acc_z, _mm_castps_si128(_mm_cmplt_ps(_mm_mul_ps(cur, prv), zero)));
+  }
+  float lanes[4];
+  int32_t zc[4];
+  _mm_storeu_ps(lanes, acc_e);
+  energy += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  _mm_storeu_ps(lanes, acc_d);
+  diff += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  _mm_storeu_si128((__m128i*)zc, acc_z);
+  crossings += (uint32_t)(zc[0] + zc[1] + zc[2] + zc[3]);
+#elif defined(VAD_NEON)
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  float32x4_t acc_e = vdupq_n_f32(0.0f);
+  float32x4_t acc_d = vdupq_n_f32(0.0f);
+  uint32x4_t acc_z = vdupq_n_u32(0);
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t cur = vld1q_f32(x + i);
+    float32x4_t prv = vld1q_f32(x + i - 1);
+    float32x4_t d = vsubq_f32(cur, prv);
+    acc_e = vmlaq_f32(acc_e, cur, cur);
+    acc_d = vmlaq_f32(acc_d, d, d);
+    acc_z = vsubq_u32(acc_z, vcltq_f32(vmulq_f32(cur, prv), zero));
+  }
+  float lanes[4];
+  uint32_t zc[4];
+  vst1q_f32(lanes, acc_e);
+  energy += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  vst1q_f32(lanes, acc_d);
+  diff += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  vst1q_u32(zc, acc_z);
+  crossings += zc[0] + zc[1] + zc[2] + zc[3];
+#endif
+  for (; i < n; i++) {
+    float d = x[i] - x[i - 1];
+    energy += x[i] * x[i];
+    diff += d * d;
+    if (x[i] * x[i - 1] < 0.0f) crossings++;
+  }
+  *energy_out = energy;
+  *diff_out = diff;
+  *crossings_out = crossings;
+}
+
+void ethervox_vad_frame_features(const float* samples, uint32_t count, float prev_sample,
+                                 ethervox_vad_frame_t* frame) {
+  if (!frame) return;
+  memset(frame, 0, sizeof(*frame));
+  frame->log_energy = -100.0f;
+  if (!samples || count == 0) return;
+
+  float energy, diff;
+  uint32_t crossings;
+  frame_sums(samples, count, prev_sample, &energy, &diff, &crossings);
+
+  float mean = energy / (float)count;
+  frame->rms = sqrtf(mean);
+  frame->log_energy = 10.0f * log10f(mean + 1e-10f);
+  frame->zcr = (float)crossings / (float)count;
+  frame->tilt = energy > 1e-12f ? diff / (2.0f * energy) : 0.0f;
+}
+
+// ============================================================================
+// Streaming detector
+// ============================================================================
+
+ethervox_vad_config_t ethervox_vad_get_default_config(void) {
+  ethervox_vad_config_t config = {.sample_rate = ETHERVOX_AUDIO_SAMPLE_RATE,
+                                  .frame_ms = ETHERVOX_VAD_FRAME_MS,
+                                  .speech_ratio = ETHERVOX_VAD_SPEECH_RATIO,
+                                  .min_rms = ETHERVOX_VAD_MIN_RMS,
+                                  .threshold = ETHERVOX_VAD_THRESHOLD,
+                                  .hangover_ms = ETHERVOX_VAD_HANGOVER_MS};
+  return config;
+}
+
+ethervox_vad_t* ethervox_vad_create(const ethervox_vad_config_t* config) {
+  ethervox_vad_config_t cfg = config ? *config : ethervox_vad_get_default_config();
+  if (cfg.frame_ms != 10 && cfg.frame_ms != 20 && cfg.frame_ms != 30) {
+    ETHERVOX_LOG_ERROR("VAD frame length must be 10, 20 or 30 ms (got %u)", cfg.frame_ms);
+    return NULL;
+  }
+  if (cfg.sample_rate == 0) cfg.sample_rate = ETHERVOX_AUDIO_SAMPLE_RATE;
+
+  ethervox_vad_t* vad = (ethervox_vad_t*)calloc(1, sizeof(*vad));
+  if (!vad) return NULL;
+  vad->config = cfg;
+  vad->frame_samples = cfg.sample_rate * cfg.frame_ms / 1000;
+  vad->hangover_frames = cfg.hangover_ms / cfg.frame_ms;
+  vad->pending = (float*)malloc(vad->frame_samples * sizeof(float));
+  if (!vad->pending) {
+    free(vad);
+    return NULL;
+  }
+  ethervox_vad_reset(vad);
+  return vad;
+}
+
+void ethervox_vad_destroy(ethervox_vad_t* vad) {
+  if (!vad) return;
+  free(vad->pending);
+  free(vad->frames);
+  free(vad);
+}
+
+void ethervox_vad_reset(ethervox_vad_t* vad) {
+  if (!vad) return;
+  vad->pending_count = 0;
+  vad->prev_sample = 0.0f;
+  vad->noise_floor = -1.0f;  // Unseeded
+  vad->hangover_left = 0;
+  vad->frame_count = 0;
+}
+
+uint32_t ethervox_vad_frame_samples(const ethervox_vad_t* vad) {
+  return vad ? vad->frame_samples : 0;
+}
+
+uint64_t ethervox_vad_frames_analyzed(const ethervox_vad_t* vad) {
+  return vad ? vad->frames_analyzed : 0;
+}
+
+/**
+ * Classify one full frame and append it to the output
+ */
+static void analyze_frame(ethervox_vad_t* vad, const float* x, uint32_t end_offset) {
+  ethervox_vad_frame_t* frame = &vad->frames[vad->frame_count++];
+  ethervox_vad_frame_features(x, vad->frame_samples, vad->prev_sample, frame);
+  vad->prev_sample = x[vad->frame_samples - 1];
+  vad->frames_analyzed++;
+
+  // Seed from the first frame and drop straight to any quieter frame, so a
+  // stream that opens mid-sentence recovers at the first pause
+  if (vad->noise_floor < 0.0f || frame->rms < vad->noise_floor) vad->noise_floor = frame->rms;
+
+  float threshold = vad->noise_floor * vad->config.speech_ratio;
+  if (threshold < vad->config.min_rms) threshold = vad->config.min_rms;
+  float tilt = frame->tilt < TILT_MAX ? frame->tilt : TILT_MAX;
+  float log_odds = ENERGY_SLOPE * logf((frame->rms + 1e-9f) / threshold) +
+                   TILT_WEIGHT * (TILT_PIVOT - tilt);
+  frame->probability = 1.0f / (1.0f + expf(-log_odds));
+  frame->voiced = frame->probability >= vad->config.threshold;
+
+  // Follow the background quickly through silence and slowly through speech,
+  // so a rising noise level cannot hold speech open forever
+  float rate = FLOOR_RATE_SILENCE;
+  if (frame->voiced) rate = frame->tilt > FLAT_TILT ? FLOOR_RATE_FLAT : FLOOR_RATE_SPEECH;
+  vad->noise_floor += rate * (frame->rms - vad->noise_floor);
+  frame->noise_floor = vad->noise_floor;
+
+  if (frame->voiced) {
+    vad->hangover_left = vad->hangover_frames;
+    frame->is_speech = true;
+  } else if (vad->hangover_left > 0) {
+    vad->hangover_left--;
+    frame->is_speech = true;
+  }
+  frame->end_offset = end_offset;
+  frame->length = vad->frame_samples;
+}
+
+ethervox_result_t ethervox_vad_process(ethervox_vad_t* vad, const float* samples, uint32_t count,
+                                       const ethervox_vad_frame_t** frames, uint32_t* frame_count) {
+  ETHERVOX_CHECK_PTR(vad);
+  ETHERVOX_CHECK_PTR(frames);
+  ETHERVOX_CHECK_PTR(frame_count);
+  if (count > 0) ETHERVOX_CHECK_PTR(samples);
+
+  const uint32_t n = vad->frame_samples;
+  uint32_t needed = (uint32_t)(((uint64_t)vad->pending_count + count) / n);
+  if (needed > vad->frame_capacity) {
+    ethervox_vad_frame_t* grown =
+        (ethervox_vad_frame_t*)realloc(vad->frames, needed * sizeof(ethervox_vad_frame_t));
+    if (!grown) return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    vad->frames = grown;
+    vad->frame_capacity = needed;
+  }
+  vad->frame_count = 0;
+
+  uint32_t pos = 0;
+  if (vad->pending_count > 0) {
+    uint32_t take = n - vad->pending_count;
+    if (take > count) take = count;
+    memcpy(vad->pending + vad->pending_count, samples, take * sizeof(float));
+    vad->pending_count += take;
+    pos = take;
+    if (vad->pending_count == n) {
+      analyze_frame(vad, vad->pending, pos);
+      vad->pending_count = 0;
+    }
+  }
+  for (; pos + n <= count; pos += n) {
+    analyze_frame(vad, samples + pos, pos + n);
+  }
+  if (pos < count) {
+    memcpy(vad->pending + vad->pending_count, samples + pos, (count - pos) * sizeof(float));
+    vad->pending_count += count - pos;
+  }
+
+  *frames = vad->frames;
+  *frame_count = vad->frame_count;
+  return ETHERVOX_SUCCESS;
+}
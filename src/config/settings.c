@@ -106,7 +106,7 @@ ethervox_persistent_settings_t ethervox_settings_get_defaults(void) {
     settings.aec.enabled = true;  // Enable AEC by default
     strncpy(settings.aec.backend, "speex", sizeof(settings.aec.backend) - 1);
     settings.aec.suppression_level = 0.5f;  // Moderate echo suppression
-    settings.aec.filter_length_ms = 64;     // 64ms echo tail (1024 samples @ 16kHz)
+    settings.aec.filter_length_ms = ETHERVOX_AEC_FILTER_MS;  // Echo tail after delay compensation
     
     // Wake word defaults
     strncpy(settings.wake_word.wake_phrase, "hey ethervox", sizeof(settings.wake_word.wake_phrase) - 1);
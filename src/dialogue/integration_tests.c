@@ -3,12 +3,12 @@
  * @brief Interactive /test command for validating major features
  *
  * Runs comprehensive tests on:
- * - Context window management (overflow, compression)
- * - Hash table indexing (tag_hash, id_hash)
- * - Adaptive memory (corrections, patterns)
- * - Memory search and retrieval
- * - Tool execution
- * - System prompt generation
+ * - Memory store basics, search and the interned tag index (per-tag bitmaps)
+ * - Adaptive memory (corrections, patterns) and system prompt generation
+ * - Memory export/import and archiving
+ * - Tag search and ID lookup timing
+ * - File append and unit conversion tools
+ * - Context cache summarization with the live LLM (llama.cpp builds)
  *
  * Copyright (c) 2024-2025 EthervoxAI Team
  * SPDX-License-Identifier: CC-BY-NC-SA-4.0
@@ -465,14 +465,14 @@ static void test_memory_export_import(void) {
     ethervox_memory_cleanup(&import_store);
 }
 
-// Test 6: Hash Table Performance (simulated)
+// Test 6: Tag index and ID lookup performance
 static void test_hash_table_performance(void) {
-    TEST_HEADER("Test 6: Hash Table Index Performance");
+    TEST_HEADER("Test 6: Tag Index and ID Lookup Performance");
     
     ethervox_memory_store_t store;
     ethervox_memory_init(&store, NULL, "/tmp");
     
-    TEST_INFO("Adding 50 memories with various tags for hash table testing");
+    TEST_INFO("Adding 50 memories with various tags for tag index testing");
     
     const char* tag_sets[][3] = {
         {"tech", "ai", "llm"},
@@ -537,11 +537,11 @@ static void test_hash_table_performance(void) {
     
     TEST_PASS("ID lookup completed in %.2f μs", lookup_time);
     
-    if (lookup_time < 100.0) {  // Should be very fast with hash table
+    if (lookup_time < 100.0) {  // 50 entries scan in well under this
         TEST_PASS("ID lookup is efficient (< 100 μs)");
         g_tests_passed++;
     } else {
-        TEST_INFO("ID lookup took %.2f μs (hash table may not be active yet)", lookup_time);
+        TEST_INFO("ID lookup took %.2f μs", lookup_time);
     }
     
     ethervox_memory_cleanup(&store);
@@ -15,8 +15,12 @@
 #include "ethervox/governor.h"
 #include "ethervox/stt.h"
 #include "ethervox/audio.h"
+#include "ethervox/audio_pipeline.h"
+#include "ethervox/audio_stream_player.h"
+#include "ethervox/dsp.h"
 #include "ethervox/tts.h"
 #include "ethervox/aec.h"
+#include "ethervox/audio_buffer.h"
 #include "ethervox/settings.h"
 
 #include <stdlib.h>
@@ -31,30 +35,6 @@
 extern ethervox_tts_context_t* g_global_tts;
 extern pthread_mutex_t g_tts_mutex;
 
-// Forward declaration for macOS audio state (platform-specific)
-#ifdef __APPLE__
-typedef struct {
-    void* capture_queue;
-    void* capture_buffers[3];
-    bool is_recording;
-    void* playback_queue;
-    void* playback_buffers[3];
-    bool is_playing;
-    int16_t* ring_buffer;
-    size_t ring_buffer_size;
-    size_t write_pos;
-    size_t read_pos;
-    pthread_mutex_t lock;
-    int16_t* playback_ring_buffer;
-    size_t playback_ring_buffer_size;
-    size_t playback_write_pos;
-    size_t playback_read_pos;
-    pthread_mutex_t playback_lock;
-    uint32_t sample_rate;
-    uint8_t channels;
-} macos_audio_state_t;
-#endif
-
 /**
  * @brief Internal conversation session structure
  */
@@ -82,6 +62,9 @@ struct ethervox_conversation_session {
     ethervox_audio_runtime_t audio_runtime;
     bool audio_initialized;
     
+    // Speaker output where the driver has no write_audio (Linux ALSA)
+    audio_stream_player_t* player;
+    
     // TTS runtime (Piper neural TTS)
     ethervox_tts_context_t* tts_context;
     bool tts_initialized;
@@ -90,6 +73,9 @@ struct ethervox_conversation_session {
     ethervox_aec_t* aec_context;
     bool aec_initialized;
     
+    // Capture -> AEC -> noise suppression -> VAD, drained by the conversation thread
+    ethervox_pipeline_t* front_end;
+    
     // Audio capture
     ethervox_audio_buffer_t* audio_buffer;
     bool audio_capture_active;
@@ -161,13 +147,8 @@ static int conversation_on_speak(const char* text, const char* language,
             ETHERVOX_LOG_INFO("TTS synthesized %zu samples at %dHz", 
                             tts_output.sample_count, tts_output.sample_rate);
             
-            // Set AEC reference buffer (must be called before playback)
-            if (session->aec_initialized && session->aec_context) {
-                ethervox_aec_set_reference(session->aec_context, 
-                                          tts_output.samples, 
-                                          tts_output.sample_count);
-                ETHERVOX_LOG_DEBUG("AEC reference buffer updated with TTS output");
-            }
+            // No AEC reference to set here: the playback driver (or the streaming
+            // player) writes what it actually plays, with playback timestamps, to the AEC's reference
             
             // Play the synthesized audio through speakers
             if (session->audio_initialized && session->audio_runtime.driver.write_audio) {
@@ -175,13 +156,7 @@ static int conversation_on_speak(const char* text, const char* language,
                 size_t byte_count = tts_output.sample_count * sizeof(int16_t);
                 int16_t* pcm_buffer = (int16_t*)malloc(byte_count);
                 if (pcm_buffer) {
-                    for (size_t i = 0; i < tts_output.sample_count; i++) {
-                        float sample = tts_output.samples[i];
-                        // Clamp and convert to int16
-                        if (sample > 1.0f) sample = 1.0f;
-                        if (sample < -1.0f) sample = -1.0f;
-                        pcm_buffer[i] = (int16_t)(sample * 32767.0f);
-                    }
+                    ethervox_dsp_float_to_s16(tts_output.samples, pcm_buffer, tts_output.sample_count);
                     
                     ethervox_audio_buffer_t playback_buffer = {
                         .data = (float*)pcm_buffer,  // Cast to float* to match struct type
@@ -197,10 +172,8 @@ static int conversation_on_speak(const char* text, const char* language,
                         
                         // ALWAYS wait for playback to finish before resuming listening
                         // This prevents microphone from capturing TTS echo/feedback
-#ifdef __APPLE__
-                        // macOS-specific playback synchronization
-                        macos_audio_state_t* state = (macos_audio_state_t*)session->audio_runtime.platform_data;
-                        if (state) {
+                        ethervox_audio_ring_t* playback_ring = session->audio_runtime.playback_ring;
+                        if (playback_ring) {
                             ETHERVOX_LOG_DEBUG("Waiting for audio playback to complete (allow_interrupt=%d)...", allow_interrupt);
                             
                             // Give the playback thread time to start consuming samples
@@ -208,17 +181,13 @@ static int conversation_on_speak(const char* text, const char* language,
                             
                             int poll_count = 0;
                             while (1) {
-                                pthread_mutex_lock(&state->playback_lock);
-                                bool is_empty = (state->playback_write_pos == state->playback_read_pos);
-                                size_t write_pos = state->playback_write_pos;
-                                size_t read_pos = state->playback_read_pos;
-                                pthread_mutex_unlock(&state->playback_lock);
+                                uint32_t queued = ethervox_audio_ring_available(playback_ring);
                                 
-                                if (poll_count % 50 == 0 && !is_empty) { // Log every 500ms while playing
-                                    ETHERVOX_LOG_DEBUG("Playback buffer: write=%zu read=%zu", write_pos, read_pos);
+                                if (poll_count % 50 == 0 && queued > 0) { // Log every 500ms while playing
+                                    ETHERVOX_LOG_DEBUG("Playback buffer: %u samples queued", queued);
                                 }
                                 
-                                if (is_empty) {
+                                if (queued == 0) {
                                     break;
                                 }
                                 
@@ -230,10 +199,8 @@ static int conversation_on_speak(const char* text, const char* language,
                                     
                                     if (should_stop) {
                                         ETHERVOX_LOG_INFO("Audio playback interrupted by user");
-                                        // Clear the playback buffer to stop audio immediately
-                                        pthread_mutex_lock(&state->playback_lock);
-                                        state->playback_write_pos = state->playback_read_pos;
-                                        pthread_mutex_unlock(&state->playback_lock);
+                                        // Drop the queued audio; the playback callback skips it on its next pull
+                                        ethervox_audio_ring_request_flush(playback_ring);
                                         break;
                                     }
                                 }
@@ -243,7 +210,6 @@ static int conversation_on_speak(const char* text, const char* language,
                             }
                             ETHERVOX_LOG_DEBUG("Audio playback completed");
                         }
-#endif
                     } else {
                         ETHERVOX_LOG_WARN("Audio playback failed: %d", play_result);
                     }
@@ -252,6 +218,18 @@ static int conversation_on_speak(const char* text, const char* language,
                 } else {
                     ETHERVOX_LOG_ERROR("Failed to allocate PCM buffer");
                 }
+            } else if (session->player && tts_output.sample_rate == 16000 && tts_output.channels == 1) {
+                // The player writes what it plays, with playback times, to the AEC reference;
+                // waiting for it keeps the microphone from hearing the reply as the next turn
+                ethervox_result_t play_result =
+                    audio_stream_player_write(session->player, tts_output.samples, tts_output.sample_count);
+                if (ethervox_is_success(play_result)) {
+                    ETHERVOX_LOG_INFO("Audio playback queued (%zu samples)", tts_output.sample_count);
+                    play_result = audio_stream_player_wait(session->player);
+                }
+                if (ethervox_is_error(play_result)) {
+                    ETHERVOX_LOG_WARN("Audio playback failed: %d", play_result);
+                }
             } else {
                 ETHERVOX_LOG_WARN("Audio playback not available");
             }
@@ -297,9 +275,21 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
         return ETHERVOX_ERROR_INVALID_ARGUMENT;  // Failure - no STT available
     }
     
+    if (!session->front_end) {
+        ETHERVOX_LOG_WARN("Microphone not initialized, cannot capture audio");
+        return ETHERVOX_ERROR_NOT_INITIALIZED;
+    }
+    
     // Start audio capture with timeout
+    if (ethervox_stt_start(&session->stt_runtime) != 0 ||
+        ethervox_is_error(ethervox_pipeline_start(session->front_end))) {
+        ethervox_stt_stop(&session->stt_runtime);
+        ETHERVOX_LOG_ERROR("[Listen Tool] Failed to start audio capture");
+        return ETHERVOX_ERROR_AUDIO_INIT;
+    }
     uint64_t start_time = get_time_ms();
-    ethervox_audio_buffer_t audio_chunk = {0};
+    float chunk_samples[1600];  // 100ms at 16kHz
+    ethervox_pipeline_block_t audio_chunk;
     
     // Use the existing STT system to capture and transcribe speech
     // This is the same flow used in the main conversation loop
@@ -307,25 +297,22 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
     fflush(stdout);
     
     // Accumulate audio until speech detected or timeout
-    ethervox_audio_buffer_t accumulated_audio = {0};
     bool speech_detected = false;
     int silence_frames = 0;
-    const int silence_threshold = 10;  // frames of silence before considering speech ended
+    const int silence_threshold = 10;  // 100ms chunks of silence before considering speech ended
     
     while ((get_time_ms() - start_time) < (uint64_t)timeout_ms) {
-        ethervox_result_t audio_result = ethervox_audio_read(&session->audio_runtime, &audio_chunk);
-        if (ethervox_is_error(audio_result) || audio_chunk.size == 0) {
+        ethervox_result_t audio_result = ethervox_pipeline_read(session->front_end, 0, chunk_samples, 1600, 100,
+                                                                &audio_chunk);
+        if (ethervox_is_error(audio_result)) {
             break;
         }
+        if (audio_chunk.audio.size == 0) {
+            continue;
+        }
         
-        // Check for voice activity using RMS energy
-        float energy = ethervox_audio_calculate_rms_energy(
-            audio_chunk.data, audio_chunk.size / sizeof(int16_t)
-        );
-        
-        // Use a reasonable default threshold (TODO: get from settings)
-        const float energy_threshold = 0.02f;
-        if (energy > energy_threshold) {
+        // The front end's VAD (with hangover) marks voiced chunks
+        if (audio_chunk.is_speech) {
             speech_detected = true;
             silence_frames = 0;
             printf(".");
@@ -333,7 +320,7 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
             
             // Process audio chunk through STT
             ethervox_stt_result_t stt_result;
-            ethervox_result_t stt_ret = ethervox_stt_process(&session->stt_runtime, &audio_chunk, &stt_result);
+            ethervox_result_t stt_ret = ethervox_stt_process(&session->stt_runtime, &audio_chunk.audio, &stt_result);
             if (ethervox_is_success(stt_ret) && stt_result.is_final && stt_result.text && strlen(stt_result.text) > 0) {
                 // Got final transcription
                 *user_input = strdup(stt_result.text);
@@ -349,7 +336,8 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
                 }
                 
                 printf(" [OK]\n");
-                ethervox_audio_buffer_free(&audio_chunk);
+                ethervox_pipeline_stop(session->front_end);
+                ethervox_stt_stop(&session->stt_runtime);
                 return ETHERVOX_SUCCESS;
             }
         } else if (speech_detected) {
@@ -373,14 +361,14 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
                         }
                     }
                 }
-                ethervox_audio_buffer_free(&audio_chunk);
+                ethervox_pipeline_stop(session->front_end);
+                ethervox_stt_stop(&session->stt_runtime);
                 return ETHERVOX_SUCCESS;
             }
         }
-        
-        ethervox_audio_buffer_free(&audio_chunk);
     }
     
+    ethervox_pipeline_stop(session->front_end);
     printf(" ⏱️\n");
     
     // Timeout reached - try to get partial transcription
@@ -394,6 +382,8 @@ static int conversation_on_listen(char** user_input, int timeout_ms,
         }
     }
     
+    ethervox_stt_stop(&session->stt_runtime);
+    
     ETHERVOX_LOG_INFO("Listen timeout reached after %dms", timeout_ms);
     return ETHERVOX_SUCCESS;  // Return 0 for success even on timeout
 }
@@ -455,9 +445,15 @@ static void* conversation_thread(void* arg) {
         audio_config.bits_per_sample = 16;
         audio_config.buffer_size = 4096;
         
-        if (ethervox_audio_register_platform_driver(&session->audio_runtime) == 0 &&
+        session->audio_runtime.config = audio_config;
+        
+        if (ethervox_audio_register_driver(&session->audio_runtime) == 0 &&
             session->audio_runtime.driver.init(&session->audio_runtime, &audio_config) == 0) {
             session->audio_initialized = true;
+            // Playback feeds the echo canceller's reference as it plays
+            if (session->aec_initialized && session->aec_context) {
+                session->audio_runtime.echo_reference = ethervox_aec_get_reference(session->aec_context);
+            }
             printf("[OK] Microphone ready\n");
         } else {
             printf("❌ Failed to initialize microphone\n");
@@ -465,26 +461,72 @@ static void* conversation_thread(void* arg) {
         }
     }
     
+    // Drivers without write_audio (Linux) speak through the streaming player,
+    // which feeds the same reference buffer as it plays
+    if (!session->audio_runtime.driver.write_audio && !session->player) {
+        session->player = audio_stream_player_create(16000, 1);
+        if (session->player) {
+            if (session->aec_initialized && session->aec_context) {
+                audio_stream_player_set_echo_reference(session->player,
+                                                       ethervox_aec_get_reference(session->aec_context));
+            }
+            if (ethervox_is_error(audio_stream_player_start(session->player))) {
+                ETHERVOX_LOG_WARN("Failed to start streaming playback; replies will be text only");
+                audio_stream_player_destroy(session->player);
+                session->player = NULL;
+            }
+        }
+    }
+    
+    // Front end on its own real-time capture thread; this thread only drains the
+    // tap, so a long Whisper decode cannot make the microphone overrun
+    if (!session->front_end) {
+        ethervox_pipeline_config_t pipeline_config = ethervox_pipeline_default_config(&session->audio_runtime);
+        pipeline_config.aec = session->aec_initialized ? session->aec_context : NULL;
+        ethervox_pipeline_sink_config_t tap = {.name = "conversation"};
+        if (ethervox_is_error(ethervox_pipeline_add_sink(&pipeline_config, &tap)) ||
+            ethervox_is_error(ethervox_pipeline_create(&pipeline_config, &session->front_end))) {
+            printf("❌ Failed to set up the audio front end\n");
+            return NULL;
+        }
+    }
+    
     if (!session->stt_initialized) {
-        printf("🗣️  Initializing speech recognition (Whisper)...\n");
         ethervox_stt_config_t stt_config = ethervox_stt_get_default_config();
         stt_config.sample_rate = 16000;
         stt_config.enable_partial_results = true;
         
-        // Use Whisper streaming (already compiled in)
-        stt_config.backend = ETHERVOX_STT_BACKEND_WHISPER;
-        
-        // Set Whisper model path
-        const char* home = getenv("HOME");
-        static char whisper_model_path[512];
-        if (home) {
-            snprintf(whisper_model_path, sizeof(whisper_model_path), 
-                     "%s/.ethervox/models/whisper/base.bin", home);
-            stt_config.model_path = whisper_model_path;
+        if (session->config.vosk.grammar) {
+            // Command mode: Vosk restricted to the tool trigger phrases
+            printf("🗣️  Initializing speech recognition (Vosk command mode)...\n");
+            stt_config.backend = ETHERVOX_STT_BACKEND_VOSK;
+            stt_config.model_path = session->config.vosk.model_path;  // NULL = default model
+            stt_config.grammar = session->config.vosk.grammar;
+        } else {
+            // Use Whisper streaming (already compiled in)
+            printf("🗣️  Initializing speech recognition (Whisper)...\n");
+            stt_config.backend = ETHERVOX_STT_BACKEND_WHISPER;
+            
+            // Set Whisper model path: reuse the model dictation already has in
+            // memory (shared through the STT model registry), else base.bin
+            const char* home = getenv("HOME");
+            static char whisper_model_path[512];
+            if (ethervox_stt_model_find_loaded(ethervox_stt_whisper_load_model, whisper_model_path,
+                                               sizeof(whisper_model_path))) {
+                printf("   Reusing loaded model: %s\n", whisper_model_path);
+                stt_config.model_path = whisper_model_path;
+            } else if (home) {
+                snprintf(whisper_model_path, sizeof(whisper_model_path), 
+                         "%s/.ethervox/models/whisper/base.bin", home);
+                stt_config.model_path = whisper_model_path;
+            }
         }
         
         if (ethervox_stt_init(&session->stt_runtime, &stt_config) == 0) {
             session->stt_initialized = true;
+            ethervox_stt_set_partial_callback(&session->stt_runtime,
+                                              session->config.on_partial_transcript,
+                                              session->config.transcript_user_data);
             printf("[OK] Speech recognition ready\n");
         } else {
             printf("❌ Failed to initialize speech recognition\n");
@@ -544,7 +586,7 @@ static void* conversation_thread(void* arg) {
             continue;
         }
         
-        if (session->audio_runtime.driver.start_capture(&session->audio_runtime) != 0) {
+        if (ethervox_is_error(ethervox_pipeline_start(session->front_end))) {
             ETHERVOX_LOG_ERROR("Failed to start audio capture");
             ethervox_stt_stop(&session->stt_runtime);
             pthread_mutex_lock(&session->mutex);
@@ -557,54 +599,24 @@ static void* conversation_thread(void* arg) {
         // Streaming audio capture: continuously feed to Whisper
         uint64_t listen_start = get_time_ms();
         
+        float chunk_samples[1600];  // 100ms at 16kHz
+        
         while (!speech_detected && !session->thread_should_exit) {
-            ethervox_audio_buffer_t audio_chunk;
-            audio_chunk.size = 1600;  // 100ms at 16kHz
-            audio_chunk.channels = 1;
-            audio_chunk.data = (float*)calloc(audio_chunk.size, sizeof(float));
-            
-            if (!audio_chunk.data) {
+            // Echo-cancelled, denoised audio from the front end
+            ethervox_pipeline_block_t audio_chunk;
+            ethervox_result_t read_result = ethervox_pipeline_read(session->front_end, 0, chunk_samples, 1600, 100,
+                                                                   &audio_chunk);
+            if (ethervox_is_error(read_result)) {
+                ETHERVOX_LOG_ERROR("Audio capture stopped: %d", read_result);
                 break;
             }
-            
-            ethervox_result_t read_result = session->audio_runtime.driver.read_audio(&session->audio_runtime, &audio_chunk);
-            if (ethervox_is_error(read_result) || audio_chunk.size == 0) {
-                free(audio_chunk.data);
-                usleep(10000);  // Wait and try again
-                continue;
-            }
-            
-            int samples_read = (int)audio_chunk.size;
-            
-            // Apply AEC to remove speaker output from microphone input
-            // AEC requires 10ms frames (160 samples at 16kHz), so process in chunks
-            if (session->aec_initialized && session->aec_context) {
-                const size_t aec_frame_size = 160;  // 10ms at 16kHz
-                size_t offset = 0;
-                
-                while (offset < samples_read) {
-                    size_t frame_samples = (offset + aec_frame_size <= samples_read) ? 
-                                          aec_frame_size : (samples_read - offset);
-                    
-                    // Only process full frames (AEC needs exact frame size)
-                    if (frame_samples == aec_frame_size) {
-                        ethervox_result_t aec_result = ethervox_aec_process(session->aec_context, 
-                                                              audio_chunk.data + offset, 
-                                                              frame_samples);
-                        if (ethervox_is_error(aec_result)) {
-                            ETHERVOX_LOG_WARN("AEC processing failed at offset %zu: %d", offset, aec_result);
-                            break;  // Stop processing on error
-                        }
-                    }
-                    // else: partial frame at end, skip AEC (will be processed with next chunk)
-                    
-                    offset += frame_samples;
-                }
+            if (audio_chunk.audio.size == 0) {
+                continue;  // Nothing captured within 100ms; check for exit and try again
             }
             
             // Feed all audio to Whisper - let it decide on VAD and boundaries
             ethervox_stt_result_t stt_result = {0};
-            ethervox_result_t stt_ret = ethervox_stt_process(&session->stt_runtime, &audio_chunk, &stt_result);
+            ethervox_result_t stt_ret = ethervox_stt_process(&session->stt_runtime, &audio_chunk.audio, &stt_result);
             
             // Check for results (Whisper returns is_final when it detects sentence boundary)
             if (ethervox_is_success(stt_ret) && stt_result.text && strlen(stt_result.text) > 3) {
@@ -640,19 +652,15 @@ static void* conversation_thread(void* arg) {
                 ethervox_stt_result_free(&stt_result);
             }
             
-            free(audio_chunk.data);
-            
             // Timeout check (30 seconds max)
             if (get_time_ms() - listen_start > 30000) {
                 printf("\r⏱️  Timeout\n");
                 break;
             }
-            
-            usleep(10000);  // 10ms sleep
         }
         
         ethervox_stt_stop(&session->stt_runtime);
-        session->audio_runtime.driver.stop_capture(&session->audio_runtime);
+        ethervox_pipeline_stop(session->front_end);
         
         pthread_mutex_lock(&session->mutex);
         
@@ -902,12 +910,11 @@ ethervox_conversation_session_t* ethervox_conversation_init(
     session->aec_context = NULL;
     
     if (settings_loaded && settings.aec.enabled && strcmp(settings.aec.backend, "speex") == 0) {
-        ethervox_aec_config_t aec_config = {
-            .sample_rate = 16000,
-            .frame_size = 160,  // 10ms frames at 16kHz
-            .filter_length = settings.aec.filter_length_ms,
-            .suppression_level = settings.aec.suppression_level
-        };
+        ethervox_aec_config_t aec_config = ethervox_aec_default_config();
+        aec_config.sample_rate = 16000;
+        aec_config.frame_size = 160;  // 10ms frames at 16kHz
+        aec_config.filter_length = settings.aec.filter_length_ms * 16;  // ms -> samples at 16kHz
+        aec_config.suppression_level = settings.aec.suppression_level;
         
         session->aec_context = ethervox_aec_create(&aec_config);
         if (session->aec_context) {
@@ -1075,8 +1082,20 @@ void ethervox_conversation_cleanup(ethervox_conversation_session_t* session) {
         session->tts_initialized = false;
     }
     
-    // Cleanup AEC context
+    // The front end borrows the AEC, so it goes first
+    ethervox_pipeline_destroy(session->front_end);
+    session->front_end = NULL;
+    
+    // The player writes the AEC's reference too
+    audio_stream_player_destroy(session->player);
+    session->player = NULL;
+    
+    // Cleanup AEC context (stop playback first: its callback writes the AEC's reference)
     if (session->aec_initialized && session->aec_context) {
+        if (session->audio_initialized && session->audio_runtime.driver.stop_playback) {
+            session->audio_runtime.driver.stop_playback(&session->audio_runtime);
+        }
+        session->audio_runtime.echo_reference = NULL;
         ethervox_aec_destroy(session->aec_context);
         session->aec_context = NULL;
         session->aec_initialized = false;
@@ -1141,3 +1160,13 @@ void* ethervox_conversation_get_stt(ethervox_conversation_session_t* session) {
     }
     return &session->stt_runtime;
 }
+
+/**
+ * Get AEC context from conversation session
+ */
+void* ethervox_conversation_get_aec(ethervox_conversation_session_t* session) {
+    if (!session || !session->aec_initialized) {
+        return NULL;
+    }
+    return session->aec_context;
+}
@@ -16,6 +16,8 @@
 #include "ethervox/error.h"
 #include "ethervox/pronunciation_trainer.h"
 #include "ethervox/audio_recording.h"
+#include "ethervox/dsp.h"
+#include "ethervox/vad.h"
 #include "../tts/phonemizer/phonemizer.h"
 #include "../tts/phonemizer/pronunciation_overrides.h"
 #include <stdio.h>
@@ -136,43 +138,46 @@ static char* generate_training_phrase(ethervox_governor_t* governor, const char*
 }
 
 /**
- * Trim silence from audio using simple energy-based VAD
+ * Trim silence from audio using the shared VAD (10ms frames; the hangover
+ * keeps soft word endings)
  */
 static int trim_silence(float* audio, int n_samples, int* start_idx, int* end_idx) {
-    const float silence_threshold = 0.01f; // RMS threshold for silence
-    const int frame_size = 160; // 10ms frames at 16kHz
-    
-    // Find start of speech
     *start_idx = 0;
-    for (int i = 0; i < n_samples - frame_size; i += frame_size) {
-        float rms = 0.0f;
-        for (int j = 0; j < frame_size; j++) {
-            rms += audio[i + j] * audio[i + j];
-        }
-        rms = sqrtf(rms / frame_size);
-        
-        if (rms > silence_threshold) {
-            *start_idx = (i > frame_size) ? (i - frame_size) : 0; // Include one frame before
-            break;
-        }
+    *end_idx = n_samples - 1;
+    if (n_samples <= 0) {
+        return ETHERVOX_SUCCESS;
     }
     
-    // Find end of speech
-    *end_idx = n_samples - 1;
-    for (int i = n_samples - frame_size; i >= 0; i -= frame_size) {
-        float rms = 0.0f;
-        for (int j = 0; j < frame_size; j++) {
-            rms += audio[i + j] * audio[i + j];
+    ethervox_vad_config_t config = ethervox_vad_get_default_config();
+    config.frame_ms = 10;
+    ethervox_vad_t* vad = ethervox_vad_create(&config);
+    if (!vad) {
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    
+    const ethervox_vad_frame_t* frames = NULL;
+    uint32_t frame_count = 0;
+    ethervox_result_t result = ethervox_vad_process(vad, audio, (uint32_t)n_samples, &frames, &frame_count);
+    if (result == ETHERVOX_SUCCESS) {
+        const int frame_size = (int)ethervox_vad_frame_samples(vad);
+        int first = -1;
+        int last = -1;
+        for (uint32_t i = 0; i < frame_count; i++) {
+            if (frames[i].is_speech) {
+                if (first < 0) first = (int)i;
+                last = (int)i;
+            }
         }
-        rms = sqrtf(rms / frame_size);
         
-        if (rms > silence_threshold) {
-            *end_idx = (i + frame_size * 2 < n_samples) ? (i + frame_size * 2) : n_samples - 1;
-            break;
+        if (first >= 0) {
+            *start_idx = (first > 0) ? (first - 1) * frame_size : 0; // Include one frame before
+            int end = (last + 1) * frame_size - 1;
+            *end_idx = (end < n_samples) ? end : n_samples - 1;
         }
     }
     
-    return ETHERVOX_SUCCESS;
+    ethervox_vad_destroy(vad);
+    return result;
 }
 
 /**
@@ -210,10 +215,7 @@ static int record_user_audio(const char* output_path, int duration_seconds) {
     int n_samples = data_size / sizeof(int16_t);
     float* float_data = (float*)malloc(n_samples * sizeof(float));
     
-    // Convert to float
-    for (int i = 0; i < n_samples; i++) {
-        float_data[i] = pcm_data[i] / 32768.0f;
-    }
+    ethervox_dsp_s16_to_float(pcm_data, float_data, (size_t)n_samples);
     
     // Trim silence
     int start_idx, end_idx;
@@ -26,6 +26,7 @@
 #include "ethervox/error.h"
 #include "ethervox/kv_cache_persistence.h"  // KV cache save/load for fast startup
 #include "ethervox/tool_manifest.h"   // Manifest system for optimized prompts
+#include "ethervox/tool_args.h"       // Shared JSON tokenizer for tool calls
 
 #ifdef _WIN32
 #include <malloc.h>  // For alloca on Windows
@@ -1108,57 +1109,18 @@ static char* parse_attribute(const char* tag, const char* attr_name) {
 }
 
 /**
- * Execute a single tool call (JSON format for Granite 4.0)
- * Input: JSON string like {"name": "calculator_compute", "arguments": {"expression": "17*23"}}
- * Extracts name and arguments, calls tool
+ * Execute a tokenized tool call; call->tokens stay valid until it returns
  */
-static int execute_tool_call_json(const char* tool_call_json, ethervox_tool_registry_t* registry,
-                                  char** result, char** error) {
-  if (!tool_call_json || !registry || !result || !error) {
-    if (error)
-      *error = strdup("Invalid parameters passed to execute_tool_call_json");
-    return ETHERVOX_ERROR_INVALID_ARGUMENT;
-  }
-
-  // Simple JSON parsing - find "name" field
-  const char* name_start = strstr(tool_call_json, "\"name\"");
-  if (!name_start) {
+static int execute_parsed_tool_call(const ethervox_tool_args_t* call,
+                                    ethervox_tool_registry_t* registry, char** result,
+                                    char** error) {
+  char tool_name[sizeof(((ethervox_tool_t*)0)->name)];
+  if (ethervox_tool_args_type(call, "name") != ETHERVOX_JSON_STRING ||
+      !ethervox_tool_args_get_string(call, "name", tool_name, sizeof(tool_name))) {
     *error = strdup("Missing 'name' field in JSON tool call");
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
 
-  // Find the value after "name":
-  const char* name_value_start = strchr(name_start, ':');
-  if (!name_value_start) {
-    *error = strdup("Malformed 'name' field in JSON tool call");
-    return ETHERVOX_ERROR_INVALID_ARGUMENT;
-  }
-  name_value_start++;
-
-  // Skip whitespace and opening quote
-  while (*name_value_start == ' ' || *name_value_start == '\t' || *name_value_start == '\n') {
-    name_value_start++;
-  }
-  if (*name_value_start == '"')
-    name_value_start++;
-
-  // Find end quote
-  const char* name_value_end = strchr(name_value_start, '"');
-  if (!name_value_end) {
-    *error = strdup("Malformed 'name' value in JSON tool call");
-    return ETHERVOX_ERROR_INVALID_ARGUMENT;
-  }
-
-  // Extract tool name
-  size_t name_len = name_value_end - name_value_start;
-  char* tool_name = malloc(name_len + 1);
-  if (!tool_name) {
-    *error = strdup("Memory allocation failed for tool name");
-    return ETHERVOX_ERROR_INVALID_ARGUMENT;
-  }
-  strncpy(tool_name, name_value_start, name_len);
-  tool_name[name_len] = '\0';
-
   // DEBUG: List all registered tools
   GOV_LOG("Looking for tool '%s' in registry with %u tools:", tool_name, registry->tool_count);
   for (uint32_t i = 0; i < registry->tool_count; i++) {
@@ -1171,121 +1133,44 @@ static int execute_tool_call_json(const char* tool_call_json, ethervox_tool_regi
     char err_msg[256];
     snprintf(err_msg, sizeof(err_msg), "Unknown tool: %s", tool_name);
     *error = strdup(err_msg);
-    free(tool_name);
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
 
-  // Find "arguments" field
-  const char* args_start = strstr(tool_call_json, "\"arguments\"");
-  char json_input[65536] = "{}";  // Default empty object
-
-  if (args_start) {
-    const char* args_value_start = strchr(args_start, ':');
-    if (args_value_start) {
-      args_value_start++;
-
-      // Skip whitespace
-      while (*args_value_start == ' ' || *args_value_start == '\t' || *args_value_start == '\n') {
-        args_value_start++;
-      }
-
-      // Handle two formats:
-      // 1. Object: "arguments": {"location": "..."}  (correct Granite format)
-      // 2. String: "arguments": "{\"location\": \"...\"}" (model sometimes generates this)
-      
-      if (*args_value_start == '"') {
-        // Format 2: Arguments as JSON string - extract the string content
-        args_value_start++; // Skip opening quote
-        
-        // Find the closing quote (handle escaped quotes)
-        const char* p = args_value_start;
-        const char* args_end = NULL;
-        while (*p) {
-          if (*p == '\\' && *(p + 1) == '"') {
-            p += 2;  // Skip escaped quote
-            continue;
-          }
-          if (*p == '"') {
-            args_end = p;
-            break;
-          }
-          p++;
-        }
-        
-        if (args_end) {
-          // Copy the string content and unescape it
-          size_t args_len = args_end - args_value_start;
-          if (args_len < sizeof(json_input)) {
-            size_t dst_idx = 0;
-            const char* src = args_value_start;
-            while (src < args_end && dst_idx < sizeof(json_input) - 1) {
-              if (*src == '\\' && src + 1 < args_end) {
-                // Handle escape sequences
-                src++;
-                switch (*src) {
-                  case 'n':  json_input[dst_idx++] = '\n'; break;
-                  case 't':  json_input[dst_idx++] = '\t'; break;
-                  case 'r':  json_input[dst_idx++] = '\r'; break;
-                  case '"':  json_input[dst_idx++] = '"';  break;
-                  case '\\': json_input[dst_idx++] = '\\'; break;
-                  default:   json_input[dst_idx++] = *src; break;
-                }
-                src++;
-              } else {
-                json_input[dst_idx++] = *src++;
-              }
-            }
-            json_input[dst_idx] = '\0';
-            GOV_LOG("Extracted arguments from JSON string format: %s", json_input);
-          }
-        }
-      } else if (*args_value_start == '{') {
-        // Format 1: Arguments as JSON object (correct format)
-        int brace_count = 0;
-        const char* p = args_value_start;
-        const char* args_end = NULL;
-
-        // Find matching closing brace
-        while (*p) {
-          if (*p == '{')
-            brace_count++;
-          else if (*p == '}') {
-            brace_count--;
-            if (brace_count == 0) {
-              args_end = p + 1;
-              break;
-            }
-          }
-          p++;
-        }
-
-        if (args_end) {
-          size_t args_len = args_end - args_value_start;
-          if (args_len < sizeof(json_input)) {
-            strncpy(json_input, args_value_start, args_len);
-            json_input[args_len] = '\0';
-            GOV_LOG("Extracted arguments from JSON object format: %s", json_input);
-          }
-        }
-      }
-    }
-  }
-
-  GOV_LOG("Executing tool '%s' with JSON: %s", tool->name, json_input);
-
-  free(tool_name);
-
   // Safety checks before execution
   if (!tool->execute) {
     *error = strdup("Tool has NULL execute pointer");
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
 
-  if (!result || !error) {
-    GOV_ERROR("Invalid result or error pointers passed to execute_tool_call_json");
-    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  // Handle two formats:
+  // 1. Object: "arguments": {"location": "..."}  (correct Granite format)
+  // 2. String: "arguments": "{\"location\": \"...\"}" (model sometimes generates this)
+  char json_input[65536] = "{}";  // Default empty object
+  ethervox_tool_args_t arguments;
+  bool have_arguments = false;
+
+  switch (ethervox_tool_args_type(call, "arguments")) {
+    case ETHERVOX_JSON_OBJECT:
+      have_arguments = ethervox_tool_args_object(call, "arguments", json_input, sizeof(json_input),
+                                                 &arguments) == ETHERVOX_SUCCESS;
+      if (have_arguments) {
+        GOV_LOG("Extracted arguments from JSON object format: %s", json_input);
+      } else {
+        snprintf(json_input, sizeof(json_input), "{}");
+      }
+      break;
+    case ETHERVOX_JSON_STRING:
+      ethervox_tool_args_get_string(call, "arguments", json_input, sizeof(json_input));
+      GOV_LOG("Extracted arguments from JSON string format: %s", json_input);
+      have_arguments =
+          ethervox_tool_args_parse_growable(&arguments, json_input) == ETHERVOX_SUCCESS;
+      break;
+    default:
+      break;
   }
 
+  GOV_LOG("Executing tool '%s' with JSON: %s", tool->name, json_input);
+
   // Resource checks for audio tools (speak/listen)
   // Note: The tools themselves handle graceful degradation, but we can provide
   // better error messages here if execution context indicates resources unavailable
@@ -1294,8 +1179,13 @@ static int execute_tool_call_json(const char* tool_call_json, ethervox_tool_regi
             tool->name);
   }
 
-  // Execute the tool
+  // Execute the tool; wrappers that parse json_input reuse the tokens above
+  ethervox_tool_args_publish(have_arguments ? &arguments : NULL);
   int exec_result = tool->execute(json_input, result, error);
+  ethervox_tool_args_publish(NULL);
+  if (have_arguments) {
+    ethervox_tool_args_release(&arguments);
+  }
 
   if (exec_result != 0) {
     if (!*error) {
@@ -1313,6 +1203,36 @@ static int execute_tool_call_json(const char* tool_call_json, ethervox_tool_regi
   return ETHERVOX_SUCCESS;
 }
 
+/**
+ * Execute a single tool call (JSON format for Granite 4.0)
+ * Input: JSON string like {"name": "calculator_compute", "arguments": {"expression": "17*23"}}
+ * Extracts name and arguments, calls tool
+ */
+static int execute_tool_call_json(const char* tool_call_json, ethervox_tool_registry_t* registry,
+                                  char** result, char** error) {
+  if (!tool_call_json || !registry || !result || !error) {
+    if (error)
+      *error = strdup("Invalid parameters passed to execute_tool_call_json");
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  // Tokenize the call once; the "arguments" view is handed on to the tool.
+  // Large calls (long ID or tag arrays) spill their tokens to the heap.
+  // Truncated model output is rejected rather than guessed at.
+  ethervox_tool_args_t call;
+  ethervox_result_t parse_result = ethervox_tool_args_parse_growable(&call, tool_call_json);
+  if (parse_result != ETHERVOX_SUCCESS) {
+    *error = strdup(parse_result == ETHERVOX_ERROR_OUT_OF_MEMORY
+                        ? "Out of memory parsing JSON tool call"
+                        : "Malformed or truncated JSON tool call");
+    return parse_result;
+  }
+
+  int status = execute_parsed_tool_call(&call, registry, result, error);
+  ethervox_tool_args_release(&call);
+  return status;
+}
+
 /**
  * Execute a single tool call (XML attribute format)
  * Parses the XML tag, extracts attributes, builds JSON, calls tool
@@ -0,0 +1,762 @@
+/**
+ * @file tool_args.c
+ * @brief Zero-allocation JSON tokenizer and typed accessors for tool arguments
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/tool_args.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// View published by the governor for the tool call running on this thread
+#if defined(_MSC_VER)
+static __declspec(thread) const ethervox_tool_args_t* g_published_args = NULL;
+#elif defined(__GNUC__) || defined(__clang__)
+static __thread const ethervox_tool_args_t* g_published_args = NULL;
+#else
+static const ethervox_tool_args_t* g_published_args = NULL;
+#endif
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+static bool is_json_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_primitive_end(char c) {
+  return is_json_space(c) || c == ',' || c == ':' || c == ']' || c == '}';
+}
+
+ethervox_result_t ethervox_json_tokenize(const char* json, size_t length,
+                                         ethervox_json_token_t* tokens, uint32_t max_tokens,
+                                         uint32_t* token_count) {
+  if (!json || !tokens || !token_count || length > INT32_MAX) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  uint32_t stack[ETHERVOX_TOOL_ARGS_MAX_DEPTH];
+  uint32_t depth = 0;
+  uint32_t count = 0;
+  size_t pos = 0;
+  *token_count = 0;
+
+  while (pos < length) {
+    char c = json[pos];
+
+    if (is_json_space(c) || c == ',' || c == ':') {
+      pos++;
+      continue;
+    }
+
+    if (c == '}' || c == ']') {
+      ethervox_json_type_t closing = (c == '}') ? ETHERVOX_JSON_OBJECT : ETHERVOX_JSON_ARRAY;
+      if (depth == 0 || tokens[stack[depth - 1]].type != closing) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+      }
+      tokens[stack[--depth]].end = (int32_t)(pos + 1);
+      pos++;
+      if (depth == 0) {
+        break;  // Root value complete
+      }
+      continue;
+    }
+
+    if (count >= max_tokens) {
+      return ETHERVOX_ERROR_BUFFER_TOO_SMALL;
+    }
+    ethervox_json_token_t* tok = &tokens[count];
+    tok->size = 0;
+    if (depth > 0) {
+      tokens[stack[depth - 1]].size++;
+    }
+
+    if (c == '{' || c == '[') {
+      if (depth >= ETHERVOX_TOOL_ARGS_MAX_DEPTH) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+      }
+      tok->type = (c == '{') ? ETHERVOX_JSON_OBJECT : ETHERVOX_JSON_ARRAY;
+      tok->start = (int32_t)pos;
+      tok->end = -1;
+      stack[depth++] = count++;
+      pos++;
+      continue;
+    }
+
+    if (c == '"') {
+      size_t start = ++pos;
+      while (pos < length && json[pos] != '"') {
+        if (json[pos] == '\\' && pos + 1 < length) {
+          pos++;
+        }
+        pos++;
+      }
+      if (pos >= length) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;  // Unterminated string
+      }
+      tok->type = ETHERVOX_JSON_STRING;
+      tok->start = (int32_t)start;
+      tok->end = (int32_t)pos;
+      count++;
+      pos++;  // Closing quote
+    } else {
+      size_t start = pos;
+      while (pos < length && json[pos] != '\0' && !is_primitive_end(json[pos])) {
+        pos++;
+      }
+      if (pos == start) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+      }
+      tok->type = ETHERVOX_JSON_PRIMITIVE;
+      tok->start = (int32_t)start;
+      tok->end = (int32_t)pos;
+      count++;
+    }
+
+    if (depth == 0) {
+      break;  // Scalar root
+    }
+  }
+
+  if (depth > 0 || count == 0) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;  // Truncated or empty input
+  }
+  *token_count = count;
+  return ETHERVOX_SUCCESS;
+}
+
+// ============================================================================
+// Views
+// ============================================================================
+
+// Index one past the subtree rooted at token i
+static uint32_t skip_value(const ethervox_tool_args_t* args, uint32_t i) {
+  int32_t end = args->tokens[i].end;
+  uint32_t j = i + 1;
+  while (j < args->token_count && args->tokens[j].start < end) {
+    j++;
+  }
+  return j;
+}
+
+static const char* token_text(const ethervox_tool_args_t* args, const ethervox_json_token_t* tok) {
+  return args->json + (tok->start - args->base);
+}
+
+static size_t token_length(const ethervox_json_token_t* tok) {
+  return (size_t)(tok->end - tok->start);
+}
+
+// Value token for key in the root object, NULL if absent
+static const ethervox_json_token_t* find_value(const ethervox_tool_args_t* args,
+                                               const char* key) {
+  if (!args || !key || args->token_count == 0 || args->tokens[0].type != ETHERVOX_JSON_OBJECT) {
+    return NULL;
+  }
+
+  size_t key_len = strlen(key);
+  uint32_t i = 1;
+  while (i + 1 < args->token_count) {
+    const ethervox_json_token_t* k = &args->tokens[i];
+    uint32_t value = i + 1;
+    if (k->type == ETHERVOX_JSON_STRING && token_length(k) == key_len &&
+        memcmp(token_text(args, k), key, key_len) == 0) {
+      return &args->tokens[value];
+    }
+    i = skip_value(args, value);
+  }
+  return NULL;
+}
+
+ethervox_result_t ethervox_tool_args_parse(ethervox_tool_args_t* args, const char* args_json) {
+  if (!args) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  const ethervox_tool_args_t* published = g_published_args;
+  if (published && args_json && published->json == args_json) {
+    args->json = published->json;
+    args->base = published->base;
+    args->tokens = published->tokens;
+    args->token_count = published->token_count;
+    args->heap = NULL;
+    return ETHERVOX_SUCCESS;
+  }
+
+  if (!args_json || args_json[0] == '\0') {
+    args_json = "{}";
+  }
+  args->json = args_json;
+  args->base = 0;
+  args->tokens = args->storage;
+  args->token_count = 0;
+  args->heap = NULL;
+
+  uint32_t count = 0;
+  ethervox_result_t result = ethervox_json_tokenize(args_json, strlen(args_json), args->storage,
+                                                    ETHERVOX_TOOL_ARGS_MAX_TOKENS, &count);
+  if (result != ETHERVOX_SUCCESS) {
+    return result;
+  }
+  args->token_count = count;
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_tool_args_parse_growable(ethervox_tool_args_t* args,
+                                                    const char* args_json) {
+  ethervox_result_t result = ethervox_tool_args_parse(args, args_json);
+  if (result != ETHERVOX_ERROR_BUFFER_TOO_SMALL) {
+    return result;
+  }
+
+  // Every token starts at a distinct byte, so the input length bounds the
+  // capacity; grow by doubling up to that
+  size_t length = strlen(args->json);
+  size_t limit = length < UINT32_MAX ? length : UINT32_MAX;
+  size_t capacity = ETHERVOX_TOOL_ARGS_MAX_TOKENS;
+  uint32_t count = 0;
+  do {
+    capacity = capacity * 2 < limit ? capacity * 2 : limit;
+    ethervox_json_token_t* grown = realloc(args->heap, capacity * sizeof(*grown));
+    if (!grown) {
+      ethervox_tool_args_release(args);
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    args->heap = grown;
+    result = ethervox_json_tokenize(args->json, length, grown, (uint32_t)capacity, &count);
+  } while (result == ETHERVOX_ERROR_BUFFER_TOO_SMALL && capacity < limit);
+  if (result != ETHERVOX_SUCCESS) {
+    ethervox_tool_args_release(args);
+    return result;
+  }
+  args->tokens = args->heap;
+  args->token_count = count;
+  return ETHERVOX_SUCCESS;
+}
+
+void ethervox_tool_args_release(ethervox_tool_args_t* args) {
+  if (!args) {
+    return;
+  }
+  free(args->heap);
+  args->heap = NULL;
+  args->tokens = args->storage;
+  args->token_count = 0;
+}
+
+ethervox_result_t ethervox_tool_args_object(const ethervox_tool_args_t* parent, const char* key,
+                                            char* text_out, size_t text_size,
+                                            ethervox_tool_args_t* child) {
+  if (!parent || !key || !text_out || text_size == 0 || !child) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  const ethervox_json_token_t* tok = find_value(parent, key);
+  if (!tok || tok->type != ETHERVOX_JSON_OBJECT) {
+    return ETHERVOX_ERROR_NOT_FOUND;
+  }
+  size_t len = token_length(tok);
+  if (len >= text_size) {
+    return ETHERVOX_ERROR_BUFFER_TOO_SMALL;
+  }
+  memcpy(text_out, token_text(parent, tok), len);
+  text_out[len] = '\0';
+
+  uint32_t first = (uint32_t)(tok - parent->tokens);
+  child->json = text_out;
+  child->base = tok->start;
+  child->tokens = tok;
+  child->token_count = skip_value(parent, first) - first;
+  child->heap = NULL;  // Borrowed from parent
+  return ETHERVOX_SUCCESS;
+}
+
+void ethervox_tool_args_publish(const ethervox_tool_args_t* args) {
+  g_published_args = args;
+}
+
+// ============================================================================
+// Accessors
+// ============================================================================
+
+static size_t append_utf8(char* out, size_t avail, uint32_t cp) {
+  char buf[4];
+  size_t n;
+  if (cp < 0x80) {
+    buf[0] = (char)cp;
+    n = 1;
+  } else if (cp < 0x800) {
+    buf[0] = (char)(0xC0 | (cp >> 6));
+    buf[1] = (char)(0x80 | (cp & 0x3F));
+    n = 2;
+  } else if (cp < 0x10000) {
+    buf[0] = (char)(0xE0 | (cp >> 12));
+    buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    buf[2] = (char)(0x80 | (cp & 0x3F));
+    n = 3;
+  } else {
+    buf[0] = (char)(0xF0 | (cp >> 18));
+    buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    buf[3] = (char)(0x80 | (cp & 0x3F));
+    n = 4;
+  }
+  if (n > avail) {
+    return 0;  // Never split a sequence when truncating
+  }
+  memcpy(out, buf, n);
+  return n;
+}
+
+static bool parse_hex4(const char* s, const char* end, uint32_t* out) {
+  if (end - s < 4) {
+    return false;
+  }
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = s[i];
+    v <<= 4;
+    if (c >= '0' && c <= '9') {
+      v |= (uint32_t)(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      v |= (uint32_t)(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      v |= (uint32_t)(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  *out = v;
+  return true;
+}
+
+// Decode a string token into out (NUL-terminated); returns bytes written.
+// With out == NULL only measures the decoded length.
+static size_t unescape(const char* src, size_t len, char* out, size_t out_size) {
+  const char* end = src + len;
+  size_t n = 0;
+  size_t cap = out ? out_size - 1 : SIZE_MAX;
+  char scratch[4];
+
+  while (src < end && n < cap) {
+    char c = *src++;
+    if (c != '\\' || src >= end) {
+      if (out) {
+        out[n] = c;
+      }
+      n++;
+      continue;
+    }
+
+    char e = *src++;
+    uint32_t cp = 0;
+    switch (e) {
+      case 'n': cp = '\n'; break;
+      case 't': cp = '\t'; break;
+      case 'r': cp = '\r'; break;
+      case 'b': cp = '\b'; break;
+      case 'f': cp = '\f'; break;
+      case 'u':
+        if (!parse_hex4(src, end, &cp)) {
+          cp = 'u';
+          break;
+        }
+        src += 4;
+        // Surrogate pair
+        if (cp >= 0xD800 && cp <= 0xDBFF && end - src >= 6 && src[0] == '\\' && src[1] == 'u') {
+          uint32_t low;
+          if (parse_hex4(src + 2, end, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            src += 6;
+          }
+        }
+        break;
+      default: cp = (unsigned char)e; break;  // \" \\ \/ and unknown escapes
+    }
+
+    size_t written = append_utf8(out ? out + n : scratch, out ? cap - n : sizeof(scratch), cp);
+    if (written == 0) {
+      break;
+    }
+    n += written;
+  }
+
+  if (out) {
+    out[n] = '\0';
+  }
+  return n;
+}
+
+ethervox_json_type_t ethervox_tool_args_type(const ethervox_tool_args_t* args, const char* key) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  return tok ? tok->type : ETHERVOX_JSON_UNDEFINED;
+}
+
+static bool is_null(const ethervox_tool_args_t* args, const ethervox_json_token_t* tok) {
+  return tok->type == ETHERVOX_JSON_PRIMITIVE && token_length(tok) == 4 &&
+         memcmp(token_text(args, tok), "null", 4) == 0;
+}
+
+bool ethervox_tool_args_has(const ethervox_tool_args_t* args, const char* key) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  return tok && !is_null(args, tok);
+}
+
+bool ethervox_tool_args_get_string(const ethervox_tool_args_t* args, const char* key, char* out,
+                                   size_t out_size) {
+  if (!out || out_size == 0) {
+    return false;
+  }
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || is_null(args, tok) ||
+      (tok->type != ETHERVOX_JSON_STRING && tok->type != ETHERVOX_JSON_PRIMITIVE)) {
+    return false;
+  }
+  unescape(token_text(args, tok), token_length(tok), out, out_size);
+  return true;
+}
+
+char* ethervox_tool_args_dup_string(const ethervox_tool_args_t* args, const char* key) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || is_null(args, tok) ||
+      (tok->type != ETHERVOX_JSON_STRING && tok->type != ETHERVOX_JSON_PRIMITIVE)) {
+    return NULL;
+  }
+  size_t len = unescape(token_text(args, tok), token_length(tok), NULL, 0);
+  char* out = malloc(len + 1);
+  if (out) {
+    unescape(token_text(args, tok), token_length(tok), out, len + 1);
+  }
+  return out;
+}
+
+// Parse a number from a primitive or numeric string token
+static bool token_to_double(const ethervox_tool_args_t* args, const ethervox_json_token_t* tok,
+                            double* out) {
+  if (tok->type != ETHERVOX_JSON_PRIMITIVE && tok->type != ETHERVOX_JSON_STRING) {
+    return false;
+  }
+  char buf[64];
+  size_t len = token_length(tok);
+  if (len == 0 || len >= sizeof(buf)) {
+    return false;
+  }
+  memcpy(buf, token_text(args, tok), len);
+  buf[len] = '\0';
+
+  char* endp = NULL;
+  errno = 0;
+  double v = strtod(buf, &endp);
+  while (*endp == ' ') {
+    endp++;
+  }
+  if (endp == buf || *endp != '\0' || errno == ERANGE || !isfinite(v)) {
+    return false;
+  }
+  *out = v;
+  return true;
+}
+
+static bool token_to_int(const ethervox_tool_args_t* args, const ethervox_json_token_t* tok,
+                         int64_t* out) {
+  double v;
+  if (!token_to_double(args, tok, &v) || v < -9.2e18 || v > 9.2e18) {
+    return false;
+  }
+  // Integers beyond double precision (large memory ids) parse exactly via strtoll
+  if (fabs(v) >= 9007199254740992.0) {
+    char buf[32];
+    size_t len = token_length(tok);
+    if (len >= sizeof(buf)) {
+      return false;
+    }
+    memcpy(buf, token_text(args, tok), len);
+    buf[len] = '\0';
+    *out = strtoll(buf, NULL, 10);
+    return true;
+  }
+  *out = (int64_t)v;
+  return true;
+}
+
+bool ethervox_tool_args_get_int(const ethervox_tool_args_t* args, const char* key, int64_t* out) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  return tok && out && token_to_int(args, tok, out);
+}
+
+bool ethervox_tool_args_get_double(const ethervox_tool_args_t* args, const char* key,
+                                   double* out) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  return tok && out && token_to_double(args, tok, out);
+}
+
+bool ethervox_tool_args_get_bool(const ethervox_tool_args_t* args, const char* key, bool* out) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || !out) {
+    return false;
+  }
+  const char* text = token_text(args, tok);
+  size_t len = token_length(tok);
+  if (tok->type == ETHERVOX_JSON_PRIMITIVE || tok->type == ETHERVOX_JSON_STRING) {
+    if (len == 4 && memcmp(text, "true", 4) == 0) {
+      *out = true;
+      return true;
+    }
+    if (len == 5 && memcmp(text, "false", 5) == 0) {
+      *out = false;
+      return true;
+    }
+  }
+  double v;
+  if (token_to_double(args, tok, &v)) {
+    *out = (v != 0.0);
+    return true;
+  }
+  return false;
+}
+
+uint32_t ethervox_tool_args_get_string_array(const ethervox_tool_args_t* args, const char* key,
+                                             char* out, size_t stride, uint32_t max_count) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || !out || stride == 0 || max_count == 0) {
+    return 0;
+  }
+
+  if (tok->type == ETHERVOX_JSON_STRING) {
+    if (token_length(tok) == 0) {
+      return 0;
+    }
+    unescape(token_text(args, tok), token_length(tok), out, stride);
+    return 1;
+  }
+  if (tok->type != ETHERVOX_JSON_ARRAY) {
+    return 0;
+  }
+
+  uint32_t written = 0;
+  uint32_t i = (uint32_t)(tok - args->tokens) + 1;
+  uint32_t end = skip_value(args, i - 1);
+  while (i < end && written < max_count) {
+    const ethervox_json_token_t* elem = &args->tokens[i];
+    if (elem->type == ETHERVOX_JSON_STRING && token_length(elem) > 0) {
+      unescape(token_text(args, elem), token_length(elem), out + written * stride, stride);
+      written++;
+    }
+    i = skip_value(args, i);
+  }
+  return written;
+}
+
+uint32_t ethervox_tool_args_get_int_array(const ethervox_tool_args_t* args, const char* key,
+                                          int64_t* out, uint32_t max_count) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || !out || max_count == 0) {
+    return 0;
+  }
+
+  if (tok->type != ETHERVOX_JSON_ARRAY) {
+    return token_to_int(args, tok, out) ? 1 : 0;
+  }
+
+  uint32_t written = 0;
+  uint32_t i = (uint32_t)(tok - args->tokens) + 1;
+  uint32_t end = skip_value(args, i - 1);
+  while (i < end && written < max_count) {
+    if (token_to_int(args, &args->tokens[i], &out[written])) {
+      written++;
+    }
+    i = skip_value(args, i);
+  }
+  return written;
+}
+
+bool ethervox_tool_args_get_raw(const ethervox_tool_args_t* args, const char* key,
+                                const char** start, size_t* length) {
+  const ethervox_json_token_t* tok = find_value(args, key);
+  if (!tok || !start || !length) {
+    return false;
+  }
+  *start = token_text(args, tok);
+  *length = token_length(tok);
+  return true;
+}
+
+// Short escape letter for c ('n' for newline...), 0 if it has none
+static char escape_letter(unsigned char c) {
+  switch (c) {
+    case '"':
+      return '"';
+    case '\\':
+      return '\\';
+    case '\b':
+      return 'b';
+    case '\f':
+      return 'f';
+    case '\n':
+      return 'n';
+    case '\r':
+      return 'r';
+    case '\t':
+      return 't';
+    default:
+      return 0;
+  }
+}
+
+char* ethervox_json_escape(const char* str) {
+  static const char kHex[] = "0123456789abcdef";
+  if (!str) {
+    str = "";
+  }
+
+  size_t len = 0;
+  for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+    if (escape_letter(*p)) {
+      len += 2;
+    } else if (*p < 0x20) {
+      len += 6;  // \u00XX
+    } else {
+      len++;
+    }
+  }
+
+  char* out = malloc(len + 1);
+  if (!out) {
+    return NULL;
+  }
+  char* w = out;
+  for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+    char letter = escape_letter(*p);
+    if (letter) {
+      *w++ = '\\';
+      *w++ = letter;
+    } else if (*p < 0x20) {
+      memcpy(w, "\\u00", 4);
+      w[4] = kHex[*p >> 4];
+      w[5] = kHex[*p & 0x0F];
+      w += 6;
+    } else {
+      *w++ = (char)*p;
+    }
+  }
+  *w = '\0';
+  return out;
+}
+
+// ============================================================================
+// Binding
+// ============================================================================
+
+static bool store_int(void* dst, size_t size, int64_t v) {
+  switch (size) {
+    case 1:
+      if (v < INT8_MIN || v > INT8_MAX) return false;
+      *(int8_t*)dst = (int8_t)v;
+      return true;
+    case 2:
+      if (v < INT16_MIN || v > INT16_MAX) return false;
+      *(int16_t*)dst = (int16_t)v;
+      return true;
+    case 4:
+      if (v < INT32_MIN || v > INT32_MAX) return false;
+      *(int32_t*)dst = (int32_t)v;
+      return true;
+    case 8:
+      *(int64_t*)dst = v;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool store_uint(void* dst, size_t size, int64_t v) {
+  if (v < 0) {
+    return false;
+  }
+  switch (size) {
+    case 1:
+      if (v > UINT8_MAX) return false;
+      *(uint8_t*)dst = (uint8_t)v;
+      return true;
+    case 2:
+      if (v > UINT16_MAX) return false;
+      *(uint16_t*)dst = (uint16_t)v;
+      return true;
+    case 4:
+      if (v > UINT32_MAX) return false;
+      *(uint32_t*)dst = (uint32_t)v;
+      return true;
+    case 8:
+      *(uint64_t*)dst = (uint64_t)v;
+      return true;
+    default:
+      return false;
+  }
+}
+
+ethervox_result_t ethervox_tool_args_bind(const ethervox_tool_args_t* args,
+                                          const ethervox_tool_arg_spec_t* specs,
+                                          uint32_t spec_count, void* out, const char** failed_key) {
+  if (!args || !specs || !out) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  for (uint32_t s = 0; s < spec_count; s++) {
+    const ethervox_tool_arg_spec_t* spec = &specs[s];
+    char* dst = (char*)out + spec->offset;
+    bool present = ethervox_tool_args_has(args, spec->key);
+    bool ok = true;
+
+    if (!present) {
+      ok = !spec->required;
+    } else {
+      int64_t i64;
+      double f64;
+      bool b;
+      switch (spec->type) {
+        case ETHERVOX_TOOL_ARG_STRING:
+          ok = ethervox_tool_args_get_string(args, spec->key, dst, spec->size);
+          break;
+        case ETHERVOX_TOOL_ARG_INT:
+          ok = ethervox_tool_args_get_int(args, spec->key, &i64) && store_int(dst, spec->size, i64);
+          break;
+        case ETHERVOX_TOOL_ARG_UINT:
+          ok = ethervox_tool_args_get_int(args, spec->key, &i64) && store_uint(dst, spec->size, i64);
+          break;
+        case ETHERVOX_TOOL_ARG_REAL:
+          ok = ethervox_tool_args_get_double(args, spec->key, &f64);
+          if (ok && spec->size == sizeof(float)) {
+            *(float*)dst = (float)f64;
+          } else if (ok && spec->size == sizeof(double)) {
+            *(double*)dst = f64;
+          } else {
+            ok = false;
+          }
+          break;
+        case ETHERVOX_TOOL_ARG_BOOL:
+          ok = ethervox_tool_args_get_bool(args, spec->key, &b) && spec->size == sizeof(bool);
+          if (ok) {
+            *(bool*)dst = b;
+          }
+          break;
+        default:
+          ok = false;
+          break;
+      }
+    }
+
+    if (!ok) {
+      if (failed_key) {
+        *failed_key = spec->key;
+      }
+      return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+  }
+  return ETHERVOX_SUCCESS;
+}
@@ -417,6 +417,100 @@ ethervox_result_t ethervox_tool_build_index_prompt(
     return offset;
 }
 
+// ============================================================================
+// Voice Command Grammar
+// ============================================================================
+
+/**
+ * Normalize a trigger phrase to the words a speech recognizer emits:
+ * lowercase, letters/digits/apostrophes only, single spaces
+ */
+static size_t normalize_trigger(const char* trigger, char* out, size_t out_size) {
+    size_t len = 0;
+    bool pending_space = false;
+    for (const char* p = trigger; *p && len + 2 < out_size; p++) {
+        char c = *p;
+        if (c >= 'A' && c <= 'Z') {
+            c = (char)(c - 'A' + 'a');
+        }
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '\'') {
+            if (pending_space && len > 0) {
+                out[len++] = ' ';
+            }
+            out[len++] = c;
+            pending_space = false;
+        } else {
+            pending_space = true;
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
+
+ethervox_result_t ethervox_tool_build_trigger_grammar(
+    const tool_manifest_registry_t* registry,
+    char* output,
+    size_t output_size
+) {
+    if (!registry || !output || output_size == 0) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    output[0] = '\0';
+    
+    if (!registry->tools_available || !registry->manifest_file) {
+        return 0;
+    }
+    
+    size_t offset = 0;
+    uint32_t phrase_count = 0;
+    tool_detail_header_t detail;
+    tool_param_t params[MAX_PARAMETERS];
+    uint8_t param_count = 0;
+    
+    for (uint32_t i = 0; i < registry->header.tool_count; i++) {
+        const tool_index_entry_t* entry = &registry->index[i];
+        if (!entry->enabled) continue;
+        
+        if (ethervox_tool_get_detail(registry, entry->name, &detail, params, &param_count) != ETHERVOX_SUCCESS) {
+            continue;
+        }
+        
+        uint8_t trigger_count = detail.trigger_count < MAX_TRIGGERS ? detail.trigger_count : MAX_TRIGGERS;
+        for (uint8_t t = 0; t < trigger_count; t++) {
+            detail.triggers[t][sizeof(detail.triggers[t]) - 1] = '\0';
+            
+            // Quoted form doubles as the duplicate check
+            char quoted[sizeof(detail.triggers[t]) + 2];
+            size_t len = normalize_trigger(detail.triggers[t], quoted + 1, sizeof(quoted) - 2);
+            if (len == 0) continue;
+            quoted[0] = '"';
+            quoted[len + 1] = '"';
+            quoted[len + 2] = '\0';
+            if (strstr(output, quoted)) continue;
+            
+            // Leave room for the closing ", \"[unk]\"]"
+            if (offset + len + 4 + 11 >= output_size) {
+                ETHERVOX_LOGE("Trigger grammar exceeds %zu bytes", output_size);
+                output[0] = '\0';
+                return ETHERVOX_ERROR_BUFFER_TOO_SMALL;
+            }
+            offset += snprintf(output + offset, output_size - offset, "%s%s",
+                               phrase_count == 0 ? "[" : ", ", quoted);
+            phrase_count++;
+        }
+    }
+    
+    if (phrase_count == 0) {
+        return 0;
+    }
+    
+    // [unk] absorbs out-of-grammar speech instead of forcing the nearest command
+    offset += snprintf(output + offset, output_size - offset, ", \"[unk]\"]");
+    
+    ETHERVOX_LOGI("Built voice command grammar: %u trigger phrases", phrase_count);
+    return (ethervox_result_t)offset;
+}
+
 // ============================================================================
 // Runtime Management
 // ============================================================================
@@ -60,7 +60,9 @@ static inline int gettimeofday(struct timeval* tp, void* tzp) {
 #endif
 
 #include "ethervox/audio.h"
+#include "ethervox/audio_pipeline.h"
 #include "ethervox/audio_recording.h"
+#include "ethervox/aec.h"
 #include "ethervox/audio_stream_player.h"
 #include "ethervox/bug_reporter.h"
 #include "ethervox/compute_tools.h"
@@ -85,6 +87,7 @@ static inline int gettimeofday(struct timeval* tp, void* tzp) {
 #include "ethervox/settings.h"
 #include "ethervox/settings_menu.h"
 #include "ethervox/startup_prompt_tools.h"
+#include "ethervox/stt_offline.h"
 #include "ethervox/system_info_tools.h"
 #include "ethervox/tool_manifest.h"
 #include "ethervox/tool_prompt_optimizer.h"
@@ -130,6 +133,18 @@ extern pthread_mutex_t g_tts_mutex;
 // Streaming audio player for real-time TTS playback
 static audio_stream_player_t* g_stream_player = NULL;
 
+// With AEC on, what the player sends to the speaker becomes the conversation's
+// echo reference (call before audio_stream_player_start)
+static void attach_stream_player_echo_reference(void) {
+  if (!g_stream_player || !g_settings.aec.enabled || !g_conversation_session) {
+    return;
+  }
+  ethervox_aec_t* aec = (ethervox_aec_t*)ethervox_conversation_get_aec(g_conversation_session);
+  if (aec) {
+    audio_stream_player_set_echo_reference(g_stream_player, ethervox_aec_get_reference(aec));
+  }
+}
+
 // TTS chunk callback for streaming playback
 static void tts_stream_callback(const float* samples, size_t sample_count, void* user_data) {
   audio_stream_player_t* player = (audio_stream_player_t*)user_data;
@@ -241,7 +256,64 @@ static ethervox_result_t standalone_listen_callback(char** user_input, int timeo
 }
 
 /**
- * Wake word listening thread - continuously monitors microphone
+ * Wake word pipeline sink - runs on its own thread with 100ms of audio per call
+ */
+static void wake_word_sink(const ethervox_pipeline_block_t* block, void* user_data) {
+  int* audio_chunks_processed = (int*)user_data;
+
+  // Check if wake word detection is enabled
+  pthread_mutex_lock(&g_wake_mutex);
+  bool enabled = g_wake_enabled;
+  ethervox_wake_runtime_t* runtime = g_wake_runtime;
+  pthread_mutex_unlock(&g_wake_mutex);
+
+  if (!enabled || !runtime) {
+    return;
+  }
+
+  // Show when calibration is complete
+  if (++*audio_chunks_processed == 50) {
+    printf(
+        "[Wake] [OK] Background calibration complete - actively listening for 'hey "
+        "ethervox'\n");
+  }
+
+  // Process with wake word detector, reusing the pipeline's VAD frames
+  ethervox_wake_result_t wake_result = {0};
+
+  pthread_mutex_lock(&g_wake_mutex);
+  ethervox_result_t result = ethervox_wake_process_frames(runtime, &block->audio, block->vad_frames,
+                                                          block->vad_frame_count, &wake_result);
+  pthread_mutex_unlock(&g_wake_mutex);
+
+  // Debug: Show wake word processing results occasionally
+  static int debug_counter = 0;
+  if (g_debug_enabled && ++debug_counter % 50 == 0) {  // Every 5 seconds
+    printf("[Wake Debug] result=%s, detected=%d, confidence=%.3f, samples=%u\n",
+           ethervox_is_success(result) ? "SUCCESS" : ethervox_error_string(result),
+           wake_result.detected, wake_result.confidence, block->audio.size);
+  }
+
+  if (ethervox_is_success(result) && wake_result.detected) {
+    // Wake word detected!
+    printf("\n🎤 Wake word detected! (confidence: %.2f)\n", wake_result.confidence);
+
+    // Trigger conversation if available
+    if (g_conversation_session) {
+      ethervox_result_t trigger_result = ethervox_conversation_trigger(g_conversation_session);
+      if (ethervox_is_error(trigger_result)) {
+        const ethervox_error_context_t* ctx = ethervox_error_get_context();
+        fprintf(stderr, "[Wake] Failed to trigger conversation: %s\n",
+                ctx && ctx->message ? ctx->message : ethervox_error_string(trigger_result));
+      }
+    } else {
+      printf("💡 Voice conversation not enabled. Use /convon first.\n");
+    }
+  }
+}
+
+/**
+ * Wake word listening thread - owns the microphone pipeline for wake word detection
  */
 static void* wake_word_listen_thread(void* arg) {
   (void)arg;
@@ -253,8 +325,9 @@ static void* wake_word_listen_thread(void* arg) {
   audio_config.channels = 1;
   audio_config.bits_per_sample = 16;
   audio_config.buffer_size = 4096;
+  audio_runtime.config = audio_config;
 
-  ethervox_result_t result = ethervox_audio_register_platform_driver(&audio_runtime);
+  ethervox_result_t result = ethervox_audio_register_driver(&audio_runtime);
   if (ethervox_is_error(result)) {
     const ethervox_error_context_t* ctx = ethervox_error_get_context();
     fprintf(stderr, "[Wake] Failed to register audio driver: %s\n", ethervox_error_string(result));
@@ -277,7 +350,23 @@ static void* wake_word_listen_thread(void* arg) {
     return NULL;
   }
 
-  result = audio_runtime.driver.start_capture(&audio_runtime);
+  // Capture (real-time thread) -> noise suppression -> VAD -> wake word sink (own thread), so
+  // LLM decode saturating the other cores cannot make capture overrun
+  int audio_chunks_processed = 0;
+  ethervox_pipeline_config_t pipeline_config = ethervox_pipeline_default_config(&audio_runtime);
+  ethervox_pipeline_sink_config_t wake_sink = {.name = "wake_word",
+                                               .process = wake_word_sink,
+                                               .user_data = &audio_chunks_processed,
+                                               .block_ms = 100,
+                                               .thread = {.own_thread = true, .cpu = -1, .rt_priority = 0}};
+  ethervox_pipeline_t* pipeline = NULL;
+  result = ethervox_pipeline_add_sink(&pipeline_config, &wake_sink);
+  if (ethervox_is_success(result)) {
+    result = ethervox_pipeline_create(&pipeline_config, &pipeline);
+  }
+  if (ethervox_is_success(result)) {
+    result = ethervox_pipeline_start(pipeline);
+  }
   if (ethervox_is_error(result)) {
     const ethervox_error_context_t* ctx = ethervox_error_get_context();
     if (ctx && ctx->message) {
@@ -285,6 +374,7 @@ static void* wake_word_listen_thread(void* arg) {
     } else {
       fprintf(stderr, "[Wake] Failed to start audio capture: %s\n", ethervox_error_string(result));
     }
+    ethervox_pipeline_destroy(pipeline);
     audio_runtime.driver.cleanup(&audio_runtime);
     g_wake_thread_running = false;
     return NULL;
@@ -292,91 +382,28 @@ static void* wake_word_listen_thread(void* arg) {
 
   printf("[Wake] Microphone listening started (calibrating for ~5 seconds...)\n");
 
-  int audio_chunks_processed = 0;
-  bool calibration_complete = false;
-
-  // Main listening loop
-  while (g_wake_thread_running) {
-    // Check if wake word detection is enabled
-    pthread_mutex_lock(&g_wake_mutex);
-    bool enabled = g_wake_enabled;
-    ethervox_wake_runtime_t* runtime = g_wake_runtime;
-    pthread_mutex_unlock(&g_wake_mutex);
-
-    if (!enabled || !runtime) {
-      usleep(100000);  // 100ms
-      continue;
-    }
-
-    // Read audio from microphone (100ms chunks)
-    ethervox_audio_buffer_t buffer;
-    buffer.size = 1600;  // 100ms at 16kHz
-    buffer.channels = 1;
-    buffer.data = (float*)calloc(buffer.size, sizeof(float));
-
-    // Set timestamp for wake word detector
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    buffer.timestamp_us = (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
-
-    if (!buffer.data) {
-      usleep(100000);
-      continue;
-    }
-
-    int samples = audio_runtime.driver.read_audio(&audio_runtime, &buffer);
+  // Detection runs on the pipeline's sink thread; this one just waits for /wakeoff or exit
+  while (g_wake_thread_running && ethervox_pipeline_is_running(pipeline)) {
+    usleep(100000);  // 100ms
+  }
 
-    // Show when calibration is complete
-    if (samples > 0) {
-      audio_chunks_processed++;
-      if (!calibration_complete && audio_chunks_processed == 50) {
-        printf(
-            "[Wake] [OK] Background calibration complete - actively listening for 'hey "
-            "ethervox'\n");
-        calibration_complete = true;
-      }
+  if (g_debug_enabled) {
+    ethervox_pipeline_metrics_t metrics;
+    if (ethervox_is_success(ethervox_pipeline_get_metrics(pipeline, &metrics))) {
+      printf("[Wake Debug] capture blocks=%llu, wake word blocks=%llu dropped=%llu max latency=%u us\n",
+             (unsigned long long)metrics.stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].blocks,
+             (unsigned long long)metrics.sinks[0].blocks, (unsigned long long)metrics.sinks[0].dropped,
+             metrics.sinks[0].max_latency_us);
     }
-
-    if (samples > 0) {
-      // Process with wake word detector
-      ethervox_wake_result_t wake_result = {0};
-
-      pthread_mutex_lock(&g_wake_mutex);
-      ethervox_result_t result = ethervox_wake_process(runtime, &buffer, &wake_result);
-      pthread_mutex_unlock(&g_wake_mutex);
-
-      // Debug: Show wake word processing results occasionally
-      static int debug_counter = 0;
-      if (g_debug_enabled && ++debug_counter % 50 == 0) {  // Every 5 seconds
-        printf("[Wake Debug] result=%s, detected=%d, confidence=%.3f, samples=%d\n",
-               ethervox_is_success(result) ? "SUCCESS" : ethervox_error_string(result),
-               wake_result.detected, wake_result.confidence, samples);
-      }
-
-      if (ethervox_is_success(result) && wake_result.detected) {
-        // Wake word detected!
-        printf("\n🎤 Wake word detected! (confidence: %.2f)\n", wake_result.confidence);
-
-        // Trigger conversation if available
-        if (g_conversation_session) {
-          ethervox_result_t trigger_result = ethervox_conversation_trigger(g_conversation_session);
-          if (ethervox_is_error(trigger_result)) {
-            const ethervox_error_context_t* ctx = ethervox_error_get_context();
-            fprintf(stderr, "[Wake] Failed to trigger conversation: %s\n",
-                    ctx && ctx->message ? ctx->message : ethervox_error_string(trigger_result));
-          }
-        } else {
-          printf("💡 Voice conversation not enabled. Use /convon first.\n");
-        }
-      }
+    ethervox_doa_t doa;
+    if (ethervox_is_success(ethervox_pipeline_get_doa(pipeline, &doa)) && doa.updates > 0) {
+      printf("[Wake Debug] talker last heard at %.0f degrees (confidence %.2f, %u estimates)\n", doa.azimuth_deg,
+             doa.confidence, doa.updates);
     }
-
-    free(buffer.data);
-    usleep(10000);  // 10ms between reads
   }
 
   // Cleanup
-  audio_runtime.driver.stop_capture(&audio_runtime);
+  ethervox_pipeline_destroy(pipeline);
   audio_runtime.driver.cleanup(&audio_runtime);
   printf("[Wake] Microphone listening stopped\n");
 
@@ -564,7 +591,7 @@ const char* DEFAULT_STARTUP_PROMPT = "Greet the user with a short creative greet
 
 static void signal_handler(int sig) {
   if (sig == SIGINT && g_transcription_session &&
-      (g_transcription_session->is_recording || g_transcription_session->capture_thread)) {
+      (g_transcription_session->is_recording || g_transcription_session->capture_pipeline)) {
     g_sigint_stop_transcribe = 1;
     return;
   }
@@ -3095,6 +3122,54 @@ static void process_command(const char* line, ethervox_memory_store_t* memory,
   }
 }
 
+// Offline transcription mode (-transcribe): decode a recording and exit
+static int run_offline_transcription(const char* wav_path, const char* stt_model,
+                                     const char* language, uint32_t workers) {
+  char default_model[512];
+  if (!stt_model) {
+    const char* home = getenv("HOME");
+    snprintf(default_model, sizeof(default_model), "%s/.ethervox/models/whisper/base.bin",
+             home ? home : ".");
+    stt_model = default_model;
+  }
+
+  ethervox_stt_offline_config_t config = ethervox_stt_offline_get_default_config();
+  config.model_path = stt_model;
+  if (language) {
+    config.language = language;
+  }
+  config.workers = workers;
+
+  printf("\n📝 Offline transcription: %s\n", wav_path);
+  printf("   Model: %s\n", stt_model);
+
+  ethervox_stt_offline_result_t result;
+  ethervox_result_t ret = ethervox_stt_offline_transcribe_file(&config, wav_path, &result);
+  if (ethervox_is_error(ret)) {
+    fprintf(stderr, "❌ Transcription failed: %s\n", ethervox_error_string(ret));
+    return 1;
+  }
+
+  printf("\n");
+  for (uint32_t i = 0; i < result.segment_count; i++) {
+    const ethervox_stt_offline_segment_t* seg = &result.segments[i];
+    printf("[%02llu:%02llu:%02llu.%03llu --> %02llu:%02llu:%02llu.%03llu] %s\n",
+           (unsigned long long)(seg->start_ms / 3600000), (unsigned long long)(seg->start_ms / 60000 % 60),
+           (unsigned long long)(seg->start_ms / 1000 % 60), (unsigned long long)(seg->start_ms % 1000),
+           (unsigned long long)(seg->end_ms / 3600000), (unsigned long long)(seg->end_ms / 60000 % 60),
+           (unsigned long long)(seg->end_ms / 1000 % 60), (unsigned long long)(seg->end_ms % 1000),
+           seg->text);
+  }
+  printf("\n✅ %.1f s of audio in %.2f s (load %.2f s) - realtime factor %.3f (%.1fx realtime)\n",
+         result.audio_seconds, result.decode_seconds, result.load_seconds, result.realtime_factor,
+         result.realtime_factor > 0.0 ? 1.0 / result.realtime_factor : 0.0);
+  printf("   %u spans on %u workers, %u segments\n", result.spans, result.workers,
+         result.segment_count);
+
+  ethervox_stt_offline_result_free(&result);
+  return 0;
+}
+
 int main(int argc, char** argv) {
   // Setup signal handlers
   signal(SIGINT, signal_handler);
@@ -3130,6 +3205,10 @@ int main(int argc, char** argv) {
   const char* tts_text = NULL;            // Text to synthesize in TTS mode
   const char* audio_file = NULL;          // Optional output file for -af flag
   const char* tts_voice_override = NULL;  // Language code override for -voice flag
+  const char* transcribe_file = NULL;     // WAV to transcribe offline (-transcribe)
+  const char* stt_model_path = NULL;      // Whisper model for -transcribe
+  const char* stt_language = NULL;        // Language for -transcribe (default: auto)
+  uint32_t stt_workers = 0;               // Parallel decoders for -transcribe (0 = auto)
 
   // Track explicit flag usage for conflict detection
   bool debug_flag_set = false;
@@ -3235,6 +3314,20 @@ int main(int argc, char** argv) {
     } else if ((strcmp(argv[i], "--voice") == 0 || strcmp(argv[i], "-voice") == 0) &&
                i + 1 < argc) {
       tts_voice_override = argv[++i];
+    } else if ((strcmp(argv[i], "--transcribe") == 0 || strcmp(argv[i], "-transcribe") == 0) &&
+               i + 1 < argc) {
+      transcribe_file = argv[++i];
+      interactive = false;
+      skip_startup_prompt = true;
+    } else if ((strcmp(argv[i], "--stt-model") == 0 || strcmp(argv[i], "-stt-model") == 0) &&
+               i + 1 < argc) {
+      stt_model_path = argv[++i];
+    } else if ((strcmp(argv[i], "--stt-lang") == 0 || strcmp(argv[i], "-stt-lang") == 0) &&
+               i + 1 < argc) {
+      stt_language = argv[++i];
+    } else if ((strcmp(argv[i], "--workers") == 0 || strcmp(argv[i], "-workers") == 0) &&
+               i + 1 < argc) {
+      stt_workers = (uint32_t)strtoul(argv[++i], NULL, 10);
     } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
       printf("Usage: %s [options]\n\n", argv[0]);
       printf("Options:\n");
@@ -3262,6 +3355,11 @@ int main(int argc, char** argv) {
       printf("  -voice <lang>      Override language detection (en, de, es, zh) for TTS\n");
       printf("  -test-voices       Demonstrate all configured TTS voices\n");
       printf("  -af <file>         Save audio output to file (use with -speak/-speak-direct)\n");
+      printf("  -transcribe <wav>  Transcribe a 16 kHz recording offline and exit\n");
+      printf("  -stt-model <path>  Whisper model for -transcribe (default: whisper/base.bin)\n");
+      printf("  -stt-lang <lang>   Language for -transcribe (default: auto)\n");
+      printf("  -workers <n>       Parallel Whisper decoders for -transcribe (default: cores/%d)\n",
+             ETHERVOX_WHISPER_OFFLINE_THREADS_PER_WORKER);
       printf("  -help, -h          Show this help message\n");
       printf("\n");
       _exit(0);
@@ -3309,6 +3407,11 @@ int main(int argc, char** argv) {
     g_ethervox_debug_enabled = 0;
   }
 
+  // Offline transcription needs neither the governor nor audio devices
+  if (transcribe_file) {
+    return run_offline_transcription(transcribe_file, stt_model_path, stt_language, stt_workers);
+  }
+
   // Print banner (skip if settings mode - ncurses needs clean terminal)
   if (!settings_mode) {
     print_banner();
@@ -3632,6 +3735,7 @@ int main(int argc, char** argv) {
       printf("   Output: streaming playback (use -af <file> to save)\n");
       // Start streaming player before synthesis
       if (g_stream_player) {
+        attach_stream_player_echo_reference();
         ethervox_result_t result = audio_stream_player_start(g_stream_player);
         if (ethervox_is_error(result)) {
           const ethervox_error_context_t* ctx = ethervox_error_get_context();
@@ -3743,6 +3847,7 @@ int main(int argc, char** argv) {
     // Start streaming player if available
     bool using_streaming = false;
     if (g_stream_player) {
+      attach_stream_player_echo_reference();
       if (ethervox_is_success(audio_stream_player_start(g_stream_player))) {
         using_streaming = true;
         printf("🎵 Using streaming audio playback\n\n");
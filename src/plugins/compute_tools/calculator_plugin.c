@@ -13,6 +13,7 @@
  */
 
 #include "ethervox/compute_tools.h"
+#include "ethervox/tool_args.h"
 #include <ctype.h>
 #include <math.h>
 #include <stdio.h>
@@ -208,60 +209,30 @@ static double evaluate_expression(const char* expr, char** error_msg) {
     return result;
 }
 
-// Extract expression from JSON: {"expression": "5+5"}
-static char* extract_json_string(const char* json, const char* key) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return NULL;
-    
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return NULL;
-    
-    const char* value_start = strchr(colon, '"');
-    if (!value_start) return NULL;
-    value_start++; // Skip opening quote
-    
-    const char* value_end = strchr(value_start, '"');
-    if (!value_end) return NULL;
-    
-    size_t len = value_end - value_start;
-    char* result = malloc(len + 1);
-    if (!result) return NULL;
-    
-    strncpy(result, value_start, len);
-    result[len] = '\0';
-    return result;
-}
-
-static int extract_json_int(const char* json, const char* key, int default_value) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return default_value;
-    
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return default_value;
-    
-    return atoi(colon + 1);
-}
+// Result returned to the model; the expression is echoed JSON-escaped
+#define CALC_RESULT_FORMAT \
+    "{\"result\": %.*f, \"tool\": \"calculator_compute\", \"expression\": \"%s\"}"
 
 static int calculator_execute(const char* args_json, char** result, char** error) {
     if (!args_json || !result || !error) {
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    // Extract expression from JSON
-    char* expression = extract_json_string(args_json, "expression");
+    // Extract expression from JSON: {"expression": "5+5"}
+    ethervox_tool_args_t args;
+    if (ethervox_tool_args_parse(&args, args_json) != ETHERVOX_SUCCESS) {
+        *error = strdup("Malformed JSON arguments");
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    char* expression = ethervox_tool_args_dup_string(&args, "expression");
     if (!expression) {
         *error = strdup("Missing 'expression' parameter in JSON");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
     // Extract optional decimal_places (default: 2)
-    int decimal_places = extract_json_int(args_json, "decimal_places", 2);
+    int64_t decimal_places = 2;
+    ethervox_tool_args_get_int(&args, "decimal_places", &decimal_places);
     if (decimal_places < 0) decimal_places = 0;
     if (decimal_places > 15) decimal_places = 15;  // Limit precision
     
@@ -275,18 +246,27 @@ static int calculator_execute(const char* args_json, char** result, char** error
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    // Return result as JSON with tool name
-    char* result_json = malloc(256);
+    // Return result as JSON with tool name. The parser unescaped the
+    // expression, so escape it again before echoing it back.
+    char* escaped = ethervox_json_escape(expression);
+    free(expression);
+    if (!escaped) {
+        *error = strdup("Out of memory");
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    
+    int length = snprintf(NULL, 0, CALC_RESULT_FORMAT, (int)decimal_places, value, escaped);
+    char* result_json = length >= 0 ? malloc((size_t)length + 1) : NULL;
     if (!result_json) {
-        free(expression);
-        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+        free(escaped);
+        *error = strdup("Out of memory");
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
     }
     
-    snprintf(result_json, 256, "{\"result\": %.*f, \"tool\": \"calculator_compute\", \"expression\": \"%s\"}", 
-             decimal_places, value, expression);
+    snprintf(result_json, (size_t)length + 1, CALC_RESULT_FORMAT, (int)decimal_places, value, escaped);
     *result = result_json;
     
-    free(expression);
+    free(escaped);
     return ETHERVOX_SUCCESS;
 }
 
@@ -9,13 +9,11 @@
 
 #include "ethervox/context_tools.h"
 #include "ethervox/config.h"
+#include "ethervox/tool_args.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// For JSON parsing (simple approach)
-#include <ctype.h>
-
 #define CTX_LOG(...) ETHERVOX_LOGI(__VA_ARGS__)
 #define CTX_ERROR(...) ETHERVOX_LOGE(__VA_ARGS__)
 
@@ -23,67 +21,6 @@
 static ethervox_memory_store_t* g_memory_store = NULL;
 static ethervox_governor_t* g_governor_ref = NULL;
 
-/**
- * Simple JSON value extractor
- * Extracts value for a given key from JSON string
- */
-static char* extract_json_string(const char* json, const char* key) {
-    if (!json || !key) return NULL;
-    
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return NULL;
-    
-    // Find the value after the key
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return NULL;
-    
-    // Skip whitespace
-    colon++;
-    while (*colon && isspace(*colon)) colon++;
-    
-    // Check if value is a string (starts with ")
-    if (*colon == '"') {
-        colon++;  // Skip opening quote
-        const char* end = strchr(colon, '"');
-        if (!end) return NULL;
-        
-        size_t len = end - colon;
-        char* value = malloc(len + 1);
-        if (!value) return NULL;
-        
-        strncpy(value, colon, len);
-        value[len] = '\0';
-        return value;
-    }
-    
-    return NULL;
-}
-
-static int extract_json_int(const char* json, const char* key, int default_value) {
-    if (!json || !key) return default_value;
-    
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return default_value;
-    
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return default_value;
-    
-    colon++;
-    while (*colon && isspace(*colon)) colon++;
-    
-    if (isdigit(*colon) || *colon == '-') {
-        return atoi(colon);
-    }
-    
-    return default_value;
-}
-
 /**
  * context_manage tool execution function
  */
@@ -97,15 +34,23 @@ static int context_manage_execute(
     CTX_LOG("[Context] context_manage called with args: %s", args_json);
     
     // Extract parameters
-    char* action_str = extract_json_string(args_json, "action");
-    if (!action_str) {
+    ethervox_tool_args_t args;
+    char action_str[64];
+    if (ethervox_tool_args_parse(&args, args_json) != ETHERVOX_SUCCESS ||
+        ethervox_tool_args_type(&args, "action") != ETHERVOX_JSON_STRING ||
+        !ethervox_tool_args_get_string(&args, "action", action_str, sizeof(action_str))) {
         *error = strdup("Missing required parameter: action");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    int keep_last_n = extract_json_int(args_json, "keep_last_n_turns", 10);
-    char* detail = extract_json_string(args_json, "summary_detail");
-    const char* detail_level = detail ? detail : "moderate";
+    int64_t keep_last_n_arg = 10;
+    ethervox_tool_args_get_int(&args, "keep_last_n_turns", &keep_last_n_arg);
+    int keep_last_n = (int)keep_last_n_arg;
+    char detail[32] = "moderate";
+    if (ethervox_tool_args_type(&args, "summary_detail") == ETHERVOX_JSON_STRING) {
+        ethervox_tool_args_get_string(&args, "summary_detail", detail, sizeof(detail));
+    }
+    const char* detail_level = detail;
     
     // Validate action
     context_action_t action;
@@ -119,8 +64,6 @@ static int context_manage_execute(
         char err_msg[256];
         snprintf(err_msg, sizeof(err_msg), "Unknown action: %s", action_str);
         *error = strdup(err_msg);
-        free(action_str);
-        if (detail) free(detail);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
@@ -145,9 +88,6 @@ static int context_manage_execute(
             break;
     }
     
-    free(action_str);
-    if (detail) free(detail);
-    
     // Build result JSON
     if (ethervox_is_success(ret) && ctx_result.success) {
         char result_json[512];
@@ -21,6 +21,36 @@
 #include <unistd.h>
 #endif
 
+// Tag dictionary and bitmaps (memory_tag_index.c)
+extern void memory_tag_index_add_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal);
+extern void memory_tag_index_remove_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal);
+extern void memory_tag_index_free_internal(ethervox_memory_store_t* store);
+extern void memory_rebuild_tag_index_internal(ethervox_memory_store_t* store);
+
+// Time-ordered index (memory_time_index.c)
+extern void memory_time_index_add_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal);
+extern void memory_time_index_rebuild_internal(ethervox_memory_store_t* store);
+extern void memory_time_index_free_internal(ethervox_memory_store_t* store);
+
+// Near-duplicate detection (memory_dedup.c)
+extern void memory_dedup_sketch_internal(const char* text, uint32_t* signature_out);
+extern uint32_t memory_dedup_find_internal(
+    const ethervox_memory_store_t* store,
+    const char* text,
+    const char* tags[],
+    uint32_t tag_count,
+    const uint32_t* signature,
+    float* similarity_out
+);
+extern void memory_dedup_add_entry_internal(
+    ethervox_memory_store_t* store,
+    uint32_t ordinal,
+    const uint32_t* signature
+);
+extern void memory_dedup_update_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal);
+extern void memory_dedup_rebuild_internal(ethervox_memory_store_t* store);
+extern void memory_dedup_free_internal(ethervox_memory_store_t* store);
+
 // Generate a simple UUID-like session ID
 static void generate_session_id(char* session_id, size_t len) {
     time_t now = time(NULL);
@@ -107,6 +137,8 @@ ethervox_result_t ethervox_memory_init(
     
     store->session_started = time(NULL);
     store->current_turn_id = 0;
+    store->dedup_mode = ETHERVOX_MEMORY_DEDUP_DEFAULT_MODE;
+    store->dedup_threshold = ETHERVOX_MEMORY_DEDUP_THRESHOLD;
     
     // Initialize entries array
     store->entry_capacity = 256;  // Start with room for 256 entries
@@ -117,7 +149,7 @@ ethervox_result_t ethervox_memory_init(
     store->entry_count = 0;
     
     // Initialize tag index
-    store->tag_index_capacity = 64;  // Start with 64 tag buckets
+    store->tag_index_capacity = 64;  // Start with room for 64 interned tags
     store->tag_index = calloc(store->tag_index_capacity, sizeof(ethervox_memory_tag_index_t));
     if (!store->tag_index) {
         free(store->entries);
@@ -181,11 +213,10 @@ void ethervox_memory_cleanup(ethervox_memory_store_t* store) {
         store->entries = NULL;
     }
     
-    // Free tag index
-    if (store->tag_index) {
-        free(store->tag_index);
-        store->tag_index = NULL;
-    }
+    // Free tag dictionary, bitmaps, time index and duplicate index
+    memory_tag_index_free_internal(store);
+    memory_time_index_free_internal(store);
+    memory_dedup_free_internal(store);
     
     ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
                 "Cleaned up memory store: %llu memories stored, %llu searches",
@@ -194,39 +225,219 @@ void ethervox_memory_cleanup(ethervox_memory_store_t* store) {
     store->is_initialized = false;
 }
 
-// Find or create tag index entry
-static ethervox_memory_tag_index_t* get_tag_index(
+// Write a JSON-escaped string (quotes included) to the append log
+static void write_log_escaped(FILE* fp, const char* str) {
+    fputc('"', fp);
+    for (const char* p = str; *p; p++) {
+        switch (*p) {
+            case '"':  fputs("\\\"", fp); break;
+            case '\\': fputs("\\\\", fp); break;
+            case '\n': fputs("\\n", fp); break;
+            case '\r': fputs("\\r", fp); break;
+            case '\t': fputs("\\t", fp); break;
+            default:   fputc(*p, fp); break;
+        }
+    }
+    fputc('"', fp);
+}
+
+// Write a complete ADD record for an entry (JSONL format, no flush)
+static void write_entry_record(FILE* fp, const ethervox_memory_entry_t* entry) {
+    fprintf(fp,
+            "{\"id\":%llu,\"turn\":%llu,\"ts\":%ld,\"user\":%s,\"imp\":%.2f,\"text\":",
+            (unsigned long long)entry->memory_id, (unsigned long long)entry->turn_id,
+            (long)entry->timestamp, entry->is_user_message ? "true" : "false", entry->importance);
+    write_log_escaped(fp, entry->text);
+
+    fprintf(fp, ",\"tags\":[");
+    for (uint32_t i = 0; i < entry->tag_count; i++) {
+        fprintf(fp, "%s\"%s\"", i > 0 ? "," : "", entry->tags[i]);
+    }
+    fprintf(fp, "]");
+
+    if (entry->tools_called_count > 0) {
+        fprintf(fp, ",\"tools\":[");
+        for (uint32_t i = 0; i < entry->tools_called_count; i++) {
+            fprintf(fp, "%s\"%s\"", i > 0 ? "," : "", entry->tools_called[i]);
+        }
+        fprintf(fp, "]");
+    }
+
+    fprintf(fp, "}\n");
+}
+
+// Grow the entries array so that at least `needed` entries fit.
+// Capacity never exceeds ETHERVOX_MEMORY_MAX_ENTRIES.
+ethervox_result_t memory_reserve_entries_internal(
     ethervox_memory_store_t* store,
-    const char* tag
+    uint32_t needed
 ) {
-    // Search for existing tag
-    for (uint32_t i = 0; i < store->tag_index_count; i++) {
-        if (strcmp(store->tag_index[i].tag, tag) == 0) {
-            return &store->tag_index[i];
+    if (!store || !store->is_initialized) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (needed > ETHERVOX_MEMORY_MAX_ENTRIES) {
+        needed = ETHERVOX_MEMORY_MAX_ENTRIES;
+    }
+    if (needed <= store->entry_capacity) {
+        return ETHERVOX_SUCCESS;
+    }
+
+    uint32_t new_capacity = store->entry_capacity ? store->entry_capacity : 256;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    if (new_capacity > ETHERVOX_MEMORY_MAX_ENTRIES) {
+        new_capacity = ETHERVOX_MEMORY_MAX_ENTRIES;
+    }
+
+    ethervox_memory_entry_t* new_entries = realloc(
+        store->entries,
+        new_capacity * sizeof(ethervox_memory_entry_t)
+    );
+    if (!new_entries) {
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    store->entries = new_entries;
+    store->entry_capacity = new_capacity;
+
+    return ETHERVOX_SUCCESS;
+}
+
+// Append a fully populated entry without touching the tag index or the log.
+// Bulk loaders call memory_rebuild_indexes_internal() and
+// memory_persist_entries_internal() once when they are done.
+ethervox_result_t memory_append_entry_internal(
+    ethervox_memory_store_t* store,
+    const ethervox_memory_entry_t* entry
+) {
+    if (!store || !store->is_initialized || !entry) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (store->entry_count >= store->entry_capacity) {
+        ethervox_result_t result = memory_reserve_entries_internal(store, store->entry_count + 1);
+        if (result != ETHERVOX_SUCCESS) {
+            return result;
         }
+        if (store->entry_count >= store->entry_capacity) {
+            return ETHERVOX_ERROR_MEMORY_STORE_FAILED;  // ETHERVOX_MEMORY_MAX_ENTRIES reached
+        }
+    }
+
+    store->entries[store->entry_count++] = *entry;
+
+    // Keep auto-generated IDs ahead of imported ones
+    if (entry->memory_id >= store->total_memories_stored) {
+        store->total_memories_stored = entry->memory_id + 1;
+    }
+    if (entry->turn_id >= store->current_turn_id) {
+        store->current_turn_id = entry->turn_id + 1;
     }
+
+    return ETHERVOX_SUCCESS;
+}
+
+// Rebuild the tag and time indexes after the entries array was compacted
+// or bulk-loaded (entry ordinals may have shifted)
+void memory_rebuild_indexes_internal(ethervox_memory_store_t* store) {
+    memory_rebuild_tag_index_internal(store);
+    memory_time_index_rebuild_internal(store);
+    memory_dedup_rebuild_internal(store);
+}
+
+// Fold a near-duplicate insert into the existing entry at `ordinal`.
+// MERGE raises importance and adds missing tags; REJECT leaves it alone.
+static ethervox_result_t resolve_duplicate(
+    ethervox_memory_store_t* store,
+    uint32_t ordinal,
+    const char* tags[],
+    uint32_t tag_count,
+    float importance,
+    float similarity,
+    uint64_t* memory_id_out
+) {
+    ethervox_memory_entry_t* entry = &store->entries[ordinal];
+    store->total_duplicates++;
     
-    // Grow index if needed
-    if (store->tag_index_count >= store->tag_index_capacity) {
-        uint32_t new_capacity = store->tag_index_capacity * 2;
-        ethervox_memory_tag_index_t* new_index = realloc(
-            store->tag_index,
-            new_capacity * sizeof(ethervox_memory_tag_index_t)
-        );
-        if (!new_index) {
-            return NULL;
+    if (memory_id_out) {
+        *memory_id_out = entry->memory_id;
+    }
+    
+    if (store->dedup_mode == ETHERVOX_MEMORY_DEDUP_REJECT) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
+                    "Rejected near-duplicate of memory %llu (similarity %.2f)",
+                    (unsigned long long)entry->memory_id, similarity);
+        return ETHERVOX_SUCCESS;
+    }
+    
+    // Union the tags, moving the entry between tag bitmaps if anything changed
+    bool tags_changed = false;
+    for (uint32_t i = 0; i < tag_count && entry->tag_count < ETHERVOX_MEMORY_MAX_TAGS; i++) {
+        bool present = false;
+        for (uint32_t t = 0; t < entry->tag_count; t++) {
+            if (strncmp(entry->tags[t], tags[i], ETHERVOX_MEMORY_TAG_LEN - 1) == 0) {
+                present = true;
+                break;
+            }
         }
-        store->tag_index = new_index;
-        store->tag_index_capacity = new_capacity;
+        if (!present) {
+            if (!tags_changed) {
+                memory_tag_index_remove_entry_internal(store, ordinal);
+                tags_changed = true;
+            }
+            snprintf(entry->tags[entry->tag_count++], ETHERVOX_MEMORY_TAG_LEN, "%s", tags[i]);
+        }
+    }
+    if (tags_changed) {
+        memory_tag_index_add_entry_internal(store, ordinal);
     }
     
-    // Create new tag index
-    ethervox_memory_tag_index_t* idx = &store->tag_index[store->tag_index_count];
-    snprintf(idx->tag, sizeof(idx->tag), "%s", tag);
-    idx->count = 0;
-    store->tag_index_count++;
+    float boosted = (importance > entry->importance ? importance : entry->importance) +
+                    ETHERVOX_MEMORY_DEDUP_IMPORTANCE_BOOST;
+    entry->importance = boosted > 1.0f ? 1.0f : boosted;
     
-    return idx;
+    // Persist as an UPDATE record carrying the merged tags and importance
+    ensure_storage_ready(store);
+    if (store->append_log) {
+        fprintf(store->append_log, "{\"op\":\"update\",\"id\":%llu,\"tags\":[",
+                (unsigned long long)entry->memory_id);
+        for (uint32_t t = 0; t < entry->tag_count; t++) {
+            fprintf(store->append_log, "%s\"%s\"", t > 0 ? "," : "", entry->tags[t]);
+        }
+        fprintf(store->append_log, "],\"imp\":%.2f}\n", entry->importance);
+        fflush(store->append_log);
+    }
+    
+    ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
+                "Merged near-duplicate into memory %llu (similarity %.2f, importance %.2f)",
+                (unsigned long long)entry->memory_id, similarity, entry->importance);
+    return ETHERVOX_SUCCESS;
+}
+
+// Write entries [start, start + count) to the append log with a single flush
+void memory_persist_entries_internal(
+    ethervox_memory_store_t* store,
+    uint32_t start,
+    uint32_t count
+) {
+    if (!store || !store->is_initialized || count == 0) {
+        return;
+    }
+
+    ensure_storage_ready(store);
+    if (!store->append_log) {
+        return;
+    }
+
+    uint32_t end = start + count;
+    if (end > store->entry_count) {
+        end = store->entry_count;
+    }
+    for (uint32_t i = start; i < end; i++) {
+        write_entry_record(store->append_log, &store->entries[i]);
+    }
+    fflush(store->append_log);
 }
 
 // Internal function for adding memories with explicit IDs (used by import)
@@ -254,6 +465,15 @@ ethervox_result_t memory_store_add_internal(
     if (importance < 0.0f) importance = 0.0f;
     if (importance > 1.0f) importance = 1.0f;
     
+    // Near-duplicate check (MinHash + LSH) before a new row is created
+    uint32_t signature[ETHERVOX_MEMORY_MINHASH_SIZE];
+    memory_dedup_sketch_internal(text, signature);
+    float similarity = 0.0f;
+    uint32_t duplicate = memory_dedup_find_internal(store, text, tags, tag_count, signature, &similarity);
+    if (duplicate != UINT32_MAX) {
+        return resolve_duplicate(store, duplicate, tags, tag_count, importance, similarity, memory_id_out);
+    }
+    
     // Grow entries array if needed
     if (store->entry_count >= store->entry_capacity) {
         uint32_t new_capacity = store->entry_capacity * 2;
@@ -289,13 +509,10 @@ ethervox_result_t memory_store_add_internal(
     entry->tag_count = tag_count;
     for (uint32_t i = 0; i < tag_count; i++) {
         snprintf(entry->tags[i], ETHERVOX_MEMORY_TAG_LEN, "%s", tags[i]);
-        
-        // Update tag index
-        ethervox_memory_tag_index_t* idx = get_tag_index(store, tags[i]);
-        if (idx && idx->count < 1024) {
-            idx->memory_ids[idx->count++] = entry->memory_id;
-        }
     }
+    memory_tag_index_add_entry_internal(store, store->entry_count);
+    memory_time_index_add_entry_internal(store, store->entry_count);
+    memory_dedup_add_entry_internal(store, store->entry_count, signature);
     
     store->entry_count++;
     
@@ -391,6 +608,15 @@ ethervox_result_t ethervox_memory_store_add_with_tools(
     if (importance < 0.0f) importance = 0.0f;
     if (importance > 1.0f) importance = 1.0f;
     
+    // Near-duplicate check (MinHash + LSH) before a new row is created
+    uint32_t signature[ETHERVOX_MEMORY_MINHASH_SIZE];
+    memory_dedup_sketch_internal(text, signature);
+    float similarity = 0.0f;
+    uint32_t duplicate = memory_dedup_find_internal(store, text, tags, tag_count, signature, &similarity);
+    if (duplicate != UINT32_MAX) {
+        return resolve_duplicate(store, duplicate, tags, tag_count, importance, similarity, memory_id_out);
+    }
+    
     // Grow entries array if needed
     if (store->entry_count >= store->entry_capacity) {
         uint32_t new_capacity = store->entry_capacity * 2;
@@ -431,13 +657,10 @@ ethervox_result_t ethervox_memory_store_add_with_tools(
     entry->tag_count = tag_count;
     for (uint32_t i = 0; i < tag_count; i++) {
         snprintf(entry->tags[i], ETHERVOX_MEMORY_TAG_LEN, "%s", tags[i]);
-        
-        // Update tag index
-        ethervox_memory_tag_index_t* idx = get_tag_index(store, tags[i]);
-        if (idx && idx->count < 1024) {
-            idx->memory_ids[idx->count++] = entry->memory_id;
-        }
     }
+    memory_tag_index_add_entry_internal(store, store->entry_count);
+    memory_time_index_add_entry_internal(store, store->entry_count);
+    memory_dedup_add_entry_internal(store, store->entry_count, signature);
     
     // Copy tools called
     entry->tools_called_count = tools_count;
@@ -523,11 +746,14 @@ ethervox_result_t memory_update_tags_internal(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;  // Not found
     }
     
-    // Update tags in memory
+    // Update tags in memory and move the entry between tag bitmaps
+    uint32_t ordinal = (uint32_t)(entry - store->entries);
+    memory_tag_index_remove_entry_internal(store, ordinal);
     for (uint32_t i = 0; i < tag_count && i < ETHERVOX_MEMORY_MAX_TAGS; i++) {
         snprintf(entry->tags[i], ETHERVOX_MEMORY_TAG_LEN, "%s", tags[i]);
     }
     entry->tag_count = tag_count;
+    memory_tag_index_add_entry_internal(store, ordinal);
     
     // Persist the update to JSONL file as an UPDATE record (if requested)
     if (persist_to_log && store->append_log) {
@@ -545,6 +771,26 @@ ethervox_result_t memory_update_tags_internal(
     return ETHERVOX_SUCCESS;
 }
 
+// Set importance without logging (replaying merged UPDATE records during import)
+ethervox_result_t memory_set_importance_internal(
+    ethervox_memory_store_t* store,
+    uint64_t memory_id,
+    float importance
+) {
+    if (!store || !store->is_initialized) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        if (store->entries[i].memory_id == memory_id) {
+            store->entries[i].importance = importance;
+            return ETHERVOX_SUCCESS;
+        }
+    }
+    
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;  // Not found
+}
+
 ethervox_result_t ethervox_memory_update_tags(
     ethervox_memory_store_t* store,
     uint64_t memory_id,
@@ -579,6 +825,7 @@ ethervox_result_t ethervox_memory_update_text(
     // Update the text
     strncpy(entry->text, new_text, ETHERVOX_MEMORY_MAX_TEXT_LEN - 1);
     entry->text[ETHERVOX_MEMORY_MAX_TEXT_LEN - 1] = '\0';
+    memory_dedup_update_entry_internal(store, (uint32_t)(entry - store->entries));
     
     // Write UPDATE record with new text
     if (store->append_log) {
@@ -709,11 +956,10 @@ ethervox_result_t ethervox_memory_get_corrections(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    // Search for correction tag
+    // Newest corrections first, walked from the tail of the time index
     const char* correction_tag = "correction";
-    return ethervox_memory_search(
+    return ethervox_memory_get_recent(
         store,
-        NULL,  // No text query, just tag filter
         &correction_tag,
         1,  // 1 tag
         limit,
@@ -732,11 +978,10 @@ ethervox_result_t ethervox_memory_get_patterns(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    // Search for pattern tag
+    // Newest patterns first, walked from the tail of the time index
     const char* pattern_tag = "pattern";
-    return ethervox_memory_search(
+    return ethervox_memory_get_recent(
         store,
-        NULL,  // No text query, just tag filter
         &pattern_tag,
         1,  // 1 tag
         limit,
@@ -0,0 +1,474 @@
+/**
+ * @file memory_dedup.c
+ * @brief Near-duplicate detection for memory inserts (MinHash + LSH)
+ *
+ * Each entry's text is reduced to a set of shingles (lowercased word
+ * unigrams and bigrams) and sketched into ETHERVOX_MEMORY_MINHASH_SIZE
+ * min-hash values. The signature is cut into ETHERVOX_MEMORY_LSH_BANDS bands;
+ * every band is hashed into a shared bucket table, so entries that agree on
+ * any full band become candidates in O(1) expected time. Candidates are
+ * confirmed with the signature estimate and then the exact Jaccard
+ * similarity of the two shingle sets.
+ *
+ * Signatures and chains are indexed by entry ordinal and rebuilt together
+ * with the tag and time indexes after compaction.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/memory_tools.h"
+#include "ethervox/logging.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LSH_ROWS (ETHERVOX_MEMORY_MINHASH_SIZE / ETHERVOX_MEMORY_LSH_BANDS)
+#define CHAIN_END UINT32_MAX
+
+// Candidates whose signature estimate falls this far below the threshold are skipped
+#define ESTIMATE_MARGIN 0.2f
+
+static const char* const k_exempt_tags[] = { ETHERVOX_MEMORY_DEDUP_EXEMPT_TAGS };
+
+void memory_dedup_rebuild_internal(ethervox_memory_store_t* store);
+
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static bool is_word_byte(unsigned char c) {
+    return isalnum(c) || c >= 0x80;  // Keep UTF-8 sequences inside words
+}
+
+// ---------------------------------------------------------------------------
+// Shingling
+// ---------------------------------------------------------------------------
+
+// Call fn(hash, ctx) for every word unigram and bigram of text
+static void for_each_shingle(const char* text, void (*fn)(uint64_t, void*), void* ctx) {
+    uint64_t prev = 0;
+    bool have_prev = false;
+    const unsigned char* p = (const unsigned char*)text;
+
+    while (*p) {
+        while (*p && !is_word_byte(*p)) {
+            p++;
+        }
+        if (!*p) {
+            break;
+        }
+
+        uint64_t word = 1469598103934665603ull;  // FNV-1a over the lowercased word
+        while (*p && is_word_byte(*p)) {
+            word ^= (uint64_t)tolower(*p);
+            word *= 1099511628211ull;
+            p++;
+        }
+
+        fn(word, ctx);
+        if (have_prev) {
+            fn(mix64(prev * 31 + word), ctx);
+        }
+        prev = word;
+        have_prev = true;
+    }
+}
+
+static void minhash_update(uint64_t shingle, void* ctx) {
+    uint32_t* sig = ctx;
+    for (uint32_t i = 0; i < ETHERVOX_MEMORY_MINHASH_SIZE; i++) {
+        uint32_t h = (uint32_t)mix64(shingle + (uint64_t)i * 0xD6E8FEB86659FD93ull);
+        if (h < sig[i]) {
+            sig[i] = h;
+        }
+    }
+}
+
+// Compute the MinHash signature of text; false if it has no words
+static bool sketch_text(const char* text, uint32_t* sig) {
+    for (uint32_t i = 0; i < ETHERVOX_MEMORY_MINHASH_SIZE; i++) {
+        sig[i] = UINT32_MAX;
+    }
+    for_each_shingle(text, minhash_update, sig);
+    return sig[0] != UINT32_MAX;
+}
+
+typedef struct {
+    uint64_t* hashes;
+    uint32_t count;
+    uint32_t capacity;
+    bool failed;
+} shingle_set_t;
+
+static void shingle_set_push(uint64_t shingle, void* ctx) {
+    shingle_set_t* set = ctx;
+    if (set->failed) {
+        return;
+    }
+    if (set->count >= set->capacity) {
+        uint32_t new_capacity = set->capacity ? set->capacity * 2 : 64;
+        uint64_t* hashes = realloc(set->hashes, new_capacity * sizeof(uint64_t));
+        if (!hashes) {
+            set->failed = true;
+            return;
+        }
+        set->hashes = hashes;
+        set->capacity = new_capacity;
+    }
+    set->hashes[set->count++] = shingle;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Sorted, de-duplicated shingle hashes of text
+static bool build_shingle_set(const char* text, shingle_set_t* set) {
+    memset(set, 0, sizeof(*set));
+    for_each_shingle(text, shingle_set_push, set);
+    if (set->failed) {
+        free(set->hashes);
+        return false;
+    }
+    if (set->count > 1) {
+        qsort(set->hashes, set->count, sizeof(uint64_t), compare_u64);
+        uint32_t unique = 1;
+        for (uint32_t i = 1; i < set->count; i++) {
+            if (set->hashes[i] != set->hashes[unique - 1]) {
+                set->hashes[unique++] = set->hashes[i];
+            }
+        }
+        set->count = unique;
+    }
+    return true;
+}
+
+static float exact_jaccard(const shingle_set_t* a, const shingle_set_t* b) {
+    if (a->count == 0 || b->count == 0) {
+        return 0.0f;
+    }
+    uint32_t i = 0, j = 0, shared = 0;
+    while (i < a->count && j < b->count) {
+        if (a->hashes[i] == b->hashes[j]) {
+            shared++;
+            i++;
+            j++;
+        } else if (a->hashes[i] < b->hashes[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return (float)shared / (float)(a->count + b->count - shared);
+}
+
+// ---------------------------------------------------------------------------
+// LSH table
+// ---------------------------------------------------------------------------
+
+static uint32_t band_key(const uint32_t* sig, uint32_t band) {
+    uint64_t h = band;
+    for (uint32_t r = 0; r < LSH_ROWS; r++) {
+        h = mix64(h ^ sig[band * LSH_ROWS + r]);
+    }
+    return (uint32_t)h;
+}
+
+static uint32_t bucket_of(const ethervox_memory_store_t* store, uint32_t key, uint32_t band) {
+    return (uint32_t)mix64(((uint64_t)band << 32) | key) & (store->dedup_bucket_count - 1);
+}
+
+static void link_entry(ethervox_memory_store_t* store, uint32_t ordinal) {
+    for (uint32_t b = 0; b < ETHERVOX_MEMORY_LSH_BANDS; b++) {
+        uint32_t node = ordinal * ETHERVOX_MEMORY_LSH_BANDS + b;
+        uint32_t bucket = bucket_of(store, store->dedup_band_keys[node], b);
+        store->dedup_next[node] = store->dedup_buckets[bucket];
+        store->dedup_buckets[bucket] = node;
+    }
+}
+
+static void unlink_entry(ethervox_memory_store_t* store, uint32_t ordinal) {
+    for (uint32_t b = 0; b < ETHERVOX_MEMORY_LSH_BANDS; b++) {
+        uint32_t node = ordinal * ETHERVOX_MEMORY_LSH_BANDS + b;
+        uint32_t* link = &store->dedup_buckets[bucket_of(store, store->dedup_band_keys[node], b)];
+        while (*link != CHAIN_END && *link != node) {
+            link = &store->dedup_next[*link];
+        }
+        if (*link == node) {
+            *link = store->dedup_next[node];
+        }
+    }
+}
+
+static void set_signature(ethervox_memory_store_t* store, uint32_t ordinal, const uint32_t* sig) {
+    memcpy(&store->dedup_signatures[(size_t)ordinal * ETHERVOX_MEMORY_MINHASH_SIZE], sig,
+           ETHERVOX_MEMORY_MINHASH_SIZE * sizeof(uint32_t));
+    for (uint32_t b = 0; b < ETHERVOX_MEMORY_LSH_BANDS; b++) {
+        store->dedup_band_keys[ordinal * ETHERVOX_MEMORY_LSH_BANDS + b] = band_key(sig, b);
+    }
+}
+
+// Size per-entry arrays for `needed` ordinals and re-bucket the linked ones
+static bool reserve_capacity(ethervox_memory_store_t* store, uint32_t needed) {
+    if (needed <= store->dedup_capacity && store->dedup_buckets) {
+        return true;
+    }
+
+    uint32_t new_capacity = store->dedup_capacity ? store->dedup_capacity : 256;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    uint32_t* signatures = realloc(store->dedup_signatures,
+        (size_t)new_capacity * ETHERVOX_MEMORY_MINHASH_SIZE * sizeof(uint32_t));
+    if (!signatures) {
+        return false;
+    }
+    store->dedup_signatures = signatures;
+
+    uint32_t* keys = realloc(store->dedup_band_keys,
+        (size_t)new_capacity * ETHERVOX_MEMORY_LSH_BANDS * sizeof(uint32_t));
+    if (!keys) {
+        return false;
+    }
+    store->dedup_band_keys = keys;
+
+    uint32_t* next = realloc(store->dedup_next,
+        (size_t)new_capacity * ETHERVOX_MEMORY_LSH_BANDS * sizeof(uint32_t));
+    if (!next) {
+        return false;
+    }
+    store->dedup_next = next;
+
+    // About one bucket per band node keeps chains short
+    uint32_t bucket_count = 1;
+    while (bucket_count < new_capacity * ETHERVOX_MEMORY_LSH_BANDS) {
+        bucket_count <<= 1;
+    }
+    uint32_t* buckets = malloc(bucket_count * sizeof(uint32_t));
+    if (!buckets) {
+        return false;
+    }
+    free(store->dedup_buckets);
+    store->dedup_buckets = buckets;
+    store->dedup_bucket_count = bucket_count;
+    store->dedup_capacity = new_capacity;
+
+    memset(store->dedup_buckets, 0xFF, bucket_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < store->dedup_indexed; i++) {
+        link_entry(store, i);
+    }
+    return true;
+}
+
+static bool has_exempt_tag(const char* const tags[], uint32_t tag_count) {
+    for (uint32_t i = 0; i < tag_count; i++) {
+        for (size_t e = 0; e < sizeof(k_exempt_tags) / sizeof(k_exempt_tags[0]); e++) {
+            if (strcmp(tags[i], k_exempt_tags[e]) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool entry_is_exempt(const ethervox_memory_entry_t* entry) {
+    const char* tags[ETHERVOX_MEMORY_MAX_TAGS];
+    for (uint32_t i = 0; i < entry->tag_count; i++) {
+        tags[i] = entry->tags[i];
+    }
+    return has_exempt_tag(tags, entry->tag_count);
+}
+
+// ---------------------------------------------------------------------------
+// Internal API (used by memory_core.c)
+// ---------------------------------------------------------------------------
+
+// Compute the MinHash signature for text (ETHERVOX_MEMORY_MINHASH_SIZE slots)
+void memory_dedup_sketch_internal(const char* text, uint32_t* signature_out) {
+    sketch_text(text ? text : "", signature_out);
+}
+
+// Find an existing entry that text duplicates. Returns its ordinal, or
+// UINT32_MAX when dedup is off, the new entry is exempt, or nothing matches.
+uint32_t memory_dedup_find_internal(
+    const ethervox_memory_store_t* store,
+    const char* text,
+    const char* tags[],
+    uint32_t tag_count,
+    const uint32_t* signature,
+    float* similarity_out
+) {
+    if (!store || store->dedup_mode == ETHERVOX_MEMORY_DEDUP_OFF || !store->dedup_buckets ||
+        !text || signature[0] == UINT32_MAX || has_exempt_tag(tags, tag_count)) {
+        return UINT32_MAX;
+    }
+
+    float threshold = store->dedup_threshold > 0.0f ? store->dedup_threshold : ETHERVOX_MEMORY_DEDUP_THRESHOLD;
+    shingle_set_t text_set;
+    bool have_text_set = false;
+    uint32_t best = UINT32_MAX;
+    float best_similarity = 0.0f;
+
+    for (uint32_t b = 0; b < ETHERVOX_MEMORY_LSH_BANDS; b++) {
+        uint32_t key = band_key(signature, b);
+        for (uint32_t node = store->dedup_buckets[bucket_of(store, key, b)];
+             node != CHAIN_END;
+             node = store->dedup_next[node]) {
+            uint32_t ordinal = node / ETHERVOX_MEMORY_LSH_BANDS;
+            if (node % ETHERVOX_MEMORY_LSH_BANDS != b || store->dedup_band_keys[node] != key ||
+                ordinal == best || ordinal >= store->entry_count) {
+                continue;
+            }
+
+            // Cheap estimate from the signatures first
+            const uint32_t* other = &store->dedup_signatures[(size_t)ordinal * ETHERVOX_MEMORY_MINHASH_SIZE];
+            uint32_t agree = 0;
+            for (uint32_t i = 0; i < ETHERVOX_MEMORY_MINHASH_SIZE; i++) {
+                agree += (other[i] == signature[i]);
+            }
+            float estimate = (float)agree / (float)ETHERVOX_MEMORY_MINHASH_SIZE;
+            if (estimate + ESTIMATE_MARGIN < threshold) {
+                continue;
+            }
+
+            const ethervox_memory_entry_t* entry = &store->entries[ordinal];
+            if (entry_is_exempt(entry)) {
+                continue;
+            }
+
+            // Confirm with the exact shingle-set similarity
+            if (!have_text_set) {
+                if (!build_shingle_set(text, &text_set)) {
+                    return best;
+                }
+                have_text_set = true;
+            }
+            shingle_set_t entry_set;
+            if (!build_shingle_set(entry->text, &entry_set)) {
+                continue;
+            }
+            float similarity = exact_jaccard(&text_set, &entry_set);
+            free(entry_set.hashes);
+
+            if (similarity >= threshold && similarity > best_similarity) {
+                best = ordinal;
+                best_similarity = similarity;
+            }
+        }
+    }
+
+    if (have_text_set) {
+        free(text_set.hashes);
+    }
+    if (similarity_out) {
+        *similarity_out = best_similarity;
+    }
+    return best;
+}
+
+// Index store->entries[ordinal]; signature may be NULL to compute it here
+void memory_dedup_add_entry_internal(
+    ethervox_memory_store_t* store,
+    uint32_t ordinal,
+    const uint32_t* signature
+) {
+    if (!store) {
+        return;
+    }
+    if (ordinal != store->dedup_indexed) {
+        // Entries were appended without indexing (bulk load) - catch up fully
+        memory_dedup_rebuild_internal(store);
+        return;
+    }
+    if (!reserve_capacity(store, ordinal + 1)) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                    "Out of memory growing duplicate index");
+        return;
+    }
+
+    uint32_t sig[ETHERVOX_MEMORY_MINHASH_SIZE];
+    if (!signature) {
+        sketch_text(store->entries[ordinal].text, sig);
+        signature = sig;
+    }
+    set_signature(store, ordinal, signature);
+    link_entry(store, ordinal);
+    store->dedup_indexed = ordinal + 1;
+}
+
+// Re-sketch store->entries[ordinal] after its text changed
+void memory_dedup_update_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal) {
+    if (!store || ordinal >= store->dedup_indexed) {
+        return;
+    }
+    uint32_t sig[ETHERVOX_MEMORY_MINHASH_SIZE];
+    sketch_text(store->entries[ordinal].text, sig);
+    unlink_entry(store, ordinal);
+    set_signature(store, ordinal, sig);
+    link_entry(store, ordinal);
+}
+
+// Re-sketch and re-link every entry (after compaction or bulk import)
+void memory_dedup_rebuild_internal(ethervox_memory_store_t* store) {
+    if (!store || !store->is_initialized) {
+        return;
+    }
+
+    store->dedup_indexed = 0;
+    if (!reserve_capacity(store, store->entry_count > 0 ? store->entry_count : 1)) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                    "Out of memory rebuilding duplicate index");
+        return;
+    }
+    memset(store->dedup_buckets, 0xFF, store->dedup_bucket_count * sizeof(uint32_t));
+
+    uint32_t sig[ETHERVOX_MEMORY_MINHASH_SIZE];
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        sketch_text(store->entries[i].text, sig);
+        set_signature(store, i, sig);
+        link_entry(store, i);
+    }
+    store->dedup_indexed = store->entry_count;
+}
+
+void memory_dedup_free_internal(ethervox_memory_store_t* store) {
+    if (!store) {
+        return;
+    }
+    free(store->dedup_signatures);
+    free(store->dedup_band_keys);
+    free(store->dedup_next);
+    free(store->dedup_buckets);
+    store->dedup_signatures = NULL;
+    store->dedup_band_keys = NULL;
+    store->dedup_next = NULL;
+    store->dedup_buckets = NULL;
+    store->dedup_bucket_count = 0;
+    store->dedup_capacity = 0;
+    store->dedup_indexed = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+ethervox_result_t ethervox_memory_set_dedup(
+    ethervox_memory_store_t* store,
+    ethervox_memory_dedup_mode_t mode,
+    float threshold
+) {
+    if (!store || !store->is_initialized || mode > ETHERVOX_MEMORY_DEDUP_REJECT || threshold > 1.0f) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    store->dedup_mode = mode;
+    store->dedup_threshold = (threshold > 0.0f) ? threshold : ETHERVOX_MEMORY_DEDUP_THRESHOLD;
+    return ETHERVOX_SUCCESS;
+}
@@ -48,6 +48,13 @@ extern int memory_update_tags_internal(
     bool persist_to_log
 );
 
+// Internal function from memory_core.c for applying merged importance from UPDATE records
+extern int memory_set_importance_internal(
+    ethervox_memory_store_t* store,
+    uint64_t memory_id,
+    float importance
+);
+
 // Format timestamp for display
 static void format_timestamp(time_t timestamp, char* buf, size_t len) {
     struct tm* tm_info = localtime(&timestamp);
@@ -221,8 +228,91 @@ ethervox_result_t ethervox_memory_export(
     return ETHERVOX_SUCCESS;
 }
 
-// Helper function to process a single JSON entry (used by both structured JSON and JSONL import)
-static bool process_json_entry(ethervox_memory_store_t* store, const char* line) {
+// Parse a quoted JSON string array ("tags":[...] / "tools":[...]) into fixed slots
+static uint32_t parse_string_array(const char* array_start, char* out, size_t slot_len, uint32_t max_slots) {
+    uint32_t count = 0;
+
+    const char* cursor = strchr(array_start, '[');
+    if (!cursor) return 0;
+    cursor++;  // Skip '['
+    const char* array_end = strchr(cursor, ']');
+    if (!array_end) return 0;
+
+    while (cursor < array_end && count < max_slots) {
+        // Skip whitespace and commas
+        while (cursor < array_end && (*cursor == ' ' || *cursor == ',' ||
+               *cursor == '\n' || *cursor == '\r' || *cursor == '\t')) {
+            cursor++;
+        }
+
+        if (cursor >= array_end || *cursor != '"') {
+            break;
+        }
+        cursor++;  // Skip opening quote
+
+        // Find closing quote
+        const char* item_end = cursor;
+        while (item_end < array_end && *item_end != '"') {
+            item_end++;
+        }
+        if (item_end >= array_end) {
+            break;
+        }
+
+        size_t item_len = item_end - cursor;
+        if (item_len > 0 && item_len < slot_len) {
+            memcpy(out + count * slot_len, cursor, item_len);
+            out[count * slot_len + item_len] = '\0';
+            count++;
+        }
+        cursor = item_end + 1;
+    }
+
+    return count;
+}
+
+// Copy the JSON string value that starts right after its opening quote, unescaping it
+static bool parse_escaped_string(const char* value_start, char* out, size_t out_size) {
+    // Find closing quote (handle escaped quotes)
+    const char* value_end = value_start;
+    while (*value_end) {
+        if (*value_end == '"' && (value_end == value_start || *(value_end - 1) != '\\')) {
+            break;
+        }
+        value_end++;
+    }
+
+    if (*value_end != '"') return false;
+
+    // Copy and unescape text
+    size_t value_len = value_end - value_start;
+    if (value_len >= out_size) value_len = out_size - 1;
+
+    size_t out_idx = 0;
+    for (size_t i = 0; i < value_len && out_idx < out_size - 1; i++) {
+        if (value_start[i] == '\\' && i + 1 < value_len) {
+            i++;
+            if (value_start[i] == 'n') out[out_idx++] = '\n';
+            else if (value_start[i] == 'r') out[out_idx++] = '\r';
+            else if (value_start[i] == 't') out[out_idx++] = '\t';
+            else out[out_idx++] = value_start[i];
+        } else {
+            out[out_idx++] = value_start[i];
+        }
+    }
+    out[out_idx] = '\0';
+
+    return true;
+}
+
+// Parse one memory entry object (JSONL ADD record or structured JSON entry).
+// Does not touch the store, so the parallel importer calls it from worker threads.
+// Non-static for use in memory_import.c.
+bool memory_parse_entry_line(const char* line, ethervox_memory_entry_t* out) {
+    if (!line || !out) {
+        return false;
+    }
+
     // Check for special operations first
     if (strstr(line, "\"op\":\"delete\"") || strstr(line, "\"op\":\"update\"") || 
         strstr(line, "\"op\":\"update_text\"")) {
@@ -231,54 +321,51 @@ static bool process_json_entry(ethervox_memory_store_t* store, const char* line)
         return false;
     }
     
-    // Parse memory entry fields
-    uint64_t id = 0, turn_id = 0;
-    long timestamp = 0;
-    float importance = 0.5f;
-    bool is_user = false;
-    char text[ETHERVOX_MEMORY_MAX_TEXT_LEN] = {0};
-    
     // Extract numeric fields
-    char* id_ptr = strstr(line, "\"memory_id\":");
+    const char* id_ptr = strstr(line, "\"memory_id\":");
     if (!id_ptr) id_ptr = strstr(line, "\"id\":");  // Fallback for JSONL format
     
-    char* turn_ptr = strstr(line, "\"turn_id\":");
+    const char* turn_ptr = strstr(line, "\"turn_id\":");
     if (!turn_ptr) turn_ptr = strstr(line, "\"turn\":");  // Fallback
     
-    char* ts_ptr = strstr(line, "\"timestamp\":");
+    const char* ts_ptr = strstr(line, "\"timestamp\":");
     if (!ts_ptr) ts_ptr = strstr(line, "\"ts\":");  // Fallback
     
-    char* imp_ptr = strstr(line, "\"importance\":");
+    const char* imp_ptr = strstr(line, "\"importance\":");
     if (!imp_ptr) imp_ptr = strstr(line, "\"imp\":");  // Fallback
     
-    char* user_ptr = strstr(line, "\"is_user\":");
+    const char* user_ptr = strstr(line, "\"is_user\":");
     if (!user_ptr) user_ptr = strstr(line, "\"user\":");  // Fallback
     
     if (!id_ptr || !turn_ptr || !ts_ptr || !imp_ptr || !user_ptr) {
         return false;  // Missing required fields
     }
     
+    memset(out, 0, sizeof(*out));
+
     // Parse values
-    id = strtoull(strchr(id_ptr, ':') + 1, NULL, 10);
-    turn_id = strtoull(strchr(turn_ptr, ':') + 1, NULL, 10);
-    timestamp = strtol(strchr(ts_ptr, ':') + 1, NULL, 10);
-    importance = strtof(strchr(imp_ptr, ':') + 1, NULL);
+    out->memory_id = strtoull(strchr(id_ptr, ':') + 1, NULL, 10);
+    out->turn_id = strtoull(strchr(turn_ptr, ':') + 1, NULL, 10);
+    out->timestamp = (time_t)strtol(strchr(ts_ptr, ':') + 1, NULL, 10);
+    out->importance = strtof(strchr(imp_ptr, ':') + 1, NULL);
+    if (out->importance < 0.0f) out->importance = 0.0f;
+    if (out->importance > 1.0f) out->importance = 1.0f;
     
     // Check is_user boolean - only check the value immediately after the colon
     // Find the value start (skip whitespace after colon)
-    char* user_value = strchr(user_ptr, ':');
+    const char* user_value = strchr(user_ptr, ':');
     if (user_value) {
         user_value++;  // Skip colon
         while (*user_value == ' ' || *user_value == '\t') user_value++;
         
         // Check if value starts with 'true' (not just contains it somewhere)
         if (strncmp(user_value, "true", 4) == 0) {
-            is_user = true;
+            out->is_user_message = true;
         }
     }
     
     // Extract text field
-    char* text_start = strstr(line, "\"text\":");
+    const char* text_start = strstr(line, "\"text\":");
     if (!text_start) return false;
     
     // Find the colon after "text"
@@ -297,193 +384,149 @@ static bool process_json_entry(ethervox_memory_store_t* store, const char* line)
     }
     text_start++;  // Skip opening quote
     
-    ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
-                "Parsing text field, first 50 chars: '%.50s'", text_start);
-    
-    // Find closing quote (handle escaped quotes)
-    char* text_end = text_start;
-    while (*text_end) {
-        if (*text_end == '"' && (text_end == text_start || *(text_end - 1) != '\\')) {
-            break;
-        }
-        text_end++;
-    }
-    
-    if (*text_end != '"') return false;
-    
-    // Copy and unescape text
-    size_t text_len = text_end - text_start;
-    if (text_len >= sizeof(text)) text_len = sizeof(text) - 1;
-    
-    size_t out_idx = 0;
-    for (size_t i = 0; i < text_len && out_idx < sizeof(text) - 1; i++) {
-        if (text_start[i] == '\\' && i + 1 < text_len) {
-            i++;
-            if (text_start[i] == 'n') text[out_idx++] = '\n';
-            else if (text_start[i] == 'r') text[out_idx++] = '\r';
-            else if (text_start[i] == 't') text[out_idx++] = '\t';
-            else if (text_start[i] == '"') text[out_idx++] = '"';
-            else if (text_start[i] == '\\') text[out_idx++] = '\\';
-            else text[out_idx++] = text_start[i];
-        } else {
-            text[out_idx++] = text_start[i];
-        }
+    if (!parse_escaped_string(text_start, out->text, sizeof(out->text))) {
+        return false;
     }
-    text[out_idx] = '\0';
     
     // Parse tags array
-    const char* tag_array[ETHERVOX_MEMORY_MAX_TAGS];
-    uint32_t tag_count = 0;
-    char tag_storage[ETHERVOX_MEMORY_MAX_TAGS][ETHERVOX_MEMORY_TAG_LEN];
-    
-    char* tags_start = strstr(line, "\"tags\":");
+    const char* tags_start = strstr(line, "\"tags\":");
     if (tags_start) {
-        tags_start = strchr(tags_start, '[');
-        if (tags_start) {
-            tags_start++;  // Skip '['
-            char* tags_end = strchr(tags_start, ']');
-            
-            if (tags_end) {
-                char* tag_cursor = tags_start;
-                while (tag_cursor < tags_end && tag_count < ETHERVOX_MEMORY_MAX_TAGS) {
-                    // Skip whitespace and commas
-                    while (tag_cursor < tags_end && (*tag_cursor == ' ' || *tag_cursor == ',' || 
-                           *tag_cursor == '\n' || *tag_cursor == '\r' || *tag_cursor == '\t')) {
-                        tag_cursor++;
-                    }
-                    
-                    if (*tag_cursor == '"') {
-                        tag_cursor++;  // Skip opening quote
-                        char* tag_end = tag_cursor;
-                        
-                        // Find closing quote
-                        while (tag_end < tags_end && *tag_end != '"') {
-                            tag_end++;
-                        }
-                        
-                        if (tag_end < tags_end && *tag_end == '"') {
-                            size_t tag_len = tag_end - tag_cursor;
-                            if (tag_len > 0 && tag_len < ETHERVOX_MEMORY_TAG_LEN) {
-                                memcpy(tag_storage[tag_count], tag_cursor, tag_len);
-                                tag_storage[tag_count][tag_len] = '\0';
-                                tag_array[tag_count] = tag_storage[tag_count];
-                                tag_count++;
-                            }
-                            tag_cursor = tag_end + 1;
-                        } else {
-                            break;
-                        }
-                    } else {
-                        break;
-                    }
-                }
-            }
-        }
+        out->tag_count = parse_string_array(tags_start, &out->tags[0][0],
+                                            ETHERVOX_MEMORY_TAG_LEN, ETHERVOX_MEMORY_MAX_TAGS);
     }
     
     // Add "imported" tag if not already present
     bool has_imported = false;
-    for (uint32_t i = 0; i < tag_count; i++) {
-        if (strcmp(tag_array[i], "imported") == 0) {
+    for (uint32_t i = 0; i < out->tag_count; i++) {
+        if (strcmp(out->tags[i], "imported") == 0) {
             has_imported = true;
             break;
         }
     }
     
-    if (!has_imported && tag_count < ETHERVOX_MEMORY_MAX_TAGS) {
-        strcpy(tag_storage[tag_count], "imported");
-        tag_array[tag_count] = tag_storage[tag_count];
-        tag_count++;
-        ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
-                    "Added 'imported' tag (total tags now: %u)", tag_count);
-    }
-    
-    // Ensure at least one tag
-    if (tag_count == 0) {
-        strcpy(tag_storage[0], "imported");
-        tag_array[0] = tag_storage[0];
-        tag_count = 1;
+    if (!has_imported && out->tag_count < ETHERVOX_MEMORY_MAX_TAGS) {
+        strcpy(out->tags[out->tag_count], "imported");
+        out->tag_count++;
     }
     
     // Parse tools array (if present)
-    char tools_storage[16][64];
-    uint32_t tools_count = 0;
-    
     // Try both "tools_called" (current format) and "tools" (legacy format)
-    char* tools_start = strstr(line, "\"tools_called\":");
+    const char* tools_start = strstr(line, "\"tools_called\":");
     if (!tools_start) {
         tools_start = strstr(line, "\"tools\":");
     }
     
     if (tools_start) {
-        ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
-                    "Found tools field in JSONL line");
-        tools_start = strchr(tools_start, '[');
-        if (tools_start) {
-            tools_start++;  // Skip '['
-            char* tools_end = strchr(tools_start, ']');
-            
-            if (tools_end) {
-                char* tool_cursor = tools_start;
-                while (tool_cursor < tools_end && tools_count < 16) {
-                    // Skip whitespace and commas
-                    while (tool_cursor < tools_end && (*tool_cursor == ' ' || *tool_cursor == ',' || 
-                           *tool_cursor == '\n' || *tool_cursor == '\r' || *tool_cursor == '\t')) {
-                        tool_cursor++;
-                    }
-                    
-                    if (*tool_cursor == '"') {
-                        tool_cursor++;  // Skip opening quote
-                        char* tool_end = tool_cursor;
-                        
-                        // Find closing quote
-                        while (tool_end < tools_end && *tool_end != '"') {
-                            tool_end++;
-                        }
-                        
-                        if (tool_end < tools_end && *tool_end == '"') {
-                            size_t tool_len = tool_end - tool_cursor;
-                            if (tool_len > 0 && tool_len < 64) {
-                                memcpy(tools_storage[tools_count], tool_cursor, tool_len);
-                                tools_storage[tools_count][tool_len] = '\0';
-                                ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
-                                            "Parsed tool %u: '%s'", tools_count, tools_storage[tools_count]);
-                                tools_count++;
-                            }
-                            tool_cursor = tool_end + 1;
-                        } else {
-                            break;
-                        }
-                    } else {
-                        break;
-                    }
-                }
-            }
+        out->tools_called_count = parse_string_array(tools_start, &out->tools_called[0][0],
+                                                     sizeof(out->tools_called[0]), 16);
+    }
+    
+    return true;
+}
+
+// Parse a {"op":"delete","id":N} record. Non-static for use in memory_import.c.
+bool memory_parse_delete_line(const char* line, uint64_t* memory_id) {
+    if (!strstr(line, "\"op\":\"delete\"")) {
+        return false;
+    }
+    const char* id_ptr = strstr(line, "\"id\":");
+    if (!id_ptr) {
+        return false;
+    }
+    *memory_id = strtoull(id_ptr + 5, NULL, 10);
+    return true;
+}
+
+// Parse a {"op":"update_text","id":N,"text":"..."} record. Non-static for use in memory_import.c.
+bool memory_parse_update_text_line(const char* line, uint64_t* memory_id, char* text_out, size_t text_size) {
+    if (!strstr(line, "\"op\":\"update_text\"")) {
+        return false;
+    }
+    const char* id_ptr = strstr(line, "\"id\":");
+    if (!id_ptr) {
+        return false;
+    }
+    *memory_id = strtoull(id_ptr + 5, NULL, 10);
+
+    const char* text_start = strstr(line, "\"text\":\"");
+    if (!text_start) {
+        return false;
+    }
+    return parse_escaped_string(text_start + 8, text_out, text_size);  // Skip "text":"
+}
+
+// Parse a {"op":"update","id":N,"tags":[...]} record. Duplicate merges also
+// carry "imp"; *importance_out is -1 when it is absent. Non-static for use in memory_import.c.
+bool memory_parse_update_tags_line(
+    const char* line,
+    uint64_t* memory_id,
+    char tags_out[][ETHERVOX_MEMORY_TAG_LEN],
+    uint32_t* tag_count,
+    float* importance_out
+) {
+    if (!strstr(line, "\"op\":\"update\"")) {
+        return false;
+    }
+    const char* id_ptr = strstr(line, "\"id\":");
+    if (!id_ptr) {
+        return false;
+    }
+    *memory_id = strtoull(id_ptr + 5, NULL, 10);
+
+    *tag_count = 0;
+    const char* tags_start = strstr(line, "\"tags\":[");
+    if (tags_start) {
+        *tag_count = parse_string_array(tags_start, &tags_out[0][0],
+                                        ETHERVOX_MEMORY_TAG_LEN, ETHERVOX_MEMORY_MAX_TAGS);
+    }
+
+    if (importance_out) {
+        *importance_out = -1.0f;
+        const char* imp_ptr = strstr(line, "\"imp\":");
+        if (imp_ptr) {
+            float importance = strtof(imp_ptr + 6, NULL);
+            if (importance < 0.0f) importance = 0.0f;
+            if (importance > 1.0f) importance = 1.0f;
+            *importance_out = importance;
         }
     }
+    return true;
+}
+
+// Helper function to process a single JSON entry (used by both structured JSON and JSONL import)
+static bool process_json_entry(ethervox_memory_store_t* store, const char* line) {
+    ethervox_memory_entry_t* parsed = malloc(sizeof(ethervox_memory_entry_t));
+    if (!parsed) {
+        return false;
+    }
+
+    if (!memory_parse_entry_line(line, parsed)) {
+        free(parsed);
+        return false;
+    }
+
+    const char* tag_array[ETHERVOX_MEMORY_MAX_TAGS];
+    for (uint32_t i = 0; i < parsed->tag_count; i++) {
+        tag_array[i] = parsed->tags[i];
+    }
     
     // Add memory with original metadata
     uint64_t memory_id_out;
-    ethervox_result_t result = memory_store_add_internal(store, text, tag_array, tag_count,
-                                     importance, is_user, id, turn_id,
-                                     timestamp, &memory_id_out);
+    ethervox_result_t result = memory_store_add_internal(store, parsed->text, tag_array, parsed->tag_count,
+                                     parsed->importance, parsed->is_user_message, parsed->memory_id,
+                                     parsed->turn_id, parsed->timestamp, &memory_id_out);
     
     // If tools were found, add them to the entry
-    if (result == 0 && tools_count > 0) {
-        ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
-                    "Attempting to set %u tools on memory ID %llu", 
-                    tools_count, (unsigned long long)memory_id_out);
+    if (result == 0 && parsed->tools_called_count > 0) {
         // Find the entry we just added and set its tools
         bool found = false;
         for (uint32_t i = 0; i < store->entry_count; i++) {
             if (store->entries[i].memory_id == memory_id_out) {
-                store->entries[i].tools_called_count = tools_count;
-                for (uint32_t t = 0; t < tools_count; t++) {
-                    snprintf(store->entries[i].tools_called[t], 64, "%s", tools_storage[t]);
-                }
-                ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
-                            "Successfully set %u tools on memory ID %llu", 
-                            tools_count, (unsigned long long)memory_id_out);
+                store->entries[i].tools_called_count = parsed->tools_called_count;
+                memcpy(store->entries[i].tools_called, parsed->tools_called, sizeof(parsed->tools_called));
+                ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
+                            "Set %u tools on memory ID %llu", 
+                            parsed->tools_called_count, (unsigned long long)memory_id_out);
                 found = true;
                 break;
             }
@@ -495,18 +538,15 @@ static bool process_json_entry(ethervox_memory_store_t* store, const char* line)
         }
     }
     
+    free(parsed);
     return (result == 0);
 }
 
-ethervox_result_t ethervox_memory_import(
+static ethervox_result_t import_file(
     ethervox_memory_store_t* store,
     const char* filepath,
     uint32_t* turns_loaded
 ) {
-    if (!store || !store->is_initialized || !filepath) {
-        return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    }
-    
     FILE* fp = fopen(filepath, "r");
     if (!fp) {
         ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__,
@@ -529,6 +569,25 @@ ethervox_result_t ethervox_memory_import(
         is_structured_json = true;
     }
     
+#ifndef _WIN32
+    if (!is_structured_json) {
+        // Large JSONL logs go through the mmap + worker thread fast path
+        fseek(fp, 0, SEEK_END);
+        long file_size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        
+        if (file_size >= ETHERVOX_MEMORY_PARALLEL_IMPORT_MIN_BYTES) {
+            fclose(fp);
+            ethervox_memory_import_stats_t stats;
+            ethervox_result_t result = ethervox_memory_import_parallel(store, filepath, 0, &stats);
+            if (turns_loaded) {
+                *turns_loaded = ethervox_is_success(result) ? stats.entries_loaded : 0;
+            }
+            return result;
+        }
+    }
+#endif
+    
     if (is_structured_json) {
         // Read entire file for structured JSON parsing
         fseek(fp, 0, SEEK_END);
@@ -618,15 +677,10 @@ ethervox_result_t ethervox_memory_import(
     uint32_t loaded = 0;
     
     while (fgets(line, sizeof(line), fp)) {
+        uint64_t memory_id = 0;
+
         // Check if this is a DELETE operation
-        char* delete_op = strstr(line, "\"op\":\"delete\"");
-        if (delete_op) {
-            // Handle DELETE record - remove memory by ID
-            char* id_ptr = strstr(line, "\"id\":");
-            if (!id_ptr) continue;
-            
-            uint64_t memory_id = strtoull(id_ptr + 5, NULL, 10);
-            
+        if (memory_parse_delete_line(line, &memory_id)) {
             // Delete the memory entry without persisting (we're already reading from file)
             uint32_t deleted = 0;
             memory_delete_by_ids_internal(store, &memory_id, 1, false, &deleted);
@@ -644,102 +698,28 @@ ethervox_result_t ethervox_memory_import(
         }
         
         // Check if this is an UPDATE_TEXT operation
-        char* update_text_op = strstr(line, "\"op\":\"update_text\"");
-        if (update_text_op) {
+        if (strstr(line, "\"op\":\"update_text\"")) {
             // Handle UPDATE_TEXT record - update text content for existing memory
-            char* id_ptr = strstr(line, "\"id\":");
-            if (!id_ptr) continue;
-            
-            uint64_t memory_id = strtoull(id_ptr + 5, NULL, 10);
-            
-            // Parse new text
-            char* text_start = strstr(line, "\"text\":\"");
-            if (text_start) {
-                text_start += 8;  // Skip "text":"
-                char* text_end = text_start;
-                
-                // Find end quote, handling escaped quotes
-                while (*text_end) {
-                    if (*text_end == '"' && (text_end == text_start || *(text_end - 1) != '\\')) {
-                        break;
-                    }
-                    text_end++;
-                }
-                
-                if (*text_end == '"') {
-                    char new_text[ETHERVOX_MEMORY_MAX_TEXT_LEN];
-                    size_t text_len = text_end - text_start;
-                    if (text_len >= ETHERVOX_MEMORY_MAX_TEXT_LEN) {
-                        text_len = ETHERVOX_MEMORY_MAX_TEXT_LEN - 1;
-                    }
-                    
-                    // Copy and unescape
-                    size_t out_idx = 0;
-                    for (size_t i = 0; i < text_len && out_idx < ETHERVOX_MEMORY_MAX_TEXT_LEN - 1; i++) {
-                        if (text_start[i] == '\\' && i + 1 < text_len) {
-                            i++;
-                            if (text_start[i] == 'n') new_text[out_idx++] = '\n';
-                            else if (text_start[i] == 'r') new_text[out_idx++] = '\r';
-                            else if (text_start[i] == 't') new_text[out_idx++] = '\t';
-                            else new_text[out_idx++] = text_start[i];
-                        } else {
-                            new_text[out_idx++] = text_start[i];
-                        }
-                    }
-                    new_text[out_idx] = '\0';
-                    
-                    // Apply update
-                    ethervox_memory_update_text(store, memory_id, new_text);
-                }
+            char new_text[ETHERVOX_MEMORY_MAX_TEXT_LEN];
+            if (memory_parse_update_text_line(line, &memory_id, new_text, sizeof(new_text))) {
+                ethervox_memory_update_text(store, memory_id, new_text);
             }
             
             continue;  // Skip to next line
         }
         
-        // Check if this is an UPDATE operation (tags)
-        char* op_ptr = strstr(line, "\"op\":\"update\"");
-        if (op_ptr) {
-            // Handle UPDATE record - update tags for existing memory
-            char* id_ptr = strstr(line, "\"id\":");
-            if (!id_ptr) continue;
-            
-            uint64_t memory_id = strtoull(id_ptr + 5, NULL, 10);
-            
-            // Parse updated tags
-            const char* tag_array[ETHERVOX_MEMORY_MAX_TAGS];
-            uint32_t tag_count = 0;
-            char tag_storage[ETHERVOX_MEMORY_MAX_TAGS][ETHERVOX_MEMORY_TAG_LEN];
-            
-            char* tags_start = strstr(line, "\"tags\":[");
-            if (tags_start) {
-                tags_start += 8;  // Skip "tags":[
-                char* tags_end = strchr(tags_start, ']');
-                
-                if (tags_end) {
-                    char* tag_cursor = tags_start;
-                    while (tag_cursor < tags_end && tag_count < ETHERVOX_MEMORY_MAX_TAGS) {
-                        char* tag_open = strchr(tag_cursor, '"');
-                        if (!tag_open || tag_open >= tags_end) break;
-                        
-                        tag_open++;
-                        char* tag_close = strchr(tag_open, '"');
-                        if (!tag_close || tag_close >= tags_end) break;
-                        
-                        size_t tag_len = tag_close - tag_open;
-                        if (tag_len > 0 && tag_len < ETHERVOX_MEMORY_TAG_LEN) {
-                            strncpy(tag_storage[tag_count], tag_open, tag_len);
-                            tag_storage[tag_count][tag_len] = '\0';
-                            tag_array[tag_count] = tag_storage[tag_count];
-                            tag_count++;
-                        }
-                        
-                        tag_cursor = tag_close + 1;
-                    }
-                }
-            }
-            
+        // Check if this is an UPDATE operation (tags, plus importance for duplicate merges)
+        char tag_storage[ETHERVOX_MEMORY_MAX_TAGS][ETHERVOX_MEMORY_TAG_LEN];
+        uint32_t tag_count = 0;
+        float importance = -1.0f;
+        if (memory_parse_update_tags_line(line, &memory_id, tag_storage, &tag_count, &importance)) {
             // Apply the tag update to the memory entry
             if (tag_count > 0) {
+                const char* tag_array[ETHERVOX_MEMORY_MAX_TAGS];
+                for (uint32_t i = 0; i < tag_count; i++) {
+                    tag_array[i] = tag_storage[i];
+                }
+
                 // Don't persist during update (we're reading from old file)
                 int update_result = memory_update_tags_internal(store, memory_id, tag_array, tag_count, false);
                 
@@ -755,10 +735,17 @@ ethervox_result_t ethervox_memory_import(
                             fprintf(store->append_log, ",");
                         }
                     }
-                    fprintf(store->append_log, "]}\n");
+                    if (importance >= 0.0f) {
+                        fprintf(store->append_log, "],\"imp\":%.2f}\n", importance);
+                    } else {
+                        fprintf(store->append_log, "]}\n");
+                    }
                     fflush(store->append_log);
                 }
             }
+            if (importance >= 0.0f) {
+                memory_set_importance_internal(store, memory_id, importance);
+            }
             
             continue;  // Skip to next line
         }
@@ -781,6 +768,25 @@ ethervox_result_t ethervox_memory_import(
     return ETHERVOX_SUCCESS;
 }
 
+ethervox_result_t ethervox_memory_import(
+    ethervox_memory_store_t* store,
+    const char* filepath,
+    uint32_t* turns_loaded
+) {
+    if (!store || !store->is_initialized || !filepath) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    
+    // Replay records verbatim: later delete/update ops refer to these exact IDs,
+    // so near-duplicate merging must not fold imported entries together
+    ethervox_memory_dedup_mode_t dedup_mode = store->dedup_mode;
+    store->dedup_mode = ETHERVOX_MEMORY_DEDUP_OFF;
+    ethervox_result_t result = import_file(store, filepath, turns_loaded);
+    store->dedup_mode = dedup_mode;
+    
+    return result;
+}
+
 ethervox_result_t ethervox_memory_load_previous_session(
     ethervox_memory_store_t* store,
     uint32_t* turns_loaded
@@ -0,0 +1,731 @@
+/**
+ * @file memory_import.c
+ * @brief Parallel mmap-based JSONL import for large memory logs
+ *
+ * The file is mapped read-only and split into chunks at newline boundaries.
+ * A small pool of worker threads parses chunks into thread-local batches
+ * (compact records + a string arena). The batches are then merged into the
+ * store in file order on the calling thread, so delete/update records keep
+ * their sequential semantics. The tag index is rebuilt and the session log
+ * is written once at the end instead of once per entry.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/memory_tools.h"
+#include "ethervox/logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Parsers from memory_export.c (thread-safe, no store access)
+extern bool memory_parse_entry_line(const char* line, ethervox_memory_entry_t* out);
+extern bool memory_parse_delete_line(const char* line, uint64_t* memory_id);
+extern bool memory_parse_update_text_line(const char* line, uint64_t* memory_id,
+                                          char* text_out, size_t text_size);
+extern bool memory_parse_update_tags_line(const char* line, uint64_t* memory_id,
+                                          char tags_out[][ETHERVOX_MEMORY_TAG_LEN],
+                                          uint32_t* tag_count, float* importance_out);
+
+// Bulk-load helpers from memory_core.c
+extern ethervox_result_t memory_reserve_entries_internal(ethervox_memory_store_t* store,
+                                                         uint32_t needed);
+extern ethervox_result_t memory_append_entry_internal(ethervox_memory_store_t* store,
+                                                      const ethervox_memory_entry_t* entry);
+extern void memory_rebuild_indexes_internal(ethervox_memory_store_t* store);
+extern void memory_persist_entries_internal(ethervox_memory_store_t* store,
+                                            uint32_t start, uint32_t count);
+
+// Chunks per worker thread - a few per thread keeps the pool busy when
+// line lengths are uneven across the file
+#define IMPORT_CHUNKS_PER_THREAD 4
+
+#define IMPORT_MAX_TOOLS 16
+
+typedef enum {
+    IMPORT_RECORD_ADD = 0,
+    IMPORT_RECORD_DELETE,
+    IMPORT_RECORD_UPDATE_TAGS,
+    IMPORT_RECORD_UPDATE_TEXT
+} import_record_type_t;
+
+/**
+ * Compact parsed line. Strings live in the owning batch's arena and are
+ * referenced by offset so the arena can grow with realloc().
+ */
+typedef struct {
+    import_record_type_t type;
+    uint64_t memory_id;
+    uint64_t turn_id;
+    time_t timestamp;
+    float importance;
+    bool is_user_message;
+    size_t text_offset;
+    uint32_t tag_count;
+    size_t tag_offsets[ETHERVOX_MEMORY_MAX_TAGS];
+    uint32_t tools_count;
+    size_t tool_offsets[IMPORT_MAX_TOOLS];
+} import_record_t;
+
+/**
+ * Thread-local batch for one newline-aligned chunk of the file
+ */
+typedef struct {
+    const char* begin;
+    const char* end;
+
+    import_record_t* records;
+    uint32_t record_count;
+    uint32_t record_capacity;
+
+    char* arena;
+    size_t arena_used;
+    size_t arena_capacity;
+
+    uint32_t lines_parsed;
+    bool failed;
+} import_batch_t;
+
+typedef struct {
+    import_batch_t* batches;
+    uint32_t batch_count;
+    uint32_t next_batch;
+    pthread_mutex_t lock;
+} import_work_queue_t;
+
+static double import_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+static uint32_t import_default_threads(void) {
+    long cores = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+    cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1) {
+        cores = 1;
+    }
+    return (uint32_t)cores;
+}
+
+// Copy a NUL-terminated string into the batch arena, returning its offset
+static bool arena_push(import_batch_t* batch, const char* str, size_t* offset_out) {
+    size_t len = strlen(str) + 1;
+
+    if (batch->arena_used + len > batch->arena_capacity) {
+        size_t new_capacity = batch->arena_capacity ? batch->arena_capacity : 64 * 1024;
+        while (new_capacity < batch->arena_used + len) {
+            new_capacity *= 2;
+        }
+        char* new_arena = realloc(batch->arena, new_capacity);
+        if (!new_arena) {
+            return false;
+        }
+        batch->arena = new_arena;
+        batch->arena_capacity = new_capacity;
+    }
+
+    memcpy(batch->arena + batch->arena_used, str, len);
+    *offset_out = batch->arena_used;
+    batch->arena_used += len;
+    return true;
+}
+
+static import_record_t* batch_next_record(import_batch_t* batch) {
+    if (batch->record_count >= batch->record_capacity) {
+        uint32_t new_capacity = batch->record_capacity ? batch->record_capacity * 2 : 256;
+        import_record_t* new_records = realloc(batch->records, new_capacity * sizeof(import_record_t));
+        if (!new_records) {
+            return NULL;
+        }
+        batch->records = new_records;
+        batch->record_capacity = new_capacity;
+    }
+
+    import_record_t* record = &batch->records[batch->record_count];
+    memset(record, 0, sizeof(*record));
+    return record;
+}
+
+// Classify and parse one NUL-terminated line into the batch
+static bool parse_line_into_batch(
+    import_batch_t* batch,
+    const char* line,
+    ethervox_memory_entry_t* scratch
+) {
+    uint64_t memory_id = 0;
+
+    if (memory_parse_delete_line(line, &memory_id)) {
+        import_record_t* record = batch_next_record(batch);
+        if (!record) return false;
+        record->type = IMPORT_RECORD_DELETE;
+        record->memory_id = memory_id;
+        batch->record_count++;
+        return true;
+    }
+
+    if (strstr(line, "\"op\":\"update_text\"")) {
+        if (!memory_parse_update_text_line(line, &memory_id, scratch->text, sizeof(scratch->text))) {
+            return true;  // Malformed op - skipped, same as the sequential importer
+        }
+        import_record_t* record = batch_next_record(batch);
+        if (!record) return false;
+        record->type = IMPORT_RECORD_UPDATE_TEXT;
+        record->memory_id = memory_id;
+        if (!arena_push(batch, scratch->text, &record->text_offset)) return false;
+        batch->record_count++;
+        return true;
+    }
+
+    uint32_t tag_count = 0;
+    float importance = -1.0f;
+    if (memory_parse_update_tags_line(line, &memory_id, scratch->tags, &tag_count, &importance)) {
+        if (tag_count == 0 && importance < 0.0f) {
+            return true;
+        }
+        import_record_t* record = batch_next_record(batch);
+        if (!record) return false;
+        record->type = IMPORT_RECORD_UPDATE_TAGS;
+        record->memory_id = memory_id;
+        record->importance = importance;  // -1 = unchanged
+        record->tag_count = tag_count;
+        for (uint32_t i = 0; i < tag_count; i++) {
+            if (!arena_push(batch, scratch->tags[i], &record->tag_offsets[i])) return false;
+        }
+        batch->record_count++;
+        return true;
+    }
+
+    if (!memory_parse_entry_line(line, scratch)) {
+        return true;  // Not a memory record
+    }
+
+    import_record_t* record = batch_next_record(batch);
+    if (!record) return false;
+    record->type = IMPORT_RECORD_ADD;
+    record->memory_id = scratch->memory_id;
+    record->turn_id = scratch->turn_id;
+    record->timestamp = scratch->timestamp;
+    record->importance = scratch->importance;
+    record->is_user_message = scratch->is_user_message;
+    if (!arena_push(batch, scratch->text, &record->text_offset)) return false;
+    record->tag_count = scratch->tag_count;
+    for (uint32_t i = 0; i < scratch->tag_count; i++) {
+        if (!arena_push(batch, scratch->tags[i], &record->tag_offsets[i])) return false;
+    }
+    record->tools_count = scratch->tools_called_count;
+    for (uint32_t i = 0; i < scratch->tools_called_count; i++) {
+        if (!arena_push(batch, scratch->tools_called[i], &record->tool_offsets[i])) return false;
+    }
+    batch->record_count++;
+    return true;
+}
+
+static void parse_batch(
+    import_batch_t* batch,
+    ethervox_memory_entry_t* scratch,
+    char** line_buf,
+    size_t* line_buf_size
+) {
+    const char* cursor = batch->begin;
+
+    while (cursor < batch->end) {
+        const char* newline = memchr(cursor, '\n', (size_t)(batch->end - cursor));
+        const char* line_end = newline ? newline : batch->end;
+        size_t line_len = (size_t)(line_end - cursor);
+
+        // Skip blank lines without copying
+        const char* p = cursor;
+        while (p < line_end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+
+        if (p < line_end) {
+            if (line_len + 1 > *line_buf_size) {
+                size_t new_size = *line_buf_size;
+                while (new_size < line_len + 1) new_size *= 2;
+                char* new_buf = realloc(*line_buf, new_size);
+                if (!new_buf) {
+                    batch->failed = true;
+                    return;
+                }
+                *line_buf = new_buf;
+                *line_buf_size = new_size;
+            }
+            memcpy(*line_buf, cursor, line_len);
+            (*line_buf)[line_len] = '\0';
+
+            batch->lines_parsed++;
+            if (!parse_line_into_batch(batch, *line_buf, scratch)) {
+                batch->failed = true;
+                return;
+            }
+        }
+
+        cursor = line_end + 1;
+    }
+}
+
+static void* import_worker(void* arg) {
+    import_work_queue_t* queue = (import_work_queue_t*)arg;
+
+    ethervox_memory_entry_t* scratch = malloc(sizeof(ethervox_memory_entry_t));
+    size_t line_buf_size = ETHERVOX_MEMORY_MAX_TEXT_LEN + 512;
+    char* line_buf = malloc(line_buf_size);
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        uint32_t idx = queue->next_batch++;
+        pthread_mutex_unlock(&queue->lock);
+
+        if (idx >= queue->batch_count) {
+            break;
+        }
+
+        if (!scratch || !line_buf) {
+            queue->batches[idx].failed = true;
+            continue;
+        }
+        parse_batch(&queue->batches[idx], scratch, &line_buf, &line_buf_size);
+    }
+
+    free(line_buf);
+    free(scratch);
+    return NULL;
+}
+
+/**
+ * id -> entry index map used while merging. Entries sharing an ID are
+ * chained through `prev_same_id` (newest first) so deletes remove every
+ * copy and updates hit the oldest live one, matching the sequential path.
+ */
+typedef struct {
+    uint64_t* keys;
+    uint32_t* values;     // Newest entry index for the key
+    bool* used;
+    uint32_t mask;
+    uint32_t* prev_same_id;
+    bool* dead;
+} import_id_map_t;
+
+static bool id_map_init(import_id_map_t* map, uint32_t max_entries) {
+    uint32_t size = 16;
+    while (size < max_entries * 2) size <<= 1;
+
+    map->keys = calloc(size, sizeof(uint64_t));
+    map->values = calloc(size, sizeof(uint32_t));
+    map->used = calloc(size, sizeof(bool));
+    map->prev_same_id = malloc(((size_t)max_entries + 1) * sizeof(uint32_t));
+    map->dead = calloc((size_t)max_entries + 1, sizeof(bool));
+    map->mask = size - 1;
+
+    return map->keys && map->values && map->used && map->prev_same_id && map->dead;
+}
+
+static void id_map_free(import_id_map_t* map) {
+    free(map->keys);
+    free(map->values);
+    free(map->used);
+    free(map->prev_same_id);
+    free(map->dead);
+}
+
+static uint32_t id_map_slot(const import_id_map_t* map, uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    uint32_t slot = (uint32_t)(h >> 32) & map->mask;
+    while (map->used[slot] && map->keys[slot] != key) {
+        slot = (slot + 1) & map->mask;
+    }
+    return slot;
+}
+
+static void id_map_insert(import_id_map_t* map, uint64_t key, uint32_t entry_index) {
+    uint32_t slot = id_map_slot(map, key);
+    map->prev_same_id[entry_index] = map->used[slot] ? map->values[slot] : UINT32_MAX;
+    map->keys[slot] = key;
+    map->values[slot] = entry_index;
+    map->used[slot] = true;
+}
+
+// Oldest live entry with this ID, or UINT32_MAX
+static uint32_t id_map_find_oldest_live(const import_id_map_t* map, uint64_t key) {
+    uint32_t slot = id_map_slot(map, key);
+    if (!map->used[slot]) {
+        return UINT32_MAX;
+    }
+    uint32_t found = UINT32_MAX;
+    for (uint32_t idx = map->values[slot]; idx != UINT32_MAX; idx = map->prev_same_id[idx]) {
+        if (!map->dead[idx]) {
+            found = idx;
+        }
+    }
+    return found;
+}
+
+// Merge batches into the store in file order.
+// Entries that existed before the import (index < base_count) get their
+// op records written to the log immediately, like the sequential importer;
+// newly imported entries are persisted in their final state afterwards.
+static void merge_batches(
+    ethervox_memory_store_t* store,
+    import_batch_t* batches,
+    uint32_t batch_count,
+    import_id_map_t* map,
+    uint32_t base_count,
+    ethervox_memory_import_stats_t* stats
+) {
+    ethervox_memory_entry_t* entry = malloc(sizeof(ethervox_memory_entry_t));
+    if (!entry) {
+        return;
+    }
+
+    bool capacity_warned = false;
+
+    for (uint32_t b = 0; b < batch_count; b++) {
+        import_batch_t* batch = &batches[b];
+
+        for (uint32_t r = 0; r < batch->record_count; r++) {
+            const import_record_t* record = &batch->records[r];
+
+            if (record->type == IMPORT_RECORD_ADD) {
+                memset(entry, 0, sizeof(*entry));
+                entry->memory_id = record->memory_id;
+                entry->turn_id = record->turn_id;
+                entry->timestamp = record->timestamp;
+                entry->importance = record->importance;
+                entry->is_user_message = record->is_user_message;
+                snprintf(entry->text, sizeof(entry->text), "%s", batch->arena + record->text_offset);
+                entry->tag_count = record->tag_count;
+                for (uint32_t i = 0; i < record->tag_count; i++) {
+                    snprintf(entry->tags[i], ETHERVOX_MEMORY_TAG_LEN, "%s",
+                             batch->arena + record->tag_offsets[i]);
+                }
+                entry->tools_called_count = record->tools_count;
+                for (uint32_t i = 0; i < record->tools_count; i++) {
+                    snprintf(entry->tools_called[i], sizeof(entry->tools_called[i]), "%s",
+                             batch->arena + record->tool_offsets[i]);
+                }
+
+                uint32_t entry_index = store->entry_count;
+                if (memory_append_entry_internal(store, entry) != ETHERVOX_SUCCESS) {
+                    if (!capacity_warned) {
+                        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                                    "Memory store full (%u entries) - dropping remaining imported entries",
+                                    store->entry_count);
+                        capacity_warned = true;
+                    }
+                    continue;
+                }
+                map->dead[entry_index] = false;
+                id_map_insert(map, entry->memory_id, entry_index);
+                stats->entries_loaded++;
+                continue;
+            }
+
+            if (record->type == IMPORT_RECORD_DELETE) {
+                uint32_t deleted = 0;
+                for (uint32_t idx = id_map_find_oldest_live(map, record->memory_id);
+                     idx != UINT32_MAX;
+                     idx = id_map_find_oldest_live(map, record->memory_id)) {
+                    map->dead[idx] = true;
+                    if (idx < base_count) {
+                        deleted++;
+                    }
+                }
+                if (deleted > 0 && store->append_log) {
+                    fprintf(store->append_log, "{\"op\":\"delete\",\"id\":%llu}\n",
+                            (unsigned long long)record->memory_id);
+                }
+                stats->ops_applied++;
+                continue;
+            }
+
+            uint32_t idx = id_map_find_oldest_live(map, record->memory_id);
+            if (idx == UINT32_MAX) {
+                continue;  // Target not found
+            }
+            ethervox_memory_entry_t* target = &store->entries[idx];
+
+            if (record->type == IMPORT_RECORD_UPDATE_TEXT) {
+                snprintf(target->text, sizeof(target->text), "%s", batch->arena + record->text_offset);
+
+                if (idx < base_count && store->append_log) {
+                    fprintf(store->append_log, "{\"op\":\"update_text\",\"id\":%llu,\"text\":\"",
+                            (unsigned long long)record->memory_id);
+                    for (const char* p = target->text; *p; p++) {
+                        switch (*p) {
+                            case '"':  fputs("\\\"", store->append_log); break;
+                            case '\\': fputs("\\\\", store->append_log); break;
+                            case '\n': fputs("\\n", store->append_log); break;
+                            case '\r': fputs("\\r", store->append_log); break;
+                            case '\t': fputs("\\t", store->append_log); break;
+                            default:   fputc(*p, store->append_log); break;
+                        }
+                    }
+                    fprintf(store->append_log, "\"}\n");
+                }
+            } else {
+                if (record->tag_count > 0) {
+                    for (uint32_t i = 0; i < record->tag_count; i++) {
+                        snprintf(target->tags[i], ETHERVOX_MEMORY_TAG_LEN, "%s",
+                                 batch->arena + record->tag_offsets[i]);
+                    }
+                    target->tag_count = record->tag_count;
+                }
+                if (record->importance >= 0.0f) {
+                    target->importance = record->importance;  // Merged duplicate
+                }
+
+                if (idx < base_count && store->append_log) {
+                    fprintf(store->append_log, "{\"op\":\"update\",\"id\":%llu,\"tags\":[",
+                            (unsigned long long)record->memory_id);
+                    for (uint32_t i = 0; i < target->tag_count; i++) {
+                        fprintf(store->append_log, "%s\"%s\"", i > 0 ? "," : "", target->tags[i]);
+                    }
+                    if (record->importance >= 0.0f) {
+                        fprintf(store->append_log, "],\"imp\":%.2f}\n", record->importance);
+                    } else {
+                        fprintf(store->append_log, "]}\n");
+                    }
+                }
+            }
+            stats->ops_applied++;
+        }
+    }
+
+    free(entry);
+}
+
+ethervox_result_t ethervox_memory_import_parallel(
+    ethervox_memory_store_t* store,
+    const char* filepath,
+    uint32_t num_threads,
+    ethervox_memory_import_stats_t* stats_out
+) {
+    if (!store || !store->is_initialized || !filepath) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    ethervox_memory_import_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    double start_ms = import_now_ms();
+
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__,
+                    "Failed to open import file: %s", filepath);
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return ETHERVOX_ERROR_MEMORY_IMPORT_FAILED;
+    }
+
+    size_t file_size = (size_t)st.st_size;
+    if (file_size == 0) {
+        close(fd);
+        if (stats_out) *stats_out = stats;
+        return ETHERVOX_SUCCESS;
+    }
+
+    const char* data = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__,
+                    "Failed to mmap import file: %s", filepath);
+        return ETHERVOX_ERROR_MEMORY_IMPORT_FAILED;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise((void*)data, file_size, MADV_SEQUENTIAL);
+#endif
+
+    if (num_threads == 0) {
+        num_threads = import_default_threads();
+    }
+    if (num_threads > ETHERVOX_MEMORY_IMPORT_MAX_THREADS) {
+        num_threads = ETHERVOX_MEMORY_IMPORT_MAX_THREADS;
+    }
+
+    // Split into chunks that each end on a newline (or EOF)
+    uint32_t target_chunks = num_threads * IMPORT_CHUNKS_PER_THREAD;
+    size_t target_size = file_size / target_chunks;
+    if (target_size < 64 * 1024) {
+        target_size = 64 * 1024;
+    }
+
+    import_batch_t* batches = calloc(target_chunks + 1, sizeof(import_batch_t));
+    if (!batches) {
+        munmap((void*)data, file_size);
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t batch_count = 0;
+    const char* cursor = data;
+    const char* data_end = data + file_size;
+    while (cursor < data_end && batch_count < target_chunks + 1) {
+        const char* chunk_end = data_end;
+        if (batch_count < target_chunks - 1 && (size_t)(data_end - cursor) > target_size) {
+            const char* newline = memchr(cursor + target_size, '\n',
+                                         (size_t)(data_end - cursor - target_size));
+            chunk_end = newline ? newline + 1 : data_end;
+        }
+        batches[batch_count].begin = cursor;
+        batches[batch_count].end = chunk_end;
+        batch_count++;
+        cursor = chunk_end;
+    }
+
+    if (num_threads > batch_count) {
+        num_threads = batch_count;
+    }
+
+    // Parse chunks on the worker pool
+    import_work_queue_t queue = {
+        .batches = batches,
+        .batch_count = batch_count,
+        .next_batch = 0
+    };
+    pthread_mutex_init(&queue.lock, NULL);
+
+    pthread_t* threads = calloc(num_threads, sizeof(pthread_t));
+    uint32_t started = 0;
+    if (threads) {
+        for (uint32_t i = 0; i < num_threads; i++) {
+            if (pthread_create(&threads[i], NULL, import_worker, &queue) != 0) {
+                break;
+            }
+            started++;
+        }
+    }
+    if (started == 0) {
+        import_worker(&queue);  // No threads available - parse on the caller
+    }
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&queue.lock);
+
+    stats.threads_used = started ? started : 1;
+    stats.chunks = batch_count;
+    stats.bytes_processed = file_size;
+
+    // Merge in file order
+    ethervox_result_t result = ETHERVOX_SUCCESS;
+    uint32_t add_count = 0;
+    for (uint32_t b = 0; b < batch_count; b++) {
+        stats.lines_parsed += batches[b].lines_parsed;
+        if (batches[b].failed) {
+            result = ETHERVOX_ERROR_OUT_OF_MEMORY;
+        }
+        for (uint32_t r = 0; r < batches[b].record_count; r++) {
+            if (batches[b].records[r].type == IMPORT_RECORD_ADD) {
+                add_count++;
+            }
+        }
+    }
+
+    uint32_t base_count = store->entry_count;
+    if (result == ETHERVOX_SUCCESS) {
+        uint32_t max_entries = base_count + add_count;
+        if (max_entries > ETHERVOX_MEMORY_MAX_ENTRIES) {
+            max_entries = ETHERVOX_MEMORY_MAX_ENTRIES;
+        }
+
+        import_id_map_t map;
+        memset(&map, 0, sizeof(map));
+        if (memory_reserve_entries_internal(store, max_entries) != ETHERVOX_SUCCESS ||
+            !id_map_init(&map, max_entries)) {
+            result = ETHERVOX_ERROR_OUT_OF_MEMORY;
+        } else {
+            for (uint32_t i = 0; i < base_count; i++) {
+                id_map_insert(&map, store->entries[i].memory_id, i);
+            }
+
+            merge_batches(store, batches, batch_count, &map, base_count, &stats);
+
+            // Compact away deleted entries in one pass
+            uint32_t write_idx = 0;
+            uint32_t new_start = UINT32_MAX;
+            for (uint32_t i = 0; i < store->entry_count; i++) {
+                if (map.dead[i]) {
+                    continue;
+                }
+                if (i >= base_count && new_start == UINT32_MAX) {
+                    new_start = write_idx;
+                }
+                if (write_idx != i) {
+                    store->entries[write_idx] = store->entries[i];
+                }
+                write_idx++;
+            }
+            store->entry_count = write_idx;
+
+            memory_rebuild_indexes_internal(store);
+            if (new_start != UINT32_MAX) {
+                memory_persist_entries_internal(store, new_start, store->entry_count - new_start);
+            } else if (store->append_log) {
+                fflush(store->append_log);
+            }
+        }
+        id_map_free(&map);
+    }
+
+    for (uint32_t b = 0; b < batch_count; b++) {
+        free(batches[b].records);
+        free(batches[b].arena);
+    }
+    free(batches);
+    munmap((void*)data, file_size);
+
+    stats.elapsed_ms = import_now_ms() - start_ms;
+    if (stats.elapsed_ms > 0.0) {
+        stats.throughput_mb_s = ((double)stats.bytes_processed / (1024.0 * 1024.0)) /
+                                (stats.elapsed_ms / 1000.0);
+    }
+    if (stats_out) {
+        *stats_out = stats;
+    }
+
+    if (result != ETHERVOX_SUCCESS) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__,
+                    "Parallel import failed for %s", filepath);
+        return result;
+    }
+
+    ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
+                "Imported %u entries (%u ops) from %s: %.1f MB in %.1f ms (%.1f MB/s, %u threads, %u chunks)",
+                stats.entries_loaded, stats.ops_applied, filepath,
+                (double)stats.bytes_processed / (1024.0 * 1024.0), stats.elapsed_ms,
+                stats.throughput_mb_s, stats.threads_used, stats.chunks);
+
+    return ETHERVOX_SUCCESS;
+}
+
+#else  // _WIN32
+
+ethervox_result_t ethervox_memory_import_parallel(
+    ethervox_memory_store_t* store,
+    const char* filepath,
+    uint32_t num_threads,
+    ethervox_memory_import_stats_t* stats_out
+) {
+    (void)store;
+    (void)filepath;
+    (void)num_threads;
+    (void)stats_out;
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
+#endif  // _WIN32
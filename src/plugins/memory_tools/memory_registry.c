@@ -10,6 +10,7 @@
 #include "ethervox/memory_tools.h"
 #include "ethervox/governor.h"
 #include "ethervox/logging.h"
+#include "ethervox/tool_args.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,125 +23,15 @@ static ethervox_memory_store_t* g_memory_store = NULL;
 // Global privacy flag for secret mode (when true, memory logging is disabled)
 static bool g_disable_memory_logging = false;
 
-// JSON parsing helper (simplified - would use cJSON in production)
-static int parse_json_string(const char* json, const char* key, char* value, size_t value_len) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    
-    const char* start = strstr(json, search);
-    if (!start) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    
-    start += strlen(search);
-    
-    // Skip whitespace after colon
-    while (*start == ' ' || *start == '\t' || *start == '\n' || *start == '\r') {
-        start++;
-    }
-    
-    // Expect opening quote
-    if (*start != '"') return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    start++;
-    
-    const char* end = strchr(start, '"');
-    if (!end) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    
-    size_t len = end - start;
-    if (len >= value_len) len = value_len - 1;
-    
-    strncpy(value, start, len);
-    value[len] = '\0';
-    return ETHERVOX_SUCCESS;
-}
-
-static int parse_json_float(const char* json, const char* key, float* value) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    
-    const char* start = strstr(json, search);
-    if (!start) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    
-    start += strlen(search);
-    *value = strtof(start, NULL);
-    return ETHERVOX_SUCCESS;
-}
-
-static int parse_json_uint(const char* json, const char* key, uint32_t* value) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    
-    const char* start = strstr(json, search);
-    if (!start) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    
-    start += strlen(search);
-    *value = strtoul(start, NULL, 10);
-    return ETHERVOX_SUCCESS;
-}
-
-static int parse_json_bool(const char* json, const char* key, bool* value) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    
-    const char* start = strstr(json, search);
-    if (!start) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    
-    start += strlen(search);
-    while (*start == ' ' || *start == '\t') start++;
-    
-    *value = (strncmp(start, "true", 4) == 0);
-    return ETHERVOX_SUCCESS;
-}
-
 // Tool wrappers that bridge between Governor API and memory functions
 
-
-// Parse a JSON array of strings: "tags": ["reminder", "recurring"]
-// OR a single string: "tags": "reminder"
-static int parse_json_string_array(const char* json, const char* key, char tags[][32], uint32_t* tag_count, uint32_t max_tags) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    const char* start = strstr(json, search);
-    if (!start) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    start += strlen(search);
-    while (*start == ' ' || *start == '\t' || *start == '\n' || *start == '\r') start++;
-    
-    *tag_count = 0;
-    
-    // Handle single string: "tags": "reminder"
-    if (*start == '"') {
-        start++;
-        const char* end = strchr(start, '"');
-        if (!end) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-        size_t len = end - start;
-        if (len > 0 && len < 32) {
-            strncpy(tags[0], start, len);
-            tags[0][len] = '\0';
-            (*tag_count) = 1;
-            return ETHERVOX_SUCCESS;
-        }
-        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+// Open args_json, reporting malformed input through *error
+static bool open_args(ethervox_tool_args_t* args, const char* args_json, char** error) {
+    if (ethervox_tool_args_parse(args, args_json) != ETHERVOX_SUCCESS) {
+        *error = strdup("Malformed JSON arguments");
+        return false;
     }
-    
-    // Handle array: "tags": ["reminder", "recurring"]
-    if (*start != '[') return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    start++;
-    while (*start && *start != ']') {
-        while (*start == ' ' || *start == '\t' || *start == ',') start++;
-        if (*start == '"') {
-            start++;
-            const char* end = strchr(start, '"');
-            if (!end) break;
-            size_t len = end - start;
-            if (len > 0 && len < 32 && *tag_count < max_tags) {
-                strncpy(tags[*tag_count], start, len);
-                tags[*tag_count][len] = '\0';
-                (*tag_count)++;
-            }
-            start = end + 1;
-        } else {
-            break;
-        }
-    }
-    return (*tag_count > 0) ? 0 : -1;
+    return true;
 }
 
 static int tool_memory_store_wrapper(
@@ -157,30 +48,31 @@ static int tool_memory_store_wrapper(
     }
     
     ethervox_memory_store_t* store = g_memory_store;
+    ethervox_tool_args_t args;
     char text[ETHERVOX_MEMORY_MAX_TEXT_LEN];
-    float importance = 0.5f;
+    double importance = 0.5;
     bool is_user = false;
     char tags[8][32];
     uint32_t tag_count = 0;
 
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
     // Parse arguments - support 'key', 'text', or 'value' as parameter name
-    if (parse_json_string(args_json, "key", text, sizeof(text)) != 0) {
-        // Try 'text' as fallback parameter name
-        if (parse_json_string(args_json, "text", text, sizeof(text)) != 0) {
-            // Try 'value' as alternative parameter name
-            if (parse_json_string(args_json, "value", text, sizeof(text)) != 0) {
-                *error = strdup("Missing 'key', 'text', or 'value' parameter");
-                return ETHERVOX_ERROR_INVALID_ARGUMENT;
-            }
-        }
+    if (!ethervox_tool_args_get_string(&args, "key", text, sizeof(text)) &&
+        !ethervox_tool_args_get_string(&args, "text", text, sizeof(text)) &&
+        !ethervox_tool_args_get_string(&args, "value", text, sizeof(text))) {
+        *error = strdup("Missing 'key', 'text', or 'value' parameter");
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
-    parse_json_float(args_json, "importance", &importance);
-    parse_json_bool(args_json, "is_user", &is_user);
+    ethervox_tool_args_get_double(&args, "importance", &importance);
+    ethervox_tool_args_get_bool(&args, "is_user", &is_user);
     
     // Try to parse tags; if none provided, default to "general"
-    if (parse_json_string_array(args_json, "tags", tags, &tag_count, 8) != 0) {
-        // Only use "general" if tags were not provided at all
-        strncpy(tags[0], "general", 32);
+    tag_count = ethervox_tool_args_get_string_array(&args, "tags", tags[0], sizeof(tags[0]), 8);
+    if (tag_count == 0) {
+        snprintf(tags[0], sizeof(tags[0]), "general");
         tag_count = 1;
     }
 
@@ -190,7 +82,7 @@ static int tool_memory_store_wrapper(
 
     uint64_t memory_id;
     if (ethervox_memory_store_add(store, text, tag_ptrs, tag_count,
-                                  importance, is_user, &memory_id) != 0) {
+                                  (float)importance, is_user, &memory_id) != 0) {
         *error = strdup("Failed to store memory");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
@@ -209,8 +101,8 @@ static int tool_memory_reminder_list_wrapper(
     ethervox_memory_search_result_t* results = NULL;
     uint32_t result_count = 0;
     const char* tag_filter[] = {"reminder"};
-    // Find up to 32 reminders
-    if (ethervox_memory_search(store, NULL, tag_filter, 1, 32, &results, &result_count) != 0) {
+    // Newest 32 reminders, straight from the time index
+    if (ethervox_memory_get_recent(store, tag_filter, 1, 32, &results, &result_count) != 0) {
         *error = strdup("Search failed");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
@@ -246,13 +138,19 @@ static int tool_memory_search_wrapper(
     ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
                 "memory_search_wrapper INPUT: args_json='%s'", args_json ? args_json : "(null)");
     
+    ethervox_tool_args_t args;
     char query[512] = {0};
-    uint32_t limit = 10;
-    float min_importance = 0.0f;  // Default: no importance filter
+    int64_t limit_arg = 10;
+    double min_importance_arg = 0.0;  // Default: no importance filter
     
-    parse_json_string(args_json, "query", query, sizeof(query));
-    parse_json_uint(args_json, "limit", &limit);
-    parse_json_float(args_json, "min_importance", &min_importance);
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    ethervox_tool_args_get_string(&args, "query", query, sizeof(query));
+    ethervox_tool_args_get_int(&args, "limit", &limit_arg);
+    ethervox_tool_args_get_double(&args, "min_importance", &min_importance_arg);
+    uint32_t limit = (limit_arg > 0 && limit_arg <= UINT32_MAX) ? (uint32_t)limit_arg : 10;
+    float min_importance = (float)min_importance_arg;
     
     ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
                 "memory_search_wrapper: query='%s', limit=%u, min_importance=%.2f, query[0]=%d",
@@ -324,11 +222,16 @@ static int tool_memory_summarize_wrapper(
 ) {
     ethervox_memory_store_t* store = g_memory_store;
     
-    uint32_t window_size = 10;
+    ethervox_tool_args_t args;
+    int64_t window_arg = 10;
     char focus[256] = {0};
     
-    parse_json_uint(args_json, "window_size", &window_size);
-    parse_json_string(args_json, "focus_topic", focus, sizeof(focus));
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    ethervox_tool_args_get_int(&args, "window_size", &window_arg);
+    ethervox_tool_args_get_string(&args, "focus_topic", focus, sizeof(focus));
+    uint32_t window_size = (window_arg > 0 && window_arg <= UINT32_MAX) ? (uint32_t)window_arg : 10;
     
     char* summary = NULL;
     if (ethervox_memory_summarize(store, window_size,
@@ -361,13 +264,16 @@ static int tool_memory_complete_reminder_wrapper(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    uint64_t memory_id = 0;
-    char id_str[32];
-    if (parse_json_string(args_json, "memory_id", id_str, sizeof(id_str)) != 0) {
+    ethervox_tool_args_t args;
+    int64_t id_arg = -1;
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    if (!ethervox_tool_args_get_int(&args, "memory_id", &id_arg) || id_arg < 0) {
         *error = strdup("Missing 'memory_id' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
-    memory_id = strtoull(id_str, NULL, 10);
+    uint64_t memory_id = (uint64_t)id_arg;
     
     // Find the entry and check if already completed
     ethervox_memory_entry_t* entry = NULL;
@@ -429,15 +335,19 @@ static int tool_memory_export_wrapper(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
+    ethervox_tool_args_t args;
     char filepath[512] = {0};
     char format[32] = "json";
     
-    if (parse_json_string(args_json, "filepath", filepath, sizeof(filepath)) != 0) {
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    if (!ethervox_tool_args_get_string(&args, "filepath", filepath, sizeof(filepath))) {
         *error = strdup("Missing 'filepath' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    parse_json_string(args_json, "format", format, sizeof(format));
+    ethervox_tool_args_get_string(&args, "format", format, sizeof(format));
     
     uint64_t bytes_written = 0;
     if (ethervox_memory_export(store, filepath, format, &bytes_written) != 0) {
@@ -461,21 +371,29 @@ static int tool_memory_forget_wrapper(
     char** error
 ) {
     ethervox_memory_store_t* store = g_memory_store;
+    ethervox_tool_args_t args;
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
     
     // Check if memory_ids parameter is present (delegate to delete functionality)
-    if (strstr(args_json, "\"memory_ids\"")) {
+    if (ethervox_tool_args_has(&args, "memory_ids")) {
         // Delegate to delete logic
         return tool_memory_delete_wrapper(args_json, result, error);
     }
     
-    uint64_t older_than = 0;
-    float importance_threshold = 0.0f;
+    int64_t older_than = 0;
+    double importance_threshold = 0.0;
     
-    parse_json_uint(args_json, "older_than_seconds", (uint32_t*)&older_than);
-    parse_json_float(args_json, "importance_threshold", &importance_threshold);
+    ethervox_tool_args_get_int(&args, "older_than_seconds", &older_than);
+    ethervox_tool_args_get_double(&args, "importance_threshold", &importance_threshold);
+    if (older_than < 0) {
+        older_than = 0;
+    }
     
     uint32_t pruned = 0;
-    if (ethervox_memory_forget(store, older_than, importance_threshold, &pruned) != 0) {
+    if (ethervox_memory_forget(store, (uint64_t)older_than, (float)importance_threshold,
+                               &pruned) != 0) {
         *error = strdup("Forget operation failed");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
@@ -499,73 +417,48 @@ static int tool_memory_delete_wrapper(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
+    ethervox_tool_args_t args;
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    
     // Parse memory_ids - can be either:
-    // 1. JSON array: "memory_ids":[123,456,789]
+    // 1. JSON array: "memory_ids":[123,456,789] (numbers or numeric strings)
     // 2. String with array: "memory_ids":"[123,456,789]"
-    // 3. Single ID: "memory_id":"123"
+    // 3. Single ID: "memory_id":"123" or "memory_id":123
     
-    uint64_t ids[100]; // Max 100 IDs at once
-    uint32_t id_count = 0;
+    int64_t parsed[100]; // Max 100 IDs at once
+    uint32_t parsed_count = 0;
     
-    // Try to find memory_ids as JSON array
-    char* ids_start = strstr(args_json, "\"memory_ids\":[");
-    if (ids_start) {
-        ids_start += 14; // Skip "memory_ids":[
-        
-        // Parse array of IDs
-        char* cursor = ids_start;
-        while (*cursor && *cursor != ']' && id_count < 100) {
-            // Skip whitespace and commas
-            while (*cursor && (*cursor == ' ' || *cursor == ',')) cursor++;
-            
+    ethervox_json_type_t ids_type = ethervox_tool_args_type(&args, "memory_ids");
+    if (ids_type == ETHERVOX_JSON_STRING) {
+        // Parse the string contents as an array of numbers
+        char ids_str[512];
+        ethervox_tool_args_get_string(&args, "memory_ids", ids_str, sizeof(ids_str));
+        char* cursor = ids_str;
+        while (*cursor && parsed_count < 100) {
             if (*cursor >= '0' && *cursor <= '9') {
-                ids[id_count++] = strtoull(cursor, &cursor, 10);
-            } else {
+                parsed[parsed_count++] = (int64_t)strtoull(cursor, &cursor, 10);
+            } else if (*cursor == ']') {
                 break;
+            } else {
+                cursor++;  // Skip brackets, whitespace and commas
             }
         }
+    } else if (ids_type != ETHERVOX_JSON_UNDEFINED) {
+        parsed_count = ethervox_tool_args_get_int_array(&args, "memory_ids", parsed, 100);
+    } else if (ethervox_tool_args_get_int_array(&args, "memory_id", parsed, 1) == 1) {
+        parsed_count = 1;
     } else {
-        // Try memory_ids as string containing array: "memory_ids":"[123,456]"
-        char ids_str[512];
-        if (parse_json_string(args_json, "memory_ids", ids_str, sizeof(ids_str)) == 0) {
-            // Parse the string as an array
-            char* cursor = ids_str;
-            
-            // Skip opening bracket if present
-            if (*cursor == '[') cursor++;
-            
-            while (*cursor && id_count < 100) {
-                // Skip whitespace and commas
-                while (*cursor && (*cursor == ' ' || *cursor == ',' || *cursor == '[')) cursor++;
-                
-                if (*cursor >= '0' && *cursor <= '9') {
-                    ids[id_count++] = strtoull(cursor, &cursor, 10);
-                } else if (*cursor == ']') {
-                    break;
-                } else if (*cursor == '\0') {
-                    break;
-                } else {
-                    cursor++;
-                }
-            }
-        } else {
-            // Try single memory_id parameter
-            char id_str[32];
-            if (parse_json_string(args_json, "memory_id", id_str, sizeof(id_str)) == 0) {
-                uint64_t single_id = strtoull(id_str, NULL, 10);
-                uint32_t deleted = 0;
-                if (ethervox_memory_delete_by_ids(store, &single_id, 1, &deleted) != 0) {
-                    *error = strdup("Delete operation failed");
-                    return ETHERVOX_ERROR_INVALID_ARGUMENT;
-                }
-                char* res = malloc(256);
-                snprintf(res, 256, "{\"success\":true,\"items_deleted\":%u}", deleted);
-                *result = res;
-                return ETHERVOX_SUCCESS;
-            }
-            
-            *error = strdup("Missing 'memory_ids' or 'memory_id' parameter");
-            return ETHERVOX_ERROR_INVALID_ARGUMENT;
+        *error = strdup("Missing 'memory_ids' or 'memory_id' parameter");
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    
+    uint64_t ids[100];
+    uint32_t id_count = 0;
+    for (uint32_t i = 0; i < parsed_count; i++) {
+        if (parsed[i] >= 0) {
+            ids[id_count++] = (uint64_t)parsed[i];
         }
     }
     
@@ -595,18 +488,23 @@ static int tool_memory_update_reminder_wrapper(
 ) {
     ethervox_memory_store_t* store = g_memory_store;
     
+    ethervox_tool_args_t args;
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    
     // Parse memory_id
-    char id_str[32];
-    if (parse_json_string(args_json, "memory_id", id_str, sizeof(id_str)) != 0) {
+    int64_t id_arg = -1;
+    if (!ethervox_tool_args_get_int(&args, "memory_id", &id_arg) || id_arg < 0) {
         *error = strdup("Missing 'memory_id' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    uint64_t memory_id = strtoull(id_str, NULL, 10);
+    uint64_t memory_id = (uint64_t)id_arg;
     
     // Parse new_text
     char new_text[ETHERVOX_MEMORY_MAX_TEXT_LEN];
-    if (parse_json_string(args_json, "new_text", new_text, sizeof(new_text)) != 0) {
+    if (!ethervox_tool_args_get_string(&args, "new_text", new_text, sizeof(new_text))) {
         *error = strdup("Missing 'new_text' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
@@ -637,16 +535,20 @@ static int tool_memory_store_correction_wrapper(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
+    ethervox_tool_args_t args;
     char correction_text[ETHERVOX_MEMORY_MAX_TEXT_LEN];
     char context[ETHERVOX_MEMORY_MAX_TEXT_LEN] = {0};
     
-    if (parse_json_string(args_json, "correction", correction_text, sizeof(correction_text)) != 0) {
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    if (!ethervox_tool_args_get_string(&args, "correction", correction_text, sizeof(correction_text))) {
         *error = strdup("Missing 'correction' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
     // Context is optional
-    parse_json_string(args_json, "context", context, sizeof(context));
+    ethervox_tool_args_get_string(&args, "context", context, sizeof(context));
     
     uint64_t memory_id;
     if (ethervox_memory_store_correction(store, correction_text, 
@@ -677,9 +579,13 @@ static int tool_memory_store_pattern_wrapper(
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
+    ethervox_tool_args_t args;
     char pattern_description[ETHERVOX_MEMORY_MAX_TEXT_LEN];
     
-    if (parse_json_string(args_json, "pattern", pattern_description, sizeof(pattern_description)) != 0) {
+    if (!open_args(&args, args_json, error)) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+    if (!ethervox_tool_args_get_string(&args, "pattern", pattern_description, sizeof(pattern_description))) {
         *error = strdup("Missing 'pattern' parameter");
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
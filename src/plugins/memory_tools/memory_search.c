@@ -14,6 +14,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Internal function from memory_core.c for re-indexing after compaction
+extern void memory_rebuild_indexes_internal(ethervox_memory_store_t* store);
+
+// Bitmap intersection over interned tags (memory_tag_index.c)
+extern ethervox_result_t memory_tag_index_query_internal(
+    const ethervox_memory_store_t* store,
+    const char* tags[],
+    uint32_t tag_count,
+    uint32_t** ordinals_out,
+    uint32_t* count_out
+);
+
+// Time index helpers (memory_time_index.c)
+extern float memory_recency_score_internal(const ethervox_memory_store_t* store, time_t timestamp);
+extern float memory_recency_relevance_internal(
+    const ethervox_memory_store_t* store,
+    const ethervox_memory_entry_t* entry
+);
+extern uint32_t memory_time_index_last_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t window,
+    uint32_t** ordinals_out
+);
+
 // Simple text similarity using word overlap (Jaccard-like)
 static float calculate_text_similarity(const char* text1, const char* text2) {
     if (!text1 || !text2) {
@@ -77,40 +101,20 @@ static float calculate_text_similarity(const char* text1, const char* text2) {
     return similarity;
 }
 
-// Check if entry has all required tags
-static bool has_all_tags(
-    const ethervox_memory_entry_t* entry,
-    const char* tag_filter[],
-    uint32_t tag_filter_count
-) {
-    if (tag_filter_count == 0) {
-        return true;  // No filter = all pass
-    }
-    
-    for (uint32_t i = 0; i < tag_filter_count; i++) {
-        bool found = false;
-        for (uint32_t j = 0; j < entry->tag_count; j++) {
-            if (strcmp(entry->tags[j], tag_filter[i]) == 0) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return false;  // Missing a required tag
-        }
-    }
-    
-    return true;
-}
-
-// Comparison for qsort - descending relevance
+// Comparison for qsort - descending relevance, newer first on ties
 static int compare_results(const void* a, const void* b) {
     const ethervox_memory_search_result_t* r1 = a;
     const ethervox_memory_search_result_t* r2 = b;
     
-    if (r1->relevance > r2->relevance) return ETHERVOX_ERROR_INVALID_ARGUMENT;
-    if (r1->relevance < r2->relevance) return ETHERVOX_SUCCESS;
-    return ETHERVOX_SUCCESS;
+    if (r1->relevance > r2->relevance) return -1;
+    if (r1->relevance < r2->relevance) return 1;
+    if (r1->entry.timestamp != r2->entry.timestamp) {
+        return (r1->entry.timestamp > r2->entry.timestamp) ? -1 : 1;
+    }
+    if (r1->entry.memory_id != r2->entry.memory_id) {
+        return (r1->entry.memory_id > r2->entry.memory_id) ? -1 : 1;
+    }
+    return 0;
 }
 
 ethervox_result_t ethervox_memory_search(
@@ -136,26 +140,35 @@ ethervox_result_t ethervox_memory_search(
         limit = 10;  // Default limit
     }
     
+    // Tag filter = intersection of the per-tag bitmaps (ascending ordinals)
+    uint32_t* candidates = NULL;
+    uint32_t candidate_count = store->entry_count;
+    bool filtered = (tag_filter && tag_filter_count > 0);
+    if (filtered) {
+        ethervox_result_t index_result = memory_tag_index_query_internal(
+            store, tag_filter, tag_filter_count, &candidates, &candidate_count);
+        if (index_result != ETHERVOX_SUCCESS) {
+            return index_result;
+        }
+    }
+    
     // Allocate results buffer for ALL matching entries (not just limit)
     // We need to find all matches, sort them, then return top N
     ethervox_memory_search_result_t* temp_results = malloc(
-        store->entry_count * sizeof(ethervox_memory_search_result_t)
+        (candidate_count > 0 ? candidate_count : 1) * sizeof(ethervox_memory_search_result_t)
     );
     if (!temp_results) {
+        free(candidates);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
     uint32_t found_count = 0;
     
-    // Search through ALL entries to find best matches
-    for (uint32_t i = 0; i < store->entry_count; i++) {
+    // Score every candidate to find best matches
+    for (uint32_t c = 0; c < candidate_count; c++) {
+        uint32_t i = filtered ? candidates[c] : c;
         ethervox_memory_entry_t* entry = &store->entries[i];
         
-        // Apply tag filter
-        if (!has_all_tags(entry, tag_filter, tag_filter_count)) {
-            continue;
-        }
-        
         // Calculate relevance
         float relevance = 1.0f;  // Base relevance
         
@@ -167,16 +180,17 @@ ethervox_result_t ethervox_memory_search(
                         "Entry %u: similarity=%.2f, importance=%.2f, text='%.60s...'",
                         i, relevance, entry->importance, entry->text);
             
-            // Boost by importance
+            // Boost by importance, then blend in time-decayed recency
             relevance = relevance * 0.7f + entry->importance * 0.3f;
+            relevance = relevance * (1.0f - ETHERVOX_MEMORY_RECENCY_QUERY_WEIGHT) +
+                        memory_recency_score_internal(store, entry->timestamp) *
+                        ETHERVOX_MEMORY_RECENCY_QUERY_WEIGHT;
             
             ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__,
                         "Entry %u: final relevance=%.2f", i, relevance);
         } else {
-            // No query = just use importance and recency
-            // More recent entries score higher
-            float recency = 1.0f - ((float)i / (float)store->entry_count);
-            relevance = entry->importance * 0.6f + recency * 0.4f;
+            // No query = just use importance and time-decayed recency
+            relevance = memory_recency_relevance_internal(store, entry);
         }
         
         // Add to results
@@ -184,6 +198,7 @@ ethervox_result_t ethervox_memory_search(
         temp_results[found_count].relevance = relevance;
         found_count++;
     }
+    free(candidates);
     
     // Sort by relevance (descending)
     if (found_count > 0) {
@@ -239,16 +254,15 @@ ethervox_result_t ethervox_memory_summarize(
         window_size = 10;  // Default: last 10 turns
     }
     
-    // Calculate start index for window
-    uint32_t start_idx = 0;
-    if (store->entry_count > window_size) {
-        start_idx = store->entry_count - window_size;
-    }
+    // Last window_size entries in time order, straight from the time index
+    uint32_t* window = NULL;
+    uint32_t window_count = memory_time_index_last_internal(store, window_size, &window);
     
     // Build summary text
     size_t summary_len = 4096;
     char* summary = malloc(summary_len);
     if (!summary) {
+        free(window);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
@@ -260,8 +274,8 @@ ethervox_result_t ethervox_memory_summarize(
     char** key_points = malloc(window_size * sizeof(char*));
     uint32_t kp_count = 0;
     
-    for (uint32_t i = start_idx; i < store->entry_count; i++) {
-        ethervox_memory_entry_t* entry = &store->entries[i];
+    for (uint32_t w = 0; w < window_count; w++) {
+        ethervox_memory_entry_t* entry = &store->entries[window[w]];
         
         // If focus topic specified, filter by tag or text match
         if (focus_topic && focus_topic[0]) {
@@ -305,6 +319,7 @@ ethervox_result_t ethervox_memory_summarize(
         }
     }
     
+    free(window);
     *summary_out = summary;
     
     if (key_points_out && key_points_count) {
@@ -375,7 +390,9 @@ ethervox_result_t ethervox_memory_forget(
     
     store->entry_count = write_idx;
     
-    // TODO: Rebuild tag index after pruning
+    if (pruned > 0) {
+        memory_rebuild_indexes_internal(store);
+    }
     
     if (items_pruned) {
         *items_pruned = pruned;
@@ -435,7 +452,9 @@ ethervox_result_t memory_delete_by_ids_internal(
     
     store->entry_count = write_idx;
     
-    // TODO: Rebuild tag index after deletion
+    if (deleted > 0) {
+        memory_rebuild_indexes_internal(store);
+    }
     
     if (items_deleted) {
         *items_deleted = deleted;
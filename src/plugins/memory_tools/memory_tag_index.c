@@ -0,0 +1,777 @@
+/**
+ * @file memory_tag_index.c
+ * @brief Interned tag dictionary with roaring-style bitmaps over entry ordinals
+ *
+ * Every distinct tag string is interned once; its tag id is its slot in
+ * store->tag_index. Each tag keeps a compressed bitmap of the ordinals
+ * (positions in store->entries) of the entries carrying it, so multi-tag
+ * filters become bitmap intersections instead of per-entry strcmp loops.
+ * Alongside the bitmap, each tag keeps the same ordinals ordered by
+ * (timestamp, ordinal) - the time index order - so tag-filtered recency and
+ * range queries binary-search the tag's own postings instead of walking
+ * every entry in the window.
+ *
+ * Ordinals shift when the entries array is compacted, so forget, delete and
+ * bulk import call memory_rebuild_tag_index_internal() afterwards.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/memory_tools.h"
+#include "ethervox/logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BITSET_WORDS (65536 / 64)
+#define TAG_LOOKUP_INITIAL_CAPACITY 128
+
+static uint32_t count_trailing_zeros64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(word);
+#else
+    uint32_t n = 0;
+    while ((word & 1u) == 0) {
+        word >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Containers
+// ---------------------------------------------------------------------------
+
+static uint32_t array_lower_bound(const uint16_t* values, uint32_t count, uint16_t low) {
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (values[mid] < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool container_contains(const ethervox_memory_bitmap_container_t* c, uint16_t low) {
+    if (c->is_bitset) {
+        return (c->words[low >> 6] >> (low & 63)) & 1u;
+    }
+    uint32_t pos = array_lower_bound(c->values, c->cardinality, low);
+    return pos < c->cardinality && c->values[pos] == low;
+}
+
+static void container_free(ethervox_memory_bitmap_container_t* c) {
+    free(c->values);
+    free(c->words);
+    c->values = NULL;
+    c->words = NULL;
+    c->cardinality = 0;
+    c->capacity = 0;
+}
+
+static bool container_to_bitset(ethervox_memory_bitmap_container_t* c) {
+    uint64_t* words = calloc(BITSET_WORDS, sizeof(uint64_t));
+    if (!words) {
+        return false;
+    }
+    for (uint32_t i = 0; i < c->cardinality; i++) {
+        words[c->values[i] >> 6] |= (uint64_t)1 << (c->values[i] & 63);
+    }
+    free(c->values);
+    c->values = NULL;
+    c->capacity = 0;
+    c->words = words;
+    c->is_bitset = true;
+    return true;
+}
+
+static bool container_to_array(ethervox_memory_bitmap_container_t* c) {
+    uint16_t* values = malloc(ETHERVOX_MEMORY_BITMAP_ARRAY_MAX * sizeof(uint16_t));
+    if (!values) {
+        return false;
+    }
+    uint32_t n = 0;
+    for (uint32_t w = 0; w < BITSET_WORDS; w++) {
+        uint64_t word = c->words[w];
+        while (word) {
+            values[n++] = (uint16_t)(w * 64 + count_trailing_zeros64(word));
+            word &= word - 1;
+        }
+    }
+    free(c->words);
+    c->words = NULL;
+    c->values = values;
+    c->capacity = ETHERVOX_MEMORY_BITMAP_ARRAY_MAX;
+    c->is_bitset = false;
+    return true;
+}
+
+// Returns 1 if added, 0 if already present, -1 on allocation failure
+static int container_add(ethervox_memory_bitmap_container_t* c, uint16_t low) {
+    if (c->is_bitset) {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (c->words[low >> 6] & bit) {
+            return 0;
+        }
+        c->words[low >> 6] |= bit;
+        c->cardinality++;
+        return 1;
+    }
+
+    uint32_t pos = array_lower_bound(c->values, c->cardinality, low);
+    if (pos < c->cardinality && c->values[pos] == low) {
+        return 0;
+    }
+
+    if (c->cardinality >= ETHERVOX_MEMORY_BITMAP_ARRAY_MAX) {
+        if (!container_to_bitset(c)) {
+            return -1;
+        }
+        return container_add(c, low);
+    }
+
+    if (c->cardinality >= c->capacity) {
+        uint32_t new_capacity = c->capacity ? c->capacity * 2 : 4;
+        if (new_capacity > ETHERVOX_MEMORY_BITMAP_ARRAY_MAX) {
+            new_capacity = ETHERVOX_MEMORY_BITMAP_ARRAY_MAX;
+        }
+        uint16_t* values = realloc(c->values, new_capacity * sizeof(uint16_t));
+        if (!values) {
+            return -1;
+        }
+        c->values = values;
+        c->capacity = new_capacity;
+    }
+
+    memmove(&c->values[pos + 1], &c->values[pos], (c->cardinality - pos) * sizeof(uint16_t));
+    c->values[pos] = low;
+    c->cardinality++;
+    return 1;
+}
+
+// Returns true if the value was present and removed
+static bool container_remove(ethervox_memory_bitmap_container_t* c, uint16_t low) {
+    if (c->is_bitset) {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(c->words[low >> 6] & bit)) {
+            return false;
+        }
+        c->words[low >> 6] &= ~bit;
+        c->cardinality--;
+        if (c->cardinality <= ETHERVOX_MEMORY_BITMAP_ARRAY_MAX) {
+            container_to_array(c);  // Stays a valid bitset if this fails
+        }
+        return true;
+    }
+
+    uint32_t pos = array_lower_bound(c->values, c->cardinality, low);
+    if (pos >= c->cardinality || c->values[pos] != low) {
+        return false;
+    }
+    memmove(&c->values[pos], &c->values[pos + 1], (c->cardinality - pos - 1) * sizeof(uint16_t));
+    c->cardinality--;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Bitmaps
+// ---------------------------------------------------------------------------
+
+static uint32_t bitmap_container_pos(const ethervox_memory_bitmap_t* bm, uint16_t key) {
+    uint32_t lo = 0;
+    uint32_t hi = bm->container_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (bm->containers[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static const ethervox_memory_bitmap_container_t* bitmap_find(
+    const ethervox_memory_bitmap_t* bm,
+    uint16_t key
+) {
+    uint32_t pos = bitmap_container_pos(bm, key);
+    if (pos < bm->container_count && bm->containers[pos].key == key) {
+        return &bm->containers[pos];
+    }
+    return NULL;
+}
+
+static bool bitmap_add(ethervox_memory_bitmap_t* bm, uint32_t ordinal) {
+    uint16_t key = (uint16_t)(ordinal >> 16);
+    uint32_t pos = bitmap_container_pos(bm, key);
+
+    if (pos >= bm->container_count || bm->containers[pos].key != key) {
+        if (bm->container_count >= bm->container_capacity) {
+            uint32_t new_capacity = bm->container_capacity ? bm->container_capacity * 2 : 1;
+            ethervox_memory_bitmap_container_t* containers = realloc(
+                bm->containers,
+                new_capacity * sizeof(ethervox_memory_bitmap_container_t)
+            );
+            if (!containers) {
+                return false;
+            }
+            bm->containers = containers;
+            bm->container_capacity = new_capacity;
+        }
+        memmove(&bm->containers[pos + 1], &bm->containers[pos],
+                (bm->container_count - pos) * sizeof(ethervox_memory_bitmap_container_t));
+        memset(&bm->containers[pos], 0, sizeof(ethervox_memory_bitmap_container_t));
+        bm->containers[pos].key = key;
+        bm->container_count++;
+    }
+
+    int added = container_add(&bm->containers[pos], (uint16_t)(ordinal & 0xFFFF));
+    if (added < 0) {
+        return false;
+    }
+    bm->cardinality += (uint32_t)added;
+    return true;
+}
+
+static void bitmap_remove(ethervox_memory_bitmap_t* bm, uint32_t ordinal) {
+    uint16_t key = (uint16_t)(ordinal >> 16);
+    uint32_t pos = bitmap_container_pos(bm, key);
+    if (pos >= bm->container_count || bm->containers[pos].key != key) {
+        return;
+    }
+
+    ethervox_memory_bitmap_container_t* c = &bm->containers[pos];
+    if (!container_remove(c, (uint16_t)(ordinal & 0xFFFF))) {
+        return;
+    }
+    bm->cardinality--;
+
+    if (c->cardinality == 0) {
+        container_free(c);
+        memmove(&bm->containers[pos], &bm->containers[pos + 1],
+                (bm->container_count - pos - 1) * sizeof(ethervox_memory_bitmap_container_t));
+        bm->container_count--;
+    }
+}
+
+static void bitmap_free(ethervox_memory_bitmap_t* bm) {
+    for (uint32_t i = 0; i < bm->container_count; i++) {
+        container_free(&bm->containers[i]);
+    }
+    free(bm->containers);
+    memset(bm, 0, sizeof(*bm));
+}
+
+// ---------------------------------------------------------------------------
+// Time-ordered posting lists
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    time_t timestamp;
+    uint32_t ordinal;
+} posting_sort_item_t;
+
+static int compare_posting_items(const void* a, const void* b) {
+    const posting_sort_item_t* x = a;
+    const posting_sort_item_t* y = b;
+    if (x->timestamp != y->timestamp) {
+        return (x->timestamp < y->timestamp) ? -1 : 1;
+    }
+    return (x->ordinal < y->ordinal) ? -1 : (x->ordinal > y->ordinal);
+}
+
+// First posting whose (timestamp, ordinal) is >= (ts, ordinal)
+static uint32_t posting_lower_bound(
+    const ethervox_memory_store_t* store,
+    const ethervox_memory_tag_index_t* idx,
+    time_t ts,
+    uint32_t ordinal
+) {
+    uint32_t lo = 0;
+    uint32_t hi = idx->by_time_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        uint32_t other = idx->by_time[mid];
+        time_t other_ts = store->entries[other].timestamp;
+        if (other_ts < ts || (other_ts == ts && other < ordinal)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool posting_reserve(ethervox_memory_tag_index_t* idx, uint32_t needed) {
+    if (needed <= idx->by_time_capacity) {
+        return true;
+    }
+    uint32_t new_capacity = idx->by_time_capacity ? idx->by_time_capacity * 2 : 4;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    uint32_t* by_time = realloc(idx->by_time, new_capacity * sizeof(uint32_t));
+    if (!by_time) {
+        return false;
+    }
+    idx->by_time = by_time;
+    idx->by_time_capacity = new_capacity;
+    return true;
+}
+
+// Insert at the ordinal's time position; live appends land on the tail
+static bool posting_insert(
+    const ethervox_memory_store_t* store,
+    ethervox_memory_tag_index_t* idx,
+    uint32_t ordinal
+) {
+    uint32_t pos = posting_lower_bound(store, idx, store->entries[ordinal].timestamp, ordinal);
+    if (pos < idx->by_time_count && idx->by_time[pos] == ordinal) {
+        return true;
+    }
+    if (!posting_reserve(idx, idx->by_time_count + 1)) {
+        return false;
+    }
+    memmove(&idx->by_time[pos + 1], &idx->by_time[pos],
+            (idx->by_time_count - pos) * sizeof(uint32_t));
+    idx->by_time[pos] = ordinal;
+    idx->by_time_count++;
+    return true;
+}
+
+static void posting_remove(
+    const ethervox_memory_store_t* store,
+    ethervox_memory_tag_index_t* idx,
+    uint32_t ordinal
+) {
+    uint32_t pos = posting_lower_bound(store, idx, store->entries[ordinal].timestamp, ordinal);
+    if (pos >= idx->by_time_count || idx->by_time[pos] != ordinal) {
+        return;
+    }
+    memmove(&idx->by_time[pos], &idx->by_time[pos + 1],
+            (idx->by_time_count - pos - 1) * sizeof(uint32_t));
+    idx->by_time_count--;
+}
+
+// Put a list filled in ordinal order into time order (rebuild path)
+static bool posting_sort(
+    const ethervox_memory_store_t* store,
+    ethervox_memory_tag_index_t* idx,
+    posting_sort_item_t* scratch
+) {
+    bool ordered = true;
+    for (uint32_t i = 1; i < idx->by_time_count && ordered; i++) {
+        ordered = store->entries[idx->by_time[i]].timestamp >=
+                  store->entries[idx->by_time[i - 1]].timestamp;
+    }
+    if (ordered) {
+        return true;
+    }
+    if (!scratch) {
+        return false;
+    }
+    for (uint32_t i = 0; i < idx->by_time_count; i++) {
+        scratch[i].timestamp = store->entries[idx->by_time[i]].timestamp;
+        scratch[i].ordinal = idx->by_time[i];
+    }
+    qsort(scratch, idx->by_time_count, sizeof(posting_sort_item_t), compare_posting_items);
+    for (uint32_t i = 0; i < idx->by_time_count; i++) {
+        idx->by_time[i] = scratch[i].ordinal;
+    }
+    return true;
+}
+
+static void posting_free(ethervox_memory_tag_index_t* idx) {
+    free(idx->by_time);
+    idx->by_time = NULL;
+    idx->by_time_count = 0;
+    idx->by_time_capacity = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Tag dictionary
+// ---------------------------------------------------------------------------
+
+// FNV-1a over the stored (truncated) form of the tag
+static uint32_t tag_hash(const char* tag) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; tag[i] && i < ETHERVOX_MEMORY_TAG_LEN - 1; i++) {
+        hash ^= (unsigned char)tag[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool tag_equals(const char* stored, const char* tag) {
+    return strncmp(stored, tag, ETHERVOX_MEMORY_TAG_LEN - 1) == 0;
+}
+
+static uint32_t find_tag_id(const ethervox_memory_store_t* store, const char* tag) {
+    if (!store->tag_lookup) {
+        return UINT32_MAX;
+    }
+    uint32_t mask = store->tag_lookup_capacity - 1;
+    for (uint32_t slot = tag_hash(tag) & mask;; slot = (slot + 1) & mask) {
+        uint32_t value = store->tag_lookup[slot];
+        if (value == 0) {
+            return UINT32_MAX;
+        }
+        if (tag_equals(store->tag_index[value - 1].tag, tag)) {
+            return value - 1;
+        }
+    }
+}
+
+static bool tag_lookup_resize(ethervox_memory_store_t* store, uint32_t new_capacity) {
+    uint32_t* lookup = calloc(new_capacity, sizeof(uint32_t));
+    if (!lookup) {
+        return false;
+    }
+    uint32_t mask = new_capacity - 1;
+    for (uint32_t id = 0; id < store->tag_index_count; id++) {
+        uint32_t slot = tag_hash(store->tag_index[id].tag) & mask;
+        while (lookup[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        lookup[slot] = id + 1;
+    }
+    free(store->tag_lookup);
+    store->tag_lookup = lookup;
+    store->tag_lookup_capacity = new_capacity;
+    return true;
+}
+
+// Find or create the tag id for a tag string (UINT32_MAX on allocation failure)
+static uint32_t intern_tag(ethervox_memory_store_t* store, const char* tag) {
+    uint32_t id = find_tag_id(store, tag);
+    if (id != UINT32_MAX) {
+        return id;
+    }
+
+    // Keep the lookup table at most half full
+    if (!store->tag_lookup || (store->tag_index_count + 1) * 2 > store->tag_lookup_capacity) {
+        uint32_t new_capacity = store->tag_lookup_capacity ?
+                                store->tag_lookup_capacity * 2 : TAG_LOOKUP_INITIAL_CAPACITY;
+        if (!tag_lookup_resize(store, new_capacity)) {
+            return UINT32_MAX;
+        }
+    }
+
+    if (store->tag_index_count >= store->tag_index_capacity) {
+        uint32_t new_capacity = store->tag_index_capacity ? store->tag_index_capacity * 2 : 64;
+        ethervox_memory_tag_index_t* new_index = realloc(
+            store->tag_index,
+            new_capacity * sizeof(ethervox_memory_tag_index_t)
+        );
+        if (!new_index) {
+            return UINT32_MAX;
+        }
+        store->tag_index = new_index;
+        store->tag_index_capacity = new_capacity;
+    }
+
+    id = store->tag_index_count++;
+    ethervox_memory_tag_index_t* idx = &store->tag_index[id];
+    memset(idx, 0, sizeof(*idx));
+    snprintf(idx->tag, sizeof(idx->tag), "%s", tag);
+
+    uint32_t mask = store->tag_lookup_capacity - 1;
+    uint32_t slot = tag_hash(idx->tag) & mask;
+    while (store->tag_lookup[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    store->tag_lookup[slot] = id + 1;
+
+    return id;
+}
+
+// ---------------------------------------------------------------------------
+// Internal API (used by memory_core.c, memory_search.c and memory_import.c)
+// ---------------------------------------------------------------------------
+
+// Add store->entries[ordinal] to the bitmap and posting list of each of its
+// tags. The rebuild path appends in ordinal order and sorts afterwards.
+static void index_entry(ethervox_memory_store_t* store, uint32_t ordinal, bool append) {
+    const ethervox_memory_entry_t* entry = &store->entries[ordinal];
+    for (uint32_t t = 0; t < entry->tag_count; t++) {
+        uint32_t id = intern_tag(store, entry->tags[t]);
+        bool ok = id != UINT32_MAX && bitmap_add(&store->tag_index[id].entries, ordinal);
+        if (ok) {
+            ethervox_memory_tag_index_t* idx = &store->tag_index[id];
+            if (append) {
+                ok = posting_reserve(idx, idx->by_time_count + 1);
+                if (ok) {
+                    idx->by_time[idx->by_time_count++] = ordinal;
+                }
+            } else {
+                ok = posting_insert(store, idx, ordinal);
+            }
+        }
+        if (!ok) {
+            ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                        "Out of memory indexing tag '%s' for memory %llu",
+                        entry->tags[t], (unsigned long long)entry->memory_id);
+        }
+    }
+}
+
+// Index the tags of store->entries[ordinal]
+void memory_tag_index_add_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal) {
+    if (!store || ordinal >= store->entry_capacity) {
+        return;
+    }
+    index_entry(store, ordinal, false);
+}
+
+// Drop store->entries[ordinal] from the bitmaps of its current tags
+void memory_tag_index_remove_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal) {
+    if (!store || ordinal >= store->entry_count) {
+        return;
+    }
+
+    const ethervox_memory_entry_t* entry = &store->entries[ordinal];
+    for (uint32_t t = 0; t < entry->tag_count; t++) {
+        uint32_t id = find_tag_id(store, entry->tags[t]);
+        if (id != UINT32_MAX) {
+            bitmap_remove(&store->tag_index[id].entries, ordinal);
+            posting_remove(store, &store->tag_index[id], ordinal);
+        }
+    }
+}
+
+// Rebuild the tag index from the current entries array.
+// Used after bulk import and after pruning/deleting entries.
+void memory_rebuild_tag_index_internal(ethervox_memory_store_t* store) {
+    if (!store || !store->is_initialized || !store->tag_index) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < store->tag_index_count; i++) {
+        bitmap_free(&store->tag_index[i].entries);
+        posting_free(&store->tag_index[i]);
+    }
+    store->tag_index_count = 0;
+    if (store->tag_lookup) {
+        memset(store->tag_lookup, 0, store->tag_lookup_capacity * sizeof(uint32_t));
+    }
+
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        index_entry(store, i, true);
+    }
+
+    // Entries are normally time-ordered already; imports may not be
+    posting_sort_item_t* scratch = NULL;
+    for (uint32_t i = 0; i < store->tag_index_count; i++) {
+        ethervox_memory_tag_index_t* idx = &store->tag_index[i];
+        if (posting_sort(store, idx, scratch)) {
+            continue;
+        }
+        if (!scratch) {
+            scratch = malloc(store->entry_count * sizeof(posting_sort_item_t));
+        }
+        if (!posting_sort(store, idx, scratch)) {
+            ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                        "Out of memory ordering postings for tag '%s'", idx->tag);
+            bitmap_free(&idx->entries);
+            posting_free(idx);
+        }
+    }
+    free(scratch);
+}
+
+// Free every bitmap plus the dictionary itself
+void memory_tag_index_free_internal(ethervox_memory_store_t* store) {
+    if (!store) {
+        return;
+    }
+
+    if (store->tag_index) {
+        for (uint32_t i = 0; i < store->tag_index_count; i++) {
+            bitmap_free(&store->tag_index[i].entries);
+            posting_free(&store->tag_index[i]);
+        }
+        free(store->tag_index);
+        store->tag_index = NULL;
+    }
+    store->tag_index_count = 0;
+    store->tag_index_capacity = 0;
+
+    free(store->tag_lookup);
+    store->tag_lookup = NULL;
+    store->tag_lookup_capacity = 0;
+}
+
+// Tag id for a tag string, or UINT32_MAX if no entry has ever carried it
+uint32_t memory_tag_index_lookup_internal(const ethervox_memory_store_t* store, const char* tag) {
+    if (!store || !tag) {
+        return UINT32_MAX;
+    }
+    return find_tag_id(store, tag);
+}
+
+// True if store->entries[ordinal] carries the interned tag
+bool memory_tag_index_contains_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    uint32_t ordinal
+) {
+    if (!store || tag_id >= store->tag_index_count) {
+        return false;
+    }
+    const ethervox_memory_bitmap_container_t* c =
+        bitmap_find(&store->tag_index[tag_id].entries, (uint16_t)(ordinal >> 16));
+    return c && container_contains(c, (uint16_t)(ordinal & 0xFFFF));
+}
+
+// Ordinals carrying the interned tag in (timestamp, ordinal) order
+const uint32_t* memory_tag_index_by_time_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    uint32_t* count_out
+) {
+    *count_out = 0;
+    if (!store || tag_id >= store->tag_index_count) {
+        return NULL;
+    }
+    *count_out = store->tag_index[tag_id].by_time_count;
+    return store->tag_index[tag_id].by_time;
+}
+
+// First position in the tag's time-ordered postings at or after the
+// time index key (timestamp, ordinal)
+uint32_t memory_tag_index_time_lower_bound_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    time_t timestamp,
+    uint32_t ordinal
+) {
+    if (!store || tag_id >= store->tag_index_count) {
+        return 0;
+    }
+    return posting_lower_bound(store, &store->tag_index[tag_id], timestamp, ordinal);
+}
+
+// Ordinals of the entries carrying every tag in tags[], ascending.
+// *ordinals_out is NULL when nothing matches; otherwise the caller frees it.
+ethervox_result_t memory_tag_index_query_internal(
+    const ethervox_memory_store_t* store,
+    const char* tags[],
+    uint32_t tag_count,
+    uint32_t** ordinals_out,
+    uint32_t* count_out
+) {
+    if (!store || !tags || tag_count == 0 || !ordinals_out || !count_out) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    *ordinals_out = NULL;
+    *count_out = 0;
+
+    const ethervox_memory_bitmap_t** sets = malloc(tag_count * sizeof(*sets));
+    const ethervox_memory_bitmap_container_t** matched = malloc(tag_count * sizeof(*matched));
+    if (!sets || !matched) {
+        free(sets);
+        free(matched);
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+
+    // Resolve tag ids; an unknown tag means an empty intersection
+    for (uint32_t i = 0; i < tag_count; i++) {
+        uint32_t id = tags[i] ? find_tag_id(store, tags[i]) : UINT32_MAX;
+        if (id == UINT32_MAX || store->tag_index[id].entries.cardinality == 0) {
+            free(sets);
+            free(matched);
+            return ETHERVOX_SUCCESS;
+        }
+        sets[i] = &store->tag_index[id].entries;
+    }
+
+    // Smallest bitmap first so it drives the intersection
+    for (uint32_t i = 1; i < tag_count; i++) {
+        const ethervox_memory_bitmap_t* key = sets[i];
+        uint32_t j = i;
+        while (j > 0 && sets[j - 1]->cardinality > key->cardinality) {
+            sets[j] = sets[j - 1];
+            j--;
+        }
+        sets[j] = key;
+    }
+
+    uint32_t* ordinals = malloc(sets[0]->cardinality * sizeof(uint32_t));
+    if (!ordinals) {
+        free(sets);
+        free(matched);
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t c = 0; c < sets[0]->container_count; c++) {
+        const ethervox_memory_bitmap_container_t* first = &sets[0]->containers[c];
+        uint32_t base = (uint32_t)first->key << 16;
+
+        // Every bitmap needs a container for this key; the sparsest array drives
+        const ethervox_memory_bitmap_container_t* driver = NULL;
+        bool present = true;
+        for (uint32_t i = 0; i < tag_count; i++) {
+            matched[i] = (i == 0) ? first : bitmap_find(sets[i], first->key);
+            if (!matched[i]) {
+                present = false;
+                break;
+            }
+            if (!matched[i]->is_bitset &&
+                (!driver || matched[i]->cardinality < driver->cardinality)) {
+                driver = matched[i];
+            }
+        }
+        if (!present) {
+            continue;
+        }
+
+        if (!driver) {
+            // All bitsets: word-wise AND
+            for (uint32_t w = 0; w < BITSET_WORDS; w++) {
+                uint64_t word = matched[0]->words[w];
+                for (uint32_t i = 1; i < tag_count && word; i++) {
+                    word &= matched[i]->words[w];
+                }
+                while (word) {
+                    ordinals[n++] = base | (w * 64 + count_trailing_zeros64(word));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (uint32_t v = 0; v < driver->cardinality; v++) {
+                uint16_t low = driver->values[v];
+                bool all = true;
+                for (uint32_t i = 0; i < tag_count; i++) {
+                    if (matched[i] != driver && !container_contains(matched[i], low)) {
+                        all = false;
+                        break;
+                    }
+                }
+                if (all) {
+                    ordinals[n++] = base | low;
+                }
+            }
+        }
+    }
+
+    free(sets);
+    free(matched);
+
+    if (n == 0) {
+        free(ordinals);
+        return ETHERVOX_SUCCESS;
+    }
+
+    *ordinals_out = ordinals;
+    *count_out = n;
+    return ETHERVOX_SUCCESS;
+}
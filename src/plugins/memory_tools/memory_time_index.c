@@ -0,0 +1,403 @@
+/**
+ * @file memory_time_index.c
+ * @brief Time-ordered secondary index for recency and time-range retrieval
+ *
+ * store->time_index holds entry ordinals sorted by (timestamp, ordinal).
+ * Live appends arrive in timestamp order and are pushed onto the tail in
+ * O(1); out-of-order timestamps (imports, clock changes) are inserted at
+ * their binary-searched position. Deletions compact the entries array, and
+ * the index is rebuilt in the same pass - linear when the entries are
+ * already time-ordered, which is the normal case.
+ *
+ * Tag-filtered queries do not walk this index: the window's bounds are
+ * located in the sparsest filter tag's time-ordered postings, and only
+ * those entries are visited, so a query costs O(log n + k) rather than
+ * O(window).
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/memory_tools.h"
+#include "ethervox/logging.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tag bitmaps and time-ordered postings (memory_tag_index.c)
+extern uint32_t memory_tag_index_lookup_internal(const ethervox_memory_store_t* store, const char* tag);
+extern bool memory_tag_index_contains_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    uint32_t ordinal
+);
+extern const uint32_t* memory_tag_index_by_time_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    uint32_t* count_out
+);
+extern uint32_t memory_tag_index_time_lower_bound_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    time_t timestamp,
+    uint32_t ordinal
+);
+
+typedef struct {
+    time_t timestamp;
+    uint32_t ordinal;
+} time_sort_item_t;
+
+static int compare_time_items(const void* a, const void* b) {
+    const time_sort_item_t* x = a;
+    const time_sort_item_t* y = b;
+    if (x->timestamp != y->timestamp) {
+        return (x->timestamp < y->timestamp) ? -1 : 1;
+    }
+    return (x->ordinal < y->ordinal) ? -1 : (x->ordinal > y->ordinal);
+}
+
+static time_t index_timestamp(const ethervox_memory_store_t* store, uint32_t pos) {
+    return store->entries[store->time_index[pos]].timestamp;
+}
+
+// First index position whose timestamp is >= ts
+static uint32_t lower_bound(const ethervox_memory_store_t* store, time_t ts) {
+    uint32_t lo = 0;
+    uint32_t hi = store->time_index_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index_timestamp(store, mid) < ts) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// First index position whose timestamp is > ts
+static uint32_t upper_bound(const ethervox_memory_store_t* store, time_t ts) {
+    uint32_t lo = 0;
+    uint32_t hi = store->time_index_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index_timestamp(store, mid) <= ts) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool reserve_index(ethervox_memory_store_t* store, uint32_t needed) {
+    if (needed <= store->time_index_capacity) {
+        return true;
+    }
+    uint32_t new_capacity = store->time_index_capacity ? store->time_index_capacity : 256;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    uint32_t* index = realloc(store->time_index, new_capacity * sizeof(uint32_t));
+    if (!index) {
+        return false;
+    }
+    store->time_index = index;
+    store->time_index_capacity = new_capacity;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Internal API (used by memory_core.c and memory_search.c)
+// ---------------------------------------------------------------------------
+
+// Add store->entries[ordinal] (the newest ordinal) to the time index
+void memory_time_index_add_entry_internal(ethervox_memory_store_t* store, uint32_t ordinal) {
+    if (!store || ordinal >= store->entry_capacity) {
+        return;
+    }
+    if (!reserve_index(store, store->time_index_count + 1)) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                    "Out of memory growing time index");
+        return;
+    }
+
+    // Ties keep ordinal order, and a new ordinal is always the largest
+    time_t ts = store->entries[ordinal].timestamp;
+    uint32_t pos = store->time_index_count;
+    if (pos > 0 && index_timestamp(store, pos - 1) > ts) {
+        pos = upper_bound(store, ts);
+        memmove(&store->time_index[pos + 1], &store->time_index[pos],
+                (store->time_index_count - pos) * sizeof(uint32_t));
+    }
+    store->time_index[pos] = ordinal;
+    store->time_index_count++;
+}
+
+// Rebuild the time index from the current entries array
+void memory_time_index_rebuild_internal(ethervox_memory_store_t* store) {
+    if (!store || !store->is_initialized) {
+        return;
+    }
+
+    store->time_index_count = 0;
+    if (store->entry_count == 0) {
+        return;
+    }
+    if (!reserve_index(store, store->entry_count)) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                    "Out of memory rebuilding time index");
+        return;
+    }
+
+    bool ordered = true;
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        store->time_index[i] = i;
+        if (i > 0 && store->entries[i].timestamp < store->entries[i - 1].timestamp) {
+            ordered = false;
+        }
+    }
+    store->time_index_count = store->entry_count;
+
+    if (ordered) {
+        return;
+    }
+
+    time_sort_item_t* items = malloc(store->entry_count * sizeof(time_sort_item_t));
+    if (!items) {
+        ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__,
+                    "Out of memory sorting time index");
+        store->time_index_count = 0;
+        return;
+    }
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        items[i].timestamp = store->entries[i].timestamp;
+        items[i].ordinal = i;
+    }
+    qsort(items, store->entry_count, sizeof(time_sort_item_t), compare_time_items);
+    for (uint32_t i = 0; i < store->entry_count; i++) {
+        store->time_index[i] = items[i].ordinal;
+    }
+    free(items);
+}
+
+void memory_time_index_free_internal(ethervox_memory_store_t* store) {
+    if (!store) {
+        return;
+    }
+    free(store->time_index);
+    store->time_index = NULL;
+    store->time_index_count = 0;
+    store->time_index_capacity = 0;
+}
+
+// Exponential recency in (0, 1], measured against the newest memory so that
+// restored sessions rank the same regardless of wall-clock time
+float memory_recency_score_internal(const ethervox_memory_store_t* store, time_t timestamp) {
+    if (!store || store->time_index_count == 0) {
+        return 1.0f;
+    }
+    time_t newest = index_timestamp(store, store->time_index_count - 1);
+    double age = difftime(newest, timestamp);
+    if (age <= 0.0) {
+        return 1.0f;
+    }
+    return (float)exp(-0.69314718 * age / (double)ETHERVOX_MEMORY_RECENCY_HALF_LIFE_S);
+}
+
+// Relevance assigned to results ranked without a text query
+float memory_recency_relevance_internal(
+    const ethervox_memory_store_t* store,
+    const ethervox_memory_entry_t* entry
+) {
+    return entry->importance * 0.6f + memory_recency_score_internal(store, entry->timestamp) * 0.4f;
+}
+
+// Ordinals of the last `window` entries in time order (oldest first).
+// Returns the number written to *ordinals_out (caller frees).
+uint32_t memory_time_index_last_internal(
+    const ethervox_memory_store_t* store,
+    uint32_t window,
+    uint32_t** ordinals_out
+) {
+    *ordinals_out = NULL;
+    if (!store || store->time_index_count == 0 || window == 0) {
+        return 0;
+    }
+    if (window > store->time_index_count) {
+        window = store->time_index_count;
+    }
+    uint32_t* ordinals = malloc(window * sizeof(uint32_t));
+    if (!ordinals) {
+        return 0;
+    }
+    memcpy(ordinals, &store->time_index[store->time_index_count - window], window * sizeof(uint32_t));
+    *ordinals_out = ordinals;
+    return window;
+}
+
+// ---------------------------------------------------------------------------
+// Public queries
+// ---------------------------------------------------------------------------
+
+// Resolve filter tags; false if any tag is unknown (nothing can match)
+static bool resolve_tag_filter(
+    const ethervox_memory_store_t* store,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t* tag_ids
+) {
+    for (uint32_t i = 0; i < tag_filter_count; i++) {
+        tag_ids[i] = memory_tag_index_lookup_internal(store, tag_filter[i]);
+        if (tag_ids[i] == UINT32_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool has_tag_ids(
+    const ethervox_memory_store_t* store,
+    const uint32_t* tag_ids,
+    uint32_t tag_count,
+    uint32_t ordinal
+) {
+    for (uint32_t i = 0; i < tag_count; i++) {
+        if (!memory_tag_index_contains_internal(store, tag_ids[i], ordinal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Position in a tag's postings that corresponds to time index position pos
+static uint32_t posting_position(
+    const ethervox_memory_store_t* store,
+    uint32_t tag_id,
+    uint32_t pos
+) {
+    if (pos >= store->time_index_count) {
+        uint32_t count = 0;
+        memory_tag_index_by_time_internal(store, tag_id, &count);
+        return count;
+    }
+    uint32_t ordinal = store->time_index[pos];
+    return memory_tag_index_time_lower_bound_internal(store, tag_id,
+                                                      store->entries[ordinal].timestamp, ordinal);
+}
+
+// Collect matches from index positions [begin, end), walking forward or backward.
+// With a tag filter the sparsest tag's postings inside the window are walked
+// instead of the window itself.
+static ethervox_result_t collect_range(
+    ethervox_memory_store_t* store,
+    uint32_t begin,
+    uint32_t end,
+    bool newest_first,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t limit,
+    ethervox_memory_search_result_t** results,
+    uint32_t* result_count
+) {
+    *results = NULL;
+    *result_count = 0;
+
+    // Candidates are time index positions, or postings of the driving tag
+    const uint32_t* candidates = store->time_index;
+    uint32_t first = begin;
+    uint32_t span = end - begin;
+
+    uint32_t* tag_ids = NULL;
+    if (tag_filter && tag_filter_count > 0) {
+        tag_ids = malloc(tag_filter_count * sizeof(uint32_t));
+        if (!tag_ids) {
+            return ETHERVOX_ERROR_OUT_OF_MEMORY;
+        }
+        if (!resolve_tag_filter(store, tag_filter, tag_filter_count, tag_ids)) {
+            span = 0;  // Unknown tag: empty result
+        }
+        for (uint32_t i = 0; i < tag_filter_count && span > 0; i++) {
+            uint32_t lo = posting_position(store, tag_ids[i], begin);
+            uint32_t hi = posting_position(store, tag_ids[i], end);
+            if (i == 0 || hi - lo < span) {
+                uint32_t posting_count = 0;
+                candidates = memory_tag_index_by_time_internal(store, tag_ids[i], &posting_count);
+                first = lo;
+                span = hi - lo;
+            }
+        }
+    }
+
+    if (limit == 0 || limit > span) {
+        limit = span;
+    }
+
+    ethervox_memory_search_result_t* out = malloc(
+        (limit > 0 ? limit : 1) * sizeof(ethervox_memory_search_result_t)
+    );
+    if (!out) {
+        free(tag_ids);
+        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t found = 0;
+    for (uint32_t k = 0; k < span && found < limit; k++) {
+        uint32_t ordinal = candidates[newest_first ? (first + span - 1 - k) : (first + k)];
+        // The driving tag matches by construction; check any others
+        if (tag_ids && tag_filter_count > 1 &&
+            !has_tag_ids(store, tag_ids, tag_filter_count, ordinal)) {
+            continue;
+        }
+        out[found].entry = store->entries[ordinal];
+        out[found].relevance = memory_recency_relevance_internal(store, &store->entries[ordinal]);
+        found++;
+    }
+
+    free(tag_ids);
+    *results = out;
+    *result_count = found;
+    return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_memory_get_recent(
+    ethervox_memory_store_t* store,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t limit,
+    ethervox_memory_search_result_t** results,
+    uint32_t* result_count
+) {
+    if (!store || !store->is_initialized || !results || !result_count) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (limit == 0) {
+        limit = 10;  // Default limit, same as search
+    }
+
+    return collect_range(store, 0, store->time_index_count, true,
+                         tag_filter, tag_filter_count, limit, results, result_count);
+}
+
+ethervox_result_t ethervox_memory_get_range(
+    ethervox_memory_store_t* store,
+    time_t start_time,
+    time_t end_time,
+    const char* tag_filter[],
+    uint32_t tag_filter_count,
+    uint32_t limit,
+    ethervox_memory_search_result_t** results,
+    uint32_t* result_count
+) {
+    if (!store || !store->is_initialized || !results || !result_count || end_time < start_time) {
+        return ETHERVOX_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint32_t begin = lower_bound(store, start_time);
+    uint32_t end = upper_bound(store, end_time);
+
+    return collect_range(store, begin, end, false,
+                         tag_filter, tag_filter_count, limit, results, result_count);
+}
@@ -14,6 +14,7 @@
  */
 
 #include "ethervox/timer_tools.h"
+#include "ethervox/tool_args.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,50 +41,27 @@ typedef struct {
 static timer_entry_t timers[MAX_TIMERS];
 static int next_timer_id = 1;
 
-// JSON parsing helpers
-static char* extract_json_string(const char* json, const char* key) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return NULL;
-    
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return NULL;
-    
-    const char* value_start = strchr(colon, '"');
-    if (!value_start) return NULL;
-    value_start++;
-    
-    const char* value_end = strchr(value_start, '"');
-    if (!value_end) return NULL;
-    
-    size_t len = value_end - value_start;
-    char* result = malloc(len + 1);
-    if (!result) return NULL;
-    
-    strncpy(result, value_start, len);
-    result[len] = '\0';
-    return result;
-}
+typedef struct {
+    int duration_seconds;
+    char label[128];
+} timer_create_args_t;
 
-static int extract_json_int(const char* json, const char* key, int default_value) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\"", key);
-    
-    const char* key_pos = strstr(json, search);
-    if (!key_pos) return default_value;
-    
-    const char* colon = strchr(key_pos, ':');
-    if (!colon) return default_value;
-    
-    int value;
-    if (sscanf(colon + 1, "%d", &value) == 1) {
-        return value;
-    }
-    
-    return default_value;
-}
+static const ethervox_tool_arg_spec_t timer_create_spec[] = {
+    ETHERVOX_TOOL_ARG_FIELD("duration_seconds", timer_create_args_t, duration_seconds, ETHERVOX_TOOL_ARG_INT, true),
+    ETHERVOX_TOOL_ARG_FIELD("label", timer_create_args_t, label, ETHERVOX_TOOL_ARG_STRING, false),
+};
+
+typedef struct {
+    int hour;
+    int minute;
+    char label[128];
+} alarm_create_args_t;
+
+static const ethervox_tool_arg_spec_t alarm_create_spec[] = {
+    ETHERVOX_TOOL_ARG_FIELD("hour", alarm_create_args_t, hour, ETHERVOX_TOOL_ARG_INT, true),
+    ETHERVOX_TOOL_ARG_FIELD("minute", alarm_create_args_t, minute, ETHERVOX_TOOL_ARG_INT, true),
+    ETHERVOX_TOOL_ARG_FIELD("label", alarm_create_args_t, label, ETHERVOX_TOOL_ARG_STRING, false),
+};
 
 /**
  * Timer Create Tool
@@ -95,14 +73,16 @@ static int timer_create_execute(const char* args_json, char** result, char** err
     }
     
     // Extract parameters
-    int duration = extract_json_int(args_json, "duration_seconds", 0);
-    char* label = extract_json_string(args_json, "label");
-    
-    if (duration <= 0) {
+    ethervox_tool_args_t args;
+    timer_create_args_t params = { .duration_seconds = 0, .label = "" };
+    uint32_t spec_count = sizeof(timer_create_spec) / sizeof(timer_create_spec[0]);
+    if (ethervox_tool_args_parse(&args, args_json) != ETHERVOX_SUCCESS ||
+        ethervox_tool_args_bind(&args, timer_create_spec, spec_count, &params, NULL) != ETHERVOX_SUCCESS ||
+        params.duration_seconds <= 0) {
         *error = strdup("Invalid duration - must be positive number of seconds");
-        free(label);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
+    int duration = params.duration_seconds;
     
     // Find free slot
     int slot = -1;
@@ -115,7 +95,6 @@ static int timer_create_execute(const char* args_json, char** result, char** err
     
     if (slot == -1) {
         *error = strdup("Maximum number of timers reached (10)");
-        free(label);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
@@ -125,10 +104,8 @@ static int timer_create_execute(const char* args_json, char** result, char** err
     timers[slot].is_active = true;
     timers[slot].is_alarm = false;
     
-    if (label) {
-        strncpy(timers[slot].label, label, sizeof(timers[slot].label) - 1);
-        timers[slot].label[sizeof(timers[slot].label) - 1] = '\0';
-        free(label);
+    if (params.label[0] != '\0') {
+        snprintf(timers[slot].label, sizeof(timers[slot].label), "%s", params.label);
     } else {
         snprintf(timers[slot].label, sizeof(timers[slot].label), "Timer %d", timers[slot].id);
     }
@@ -159,7 +136,11 @@ static int timer_cancel_execute(const char* args_json, char** result, char** err
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
-    int timer_id = extract_json_int(args_json, "timer_id", -1);
+    ethervox_tool_args_t args;
+    int64_t timer_id = -1;
+    if (ethervox_tool_args_parse(&args, args_json) == ETHERVOX_SUCCESS) {
+        ethervox_tool_args_get_int(&args, "timer_id", &timer_id);
+    }
     
     if (timer_id < 0) {
         *error = strdup("Invalid timer_id");
@@ -172,7 +153,7 @@ static int timer_cancel_execute(const char* args_json, char** result, char** err
         if (timers[i].is_active && timers[i].id == timer_id) {
             timers[i].is_active = false;
             found = true;
-            TIMER_LOG("Canceled timer %d: %s", timer_id, timers[i].label);
+            TIMER_LOG("Canceled timer %d: %s", (int)timer_id, timers[i].label);
             break;
         }
     }
@@ -205,15 +186,17 @@ static int alarm_create_execute(const char* args_json, char** result, char** err
     }
     
     // Extract parameters
-    int hour = extract_json_int(args_json, "hour", -1);
-    int minute = extract_json_int(args_json, "minute", -1);
-    char* label = extract_json_string(args_json, "label");
-    
-    if (hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+    ethervox_tool_args_t args;
+    alarm_create_args_t params = { .hour = -1, .minute = -1, .label = "" };
+    uint32_t spec_count = sizeof(alarm_create_spec) / sizeof(alarm_create_spec[0]);
+    if (ethervox_tool_args_parse(&args, args_json) != ETHERVOX_SUCCESS ||
+        ethervox_tool_args_bind(&args, alarm_create_spec, spec_count, &params, NULL) != ETHERVOX_SUCCESS ||
+        params.hour < 0 || params.hour > 23 || params.minute < 0 || params.minute > 59) {
         *error = strdup("Invalid time - hour must be 0-23, minute must be 0-59");
-        free(label);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
+    int hour = params.hour;
+    int minute = params.minute;
     
     // Find free slot
     int slot = -1;
@@ -226,7 +209,6 @@ static int alarm_create_execute(const char* args_json, char** result, char** err
     
     if (slot == -1) {
         *error = strdup("Maximum number of timers reached (10)");
-        free(label);
         return ETHERVOX_ERROR_INVALID_ARGUMENT;
     }
     
@@ -252,10 +234,8 @@ static int alarm_create_execute(const char* args_json, char** result, char** err
     timers[slot].is_active = true;
     timers[slot].is_alarm = true;
     
-    if (label) {
-        strncpy(timers[slot].label, label, sizeof(timers[slot].label) - 1);
-        timers[slot].label[sizeof(timers[slot].label) - 1] = '\0';
-        free(label);
+    if (params.label[0] != '\0') {
+        snprintf(timers[slot].label, sizeof(timers[slot].label), "%s", params.label);
     } else {
         snprintf(timers[slot].label, sizeof(timers[slot].label), 
                  "Alarm %02d:%02d", hour, minute);
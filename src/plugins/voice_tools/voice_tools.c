@@ -10,7 +10,6 @@
 #include "ethervox/voice_tools.h"
 
 #include <errno.h>
-#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,6 +23,7 @@
 #include <unistd.h>
 #endif
 
+#include "ethervox/audio_pipeline.h"
 #include "ethervox/file_tools.h"
 #include "ethervox/governor.h"
 #include "ethervox/logging.h"
@@ -110,146 +110,102 @@ static int download_whisper_model(const char* model_name, const char* dest_dir)
 static ethervox_voice_session_t* g_voice_session = NULL;
 
 /**
- * Background thread that captures audio and feeds to STT
+ * Audio pipeline sink that feeds STT
  *
- * This thread continuously feeds audio to Whisper's internal buffer and lets
- * Whisper's VAD decide when to segment and transcribe at natural speech pauses.
- * We only force processing when:
+ * Runs on its own thread, so a slow Whisper decode backs up the sink's queue
+ * instead of the capture device. Whisper's endpointer, fed the pipeline's
+ * VAD frames, decides when to segment and transcribe at natural speech
+ * pauses; we only force processing when:
  *   1. Buffer approaches capacity (~30s at 90% full)
  *   2. User calls /stoptranscribe (handled by stop_listen -> finalize)
  */
-static void* audio_capture_thread(void* arg) {
-  ethervox_voice_session_t* session = (ethervox_voice_session_t*)arg;
-
-  ethervox_audio_buffer_t audio_buf;
-  audio_buf.data = (float*)malloc(16000 * sizeof(float));  // 1 second buffer
-  audio_buf.size = 16000;
-  audio_buf.channels = 1;
-  audio_buf.timestamp_us = 0;
-  const uint32_t buffer_capacity = audio_buf.size;
-
-  if (!audio_buf.data) {
-    LOG_ERROR("Failed to allocate audio buffer");
-    return NULL;
+static void stt_sink(const ethervox_pipeline_block_t* block, void* user_data) {
+  ethervox_voice_session_t* session = (ethervox_voice_session_t*)user_data;
+  if (!session->is_recording || session->stop_requested) {
+    return;
   }
 
-  LOG_INFO("Audio capture thread started - feeding to Whisper VAD");
-
-  while (session->is_recording && !session->stop_requested) {
-    // Read audio from platform driver
-    // CRITICAL: Reset buffer size before each read to prevent buffer overflow
-    audio_buf.size = buffer_capacity;
-    ethervox_result_t read_result = ethervox_audio_read(&session->audio_runtime, &audio_buf);
-
-    if (ethervox_is_success(read_result) && audio_buf.size > 0) {
-      int samples_read = (int)audio_buf.size;
-      
-      // Clamp samples_read to buffer capacity to prevent overflow
-      if (samples_read > (int)buffer_capacity) {
-        LOG_WARN("Audio driver returned more samples (%d) than buffer capacity (%u) - clamping",
-                 samples_read, buffer_capacity);
-        samples_read = (int)buffer_capacity;
-      }
-      
-      // Set actual size for STT processing
-      audio_buf.size = (uint32_t)samples_read;
-
-      // Feed audio to STT - it will accumulate internally
-      // Whisper's VAD will decide when to segment and transcribe
-      ethervox_stt_result_t result;
-      ethervox_result_t stt_ret = ethervox_stt_process(&session->stt_runtime, &audio_buf, &result);
+  // Feed audio to STT - it will accumulate internally
+  // Whisper's endpointer reads the pipeline's VAD frames to decide when to segment and transcribe
+  ethervox_stt_result_t result;
+  ethervox_result_t stt_ret = ethervox_stt_process_frames(&session->stt_runtime, &block->audio,
+                                                          block->vad_frames, block->vad_frame_count,
+                                                          &result);
 
-      if (stt_ret == 1) {
-        // Normal: audio is accumulating in Whisper's buffer, VAD hasn't triggered yet
-        // This is the expected path most of the time
-        continue;
-      } else if (stt_ret < 0) {
-        LOG_WARN("STT processing error: %d", stt_ret);
-        continue;
-      }
+  if (stt_ret == 1) {
+    // Normal: audio is accumulating in Whisper's buffer, VAD hasn't triggered yet
+    // This is the expected path most of the time
+    return;
+  } else if (stt_ret < 0) {
+    LOG_WARN("STT processing error: %d", stt_ret);
+    return;
+  }
 
-      // stt_ret == 0: Whisper's VAD detected a natural speech boundary and transcribed
-      if (ethervox_is_success(stt_ret) && result.text && strlen(result.text) > 0) {
-        LOG_INFO("📥 Whisper VAD segment complete: %zu chars", strlen(result.text));
+  // stt_ret == 0: Whisper's VAD detected a natural speech boundary and transcribed
+  if (ethervox_is_success(stt_ret) && result.text && strlen(result.text) > 0) {
+    LOG_INFO("📥 Whisper VAD segment complete: %zu chars", strlen(result.text));
 
-        // Track max speaker ID for later naming
-        // Text contains [Speaker N] markers - extract highest N
-        const char* speaker_marker = strstr(result.text, "[Speaker ");
-        while (speaker_marker) {
-          int speaker_id = -1;
-          if (sscanf(speaker_marker, "[Speaker %d]", &speaker_id) == 1) {
-            if (speaker_id > session->max_speaker_id) {
-              session->max_speaker_id = speaker_id;
-            }
-          }
-          speaker_marker = strstr(speaker_marker + 1, "[Speaker ");
-        }
-
-        // Format segment with timestamp and language info
-        char formatted_segment[8192];
-        
-        // Get current date/time
-        time_t now = time(NULL);
-        struct tm* tm_info = localtime(&now);
-        char datetime_str[64];
-        strftime(datetime_str, sizeof(datetime_str), "%Y-%m-%d %H:%M:%S", tm_info);
-        
-        // Add date/time timestamp and language to the transcript
-        snprintf(formatted_segment, sizeof(formatted_segment), 
-                 "[%s] (%s) %s",
-                 datetime_str, result.language, result.text);
-
-        // Append to transcript buffer (in-memory)
-        size_t needed = session->transcript_len + strlen(formatted_segment) + 2;
-        if (needed > session->transcript_capacity) {
-          session->transcript_capacity = needed * 2;
-          session->full_transcript =
-              (char*)realloc(session->full_transcript, session->transcript_capacity);
+    // Track max speaker ID for later naming
+    // Text contains [Speaker N] markers - extract highest N
+    const char* speaker_marker = strstr(result.text, "[Speaker ");
+    while (speaker_marker) {
+      int speaker_id = -1;
+      if (sscanf(speaker_marker, "[Speaker %d]", &speaker_id) == 1) {
+        if (speaker_id > session->max_speaker_id) {
+          session->max_speaker_id = speaker_id;
         }
+      }
+      speaker_marker = strstr(speaker_marker + 1, "[Speaker ");
+    }
 
-        if (session->transcript_len > 0) {
-          strcat(session->full_transcript, "\n");
-          session->transcript_len++;
-        }
-        strcat(session->full_transcript, formatted_segment);
-        session->transcript_len += strlen(formatted_segment);
-        session->segment_count++;
-
-        LOG_INFO("Segment %u: %s", session->segment_count, formatted_segment);
-
-        // LIVE UPDATE: Append to file immediately for LLM monitoring
-        if (session->last_transcript_file[0] != '\0') {
-          FILE* f = fopen(session->last_transcript_file, "a");
-          if (f) {
-            fprintf(f, "%s\n", formatted_segment);
-            fflush(f);  // Ensure data is written immediately
-            fclose(f);
-            LOG_DEBUG("Updated live transcript file: %s", session->last_transcript_file);
-          } else {
-            LOG_WARN("Failed to open transcript file for writing: %s",
-                     session->last_transcript_file);
-          }
-        }
+    // Format segment with timestamp and language info
+    char formatted_segment[8192];
+    
+    // Get current date/time
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char datetime_str[64];
+    strftime(datetime_str, sizeof(datetime_str), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    // Add date/time timestamp and language to the transcript
+    snprintf(formatted_segment, sizeof(formatted_segment), 
+             "[%s] (%s) %s",
+             datetime_str, result.language, result.text);
+
+    // Append to transcript buffer (in-memory)
+    size_t needed = session->transcript_len + strlen(formatted_segment) + 2;
+    if (needed > session->transcript_capacity) {
+      session->transcript_capacity = needed * 2;
+      session->full_transcript =
+          (char*)realloc(session->full_transcript, session->transcript_capacity);
+    }
 
-        ethervox_stt_result_free(&result);
+    if (session->transcript_len > 0) {
+      strcat(session->full_transcript, "\n");
+      session->transcript_len++;
+    }
+    strcat(session->full_transcript, formatted_segment);
+    session->transcript_len += strlen(formatted_segment);
+    session->segment_count++;
+
+    LOG_INFO("Segment %u: %s", session->segment_count, formatted_segment);
+
+    // LIVE UPDATE: Append to file immediately for LLM monitoring
+    if (session->last_transcript_file[0] != '\0') {
+      FILE* f = fopen(session->last_transcript_file, "a");
+      if (f) {
+        fprintf(f, "%s\n", formatted_segment);
+        fflush(f);  // Ensure data is written immediately
+        fclose(f);
+        LOG_DEBUG("Updated live transcript file: %s", session->last_transcript_file);
+      } else {
+        LOG_WARN("Failed to open transcript file for writing: %s",
+                 session->last_transcript_file);
       }
-      // Note: buffer size is reset at the top of the loop before next read
-    } else if (ethervox_is_success(read_result) && audio_buf.size == 0) {
-      // No audio available yet, sleep briefly
-#ifdef _WIN32
-      Sleep(50);  // 50ms
-#else
-      usleep(50000);  // 50ms
-#endif
-    } else {
-      LOG_ERROR("Audio read error: result=%d", read_result);
-      break;
     }
-  }
 
-  free(audio_buf.data);
-  LOG_INFO("Audio capture thread stopped");
-  return NULL;
+    ethervox_stt_result_free(&result);
+  }
 }
 
 /**
@@ -712,8 +668,18 @@ ethervox_result_t ethervox_voice_tools_start_listen(ethervox_voice_session_t* se
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
 
-  if (ethervox_audio_start_capture(&session->audio_runtime) != 0) {
-    LOG_ERROR("Failed to start audio capture");
+  // Capture -> noise suppression -> VAD -> STT sink; Whisper endpoints on the VAD's frames
+  ethervox_pipeline_config_t pipeline_config = ethervox_pipeline_default_config(&session->audio_runtime);
+  pipeline_config.noise_suppression = session->audio_runtime.config.enable_noise_suppression;
+  ethervox_pipeline_sink_config_t sink = {.name = "stt",
+                                          .process = stt_sink,
+                                          .user_data = session,
+                                          .block_ms = 100,
+                                          .thread = {.own_thread = true, .cpu = -1, .rt_priority = 0}};
+  ethervox_pipeline_t* pipeline = NULL;
+  if (ethervox_is_error(ethervox_pipeline_add_sink(&pipeline_config, &sink)) ||
+      ethervox_is_error(ethervox_pipeline_create(&pipeline_config, &pipeline))) {
+    LOG_ERROR("Failed to create audio pipeline");
     ethervox_stt_stop(&session->stt_runtime);
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
@@ -780,15 +746,13 @@ ethervox_result_t ethervox_voice_tools_start_listen(ethervox_voice_session_t* se
     session->last_transcript_file[0] = '\0';  // Clear the path since file creation failed
   }
 
-  // Start background capture thread
-  pthread_t* thread = (pthread_t*)malloc(sizeof(pthread_t));
-  if (thread && pthread_create(thread, NULL, audio_capture_thread, session) == 0) {
-    session->capture_thread = thread;
-    LOG_INFO("Voice recording session started with background thread");
+  // Start capture and the STT sink thread
+  if (ethervox_is_success(ethervox_pipeline_start(pipeline))) {
+    session->capture_pipeline = pipeline;
+    LOG_INFO("Voice recording session started with audio pipeline");
   } else {
-    LOG_ERROR("Failed to create capture thread");
-    free(thread);
-    ethervox_audio_stop_capture(&session->audio_runtime);
+    LOG_ERROR("Failed to start audio pipeline");
+    ethervox_pipeline_destroy(pipeline);
     ethervox_stt_stop(&session->stt_runtime);
     session->is_recording = false;
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
@@ -808,30 +772,26 @@ ethervox_result_t ethervox_voice_tools_stop_listen(ethervox_voice_session_t* ses
   }
 
   bool was_recording = session->is_recording;
-  bool has_thread = (session->capture_thread != NULL);
+  bool has_pipeline = (session->capture_pipeline != NULL);
 
-  if (!was_recording && !has_thread) {
+  if (!was_recording && !has_pipeline) {
     LOG_WARN("Not currently recording");
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
 
-  // Signal thread to stop (even if flag already dropped)
-  session->stop_requested = true;
-  session->is_recording = false;
-
-  // Wait for capture thread to finish if it is still running
-  if (has_thread) {
-    pthread_t* thread = (pthread_t*)session->capture_thread;
-    pthread_join(*thread, NULL);
-    free(thread);
-    session->capture_thread = NULL;
-    LOG_INFO("Capture thread joined - all audio fed to STT");
+  // Stop capture and join the STT sink thread. The sink keeps accepting audio
+  // until then, so everything still queued behind a slow decode reaches STT.
+  if (has_pipeline) {
+    ethervox_pipeline_t* pipeline = (ethervox_pipeline_t*)session->capture_pipeline;
+    ethervox_pipeline_stop(pipeline);
+    ethervox_pipeline_destroy(pipeline);
+    session->capture_pipeline = NULL;
+    LOG_INFO("Audio pipeline stopped - all audio fed to STT");
   }
 
-  // Stop audio capture
-  if (session->audio_runtime.is_initialized) {
-    ethervox_audio_stop_capture(&session->audio_runtime);
-  }
+  // Nothing may feed STT past this point (even if flag already dropped)
+  session->stop_requested = true;
+  session->is_recording = false;
 
   // CRITICAL: Finalize STT to process any remaining buffered audio
   // This forces Whisper to transcribe whatever is left in the buffer,
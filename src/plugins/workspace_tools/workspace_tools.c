@@ -14,50 +14,43 @@
 
 #include "ethervox/governor.h"
 #include "ethervox/logging.h"
+#include "ethervox/tool_args.h"
 #include "workspace_operations.h"
 
 // Global workspace operations (set during registration)
 static workspace_operations_t* g_workspace_ops = NULL;
 
 /**
- * @brief Parse a JSON string parameter from args_json
- *
- * Simple JSON parser for extracting string values from {"key": "value"} format
+ * @brief Open args_json, reporting malformed input through *error
  */
-static int parse_json_string(const char* json, const char* key, char* out, size_t out_size) {
-  if (!json || !key || !out)
+static int open_args(ethervox_tool_args_t* args, const char* args_json, char** error) {
+  if (ethervox_tool_args_parse(args, args_json) != ETHERVOX_SUCCESS) {
+    *error = strdup("Malformed JSON arguments");
     return -1;
-
-  char search_key[256];
-  snprintf(search_key, sizeof(search_key), "\"%s\":", key);
-
-  const char* start = strstr(json, search_key);
-  if (!start) {
-    // Try with space after colon
-    snprintf(search_key, sizeof(search_key), "\"%s\": ", key);
-    start = strstr(json, search_key);
-    if (!start)
-      return -1;
   }
+  return 0;
+}
 
-  start += strlen(search_key);
-  while (*start == ' ' || *start == '\t')
-    start++;
-
-  if (*start != '\"')
-    return -1;
-  start++;
+/**
+ * @brief Copy a JSON array parameter as raw JSON text
+ *
+ * Accepts either a real array or a string containing one. Returns -1 if the
+ * key is absent or does not fit in out.
+ */
+static int get_array_json(const ethervox_tool_args_t* args, const char* key, char* out,
+                          size_t out_size) {
+  if (ethervox_tool_args_type(args, key) == ETHERVOX_JSON_STRING) {
+    return ethervox_tool_args_get_string(args, key, out, out_size) ? 0 : -1;
+  }
 
-  const char* end = strchr(start, '\"');
-  if (!end)
+  const char* raw = NULL;
+  size_t raw_len = 0;
+  if (ethervox_tool_args_type(args, key) != ETHERVOX_JSON_ARRAY ||
+      !ethervox_tool_args_get_raw(args, key, &raw, &raw_len) || raw_len >= out_size) {
     return -1;
-
-  size_t len = end - start;
-  if (len >= out_size)
-    len = out_size - 1;
-
-  memcpy(out, start, len);
-  out[len] = '\0';
+  }
+  memcpy(out, raw, raw_len);
+  out[raw_len] = '\0';
   return 0;
 }
 
@@ -74,12 +67,13 @@ static int tool_workspace_list_objects_wrapper(const char* args_json, char** res
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char type_filter[64] = "all";
 
-  // Try to parse type filter (optional parameter)
-  if (args_json && *args_json != '\0') {
-    parse_json_string(args_json, "type", type_filter, sizeof(type_filter));
-  }
+  // Parse type filter (optional parameter)
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  ethervox_tool_args_get_string(&args, "type", type_filter, sizeof(type_filter));
 
   ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
                "Listing workspace objects with filter: %s", type_filter);
@@ -97,9 +91,12 @@ static int tool_workspace_search_objects_wrapper(const char* args_json, char** r
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char query[1024];
 
-  if (parse_json_string(args_json, "query", query, sizeof(query)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "query", query, sizeof(query))) {
     *error = strdup("Missing required parameter: 'query'");
     return -1;
   }
@@ -119,9 +116,12 @@ static int tool_workspace_get_object_wrapper(const char* args_json, char** resul
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char object_id[64];
 
-  if (parse_json_string(args_json, "object_id", object_id, sizeof(object_id)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "object_id", object_id, sizeof(object_id))) {
     *error = strdup("Missing required parameter: 'object_id'");
     return -1;
   }
@@ -141,47 +141,27 @@ static int tool_workspace_create_note_wrapper(const char* args_json, char** resu
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char title[256];
-  char* content = NULL;
   char tags_json[512] = "[]";
 
   // Parse required parameters
-  if (parse_json_string(args_json, "title", title, sizeof(title)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "title", title, sizeof(title))) {
     *error = strdup("Missing required parameter: 'title'");
     return -1;
   }
 
-  // Parse content (can be large, so we need special handling)
-  const char* content_key = "\"content\":\"";
-  const char* content_start = strstr(args_json, content_key);
-  if (!content_start) {
-    content_key = "\"content\": \"";
-    content_start = strstr(args_json, content_key);
-  }
-
-  if (content_start) {
-    content_start += strlen(content_key);
-    const char* content_end = strstr(content_start, "\",");
-    if (!content_end)
-      content_end = strstr(content_start, "\"}");
-
-    if (content_end) {
-      size_t content_len = content_end - content_start;
-      content = (char*)malloc(content_len + 1);
-      if (content) {
-        memcpy(content, content_start, content_len);
-        content[content_len] = '\0';
-      }
-    }
-  }
-
+  // Content can be large, so it is the one value copied to the heap
+  char* content = ethervox_tool_args_dup_string(&args, "content");
   if (!content) {
     *error = strdup("Missing required parameter: 'content'");
     return -1;
   }
 
   // Parse optional tags array
-  parse_json_string(args_json, "tags", tags_json, sizeof(tags_json));
+  get_array_json(&args, "tags", tags_json, sizeof(tags_json));
 
   ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, "Creating note: %s", title);
 
@@ -200,23 +180,26 @@ static int tool_workspace_create_connection_wrapper(const char* args_json, char*
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char from_id[64];
   char to_id[64];
   char label[128] = "";
 
   // Parse required parameters
-  if (parse_json_string(args_json, "from_id", from_id, sizeof(from_id)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "from_id", from_id, sizeof(from_id))) {
     *error = strdup("Missing required parameter: 'from_id'");
     return -1;
   }
 
-  if (parse_json_string(args_json, "to_id", to_id, sizeof(to_id)) != 0) {
+  if (!ethervox_tool_args_get_string(&args, "to_id", to_id, sizeof(to_id))) {
     *error = strdup("Missing required parameter: 'to_id'");
     return -1;
   }
 
   // Parse optional label
-  parse_json_string(args_json, "label", label, sizeof(label));
+  ethervox_tool_args_get_string(&args, "label", label, sizeof(label));
 
   ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
                "Creating connection: %s -> %s", from_id, to_id);
@@ -235,47 +218,26 @@ static int tool_workspace_update_object_wrapper(const char* args_json, char** re
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char object_id[64];
-  char* content = NULL;
   char append[16] = "true";  // Default to append mode
 
   // Parse required parameters
-  if (parse_json_string(args_json, "object_id", object_id, sizeof(object_id)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "object_id", object_id, sizeof(object_id))) {
     *error = strdup("Missing required parameter: 'object_id'");
     return -1;
   }
 
-  // Parse content (can be large, so we need special handling)
-  const char* content_key = "\"content\":\"";
-  const char* content_start = strstr(args_json, content_key);
-  if (!content_start) {
-    content_key = "\"content\": \"";
-    content_start = strstr(args_json, content_key);
-  }
-
-  if (content_start) {
-    content_start += strlen(content_key);
-    const char* content_end = strstr(content_start, "\",");
-    if (!content_end)
-      content_end = strstr(content_start, "\"}");
-
-    if (content_end) {
-      size_t content_len = content_end - content_start;
-      content = (char*)malloc(content_len + 1);
-      if (content) {
-        memcpy(content, content_start, content_len);
-        content[content_len] = '\0';
-      }
-    }
-  }
-
+  char* content = ethervox_tool_args_dup_string(&args, "content");
   if (!content) {
     *error = strdup("Missing required parameter: 'content'");
     return -1;
   }
 
-  // Parse optional append mode
-  parse_json_string(args_json, "append", append, sizeof(append));
+  // Parse optional append mode (boolean or "true"/"false" string)
+  ethervox_tool_args_get_string(&args, "append", append, sizeof(append));
 
   ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
                "Updating object: %s (append=%s)", object_id, append);
@@ -295,10 +257,13 @@ static int tool_workspace_export_to_docx_wrapper(const char* args_json, char** r
     return -1;
   }
 
+  ethervox_tool_args_t args;
   char object_id[64];
 
   // Parse required object_id parameter
-  if (parse_json_string(args_json, "object_id", object_id, sizeof(object_id)) != 0) {
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_get_string(&args, "object_id", object_id, sizeof(object_id))) {
     *error = strdup("Missing required parameter: 'object_id'");
     return -1;
   }
@@ -319,42 +284,29 @@ static int tool_workspace_highlight_nodes_wrapper(const char* args_json, char**
     return -1;
   }
 
-  // Parse node_ids array from JSON
   // args_json should be: {"node_ids": ["id1", "id2", ...]}
-  
-  // Extract just the node_ids array JSON string
-  // For now, simple extraction - in production you'd use a JSON parser
-  const char* node_ids_start = strstr(args_json, "\"node_ids\"");
-  if (!node_ids_start) {
+  ethervox_tool_args_t args;
+  if (open_args(&args, args_json, error) != 0)
+    return -1;
+  if (!ethervox_tool_args_has(&args, "node_ids")) {
     *error = strdup("Missing required parameter: 'node_ids'");
     return -1;
   }
-  
-  // Find the array value
-  const char* array_start = strchr(node_ids_start, '[');
-  if (!array_start) {
+
+  // Pass the array through as JSON text (the list can be long, so copy to the heap)
+  const char* raw = NULL;
+  size_t raw_len = 0;
+  if (ethervox_tool_args_type(&args, "node_ids") != ETHERVOX_JSON_ARRAY ||
+      !ethervox_tool_args_get_raw(&args, "node_ids", &raw, &raw_len)) {
     *error = strdup("Invalid node_ids format (expected array)");
     return -1;
   }
-  
-  // Find the matching closing bracket
-  int bracket_count = 1;
-  const char* p = array_start + 1;
-  while (*p && bracket_count > 0) {
-    if (*p == '[') bracket_count++;
-    else if (*p == ']') bracket_count--;
-    p++;
-  }
-  
-  if (bracket_count != 0) {
-    *error = strdup("Malformed node_ids array");
+  char* node_ids_json = strndup(raw, raw_len);
+  if (!node_ids_json) {
+    *error = strdup("Out of memory");
     return -1;
   }
-  
-  // Extract the array substring
-  size_t array_len = p - array_start;
-  char* node_ids_json = strndup(array_start, array_len);
-  
+
   ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__,
                "Highlighting nodes: %s", node_ids_json);
 
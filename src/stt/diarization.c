@@ -0,0 +1,668 @@
+/**
+ * @file diarization.c
+ * @brief Speaker diarization: MFCC + YIN embeddings with online clustering
+ *
+ * Per 10 ms frame the worker computes 12 MFCCs (25 ms Hamming window, 24 mel
+ * bands) and a YIN F0 estimate. A segment embedding is the mean cepstrum of
+ * its speech frames plus the median log F0 of its voiced frames. Distances
+ * are measured in units of the session's frame-level cepstral spread, so a
+ * segment mean from the same speaker sits well inside one unit while a
+ * different vocal tract or pitch register lands outside it.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ethervox/diarization.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include "ethervox/logging.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DIARIZER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DIARIZER_NEON 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SAMPLE_RATE 16000
+#define FRAME_LEN 400  // 25 ms
+#define FRAME_HOP 160  // 10 ms
+#define FFT_SIZE 512
+#define FFT_BINS (FFT_SIZE / 2 + 1)
+#define MEL_BANDS 24
+#define MEL_LOW_HZ 100.0f
+#define MEL_HIGH_HZ 7600.0f
+#define MFCC_COUNT ETHERVOX_DIARIZER_MFCC_COUNT
+#define PRE_EMPHASIS 0.97f
+
+#define YIN_TAU_MIN (SAMPLE_RATE / ETHERVOX_SPEAKER_F0_MAX)
+#define YIN_TAU_MAX (SAMPLE_RATE / ETHERVOX_SPEAKER_F0_MIN)
+#define YIN_SPAN (ETHERVOX_SPEAKER_YIN_WINDOW + YIN_TAU_MAX)
+
+#define SPEECH_MIN_RMS 0.003f   // Absolute floor for a speech frame
+#define SPEECH_REL_RMS 0.1f     // Speech frames are within 20 dB of the segment peak
+#define MIN_VOICED_FRAMES 10    // Fewer voiced frames leave the pitch out
+#define PITCH_SCALE 0.15f       // log-F0 difference worth one distance unit (~16%)
+#define PITCH_WEIGHT 2.0f       // Pitch counts as this many cepstral dimensions
+
+typedef struct {
+  float mfcc[MFCC_COUNT];
+  float rms;
+  float f0;  // Hz, 0 = unvoiced
+} diarizer_frame_t;
+
+typedef struct {
+  bool active;
+  double mfcc_sum[MFCC_COUNT];  // Frame-weighted cepstrum sum
+  double weight;                // Speech frames pooled
+  double log_f0_sum;
+  double f0_weight;             // Segments that contributed a pitch
+} speaker_cluster_t;
+
+struct ethervox_diarizer {
+  uint32_t max_speakers;
+
+  // Analysis tables
+  float window[FRAME_LEN];
+  float mel[MEL_BANDS][FFT_BINS];
+  float dct[MFCC_COUNT][MEL_BANDS];
+  ethervox_fft_t* fft;
+
+  // Background feature extraction
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t job_ready;
+  pthread_cond_t job_done;
+  bool stopping;
+  bool job_pending;
+  float* audio;
+  uint32_t audio_count;
+  uint32_t audio_capacity;
+  diarizer_frame_t* frames;
+  uint32_t frame_count;
+  uint32_t frame_capacity;
+  float* scratch;  // Per-segment pitch values for the median
+
+  // Session state (caller thread)
+  speaker_cluster_t* clusters;
+  double stat_count;
+  double stat_mean[MFCC_COUNT];
+  double stat_m2[MFCC_COUNT];
+};
+
+// ============================================================================
+// Vector kernels
+// ============================================================================
+
+static float vec_dot(const float* a, const float* b, size_t n) {
+  size_t i = 0;
+  float sum = 0.0f;
+#if defined(DIARIZER_SSE2)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(DIARIZER_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  float lanes[4];
+  vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+  for (; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+/**
+ * Sum of squared differences, the YIN difference function for one lag
+ */
+static float vec_sq_diff(const float* a, const float* b, size_t n) {
+  size_t i = 0;
+  float sum = 0.0f;
+#if defined(DIARIZER_SSE2)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+    __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4));
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(d0, d0));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(d1, d1));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(DIARIZER_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+    float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    acc0 = vmlaq_f32(acc0, d0, d0);
+    acc1 = vmlaq_f32(acc1, d1, d1);
+  }
+  float lanes[4];
+  vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+  for (; i < n; i++) {
+    float d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+// ============================================================================
+// Frame analysis
+// ============================================================================
+
+static float hz_to_mel(float hz) {
+  return 2595.0f * log10f(1.0f + hz / 700.0f);
+}
+
+static float mel_to_hz(float mel) {
+  return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+static void init_tables(ethervox_diarizer_t* d) {
+  for (int i = 0; i < FRAME_LEN; i++) {
+    d->window[i] = 0.54f - 0.46f * cosf(2.0f * (float)M_PI * (float)i / (float)(FRAME_LEN - 1));
+  }
+
+  // Triangular mel filters over the power spectrum bins
+  float edges[MEL_BANDS + 2];
+  float mel_low = hz_to_mel(MEL_LOW_HZ);
+  float mel_high = hz_to_mel(MEL_HIGH_HZ);
+  for (int b = 0; b < MEL_BANDS + 2; b++) {
+    edges[b] = mel_to_hz(mel_low + (mel_high - mel_low) * (float)b / (float)(MEL_BANDS + 1));
+  }
+  for (int b = 0; b < MEL_BANDS; b++) {
+    for (int k = 0; k < FFT_BINS; k++) {
+      float hz = (float)k * SAMPLE_RATE / FFT_SIZE;
+      float w = 0.0f;
+      if (hz > edges[b] && hz <= edges[b + 1]) {
+        w = (hz - edges[b]) / (edges[b + 1] - edges[b]);
+      } else if (hz > edges[b + 1] && hz < edges[b + 2]) {
+        w = (edges[b + 2] - hz) / (edges[b + 2] - edges[b + 1]);
+      }
+      d->mel[b][k] = w;
+    }
+  }
+
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    for (int b = 0; b < MEL_BANDS; b++) {
+      d->dct[c][b] = cosf((float)M_PI * (float)(c + 1) * ((float)b + 0.5f) / (float)MEL_BANDS);
+    }
+  }
+}
+
+float ethervox_diarizer_yin_f0(const float* window) {
+  const int w = ETHERVOX_SPEAKER_YIN_WINDOW;
+  float diff[YIN_TAU_MAX + 1];
+  diff[0] = 1.0f;
+
+  // Cumulative mean normalized difference; take the first dip under the
+  // threshold, followed down to its local minimum
+  float running = 0.0f;
+  int best_tau = -1;
+  for (int tau = 1; tau <= YIN_TAU_MAX; tau++) {
+    float dt = vec_sq_diff(window, window + tau, (size_t)w);
+    running += dt;
+    diff[tau] = running > 0.0f ? dt * (float)tau / running : 1.0f;
+    if (best_tau < 0 && tau > YIN_TAU_MIN && diff[tau - 1] < ETHERVOX_SPEAKER_YIN_THRESHOLD &&
+        diff[tau] >= diff[tau - 1]) {
+      best_tau = tau - 1;
+      break;
+    }
+  }
+  if (best_tau < 0) {
+    return 0.0f;
+  }
+
+  // Parabolic interpolation around the dip
+  float tau = (float)best_tau;
+  if (best_tau > 1 && best_tau < YIN_TAU_MAX) {
+    float s0 = diff[best_tau - 1];
+    float s1 = diff[best_tau];
+    float s2 = diff[best_tau + 1];
+    float denom = s0 - 2.0f * s1 + s2;
+    if (fabsf(denom) > 1e-9f) {
+      tau += 0.5f * (s0 - s2) / denom;
+    }
+  }
+  return (float)SAMPLE_RATE / tau;
+}
+
+static void analyze_frame(const ethervox_diarizer_t* d, const float* samples, bool has_pitch_span,
+                          diarizer_frame_t* frame) {
+  float x[FFT_SIZE];
+  float re[FFT_BINS];
+  float im[FFT_BINS];
+  float energy = 0.0f;
+
+  for (int i = 0; i < FRAME_LEN; i++) {
+    x[i] = (samples[i] - (i > 0 ? PRE_EMPHASIS * samples[i - 1] : 0.0f)) * d->window[i];
+    energy += samples[i] * samples[i];
+  }
+  memset(x + FRAME_LEN, 0, (FFT_SIZE - FRAME_LEN) * sizeof(float));
+  frame->rms = sqrtf(energy / FRAME_LEN);
+  ethervox_fft_real_forward(d->fft, x, re, im);
+
+  float power[FFT_BINS];
+  for (int k = 0; k < FFT_BINS; k++) {
+    power[k] = re[k] * re[k] + im[k] * im[k];
+  }
+  float log_mel[MEL_BANDS];
+  for (int b = 0; b < MEL_BANDS; b++) {
+    log_mel[b] = logf(vec_dot(power, d->mel[b], FFT_BINS) + 1e-10f);
+  }
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    frame->mfcc[c] = vec_dot(log_mel, d->dct[c], MEL_BANDS);
+  }
+
+  frame->f0 = (has_pitch_span && frame->rms >= SPEECH_MIN_RMS) ? ethervox_diarizer_yin_f0(samples) : 0.0f;
+}
+
+static void* diarizer_thread(void* arg) {
+  ethervox_diarizer_t* d = (ethervox_diarizer_t*)arg;
+
+  pthread_mutex_lock(&d->lock);
+  for (;;) {
+    while (!d->job_pending && !d->stopping) {
+      pthread_cond_wait(&d->job_ready, &d->lock);
+    }
+    if (d->stopping) {
+      break;
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    // The submitter waits for job_pending to clear before touching the buffers
+    uint32_t count = d->audio_count;
+    uint32_t frames = count >= FRAME_LEN ? (count - FRAME_LEN) / FRAME_HOP + 1 : 0;
+    for (uint32_t i = 0; i < frames; i++) {
+      uint32_t pos = i * FRAME_HOP;
+      analyze_frame(d, d->audio + pos, pos + YIN_SPAN <= count, &d->frames[i]);
+    }
+
+    pthread_mutex_lock(&d->lock);
+    d->frame_count = frames;
+    d->job_pending = false;
+    pthread_cond_broadcast(&d->job_done);
+  }
+  pthread_mutex_unlock(&d->lock);
+  return NULL;
+}
+
+static void wait_for_job(ethervox_diarizer_t* d) {
+  pthread_mutex_lock(&d->lock);
+  while (d->job_pending) {
+    pthread_cond_wait(&d->job_done, &d->lock);
+  }
+  pthread_mutex_unlock(&d->lock);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+ethervox_diarizer_t* ethervox_diarizer_create(uint32_t max_speakers) {
+  if (max_speakers == 0) {
+    return NULL;
+  }
+  ethervox_diarizer_t* d = (ethervox_diarizer_t*)calloc(1, sizeof(ethervox_diarizer_t));
+  if (!d) {
+    return NULL;
+  }
+  d->clusters = (speaker_cluster_t*)calloc(max_speakers, sizeof(speaker_cluster_t));
+  if (!d->clusters) {
+    free(d);
+    return NULL;
+  }
+  d->max_speakers = max_speakers;
+  d->fft = ethervox_fft_create(FFT_SIZE);
+  if (!d->fft) {
+    free(d->clusters);
+    free(d);
+    return NULL;
+  }
+  init_tables(d);
+
+  pthread_mutex_init(&d->lock, NULL);
+  pthread_cond_init(&d->job_ready, NULL);
+  pthread_cond_init(&d->job_done, NULL);
+  if (pthread_create(&d->thread, NULL, diarizer_thread, d) != 0) {
+    ETHERVOX_LOG_ERROR("Failed to start diarization thread");
+    pthread_cond_destroy(&d->job_done);
+    pthread_cond_destroy(&d->job_ready);
+    pthread_mutex_destroy(&d->lock);
+    ethervox_fft_destroy(d->fft);
+    free(d->clusters);
+    free(d);
+    return NULL;
+  }
+  return d;
+}
+
+void ethervox_diarizer_destroy(ethervox_diarizer_t* d) {
+  if (!d) {
+    return;
+  }
+  pthread_mutex_lock(&d->lock);
+  d->stopping = true;
+  pthread_cond_broadcast(&d->job_ready);
+  pthread_mutex_unlock(&d->lock);
+  pthread_join(d->thread, NULL);
+
+  pthread_cond_destroy(&d->job_done);
+  pthread_cond_destroy(&d->job_ready);
+  pthread_mutex_destroy(&d->lock);
+  free(d->audio);
+  free(d->frames);
+  free(d->scratch);
+  free(d->clusters);
+  ethervox_fft_destroy(d->fft);
+  free(d);
+}
+
+void ethervox_diarizer_reset(ethervox_diarizer_t* d) {
+  if (!d) {
+    return;
+  }
+  wait_for_job(d);
+  memset(d->clusters, 0, d->max_speakers * sizeof(speaker_cluster_t));
+  d->stat_count = 0.0;
+  memset(d->stat_mean, 0, sizeof(d->stat_mean));
+  memset(d->stat_m2, 0, sizeof(d->stat_m2));
+  d->frame_count = 0;
+}
+
+ethervox_result_t ethervox_diarizer_submit(ethervox_diarizer_t* d, const float* samples,
+                                           uint32_t sample_count) {
+  ETHERVOX_CHECK_PTR(d);
+  ETHERVOX_CHECK_PTR(samples);
+
+  wait_for_job(d);
+
+  if (sample_count > d->audio_capacity) {
+    float* audio = (float*)realloc(d->audio, sample_count * sizeof(float));
+    if (!audio) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    d->audio = audio;
+    d->audio_capacity = sample_count;
+  }
+  uint32_t frames = sample_count >= FRAME_LEN ? (sample_count - FRAME_LEN) / FRAME_HOP + 1 : 0;
+  if (frames > d->frame_capacity) {
+    diarizer_frame_t* grown = (diarizer_frame_t*)realloc(d->frames, frames * sizeof(diarizer_frame_t));
+    if (!grown) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    d->frames = grown;
+    float* scratch = (float*)realloc(d->scratch, frames * sizeof(float));
+    if (!scratch) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    d->scratch = scratch;
+    d->frame_capacity = frames;
+  }
+  memcpy(d->audio, samples, sample_count * sizeof(float));
+
+  pthread_mutex_lock(&d->lock);
+  d->audio_count = sample_count;
+  d->frame_count = 0;
+  d->job_pending = true;
+  pthread_cond_signal(&d->job_ready);
+  pthread_mutex_unlock(&d->lock);
+  return ETHERVOX_SUCCESS;
+}
+
+static int compare_float(const void* a, const void* b) {
+  float fa = *(const float*)a;
+  float fb = *(const float*)b;
+  return (fa > fb) - (fa < fb);
+}
+
+/**
+ * Frames whose centre lies in [start, end)
+ */
+static void frame_range(const ethervox_diarizer_t* d, uint32_t start, uint32_t end, uint32_t* first,
+                        uint32_t* last) {
+  uint32_t half = FRAME_LEN / 2;
+  *first = start > half ? (start - half + FRAME_HOP - 1) / FRAME_HOP : 0;
+  *last = end > half ? (end - half + FRAME_HOP - 1) / FRAME_HOP : 0;
+  if (*last > d->frame_count) *last = d->frame_count;
+  if (*first > *last) *first = *last;
+}
+
+static float speech_gate(const ethervox_diarizer_t* d, uint32_t first, uint32_t last) {
+  float peak = 0.0f;
+  for (uint32_t i = first; i < last; i++) {
+    if (d->frames[i].rms > peak) peak = d->frames[i].rms;
+  }
+  float gate = peak * SPEECH_REL_RMS;
+  return gate > SPEECH_MIN_RMS ? gate : SPEECH_MIN_RMS;
+}
+
+ethervox_result_t ethervox_diarizer_embed(ethervox_diarizer_t* d, uint32_t start, uint32_t end,
+                                          ethervox_speaker_embedding_t* embedding) {
+  ETHERVOX_CHECK_PTR(d);
+  ETHERVOX_CHECK_PTR(embedding);
+  memset(embedding, 0, sizeof(*embedding));
+
+  wait_for_job(d);
+
+  uint32_t first = 0;
+  uint32_t last = 0;
+  frame_range(d, start, end, &first, &last);
+  float gate = speech_gate(d, first, last);
+
+  double sum[MFCC_COUNT] = {0};
+  for (uint32_t i = first; i < last; i++) {
+    const diarizer_frame_t* frame = &d->frames[i];
+    if (frame->rms < gate) continue;
+    for (int c = 0; c < MFCC_COUNT; c++) {
+      sum[c] += frame->mfcc[c];
+    }
+    embedding->speech_frames++;
+    if (frame->f0 > 0.0f) {
+      d->scratch[embedding->voiced_frames++] = logf(frame->f0);
+    }
+  }
+
+  if (embedding->speech_frames * FRAME_HOP * 1000u < ETHERVOX_SPEAKER_MIN_SPEECH_MS * (uint32_t)SAMPLE_RATE) {
+    return ETHERVOX_ERROR_NOT_FOUND;
+  }
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    embedding->mfcc[c] = (float)(sum[c] / embedding->speech_frames);
+  }
+  if (embedding->voiced_frames >= MIN_VOICED_FRAMES) {
+    qsort(d->scratch, embedding->voiced_frames, sizeof(float), compare_float);
+    embedding->log_f0 = d->scratch[embedding->voiced_frames / 2];
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+float ethervox_diarizer_distance(const ethervox_diarizer_t* d, const ethervox_speaker_embedding_t* a,
+                                 const ethervox_speaker_embedding_t* b) {
+  if (!d || !a || !b) {
+    return INFINITY;
+  }
+  float sum = 0.0f;
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    float scale = 1.0f;
+    if (d->stat_count > 1.0) {
+      scale = (float)sqrt(d->stat_m2[c] / (d->stat_count - 1.0));
+      if (scale < 1e-3f) scale = 1e-3f;
+    }
+    float diff = (a->mfcc[c] - b->mfcc[c]) / scale;
+    sum += diff * diff;
+  }
+  float dims = (float)MFCC_COUNT;
+  if (a->log_f0 != 0.0f && b->log_f0 != 0.0f) {
+    float diff = (a->log_f0 - b->log_f0) / PITCH_SCALE;
+    sum += PITCH_WEIGHT * diff * diff;
+    dims += PITCH_WEIGHT;
+  }
+  return sqrtf(sum / dims);
+}
+
+static void cluster_centroid(const speaker_cluster_t* cluster, ethervox_speaker_embedding_t* out) {
+  memset(out, 0, sizeof(*out));
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    out->mfcc[c] = (float)(cluster->mfcc_sum[c] / cluster->weight);
+  }
+  if (cluster->f0_weight > 0.0) {
+    out->log_f0 = (float)(cluster->log_f0_sum / cluster->f0_weight);
+  }
+}
+
+static void cluster_add(speaker_cluster_t* cluster, const ethervox_speaker_embedding_t* e) {
+  cluster->active = true;
+  for (int c = 0; c < MFCC_COUNT; c++) {
+    cluster->mfcc_sum[c] += (double)e->mfcc[c] * e->speech_frames;
+  }
+  cluster->weight += e->speech_frames;
+  if (e->log_f0 != 0.0f) {
+    cluster->log_f0_sum += e->log_f0;
+    cluster->f0_weight += 1.0;
+  }
+}
+
+/**
+ * Fold the segment's speech frames into the session's cepstral spread
+ */
+static void update_feature_scale(ethervox_diarizer_t* d, uint32_t start, uint32_t end) {
+  uint32_t first = 0;
+  uint32_t last = 0;
+  frame_range(d, start, end, &first, &last);
+  float gate = speech_gate(d, first, last);
+  for (uint32_t i = first; i < last; i++) {
+    const diarizer_frame_t* frame = &d->frames[i];
+    if (frame->rms < gate) continue;
+    d->stat_count += 1.0;
+    for (int c = 0; c < MFCC_COUNT; c++) {
+      double delta = frame->mfcc[c] - d->stat_mean[c];
+      d->stat_mean[c] += delta / d->stat_count;
+      d->stat_m2[c] += delta * (frame->mfcc[c] - d->stat_mean[c]);
+    }
+  }
+}
+
+/**
+ * Known speaker an embedding belongs to, or -1 if it should start a new
+ * one in *free_slot
+ */
+static int match_speaker(const ethervox_diarizer_t* d, const ethervox_speaker_embedding_t* embedding,
+                         int* free_slot) {
+  int nearest = -1;
+  float nearest_distance = INFINITY;
+  *free_slot = -1;
+  for (uint32_t s = 0; s < d->max_speakers; s++) {
+    if (!d->clusters[s].active) {
+      if (*free_slot < 0) *free_slot = (int)s;
+      continue;
+    }
+    ethervox_speaker_embedding_t centroid;
+    cluster_centroid(&d->clusters[s], &centroid);
+    float distance = ethervox_diarizer_distance(d, embedding, &centroid);
+    if (distance < nearest_distance) {
+      nearest_distance = distance;
+      nearest = (int)s;
+    }
+  }
+  if (nearest < 0 || (nearest_distance > ETHERVOX_SPEAKER_NEW_THRESHOLD && *free_slot >= 0)) {
+    ETHERVOX_LOG_DEBUG("New speaker (nearest distance %.2f)", nearest_distance);
+    return -1;
+  }
+  return nearest;
+}
+
+int ethervox_diarizer_identify(ethervox_diarizer_t* d, uint32_t start, uint32_t end) {
+  ethervox_speaker_embedding_t embedding;
+  if (!d || ethervox_diarizer_embed(d, start, end, &embedding) != ETHERVOX_SUCCESS) {
+    return -1;
+  }
+  int free_slot;
+  int speaker = match_speaker(d, &embedding, &free_slot);
+  return speaker >= 0 ? speaker : ETHERVOX_DIARIZER_NEW_SPEAKER;
+}
+
+int ethervox_diarizer_assign(ethervox_diarizer_t* d, uint32_t start, uint32_t end) {
+  ethervox_speaker_embedding_t embedding;
+  if (!d || ethervox_diarizer_embed(d, start, end, &embedding) != ETHERVOX_SUCCESS) {
+    return -1;
+  }
+  update_feature_scale(d, start, end);
+
+  int free_slot;
+  int speaker = match_speaker(d, &embedding, &free_slot);
+  if (speaker < 0) {
+    speaker = free_slot;
+  }
+  cluster_add(&d->clusters[speaker], &embedding);
+
+  // Online agglomeration: merge speakers whose centroids have converged,
+  // keeping the lower (earlier) ID
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (uint32_t a = 0; a < d->max_speakers && !merged; a++) {
+      if (!d->clusters[a].active) continue;
+      ethervox_speaker_embedding_t ca;
+      cluster_centroid(&d->clusters[a], &ca);
+      for (uint32_t b = a + 1; b < d->max_speakers && !merged; b++) {
+        if (!d->clusters[b].active) continue;
+        ethervox_speaker_embedding_t cb;
+        cluster_centroid(&d->clusters[b], &cb);
+        if (ethervox_diarizer_distance(d, &ca, &cb) >= ETHERVOX_SPEAKER_MERGE_THRESHOLD) continue;
+
+        speaker_cluster_t* keep = &d->clusters[a];
+        speaker_cluster_t* drop = &d->clusters[b];
+        for (int c = 0; c < MFCC_COUNT; c++) {
+          keep->mfcc_sum[c] += drop->mfcc_sum[c];
+        }
+        keep->weight += drop->weight;
+        keep->log_f0_sum += drop->log_f0_sum;
+        keep->f0_weight += drop->f0_weight;
+        memset(drop, 0, sizeof(*drop));
+        if (speaker == (int)b) speaker = (int)a;
+        ETHERVOX_LOG_DEBUG("Merged speaker %u into %u", b, a);
+        merged = true;
+      }
+    }
+  }
+  return speaker;
+}
+
+uint32_t ethervox_diarizer_speaker_count(const ethervox_diarizer_t* d) {
+  if (!d) {
+    return 0;
+  }
+  uint32_t count = 0;
+  for (uint32_t s = 0; s < d->max_speakers; s++) {
+    if (d->clusters[s].active) count++;
+  }
+  return count;
+}
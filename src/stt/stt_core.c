@@ -2,6 +2,14 @@
  * @file stt_core.c
  * @brief Core Speech-to-Text implementation
  *
+ * With config.rescore_model_path set, STT runs as a two-tier cascade: the
+ * configured backend (Vosk or a small Whisper) streams partials and decides
+ * where utterances end, while a larger Whisper model re-decodes each final
+ * utterance on a background thread and replaces the text if it differs.
+ * The rescoring thread keeps one offline decoder (one whisper_state) for
+ * the life of the runtime; input at other rates is resampled to 16 kHz as it
+ * enters the utterance window.
+ *
  * Copyright (c) 2024-2025 EthervoxAI Team
  * Licensed under CC BY-NC-SA 4.0
  */
@@ -9,10 +17,382 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "ethervox/stt.h"
+#include "ethervox/stt_offline.h"
+#include "ethervox/dsp.h"
 #include "ethervox/error.h"
 #include "ethervox/logging.h"
+#include "ethervox/config.h"
+
+#define CASCADE_SAMPLE_RATE 16000
+#define CASCADE_RESAMPLE_BLOCK 1024
+
+// ===========================================================================
+// Two-tier cascade
+// ===========================================================================
+
+typedef struct stt_rescore_job {
+  struct stt_rescore_job* next;
+  float* samples;    // Utterance window (owned)
+  uint32_t sample_count;
+  char* first_pass;  // First-pass final text (owned)
+  char* rescored;    // Second-pass text if it differs (owned), NULL otherwise
+  bool done;
+  bool waited_on;    // A caller is blocked on this job and will free it
+} stt_rescore_job_t;
+
+typedef struct {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t job_ready;
+  pthread_cond_t job_done;
+  bool thread_started;
+  bool stopping;
+  stt_rescore_job_t* queue_head;
+  stt_rescore_job_t* queue_tail;
+
+  ethervox_stt_offline_decoder_t* decoder;  // Used by the rescoring thread only
+  char language[16];                        // Pending language switch
+  bool language_changed;
+
+  ethervox_stt_rescore_callback_t callback;
+  void* callback_user_data;
+
+  // Audio since the last final result (mono, 16 kHz)
+  float* window;
+  uint32_t window_count;
+  uint32_t window_capacity;
+
+  // Input rate conversion, NULL when the runtime already runs at 16 kHz
+  ethervox_resampler_t* resampler;
+  float* resample_in;
+  float* resample_out;
+
+  uint32_t rescored_count;
+  uint32_t replaced_count;
+} stt_cascade_t;
+
+/**
+ * Compare transcripts ignoring case, punctuation and spacing
+ */
+static bool transcripts_match(const char* a, const char* b) {
+  for (;;) {
+    while (*a && !((*a >= 'a' && *a <= 'z') || (*a >= 'A' && *a <= 'Z') || (*a >= '0' && *a <= '9') ||
+                   (unsigned char)*a >= 0x80)) {
+      a++;
+    }
+    while (*b && !((*b >= 'a' && *b <= 'z') || (*b >= 'A' && *b <= 'Z') || (*b >= '0' && *b <= '9') ||
+                   (unsigned char)*b >= 0x80)) {
+      b++;
+    }
+    if (!*a || !*b) {
+      return !*a && !*b;
+    }
+    char ca = (*a >= 'A' && *a <= 'Z') ? (char)(*a - 'A' + 'a') : *a;
+    char cb = (*b >= 'A' && *b <= 'Z') ? (char)(*b - 'A' + 'a') : *b;
+    if (ca != cb) {
+      return false;
+    }
+    a++;
+    b++;
+  }
+}
+
+static void rescore_job_free(stt_rescore_job_t* job) {
+  free(job->samples);
+  free(job->first_pass);
+  free(job->rescored);
+  free(job);
+}
+
+static void* rescore_thread(void* arg) {
+  stt_cascade_t* cascade = (stt_cascade_t*)arg;
+
+  pthread_mutex_lock(&cascade->lock);
+  for (;;) {
+    while (!cascade->queue_head && !cascade->stopping) {
+      pthread_cond_wait(&cascade->job_ready, &cascade->lock);
+    }
+    if (cascade->stopping) {
+      break;
+    }
+    stt_rescore_job_t* job = cascade->queue_head;
+    cascade->queue_head = job->next;
+    if (!cascade->queue_head) {
+      cascade->queue_tail = NULL;
+    }
+    bool language_changed = cascade->language_changed;
+    char language[sizeof(cascade->language)];
+    memcpy(language, cascade->language, sizeof(language));
+    cascade->language_changed = false;
+    pthread_mutex_unlock(&cascade->lock);
+
+    if (language_changed) {
+      ethervox_stt_offline_decoder_set_language(cascade->decoder, language);
+    }
+
+    // Decode outside the lock so the first pass keeps streaming
+    ethervox_stt_offline_result_t offline_result;
+    char* rescored = NULL;
+    if (ethervox_is_success(ethervox_stt_offline_decode(cascade->decoder, job->samples, job->sample_count,
+                                                        &offline_result))) {
+      // No speech found by the second pass keeps the first-pass text
+      if (offline_result.text && offline_result.text[0] &&
+          !transcripts_match(offline_result.text, job->first_pass)) {
+        rescored = offline_result.text;
+        offline_result.text = NULL;
+      }
+      ethervox_stt_offline_result_free(&offline_result);
+    } else {
+      ETHERVOX_LOG_WARN("STT rescoring failed, keeping first-pass text");
+    }
+
+    pthread_mutex_lock(&cascade->lock);
+    job->rescored = rescored;
+    job->done = true;
+    cascade->rescored_count++;
+    if (rescored) {
+      cascade->replaced_count++;
+    }
+    if (job->waited_on) {
+      pthread_cond_broadcast(&cascade->job_done);
+      continue;
+    }
+
+    // Nobody is waiting any more: report the late replacement
+    ethervox_stt_rescore_callback_t callback = cascade->callback;
+    void* user_data = cascade->callback_user_data;
+    pthread_mutex_unlock(&cascade->lock);
+    if (rescored && callback) {
+      callback(job->first_pass, rescored, user_data);
+    }
+    rescore_job_free(job);
+    pthread_mutex_lock(&cascade->lock);
+  }
+  pthread_mutex_unlock(&cascade->lock);
+  return NULL;
+}
+
+static void cascade_destroy(stt_cascade_t* cascade) {
+  if (!cascade) {
+    return;
+  }
+
+  if (cascade->thread_started) {
+    pthread_mutex_lock(&cascade->lock);
+    cascade->stopping = true;
+    pthread_cond_broadcast(&cascade->job_ready);
+    pthread_mutex_unlock(&cascade->lock);
+    pthread_join(cascade->thread, NULL);
+    ETHERVOX_LOG_INFO("STT rescoring: %u utterances re-decoded, %u replaced", cascade->rescored_count,
+                      cascade->replaced_count);
+  }
+
+  // Utterances still queued are dropped
+  while (cascade->queue_head) {
+    stt_rescore_job_t* job = cascade->queue_head;
+    cascade->queue_head = job->next;
+    rescore_job_free(job);
+  }
+
+  pthread_cond_destroy(&cascade->job_done);
+  pthread_cond_destroy(&cascade->job_ready);
+  pthread_mutex_destroy(&cascade->lock);
+  ethervox_stt_offline_decoder_destroy(cascade->decoder);
+  ethervox_resampler_destroy(cascade->resampler);
+  free(cascade->resample_in);
+  free(cascade->resample_out);
+  free(cascade->window);
+  free(cascade);
+}
+
+static ethervox_result_t cascade_create(ethervox_stt_runtime_t* runtime) {
+  const ethervox_stt_config_t* config = &runtime->config;
+  stt_cascade_t* cascade = (stt_cascade_t*)calloc(1, sizeof(stt_cascade_t));
+  if (!cascade) {
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  pthread_mutex_init(&cascade->lock, NULL);
+  pthread_cond_init(&cascade->job_ready, NULL);
+  pthread_cond_init(&cascade->job_done, NULL);
+
+  // Whisper only takes 16 kHz; other input rates are converted on append
+  if (config->sample_rate != CASCADE_SAMPLE_RATE) {
+    cascade->resampler = ethervox_resampler_create(config->sample_rate, CASCADE_SAMPLE_RATE, CASCADE_RESAMPLE_BLOCK);
+    if (!cascade->resampler) {
+      ETHERVOX_LOG_ERROR("STT rescoring cannot convert %u Hz input to %u Hz", config->sample_rate,
+                         CASCADE_SAMPLE_RATE);
+      cascade_destroy(cascade);
+      return ETHERVOX_ERROR_AUDIO_FORMAT_UNSUPPORTED;
+    }
+    cascade->resample_in = (float*)malloc(CASCADE_RESAMPLE_BLOCK * sizeof(float));
+    cascade->resample_out =
+        (float*)malloc(ethervox_resampler_max_output(cascade->resampler, CASCADE_RESAMPLE_BLOCK) * sizeof(float));
+    if (!cascade->resample_in || !cascade->resample_out) {
+      cascade_destroy(cascade);
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  cascade->window_capacity = CASCADE_SAMPLE_RATE * ETHERVOX_STT_RESCORE_MAX_UTTERANCE_MS / 1000;
+  cascade->window = (float*)malloc(cascade->window_capacity * sizeof(float));
+  if (!cascade->window) {
+    cascade_destroy(cascade);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  ethervox_stt_offline_config_t offline = ethervox_stt_offline_get_default_config();
+  offline.model_path = config->rescore_model_path;
+  offline.language = config->language ? config->language : "auto";
+  offline.translate_to_english = config->translate_to_english;
+
+  // Load the rescoring model and its decoding state now rather than on the
+  // first utterance; the decoder holds a registry reference, so idle
+  // eviction never drops the model mid-session
+  ethervox_result_t result = ethervox_stt_offline_decoder_create(&offline, &cascade->decoder);
+  if (ethervox_is_error(result)) {
+    ETHERVOX_LOG_ERROR("Failed to load rescoring model: %s", config->rescore_model_path);
+    cascade_destroy(cascade);
+    return result;
+  }
+
+  if (pthread_create(&cascade->thread, NULL, rescore_thread, cascade) != 0) {
+    cascade_destroy(cascade);
+    return ETHERVOX_ERROR_STT_INIT;
+  }
+  cascade->thread_started = true;
+
+  runtime->cascade = cascade;
+  ETHERVOX_LOG_INFO("STT cascade: rescoring final utterances with %s (wait %d ms)", config->rescore_model_path,
+                    (int)config->rescore_wait_ms);
+  return ETHERVOX_SUCCESS;
+}
+
+/**
+ * Append 16 kHz samples to the utterance window, keeping the newest ones
+ */
+static void cascade_push(stt_cascade_t* cascade, const float* samples, uint32_t count, uint32_t stride) {
+  uint32_t skip = 0;
+  if (count > cascade->window_capacity) {
+    skip = count - cascade->window_capacity;
+    count = cascade->window_capacity;
+  }
+  if (cascade->window_count + count > cascade->window_capacity) {
+    uint32_t drop = cascade->window_count + count - cascade->window_capacity;
+    memmove(cascade->window, cascade->window + drop, (cascade->window_count - drop) * sizeof(float));
+    cascade->window_count -= drop;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    cascade->window[cascade->window_count++] = samples[(skip + i) * stride];
+  }
+}
+
+/**
+ * Append audio to the current utterance window
+ */
+static void cascade_append(stt_cascade_t* cascade, const ethervox_audio_buffer_t* audio_buffer) {
+  // First channel only; the streaming backends are fed mono
+  uint32_t channels = audio_buffer->channels > 0 ? audio_buffer->channels : 1;
+  uint32_t frames = audio_buffer->size / channels;
+  if (!cascade->resampler) {
+    cascade_push(cascade, audio_buffer->data, frames, channels);
+    return;
+  }
+
+  for (uint32_t done = 0; done < frames;) {
+    uint32_t block = frames - done < CASCADE_RESAMPLE_BLOCK ? frames - done : CASCADE_RESAMPLE_BLOCK;
+    for (uint32_t i = 0; i < block; i++) {
+      cascade->resample_in[i] = audio_buffer->data[(done + i) * channels];
+    }
+    size_t produced = ethervox_resampler_process(cascade->resampler, cascade->resample_in, block,
+                                                 cascade->resample_out);
+    cascade_push(cascade, cascade->resample_out, (uint32_t)produced, 1);
+    done += block;
+  }
+}
+
+/**
+ * Hand the finished utterance to the rescoring thread and, per the wait
+ * policy, swap in the rescored text
+ */
+static void cascade_rescore(ethervox_stt_runtime_t* runtime, ethervox_stt_result_t* result) {
+  stt_cascade_t* cascade = (stt_cascade_t*)runtime->cascade;
+  if (cascade->window_count == 0) {
+    return;
+  }
+
+  stt_rescore_job_t* job = (stt_rescore_job_t*)calloc(1, sizeof(stt_rescore_job_t));
+  if (job) {
+    job->samples = (float*)malloc(cascade->window_count * sizeof(float));
+    job->first_pass = strdup(result->text);
+  }
+  if (!job || !job->samples || !job->first_pass) {
+    ETHERVOX_LOG_WARN("Skipping STT rescoring: out of memory");
+    if (job) {
+      rescore_job_free(job);
+    }
+    cascade->window_count = 0;
+    return;
+  }
+  memcpy(job->samples, cascade->window, cascade->window_count * sizeof(float));
+  job->sample_count = cascade->window_count;
+  cascade->window_count = 0;
+
+  int32_t wait_ms = runtime->config.rescore_wait_ms;
+  pthread_mutex_lock(&cascade->lock);
+  job->waited_on = wait_ms != 0;
+  if (cascade->queue_tail) {
+    cascade->queue_tail->next = job;
+  } else {
+    cascade->queue_head = job;
+  }
+  cascade->queue_tail = job;
+  pthread_cond_signal(&cascade->job_ready);
+
+  if (!job->waited_on) {
+    pthread_mutex_unlock(&cascade->lock);
+    return;
+  }
+
+  struct timespec deadline;
+  if (wait_ms > 0) {
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += wait_ms / 1000;
+    deadline.tv_nsec += (long)(wait_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+  }
+  while (!job->done) {
+    if (wait_ms < 0) {
+      pthread_cond_wait(&cascade->job_done, &cascade->lock);
+    } else if (pthread_cond_timedwait(&cascade->job_done, &cascade->lock, &deadline) == ETIMEDOUT) {
+      break;
+    }
+  }
+
+  if (!job->done) {
+    // Too slow: return the first pass, the callback gets the rescored text
+    job->waited_on = false;
+    pthread_mutex_unlock(&cascade->lock);
+    ETHERVOX_LOG_DEBUG("STT rescoring still running after %d ms", (int)wait_ms);
+    return;
+  }
+  pthread_mutex_unlock(&cascade->lock);
+
+  if (job->rescored) {
+    ETHERVOX_LOG_DEBUG("STT rescored: \"%s\" -> \"%s\"", job->first_pass, job->rescored);
+    free(result->text);
+    result->text = job->rescored;
+    job->rescored = NULL;
+  }
+  rescore_job_free(job);
+}
 
 // Default configuration - use Whisper as default since it's implemented
 ethervox_stt_config_t ethervox_stt_get_default_config(void) {
@@ -23,7 +403,11 @@ ethervox_stt_config_t ethervox_stt_get_default_config(void) {
                                   .enable_partial_results = true,
                                   .enable_punctuation = true,
                                   .vad_threshold = 0.5f,
-                                  .translate_to_english = false};  // Transcribe in original language by default
+                                  .translate_to_english = false,  // Transcribe in original language by default
+                                  .grammar = NULL,
+                                  .threads = ETHERVOX_WHISPER_THREADS,
+                                  .rescore_model_path = NULL,
+                                  .rescore_wait_ms = ETHERVOX_STT_RESCORE_WAIT_MS};
   return config;
 }
 
@@ -42,6 +426,12 @@ ethervox_result_t ethervox_stt_init(ethervox_stt_runtime_t* runtime, const ether
     if (config->language) {
       runtime->config.language = strdup(config->language);
     }
+    if (config->grammar) {
+      runtime->config.grammar = strdup(config->grammar);
+    }
+    if (config->rescore_model_path) {
+      runtime->config.rescore_model_path = strdup(config->rescore_model_path);
+    }
   } else {
     runtime->config = ethervox_stt_get_default_config();
   }
@@ -77,6 +467,14 @@ ethervox_result_t ethervox_stt_init(ethervox_stt_runtime_t* runtime, const ether
       return ETHERVOX_ERROR_NOT_SUPPORTED;
   }
 
+  if (runtime->config.rescore_model_path) {
+    ethervox_result_t result = cascade_create(runtime);
+    if (ethervox_is_error(result)) {
+      ethervox_stt_cleanup(runtime);
+      return result;
+    }
+  }
+
   runtime->is_initialized = true;
   return ETHERVOX_SUCCESS;
 }
@@ -90,6 +488,13 @@ ethervox_result_t ethervox_stt_start(ethervox_stt_runtime_t* runtime) {
 
   runtime->is_processing = true;
   runtime->accumulator_write_pos = 0;
+  if (runtime->cascade) {
+    stt_cascade_t* cascade = (stt_cascade_t*)runtime->cascade;
+    cascade->window_count = 0;
+    if (cascade->resampler) {
+      ethervox_resampler_reset(cascade->resampler);
+    }
+  }
 
   // Delegate to backend-specific start
   switch (runtime->config.backend) {
@@ -105,10 +510,11 @@ ethervox_result_t ethervox_stt_start(ethervox_stt_runtime_t* runtime) {
   }
 }
 
-// Process audio
-ethervox_result_t ethervox_stt_process(ethervox_stt_runtime_t* runtime,
-                         const ethervox_audio_buffer_t* audio_buffer,
-                         ethervox_stt_result_t* result) {
+// Process audio; frames is NULL when the backend should run its own VAD
+static ethervox_result_t stt_process(ethervox_stt_runtime_t* runtime,
+                                     const ethervox_audio_buffer_t* audio_buffer,
+                                     const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                                     ethervox_stt_result_t* result) {
   ETHERVOX_CHECK_PTR(runtime);
   ETHERVOX_CHECK_PTR(audio_buffer);
   ETHERVOX_CHECK_PTR(result);
@@ -118,18 +524,53 @@ ethervox_result_t ethervox_stt_process(ethervox_stt_runtime_t* runtime,
 
   memset(result, 0, sizeof(ethervox_stt_result_t));
 
+  if (runtime->cascade) {
+    cascade_append((stt_cascade_t*)runtime->cascade, audio_buffer);
+  }
+
   // Delegate to backend-specific processing
+  ethervox_result_t ret;
   switch (runtime->config.backend) {
     case ETHERVOX_STT_BACKEND_WHISPER:
-      return ethervox_stt_whisper_process(runtime, audio_buffer, result);
+      ret = ethervox_stt_whisper_process(runtime, audio_buffer, frames, frame_count, result);
+      break;
     
     case ETHERVOX_STT_BACKEND_VOSK:
-      return ethervox_stt_vosk_process(runtime, audio_buffer, result);
+      ret = ethervox_stt_vosk_process(runtime, audio_buffer, result);
+      break;
     
     default:
       ETHERVOX_LOG_ERROR("Unknown STT backend: %d", runtime->config.backend);
       return ETHERVOX_ERROR_NOT_SUPPORTED;
   }
+
+  if (ret == ETHERVOX_SUCCESS && runtime->cascade && result->is_final && result->text && result->text[0]) {
+    cascade_rescore(runtime, result);
+  }
+
+  // Stream the hypothesis before the caller sees the result
+  if (ret == ETHERVOX_SUCCESS && runtime->partial_callback && result->text && result->text[0]) {
+    runtime->partial_callback(result->text, result->is_final, runtime->partial_user_data);
+  }
+  return ret;
+}
+
+ethervox_result_t ethervox_stt_process(ethervox_stt_runtime_t* runtime,
+                         const ethervox_audio_buffer_t* audio_buffer,
+                         ethervox_stt_result_t* result) {
+  return stt_process(runtime, audio_buffer, NULL, 0, result);
+}
+
+ethervox_result_t ethervox_stt_process_frames(ethervox_stt_runtime_t* runtime,
+                                              const ethervox_audio_buffer_t* audio_buffer,
+                                              const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                                              ethervox_stt_result_t* result) {
+  // A buffer that completed no frame still comes from the stream's VAD
+  static const ethervox_vad_frame_t kNoFrames[1];
+  if (frame_count > 0) {
+    ETHERVOX_CHECK_PTR(frames);
+  }
+  return stt_process(runtime, audio_buffer, frame_count > 0 ? frames : kNoFrames, frame_count, result);
 }
 
 // Finalize and get final result
@@ -140,17 +581,25 @@ ethervox_result_t ethervox_stt_finalize(ethervox_stt_runtime_t* runtime, ethervo
   memset(result, 0, sizeof(ethervox_stt_result_t));
 
   // Delegate to backend-specific finalize
+  ethervox_result_t ret;
   switch (runtime->config.backend) {
     case ETHERVOX_STT_BACKEND_WHISPER:
-      return ethervox_stt_whisper_finalize(runtime, result);
+      ret = ethervox_stt_whisper_finalize(runtime, result);
+      break;
     
     case ETHERVOX_STT_BACKEND_VOSK:
-      return ethervox_stt_vosk_finalize(runtime, result);
+      ret = ethervox_stt_vosk_finalize(runtime, result);
+      break;
     
     default:
       ETHERVOX_LOG_ERROR("Unknown STT backend: %d", runtime->config.backend);
       return ETHERVOX_ERROR_NOT_SUPPORTED;
   }
+
+  if (ret == ETHERVOX_SUCCESS && runtime->cascade && result->text && result->text[0]) {
+    cascade_rescore(runtime, result);
+  }
+  return ret;
 }
 
 // Stop STT session
@@ -201,6 +650,10 @@ void ethervox_stt_cleanup(ethervox_stt_runtime_t* runtime) {
     free(runtime->audio_accumulator);
   }
 
+  // Stop rescoring before the first-pass backend goes away
+  cascade_destroy((stt_cascade_t*)runtime->cascade);
+  runtime->cascade = NULL;
+
   // Delegate to backend-specific cleanup
   if (runtime->config.backend == ETHERVOX_STT_BACKEND_WHISPER) {
     ethervox_stt_whisper_cleanup(runtime);
@@ -220,6 +673,14 @@ void ethervox_stt_cleanup(ethervox_stt_runtime_t* runtime) {
     free((void*)runtime->config.language);
   }
 
+  if (runtime->config.grammar) {
+    free((void*)runtime->config.grammar);
+  }
+
+  if (runtime->config.rescore_model_path) {
+    free((void*)runtime->config.rescore_model_path);
+  }
+
   runtime->is_initialized = false;
   ETHERVOX_LOG_INFO("STT engine cleaned up");
 }
@@ -239,8 +700,22 @@ ethervox_result_t ethervox_stt_set_language(ethervox_stt_runtime_t* runtime, con
     return ETHERVOX_ERROR_INVALID_ARGUMENT;
   }
   
-  // Update config
-  runtime->config.language = language;
+  // Update config (the runtime owns its copy)
+  char* copy = strdup(language);
+  if (!copy) {
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  free((void*)runtime->config.language);
+  runtime->config.language = copy;
+
+  // The rescoring thread picks the switch up before its next utterance
+  if (runtime->cascade) {
+    stt_cascade_t* cascade = (stt_cascade_t*)runtime->cascade;
+    pthread_mutex_lock(&cascade->lock);
+    snprintf(cascade->language, sizeof(cascade->language), "%s", language);
+    cascade->language_changed = true;
+    pthread_mutex_unlock(&cascade->lock);
+  }
   
   // Delegate to backend-specific language switching
   switch (runtime->config.backend) {
@@ -259,3 +734,64 @@ ethervox_result_t ethervox_stt_set_language(ethervox_stt_runtime_t* runtime, con
       return ETHERVOX_ERROR_NOT_SUPPORTED;
   }
 }
+
+/**
+ * Stream hypotheses to a callback
+ */
+void ethervox_stt_set_partial_callback(ethervox_stt_runtime_t* runtime,
+                                       ethervox_stt_partial_callback_t callback, void* user_data) {
+  if (!runtime) {
+    return;
+  }
+  runtime->partial_callback = callback;
+  runtime->partial_user_data = user_data;
+}
+
+/**
+ * Receive late rescored text
+ */
+void ethervox_stt_set_rescore_callback(ethervox_stt_runtime_t* runtime,
+                                       ethervox_stt_rescore_callback_t callback, void* user_data) {
+  if (!runtime || !runtime->cascade) {
+    return;
+  }
+  stt_cascade_t* cascade = (stt_cascade_t*)runtime->cascade;
+  pthread_mutex_lock(&cascade->lock);
+  cascade->callback = callback;
+  cascade->callback_user_data = user_data;
+  pthread_mutex_unlock(&cascade->lock);
+}
+
+/**
+ * Set command grammar (hot-switch without re-init)
+ */
+ethervox_result_t ethervox_stt_set_grammar(ethervox_stt_runtime_t* runtime, const char* grammar) {
+  ETHERVOX_CHECK_PTR(runtime);
+  if (!runtime->is_initialized) {
+    ETHERVOX_LOG_ERROR("STT runtime not initialized");
+    return ETHERVOX_ERROR_NOT_INITIALIZED;
+  }
+
+  if (runtime->config.backend != ETHERVOX_STT_BACKEND_VOSK) {
+    ETHERVOX_LOG_ERROR("Grammar mode is only supported by the Vosk backend");
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+  }
+
+  char* copy = NULL;
+  if (grammar) {
+    copy = strdup(grammar);
+    if (!copy) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  ethervox_result_t result = ethervox_stt_vosk_set_grammar(runtime, copy);
+  if (ethervox_is_error(result)) {
+    free(copy);
+    return result;
+  }
+
+  free((void*)runtime->config.grammar);
+  runtime->config.grammar = copy;
+  return ETHERVOX_SUCCESS;
+}
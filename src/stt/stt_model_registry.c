@@ -0,0 +1,281 @@
+/**
+ * @file stt_model_registry.c
+ * @brief Process-wide registry of loaded STT models
+ *
+ * Whisper contexts and Vosk models are read-only once loaded, so every
+ * session over the same model shares one copy and keeps only its decoder
+ * state. Unreferenced models linger for ETHERVOX_STT_MODEL_IDLE_EVICT_MS so
+ * switching between dictation and conversation does not reload from disk.
+ * A sweeper thread runs while any model is idle, so an unused model is freed
+ * on time even if no session touches the registry again.
+ *
+ * Loads run outside the registry lock behind a placeholder entry: sessions
+ * asking for the same model wait for that load on g_loaded_cond, while
+ * unrelated acquires, releases and the sweeper carry on.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * Licensed under CC BY-NC-SA 4.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "ethervox/stt.h"
+#include "ethervox/error.h"
+#include "ethervox/logging.h"
+#include "ethervox/config.h"
+
+typedef struct stt_model_entry {
+  struct stt_model_entry* next;
+  char* path;  // Canonical model path
+  ethervox_stt_model_load_fn load;
+  ethervox_stt_model_free_fn free_model;
+  void* model;
+  uint32_t refs;           // Sessions holding the model, plus the loader and its waiters
+  bool loading;            // load() is running; model is not set yet
+  uint64_t idle_since_ms;  // When refs last dropped to zero
+} stt_model_entry_t;
+
+static pthread_mutex_t g_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_loaded_cond = PTHREAD_COND_INITIALIZER;
+static stt_model_entry_t* g_models = NULL;
+static bool g_sweeper_running = false;
+
+static uint64_t registry_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * Free unreferenced models idle for at least idle_ms (lock held)
+ */
+static uint32_t sweep_idle_locked(uint64_t now, uint32_t idle_ms) {
+  uint32_t freed = 0;
+  stt_model_entry_t** link = &g_models;
+  while (*link) {
+    stt_model_entry_t* entry = *link;
+    if (entry->refs == 0 && now - entry->idle_since_ms >= idle_ms) {
+      *link = entry->next;
+      ETHERVOX_LOG_INFO("Evicting idle STT model: %s", entry->path);
+      entry->free_model(entry->model);
+      free(entry->path);
+      free(entry);
+      freed++;
+    } else {
+      link = &entry->next;
+    }
+  }
+  return freed;
+}
+
+/**
+ * Sleep until the oldest idle model is due, evict, repeat; exits once no
+ * model is idle. Entries go idle in time order, so a model released while
+ * the sweeper sleeps is never due before the one it is waiting for.
+ */
+static void* sweeper_thread(void* arg) {
+  (void)arg;
+  pthread_mutex_lock(&g_registry_lock);
+  for (;;) {
+    uint64_t now = registry_now_ms();
+    sweep_idle_locked(now, ETHERVOX_STT_MODEL_IDLE_EVICT_MS);
+
+    uint64_t due = UINT64_MAX;
+    for (stt_model_entry_t* entry = g_models; entry; entry = entry->next) {
+      if (entry->refs == 0 && entry->idle_since_ms + ETHERVOX_STT_MODEL_IDLE_EVICT_MS < due) {
+        due = entry->idle_since_ms + ETHERVOX_STT_MODEL_IDLE_EVICT_MS;
+      }
+    }
+    if (due == UINT64_MAX) {
+      break;
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+
+    uint64_t wait_ms = due > now ? due - now : 0;
+    struct timespec ts = { (time_t)(wait_ms / 1000), (long)(wait_ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+    pthread_mutex_lock(&g_registry_lock);
+  }
+  g_sweeper_running = false;
+  pthread_mutex_unlock(&g_registry_lock);
+  return NULL;
+}
+
+/**
+ * Make sure an idle model will be swept (lock held)
+ */
+static void start_sweeper_locked(void) {
+  if (g_sweeper_running || ETHERVOX_STT_MODEL_IDLE_EVICT_MS == 0) {
+    return;
+  }
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, sweeper_thread, NULL) != 0) {
+    ETHERVOX_LOG_WARN("Cannot start STT model sweeper; idle models are freed on the next registry call");
+    return;
+  }
+  pthread_detach(thread);
+  g_sweeper_running = true;
+}
+
+ethervox_result_t ethervox_stt_model_acquire(const char* model_path, ethervox_stt_model_load_fn load,
+                                             ethervox_stt_model_free_fn free_model, void** model) {
+  ETHERVOX_CHECK_PTR(model_path);
+  ETHERVOX_CHECK_PTR(load);
+  ETHERVOX_CHECK_PTR(free_model);
+  ETHERVOX_CHECK_PTR(model);
+  *model = NULL;
+
+  // Different spellings of one path share an entry; a path that does not
+  // resolve is kept as given and left to the loader to reject
+  char* key = realpath(model_path, NULL);
+  if (!key) {
+    key = strdup(model_path);
+    if (!key) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  pthread_mutex_lock(&g_registry_lock);
+  sweep_idle_locked(registry_now_ms(), ETHERVOX_STT_MODEL_IDLE_EVICT_MS);
+
+  for (stt_model_entry_t* entry = g_models; entry; entry = entry->next) {
+    if (entry->load == load && strcmp(entry->path, key) == 0) {
+      // The reference keeps the entry alive while another session loads it
+      entry->refs++;
+      while (entry->loading) {
+        pthread_cond_wait(&g_loaded_cond, &g_registry_lock);
+      }
+      if (!entry->model) {
+        // That load failed; its entry is already unlinked
+        bool last = --entry->refs == 0;
+        pthread_mutex_unlock(&g_registry_lock);
+        if (last) {
+          free(entry->path);
+          free(entry);
+        }
+        free(key);
+        return ETHERVOX_ERROR_STT_INIT;
+      }
+      *model = entry->model;
+      ETHERVOX_LOG_INFO("Sharing loaded STT model: %s (%u sessions)", key, entry->refs);
+      pthread_mutex_unlock(&g_registry_lock);
+      free(key);
+      return ETHERVOX_SUCCESS;
+    }
+  }
+
+  // Publish a placeholder so concurrent sessions wait for this load instead
+  // of loading the same model twice, then load without the lock
+  stt_model_entry_t* entry = (stt_model_entry_t*)calloc(1, sizeof(stt_model_entry_t));
+  if (!entry) {
+    pthread_mutex_unlock(&g_registry_lock);
+    free(key);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  entry->path = key;
+  entry->load = load;
+  entry->free_model = free_model;
+  entry->refs = 1;
+  entry->loading = true;
+  entry->next = g_models;
+  g_models = entry;
+  pthread_mutex_unlock(&g_registry_lock);
+
+  void* loaded = load(key);
+
+  pthread_mutex_lock(&g_registry_lock);
+  entry->model = loaded;
+  entry->loading = false;
+  pthread_cond_broadcast(&g_loaded_cond);
+  if (!loaded) {
+    for (stt_model_entry_t** link = &g_models; *link; link = &(*link)->next) {
+      if (*link == entry) {
+        *link = entry->next;
+        break;
+      }
+    }
+    ETHERVOX_LOG_ERROR("Failed to load STT model: %s", key);
+    bool last = --entry->refs == 0;  // Waiters still hold the entry otherwise
+    pthread_mutex_unlock(&g_registry_lock);
+    if (last) {
+      free(entry->path);
+      free(entry);
+    }
+    return ETHERVOX_ERROR_STT_INIT;
+  }
+  *model = loaded;
+  pthread_mutex_unlock(&g_registry_lock);
+  return ETHERVOX_SUCCESS;
+}
+
+void ethervox_stt_model_release(void* model) {
+  if (!model) {
+    return;
+  }
+
+  pthread_mutex_lock(&g_registry_lock);
+  uint64_t now = registry_now_ms();
+  bool found = false;
+  for (stt_model_entry_t* entry = g_models; entry; entry = entry->next) {
+    if (entry->model == model && entry->refs > 0) {
+      found = true;
+      if (--entry->refs == 0) {
+        entry->idle_since_ms = now;
+        start_sweeper_locked();
+      }
+      break;
+    }
+  }
+  if (!found) {
+    ETHERVOX_LOG_WARN("Releasing STT model %p that is not held", model);
+  }
+  sweep_idle_locked(now, ETHERVOX_STT_MODEL_IDLE_EVICT_MS);
+  pthread_mutex_unlock(&g_registry_lock);
+}
+
+uint32_t ethervox_stt_model_trim(uint32_t idle_ms) {
+  pthread_mutex_lock(&g_registry_lock);
+  uint32_t freed = sweep_idle_locked(registry_now_ms(), idle_ms);
+  pthread_mutex_unlock(&g_registry_lock);
+  return freed;
+}
+
+uint32_t ethervox_stt_model_loaded_count(void) {
+  uint32_t count = 0;
+  pthread_mutex_lock(&g_registry_lock);
+  for (stt_model_entry_t* entry = g_models; entry; entry = entry->next) {
+    if (!entry->loading) {
+      count++;
+    }
+  }
+  pthread_mutex_unlock(&g_registry_lock);
+  return count;
+}
+
+bool ethervox_stt_model_find_loaded(ethervox_stt_model_load_fn load, char* path_out,
+                                    size_t path_size) {
+  if (!load || !path_out || path_size == 0) {
+    return false;
+  }
+  bool found = false;
+  pthread_mutex_lock(&g_registry_lock);
+  // New entries are pushed at the head, so the first match is the newest
+  for (stt_model_entry_t* entry = g_models; entry; entry = entry->next) {
+    if (entry->load == load && !entry->loading) {
+      found = strlen(entry->path) < path_size;
+      if (found) {
+        strcpy(path_out, entry->path);
+      }
+      break;
+    }
+  }
+  pthread_mutex_unlock(&g_registry_lock);
+  return found;
+}
@@ -5,6 +5,11 @@
  * Provides lightweight, real-time speech recognition for voice conversations.
  * Vosk is faster than Whisper (~0.3x realtime) and uses less memory (~50MB).
  *
+ * Partial hypotheses are surfaced as soon as they change, so callers can act
+ * before the utterance ends. With config.grammar set the recognizer only
+ * considers the listed phrases, which makes command recognition near-instant
+ * on small boards.
+ *
  * Copyright (c) 2024-2025 EthervoxAI Team
  * Licensed under CC BY-NC-SA 4.0
  */
@@ -18,6 +23,7 @@
 #include "ethervox/error.h"
 #include "ethervox/logging.h"
 #include "ethervox/config.h"
+#include "ethervox/dsp.h"
 
 // Conditional compilation based on Vosk availability
 #ifdef VOSK_AVAILABLE
@@ -32,9 +38,13 @@
  * @brief Vosk backend context for streaming recognition
  */
 typedef struct {
-    VoskModel* model;
+    VoskModel* model;              // Shared, owned by the STT model registry
     VoskRecognizer* recognizer;
     
+    // int16 conversion scratch, grown on demand
+    int16_t* pcm_buffer;
+    size_t pcm_capacity;
+    
     // Streaming state
     char* partial_result;
     char* final_result;
@@ -48,13 +58,14 @@ typedef struct {
 /**
  * @brief Parse JSON result from Vosk
  * 
- * Vosk returns JSON like: {"text": "hello world"}
- * We extract the text field.
+ * Vosk returns JSON like: {"text": "hello world"} for results and
+ * {"partial": "hello"} for partial results. We extract the given field.
  */
-static char* parse_vosk_json_text(const char* json) {
+static char* parse_vosk_json_text(const char* json, const char* key) {
     if (!json) return NULL;
     
-    const char* text_key = "\"text\"";
+    char text_key[32];
+    snprintf(text_key, sizeof(text_key), "\"%s\"", key);
     const char* text_start = strstr(json, text_key);
     if (!text_start) return NULL;
     
@@ -85,6 +96,60 @@ static char* parse_vosk_json_text(const char* json) {
     return result;
 }
 
+/**
+ * @brief Drop grammar "[unk]" placeholders so out-of-grammar speech yields no text
+ */
+static void strip_unknown_words(char* text) {
+    const char* unk = "[unk]";
+    size_t unk_len = strlen(unk);
+    char* read = text;
+    char* write = text;
+    while (*read) {
+        if (strncmp(read, unk, unk_len) == 0) {
+            read += unk_len;
+            while (*read == ' ') read++;
+            continue;
+        }
+        *write++ = *read++;
+    }
+    // Trim the separator left before a trailing placeholder
+    while (write > text && write[-1] == ' ') write--;
+    *write = '\0';
+}
+
+/**
+ * @brief Extract a result field, returning NULL when no words were recognized
+ */
+static char* vosk_result_text(const char* json, const char* key) {
+    char* text = parse_vosk_json_text(json, key);
+    if (text) {
+        strip_unknown_words(text);
+        if (text[0] == '\0') {
+            free(text);
+            text = NULL;
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Registry loader for Vosk models
+ */
+void* ethervox_stt_vosk_load_model(const char* model_path) {
+    LOG_INFO("Loading Vosk model from: %s", model_path);
+    VoskModel* model = vosk_model_new(model_path);
+    if (!model) {
+        LOG_ERROR("Failed to load Vosk model from: %s", model_path);
+        LOG_ERROR("Download model: https://alphacephei.com/vosk/models");
+        LOG_ERROR("Suggested: vosk-model-small-en-us-0.15 (~40MB)");
+    }
+    return model;
+}
+
+void ethervox_stt_vosk_free_model(void* model) {
+    vosk_model_free((VoskModel*)model);
+}
+
 /**
  * @brief Initialize Vosk backend
  */
@@ -116,22 +181,26 @@ ethervox_result_t ethervox_stt_vosk_init(ethervox_stt_runtime_t* runtime) {
         }
     }
     
-    LOG_INFO("Loading Vosk model from: %s", model_path);
-    ctx->model = vosk_model_new(model_path);
-    if (!ctx->model) {
-        LOG_ERROR("Failed to load Vosk model from: %s", model_path);
-        LOG_ERROR("Download model: https://alphacephei.com/vosk/models");
-        LOG_ERROR("Suggested: vosk-model-small-en-us-0.15 (~40MB)");
+    // Recognizers are per session; the model is shared with other sessions
+    void* model = NULL;
+    ethervox_result_t acquired = ethervox_stt_model_acquire(
+        model_path, ethervox_stt_vosk_load_model, ethervox_stt_vosk_free_model, &model);
+    if (ethervox_is_error(acquired)) {
         free(ctx);
-        return ETHERVOX_ERROR_STT_INIT;
+        return acquired;
     }
+    ctx->model = (VoskModel*)model;
     
-    // Create recognizer
+    // Create recognizer, restricted to the command grammar if one is set
     float sample_rate = runtime->config.sample_rate;
-    ctx->recognizer = vosk_recognizer_new(ctx->model, sample_rate);
+    if (runtime->config.grammar) {
+        ctx->recognizer = vosk_recognizer_new_grm(ctx->model, sample_rate, runtime->config.grammar);
+    } else {
+        ctx->recognizer = vosk_recognizer_new(ctx->model, sample_rate);
+    }
     if (!ctx->recognizer) {
         LOG_ERROR("Failed to create Vosk recognizer");
-        vosk_model_free(ctx->model);
+        ethervox_stt_model_release(ctx->model);
         free(ctx);
         return ETHERVOX_ERROR_STT_INIT;
     }
@@ -144,7 +213,8 @@ ethervox_result_t ethervox_stt_vosk_init(ethervox_stt_runtime_t* runtime) {
     
     runtime->backend_context = ctx;
     
-    LOG_INFO("Vosk backend initialized (sample_rate=%.0f Hz)", sample_rate);
+    LOG_INFO("Vosk backend initialized (sample_rate=%.0f Hz, %s)", sample_rate,
+             runtime->config.grammar ? "command grammar" : "dictation");
     
     return ETHERVOX_SUCCESS;
 }
@@ -162,6 +232,7 @@ ethervox_result_t ethervox_stt_vosk_start(ethervox_stt_runtime_t* runtime) {
     vosk_backend_context_t* ctx = (vosk_backend_context_t*)runtime->backend_context;
     
     // Reset state
+    vosk_recognizer_reset(ctx->recognizer);
     ctx->has_final_result = false;
     if (ctx->partial_result) {
         free(ctx->partial_result);
@@ -191,34 +262,34 @@ ethervox_result_t ethervox_stt_vosk_process(ethervox_stt_runtime_t* runtime,
     vosk_backend_context_t* ctx = (vosk_backend_context_t*)runtime->backend_context;
     
     // Convert float samples to int16
-    size_t sample_count = audio_buffer->frame_count;
-    int16_t* pcm_data = (int16_t*)malloc(sample_count * sizeof(int16_t));
-    if (!pcm_data) {
-        LOG_ERROR("Failed to allocate PCM buffer");
-        return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    size_t sample_count = audio_buffer->size;
+    if (sample_count > ctx->pcm_capacity) {
+        int16_t* grown = (int16_t*)realloc(ctx->pcm_buffer, sample_count * sizeof(int16_t));
+        if (!grown) {
+            LOG_ERROR("Failed to allocate PCM buffer");
+            return ETHERVOX_ERROR_OUT_OF_MEMORY;
+        }
+        ctx->pcm_buffer = grown;
+        ctx->pcm_capacity = sample_count;
     }
+    int16_t* pcm_data = ctx->pcm_buffer;
     
-    for (size_t i = 0; i < sample_count; i++) {
-        float sample = audio_buffer->data[i];
-        // Clamp to [-1.0, 1.0]
-        if (sample > 1.0f) sample = 1.0f;
-        if (sample < -1.0f) sample = -1.0f;
-        pcm_data[i] = (int16_t)(sample * 32767.0f);
-    }
+    ethervox_dsp_float_to_s16(audio_buffer->data, pcm_data, sample_count);
     
     // Feed audio to Vosk
-    int accept_result = vosk_recognizer_accept_waveform(ctx->recognizer, (const char*)pcm_data, sample_count * sizeof(int16_t));
-    
-    free(pcm_data);
+    int accept_result = vosk_recognizer_accept_waveform(ctx->recognizer, (const char*)pcm_data,
+                                                        (int)(sample_count * sizeof(int16_t)));
     
     ctx->audio_frames_processed++;
     
     if (accept_result) {
-        // Final result available
+        // Final result available; the next utterance starts a fresh partial
         const char* json_result = vosk_recognizer_result(ctx->recognizer);
+        free(ctx->partial_result);
+        ctx->partial_result = NULL;
         
-        char* text = parse_vosk_json_text(json_result);
-        if (text && strlen(text) > 0) {
+        char* text = vosk_result_text(json_result, "text");
+        if (text) {
             if (ctx->final_result) free(ctx->final_result);
             ctx->final_result = text;
             ctx->has_final_result = true;
@@ -233,32 +304,27 @@ ethervox_result_t ethervox_stt_vosk_process(ethervox_stt_runtime_t* runtime,
             LOG_DEBUG("Vosk final result: %s", text);
             
             return ETHERVOX_SUCCESS;  // Success with final result
-        } else {
-            if (text) free(text);
         }
-    } else {
-        // Partial result
-        if (runtime->config.enable_partial_results) {
-            const char* json_partial = vosk_recognizer_partial_result(ctx->recognizer);
+    } else if (runtime->config.enable_partial_results) {
+        // Partial result, reported only when the hypothesis changed
+        const char* json_partial = vosk_recognizer_partial_result(ctx->recognizer);
+        
+        char* text = vosk_result_text(json_partial, "partial");
+        if (text && (!ctx->partial_result || strcmp(text, ctx->partial_result) != 0)) {
+            if (ctx->partial_result) free(ctx->partial_result);
+            ctx->partial_result = text;
+            
+            // Populate result
+            result->text = strdup(text);
+            result->confidence = 0.5f;  // Lower confidence for partial
+            result->is_final = false;
+            result->is_partial = true;
             
-            char* text = parse_vosk_json_text(json_partial);
-            if (text && strlen(text) > 0) {
-                if (ctx->partial_result) free(ctx->partial_result);
-                ctx->partial_result = text;
-                
-                // Populate result
-                result->text = strdup(text);
-                result->confidence = 0.5f;  // Lower confidence for partial
-                result->is_final = false;
-                result->is_partial = true;
-                
-                LOG_DEBUG("Vosk partial result: %s", text);
-                
-                return ETHERVOX_SUCCESS;  // Success with partial result
-            } else {
-                if (text) free(text);
-            }
+            LOG_DEBUG("Vosk partial result: %s", text);
+            
+            return ETHERVOX_SUCCESS;  // Success with partial result
         }
+        free(text);
     }
     
     return 1;  // No result yet
@@ -277,8 +343,8 @@ ethervox_result_t ethervox_stt_vosk_finalize(ethervox_stt_runtime_t* runtime, et
     // Get any remaining buffered result
     const char* json_final = vosk_recognizer_final_result(ctx->recognizer);
     
-    char* text = parse_vosk_json_text(json_final);
-    if (text && strlen(text) > 0) {
+    char* text = vosk_result_text(json_final, "text");
+    if (text) {
         result->text = text;
         result->confidence = 0.9f;
         result->is_final = true;
@@ -299,10 +365,39 @@ ethervox_result_t ethervox_stt_vosk_finalize(ethervox_stt_runtime_t* runtime, et
         return ETHERVOX_SUCCESS;
     }
     
-    if (text) free(text);
-    
     LOG_WARN("Vosk finalize: no result available");
-    return ETHERVOX_ERROR_STT_NO_RESULT;
+    return 1;  // No result
+}
+
+/**
+ * @brief Switch between grammar-restricted command mode and dictation
+ */
+ethervox_result_t ethervox_stt_vosk_set_grammar(ethervox_stt_runtime_t* runtime, const char* grammar) {
+    ETHERVOX_CHECK_PTR(runtime);
+    ETHERVOX_CHECK_PTR(runtime->backend_context);
+    
+    vosk_backend_context_t* ctx = (vosk_backend_context_t*)runtime->backend_context;
+    
+    // A new recognizer picks up the grammar without reloading the shared model
+    VoskRecognizer* recognizer = grammar
+        ? vosk_recognizer_new_grm(ctx->model, (float)runtime->config.sample_rate, grammar)
+        : vosk_recognizer_new(ctx->model, (float)runtime->config.sample_rate);
+    if (!recognizer) {
+        LOG_ERROR("Failed to create Vosk recognizer for %s", grammar ? "grammar" : "dictation");
+        return ETHERVOX_ERROR_STT_INIT;
+    }
+    if (runtime->config.enable_partial_results) {
+        vosk_recognizer_set_max_alternatives(recognizer, 0);
+        vosk_recognizer_set_words(recognizer, 1);
+    }
+    
+    vosk_recognizer_free(ctx->recognizer);
+    ctx->recognizer = recognizer;
+    free(ctx->partial_result);
+    ctx->partial_result = NULL;
+    
+    LOG_INFO("Vosk switched to %s", grammar ? "command grammar" : "dictation");
+    return ETHERVOX_SUCCESS;
 }
 
 /**
@@ -335,7 +430,7 @@ void ethervox_stt_vosk_cleanup(ethervox_stt_runtime_t* runtime) {
     }
     
     if (ctx->model) {
-        vosk_model_free(ctx->model);
+        ethervox_stt_model_release(ctx->model);
     }
     
     if (ctx->partial_result) {
@@ -346,6 +441,7 @@ void ethervox_stt_vosk_cleanup(ethervox_stt_runtime_t* runtime) {
         free(ctx->final_result);
     }
     
+    free(ctx->pcm_buffer);
     free(ctx);
     runtime->backend_context = NULL;
     
@@ -386,8 +482,23 @@ void ethervox_stt_vosk_stop(ethervox_stt_runtime_t* runtime) {
     (void)runtime;
 }
 
+ethervox_result_t ethervox_stt_vosk_set_grammar(ethervox_stt_runtime_t* runtime, const char* grammar) {
+    (void)runtime;
+    (void)grammar;
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
 void ethervox_stt_vosk_cleanup(ethervox_stt_runtime_t* runtime) {
     (void)runtime;
 }
 
+void* ethervox_stt_vosk_load_model(const char* model_path) {
+    (void)model_path;
+    return NULL;
+}
+
+void ethervox_stt_vosk_free_model(void* model) {
+    (void)model;
+}
+
 #endif  // VOSK_AVAILABLE
@@ -15,10 +15,20 @@
 #include "ethervox/error.h"
 #include "ethervox/logging.h"
 #include "ethervox/config.h"
+#include "ethervox/diarization.h"
+#include "ethervox/vad.h"
 
 #ifdef WHISPER_CPP_AVAILABLE
 #include "whisper.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WHISPER_ENERGY_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define WHISPER_ENERGY_NEON 1
+#endif
+
 #define LOG_ERROR(...) ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, __VA_ARGS__)
 #define LOG_WARN(...)  ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__, __VA_ARGS__)
 #define LOG_INFO(...)  ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, __VA_ARGS__)
@@ -57,18 +67,35 @@ static inline size_t safe_strnlen(const char* p, size_t max) {
 /**
  * Minimal Whisper context - streaming with overlap
  */
+// VAD decision for one frame of the ring
+typedef struct {
+  uint64_t end;       // Logical ring position one past the frame
+  float probability;  // Speech probability
+  bool voiced;
+} whisper_vad_frame_t;
+
 typedef struct {
-  struct whisper_context* ctx;
+  struct whisper_context* ctx;    // Shared model, owned by the STT model registry
+  struct whisper_state* state;    // This session's decoder state over ctx
   struct whisper_full_params params;
-  float* audio_buffer;        // Main accumulation buffer
-  size_t audio_buffer_size;
+  
+  // Mirrored ring buffer: sample i is stored at ring[i % cap] and
+  // ring[i % cap + cap], so any window of up to ring_capacity samples is
+  // contiguous and whisper_full() reads it in place
+  float* ring;                 // 2 * ring_capacity floats, allocated once at init
+  size_t ring_capacity;        // audio_buffer_capacity + overlap_capacity
+  uint64_t ring_write;         // Total samples written (logical write position)
+  uint64_t chunk_start;        // Logical position of the first undecoded sample
+  size_t audio_buffer_size;    // Undecoded samples (ring_write - chunk_start)
   size_t audio_buffer_capacity;
   
-  // Overlap buffer (keeps last 200ms for context between chunks)
-  float* overlap_buffer;
+  // Overlap (the last 200ms before chunk_start, kept for context between chunks)
   size_t overlap_size;
   size_t overlap_capacity;
   
+  // Zero-padded copy for chunks shorter than whisper_full()'s 1 second minimum
+  float* pad_buffer;
+  
   // Duplicate detection
   char* last_transcript;
   int duplicate_count;
@@ -78,146 +105,606 @@ typedef struct {
   char detected_language[3];  // Detected language code
   bool language_detected;
   
-  // Periodic language re-detection for mid-conversation language changes
-  int segment_count;           // Number of segments processed
-  int redetect_interval;       // Re-detect language every N segments (0 = disabled)
+  // Language re-detection for mid-conversation language changes
+  int segment_count;           // Number of chunks processed
+  int redetect_interval;       // Re-check every N chunks within a speaker turn (0 = turns only)
+  int lang_detect_segment;     // segment_count at the last language check
+  int lang_speaker;            // Speaker turn the cached language was detected for
+  float* lang_probs;           // whisper_lang_auto_detect() output (one per language)
+  
+  // Context carry: decoder prompt = [tokenized initial prompt][previous chunk's tail]
+  bool carry_context;
+  whisper_token* prompt_tokens;
+  int prompt_base_tokens;      // Tokens of the initial prompt (always kept)
   
   // Speaker tracking across entire session
   int current_speaker;         // Current active speaker ID (0, 1, 2, ...)
   bool show_speaker_labels;    // Always show speaker labels (not just on turns)
   
-  // Acoustic feature tracking for speaker change detection
-  float last_segment_energy;   // RMS energy of last segment
-  float last_segment_pitch;    // Estimated pitch of last segment
-  int64_t last_segment_end_time; // End time of last segment (for pause detection)
-  bool first_segment;          // Is this the first segment?
+  ethervox_diarizer_t* diarizer; // MFCC/YIN speaker clustering (features computed off-thread)
+  
+  // Endpoint detection (VAD frames mapped onto the undecoded audio)
+  bool endpoint_mode;          // Decode at end of speech instead of every 3 seconds
+  ethervox_vad_t* vad;         // Private VAD, for buffers that come without the stream's frames
+  float vad_threshold;         // Frame probability that counts as voiced (config.vad_threshold)
+  size_t vad_frame_samples;    // Length of the frames being queued
+  whisper_vad_frame_t* vad_queue;  // Classified frames the endpointer has not seen yet
+  uint32_t vad_queue_capacity;
+  uint64_t vad_queue_head;
+  uint64_t vad_queue_tail;
+  size_t vad_pos;              // First undecoded sample not yet classified
+  bool in_speech;              // An utterance is open
+  int speech_frames;           // Consecutive voiced frames
+  int silence_frames;          // Consecutive unvoiced frames
+  size_t speech_start;         // First voiced sample of the open utterance
+  size_t speech_end;           // One past its last voiced frame (0 = none yet)
+  size_t voiced_samples;       // Voiced audio in the utterance (min-speech check)
 } whisper_backend_context_t;
 
+// Why a chunk is being decoded
+typedef enum {
+  WHISPER_CHUNK_PENDING,     // Keep accumulating
+  WHISPER_CHUNK_TIME,        // Fixed 3-second chunk (time-based mode)
+  WHISPER_CHUNK_SPEECH_END,  // Utterance ended in silence
+  WHISPER_CHUNK_MAX_LENGTH   // Utterance still running but the length guard was hit
+} whisper_chunk_reason_t;
+
+#define WHISPER_SAMPLES_PER_MS 16
+// whisper_full() ignores input shorter than 1 second, so short commands are zero-padded
+#define WHISPER_MIN_DECODE_SAMPLES (16000 + 1600)
+// Token budget for the tokenized initial prompt
+#define WHISPER_PROMPT_BASE_MAX 128
+// Bounds for the hallucination guards (tokens / text bytes examined per chunk)
+#define WHISPER_GUARD_MAX_TOKENS 512
+#define WHISPER_GUARD_MAX_TEXT 2048
+
+/**
+ * Sum of squares and peak magnitude of a block
+ * Eight samples per iteration on SSE2/NEON, scalar tail and fallback
+ */
+static float block_energy(const float* data, size_t count, float* peak_out) {
+  size_t i = 0;
+  float sum = 0.0f;
+  float peak = 0.0f;
+#if defined(WHISPER_ENERGY_SSE2)
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  __m128 vpeak = _mm_setzero_ps();
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_loadu_ps(data + i);
+    __m128 b = _mm_loadu_ps(data + i + 4);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    vpeak = _mm_max_ps(vpeak, _mm_max_ps(_mm_and_ps(a, abs_mask), _mm_and_ps(b, abs_mask)));
+  }
+  float lanes[4];
+  float peaks[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+  _mm_storeu_ps(peaks, vpeak);
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (int k = 0; k < 4; k++) {
+    if (peaks[k] > peak) peak = peaks[k];
+  }
+#elif defined(WHISPER_ENERGY_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  float32x4_t vpeak = vdupq_n_f32(0.0f);
+  for (; i + 8 <= count; i += 8) {
+    float32x4_t a = vld1q_f32(data + i);
+    float32x4_t b = vld1q_f32(data + i + 4);
+    acc0 = vmlaq_f32(acc0, a, a);
+    acc1 = vmlaq_f32(acc1, b, b);
+    vpeak = vmaxq_f32(vpeak, vmaxq_f32(vabsq_f32(a), vabsq_f32(b)));
+  }
+  float lanes[4];
+  float peaks[4];
+  vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+  vst1q_f32(peaks, vpeak);
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (int k = 0; k < 4; k++) {
+    if (peaks[k] > peak) peak = peaks[k];
+  }
+#endif
+  for (; i < count; i++) {
+    float s = data[i];
+    sum += s * s;
+    if (fabsf(s) > peak) peak = fabsf(s);
+  }
+  if (peak_out) *peak_out = peak;
+  return sum;
+}
+
 static void log_audio_stats(const float* data, size_t sample_count, const char* label) {
   if (!data || sample_count == 0) {
     LOG_INFO("%s: no samples", label ? label : "Audio");
     return;
   }
-  double sum_sq = 0.0;
   float peak = 0.0f;
-  for (size_t i = 0; i < sample_count; ++i) {
-    float s = fabsf(data[i]);
-    sum_sq += (double)s * (double)s;
-    if (s > peak) peak = s;
-  }
-  float rms = (float)sqrt(sum_sq / (double)sample_count);
+  float rms = sqrtf(block_energy(data, sample_count, &peak) / (float)sample_count);
   LOG_INFO("%s: %zu samples, RMS=%.4f, peak=%.4f", label ? label : "Audio",
            sample_count, rms, peak);
 }
 
 /**
- * Calculate RMS energy of audio segment
+ * Suppress whisper.cpp internal logs
  */
-static float calculate_energy(const float* data, size_t start, size_t end) {
-  if (!data || start >= end) return 0.0f;
-  double sum_sq = 0.0;
-  for (size_t i = start; i < end; i++) {
-    float s = data[i];
-    sum_sq += (double)s * (double)s;
+static void whisper_log_suppress(enum ggml_log_level level, const char* text, void* user_data) {
+  (void)level; (void)text; (void)user_data;
+}
+
+/**
+ * Forget the open utterance (the noise floor is kept)
+ */
+static void vad_reset(whisper_backend_context_t* ctx) {
+  ctx->in_speech = false;
+  ctx->speech_frames = 0;
+  ctx->silence_frames = 0;
+  ctx->speech_start = 0;
+  ctx->speech_end = 0;
+  ctx->voiced_samples = 0;
+}
+
+/**
+ * Start endpoint detection over (the ring is being rewound)
+ */
+static void vad_restart(whisper_backend_context_t* ctx) {
+  ctx->vad_pos = 0;
+  ctx->vad_queue_head = 0;
+  ctx->vad_queue_tail = 0;
+  ethervox_vad_reset(ctx->vad);
+  vad_reset(ctx);
+}
+
+/**
+ * Queue the VAD frames of a buffer whose first `appended` samples were
+ * stored at logical ring position append_at
+ *
+ * frames are the capture stream's, or NULL to analyze the buffer with the
+ * private VAD. Either way a frame is voiced by our own threshold.
+ */
+static void vad_enqueue(whisper_backend_context_t* ctx, const ethervox_audio_buffer_t* audio_buffer,
+                        const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                        uint64_t append_at, size_t appended) {
+  if (!frames) {
+    ethervox_result_t rc =
+        ethervox_vad_process(ctx->vad, audio_buffer->data, audio_buffer->size, &frames, &frame_count);
+    if (ethervox_is_error(rc)) {
+      LOG_WARN("[Whisper VAD] Frame analysis failed, treating buffer as silence");
+      return;
+    }
+  }
+  for (uint32_t i = 0; i < frame_count; i++) {
+    if (frames[i].end_offset > appended) break;  // Dropped by a ring overflow
+    if (ctx->vad_queue_tail - ctx->vad_queue_head == ctx->vad_queue_capacity) {
+      ctx->vad_queue_head++;  // Oldest entry already lies in consumed audio
+    }
+    whisper_vad_frame_t* slot = &ctx->vad_queue[ctx->vad_queue_tail++ % ctx->vad_queue_capacity];
+    slot->end = append_at + frames[i].end_offset;
+    slot->probability = frames[i].probability;
+    slot->voiced = frames[i].probability >= ctx->vad_threshold;
+    if (frames[i].length > 0) ctx->vad_frame_samples = frames[i].length;
+  }
+}
+
+/**
+ * Contiguous view of the ring starting at logical position pos (valid for
+ * up to ring_capacity samples thanks to the mirror)
+ */
+static inline float* ring_at(const whisper_backend_context_t* ctx, uint64_t pos) {
+  return ctx->ring + (size_t)(pos % ctx->ring_capacity);
+}
+
+/**
+ * Undecoded audio as one contiguous array of audio_buffer_size samples
+ */
+static inline float* chunk_data(const whisper_backend_context_t* ctx) {
+  return ring_at(ctx, ctx->chunk_start);
+}
+
+/**
+ * Append samples to both halves of the ring
+ *
+ * @return Number of samples stored (less than count if the chunk is full)
+ */
+static size_t ring_append(whisper_backend_context_t* ctx, const float* samples, size_t count) {
+  size_t space = ctx->audio_buffer_capacity - ctx->audio_buffer_size;
+  if (count > space) count = space;
+  
+  size_t pos = (size_t)(ctx->ring_write % ctx->ring_capacity);
+  size_t first = ctx->ring_capacity - pos;
+  if (first > count) first = count;
+  memcpy(ctx->ring + pos, samples, first * sizeof(float));
+  memcpy(ctx->ring + pos + ctx->ring_capacity, samples, first * sizeof(float));
+  if (count > first) {
+    memcpy(ctx->ring, samples + first, (count - first) * sizeof(float));
+    memcpy(ctx->ring + ctx->ring_capacity, samples + first, (count - first) * sizeof(float));
   }
-  return (float)sqrt(sum_sq / (double)(end - start));
+  
+  ctx->ring_write += count;
+  ctx->audio_buffer_size += count;
+  return count;
 }
 
 /**
- * Estimate fundamental frequency (pitch) using zero-crossing rate
- * Simple pitch proxy: higher ZCR = higher pitch
+ * Mark the first `consumed` undecoded samples as done (index arithmetic only).
+ * Any overlap is invalidated; callers re-establish it afterwards.
  */
-static float estimate_pitch(const float* data, size_t start, size_t end) {
-  if (!data || start >= end || (end - start) < 100) return 0.0f;
+static void consume_audio(whisper_backend_context_t* ctx, size_t consumed) {
+  if (consumed > ctx->audio_buffer_size) consumed = ctx->audio_buffer_size;
+  if (consumed == 0) return;
+  ctx->chunk_start += consumed;
+  ctx->audio_buffer_size -= consumed;
+  ctx->overlap_size = 0;
+  ctx->vad_pos = ctx->vad_pos > consumed ? ctx->vad_pos - consumed : 0;
+  ctx->speech_start = ctx->speech_start > consumed ? ctx->speech_start - consumed : 0;
+  ctx->speech_end = ctx->speech_end > consumed ? ctx->speech_end - consumed : 0;
+}
+
+/**
+ * Window handed to whisper_full(): overlap + undecoded[start, start + length)
+ *
+ * Points straight into the ring unless the window is shorter than the 1
+ * second whisper_full() accepts, in which case it is copied to the
+ * preallocated pad_buffer and zero-padded.
+ *
+ * @param sample_count Output: samples to decode
+ */
+static const float* decode_window(whisper_backend_context_t* ctx, size_t start, size_t length,
+                                  size_t* sample_count) {
+  // The overlap sits directly before chunk_start, so it only joins a window
+  // that begins there
+  if (start != 0) ctx->overlap_size = 0;
+  
+  size_t window = ctx->overlap_size + length;
+  const float* data = ring_at(ctx, ctx->chunk_start + start - ctx->overlap_size);
+  if (window >= WHISPER_MIN_DECODE_SAMPLES) {
+    *sample_count = window;
+    return data;
+  }
   
-  int zero_crossings = 0;
-  for (size_t i = start + 1; i < end; i++) {
-    if ((data[i] >= 0.0f && data[i-1] < 0.0f) || (data[i] < 0.0f && data[i-1] >= 0.0f)) {
-      zero_crossings++;
+  memcpy(ctx->pad_buffer, data, window * sizeof(float));
+  memset(ctx->pad_buffer + window, 0, (WHISPER_MIN_DECODE_SAMPLES - window) * sizeof(float));
+  *sample_count = WHISPER_MIN_DECODE_SAMPLES;
+  return ctx->pad_buffer;
+}
+
+/**
+ * Throw away all buffered audio after a failed decode
+ */
+static void discard_chunk(whisper_backend_context_t* ctx) {
+  consume_audio(ctx, ctx->audio_buffer_size);
+  vad_reset(ctx);
+}
+
+/**
+ * Walk the queued VAD frames and decide whether to decode
+ *
+ * Frames come from the capture stream's VAD or the private one (voiced =
+ * speech probability over config.vad_threshold; the VAD's own hangover is
+ * not used, the end silence below plays that role). While idle only a short pre-roll is kept, so silence never reaches
+ * whisper_full(). An utterance ends after ETHERVOX_WHISPER_VAD_END_SILENCE_MS
+ * of unvoiced frames and is decoded with its trailing silence trimmed to
+ * ETHERVOX_WHISPER_VAD_PAD_MS.
+ *
+ * @param frame Samples per VAD frame
+ * @param decode_start Output: first undecoded sample to decode
+ * @param decode_end Output: one past the last sample to decode
+ */
+static whisper_chunk_reason_t endpoint_update(whisper_backend_context_t* ctx, size_t frame,
+                                              size_t* decode_start, size_t* decode_end) {
+  const size_t frame_ms = frame / WHISPER_SAMPLES_PER_MS;
+  const size_t pad = ETHERVOX_WHISPER_VAD_PAD_MS * WHISPER_SAMPLES_PER_MS;
+  const size_t min_speech = ETHERVOX_WHISPER_VAD_MIN_SPEECH_MS * WHISPER_SAMPLES_PER_MS;
+  int start_frames = (int)(ETHERVOX_WHISPER_VAD_START_MS / frame_ms);
+  int end_frames = (int)(ETHERVOX_WHISPER_VAD_END_SILENCE_MS / frame_ms);
+  if (start_frames < 1) start_frames = 1;
+  if (end_frames < 1) end_frames = 1;
+  size_t max_samples = (size_t)ETHERVOX_WHISPER_MAX_UTTERANCE_MS * WHISPER_SAMPLES_PER_MS;
+  if (max_samples > ctx->audio_buffer_capacity) max_samples = ctx->audio_buffer_capacity;
+  
+  while (ctx->vad_queue_head != ctx->vad_queue_tail) {
+    const whisper_vad_frame_t* f = &ctx->vad_queue[ctx->vad_queue_head++ % ctx->vad_queue_capacity];
+    // Skip frames whose audio was consumed meanwhile (idle trim, discarded chunk)
+    if (f->end <= ctx->chunk_start + ctx->vad_pos) continue;
+    ctx->vad_pos = (size_t)(f->end - ctx->chunk_start);
+    
+    if (f->voiced) {
+      ctx->speech_frames++;
+      ctx->silence_frames = 0;
+      if (ctx->in_speech) {
+        ctx->voiced_samples += frame;
+      } else if (ctx->speech_frames >= start_frames) {
+        size_t run = (size_t)ctx->speech_frames * frame;
+        ctx->in_speech = true;
+        ctx->speech_start = ctx->vad_pos > run ? ctx->vad_pos - run : 0;
+        ctx->voiced_samples = run;
+        LOG_DEBUG("[Whisper VAD] Speech start (p=%.2f)", f->probability);
+      }
+      if (ctx->in_speech) ctx->speech_end = ctx->vad_pos;
+      continue;
     }
+    
+    ctx->speech_frames = 0;
+    ctx->silence_frames++;
+    if (!ctx->in_speech || ctx->silence_frames < end_frames) continue;
+    
+    if (ctx->speech_end == 0 || ctx->voiced_samples < min_speech) {
+      LOG_DEBUG("[Whisper VAD] Dropping %.2fs burst without decoding",
+                (float)ctx->voiced_samples / 16000.0f);
+      vad_reset(ctx);
+      ctx->overlap_size = 0;
+      continue;
+    }
+    
+    *decode_start = ctx->speech_start > pad ? ctx->speech_start - pad : 0;
+    *decode_end = ctx->speech_end + pad < ctx->audio_buffer_size
+                  ? ctx->speech_end + pad : ctx->audio_buffer_size;
+    LOG_DEBUG("[Whisper VAD] Speech end after %.2fs of speech",
+              (float)ctx->voiced_samples / 16000.0f);
+    return WHISPER_CHUNK_SPEECH_END;
   }
   
-  // Normalize by duration to get zero-crossing rate
-  return (float)zero_crossings / (float)(end - start);
+  if (!ctx->in_speech) {
+    // Idle: keep the pre-roll and any voiced run that may still open an utterance
+    size_t keep = pad + (size_t)ctx->speech_frames * frame;
+    if (ctx->vad_pos > keep) consume_audio(ctx, ctx->vad_pos - keep);
+    return WHISPER_CHUNK_PENDING;
+  }
+  
+  if (ctx->audio_buffer_size >= max_samples) {
+    *decode_start = ctx->speech_start > pad ? ctx->speech_start - pad : 0;
+    *decode_end = ctx->audio_buffer_size;
+    return WHISPER_CHUNK_MAX_LENGTH;
+  }
+  
+  return WHISPER_CHUNK_PENDING;
+}
+
+/**
+ * Drop the carried tokens, keeping only the initial prompt
+ */
+static void reset_prompt_carry(whisper_backend_context_t* ctx) {
+  if (ctx->prompt_tokens) {
+    ctx->params.prompt_n_tokens = ctx->prompt_base_tokens;
+  }
 }
 
 /**
- * Detect speaker change using multi-factor analysis:
- * 1. Significant energy change (volume shift)
- * 2. Pitch change (voice characteristic)
- * 3. Pause duration (silence between speakers)
+ * Text tokens (no timestamps or specials) of the last whisper_full() result;
+ * if there are more than max_tokens, the last max_tokens are kept
  */
-static bool detect_speaker_change(whisper_backend_context_t* ctx,
-                                   const float* audio_data,
-                                   size_t segment_start,
-                                   size_t segment_end,
-                                   int64_t segment_t0,
-                                   int64_t segment_t1) {
-  if (ctx->first_segment) {
-    return false; // No change on first segment
-  }
-  
-  // Calculate current segment features
-  float energy = calculate_energy(audio_data, segment_start, segment_end);
-  float pitch = estimate_pitch(audio_data, segment_start, segment_end);
-  
-  // Calculate pause duration (in 10ms units, same as timestamps)
-  int64_t pause_duration = segment_t0 - ctx->last_segment_end_time;
-  
-  // Thresholds for speaker change detection (from config)
-  const float ENERGY_CHANGE_THRESHOLD = ETHERVOX_SPEAKER_ENERGY_CHANGE_THRESHOLD;
-  const float PITCH_CHANGE_THRESHOLD = ETHERVOX_SPEAKER_PITCH_CHANGE_THRESHOLD;
-  const int64_t PAUSE_THRESHOLD = ETHERVOX_SPEAKER_PAUSE_THRESHOLD;
-  
-  bool speaker_change = false;
-  int change_factors = 0;
-  
-  // Factor 1: Energy change (different volume = different speaker or distance)
-  if (ctx->last_segment_energy > 0.01f && energy > 0.01f) {
-    float energy_ratio = fabsf(energy - ctx->last_segment_energy) / ctx->last_segment_energy;
-    if (energy_ratio > ENERGY_CHANGE_THRESHOLD) {
-      change_factors++;
-      LOG_DEBUG("Energy change detected: %.4f -> %.4f (ratio: %.2f)",
-                ctx->last_segment_energy, energy, energy_ratio);
+static int collect_text_tokens(whisper_backend_context_t* ctx, whisper_token* out, int max_tokens) {
+  const whisper_token eot = whisper_token_eot(ctx->ctx);
+  const int n_segments = whisper_full_n_segments_from_state(ctx->state);
+  
+  int total = 0;
+  for (int i = 0; i < n_segments; i++) {
+    for (int j = 0; j < whisper_full_n_tokens_from_state(ctx->state, i); j++) {
+      if (whisper_full_get_token_id_from_state(ctx->state, i, j) < eot) total++;
     }
   }
   
-  // Factor 2: Pitch change (different voice fundamental frequency)
-  if (ctx->last_segment_pitch > 0.001f && pitch > 0.001f) {
-    float pitch_ratio = fabsf(pitch - ctx->last_segment_pitch) / ctx->last_segment_pitch;
-    if (pitch_ratio > PITCH_CHANGE_THRESHOLD) {
-      change_factors++;
-      LOG_DEBUG("Pitch change detected: %.4f -> %.4f (ratio: %.2f)",
-                ctx->last_segment_pitch, pitch, pitch_ratio);
+  int skip = total > max_tokens ? total - max_tokens : 0;
+  int count = 0;
+  for (int i = 0; i < n_segments; i++) {
+    for (int j = 0; j < whisper_full_n_tokens_from_state(ctx->state, i); j++) {
+      whisper_token id = whisper_full_get_token_id_from_state(ctx->state, i, j);
+      if (id >= eot) continue;
+      if (skip > 0) {
+        skip--;
+        continue;
+      }
+      out[count++] = id;
+    }
+  }
+  return count;
+}
+
+/**
+ * True if some phrase of up to 8 tokens repeats back-to-back
+ * ETHERVOX_WHISPER_MAX_PHRASE_REPEATS times
+ */
+static bool has_phrase_loop(const whisper_token* ids, int count) {
+  for (int period = 1; period <= 8; period++) {
+    int run = 0;  // Consecutive tokens equal to the one a period earlier
+    for (int i = period; i < count; i++) {
+      run = ids[i] == ids[i - period] ? run + 1 : 0;
+      if (run / period + 1 >= ETHERVOX_WHISPER_MAX_PHRASE_REPEATS) return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Rough compression ratio: text length over an LZ77-style cost where each
+ * repeat of an earlier 4-byte sequence costs 3 bytes however long it runs.
+ * Normal speech stays well under 2; repetition loops score far higher.
+ */
+static float text_compression_ratio(const char* text, size_t len) {
+  if (len < 32) return 1.0f;  // Too short to judge
+  
+  uint16_t last_seen[4096];   // Position + 1 of the latest 4-gram per hash bucket
+  memset(last_seen, 0, sizeof(last_seen));
+  
+  size_t cost = 0;
+  size_t i = 0;
+  while (i < len) {
+    if (i + 4 <= len) {
+      uint32_t h = ((uint32_t)(unsigned char)text[i] * 2654435761u) ^
+                   ((uint32_t)(unsigned char)text[i + 1] << 16) ^
+                   ((uint32_t)(unsigned char)text[i + 2] << 8) ^ (unsigned char)text[i + 3];
+      h = (h ^ (h >> 12)) & 4095;
+      size_t candidate = last_seen[h];
+      last_seen[h] = (uint16_t)(i + 1);
+      if (candidate > 0 && memcmp(text + candidate - 1, text + i, 4) == 0) {
+        size_t match = 4;
+        while (i + match < len && text[candidate - 1 + match] == text[i + match]) match++;
+        cost += 3;
+        i += match;
+        continue;
+      }
     }
+    cost++;
+    i++;
+  }
+  return (float)len / (float)cost;
+}
+
+/**
+ * Hallucination guards for the last whisper_full() result
+ */
+static bool chunk_output_degenerate(whisper_backend_context_t* ctx) {
+  whisper_token ids[WHISPER_GUARD_MAX_TOKENS];
+  int count = collect_text_tokens(ctx, ids, WHISPER_GUARD_MAX_TOKENS);
+  if (has_phrase_loop(ids, count)) {
+    LOG_WARN("⚠️  Repetition loop in decoded tokens");
+    return true;
   }
   
-  // Factor 3: Significant pause (typical of turn-taking)
-  if (pause_duration > PAUSE_THRESHOLD) {
-    change_factors++;
-    LOG_DEBUG("Pause detected: %lldms", pause_duration * 10);
+  char text[WHISPER_GUARD_MAX_TEXT];
+  size_t len = 0;
+  for (int i = 0; i < whisper_full_n_segments_from_state(ctx->state) && len < sizeof(text) - 1; i++) {
+    const char* segment = whisper_full_get_segment_text_from_state(ctx->state, i);
+    if (!whisper_text_ptr_valid(segment)) continue;
+    size_t segment_len = safe_strnlen(segment, sizeof(text) - 1 - len);
+    memcpy(text + len, segment, segment_len);
+    len += segment_len;
   }
   
-  // Require minimum factors to confirm speaker change (reduce false positives)
-  if (change_factors >= ETHERVOX_SPEAKER_CHANGE_MIN_FACTORS) {
-    speaker_change = true;
-    LOG_INFO("🎙️ Speaker change detected (%d factors)",
-             change_factors);
+  float ratio = text_compression_ratio(text, len);
+  if (ratio > ETHERVOX_WHISPER_MAX_COMPRESSION_RATIO) {
+    LOG_WARN("⚠️  Decoded text compresses %.1fx (limit %.1f) - likely hallucination", ratio,
+             ETHERVOX_WHISPER_MAX_COMPRESSION_RATIO);
+    return true;
   }
+  return false;
+}
+
+/**
+ * Carry the tail of the last result into the next chunk's prompt
+ * (an empty result keeps the previous carry)
+ */
+static void carry_prompt_tokens(whisper_backend_context_t* ctx) {
+  if (!ctx->carry_context || !ctx->prompt_tokens) return;
   
-  // Update context for next comparison
-  ctx->last_segment_energy = energy;
-  ctx->last_segment_pitch = pitch;
-  ctx->last_segment_end_time = segment_t1;
+  whisper_token tail[ETHERVOX_WHISPER_PROMPT_MAX_TOKENS];
+  int count = collect_text_tokens(ctx, tail, ETHERVOX_WHISPER_PROMPT_MAX_TOKENS);
+  if (count == 0) return;
   
-  return speaker_change;
+  memcpy(ctx->prompt_tokens + ctx->prompt_base_tokens, tail, (size_t)count * sizeof(whisper_token));
+  ctx->params.prompt_n_tokens = ctx->prompt_base_tokens + count;
 }
 
 /**
- * Suppress whisper.cpp internal logs
+ * Identify the chunk's language with whisper_lang_auto_detect()
+ *
+ * This costs one encoder pass over the first 30s window plus a single
+ * decoder step, instead of a whole whisper_full() run. The cached language
+ * only changes when the new one leads it by ETHERVOX_WHISPER_LANG_SWITCH_MARGIN,
+ * so a short ambiguous utterance cannot flip the session language.
  */
-static void whisper_log_suppress(enum ggml_log_level level, const char* text, void* user_data) {
-  (void)level; (void)text; (void)user_data;
+static void detect_chunk_language(whisper_backend_context_t* ctx, const float* samples,
+                                  size_t sample_count, int speaker) {
+  const int n_threads = ctx->params.n_threads > 0 ? ctx->params.n_threads : 1;
+  
+  ctx->lang_detect_segment = ctx->segment_count;
+  ctx->lang_speaker = speaker;
+  
+  int lang_id = -1;
+  if (whisper_pcm_to_mel_with_state(ctx->ctx, ctx->state, samples, (int)sample_count, n_threads) == 0) {
+    lang_id = whisper_lang_auto_detect_with_state(ctx->ctx, ctx->state, 0, n_threads, ctx->lang_probs);
+  }
+  const char* detected_lang = lang_id >= 0 ? whisper_lang_str(lang_id) : NULL;
+  
+  if (!detected_lang || strlen(detected_lang) < 2) {
+    // Fallback to English if detection fails
+    if (!ctx->language_detected) {
+      strncpy(ctx->detected_language, "en", 2);
+      ctx->detected_language[2] = '\0';
+      ctx->language_detected = true;
+      ctx->params.language = ctx->detected_language;
+      LOG_WARN("Language detection failed, defaulting to English");
+    }
+    return;
+  }
+  
+  // Validate detected language against Whisper's supported languages
+  // Common issue: "nn" (Norwegian Nynorsk) is not well-supported
+  // Multilingual models may not handle all variants well
+  const char* safe_lang = detected_lang;
+  if (strcmp(detected_lang, "nn") == 0 || strcmp(detected_lang, "no") == 0) {
+    // Norwegian variants → use English (common issue with quiet audio)
+    safe_lang = "en";
+    LOG_WARN("⚠️  Detected Norwegian ('%s'), but switching to English (more reliable for quiet audio)", detected_lang);
+  } else if (strcmp(detected_lang, "mt") == 0 || strcmp(detected_lang, "sa") == 0 || 
+             strcmp(detected_lang, "bo") == 0 || strcmp(detected_lang, "haw") == 0) {
+    // Rare languages that Whisper struggles with → fallback to English
+    safe_lang = "en";
+    LOG_WARN("⚠️  Detected rare language '%s', but switching to English (better model support)", detected_lang);
+  }
+  // Probabilities are for the language actually adopted
+  const int safe_id = safe_lang == detected_lang ? lang_id : whisper_lang_id(safe_lang);
+  const float safe_prob = safe_id >= 0 ? ctx->lang_probs[safe_id] : 0.0f;
+  
+  if (ctx->language_detected) {
+    if (strncmp(ctx->detected_language, safe_lang, 2) == 0) {
+      LOG_DEBUG("Language confirmed: %s (p=%.2f)", ctx->detected_language, safe_prob);
+      return;
+    }
+    // Hysteresis: require a clear lead over the cached language
+    int current_id = whisper_lang_id(ctx->detected_language);
+    float lead = safe_prob - (current_id >= 0 ? ctx->lang_probs[current_id] : 0.0f);
+    if (lead < ETHERVOX_WHISPER_LANG_SWITCH_MARGIN) {
+      LOG_DEBUG("Keeping language %s (%s leads by only %.2f)", ctx->detected_language,
+                safe_lang, lead);
+      return;
+    }
+    LOG_INFO("🔄 Language changed: %s → %s", ctx->detected_language, safe_lang);
+  } else {
+    LOG_INFO("[OK] Detected language: %s (p=%.2f)", safe_lang, safe_prob);
+  }
+  
+  // Carried tokens belong to the old language
+  reset_prompt_carry(ctx);
+  strncpy(ctx->detected_language, safe_lang, 2);
+  ctx->detected_language[2] = '\0';
+  ctx->language_detected = true;
+  ctx->params.language = ctx->detected_language;
+}
+
+/**
+ * Registry loader: weights only, per-session state comes from whisper_init_state()
+ */
+void* ethervox_stt_whisper_load_model(const char* model_path) {
+  whisper_log_set(whisper_log_suppress, NULL);
+  LOG_INFO("Loading Whisper model from: %s", model_path);
+  struct whisper_context_params cparams = whisper_context_default_params();
+  struct whisper_context* model = whisper_init_from_file_with_params(model_path, cparams);
+  if (!model) {
+    LOG_ERROR("Failed to load Whisper model (possibly OOM): %s", model_path);
+    return NULL;
+  }
+  LOG_INFO("✅ Successfully loaded Whisper model: %s", model_path);
+  return model;
+}
+
+void ethervox_stt_whisper_free_model(void* model) {
+  whisper_free((struct whisper_context*)model);
+}
+
+/**
+ * Free this session's state and drop its reference on the shared model
+ */
+static void release_model(whisper_backend_context_t* ctx) {
+  if (ctx->state) {
+    whisper_free_state(ctx->state);
+    ctx->state = NULL;
+  }
+  if (ctx->ctx) {
+    ethervox_stt_model_release(ctx->ctx);
+    ctx->ctx = NULL;
+  }
 }
 
 /**
@@ -226,34 +713,43 @@ static void whisper_log_suppress(enum ggml_log_level level, const char* text, vo
 ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime) {
   ETHERVOX_CHECK_PTR(runtime);
   
-  whisper_log_set(whisper_log_suppress, NULL);
+  ETHERVOX_CHECK_PTR(runtime->config.model_path);
   
   whisper_backend_context_t* ctx = (whisper_backend_context_t*)calloc(1, sizeof(whisper_backend_context_t));
   if (!ctx) {
     return ETHERVOX_ERROR_OUT_OF_MEMORY;
   }
   
-  // Load model
-  LOG_INFO("Loading Whisper model from: %s", runtime->config.model_path);
-  struct whisper_context_params cparams = whisper_context_default_params();
-  ctx->ctx = whisper_init_from_file_with_params(runtime->config.model_path, cparams);
-  if (!ctx->ctx) {
-    LOG_ERROR("Failed to load Whisper model (possibly OOM): %s", runtime->config.model_path);
+  // The model is shared with other sessions on the same path; this session
+  // only allocates its own state (KV cache, mel and decoder buffers)
+  void* model = NULL;
+  ethervox_result_t acquired = ethervox_stt_model_acquire(
+      runtime->config.model_path, ethervox_stt_whisper_load_model, ethervox_stt_whisper_free_model,
+      &model);
+  if (ethervox_is_error(acquired)) {
+    free(ctx);
+    return acquired;
+  }
+  ctx->ctx = (struct whisper_context*)model;
+  ctx->state = whisper_init_state(ctx->ctx);
+  if (!ctx->state) {
+    LOG_ERROR("Failed to create Whisper state (possibly OOM)");
+    ethervox_stt_model_release(ctx->ctx);
     free(ctx);
     return ETHERVOX_ERROR_STT_INIT;
   }
   
-  LOG_INFO("✅ Successfully loaded Whisper model: %s", runtime->config.model_path);
-  
   // Get default params with BEAM_SEARCH strategy for better accuracy
   ctx->params = whisper_full_default_params(WHISPER_SAMPLING_BEAM_SEARCH);
+  if (runtime->config.threads > 0) {
+    ctx->params.n_threads = (int)runtime->config.threads;
+  }
   
   // Language configuration for multilingual model
   const char* lang = runtime->config.language;
   if (lang && strcmp(lang, "auto") == 0) {
-    // Multi-language support: Enable two-pass approach
-    // Pass 1: detect_language=true to identify language
-    // Pass 2: detect_language=false with detected language to transcribe
+    // Multi-language support: language ID runs on each chunk's mel via
+    // whisper_lang_auto_detect(), then whisper_full() transcribes once
     ctx->auto_detect_language = true;
     ctx->language_detected = false;
     // CRITICAL: Initialize to English as fallback (will be overwritten after detection)
@@ -261,8 +757,8 @@ ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime) {
     strncpy(ctx->detected_language, "en", 2);
     ctx->detected_language[2] = '\0';
     ctx->params.language = ctx->detected_language;
-    ctx->params.detect_language = true;  // First pass: detect only
-    LOG_INFO("Multi-language auto-detection enabled (two-pass mode, fallback=en)");
+    ctx->params.detect_language = false;  // Never detect inside whisper_full()
+    LOG_INFO("Multi-language auto-detection enabled (single-pass mode, fallback=en)");
   } else if (lang && strlen(lang) >= 2) {
     // Extract language code (e.g., "en" from "en-US")
     static char lang_code[3];
@@ -342,6 +838,30 @@ ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime) {
     "Only transcribe what is actually said. Output nothing during silence.";
   LOG_INFO("Using anti-hallucination prompt (prevents filler phrases)");
   
+  // Context carry: whisper ignores initial_prompt once prompt_tokens is set,
+  // so the prompt is tokenized once here and the carried tokens follow it
+  ctx->carry_context = ETHERVOX_WHISPER_CONTEXT_CARRY != 0;
+  if (ctx->carry_context) {
+    ctx->prompt_tokens = (whisper_token*)calloc(
+        WHISPER_PROMPT_BASE_MAX + ETHERVOX_WHISPER_PROMPT_MAX_TOKENS, sizeof(whisper_token));
+    int n_prompt = ctx->prompt_tokens
+                   ? whisper_tokenize(ctx->ctx, ctx->params.initial_prompt, ctx->prompt_tokens,
+                                      WHISPER_PROMPT_BASE_MAX)
+                   : -1;
+    if (n_prompt < 0) {
+      LOG_WARN("Could not tokenize initial prompt - context carry disabled");
+      free(ctx->prompt_tokens);
+      ctx->prompt_tokens = NULL;
+      ctx->carry_context = false;
+    } else {
+      ctx->prompt_base_tokens = n_prompt;
+      ctx->params.prompt_tokens = ctx->prompt_tokens;
+      ctx->params.prompt_n_tokens = n_prompt;
+      LOG_INFO("Context carry enabled (%d prompt + up to %d carried tokens)", n_prompt,
+               ETHERVOX_WHISPER_PROMPT_MAX_TOKENS);
+    }
+  }
+  
   // Advanced tuning for word-level accuracy
   ctx->params.split_on_word = true;     // Split segments on word boundaries (cleaner output)
   ctx->params.max_len = 0;              // No max length constraint (let speech flow naturally)
@@ -349,33 +869,39 @@ ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime) {
   
   // Streaming optimization (based on stream.cpp example)
   ctx->params.no_context = true;        // Reset context each chunk to avoid hallucination loops
+                                        // (the bounded carry goes in explicitly as prompt_tokens)
   ctx->params.single_segment = false;   // Allow multiple segments per chunk
   ctx->params.max_tokens = 0;           // No token limit (letting natural speech flow)
   ctx->params.max_len = 0;              // No segment length limit (natural segmentation)
   
   // DISABLE experimental VAD - it requires a separate VAD model we don't have
-  // We'll use time-based chunking instead (like stream.cpp default mode)
+  // Chunks are cut by our own energy endpointer (or every 3 seconds if disabled)
   ctx->params.vad = false;
-  LOG_INFO("Using time-based chunking with balanced anti-hallucination settings");
+  ctx->endpoint_mode = ETHERVOX_WHISPER_ENDPOINT_MODE != 0;
+  LOG_INFO("Using %s chunking with balanced anti-hallucination settings",
+           ctx->endpoint_mode ? "VAD-endpointed" : "time-based");
   
-  // Allocate main audio buffer (10 seconds @ 16kHz for chunk processing)
+  // Allocate the mirrored ring once: 10 seconds @ 16kHz for chunk processing
+  // plus 200ms of overlap (3200 samples) for context between chunks; with
+  // context carry the tokens provide continuity and the overlap shrinks
   ctx->audio_buffer_capacity = 16000 * 10;
-  ctx->audio_buffer = (float*)calloc(ctx->audio_buffer_capacity, sizeof(float));
-  if (!ctx->audio_buffer) {
-    whisper_free(ctx->ctx);
-    free(ctx);
-    return ETHERVOX_ERROR_OUT_OF_MEMORY;
-  }
-  
-  // Allocate overlap buffer (200ms @ 16kHz for context between chunks)
-  ctx->overlap_capacity = 16000 * 0.2;  // 200ms = 3200 samples
-  ctx->overlap_buffer = (float*)calloc(ctx->overlap_capacity, sizeof(float));
-  if (!ctx->overlap_buffer) {
-    free(ctx->audio_buffer);
-    whisper_free(ctx->ctx);
+  ctx->overlap_capacity = ctx->carry_context
+                          ? ETHERVOX_WHISPER_CARRY_OVERLAP_MS * WHISPER_SAMPLES_PER_MS
+                          : 16000 * 0.2;
+  ctx->ring_capacity = ctx->audio_buffer_capacity + ctx->overlap_capacity;
+  ctx->ring = (float*)calloc(ctx->ring_capacity * 2, sizeof(float));
+  ctx->pad_buffer = (float*)calloc(WHISPER_MIN_DECODE_SAMPLES, sizeof(float));
+  if (!ctx->ring || !ctx->pad_buffer) {
+    free(ctx->ring);
+    free(ctx->pad_buffer);
+    free(ctx->prompt_tokens);
+    release_model(ctx);
     free(ctx);
     return ETHERVOX_ERROR_OUT_OF_MEMORY;
   }
+  ctx->ring_write = 0;
+  ctx->chunk_start = 0;
+  ctx->audio_buffer_size = 0;
   ctx->overlap_size = 0;
   
   // Initialize duplicate detection
@@ -384,18 +910,54 @@ ethervox_result_t ethervox_stt_whisper_init(ethervox_stt_runtime_t* runtime) {
   
   // Initialize language re-detection
   ctx->segment_count = 0;
-  ctx->redetect_interval = 2;  // Re-detect language every 2 segments
+  ctx->redetect_interval = ETHERVOX_WHISPER_LANG_REDETECT_INTERVAL;
+  ctx->lang_detect_segment = 0;
+  ctx->lang_speaker = 0;
+  ctx->lang_probs = (float*)calloc((size_t)whisper_lang_max_id() + 1, sizeof(float));
+  if (!ctx->lang_probs) {
+    free(ctx->pad_buffer);
+    free(ctx->ring);
+    free(ctx->prompt_tokens);
+    release_model(ctx);
+    free(ctx);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
   
   // Initialize speaker tracking
   ctx->current_speaker = 0;
   ctx->show_speaker_labels = true;  // Always show speaker labels for better transcript clarity
-  ctx->last_segment_energy = 0.0f;
-  ctx->last_segment_pitch = 0.0f;
-  ctx->last_segment_end_time = 0;
-  ctx->first_segment = true;
+  ctx->diarizer = ethervox_diarizer_create(ETHERVOX_SPEAKER_MAX_SPEAKERS);
+  if (!ctx->diarizer) {
+    LOG_WARN("Speaker diarization unavailable - transcripts will use a single speaker label");
+  }
+  
+  // Initialize endpoint detection. Frames from the capture stream's VAD
+  // (ethervox_stt_process_frames) or the private fallback are judged by the
+  // STT's threshold, not the wake word's.
+  if (ctx->endpoint_mode) {
+    ethervox_vad_config_t vad_config = ethervox_vad_get_default_config();
+    if (runtime->config.vad_threshold > 0.0f && runtime->config.vad_threshold < 1.0f) {
+      vad_config.threshold = runtime->config.vad_threshold;
+    }
+    ctx->vad = ethervox_vad_create(&vad_config);
+    ctx->vad_threshold = vad_config.threshold;
+    ctx->vad_frame_samples = ethervox_vad_frame_samples(ctx->vad);
+    // Sized for 10 ms frames, the shortest the VAD supports
+    ctx->vad_queue_capacity = (uint32_t)(ctx->audio_buffer_capacity / (10 * WHISPER_SAMPLES_PER_MS)) + 64;
+    ctx->vad_queue = (whisper_vad_frame_t*)calloc(ctx->vad_queue_capacity, sizeof(whisper_vad_frame_t));
+    if (!ctx->vad || !ctx->vad_queue) {
+      LOG_WARN("VAD unavailable - falling back to time-based chunking");
+      ethervox_vad_destroy(ctx->vad);
+      free(ctx->vad_queue);
+      ctx->vad = NULL;
+      ctx->vad_queue = NULL;
+      ctx->endpoint_mode = false;
+    }
+  }
+  vad_restart(ctx);
   
   runtime->backend_context = ctx;
-  LOG_INFO("Whisper backend initialized with multi-language, timestamps, and acoustic speaker detection");
+  LOG_INFO("Whisper backend initialized with multi-language, timestamps, and speaker diarization");
   return ETHERVOX_SUCCESS;
 }
 
@@ -412,21 +974,21 @@ ethervox_result_t ethervox_stt_whisper_start(ethervox_stt_runtime_t* runtime) {
   
   // CRITICAL: Zero out buffer memory at start to ensure clean slate
   // This prevents any carryover from previous session
-  if (ctx->audio_buffer && ctx->audio_buffer_capacity > 0) {
-    memset(ctx->audio_buffer, 0, ctx->audio_buffer_capacity * sizeof(float));
-  }
-  if (ctx->overlap_buffer && ctx->overlap_capacity > 0) {
-    memset(ctx->overlap_buffer, 0, ctx->overlap_capacity * sizeof(float));
+  if (ctx->ring && ctx->ring_capacity > 0) {
+    memset(ctx->ring, 0, ctx->ring_capacity * 2 * sizeof(float));
   }
+  ctx->ring_write = 0;
+  ctx->chunk_start = 0;
   
   // Reset buffer sizes and speaker tracking
   ctx->audio_buffer_size = 0;
   ctx->overlap_size = 0;
   ctx->current_speaker = 0;  // Reset to Speaker 0 at session start
-  ctx->first_segment = true; // Reset first segment flag
-  ctx->last_segment_energy = 0.0f;
-  ctx->last_segment_pitch = 0.0f;
-  ctx->last_segment_end_time = 0;
+  ethervox_diarizer_reset(ctx->diarizer);
+  
+  // Reset endpoint detection
+  vad_restart(ctx);
+  reset_prompt_carry(ctx);
   
   // Clear duplicate detection
   if (ctx->last_transcript) {
@@ -440,13 +1002,17 @@ ethervox_result_t ethervox_stt_whisper_start(ethervox_stt_runtime_t* runtime) {
 
 /**
  * Process audio - STREAMING WITH OVERLAP
- * Based on whisper.cpp stream.cpp example:
+ * Endpoint mode (default):
+ * - Decode each utterance as soon as its trailing silence is seen
+ * - Silence is never decoded; leading/trailing silence is trimmed to 200ms
+ * - Utterances longer than the max-length guard are cut with 200ms overlap
+ * Time-based mode (ETHERVOX_WHISPER_ENDPOINT_MODE=0, whisper.cpp stream.cpp):
  * - Process every 3 seconds of audio
  * - Keep 200ms overlap for context continuity
- * - No experimental VAD, just time-based chunking
  */
 ethervox_result_t ethervox_stt_whisper_process(ethervox_stt_runtime_t* runtime,
                                   const ethervox_audio_buffer_t* audio_buffer,
+                                  const ethervox_vad_frame_t* frames, uint32_t frame_count,
                                   ethervox_stt_result_t* result) {
   ETHERVOX_CHECK_PTR(runtime);
   ETHERVOX_CHECK_PTR(runtime->backend_context);
@@ -457,7 +1023,7 @@ ethervox_result_t ethervox_stt_whisper_process(ethervox_stt_runtime_t* runtime,
   
   // CRITICAL: Validate buffers are allocated before processing
   // This can happen if stop() was called while process() is still running
-  if (!ctx->audio_buffer || !ctx->overlap_buffer || !ctx->ctx) {
+  if (!ctx->ring || !ctx->pad_buffer || !ctx->ctx) {
     LOG_WARN("Whisper buffers not initialized, skipping audio processing");
     return ETHERVOX_ERROR_STT_PROCESSING;
   }
@@ -475,236 +1041,152 @@ ethervox_result_t ethervox_stt_whisper_process(ethervox_stt_runtime_t* runtime,
     return 1;
   }
   
-  // Add samples to buffer
-  size_t samples_added = 0;
-  for (uint32_t i = 0; i < sample_count; i++) {
-    if (ctx->audio_buffer_size >= ctx->audio_buffer_capacity) {
-      LOG_WARN("Audio buffer overflow, processing early");
-      break;
-    }
-    ctx->audio_buffer[ctx->audio_buffer_size++] = samples[i];
-    samples_added++;
+  // Add samples to the ring
+  uint64_t append_at = ctx->ring_write;
+  size_t samples_added = ring_append(ctx, samples, sample_count);
+  if (samples_added < sample_count) {
+    LOG_WARN("Audio buffer overflow, processing early");
   }
   
   // Calculate audio energy to verify we're getting real audio (not silence)
-  float energy = 0.0f;
-  for (uint32_t i = 0; i < sample_count; i++) {
-    energy += samples[i] * samples[i];
-  }
-  energy = energy / sample_count;
+  float energy = block_energy(samples, sample_count, NULL) / (float)sample_count;
   
   LOG_DEBUG("[Whisper Process] Added %zu samples, buffer now: %zu samples (%.2fs), audio energy: %.6f",
             samples_added, ctx->audio_buffer_size, 
             (float)ctx->audio_buffer_size / 16000.0f, energy);
   
-  // Process when we have 3 seconds (stream.cpp uses step_ms=3000)
-  const size_t chunk_size = 16000 * 3;  // 3 seconds @ 16kHz
-  
-  if (ctx->audio_buffer_size < chunk_size) {
-    // Not enough audio yet - keep accumulating
-    LOG_DEBUG("[Whisper Process] Buffer not full yet (%zu/%zu samples), accumulating...",
-              ctx->audio_buffer_size, chunk_size);
-    return 1;
-  }
-  
-  LOG_INFO("[Whisper Process] Buffer threshold reached (%zu samples >= %zu), processing chunk...",
-           ctx->audio_buffer_size, chunk_size);
-  
-  // Prepare processing buffer: overlap + new audio
-  size_t total_samples = ctx->overlap_size + ctx->audio_buffer_size;
-  float* process_buffer = (float*)malloc(total_samples * sizeof(float));
-  if (!process_buffer) {
-    LOG_ERROR("Failed to allocate processing buffer");
-    return ETHERVOX_ERROR_STT_PROCESSING;
+  size_t decode_start = 0;
+  size_t decode_end = ctx->audio_buffer_size;
+  whisper_chunk_reason_t reason;
+  
+  if (ctx->endpoint_mode) {
+    vad_enqueue(ctx, audio_buffer, frames, frame_count, append_at, samples_added);
+    reason = endpoint_update(ctx, ctx->vad_frame_samples, &decode_start, &decode_end);
+    if (reason == WHISPER_CHUNK_PENDING) {
+      LOG_DEBUG("[Whisper Process] %s, accumulating (%zu samples buffered)...",
+                ctx->in_speech ? "Speech in progress" : "No speech", ctx->audio_buffer_size);
+      return 1;
+    }
+    LOG_INFO("[Whisper Process] %s, processing %.2fs utterance...",
+             reason == WHISPER_CHUNK_SPEECH_END ? "End of speech" : "Max utterance length reached",
+             (float)(decode_end - decode_start) / 16000.0f);
+  } else {
+    // Process when we have 3 seconds (stream.cpp uses step_ms=3000)
+    const size_t chunk_size = 16000 * 3;  // 3 seconds @ 16kHz
+    
+    if (ctx->audio_buffer_size < chunk_size) {
+      // Not enough audio yet - keep accumulating
+      LOG_DEBUG("[Whisper Process] Buffer not full yet (%zu/%zu samples), accumulating...",
+                ctx->audio_buffer_size, chunk_size);
+      return 1;
+    }
+    
+    LOG_INFO("[Whisper Process] Buffer threshold reached (%zu samples >= %zu), processing chunk...",
+             ctx->audio_buffer_size, chunk_size);
+    reason = WHISPER_CHUNK_TIME;
   }
   
-  // Copy overlap from previous chunk (provides context)
-  if (ctx->overlap_size > 0) {
-    memcpy(process_buffer, ctx->overlap_buffer, ctx->overlap_size * sizeof(float));
+  // Decode window: overlap + new audio, read in place from the ring
+  // (short commands are zero-padded in the preallocated pad buffer)
+  const size_t decode_len = decode_end - decode_start;
+  size_t total_samples = 0;
+  const float* process_buffer = decode_window(ctx, decode_start, decode_len, &total_samples);
+  
+  // Speaker features are extracted on the diarizer's thread while this one
+  // runs language detection and whisper_full over the same window
+  if (ctx->diarizer &&
+      ethervox_diarizer_submit(ctx->diarizer, process_buffer, (uint32_t)total_samples) != ETHERVOX_SUCCESS) {
+    LOG_WARN("Diarizer could not take this chunk - keeping the current speaker");
   }
   
-  // Copy new audio
-  memcpy(process_buffer + ctx->overlap_size, ctx->audio_buffer, 
-         ctx->audio_buffer_size * sizeof(float));
-  
   LOG_INFO("Processing %.1f seconds (%.1f overlap + %.1f new)...", 
            (float)total_samples / 16000.0f,
            (float)ctx->overlap_size / 16000.0f,
-           (float)ctx->audio_buffer_size / 16000.0f);
+           (float)decode_len / 16000.0f);
   
   // Log audio stats to verify data quality
   log_audio_stats(process_buffer, total_samples, "Before whisper_full");
   
-  // Periodic language re-detection for mid-conversation language changes
-  bool should_redetect = false;
-  if (ctx->auto_detect_language && ctx->redetect_interval > 0) {
+  // Language ID on this chunk's mel, only when the cached language is stale:
+  // first chunk, a new speaker turn, or every redetect_interval chunks.
+  // The turn is judged on this chunk's new audio, since segments are only
+  // assigned to speakers after whisper_full()
+  if (ctx->auto_detect_language) {
     ctx->segment_count++;
-    if (ctx->segment_count % ctx->redetect_interval == 0) {
-      should_redetect = true;
-      LOG_INFO("⟳ Segment %d: Re-detecting language (interval=%d)...", 
-               ctx->segment_count, ctx->redetect_interval);
-    }
-  }
-  
-  // Two-pass approach for multi-language support
-  // Pass 1 runs on: (a) first chunk, OR (b) periodic re-detection
-  if (ctx->auto_detect_language && (!ctx->language_detected || should_redetect)) {
-    // PASS 1: Detect language
-    if (!ctx->language_detected) {
-      LOG_INFO("Pass 1: Detecting language with %zu samples...", total_samples);
+    int speaker = ctx->current_speaker;
+    if (ctx->diarizer && total_samples > ctx->overlap_size) {
+      int id = ethervox_diarizer_identify(ctx->diarizer, (uint32_t)ctx->overlap_size,
+                                          (uint32_t)total_samples);
+      if (id != -1) speaker = id;
     }
-    
-    // Enable language detection for this pass only
-    ctx->params.detect_language = true;
-    
-    int ret_code = whisper_full(ctx->ctx, ctx->params, process_buffer, total_samples);
-    
-    // CRITICAL: Always disable detection after pass 1 to prevent error -4
-    // The detection flag MUST be false for the transcription pass
-    ctx->params.detect_language = false;
-    
-    if (ret_code != 0) {
-      LOG_ERROR("Language detection failed with code %d", ret_code);
-      free(process_buffer);
-      ctx->audio_buffer_size = 0;
-      return ETHERVOX_ERROR_STT_PROCESSING;
-    }
-    
-    // Get detected language
-    int lang_id = whisper_full_lang_id(ctx->ctx);
-    const char* detected_lang = whisper_lang_str(lang_id);
-    
-    // Validate detected language against Whisper's supported languages
-    // Common issue: "nn" (Norwegian Nynorsk) is not well-supported
-    // Whisper officially supports: en, zh, de, es, ru, ko, fr, ja, pt, tr, pl, ca, nl, ar, sv, it, id, hi, fi, vi, he, uk, el, ms, cs, ro, da, hu, ta, no, th, ur, hr, bg, lt, lv, bn, fa, sr, az, sl, kn, et, mk, br, eu, is, hy, ne, mn, bs, kk, sq, sw, gl, mr, pa, si, km, sn, yo, so, af, oc, ka, be, tg, sd, gu, am, yi, lo, uz, fo, ht, ps, tk, nn, mt, sa, lb, my, bo, tl, mg, as, tt, haw, ln, ha, ba, jw, su
-    // But multilingual models may not handle all variants well
-    
-    const char* safe_lang = NULL;
-    if (detected_lang && strlen(detected_lang) >= 2) {
-      // Map problematic language codes to safe alternatives
-      if (strcmp(detected_lang, "nn") == 0 || strcmp(detected_lang, "no") == 0) {
-        // Norwegian variants → use English (common issue with quiet audio)
-        safe_lang = "en";
-        LOG_WARN("⚠️  Detected Norwegian ('%s'), but switching to English (more reliable for quiet audio)", detected_lang);
-      } else if (strcmp(detected_lang, "mt") == 0 || strcmp(detected_lang, "sa") == 0 || 
-                 strcmp(detected_lang, "bo") == 0 || strcmp(detected_lang, "haw") == 0) {
-        // Rare languages that Whisper struggles with → fallback to English
-        safe_lang = "en";
-        LOG_WARN("⚠️  Detected rare language '%s', but switching to English (better model support)", detected_lang);
-      } else {
-        // Use detected language
-        safe_lang = detected_lang;
-      }
-      
-      // Check if language changed
-      bool lang_changed = false;
-      if (ctx->language_detected && strncmp(ctx->detected_language, safe_lang, 2) != 0) {
-        lang_changed = true;
-        LOG_INFO("🔄 Language changed: %s → %s", ctx->detected_language, safe_lang);
-      }
-      
-      strncpy(ctx->detected_language, safe_lang, 2);
-      ctx->detected_language[2] = '\0';
-      ctx->language_detected = true;
-      
-      if (!lang_changed) {
-        LOG_INFO("[OK] Detected language: %s (will use for next %d segments)", 
-                 ctx->detected_language, ctx->redetect_interval);
-      }
-      
-      // Update params for ALL future transcription passes
-      ctx->params.language = ctx->detected_language;
-      ctx->params.detect_language = false;  // Never detect during transcription
-    } else {
-      // Fallback to English if detection fails
-      if (!ctx->language_detected) {
-        strncpy(ctx->detected_language, "en", 2);
-        ctx->detected_language[2] = '\0';
-        ctx->language_detected = true;
-        ctx->params.language = ctx->detected_language;
-        ctx->params.detect_language = false;
-        LOG_WARN("Language detection failed, defaulting to English");
-      }
+    bool stale = !ctx->language_detected || speaker != ctx->lang_speaker ||
+                 (ctx->redetect_interval > 0 &&
+                  ctx->segment_count - ctx->lang_detect_segment >= ctx->redetect_interval);
+    if (stale) {
+      LOG_INFO("⟳ Chunk %d: Detecting language (speaker %d)...", ctx->segment_count, speaker);
+      detect_chunk_language(ctx, process_buffer, total_samples, speaker);
     }
   }
   
-  // PASS 2 (or single pass if language already known): Transcribe
+  // Single transcription pass
   LOG_INFO("Transcribing %zu samples in language: %s...", total_samples, ctx->params.language);
   LOG_DEBUG("whisper params: detect_language=%d, translate=%d, token_timestamps=%d",
             ctx->params.detect_language, ctx->params.translate, ctx->params.token_timestamps);
   
-  int ret_code = whisper_full(ctx->ctx, ctx->params, process_buffer, total_samples);
+  int ret_code = whisper_full_with_state(ctx->ctx, ctx->state, ctx->params, process_buffer, total_samples);
   
   if (ret_code != 0) {
     LOG_ERROR("whisper_full() failed with code %d", ret_code);
     
-    // Error code -4 typically means parameter mismatch or invalid config
-    // Try multiple recovery strategies
-    if (ret_code == -4) {
-      LOG_WARN("⚠️  Error -4 detected - attempting recovery strategies...");
-      
-      // Strategy 1: Disable language detection (it might be left on from pass 1)
-      if (ctx->params.detect_language) {
-        LOG_INFO("Recovery attempt 1: Disabling detect_language flag...");
-        ctx->params.detect_language = false;
-        ret_code = whisper_full(ctx->ctx, ctx->params, process_buffer, total_samples);
-        if (ret_code == 0) {
-          LOG_INFO("[OK] Recovery successful - detect_language flag was the issue");
-          goto transcription_success;
-        }
-        LOG_WARN("Recovery attempt 1 failed (code: %d)", ret_code);
-      }
-      
-      // Strategy 2: Force English language
-      if (strcmp(ctx->params.language, "en") != 0) {
-        LOG_INFO("Recovery attempt 2: Forcing English language...");
-        strncpy(ctx->detected_language, "en", 2);
-        ctx->detected_language[2] = '\0';
-        ctx->params.language = ctx->detected_language;
-        ctx->params.detect_language = false;
-        ret_code = whisper_full(ctx->ctx, ctx->params, process_buffer, total_samples);
-        if (ret_code == 0) {
-          LOG_INFO("[OK] Recovery successful - English language works");
-          goto transcription_success;
-        }
-        LOG_WARN("Recovery attempt 2 failed (code: %d)", ret_code);
-      }
-      
-      // Strategy 3: Disable translation (might conflict with language settings)
-      if (ctx->params.translate) {
-        LOG_INFO("Recovery attempt 3: Disabling translation...");
-        ctx->params.translate = false;
-        ret_code = whisper_full(ctx->ctx, ctx->params, process_buffer, total_samples);
-        if (ret_code == 0) {
-          LOG_INFO("[OK] Recovery successful - translation was conflicting");
-          goto transcription_success;
-        }
-        LOG_WARN("Recovery attempt 3 failed (code: %d)", ret_code);
+    // Error code -4 typically means parameter mismatch or invalid config.
+    // With detect_language always off, the likely culprit is a language /
+    // translation conflict: retry once with the safest settings.
+    bool can_retry = strcmp(ctx->params.language, "en") != 0 || ctx->params.translate;
+    if (ret_code == -4 && can_retry) {
+      LOG_WARN("⚠️  Error -4 detected - retrying in English without translation...");
+      strncpy(ctx->detected_language, "en", 2);
+      ctx->detected_language[2] = '\0';
+      ctx->params.language = ctx->detected_language;
+      ctx->params.translate = false;
+      ret_code = whisper_full_with_state(ctx->ctx, ctx->state, ctx->params, process_buffer, total_samples);
+      if (ret_code == 0) {
+        LOG_INFO("[OK] Recovery successful - English without translation works");
+        goto transcription_success;
       }
-      
-      // All recovery attempts failed
-      LOG_ERROR("❌ All recovery strategies failed - giving up on this chunk");
-      free(process_buffer);
-      ctx->audio_buffer_size = 0;
-      return ETHERVOX_ERROR_STT_PROCESSING;
-    } else {
-      // Non -4 error, not recoverable
-      free(process_buffer);
-      ctx->audio_buffer_size = 0;
-      return ETHERVOX_ERROR_STT_PROCESSING;
+      LOG_ERROR("❌ Recovery failed (code: %d) - giving up on this chunk", ret_code);
     }
+    
+    discard_chunk(ctx);
+    return ETHERVOX_ERROR_STT_PROCESSING;
   }
   
 transcription_success:
   ; // Empty statement to satisfy C standard (labels must be followed by a statement)
   
+  // Hallucination guards: carried tokens are the usual cause of a repetition
+  // loop, so degenerate output is re-decoded once without them
+  if (ctx->carry_context && whisper_full_n_segments_from_state(ctx->state) > 0 &&
+      chunk_output_degenerate(ctx)) {
+    bool redecoded = false;
+    if (ctx->params.prompt_n_tokens > ctx->prompt_base_tokens) {
+      LOG_WARN("Re-decoding chunk without carried context...");
+      reset_prompt_carry(ctx);
+      redecoded = whisper_full_with_state(ctx->ctx, ctx->state, ctx->params, process_buffer, total_samples) == 0;
+    }
+    if (!redecoded || chunk_output_degenerate(ctx)) {
+      LOG_WARN("Dropping degenerate transcript");
+      reset_prompt_carry(ctx);
+      goto save_overlap_no_cleanup;
+    }
+  }
+  
   // Get segments
-  const int n_segments = whisper_full_n_segments(ctx->ctx);
+  const int n_segments = whisper_full_n_segments_from_state(ctx->state);
   LOG_INFO("Got %d segments from chunk", n_segments);
   
   if (n_segments == 0) {
     LOG_DEBUG("No segments detected - continuing to accumulate");
-    // Skip directly to overlap saving (no speaker_turns allocated yet)
+    // Skip directly to overlap saving (no speakers allocated yet)
     goto save_overlap_no_cleanup;
   }
   
@@ -718,11 +1200,10 @@ transcription_success:
   // Only process segments that start AFTER the overlap portion
   const int64_t overlap_time_threshold = (int64_t)(ctx->overlap_size * 100.0f / 16000.0f);
   
-  // Store speaker turn flags for each segment
-  bool* speaker_turns = (bool*)calloc(n_segments, sizeof(bool));
-  if (!speaker_turns) {
-    free(process_buffer);
-    ctx->audio_buffer_size = 0;
+  // Speaker ID of each segment
+  int* speakers = (int*)calloc(n_segments, sizeof(int));
+  if (!speakers) {
+    discard_chunk(ctx);
     return ETHERVOX_ERROR_STT_PROCESSING;
   }
   
@@ -730,7 +1211,7 @@ transcription_success:
   const float sample_rate = 16000.0f;
   
   for (int i = 0; i < n_segments; i++) {
-    const char* text = whisper_full_get_segment_text(ctx->ctx, i);
+    const char* text = whisper_full_get_segment_text_from_state(ctx->state, i);
     
     // Validate pointer before any access (whisper.cpp bug: sometimes returns invalid low addresses)
     if (!whisper_text_ptr_valid(text)) {
@@ -747,8 +1228,8 @@ transcription_success:
       }
     }
     
-    int64_t t0 = whisper_full_get_segment_t0(ctx->ctx, i);
-    int64_t t1 = whisper_full_get_segment_t1(ctx->ctx, i);
+    int64_t t0 = whisper_full_get_segment_t0_from_state(ctx->state, i);
+    int64_t t1 = whisper_full_get_segment_t1_from_state(ctx->state, i);
     
     // Skip segments that are entirely within the overlap region (duplicates)
     if (ctx->overlap_size > 0 && t1 <= overlap_time_threshold) {
@@ -757,59 +1238,54 @@ transcription_success:
       continue;
     }
     
-    // Detect speaker change using acoustic analysis
-    bool speaker_turn = false;
-    if (!ctx->first_segment) {
-      // Convert timestamps (10ms units) to sample indices
-      size_t seg_start = (size_t)(t0 * sample_rate / 100.0f);
-      size_t seg_end = (size_t)(t1 * sample_rate / 100.0f);
-      
-      // Ensure bounds are within buffer
-      if (seg_start < total_samples && seg_end <= total_samples && seg_end > seg_start) {
-        speaker_turn = detect_speaker_change(ctx, process_buffer, seg_start, seg_end, t0, t1);
-      }
-    } else {
-      // First segment: initialize tracking
-      size_t seg_start = (size_t)(t0 * sample_rate / 100.0f);
-      size_t seg_end = (size_t)(t1 * sample_rate / 100.0f);
-      if (seg_start < total_samples && seg_end <= total_samples && seg_end > seg_start) {
-        ctx->last_segment_energy = calculate_energy(process_buffer, seg_start, seg_end);
-        ctx->last_segment_pitch = estimate_pitch(process_buffer, seg_start, seg_end);
-        ctx->last_segment_end_time = t1;
-      }
-      ctx->first_segment = false;
+    // Cluster the segment against the speakers heard so far; segments with
+    // too little speech to judge stay with the current speaker
+    int speaker = -1;
+    size_t seg_start = (size_t)(t0 * sample_rate / 100.0f);
+    size_t seg_end = (size_t)(t1 * sample_rate / 100.0f);
+    if (seg_end > total_samples) seg_end = total_samples;
+    if (ctx->diarizer && seg_end > seg_start) {
+      speaker = ethervox_diarizer_assign(ctx->diarizer, (uint32_t)seg_start, (uint32_t)seg_end);
     }
-    
-    // Store the speaker turn flag for this segment
-    speaker_turns[i] = speaker_turn;
+    if (speaker < 0) speaker = ctx->current_speaker;
+    bool speaker_turn = speaker != ctx->current_speaker;
+    if (speaker_turn) {
+      LOG_INFO("🎙️ Speaker turn: Speaker %d → Speaker %d", ctx->current_speaker, speaker);
+    }
+    ctx->current_speaker = speaker;
+    speakers[i] = speaker;
     
     if (i == 0) first_t0 = t0;
     last_t1 = t1;
     if (speaker_turn) has_speaker_change = true;
     
     // Don't log text content or call strlen - text pointer may be invalid
-    LOG_DEBUG("Segment %d: [%.2fs -> %.2fs] speaker_turn=%d has_text=%d", 
-              i, t0/100.0f, t1/100.0f, speaker_turn, text != NULL ? 1 : 0);
+    LOG_DEBUG("Segment %d: [%.2fs -> %.2fs] speaker=%d has_text=%d", 
+              i, t0/100.0f, t1/100.0f, speaker, text != NULL ? 1 : 0);
     
     // Only add to total_len if we have valid text (after safety check)
     if (text) {
       size_t text_len = safe_strnlen(text, 65536);
       total_len += text_len + 1;
-      if (speaker_turn && i < n_segments - 1) {
+      if (ctx->show_speaker_labels || speaker_turn) {
         total_len += 20;  // Space for "[Speaker X: " markers
       }
     }
   }
   
+  // A voice first heard in this chunk now has the ID it was enrolled under
+  if (ctx->lang_speaker == ETHERVOX_DIARIZER_NEW_SPEAKER) {
+    ctx->lang_speaker = ctx->current_speaker;
+  }
+  
   LOG_INFO("Total %d segments, length=%zu, time=[%.2fs -> %.2fs], speaker_changes=%d", 
            n_segments, total_len, first_t0/100.0f, last_t1/100.0f, has_speaker_change);
   
   // Allocate transcript buffer (even if empty, we need it for duplicate detection)
   char* transcript = (char*)calloc(total_len + 200, 1);  // Extra space for speaker markers
   if (!transcript) {
-    free(speaker_turns);
-    free(process_buffer);
-    ctx->audio_buffer_size = 0;
+    free(speakers);
+    discard_chunk(ctx);
     return ETHERVOX_ERROR_STT_PROCESSING;
   }
   
@@ -820,7 +1296,7 @@ transcription_success:
     
     // Track speaker changes across this chunk
     for (int i = 0; i < n_segments; i++) {
-      const char* text = whisper_full_get_segment_text(ctx->ctx, i);
+      const char* text = whisper_full_get_segment_text_from_state(ctx->state, i);
       
       // Validate pointer before any access
       if (!whisper_text_ptr_valid(text)) {
@@ -833,16 +1309,17 @@ transcription_success:
           text = NULL;
         }
       }
-      int64_t t0 = whisper_full_get_segment_t0(ctx->ctx, i);
-      int64_t t1 = whisper_full_get_segment_t1(ctx->ctx, i);
+      int64_t t0 = whisper_full_get_segment_t0_from_state(ctx->state, i);
+      int64_t t1 = whisper_full_get_segment_t1_from_state(ctx->state, i);
       
       // Skip segments in overlap region
       if (ctx->overlap_size > 0 && t1 <= overlap_time_threshold) {
         continue;
       }
       
-      // Use the speaker turn flag we calculated earlier
-      bool speaker_turn = speaker_turns[i];
+      // Use the speaker we assigned earlier
+      int speaker = speakers[i];
+      bool speaker_turn = i > 0 && speaker != speakers[i - 1];
       
       if (text) {
         size_t text_len = safe_strnlen(text, 65536);
@@ -857,7 +1334,7 @@ transcription_success:
         if (ctx->show_speaker_labels || (speaker_turn && has_speaker_change)) {
           // Ensure we have space for speaker label (max 20 chars for "[Speaker 999] ")
           if (current_pos + 20 < total_len + 200) {
-            int written = snprintf(transcript + current_pos, 30, "[Speaker %d] ", ctx->current_speaker);
+            int written = snprintf(transcript + current_pos, 30, "[Speaker %d] ", speaker);
             if (written > 0 && written < 30) current_pos += written;
           }
         }
@@ -872,12 +1349,7 @@ transcription_success:
           LOG_WARN("Buffer overflow prevented: current_pos=%zu text_len=%zu total=%zu", current_pos, text_len, total_len);
           break; // Stop adding more segments
         }
-        
-        // Update speaker ID if there's a turn detected
-        if (speaker_turn) {
-          ctx->current_speaker++;  // Increment to next speaker ID
-          LOG_DEBUG("Speaker turn detected → now Speaker %d", ctx->current_speaker);
-        }
+
       }
   }
   
@@ -904,6 +1376,9 @@ transcription_success:
     result->start_time_us = first_t0 * 10000;
     result->end_time_us = last_t1 * 10000;
     
+    // Feed this chunk's final tokens to the next one
+    carry_prompt_tokens(ctx);
+    
     // Return result
     result->text = transcript;
     result->confidence = 0.9f;
@@ -922,26 +1397,25 @@ transcription_success:
   }
   
 save_overlap:
-  free(speaker_turns);  // Clean up speaker turn flags array
+  free(speakers);  // Clean up per-segment speaker IDs
   
 save_overlap_no_cleanup:
   ; // Empty statement for label
   
-  // Save last 200ms of audio as overlap for next chunk (context continuity)
-  ctx->overlap_size = (ctx->audio_buffer_size > ctx->overlap_capacity) 
-                      ? ctx->overlap_capacity 
-                      : ctx->audio_buffer_size;
-  
-  if (ctx->overlap_size > 0) {
-    memcpy(ctx->overlap_buffer, 
-           ctx->audio_buffer + ctx->audio_buffer_size - ctx->overlap_size,
-           ctx->overlap_size * sizeof(float));
+  if (reason == WHISPER_CHUNK_SPEECH_END) {
+    // A finished utterance needs no carry-over: the next one starts after silence
+    consume_audio(ctx, ctx->vad_pos);
+    vad_reset(ctx);
+    ctx->overlap_size = 0;
+  } else {
+    // Clear main buffer for next chunk (a cut utterance stays open); its last
+    // 200ms stay in the ring right before chunk_start as overlap
+    consume_audio(ctx, decode_end);
+    ctx->overlap_size = (decode_len > ctx->overlap_capacity) 
+                        ? ctx->overlap_capacity 
+                        : decode_len;
   }
   
-  // Clear main buffer for next chunk
-  ctx->audio_buffer_size = 0;
-  free(process_buffer);
-  
   return (result->text && strlen(result->text) > 0) ? 0 : 1;
 }
 
@@ -956,7 +1430,7 @@ ethervox_result_t ethervox_stt_whisper_finalize(ethervox_stt_runtime_t* runtime,
   whisper_backend_context_t* ctx = (whisper_backend_context_t*)runtime->backend_context;
   
   // CRITICAL: Check if buffers are still valid (might be NULL if stop() was called)
-  if (!ctx->audio_buffer || !ctx->ctx) {
+  if (!ctx->ring || !ctx->pad_buffer || !ctx->ctx) {
     LOG_WARN("Finalize called but buffers already cleaned up");
     result->text = strdup("");
     result->is_final = true;
@@ -973,22 +1447,37 @@ ethervox_result_t ethervox_stt_whisper_finalize(ethervox_stt_runtime_t* runtime,
             ctx->overlap_size, (float)ctx->overlap_size / 16000.0f);
   LOG_DEBUG("[Whisper Finalize] ========================================");
   
+  // Endpoint mode: only an open utterance is worth decoding, trimmed like in process()
+  size_t remaining_start = 0;
+  size_t remaining_len = ctx->audio_buffer_size;
+  if (ctx->endpoint_mode) {
+    const size_t pad = ETHERVOX_WHISPER_VAD_PAD_MS * WHISPER_SAMPLES_PER_MS;
+    if (!ctx->in_speech || ctx->speech_end == 0) {
+      LOG_DEBUG("[Whisper Finalize] No open utterance, dropping %zu buffered samples",
+                ctx->audio_buffer_size);
+      remaining_len = 0;
+      ctx->overlap_size = 0;
+    } else {
+      size_t end = ctx->speech_end + pad < ctx->audio_buffer_size
+                   ? ctx->speech_end + pad : ctx->audio_buffer_size;
+      remaining_start = ctx->speech_start > pad ? ctx->speech_start - pad : 0;
+      remaining_len = end - remaining_start;
+    }
+  }
+  
   // CRITICAL: Process remaining audio WITH overlap (just like during normal processing)
   // This ensures we don't lose context from the previous chunk
-  size_t total_samples = ctx->overlap_size + ctx->audio_buffer_size;
+  size_t total_samples = (remaining_start == 0 ? ctx->overlap_size : 0) + remaining_len;
   
   LOG_INFO("[Whisper Finalize] Total samples to process: %zu (%.2fs)",
            total_samples, (float)total_samples / 16000.0f);
   
   if (total_samples > 0) { // Process any remaining audio
-    // Pad short audio to minimum chunk size (0.5 seconds = 8000 samples)
-    const size_t min_chunk_size = 8000;
-    size_t padded_size = total_samples;
-    bool needs_padding = false;
-    
-    if (total_samples < min_chunk_size) {
-      padded_size = min_chunk_size;
-      needs_padding = true;
+    // Window read in place from the ring; short audio is zero-padded to the
+    // minimum whisper_full() accepts
+    size_t padded_size = 0;
+    const float* process_buffer = decode_window(ctx, remaining_start, remaining_len, &padded_size);
+    if (padded_size > total_samples) {
       LOG_INFO("Finalizing with padding: %.1fs audio -> %.1fs (padded with zeros)",
                (float)total_samples / 16000.0f,
                (float)padded_size / 16000.0f);
@@ -996,52 +1485,26 @@ ethervox_result_t ethervox_stt_whisper_finalize(ethervox_stt_runtime_t* runtime,
       LOG_INFO("Finalizing with %.1f seconds total (%.1f overlap + %.1f new)", 
                (float)total_samples / 16000.0f,
                (float)ctx->overlap_size / 16000.0f,
-               (float)ctx->audio_buffer_size / 16000.0f);
-    }
-    
-    // Prepare processing buffer: overlap + remaining audio + padding
-    float* process_buffer = (float*)malloc(padded_size * sizeof(float));
-    if (!process_buffer) {
-      LOG_ERROR("Failed to allocate finalize processing buffer");
-      result->text = strdup("");
-      result->is_final = true;
-      return 0;
-    }
-    
-    // Copy overlap from previous chunk
-    if (ctx->overlap_size > 0) {
-      memcpy(process_buffer, ctx->overlap_buffer, ctx->overlap_size * sizeof(float));
-    }
-    
-    // Copy remaining audio
-    if (ctx->audio_buffer_size > 0) {
-      memcpy(process_buffer + ctx->overlap_size, ctx->audio_buffer, 
-             ctx->audio_buffer_size * sizeof(float));
-    }
-    
-    // Pad with zeros if needed
-    if (needs_padding) {
-      memset(process_buffer + total_samples, 0, (padded_size - total_samples) * sizeof(float));
-      LOG_INFO("Padded %zu samples with zeros", padded_size - total_samples);
+               (float)remaining_len / 16000.0f);
     }
     
     log_audio_stats(process_buffer, padded_size, "Finalize audio stats (with overlap and padding)");
     
-    if (whisper_full(ctx->ctx, ctx->params, process_buffer, padded_size) == 0) {
-      const int n_segments = whisper_full_n_segments(ctx->ctx);
+    if (whisper_full_with_state(ctx->ctx, ctx->state, ctx->params, process_buffer, padded_size) == 0) {
+      const int n_segments = whisper_full_n_segments_from_state(ctx->state);
       LOG_INFO("Finalize produced %d segment(s)", n_segments);
       
       if (n_segments > 0) {
         size_t total_len = 0;
         for (int i = 0; i < n_segments; i++) {
-          total_len += strlen(whisper_full_get_segment_text(ctx->ctx, i)) + 1;
+          total_len += strlen(whisper_full_get_segment_text_from_state(ctx->state, i)) + 1;
         }
         
         result->text = (char*)calloc(total_len + 10, 1);
         if (result->text) {
           for (int i = 0; i < n_segments; i++) {
             if (i > 0) strcat(result->text, " ");
-            strcat(result->text, whisper_full_get_segment_text(ctx->ctx, i));
+            strcat(result->text, whisper_full_get_segment_text_from_state(ctx->state, i));
           }
           LOG_INFO("Finalize extracted: '%s'", result->text);
         }
@@ -1049,17 +1512,15 @@ ethervox_result_t ethervox_stt_whisper_finalize(ethervox_stt_runtime_t* runtime,
     } else {
       LOG_WARN("Whisper finalize processing failed");
     }
-    
-    free(process_buffer);
-    
-    // CRITICAL: Clear the buffer sizes after processing
-    // Buffer memory will be zeroed by stop() function
-    ctx->audio_buffer_size = 0;
-    ctx->overlap_size = 0;
   } else {
     LOG_INFO("Finalize: No remaining audio to process");
   }
   
+  // CRITICAL: Clear the buffer sizes after processing
+  // Buffer memory will be zeroed by stop() function
+  discard_chunk(ctx);
+  ctx->overlap_size = 0;
+  
   if (!result->text) {
     result->text = strdup("");
   }
@@ -1076,12 +1537,11 @@ void ethervox_stt_whisper_stop(ethervox_stt_runtime_t* runtime) {
   whisper_backend_context_t* ctx = (whisper_backend_context_t*)runtime->backend_context;
   
   // CRITICAL: Zero out buffer memory to prevent any carryover
-  if (ctx->audio_buffer && ctx->audio_buffer_capacity > 0) {
-    memset(ctx->audio_buffer, 0, ctx->audio_buffer_capacity * sizeof(float));
-  }
-  if (ctx->overlap_buffer && ctx->overlap_capacity > 0) {
-    memset(ctx->overlap_buffer, 0, ctx->overlap_capacity * sizeof(float));
+  if (ctx->ring && ctx->ring_capacity > 0) {
+    memset(ctx->ring, 0, ctx->ring_capacity * 2 * sizeof(float));
   }
+  ctx->ring_write = 0;
+  ctx->chunk_start = 0;
   
   // Clear buffer sizes
   ctx->audio_buffer_size = 0;
@@ -1089,10 +1549,11 @@ void ethervox_stt_whisper_stop(ethervox_stt_runtime_t* runtime) {
   
   // Reset speaker tracking
   ctx->current_speaker = 0;
-  ctx->first_segment = true;
-  ctx->last_segment_energy = 0.0f;
-  ctx->last_segment_pitch = 0.0f;
-  ctx->last_segment_end_time = 0;
+  ethervox_diarizer_reset(ctx->diarizer);
+  
+  // Reset endpoint detection
+  vad_restart(ctx);
+  reset_prompt_carry(ctx);
   
   // Clear duplicate detection
   if (ctx->last_transcript) {
@@ -1116,20 +1577,23 @@ ethervox_result_t ethervox_stt_whisper_set_language(ethervox_stt_runtime_t* runt
   whisper_backend_context_t* ctx = (whisper_backend_context_t*)runtime->backend_context;
   
   if (!language || strcmp(language, "auto") == 0 || strcmp(language, "AUTO") == 0) {
-    ctx->params.detect_language = true;
-    ctx->params.language = "auto";
+    // Detection happens per chunk; keep transcribing in the cached language until then
+    ctx->auto_detect_language = true;
+    ctx->language_detected = false;
     LOG_INFO("Language set to auto-detect");
   } else if (strlen(language) >= 2) {
-    ctx->params.detect_language = false;
-    static char lang_code[3];
-    lang_code[0] = language[0];
-    lang_code[1] = language[1];
-    lang_code[2] = '\0';
-    ctx->params.language = lang_code;
-    LOG_INFO("Language set to: %s", lang_code);
+    ctx->auto_detect_language = false;
+    ctx->language_detected = true;
+    ctx->detected_language[0] = language[0];
+    ctx->detected_language[1] = language[1];
+    ctx->detected_language[2] = '\0';
+    LOG_INFO("Language set to: %s", ctx->detected_language);
   } else {
     return -1;
   }
+  ctx->params.language = ctx->detected_language;
+  ctx->params.detect_language = false;
+  reset_prompt_carry(ctx);
   
   return 0;
 }
@@ -1142,10 +1606,15 @@ void ethervox_stt_whisper_cleanup(ethervox_stt_runtime_t* runtime) {
   
   whisper_backend_context_t* ctx = (whisper_backend_context_t*)runtime->backend_context;
   
-  if (ctx->ctx) whisper_free(ctx->ctx);
-  if (ctx->audio_buffer) free(ctx->audio_buffer);
-  if (ctx->overlap_buffer) free(ctx->overlap_buffer);
+  release_model(ctx);
+  if (ctx->ring) free(ctx->ring);
+  if (ctx->pad_buffer) free(ctx->pad_buffer);
+  if (ctx->prompt_tokens) free(ctx->prompt_tokens);
   if (ctx->last_transcript) free(ctx->last_transcript);
+  if (ctx->lang_probs) free(ctx->lang_probs);
+  ethervox_diarizer_destroy(ctx->diarizer);
+  ethervox_vad_destroy(ctx->vad);
+  free(ctx->vad_queue);
   
   free(ctx);
   runtime->backend_context = NULL;
@@ -1166,8 +1635,9 @@ ethervox_result_t ethervox_stt_whisper_start(ethervox_stt_runtime_t* runtime) {
 
 ethervox_result_t ethervox_stt_whisper_process(ethervox_stt_runtime_t* runtime,
                                   const ethervox_audio_buffer_t* audio_buffer,
+                                  const ethervox_vad_frame_t* frames, uint32_t frame_count,
                                   ethervox_stt_result_t* result) {
-  (void)runtime; (void)audio_buffer; (void)result;
+  (void)runtime; (void)audio_buffer; (void)frames; (void)frame_count; (void)result;
   return ETHERVOX_ERROR_NOT_SUPPORTED;
 }
 
@@ -1184,4 +1654,13 @@ void ethervox_stt_whisper_cleanup(ethervox_stt_runtime_t* runtime) {
   (void)runtime;
 }
 
+void* ethervox_stt_whisper_load_model(const char* model_path) {
+  (void)model_path;
+  return NULL;
+}
+
+void ethervox_stt_whisper_free_model(void* model) {
+  (void)model;
+}
+
 #endif // WHISPER_CPP_AVAILABLE
@@ -0,0 +1,912 @@
+/**
+ * @file whisper_offline.c
+ * @brief Parallel offline Whisper transcription of recorded audio
+ *
+ * The recording is split at VAD silences into spans of up to one encoder
+ * window. Each worker thread owns a whisper_state created from a shared
+ * whisper_context and pulls spans longest-first from a common queue; every
+ * span writes into its own output slot, so stitching is a walk in
+ * recording order.
+ *
+ * A decoder (ethervox_stt_offline_decoder_create) runs the same span
+ * decoding on one whisper_state kept between calls, for callers that decode
+ * many short clips and cannot afford a state allocation per clip.
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "ethervox/stt_offline.h"
+#include "ethervox/stt.h"
+#include "ethervox/error.h"
+#include "ethervox/logging.h"
+#include "ethervox/config.h"
+#include "ethervox/dsp.h"
+#include "ethervox/vad.h"
+
+#ifdef WHISPER_CPP_AVAILABLE
+#include "whisper.h"
+#endif
+
+#define LOG_ERROR(...) ethervox_log(ETHERVOX_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, __VA_ARGS__)
+#define LOG_WARN(...)  ethervox_log(ETHERVOX_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__, __VA_ARGS__)
+#define LOG_INFO(...)  ethervox_log(ETHERVOX_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, __VA_ARGS__)
+#define LOG_DEBUG(...) ethervox_log(ETHERVOX_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__, __VA_ARGS__)
+
+#define OFFLINE_SAMPLE_RATE 16000
+#define OFFLINE_SAMPLES_PER_MS 16
+#define OFFLINE_NOISE_PERCENTILE 10  // Frame RMS percentile taken as the noise floor
+#define OFFLINE_LOUD_PERCENTILE 99   // Frame RMS percentile taken as the loudest speech
+
+ethervox_stt_offline_config_t ethervox_stt_offline_get_default_config(void) {
+  ethervox_stt_offline_config_t config = {
+    .model_path = NULL,
+    .language = "auto",
+    .translate_to_english = false,
+    .workers = 0,
+    .threads_per_worker = ETHERVOX_WHISPER_OFFLINE_THREADS_PER_WORKER,
+    .max_segment_ms = ETHERVOX_WHISPER_OFFLINE_MAX_SEGMENT_MS,
+    .min_silence_ms = ETHERVOX_WHISPER_OFFLINE_MIN_SILENCE_MS,
+  };
+  return config;
+}
+
+// ============================================================================
+// VAD SPLITTING
+// ============================================================================
+
+typedef struct {
+  uint32_t start;  // First frame
+  uint32_t end;    // One past the last frame
+} frame_run_t;
+
+static int compare_float(const void* a, const void* b) {
+  float fa = *(const float*)a;
+  float fb = *(const float*)b;
+  return (fa > fb) - (fa < fb);
+}
+
+/**
+ * Index of the quietest frame in [from, to)
+ */
+static uint32_t quietest_frame(const float* rms, uint32_t from, uint32_t to) {
+  uint32_t best = from;
+  for (uint32_t f = from + 1; f < to; f++) {
+    if (rms[f] < rms[best]) {
+      best = f;
+    }
+  }
+  return best;
+}
+
+ethervox_result_t ethervox_stt_offline_split(const float* samples, uint32_t sample_count,
+                                             uint32_t max_segment_ms, uint32_t min_silence_ms,
+                                             ethervox_stt_offline_span_t** spans,
+                                             uint32_t* span_count) {
+  ETHERVOX_CHECK_PTR(samples);
+  ETHERVOX_CHECK_PTR(spans);
+  ETHERVOX_CHECK_PTR(span_count);
+  *spans = NULL;
+  *span_count = 0;
+  if (max_segment_ms < ETHERVOX_VAD_FRAME_MS) {
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+  if (sample_count == 0) {
+    return ETHERVOX_SUCCESS;
+  }
+
+  const uint32_t frame = ETHERVOX_VAD_FRAME_MS * OFFLINE_SAMPLES_PER_MS;
+  const uint32_t n_frames = (sample_count + frame - 1) / frame;
+
+  // rms[0..n) per frame, rms[n..2n) sorted copy for the floor estimate
+  float* rms = (float*)malloc(2 * (size_t)n_frames * sizeof(float));
+  frame_run_t* runs = (frame_run_t*)malloc((size_t)n_frames * sizeof(frame_run_t));
+  if (!rms || !runs) {
+    free(rms);
+    free(runs);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  // Frame energies from the shared VAD kernel; the whole recording is known,
+  // so the floor comes from its percentiles rather than the streaming tracker
+  for (uint32_t f = 0; f < n_frames; f++) {
+    uint32_t begin = f * frame;
+    uint32_t n = sample_count - begin < frame ? sample_count - begin : frame;
+    ethervox_vad_frame_t features;
+    ethervox_vad_frame_features(samples + begin, n, begin > 0 ? samples[begin - 1] : 0.0f, &features);
+    rms[f] = features.rms;
+  }
+  memcpy(rms + n_frames, rms, (size_t)n_frames * sizeof(float));
+  qsort(rms + n_frames, n_frames, sizeof(float), compare_float);
+  float noise_floor = rms[n_frames + (uint64_t)n_frames * OFFLINE_NOISE_PERCENTILE / 100];
+  float loud = rms[n_frames + (uint64_t)n_frames * OFFLINE_LOUD_PERCENTILE / 100];
+  float threshold = noise_floor * ETHERVOX_VAD_SPEECH_RATIO;
+  // Without quiet stretches to calibrate against (dense speech or steady
+  // noise) everything audible is decoded rather than risk dropping speech
+  if (threshold > loud || threshold < ETHERVOX_VAD_MIN_RMS) {
+    threshold = ETHERVOX_VAD_MIN_RMS;
+  }
+
+  uint32_t min_gap = (min_silence_ms + ETHERVOX_VAD_FRAME_MS - 1) / ETHERVOX_VAD_FRAME_MS;
+  if (min_gap == 0) {
+    min_gap = 1;
+  }
+  const uint32_t min_speech = ETHERVOX_WHISPER_VAD_MIN_SPEECH_MS / ETHERVOX_VAD_FRAME_MS;
+  const uint32_t max_frames = max_segment_ms / ETHERVOX_VAD_FRAME_MS;
+  uint32_t pad = ETHERVOX_WHISPER_VAD_PAD_MS / ETHERVOX_VAD_FRAME_MS;
+  if (pad > max_frames / 4) {
+    pad = max_frames / 4;
+  }
+  const uint32_t piece_max = max_frames - 2 * pad;  // Longest run that still fits once padded
+
+  // Pass 1: speech runs, bridging pauses shorter than min_gap; runs longer
+  // than a segment are cut at their quietest frame in the second half
+  uint32_t n_runs = 0;
+  uint32_t f = 0;
+  while (f < n_frames) {
+    if (rms[f] <= threshold) {
+      f++;
+      continue;
+    }
+    uint32_t start = f;
+    uint32_t end = f + 1;
+    uint32_t voiced = 1;
+    uint32_t g = f + 1;
+    while (g < n_frames && g - end < min_gap) {
+      if (rms[g] > threshold) {
+        end = g + 1;
+        voiced++;
+      }
+      g++;
+    }
+    f = g;
+    if (voiced < min_speech) {
+      continue;  // Click or burst
+    }
+    while (end - start > piece_max) {
+      uint32_t cut = quietest_frame(rms, start + piece_max / 2 + 1, start + piece_max);
+      runs[n_runs++] = (frame_run_t){ start, cut };
+      start = cut;
+    }
+    runs[n_runs++] = (frame_run_t){ start, end };
+  }
+
+  // Pass 2: pad runs and pack neighbours into spans of up to max_frames;
+  // padding never crosses the midpoint of the pause to the next run
+  ethervox_stt_offline_span_t* out = NULL;
+  uint32_t n_out = 0;
+  if (n_runs > 0) {
+    out = (ethervox_stt_offline_span_t*)malloc((size_t)n_runs * sizeof(*out));
+    if (!out) {
+      free(rms);
+      free(runs);
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+  }
+  uint32_t prev_end = 0;
+  for (uint32_t i = 0; i < n_runs;) {
+    uint32_t seg_start = runs[i].start > pad ? runs[i].start - pad : 0;
+    if (seg_start < prev_end) {
+      seg_start = prev_end;
+    }
+    uint32_t j = i;
+    while (j + 1 < n_runs && runs[j + 1].end + pad - seg_start <= max_frames) {
+      j++;
+    }
+    uint32_t seg_end = runs[j].end + pad;
+    if (j + 1 < n_runs) {
+      uint32_t mid = runs[j].end + (runs[j + 1].start - runs[j].end) / 2;
+      if (seg_end > mid) {
+        seg_end = mid;
+      }
+    }
+    if (seg_end > n_frames) {
+      seg_end = n_frames;
+    }
+
+    uint32_t first = seg_start * frame;
+    uint32_t last = (uint64_t)seg_end * frame < sample_count ? seg_end * frame : sample_count;
+    out[n_out++] = (ethervox_stt_offline_span_t){ first, last - first };
+    prev_end = seg_end;
+    i = j + 1;
+  }
+
+  LOG_DEBUG("VAD split: %u frames, floor=%.5f threshold=%.5f, %u runs -> %u spans", n_frames,
+            noise_floor, threshold, n_runs, n_out);
+  free(rms);
+  free(runs);
+  *spans = out;
+  *span_count = n_out;
+  return ETHERVOX_SUCCESS;
+}
+
+// ============================================================================
+// WAV LOADING
+// ============================================================================
+
+/**
+ * Load a 16 kHz 16-bit PCM WAV as mono float samples (channels are averaged)
+ */
+static ethervox_result_t load_wav_16k(const char* path, float** samples_out, uint32_t* count_out) {
+  FILE* fp = fopen(path, "rb");
+  if (!fp) {
+    LOG_ERROR("Failed to open WAV file: %s", path);
+    return ETHERVOX_ERROR_FILE_NOT_FOUND;
+  }
+
+  uint8_t header[12];
+  if (fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header, "RIFF", 4) != 0 ||
+      memcmp(header + 8, "WAVE", 4) != 0) {
+    LOG_ERROR("Not a RIFF/WAVE file: %s", path);
+    fclose(fp);
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+
+  uint16_t format = 0, channels = 0, bits = 0;
+  uint32_t rate = 0, data_size = 0;
+  bool have_fmt = false, have_data = false;
+  uint8_t chunk[8];
+  while (!have_data && fread(chunk, 1, sizeof(chunk), fp) == sizeof(chunk)) {
+    uint32_t size = (uint32_t)chunk[4] | (uint32_t)chunk[5] << 8 | (uint32_t)chunk[6] << 16 |
+                    (uint32_t)chunk[7] << 24;
+    if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+      uint8_t fmt[16];
+      if (fread(fmt, 1, sizeof(fmt), fp) != sizeof(fmt)) {
+        break;
+      }
+      format = (uint16_t)(fmt[0] | fmt[1] << 8);
+      channels = (uint16_t)(fmt[2] | fmt[3] << 8);
+      rate = (uint32_t)fmt[4] | (uint32_t)fmt[5] << 8 | (uint32_t)fmt[6] << 16 |
+             (uint32_t)fmt[7] << 24;
+      bits = (uint16_t)(fmt[14] | fmt[15] << 8);
+      have_fmt = true;
+      fseek(fp, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      data_size = size;
+      have_data = true;
+    } else {
+      fseek(fp, (long)(size + (size & 1)), SEEK_CUR);  // Chunks are word aligned
+    }
+  }
+
+  if (!have_fmt || !have_data) {
+    LOG_ERROR("Missing WAV chunks in %s (fmt: %d, data: %d)", path, have_fmt, have_data);
+    fclose(fp);
+    return ETHERVOX_ERROR_INVALID_ARGUMENT;
+  }
+  // 0xFFFE is WAVE_FORMAT_EXTENSIBLE, used by some recorders for plain PCM
+  if ((format != 1 && format != 0xFFFE) || bits != 16 || channels == 0 ||
+      rate != OFFLINE_SAMPLE_RATE) {
+    LOG_ERROR("Unsupported WAV format in %s: format=%u %u Hz %u-bit %u ch (need 16 kHz 16-bit PCM; "
+              "convert with: ffmpeg -i in.wav -ar 16000 -ac 1 -sample_fmt s16 out.wav)",
+              path, format, rate, bits, channels);
+    fclose(fp);
+    return ETHERVOX_ERROR_NOT_SUPPORTED;
+  }
+
+  // Recorders that were interrupted leave the header size unpatched, so
+  // trust the file length over the data chunk size
+  long data_pos = ftell(fp);
+  if (data_pos >= 0 && fseek(fp, 0, SEEK_END) == 0) {
+    long file_end = ftell(fp);
+    if (file_end >= data_pos && (uint64_t)(file_end - data_pos) < data_size) {
+      data_size = (uint32_t)(file_end - data_pos);
+    }
+    fseek(fp, data_pos, SEEK_SET);
+  }
+
+  uint32_t frames = data_size / (2u * channels);
+  int16_t* pcm = (int16_t*)malloc((size_t)(frames ? frames : 1) * channels * sizeof(int16_t));
+  float* samples = (float*)malloc((size_t)(frames ? frames : 1) * channels * sizeof(float));
+  if (!pcm || !samples) {
+    free(pcm);
+    free(samples);
+    fclose(fp);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  frames = (uint32_t)fread(pcm, 2u * channels, frames, fp);
+  fclose(fp);
+
+  ethervox_dsp_s16_to_float(pcm, samples, (size_t)frames * channels);
+  ethervox_dsp_downmix(samples, samples, frames, channels);
+  free(pcm);
+
+  *samples_out = samples;
+  *count_out = frames;
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_stt_offline_transcribe_file(const ethervox_stt_offline_config_t* config,
+                                                       const char* wav_path,
+                                                       ethervox_stt_offline_result_t* result) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(wav_path);
+  ETHERVOX_CHECK_PTR(result);
+
+  float* samples = NULL;
+  uint32_t sample_count = 0;
+  ethervox_result_t ret = load_wav_16k(wav_path, &samples, &sample_count);
+  if (ethervox_is_error(ret)) {
+    return ret;
+  }
+  LOG_INFO("Loaded %s: %.1f s of audio", wav_path, (double)sample_count / OFFLINE_SAMPLE_RATE);
+
+  ret = ethervox_stt_offline_transcribe(config, samples, sample_count, result);
+  free(samples);
+  return ret;
+}
+
+void ethervox_stt_offline_result_free(ethervox_stt_offline_result_t* result) {
+  if (!result) {
+    return;
+  }
+  for (uint32_t i = 0; i < result->segment_count; i++) {
+    free(result->segments[i].text);
+  }
+  free(result->segments);
+  free(result->text);
+  memset(result, 0, sizeof(*result));
+}
+
+// ============================================================================
+// PARALLEL DECODING
+// ============================================================================
+
+#ifdef WHISPER_CPP_AVAILABLE
+
+typedef struct {
+  ethervox_stt_offline_segment_t* segments;
+  uint32_t count;
+} span_output_t;
+
+typedef struct {
+  uint32_t length;
+  uint32_t index;
+} span_order_t;
+
+typedef struct {
+  struct whisper_context* ctx;
+  struct whisper_full_params params;
+  const float* samples;
+  const ethervox_stt_offline_span_t* spans;
+  const span_order_t* order;  // Span indices, longest first
+  uint32_t span_count;
+  span_output_t* outputs;  // One slot per span, in recording order
+
+  pthread_mutex_t lock;
+  uint32_t next;  // Next position in order
+  ethervox_result_t status;
+} offline_job_t;
+
+typedef struct {
+  offline_job_t* job;
+  struct whisper_state* state;
+  pthread_t thread;
+} offline_worker_t;
+
+static double monotonic_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t detect_cpu_cores(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cores > 0) {
+    return (uint32_t)cores;
+  }
+#endif
+  return 4;  // Safe fallback
+}
+
+static int compare_span_length_desc(const void* a, const void* b) {
+  uint32_t la = ((const span_order_t*)a)->length;
+  uint32_t lb = ((const span_order_t*)b)->length;
+  return (la < lb) - (la > lb);
+}
+
+/**
+ * Copy the segments of the span just decoded into its output slot
+ */
+static ethervox_result_t collect_span_output(struct whisper_state* state,
+                                             const ethervox_stt_offline_span_t* span,
+                                             span_output_t* output) {
+  int n = whisper_full_n_segments_from_state(state);
+  if (n <= 0) {
+    return ETHERVOX_SUCCESS;
+  }
+  output->segments = (ethervox_stt_offline_segment_t*)calloc((size_t)n, sizeof(*output->segments));
+  if (!output->segments) {
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  const char* language = whisper_lang_str(whisper_full_lang_id_from_state(state));
+  uint64_t offset_ms = span->start / OFFLINE_SAMPLES_PER_MS;
+  for (int i = 0; i < n; i++) {
+    const char* text = whisper_full_get_segment_text_from_state(state, i);
+    if (!text) {
+      continue;
+    }
+    while (isspace((unsigned char)*text)) {
+      text++;
+    }
+    if (*text == '\0') {
+      continue;
+    }
+    char* copy = strdup(text);
+    if (!copy) {
+      return ETHERVOX_ERROR_OUT_OF_MEMORY;
+    }
+    // Segment times are in centiseconds relative to the span
+    ethervox_stt_offline_segment_t* seg = &output->segments[output->count++];
+    seg->start_ms = offset_ms + (uint64_t)whisper_full_get_segment_t0_from_state(state, i) * 10;
+    seg->end_ms = offset_ms + (uint64_t)whisper_full_get_segment_t1_from_state(state, i) * 10;
+    seg->text = copy;
+    seg->language = language;
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+static void* offline_worker_thread(void* arg) {
+  offline_worker_t* worker = (offline_worker_t*)arg;
+  offline_job_t* job = worker->job;
+
+  for (;;) {
+    pthread_mutex_lock(&job->lock);
+    if (ethervox_is_error(job->status) || job->next >= job->span_count) {
+      pthread_mutex_unlock(&job->lock);
+      break;
+    }
+    uint32_t index = job->order[job->next++].index;
+    pthread_mutex_unlock(&job->lock);
+
+    const ethervox_stt_offline_span_t* span = &job->spans[index];
+    ethervox_result_t ret = ETHERVOX_SUCCESS;
+    int rc = whisper_full_with_state(job->ctx, worker->state, job->params,
+                                     job->samples + span->start, (int)span->length);
+    if (rc != 0) {
+      LOG_ERROR("whisper_full_with_state failed (%d) on span %u at %.1f s", rc, index,
+                (double)span->start / OFFLINE_SAMPLE_RATE);
+      ret = ETHERVOX_ERROR_STT_PROCESSING;
+    } else {
+      ret = collect_span_output(worker->state, span, &job->outputs[index]);
+    }
+
+    if (ethervox_is_error(ret)) {
+      pthread_mutex_lock(&job->lock);
+      job->status = ret;
+      pthread_mutex_unlock(&job->lock);
+      break;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Full-params for independent spans: no text is carried between spans,
+ * since a state's previous span is generally not the preceding audio
+ */
+static struct whisper_full_params offline_params(const ethervox_stt_offline_config_t* config,
+                                                 uint32_t threads, char* language_code) {
+  struct whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_BEAM_SEARCH);
+  params.n_threads = (int)threads;
+
+  // "auto" makes whisper_full identify the language of each span itself
+  const char* lang = config->language;
+  if (lang && strlen(lang) >= 2 && strcmp(lang, "auto") != 0) {
+    language_code[0] = lang[0];
+    language_code[1] = lang[1];
+    language_code[2] = '\0';
+    params.language = language_code;
+  } else {
+    params.language = "auto";
+  }
+  params.detect_language = false;
+  params.translate = config->translate_to_english;
+
+  params.no_context = true;
+  params.print_progress = false;
+  params.print_realtime = false;
+  params.print_timestamps = false;
+  params.print_special = false;
+  params.no_timestamps = false;
+
+  params.suppress_blank = true;
+  params.suppress_nst = true;
+  params.no_speech_thold = ETHERVOX_WHISPER_NO_SPEECH_THRESHOLD;
+  params.logprob_thold = ETHERVOX_WHISPER_LOGPROB_THRESHOLD;
+  params.entropy_thold = ETHERVOX_WHISPER_ENTROPY_THRESHOLD;
+  params.temperature = ETHERVOX_WHISPER_TEMPERATURE_START;
+  params.temperature_inc = ETHERVOX_WHISPER_TEMPERATURE_INCREMENT;
+  params.beam_search.beam_size = ETHERVOX_WHISPER_BEAM_SIZE;
+  params.greedy.best_of = 1;
+
+  params.initial_prompt =
+    "Transcribe the exact words spoken in this conversational audio. "
+    "Do not add phrases like 'thanks for watching', 'please subscribe', or any closing remarks. "
+    "Only transcribe what is actually said. Output nothing during silence.";
+  return params;
+}
+
+/**
+ * Move the per-span outputs into the result in recording order
+ */
+static ethervox_result_t stitch_outputs(span_output_t* outputs, uint32_t span_count,
+                                        ethervox_stt_offline_result_t* result) {
+  uint32_t total = 0;
+  size_t text_len = 0;
+  for (uint32_t s = 0; s < span_count; s++) {
+    total += outputs[s].count;
+    for (uint32_t i = 0; i < outputs[s].count; i++) {
+      text_len += strlen(outputs[s].segments[i].text) + 1;
+    }
+  }
+
+  result->text = (char*)malloc(text_len + 1);
+  result->segments = total ? (ethervox_stt_offline_segment_t*)malloc(total * sizeof(*result->segments))
+                           : NULL;
+  if (!result->text || (total && !result->segments)) {
+    free(result->text);
+    free(result->segments);
+    result->text = NULL;
+    result->segments = NULL;
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  char* p = result->text;
+  for (uint32_t s = 0; s < span_count; s++) {
+    for (uint32_t i = 0; i < outputs[s].count; i++) {
+      ethervox_stt_offline_segment_t* seg = &outputs[s].segments[i];
+      size_t len = strlen(seg->text);
+      if (p != result->text) {
+        *p++ = ' ';
+      }
+      memcpy(p, seg->text, len);
+      p += len;
+      result->segments[result->segment_count++] = *seg;
+    }
+    outputs[s].count = 0;  // Ownership of the text moved to result
+  }
+  *p = '\0';
+  return ETHERVOX_SUCCESS;
+}
+
+/**
+ * Decode spans on the states in pool (worker 0 on the calling thread) and
+ * stitch the result
+ */
+static ethervox_result_t decode_spans(struct whisper_context* ctx, struct whisper_full_params params,
+                                      const float* samples, const ethervox_stt_offline_span_t* spans,
+                                      uint32_t span_count, offline_worker_t* pool, uint32_t workers,
+                                      ethervox_stt_offline_result_t* result) {
+  span_output_t* outputs = (span_output_t*)calloc(span_count, sizeof(*outputs));
+  span_order_t* order = (span_order_t*)malloc(span_count * sizeof(*order));
+  if (!outputs || !order) {
+    free(outputs);
+    free(order);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  // Longest spans first so no worker is left with a long tail
+  for (uint32_t i = 0; i < span_count; i++) {
+    order[i] = (span_order_t){ spans[i].length, i };
+  }
+  qsort(order, span_count, sizeof(*order), compare_span_length_desc);
+
+  offline_job_t job = {
+    .ctx = ctx,
+    .params = params,
+    .samples = samples,
+    .spans = spans,
+    .order = order,
+    .span_count = span_count,
+    .outputs = outputs,
+    .next = 0,
+    .status = ETHERVOX_SUCCESS,
+  };
+  pthread_mutex_init(&job.lock, NULL);
+
+  double t_decode = monotonic_seconds();
+  uint32_t started = 1;
+  for (uint32_t w = 0; w < workers; w++) {
+    pool[w].job = &job;
+  }
+  for (uint32_t w = 1; w < workers; w++) {
+    if (pthread_create(&pool[w].thread, NULL, offline_worker_thread, &pool[w]) != 0) {
+      LOG_WARN("pthread_create failed - continuing with %u workers", started);
+      break;
+    }
+    started++;
+  }
+  offline_worker_thread(&pool[0]);
+  for (uint32_t w = 1; w < started; w++) {
+    pthread_join(pool[w].thread, NULL);
+  }
+
+  result->decode_seconds = monotonic_seconds() - t_decode;
+  if (result->audio_seconds > 0.0) {
+    result->realtime_factor = result->decode_seconds / result->audio_seconds;
+  }
+  pthread_mutex_destroy(&job.lock);
+
+  ethervox_result_t ret = job.status;
+  if (ethervox_is_success(ret)) {
+    ret = stitch_outputs(outputs, span_count, result);
+  }
+
+  for (uint32_t s = 0; s < span_count; s++) {
+    for (uint32_t i = 0; i < outputs[s].count; i++) {
+      free(outputs[s].segments[i].text);
+    }
+    free(outputs[s].segments);
+  }
+  free(outputs);
+  free(order);
+  return ret;
+}
+
+/**
+ * Split the input; no speech is a successful empty result (*spans = NULL)
+ */
+static ethervox_result_t split_input(const ethervox_stt_offline_config_t* config, const float* samples,
+                                     uint32_t sample_count, ethervox_stt_offline_span_t** spans,
+                                     uint32_t* span_count, ethervox_stt_offline_result_t* result) {
+  memset(result, 0, sizeof(*result));
+  result->audio_seconds = (double)sample_count / OFFLINE_SAMPLE_RATE;
+
+  ethervox_result_t ret = ethervox_stt_offline_split(samples, sample_count, config->max_segment_ms,
+                                                     config->min_silence_ms, spans, span_count);
+  if (ethervox_is_error(ret)) {
+    return ret;
+  }
+  result->spans = *span_count;
+  if (*span_count == 0) {
+    LOG_DEBUG("No speech found in %.1f s of audio", result->audio_seconds);
+    result->text = strdup("");
+    return result->text ? ETHERVOX_SUCCESS : ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  return ETHERVOX_SUCCESS;
+}
+
+static uint32_t worker_threads(const ethervox_stt_offline_config_t* config, uint32_t cores) {
+  uint32_t threads = config->threads_per_worker ? config->threads_per_worker
+                                                : ETHERVOX_WHISPER_OFFLINE_THREADS_PER_WORKER;
+  return threads > cores ? cores : threads;
+}
+
+ethervox_result_t ethervox_stt_offline_transcribe(const ethervox_stt_offline_config_t* config,
+                                                  const float* samples, uint32_t sample_count,
+                                                  ethervox_stt_offline_result_t* result) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(samples);
+  ETHERVOX_CHECK_PTR(result);
+  ETHERVOX_CHECK_PTR(config->model_path);
+
+  ethervox_stt_offline_span_t* spans = NULL;
+  uint32_t span_count = 0;
+  ethervox_result_t ret = split_input(config, samples, sample_count, &spans, &span_count, result);
+  if (ethervox_is_error(ret) || span_count == 0) {
+    return ret;
+  }
+
+  // Worker sizing: whisper scales poorly past a few threads per decode, so
+  // the cores are spread over several states instead of one wide one
+  uint32_t cores = detect_cpu_cores();
+  uint32_t threads = worker_threads(config, cores);
+  uint32_t workers = config->workers ? config->workers : cores / threads;
+  if (workers == 0) {
+    workers = 1;
+  }
+  if (workers > span_count) {
+    workers = span_count;
+  }
+
+  // A model already loaded by a live session is reused
+  double t_load = monotonic_seconds();
+  void* model = NULL;
+  ret = ethervox_stt_model_acquire(config->model_path, ethervox_stt_whisper_load_model,
+                                   ethervox_stt_whisper_free_model, &model);
+  if (ethervox_is_error(ret)) {
+    free(spans);
+    return ret;
+  }
+  struct whisper_context* ctx = (struct whisper_context*)model;
+
+  offline_worker_t* pool = (offline_worker_t*)calloc(workers, sizeof(*pool));
+  if (!pool) {
+    free(spans);
+    ethervox_stt_model_release(ctx);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+
+  // Each state holds its own KV cache and encoder buffers; stop at the
+  // first one that cannot be allocated and run with what we have
+  uint32_t ready = 0;
+  while (ready < workers) {
+    pool[ready].state = whisper_init_state(ctx);
+    if (!pool[ready].state) {
+      LOG_WARN("Could only create %u of %u whisper states", ready, workers);
+      break;
+    }
+    ready++;
+  }
+  if (ready == 0) {
+    LOG_ERROR("Failed to create a whisper state");
+    free(pool);
+    free(spans);
+    ethervox_stt_model_release(ctx);
+    return ETHERVOX_ERROR_STT_INIT;
+  }
+  workers = ready;
+  result->workers = workers;
+  result->load_seconds = monotonic_seconds() - t_load;
+
+  LOG_INFO("Transcribing %.1f s in %u spans on %u workers x %u threads", result->audio_seconds,
+           span_count, workers, threads);
+  char language_code[3];
+  ret = decode_spans(ctx, offline_params(config, threads, language_code), samples, spans, span_count, pool,
+                     workers, result);
+  if (ethervox_is_success(ret)) {
+    LOG_INFO("Transcribed %.1f s in %.2f s (RTF %.3f, %u segments)", result->audio_seconds,
+             result->decode_seconds, result->realtime_factor, result->segment_count);
+  }
+
+  for (uint32_t w = 0; w < workers; w++) {
+    whisper_free_state(pool[w].state);
+  }
+  free(pool);
+  free(spans);
+  ethervox_stt_model_release(ctx);
+
+  if (ethervox_is_error(ret)) {
+    ethervox_stt_offline_result_free(result);
+  }
+  return ret;
+}
+
+// ============================================================================
+// PERSISTENT DECODER
+// ============================================================================
+
+struct ethervox_stt_offline_decoder {
+  ethervox_stt_offline_config_t config;
+  char language[16];  // config.language points here
+  struct whisper_context* ctx;  // Registry reference
+  struct whisper_state* state;
+  uint32_t threads;
+};
+
+ethervox_result_t ethervox_stt_offline_decoder_create(const ethervox_stt_offline_config_t* config,
+                                                      ethervox_stt_offline_decoder_t** decoder_out) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(config->model_path);
+  ETHERVOX_CHECK_PTR(decoder_out);
+  *decoder_out = NULL;
+
+  ethervox_stt_offline_decoder_t* decoder = (ethervox_stt_offline_decoder_t*)calloc(1, sizeof(*decoder));
+  if (!decoder) {
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  decoder->config = *config;
+  decoder->config.model_path = NULL;  // Only needed to acquire the model
+  decoder->threads = worker_threads(config, detect_cpu_cores());
+  ethervox_stt_offline_decoder_set_language(decoder, config->language);
+
+  void* model = NULL;
+  ethervox_result_t ret = ethervox_stt_model_acquire(config->model_path, ethervox_stt_whisper_load_model,
+                                                     ethervox_stt_whisper_free_model, &model);
+  if (ethervox_is_error(ret)) {
+    free(decoder);
+    return ret;
+  }
+  decoder->ctx = (struct whisper_context*)model;
+  decoder->state = whisper_init_state(decoder->ctx);
+  if (!decoder->state) {
+    LOG_ERROR("Failed to create a whisper state");
+    ethervox_stt_offline_decoder_destroy(decoder);
+    return ETHERVOX_ERROR_STT_INIT;
+  }
+
+  *decoder_out = decoder;
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_stt_offline_decoder_set_language(ethervox_stt_offline_decoder_t* decoder,
+                                                            const char* language) {
+  ETHERVOX_CHECK_PTR(decoder);
+  snprintf(decoder->language, sizeof(decoder->language), "%s", language ? language : "auto");
+  decoder->config.language = decoder->language;
+  return ETHERVOX_SUCCESS;
+}
+
+ethervox_result_t ethervox_stt_offline_decode(ethervox_stt_offline_decoder_t* decoder, const float* samples,
+                                              uint32_t sample_count, ethervox_stt_offline_result_t* result) {
+  ETHERVOX_CHECK_PTR(decoder);
+  ETHERVOX_CHECK_PTR(samples);
+  ETHERVOX_CHECK_PTR(result);
+
+  ethervox_stt_offline_span_t* spans = NULL;
+  uint32_t span_count = 0;
+  ethervox_result_t ret = split_input(&decoder->config, samples, sample_count, &spans, &span_count, result);
+  if (ethervox_is_error(ret) || span_count == 0) {
+    return ret;
+  }
+
+  offline_worker_t worker = { .state = decoder->state };
+  char language_code[3];
+  result->workers = 1;
+  ret = decode_spans(decoder->ctx, offline_params(&decoder->config, decoder->threads, language_code), samples,
+                     spans, span_count, &worker, 1, result);
+  free(spans);
+  if (ethervox_is_error(ret)) {
+    ethervox_stt_offline_result_free(result);
+  }
+  return ret;
+}
+
+void ethervox_stt_offline_decoder_destroy(ethervox_stt_offline_decoder_t* decoder) {
+  if (!decoder) {
+    return;
+  }
+  if (decoder->state) {
+    whisper_free_state(decoder->state);
+  }
+  ethervox_stt_model_release(decoder->ctx);
+  free(decoder);
+}
+
+#else  // !WHISPER_CPP_AVAILABLE
+
+ethervox_result_t ethervox_stt_offline_transcribe(const ethervox_stt_offline_config_t* config,
+                                                  const float* samples, uint32_t sample_count,
+                                                  ethervox_stt_offline_result_t* result) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(samples);
+  ETHERVOX_CHECK_PTR(result);
+  (void)sample_count;
+  memset(result, 0, sizeof(*result));
+  LOG_ERROR("Offline transcription requires whisper.cpp");
+  return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
+ethervox_result_t ethervox_stt_offline_decoder_create(const ethervox_stt_offline_config_t* config,
+                                                      ethervox_stt_offline_decoder_t** decoder_out) {
+  ETHERVOX_CHECK_PTR(config);
+  ETHERVOX_CHECK_PTR(decoder_out);
+  *decoder_out = NULL;
+  LOG_ERROR("Offline transcription requires whisper.cpp");
+  return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
+ethervox_result_t ethervox_stt_offline_decoder_set_language(ethervox_stt_offline_decoder_t* decoder,
+                                                            const char* language) {
+  (void)decoder;
+  (void)language;
+  return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
+ethervox_result_t ethervox_stt_offline_decode(ethervox_stt_offline_decoder_t* decoder, const float* samples,
+                                              uint32_t sample_count, ethervox_stt_offline_result_t* result) {
+  ETHERVOX_CHECK_PTR(result);
+  (void)decoder;
+  (void)samples;
+  (void)sample_count;
+  memset(result, 0, sizeof(*result));
+  return ETHERVOX_ERROR_NOT_SUPPORTED;
+}
+
+void ethervox_stt_offline_decoder_destroy(ethervox_stt_offline_decoder_t* decoder) {
+  (void)decoder;
+}
+
+#endif  // WHISPER_CPP_AVAILABLE
@@ -29,25 +29,16 @@
   #define HAVE_ONNX 0
 #endif
 
-// Check if Speex is available  
-#if defined(__has_include)
-  #if __has_include(<speex/speex_resampler.h>)
-    #define HAVE_SPEEX 1
-    #include <speex/speex_resampler.h>
-  #else
-    #define HAVE_SPEEX 0
-  #endif
-#else
-  #define HAVE_SPEEX 0
-#endif
+#if HAVE_ONNX
 
-#if HAVE_ONNX && HAVE_SPEEX
+#include "ethervox/dsp.h"
 
 #define PIPER_MAX_PHONEMES 512
 #define PIPER_SAMPLE_RATE 22050
 #define TARGET_SAMPLE_RATE 16000
 #define MAX_PHONEME_MAP_SIZE 256
 #define PIPER_DEFAULT_CHUNK_SIZE 64  // Default phonemes per chunk for streaming
+#define PIPER_RESAMPLE_BLOCK 4096  // Samples per resampler call
 
 // Phoneme ID map entry
 typedef struct {
@@ -61,7 +52,7 @@ typedef struct {
     OrtEnv* env;
     OrtSession* session;
     OrtMemoryInfo* memory_info;
-    SpeexResamplerState* resampler;
+    ethervox_resampler_t* resampler;
     phoneme_map_entry_t phoneme_map[MAX_PHONEME_MAP_SIZE];
     int phoneme_map_size;
     char piper_voice[32];  // e.g., "en-us", "es-419", "zh", "de" (from model config)
@@ -513,7 +504,7 @@ static int text_to_phonemes(piper_context_t* ctx, const char* text, int64_t* pho
 }
 
 // Forward declarations
-static int resample_audio(SpeexResamplerState* resampler,
+static int resample_audio(ethervox_resampler_t* resampler,
                          const float* input,
                          size_t input_count,
                          float** output,
@@ -802,35 +793,30 @@ static int piper_infer(piper_context_t* ctx,
 /**
  * Resample from 22050Hz to 16000Hz
  */
-static int resample_audio(SpeexResamplerState* resampler,
+static int resample_audio(ethervox_resampler_t* resampler,
                          const float* input,
                          size_t input_count,
                          float** output,
                          size_t* output_count) {
     
     // Calculate output size
-    size_t estimated_output = (input_count * TARGET_SAMPLE_RATE) / PIPER_SAMPLE_RATE + 64;
+    size_t estimated_output = ethervox_resampler_max_output(resampler, input_count) + 1;
     *output = (float*)malloc(estimated_output * sizeof(float));
-    
-    spx_uint32_t in_len = input_count;
-    spx_uint32_t out_len = estimated_output;
-    
-    int err = speex_resampler_process_float(
-        resampler,
-        0,  // channel
-        input,
-        &in_len,
-        *output,
-        &out_len
-    );
-    
-    if (err != RESAMPLER_ERR_SUCCESS) {
-        ETHERVOX_LOG_DEBUG("[Piper] Resampling error: %d\n", err);
-        free(*output);
-        *output = NULL;
+    if (!*output) {
+        ETHERVOX_LOG_DEBUG("[Piper] Resampling: out of memory\n");
         return -1;
     }
     
+    // The resampler takes bounded blocks; state carries across them
+    size_t out_len = 0;
+    for (size_t pos = 0; pos < input_count; pos += PIPER_RESAMPLE_BLOCK) {
+        size_t n = input_count - pos;
+        if (n > PIPER_RESAMPLE_BLOCK) {
+            n = PIPER_RESAMPLE_BLOCK;
+        }
+        out_len += ethervox_resampler_process(resampler, input + pos, n, *output + out_len);
+    }
+    
     *output_count = out_len;
     
     return 0;
@@ -988,10 +974,9 @@ ethervox_tts_context_t* ethervox_tts_piper_create(const ethervox_tts_config_t* c
     }
     
     // Create resampler (22050Hz → 16000Hz)
-    int err = 0;
-    ctx->resampler = speex_resampler_init(1, PIPER_SAMPLE_RATE, TARGET_SAMPLE_RATE, 5, &err);
-    if (err != RESAMPLER_ERR_SUCCESS) {
-        ETHERVOX_LOG_DEBUG("[Piper] Failed to create resampler: %d\n", err);
+    ctx->resampler = ethervox_resampler_create(PIPER_SAMPLE_RATE, TARGET_SAMPLE_RATE, PIPER_RESAMPLE_BLOCK);
+    if (!ctx->resampler) {
+        ETHERVOX_LOG_DEBUG("[Piper] Failed to create resampler\n");
         g_ort_api->ReleaseMemoryInfo(ctx->memory_info);
         g_ort_api->ReleaseSession(ctx->session);
         g_ort_api->ReleaseEnv(ctx->env);
@@ -1008,7 +993,7 @@ ethervox_tts_context_t* ethervox_tts_piper_create(const ethervox_tts_config_t* c
     ctx->phonemizer = phonemizer_create(ctx->piper_voice);
     if (!ctx->phonemizer) {
         ETHERVOX_LOG_ERROR("[Piper] Failed to initialize phonemizer for language: %s\n", ctx->piper_voice);
-        speex_resampler_destroy(ctx->resampler);
+        ethervox_resampler_destroy(ctx->resampler);
         g_ort_api->ReleaseMemoryInfo(ctx->memory_info);
         g_ort_api->ReleaseSession(ctx->session);
         g_ort_api->ReleaseEnv(ctx->env);
@@ -1171,7 +1156,7 @@ void ethervox_tts_piper_destroy(ethervox_tts_context_t* ctx) {
     }
     
     if (piper->resampler) {
-        speex_resampler_destroy(piper->resampler);
+        ethervox_resampler_destroy(piper->resampler);
     }
     
     if (piper->accumulated_audio) {
@@ -1193,9 +1178,9 @@ void ethervox_tts_piper_destroy(ethervox_tts_context_t* ctx) {
     free(piper);
 }
 
-#else // !HAVE_ONNX || !HAVE_SPEEX
+#else // !HAVE_ONNX
 
-// Stub implementations when ONNX Runtime or Speex is not available
+// Stub implementations when ONNX Runtime is not available
 #include "ethervox/tts.h"
 #include "ethervox/logging.h"
 #include "ethervox/error.h"
@@ -1208,8 +1193,8 @@ ethervox_result_t ethervox_tts_piper_init(
     (void)ctx_out;
     (void)model_path;
     (void)config_path;
-    ETHERVOX_LOG_WARN("Piper TTS not available - ONNX Runtime or Speex not found");
-    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_IMPLEMENTED, "Piper TTS requires ONNX Runtime and Speex");
+    ETHERVOX_LOG_WARN("Piper TTS not available - ONNX Runtime not found");
+    ETHERVOX_RETURN_ERROR(ETHERVOX_ERROR_NOT_IMPLEMENTED, "Piper TTS requires ONNX Runtime");
 }
 
 ethervox_result_t ethervox_tts_piper_synthesize(
@@ -1229,4 +1214,4 @@ void ethervox_tts_piper_destroy(ethervox_tts_context_t* ctx) {
     (void)ctx;
 }
 
-#endif // HAVE_ONNX && HAVE_SPEEX
+#endif // HAVE_ONNX
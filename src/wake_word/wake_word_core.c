@@ -3,7 +3,7 @@
  * @brief Production-ready keyword spotting for EthervoxAI
  *
  * Implements a lightweight, dependency-free wake word detection system using:
- * - Voice Activity Detection (VAD) with zero-crossing rate and spectral analysis
+ * - Voice Activity Detection from the shared frame VAD (log-energy, spectral tilt)
  * - Syllable counting and temporal pattern matching
  * - Template-based audio correlation
  * - Adaptive background noise filtering
@@ -21,16 +21,11 @@
 #include <sys/time.h>
 
 #include "ethervox/error.h"
+#include "ethervox/vad.h"
 #include "ethervox/wake_word.h"
 
 #define DEFAULT_WAKE_WORD "hey ethervox"
 
-// VAD thresholds
-#define VAD_ENERGY_THRESHOLD 0.01f        // Minimum energy for speech (lowered from 0.02)
-#define VAD_ZCR_MIN 0.01f                 // Min zero-crossing rate (lowered from 0.05)
-#define VAD_ZCR_MAX 0.35f                 // Max zero-crossing rate (Hz)
-#define VAD_SPECTRAL_FLATNESS_MAX 0.95f   // Max spectral flatness (very relaxed - 1.0 = pure noise)
-
 // Syllable detection
 #define SYLLABLE_MIN_SPACING_MS 80        // Minimum ms between syllables
 #define SYLLABLE_ENERGY_RATIO 1.5f        // Peak must be 1.5x valley energy
@@ -43,14 +38,13 @@
 // Contextual filtering
 #define DEBOUNCE_TIME_MS 3000             // Don't retrigger within 3 seconds
 #define PRE_SILENCE_MS 500                // Require silence before wake word
-#define NOISE_ADAPT_FRAMES 50             // Frames for background noise estimation
 
 // Internal state
 typedef struct {
-  // Background noise profile
-  float noise_floor;
-  float noise_zcr;
-  int noise_adapt_count;
+  // Voice activity: frames come from the stream's VAD, or this private one
+  // when the caller hands over raw audio
+  ethervox_vad_t* vad;
+  float vad_threshold;  // Frame probability that counts as voice
   
   // Syllable tracking
   float* syllable_energies;
@@ -76,24 +70,6 @@ static uint64_t get_time_us(void) {
   return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
 }
 
-/**
- * Calculate zero-crossing rate (ZCR) for pitch/voice estimation
- * Returns normalized ZCR (crossings per sample)
- */
-static float calculate_zcr(const float* samples, uint32_t count) {
-  if (count < 2) return 0.0f;
-  
-  uint32_t crossings = 0;
-  for (uint32_t i = 1; i < count; i++) {
-    if ((samples[i] >= 0.0f && samples[i-1] < 0.0f) ||
-        (samples[i] < 0.0f && samples[i-1] >= 0.0f)) {
-      crossings++;
-    }
-  }
-  
-  return (float)crossings / (float)count;
-}
-
 /**
  * Calculate RMS energy of audio buffer
  */
@@ -108,80 +84,6 @@ static float calculate_energy(const float* samples, uint32_t count) {
   return (float)sqrt(sum / (double)count);
 }
 
-/**
- * Calculate spectral flatness (geometric mean / arithmetic mean of magnitude spectrum)
- * Values close to 1.0 indicate noise, values close to 0.0 indicate tonal/speech
- */
-static float calculate_spectral_flatness(const float* samples, uint32_t count) {
-  if (count < 4) return 1.0f;
-  
-  // Simple approximation: compare energy in different frequency bands
-  // Full implementation would use FFT, but this is lightweight alternative
-  
-  float low_energy = 0.0f, mid_energy = 0.0f, high_energy = 0.0f;
-  uint32_t band_size = count / 3;
-  
-  for (uint32_t i = 0; i < band_size && i < count; i++) {
-    low_energy += fabsf(samples[i]);
-  }
-  for (uint32_t i = band_size; i < 2 * band_size && i < count; i++) {
-    mid_energy += fabsf(samples[i]);
-  }
-  for (uint32_t i = 2 * band_size; i < count; i++) {
-    high_energy += fabsf(samples[i]);
-  }
-  
-  low_energy /= (float)band_size;
-  mid_energy /= (float)band_size;
-  high_energy /= (float)(count - 2 * band_size);
-  
-  // Speech typically has more mid-frequency energy
-  // Calculate variance of band energies (low variance = flat/noise)
-  float mean = (low_energy + mid_energy + high_energy) / 3.0f;
-  if (mean < 0.001f) return 1.0f;
-  
-  float variance = ((low_energy - mean) * (low_energy - mean) +
-                    (mid_energy - mean) * (mid_energy - mean) +
-                    (high_energy - mean) * (high_energy - mean)) / 3.0f;
-  
-  // Normalize to 0-1 range (lower variance = flatter = more noise-like)
-  return 1.0f / (1.0f + variance * 100.0f);
-}
-
-/**
- * Voice Activity Detection using multiple features
- * Returns true if audio contains speech
- */
-static bool detect_voice_activity(const float* samples, uint32_t count, 
-                                   float noise_floor, float noise_zcr) {
-  float energy = calculate_energy(samples, count);
-  float zcr = calculate_zcr(samples, count);
-  float flatness = calculate_spectral_flatness(samples, count);
-  
-  bool passed_energy = energy >= noise_floor + VAD_ENERGY_THRESHOLD;
-  bool passed_zcr = (zcr >= VAD_ZCR_MIN && zcr <= VAD_ZCR_MAX);
-  
-  // Check energy above noise floor
-  if (!passed_energy) {
-    return false;
-  }
-  
-  // Check ZCR in speech range (not too low like hum, not too high like noise)
-  if (!passed_zcr) {
-    return false;
-  }
-  
-  // NOTE: Spectral flatness check disabled - was too strict for real-world audio
-  // Most microphone input has high flatness due to background noise
-  // Relying on energy + ZCR is sufficient for wake word detection
-  //
-  // if (!passed_flatness) {
-  //   return false;
-  // }
-  
-  return true;
-}
-
 /**
  * Detect syllable peaks in audio energy envelope
  * Updates syllable count and timing
@@ -297,9 +199,15 @@ ethervox_result_t ethervox_wake_init(ethervox_wake_runtime_t* runtime, const eth
     return ETHERVOX_ERROR_NULL_POINTER;
   }
   
-  state->noise_floor = 0.01f;  // Initial estimate
-  state->noise_zcr = 0.15f;    // Initial estimate
-  state->noise_adapt_count = 0;
+  ethervox_vad_config_t vad_config = ethervox_vad_get_default_config();
+  vad_config.sample_rate = runtime->config.sample_rate;
+  state->vad = ethervox_vad_create(&vad_config);
+  if (!state->vad) {
+    free(state);
+    free(runtime->audio_buffer);
+    return ETHERVOX_ERROR_OUT_OF_MEMORY;
+  }
+  state->vad_threshold = vad_config.threshold;
   state->last_detection_time_us = 0;
   state->last_voice_time_us = 0;
   
@@ -327,6 +235,36 @@ ethervox_result_t ethervox_wake_process(ethervox_wake_runtime_t* runtime,
   if (!runtime->is_initialized) {
     return ETHERVOX_ERROR_NOT_INITIALIZED;
   }
+  wake_word_state_t* state = (wake_word_state_t*)runtime->detector_context;
+  if (!state) {
+    return ETHERVOX_ERROR_NULL_POINTER;
+  }
+
+  // No frames from the stream: analyze the audio with the private VAD
+  const ethervox_vad_frame_t* frames = NULL;
+  uint32_t frame_count = 0;
+  ethervox_result_t vad_result =
+      ethervox_vad_process(state->vad, audio_buffer->data, audio_buffer->size, &frames, &frame_count);
+  if (ethervox_is_error(vad_result)) {
+    return vad_result;
+  }
+  return ethervox_wake_process_frames(runtime, audio_buffer, frames, frame_count, result);
+}
+
+ethervox_result_t ethervox_wake_process_frames(ethervox_wake_runtime_t* runtime,
+                                               const ethervox_audio_buffer_t* audio_buffer,
+                                               const ethervox_vad_frame_t* frames, uint32_t frame_count,
+                                               ethervox_wake_result_t* result) {
+  ETHERVOX_CHECK_PTR(runtime);
+  ETHERVOX_CHECK_PTR(audio_buffer);
+  ETHERVOX_CHECK_PTR(audio_buffer->data);
+  ETHERVOX_CHECK_PTR(result);
+  if (frame_count > 0) {
+    ETHERVOX_CHECK_PTR(frames);
+  }
+  if (!runtime->is_initialized) {
+    return ETHERVOX_ERROR_NOT_INITIALIZED;
+  }
 
   memset(result, 0, sizeof(*result));
   result->wake_word = runtime->config.wake_word;
@@ -358,23 +296,19 @@ ethervox_result_t ethervox_wake_process(ethervox_wake_runtime_t* runtime,
     runtime->write_index = (runtime->write_index + 1) % runtime->buffer_size;
   }
 
-  // Calculate audio features
-  float energy = calculate_energy(samples, sample_count);
-  float zcr = calculate_zcr(samples, sample_count);
-  
-  // Adapt to background noise (first N frames)
-  if (state->noise_adapt_count < NOISE_ADAPT_FRAMES) {
-    state->noise_floor = (state->noise_floor * state->noise_adapt_count + energy) / 
-                         (state->noise_adapt_count + 1);
-    state->noise_zcr = (state->noise_zcr * state->noise_adapt_count + zcr) / 
-                       (state->noise_adapt_count + 1);
-    state->noise_adapt_count++;
-    return ETHERVOX_SUCCESS;  // Still learning background
+  // Voice Activity Detection: the buffer is voice if any of its frames is
+  // over our threshold (the VAD tracks the background noise floor itself)
+  if (frame_count == 0) {
+    return ETHERVOX_SUCCESS;  // Less than a frame so far
   }
 
-  // Voice Activity Detection
-  bool is_voice = detect_voice_activity(samples, sample_count, 
-                                         state->noise_floor, state->noise_zcr);
+  bool is_voice = false;
+  float energy_sum = 0.0f;
+  for (uint32_t i = 0; i < frame_count; i++) {
+    is_voice = is_voice || frames[i].probability >= state->vad_threshold;
+    energy_sum += frames[i].rms * frames[i].rms;
+  }
+  float energy = sqrtf(energy_sum / (float)frame_count);
   
   if (is_voice) {
     state->last_voice_time_us = timestamp_us;
@@ -535,6 +469,7 @@ void ethervox_wake_cleanup(ethervox_wake_runtime_t* runtime) {
     if (state->template_audio) {
       free(state->template_audio);
     }
+    ethervox_vad_destroy(state->vad);
     free(state);
     runtime->detector_context = NULL;
   }
@@ -0,0 +1,730 @@
+/**
+ * @file benchmark_stt.c
+ * @brief Accuracy and speed benchmark for the STT backends
+ *
+ * Streams every WAV in a corpus directory through each compiled backend and
+ * model the way the live pipeline does (fixed-size capture chunks, then
+ * finalize), and compares the transcript with the reference <name>.txt next
+ * to each <name>.wav.
+ *
+ * Reported per run: word error rate, realtime factor (processing time over
+ * audio time), first-result latency, per-chunk latency percentiles and peak
+ * RSS. The JSON report also records the compiled ETHERVOX_WHISPER_* tunables
+ * so runs built with different -D overrides stay comparable.
+ *
+ * Usage:
+ *   benchmark_stt --data DIR [--whisper MODEL]... [--vosk MODEL]...
+ *                 [--threads N]... [--chunk-ms MS] [--language CODE] [--json FILE]
+ *
+ * Corpus WAVs must be 16 kHz mono 16-bit PCM:
+ *   ffmpeg -i input.wav -ar 16000 -ac 1 -sample_fmt s16 output.wav
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/stt.h"
+#include "ethervox/error.h"
+#include "ethervox/config.h"
+#include "ethervox/logging.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#define SAMPLE_RATE 16000
+#define MAX_RUNS 32
+#define MAX_THREAD_COUNTS 8
+
+typedef struct {
+    char* name;        // File stem
+    float* samples;
+    uint32_t sample_count;
+    char* reference;
+} bench_item_t;
+
+typedef struct {
+    char* hypothesis;
+    uint32_t errors;     // Word edit distance to the reference
+    uint32_t ref_words;
+    double process_ms;   // Time inside process() and finalize()
+    double first_result_ms;  // Real-time-paced clock at the first text (< 0 = none)
+} bench_item_result_t;
+
+typedef struct {
+    const char* backend_name;
+    ethervox_stt_backend_t backend;
+    const char* model_path;
+    uint32_t threads;
+    bool skipped;
+    ethervox_result_t init_error;
+    double init_ms;
+    bench_item_result_t* items;
+    double* chunk_ms;    // Latency of every process() call
+    size_t chunk_count;
+    size_t chunk_capacity;
+    long peak_rss_kb;
+} bench_run_t;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// ============================================================================
+// Corpus loading
+// ============================================================================
+
+static uint32_t read_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_u16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * Load a 16 kHz mono 16-bit PCM WAV as float samples
+ */
+static bool load_wav(const char* path, float** samples_out, uint32_t* count_out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    unsigned char header[12];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        fclose(fp);
+        return false;
+    }
+
+    bool format_ok = false;
+    unsigned char chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), fp) == sizeof(chunk)) {
+        uint32_t size = read_u32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            unsigned char fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), fp) != sizeof(fmt)) break;
+            format_ok = read_u16(fmt) == 1 && read_u16(fmt + 2) == 1 &&
+                        read_u32(fmt + 4) == SAMPLE_RATE && read_u16(fmt + 14) == 16;
+            fseek(fp, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!format_ok) break;
+            uint32_t count = size / 2;
+            int16_t* pcm = (int16_t*)malloc(size);
+            float* samples = (float*)malloc((count ? count : 1) * sizeof(float));
+            if (!pcm || !samples || fread(pcm, 2, count, fp) != count) {
+                free(pcm);
+                free(samples);
+                break;
+            }
+            for (uint32_t i = 0; i < count; i++) {
+                samples[i] = (float)(int16_t)read_u16((const unsigned char*)&pcm[i]) / 32768.0f;
+            }
+            free(pcm);
+            fclose(fp);
+            *samples_out = samples;
+            *count_out = count;
+            return true;
+        } else {
+            fseek(fp, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(fp);
+    return false;
+}
+
+static char* read_text_file(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* text = (char*)malloc((size_t)size + 1);
+    if (text) {
+        size_t read = fread(text, 1, (size_t)size, fp);
+        text[read] = '\0';
+    }
+    fclose(fp);
+    return text;
+}
+
+static int compare_items(const void* a, const void* b) {
+    return strcmp(((const bench_item_t*)a)->name, ((const bench_item_t*)b)->name);
+}
+
+/**
+ * Collect <name>.wav files that have a <name>.txt reference
+ */
+static size_t load_corpus(const char* dir_path, bench_item_t** items_out) {
+    DIR* dir = opendir(dir_path);
+    if (!dir) {
+        return 0;
+    }
+
+    bench_item_t* items = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 5 || strcmp(entry->d_name + len - 4, ".wav") != 0) continue;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%.*s.txt", dir_path, (int)(len - 4), entry->d_name);
+        char* reference = read_text_file(path);
+        if (!reference) {
+            fprintf(stderr, "Skipping %s: no reference transcript\n", entry->d_name);
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        float* samples = NULL;
+        uint32_t sample_count = 0;
+        if (!load_wav(path, &samples, &sample_count)) {
+            fprintf(stderr, "Skipping %s: not 16 kHz mono 16-bit PCM\n", entry->d_name);
+            free(reference);
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            bench_item_t* grown = (bench_item_t*)realloc(items, capacity * sizeof(bench_item_t));
+            if (!grown) {
+                free(samples);
+                free(reference);
+                break;
+            }
+            items = grown;
+        }
+        items[count].name = strndup(entry->d_name, len - 4);
+        items[count].samples = samples;
+        items[count].sample_count = sample_count;
+        items[count].reference = reference;
+        count++;
+    }
+    closedir(dir);
+
+    if (count > 0) {
+        qsort(items, count, sizeof(bench_item_t), compare_items);
+    }
+    *items_out = items;
+    return count;
+}
+
+// ============================================================================
+// Word error rate
+// ============================================================================
+
+/**
+ * Split into lowercase words, dropping punctuation and bracketed tags
+ * such as speaker labels and [BLANK_AUDIO]
+ */
+static size_t tokenize_words(const char* text, char*** words_out) {
+    size_t len = text ? strlen(text) : 0;
+    char* norm = (char*)malloc(len + 1);
+    size_t n = 0;
+    int bracket_depth = 0;
+    for (size_t i = 0; norm && i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '[' || c == '(') {
+            bracket_depth++;
+            c = ' ';
+        } else if ((c == ']' || c == ')') && bracket_depth > 0) {
+            bracket_depth--;
+            c = ' ';
+        } else if (bracket_depth > 0) {
+            c = ' ';
+        } else if (c < 0x80) {
+            c = (isalnum(c) || c == '\'') ? (unsigned char)tolower(c) : ' ';
+        }
+        norm[n++] = (char)c;
+    }
+
+    size_t count = 0;
+    char** words = (char**)malloc((len / 2 + 1) * sizeof(char*));
+    if (norm && words) {
+        norm[n] = '\0';
+        char* save = NULL;
+        for (char* tok = strtok_r(norm, " \t\r\n", &save); tok; tok = strtok_r(NULL, " \t\r\n", &save)) {
+            words[count++] = strdup(tok);
+        }
+    }
+    free(norm);
+    *words_out = words;
+    return count;
+}
+
+static void free_words(char** words, size_t count) {
+    for (size_t i = 0; i < count; i++) free(words[i]);
+    free(words);
+}
+
+/**
+ * Word-level Levenshtein distance (substitutions + deletions + insertions)
+ */
+static uint32_t word_errors(const char* reference, const char* hypothesis, uint32_t* ref_words) {
+    char** ref = NULL;
+    char** hyp = NULL;
+    size_t nr = tokenize_words(reference, &ref);
+    size_t nh = tokenize_words(hypothesis, &hyp);
+    *ref_words = (uint32_t)nr;
+
+    uint32_t* prev = (uint32_t*)malloc((nh + 1) * sizeof(uint32_t));
+    uint32_t* cur = (uint32_t*)malloc((nh + 1) * sizeof(uint32_t));
+    uint32_t distance = (uint32_t)(nr > nh ? nr : nh);
+    if (prev && cur) {
+        for (size_t j = 0; j <= nh; j++) prev[j] = (uint32_t)j;
+        for (size_t i = 1; i <= nr; i++) {
+            cur[0] = (uint32_t)i;
+            for (size_t j = 1; j <= nh; j++) {
+                uint32_t sub = prev[j - 1] + (strcmp(ref[i - 1], hyp[j - 1]) != 0);
+                uint32_t del = prev[j] + 1;
+                uint32_t ins = cur[j - 1] + 1;
+                cur[j] = sub < del ? (sub < ins ? sub : ins) : (del < ins ? del : ins);
+            }
+            uint32_t* swap = prev;
+            prev = cur;
+            cur = swap;
+        }
+        distance = prev[nh];
+    }
+    free(prev);
+    free(cur);
+    free_words(ref, nr);
+    free_words(hyp, nh);
+    return distance;
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+/**
+ * Reset the kernel's peak-RSS mark so each run reports its own peak (Linux)
+ */
+static void reset_peak_rss(void) {
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (fp) {
+        fputs("5", fp);
+        fclose(fp);
+    }
+}
+
+static long peak_rss_kb(void) {
+    FILE* fp = fopen("/proc/self/status", "r");
+    if (fp) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+        }
+        fclose(fp);
+        if (kb >= 0) return kb;
+    }
+    // Process lifetime peak: runs after the first include earlier models
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static int compare_double(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static double percentile(const double* sorted, size_t count, double p) {
+    if (count == 0) return 0.0;
+    size_t index = (size_t)(p / 100.0 * (double)(count - 1) + 0.5);
+    return sorted[index < count ? index : count - 1];
+}
+
+static void record_chunk(bench_run_t* run, double ms) {
+    if (run->chunk_count == run->chunk_capacity) {
+        size_t capacity = run->chunk_capacity ? run->chunk_capacity * 2 : 1024;
+        double* grown = (double*)realloc(run->chunk_ms, capacity * sizeof(double));
+        if (!grown) return;
+        run->chunk_ms = grown;
+        run->chunk_capacity = capacity;
+    }
+    run->chunk_ms[run->chunk_count++] = ms;
+}
+
+static void append_text(char** transcript, const char* text) {
+    if (!text || !text[0]) return;
+    size_t old_len = *transcript ? strlen(*transcript) : 0;
+    char* grown = (char*)realloc(*transcript, old_len + strlen(text) + 2);
+    if (!grown) return;
+    if (old_len > 0) grown[old_len++] = ' ';
+    strcpy(grown + old_len, text);
+    *transcript = grown;
+}
+
+/**
+ * Stream one recording through the runtime
+ *
+ * First-result latency is measured on a simulated capture clock: chunk i
+ * becomes available at (i + 1) * chunk_ms, and a call starts once both the
+ * chunk has arrived and the previous call has returned. It is the clock
+ * reading when the first text comes back.
+ */
+static void run_item(ethervox_stt_runtime_t* runtime, bench_run_t* run, const bench_item_t* item,
+                     uint32_t chunk_ms, bench_item_result_t* out) {
+    const uint32_t chunk = SAMPLE_RATE * chunk_ms / 1000;
+    double clock = 0.0;
+    out->first_result_ms = -1.0;
+
+    if (ethervox_stt_start(runtime) != ETHERVOX_SUCCESS) {
+        return;
+    }
+    for (uint32_t offset = 0; offset < item->sample_count; offset += chunk) {
+        uint32_t size = item->sample_count - offset < chunk ? item->sample_count - offset : chunk;
+        ethervox_audio_buffer_t buffer = {
+            .data = item->samples + offset,
+            .size = size,
+            .channels = 1,
+            .timestamp_us = (uint64_t)offset * 1000000 / SAMPLE_RATE,
+        };
+        ethervox_stt_result_t result;
+        memset(&result, 0, sizeof(result));
+
+        double start = now_ms();
+        ethervox_result_t ret = ethervox_stt_process(runtime, &buffer, &result);
+        double elapsed = now_ms() - start;
+        record_chunk(run, elapsed);
+        out->process_ms += elapsed;
+
+        double available = (double)(offset + size) * 1000.0 / SAMPLE_RATE;
+        clock = (clock > available ? clock : available) + elapsed;
+
+        if (ret == ETHERVOX_SUCCESS && result.text && result.text[0]) {
+            if (out->first_result_ms < 0.0) out->first_result_ms = clock;
+            if (!result.is_partial) append_text(&out->hypothesis, result.text);
+        }
+        ethervox_stt_result_free(&result);
+    }
+
+    ethervox_stt_result_t result;
+    memset(&result, 0, sizeof(result));
+    double start = now_ms();
+    ethervox_result_t ret = ethervox_stt_finalize(runtime, &result);
+    double elapsed = now_ms() - start;
+    out->process_ms += elapsed;
+    clock += elapsed;
+    if (ret == ETHERVOX_SUCCESS && result.text && result.text[0]) {
+        if (out->first_result_ms < 0.0) out->first_result_ms = clock;
+        append_text(&out->hypothesis, result.text);
+    }
+    ethervox_stt_result_free(&result);
+    ethervox_stt_stop(runtime);
+
+    out->errors = word_errors(item->reference, out->hypothesis, &out->ref_words);
+}
+
+static void run_backend(bench_run_t* run, const bench_item_t* items, size_t item_count,
+                        uint32_t chunk_ms, const char* language) {
+    ethervox_stt_config_t config = ethervox_stt_get_default_config();
+    config.backend = run->backend;
+    config.model_path = run->model_path;
+    config.language = language;
+    config.threads = run->threads;
+
+    ethervox_stt_runtime_t runtime;
+    memset(&runtime, 0, sizeof(runtime));
+    reset_peak_rss();
+
+    double start = now_ms();
+    run->init_error = ethervox_stt_init(&runtime, &config);
+    run->init_ms = now_ms() - start;
+    if (run->init_error != ETHERVOX_SUCCESS) {
+        run->skipped = true;
+        fprintf(stderr, "%s %s: init failed (%s) - skipped\n", run->backend_name, run->model_path,
+                ethervox_error_string(run->init_error));
+        return;
+    }
+
+    run->items = (bench_item_result_t*)calloc(item_count, sizeof(bench_item_result_t));
+    if (!run->items) {
+        run->skipped = true;
+        ethervox_stt_cleanup(&runtime);
+        return;
+    }
+    for (size_t i = 0; i < item_count; i++) {
+        fprintf(stderr, "  [%s] %s (%zu/%zu)\n", run->backend_name, items[i].name, i + 1, item_count);
+        run_item(&runtime, run, &items[i], chunk_ms, &run->items[i]);
+    }
+    run->peak_rss_kb = peak_rss_kb();
+    ethervox_stt_cleanup(&runtime);
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+typedef struct {
+    double wer;
+    double rtf;
+    double first_result_ms;  // Mean over recordings that produced text
+    double p50, p90, p99, max;
+} bench_summary_t;
+
+static bench_summary_t summarize(bench_run_t* run, const bench_item_t* items, size_t item_count) {
+    bench_summary_t s;
+    memset(&s, 0, sizeof(s));
+    uint64_t errors = 0, ref_words = 0, samples = 0;
+    double process_ms = 0.0, first_sum = 0.0;
+    size_t first_count = 0;
+    for (size_t i = 0; i < item_count; i++) {
+        errors += run->items[i].errors;
+        ref_words += run->items[i].ref_words;
+        samples += items[i].sample_count;
+        process_ms += run->items[i].process_ms;
+        if (run->items[i].first_result_ms >= 0.0) {
+            first_sum += run->items[i].first_result_ms;
+            first_count++;
+        }
+    }
+    s.wer = ref_words ? (double)errors / (double)ref_words : 0.0;
+    s.rtf = samples ? process_ms / ((double)samples * 1000.0 / SAMPLE_RATE) : 0.0;
+    s.first_result_ms = first_count ? first_sum / (double)first_count : -1.0;
+
+    qsort(run->chunk_ms, run->chunk_count, sizeof(double), compare_double);
+    s.p50 = percentile(run->chunk_ms, run->chunk_count, 50.0);
+    s.p90 = percentile(run->chunk_ms, run->chunk_count, 90.0);
+    s.p99 = percentile(run->chunk_ms, run->chunk_count, 99.0);
+    s.max = run->chunk_count ? run->chunk_ms[run->chunk_count - 1] : 0.0;
+    return s;
+}
+
+static void json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* p = (const unsigned char*)(text ? text : ""); *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(out, "\\%c", *p);
+        } else if (*p == '\n') {
+            fputs("\\n", out);
+        } else if (*p < 0x20) {
+            fprintf(out, "\\u%04x", *p);
+        } else {
+            fputc(*p, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void write_json(FILE* out, bench_run_t* runs, size_t run_count, const bench_item_t* items,
+                       size_t item_count, uint32_t chunk_ms, const char* language) {
+    char timestamp[32];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(out, "{\n  \"commit\": ");
+    json_string(out, ETHERVOX_GIT_COMMIT);
+    fprintf(out, ",\n  \"version\": ");
+    json_string(out, ETHERVOX_BACKEND_VERSION);
+    fprintf(out, ",\n  \"timestamp\": \"%s\",\n  \"chunk_ms\": %u,\n  \"language\": ", timestamp, chunk_ms);
+    json_string(out, language);
+    fprintf(out, ",\n  \"recordings\": %zu,\n", item_count);
+    fprintf(out, "  \"tunables\": {\n");
+    fprintf(out, "    \"ETHERVOX_WHISPER_BEAM_SIZE\": %d,\n", ETHERVOX_WHISPER_BEAM_SIZE);
+    fprintf(out, "    \"ETHERVOX_WHISPER_THREADS\": %d,\n", ETHERVOX_WHISPER_THREADS);
+    fprintf(out, "    \"ETHERVOX_WHISPER_NO_SPEECH_THRESHOLD\": %.3f,\n", ETHERVOX_WHISPER_NO_SPEECH_THRESHOLD);
+    fprintf(out, "    \"ETHERVOX_WHISPER_LOGPROB_THRESHOLD\": %.3f,\n", ETHERVOX_WHISPER_LOGPROB_THRESHOLD);
+    fprintf(out, "    \"ETHERVOX_WHISPER_ENTROPY_THRESHOLD\": %.3f,\n", ETHERVOX_WHISPER_ENTROPY_THRESHOLD);
+    fprintf(out, "    \"ETHERVOX_WHISPER_ENDPOINT_MODE\": %d,\n", ETHERVOX_WHISPER_ENDPOINT_MODE);
+    fprintf(out, "    \"ETHERVOX_WHISPER_VAD_END_SILENCE_MS\": %d,\n", ETHERVOX_WHISPER_VAD_END_SILENCE_MS);
+    fprintf(out, "    \"ETHERVOX_WHISPER_MAX_UTTERANCE_MS\": %d,\n", ETHERVOX_WHISPER_MAX_UTTERANCE_MS);
+    fprintf(out, "    \"ETHERVOX_WHISPER_CONTEXT_CARRY\": %d\n", ETHERVOX_WHISPER_CONTEXT_CARRY);
+    fprintf(out, "  },\n  \"runs\": [");
+
+    for (size_t r = 0; r < run_count; r++) {
+        bench_run_t* run = &runs[r];
+        fprintf(out, "%s\n    {\n      \"backend\": \"%s\",\n      \"model\": ", r ? "," : "",
+                run->backend_name);
+        json_string(out, run->model_path);
+        fprintf(out, ",\n      \"threads\": %u,\n", run->threads);
+        if (run->skipped) {
+            fprintf(out, "      \"skipped\": true,\n      \"error\": ");
+            json_string(out, ethervox_error_string(run->init_error));
+            fprintf(out, "\n    }");
+            continue;
+        }
+        bench_summary_t s = summarize(run, items, item_count);
+        fprintf(out, "      \"wer\": %.4f,\n      \"rtf\": %.4f,\n", s.wer, s.rtf);
+        fprintf(out, "      \"init_ms\": %.1f,\n      \"first_result_ms\": %.1f,\n", run->init_ms,
+                s.first_result_ms);
+        fprintf(out, "      \"chunk_latency_ms\": {\"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f},\n",
+                s.p50, s.p90, s.p99, s.max);
+        fprintf(out, "      \"peak_rss_kb\": %ld,\n      \"recordings\": [", run->peak_rss_kb);
+        for (size_t i = 0; i < item_count; i++) {
+            const bench_item_result_t* it = &run->items[i];
+            fprintf(out, "%s\n        {\"name\": ", i ? "," : "");
+            json_string(out, items[i].name);
+            fprintf(out, ", \"seconds\": %.2f, \"errors\": %u, \"ref_words\": %u, \"process_ms\": %.1f, "
+                         "\"first_result_ms\": %.1f, \"hypothesis\": ",
+                    (double)items[i].sample_count / SAMPLE_RATE, it->errors, it->ref_words, it->process_ms,
+                    it->first_result_ms);
+            json_string(out, it->hypothesis);
+            fputc('}', out);
+        }
+        fprintf(out, "\n      ]\n    }");
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+static void print_report(FILE* out, bench_run_t* runs, size_t run_count, const bench_item_t* items, size_t item_count) {
+    fprintf(out, "═══════════════════════════════════════════════════════════════════════════════\n");
+    fprintf(out, " STT Benchmark Report (%zu recordings, commit %s)\n", item_count, ETHERVOX_GIT_COMMIT);
+    fprintf(out, "═══════════════════════════════════════════════════════════════════════════════\n\n");
+    fprintf(out, "%-8s %-28s %3s %7s %6s %9s %8s %8s %8s %9s\n", "Backend", "Model", "Thr", "WER", "RTF",
+           "First(ms)", "p50(ms)", "p90(ms)", "p99(ms)", "RSS(MB)");
+    for (size_t r = 0; r < run_count; r++) {
+        bench_run_t* run = &runs[r];
+        const char* model = run->model_path;
+        size_t len = strlen(model);
+        if (len > 28) model += len - 28;
+        if (run->skipped) {
+            fprintf(out, "%-8s %-28s %3u   skipped: %s\n", run->backend_name, model, run->threads,
+                   ethervox_error_string(run->init_error));
+            continue;
+        }
+        bench_summary_t s = summarize(run, items, item_count);
+        fprintf(out, "%-8s %-28s %3u %6.2f%% %6.3f %9.0f %8.1f %8.1f %8.1f %9.1f\n", run->backend_name, model,
+               run->threads, s.wer * 100.0, s.rtf, s.first_result_ms, s.p50, s.p90, s.p99,
+               run->peak_rss_kb / 1024.0);
+    }
+    fprintf(out, "\n");
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --data DIR [--whisper MODEL]... [--vosk MODEL]...\n"
+            "          [--threads N]... [--chunk-ms MS] [--language CODE] [--json FILE]\n\n"
+            "  --data DIR      Corpus of <name>.wav (16 kHz mono s16) + <name>.txt references\n"
+            "  --whisper MODEL Whisper model to benchmark (repeat for several sizes)\n"
+            "  --vosk MODEL    Vosk model directory to benchmark\n"
+            "  --threads N     Whisper decoder threads (repeat to sweep; default: build default)\n"
+            "  --chunk-ms MS   Capture chunk fed to process() (default 100)\n"
+            "  --language CODE Language passed to the backends (default en)\n"
+            "  --json FILE     Write the JSON report to FILE (- for stdout)\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* data_dir = NULL;
+    const char* json_path = NULL;
+    const char* language = "en";
+    uint32_t chunk_ms = 100;
+    const char* whisper_models[MAX_RUNS];
+    const char* vosk_models[MAX_RUNS];
+    uint32_t thread_counts[MAX_THREAD_COUNTS];
+    size_t n_whisper = 0, n_vosk = 0, n_threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(arg, "--data") == 0) {
+            data_dir = value;
+        } else if (strcmp(arg, "--whisper") == 0 && n_whisper < MAX_RUNS) {
+            whisper_models[n_whisper++] = value;
+        } else if (strcmp(arg, "--vosk") == 0 && n_vosk < MAX_RUNS) {
+            vosk_models[n_vosk++] = value;
+        } else if (strcmp(arg, "--threads") == 0 && n_threads < MAX_THREAD_COUNTS) {
+            thread_counts[n_threads++] = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--chunk-ms") == 0) {
+            chunk_ms = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--language") == 0) {
+            language = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            json_path = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (!data_dir || (n_whisper == 0 && n_vosk == 0) || chunk_ms < 10) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (n_threads == 0) {
+        thread_counts[n_threads++] = 0;
+    }
+
+    ethervox_log_set_level(ETHERVOX_LOG_LEVEL_WARN);
+
+    bench_item_t* items = NULL;
+    size_t item_count = load_corpus(data_dir, &items);
+    if (item_count == 0) {
+        fprintf(stderr, "No usable <name>.wav + <name>.txt pairs in %s\n", data_dir);
+        free(items);
+        return 1;
+    }
+
+    bench_run_t runs[MAX_RUNS];
+    size_t run_count = 0;
+    memset(runs, 0, sizeof(runs));
+    for (size_t m = 0; m < n_whisper; m++) {
+        for (size_t t = 0; t < n_threads && run_count < MAX_RUNS; t++) {
+            runs[run_count++] = (bench_run_t){.backend_name = "whisper",
+                                              .backend = ETHERVOX_STT_BACKEND_WHISPER,
+                                              .model_path = whisper_models[m],
+                                              .threads = thread_counts[t]};
+        }
+    }
+    for (size_t m = 0; m < n_vosk && run_count < MAX_RUNS; m++) {
+        runs[run_count++] = (bench_run_t){
+            .backend_name = "vosk", .backend = ETHERVOX_STT_BACKEND_VOSK, .model_path = vosk_models[m]};
+    }
+
+    for (size_t r = 0; r < run_count; r++) {
+        fprintf(stderr, "Run %zu/%zu: %s %s (threads %u)\n", r + 1, run_count, runs[r].backend_name,
+                runs[r].model_path, runs[r].threads);
+        run_backend(&runs[r], items, item_count, chunk_ms, language);
+        // Unreferenced models would otherwise linger into the next run's RSS
+        ethervox_stt_model_trim(0);
+    }
+
+    // With the JSON on stdout the table goes to stderr
+    bool json_stdout = json_path && strcmp(json_path, "-") == 0;
+    print_report(json_stdout ? stderr : stdout, runs, run_count, items, item_count);
+    if (json_path) {
+        FILE* out = json_stdout ? stdout : fopen(json_path, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", json_path);
+        } else {
+            write_json(out, runs, run_count, items, item_count, chunk_ms, language);
+            if (out != stdout) fclose(out);
+        }
+    }
+
+    for (size_t r = 0; r < run_count; r++) {
+        if (runs[r].items) {
+            for (size_t i = 0; i < item_count; i++) free(runs[r].items[i].hypothesis);
+        }
+        free(runs[r].items);
+        free(runs[r].chunk_ms);
+    }
+    for (size_t i = 0; i < item_count; i++) {
+        free(items[i].name);
+        free(items[i].samples);
+        free(items[i].reference);
+    }
+    free(items);
+    return ETHERVOX_SUCCESS;
+}
@@ -122,6 +122,67 @@ static void test_reference_buffer_overflow(void) {
     printf("✓ Overflow test passed\n");
 }
 
+// Test 3b: Timestamp-aligned reads
+static void test_reference_buffer_timed(void) {
+    printf("\n=== Test 3b: Timestamp-Aligned Reference ===\n");
+    
+    ethervox_reference_buffer_t* buffer = ethervox_reference_buffer_create_timed(SAMPLE_RATE, SAMPLE_RATE);
+    assert(buffer != NULL);
+    
+    // 100 ms of playback reaching the speaker at t = 1 s
+    float samples[1600];
+    for (size_t i = 0; i < 1600; i++) {
+        samples[i] = (float)i;
+    }
+    assert(ethervox_reference_buffer_write_at(buffer, samples, 1600, 1000000) == 1600);
+    
+    // Mic frame captured 5 ms before playback starts: 80 samples of silence first
+    float output[FRAME_SIZE];
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 995000) == 80);
+    assert(output[79] == 0.0f && output[80] == 0.0f && output[81] == 1.0f);
+    printf("✓ Leading silence before playback starts\n");
+    
+    // Next frame continues where the last one stopped
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 1005000) == FRAME_SIZE);
+    assert(output[0] == 80.0f);
+    
+    // Capture skipped ahead 35 ms (e.g. the reader was descheduled): stale samples dropped
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 1050000) == FRAME_SIZE);
+    assert(output[0] == 800.0f);
+    printf("✓ Samples that played before the capture time are skipped\n");
+    
+    // A 2 ms timestamp wobble does not make the stream slip
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 1062000) == FRAME_SIZE);
+    assert(output[0] == 960.0f);
+    printf("✓ Jitter below the slip tolerance is absorbed\n");
+    
+    // Everything queued is older than the capture: silence
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 2000000) == 0);
+    assert(output[0] == 0.0f && ethervox_reference_buffer_is_empty(buffer));
+    
+    // Full buffer: the block is dropped and the stale backlog flushed on the next read
+    assert(ethervox_reference_buffer_write_at(buffer, samples, 1600, 3000000) == 1600);
+    for (int i = 0; i < 9; i++) {
+        ethervox_reference_buffer_write_at(buffer, samples, 1600, 0);
+    }
+    assert(ethervox_reference_buffer_write_at(buffer, samples, 1600, 0) == 0);
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 3000000) == 0);
+    assert(ethervox_reference_buffer_write_at(buffer, samples, 1600, 3500000) == 1600);
+    assert(ethervox_reference_buffer_read_at(buffer, output, FRAME_SIZE, 3500000) == FRAME_SIZE);
+    assert(output[1] == 1.0f);
+    printf("✓ Overflow flushes stale reference instead of dropping fresh audio\n");
+    
+    ethervox_reference_buffer_destroy(buffer);
+    
+    // Untimed writes fall back to FIFO order
+    buffer = ethervox_reference_buffer_create(1000);
+    assert(ethervox_reference_buffer_write(buffer, samples, 100) == 100);
+    assert(ethervox_reference_buffer_read_at(buffer, output, 50, 123456789) == 50);
+    assert(output[49] == 49.0f);
+    ethervox_reference_buffer_destroy(buffer);
+    printf("✓ Timestamp-aligned reference test passed\n");
+}
+
 // Test 4: AEC passthrough mode (no Speex)
 static void test_aec_passthrough(void) {
     printf("\n=== Test 4: AEC Passthrough Mode ===\n");
@@ -289,6 +350,7 @@ int main(void) {
     test_reference_buffer_basic();
     test_reference_buffer_wraparound();
     test_reference_buffer_overflow();
+    test_reference_buffer_timed();
     test_aec_passthrough();
     test_aec_speex();
     test_full_workflow();
@@ -122,6 +122,65 @@ void test_manifest_roundtrip(void) {
     printf("✓ PASS\n");
 }
 
+// Test voice command grammar built from trigger phrases
+void test_trigger_grammar(void) {
+    printf("[TEST] Trigger phrase grammar... ");
+    
+    ethervox_tool_registry_t registry;
+    ethervox_tool_registry_init(&registry, 4);
+    ethervox_tool_t time_tool = { .name = "get_time", .description = "Current time" };
+    ethervox_tool_t memory_tool = { .name = "memory_store", .description = "Remember a fact" };
+    ethervox_tool_registry_add(&registry, &time_tool);
+    ethervox_tool_registry_add(&registry, &memory_tool);
+    
+    const char* test_path = "/tmp/test_tools_triggers.bin";
+    assert(ethervox_tool_registry_export_manifest(&registry, test_path) == 0);
+    
+    // Export writes no triggers, so patch them into the detail records and
+    // reopen (the registry keeps its file handle, with buffered details)
+    tool_manifest_registry_t manifest;
+    assert(ethervox_tool_manifest_init(&manifest, test_path) == 0);
+    const char* triggers[2][3] = {
+        { "What time is it?", "Current  TIME", NULL },
+        { "Remember this", "what time is it", "..." },
+    };
+    FILE* fp = fopen(test_path, "r+b");
+    assert(fp != NULL);
+    for (uint32_t i = 0; i < 2; i++) {
+        tool_detail_header_t detail;
+        fseek(fp, manifest.index[i].detail_offset, SEEK_SET);
+        assert(fread(&detail, sizeof(detail), 1, fp) == 1);
+        detail.trigger_count = 0;
+        for (int t = 0; t < 3 && triggers[i][t]; t++) {
+            snprintf(detail.triggers[detail.trigger_count++], sizeof(detail.triggers[0]), "%s", triggers[i][t]);
+        }
+        fseek(fp, manifest.index[i].detail_offset, SEEK_SET);
+        assert(fwrite(&detail, sizeof(detail), 1, fp) == 1);
+    }
+    fclose(fp);
+    ethervox_tool_manifest_cleanup(&manifest);
+    assert(ethervox_tool_manifest_init(&manifest, test_path) == 0);
+    
+    // Normalized, de-duplicated, with [unk] for out-of-grammar speech
+    char grammar[512];
+    int len = ethervox_tool_build_trigger_grammar(&manifest, grammar, sizeof(grammar));
+    assert(len == (int)strlen(grammar));
+    assert(strcmp(grammar, "[\"what time is it\", \"current time\", \"remember this\", \"[unk]\"]") == 0);
+    
+    // Disabled tools contribute no phrases
+    ethervox_tool_manifest_disable(&manifest, "get_time");
+    len = ethervox_tool_build_trigger_grammar(&manifest, grammar, sizeof(grammar));
+    assert(strcmp(grammar, "[\"remember this\", \"what time is it\", \"[unk]\"]") == 0);
+    
+    assert(ethervox_tool_build_trigger_grammar(&manifest, grammar, 16) == ETHERVOX_ERROR_BUFFER_TOO_SMALL);
+    
+    ethervox_tool_manifest_cleanup(&manifest);
+    ethervox_tool_registry_cleanup(&registry);
+    remove(test_path);
+    
+    printf("✓ PASS\n");
+}
+
 // Test token count estimation
 void test_token_count_estimation(void) {
     printf("[TEST] Token count estimation... ");
@@ -179,6 +238,7 @@ int main(void) {
     test_minimal_system_prompt();
     test_token_count_estimation();
     test_manifest_roundtrip();
+    test_trigger_grammar();
     
     printf("\n");
     printf("═══════════════════════════════════════════════════════════\n");
@@ -0,0 +1,244 @@
+/**
+ * @file test_audio_buffer.c
+ * @brief Unit tests for the SPSC audio ring buffer
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/audio_buffer.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_capacity_and_copy(void) {
+    printf("Testing capacity rounding and copying...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(1000, 16000);
+    assert(ring != NULL);
+    assert(ethervox_audio_ring_capacity(ring) == 1024);
+    assert(ethervox_audio_ring_write_space(ring) == 1024);
+    assert(ethervox_audio_ring_available(ring) == 0);
+
+    float in[600], out[600];
+    for (int i = 0; i < 600; i++) in[i] = (float)i;
+
+    // Push the indices past the end so the next block wraps
+    for (int round = 0; round < 3; round++) {
+        assert(ethervox_audio_ring_write(ring, in, 600, 0) == 600);
+        assert(ethervox_audio_ring_available(ring) == 600);
+        assert(ethervox_audio_ring_read(ring, out, 600, NULL) == 600);
+        assert(memcmp(in, out, sizeof(in)) == 0);
+    }
+
+    assert(ethervox_audio_ring_create(0, 16000) == NULL);
+    ethervox_audio_ring_destroy(ring);
+    ethervox_audio_ring_destroy(NULL);
+    printf("  ✓ 1000 rounds up to 1024, wrapped copies round-trip\n");
+}
+
+void test_spans(void) {
+    printf("Testing zero-copy spans...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(16, 0);
+    assert(ring != NULL);
+    ethervox_audio_span_t span;
+
+    // Move both indices to 12 so the free region wraps after 4 slots
+    float fill[12] = {0};
+    assert(ethervox_audio_ring_write(ring, fill, 12, 0) == 12);
+    assert(ethervox_audio_ring_read(ring, fill, 12, NULL) == 12);
+
+    assert(ethervox_audio_ring_begin_write(ring, &span) == 16);
+    assert(span.position == 12);
+    assert(span.size[0] == 4 && span.size[1] == 12);
+    assert(span.data[1] != NULL);
+    for (uint32_t i = 0; i < 4; i++) span.data[0][i] = (float)i;
+    for (uint32_t i = 0; i < 6; i++) span.data[1][i] = (float)(4 + i);
+    ethervox_audio_ring_end_write(ring, 10, 0);
+
+    assert(ethervox_audio_ring_begin_read(ring, &span) == 10);
+    assert(span.position == 12);
+    assert(span.size[0] == 4 && span.size[1] == 6);
+    for (uint32_t i = 0; i < 4; i++) assert(span.data[0][i] == (float)i);
+    for (uint32_t i = 0; i < 6; i++) assert(span.data[1][i] == (float)(4 + i));
+    ethervox_audio_ring_end_read(ring, 7);
+    assert(ethervox_audio_ring_available(ring) == 3);
+
+    // A contiguous region has no second segment
+    assert(ethervox_audio_ring_begin_read(ring, &span) == 3);
+    assert(span.size[0] == 3 && span.size[1] == 0 && span.data[1] == NULL);
+    assert(span.data[0][0] == 7.0f);
+
+    ethervox_audio_ring_destroy(ring);
+    printf("  ✓ Two-segment views expose the wrapped region in place\n");
+}
+
+void test_overrun_underrun(void) {
+    printf("Testing overrun and underrun accounting...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(64, 0);
+    assert(ring != NULL);
+    float block[100];
+    for (int i = 0; i < 100; i++) block[i] = (float)i;
+
+    // Full ring keeps the oldest samples and drops the rest
+    assert(ethervox_audio_ring_write(ring, block, 100, 0) == 64);
+    assert(ethervox_audio_ring_write(ring, block, 10, 0) == 0);
+
+    float out[100];
+    assert(ethervox_audio_ring_read(ring, out, 100, NULL) == 64);
+    assert(out[63] == 63.0f);
+    for (int i = 64; i < 100; i++) assert(out[i] == 0.0f);
+
+    ethervox_audio_ring_stats_t stats;
+    assert(ethervox_audio_ring_get_stats(ring, &stats) == ETHERVOX_SUCCESS);
+    assert(stats.written == 64 && stats.read == 64);
+    assert(stats.overruns == 2 && stats.dropped == 46);
+    assert(stats.underruns == 1);
+    assert(stats.high_water == 64);
+
+    assert(ethervox_audio_ring_get_stats(NULL, &stats) == ETHERVOX_ERROR_NULL_POINTER);
+    ethervox_audio_ring_reset(ring);
+    assert(ethervox_audio_ring_get_stats(ring, &stats) == ETHERVOX_SUCCESS);
+    assert(stats.written == 0 && stats.overruns == 0 && stats.underruns == 0);
+
+    ethervox_audio_ring_destroy(ring);
+    printf("  ✓ Overruns drop newest samples, short reads zero-fill\n");
+}
+
+void test_timestamps(void) {
+    printf("Testing sample timestamps...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(4096, 16000);
+    assert(ring != NULL);
+    float block[160] = {0};
+    uint64_t ts = 0;
+
+    // No timestamps written yet
+    assert(ethervox_audio_ring_write(ring, block, 160, 0) == 160);
+    assert(ethervox_audio_ring_read(ring, block, 160, &ts) == 160);
+    assert(ts == 0);
+
+    // 10 ms blocks stamped at capture time
+    assert(ethervox_audio_ring_write(ring, block, 160, 1000000) == 160);
+    assert(ethervox_audio_ring_write(ring, block, 160, 0) == 160);
+    assert(ethervox_audio_ring_read(ring, block, 80, &ts) == 80);
+    assert(ts == 1000000);
+    assert(ethervox_audio_ring_read(ring, block, 160, &ts) == 160);
+    assert(ts == 1005000);
+
+    // A late block re-anchors the clock (e.g. after a capture gap)
+    assert(ethervox_audio_ring_write(ring, block, 160, 2000000) == 160);
+    assert(ethervox_audio_ring_read(ring, block, 160, &ts) == 160);
+    assert(ts == 1995000);  // The 80 leftover samples precede the new anchor
+    assert(ethervox_audio_ring_timestamp_at(ring, 480) == 2000000);
+    assert(ethervox_audio_ring_timestamp_at(ring, 640) == 2010000);
+
+    ethervox_audio_ring_destroy(ring);
+    printf("  ✓ Positions map to capture time through the latest anchor\n");
+}
+
+void test_flush(void) {
+    printf("Testing flush requests...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(256, 0);
+    assert(ring != NULL);
+    float block[100] = {0};
+
+    assert(ethervox_audio_ring_write(ring, block, 100, 0) == 100);
+    ethervox_audio_ring_request_flush(ring);
+    assert(ethervox_audio_ring_available(ring) == 0);
+    block[0] = 42.0f;
+    assert(ethervox_audio_ring_write(ring, block, 10, 0) == 10);
+    assert(ethervox_audio_ring_available(ring) == 10);
+
+    float out[10];
+    assert(ethervox_audio_ring_read(ring, out, 10, NULL) == 10);
+    assert(out[0] == 42.0f);
+
+    ethervox_audio_ring_stats_t stats;
+    ethervox_audio_ring_get_stats(ring, &stats);
+    assert(stats.flushed == 100 && stats.read == 110);
+
+    ethervox_audio_ring_destroy(ring);
+    printf("  ✓ Samples written before the request are discarded\n");
+}
+
+#define STRESS_SAMPLES 500000u
+
+static void* stress_producer(void* arg) {
+    ethervox_audio_ring_t* ring = (ethervox_audio_ring_t*)arg;
+    uint32_t next = 0;
+    while (next < STRESS_SAMPLES) {
+        ethervox_audio_span_t span;
+        uint32_t space = ethervox_audio_ring_begin_write(ring, &span);
+        if (space == 0) {
+            sched_yield();
+            continue;
+        }
+        uint32_t n = (next % 97) + 1;
+        if (n > space) n = space;
+        if (n > STRESS_SAMPLES - next) n = STRESS_SAMPLES - next;
+        for (uint32_t i = 0; i < n; i++) {
+            float* slot = i < span.size[0] ? &span.data[0][i] : &span.data[1][i - span.size[0]];
+            *slot = (float)((next + i) & 0xFFFF);
+        }
+        ethervox_audio_ring_end_write(ring, n, 0);
+        next += n;
+    }
+    return NULL;
+}
+
+void test_threaded_stress(void) {
+    printf("Testing concurrent producer and consumer...\n");
+
+    ethervox_audio_ring_t* ring = ethervox_audio_ring_create(256, 16000);
+    assert(ring != NULL);
+
+    pthread_t producer;
+    assert(pthread_create(&producer, NULL, stress_producer, ring) == 0);
+
+    uint32_t expected = 0;
+    float out[53];
+    while (expected < STRESS_SAMPLES) {
+        uint32_t want = ethervox_audio_ring_available(ring);
+        if (want == 0) {
+            sched_yield();
+            continue;
+        }
+        if (want > 53) want = 53;
+        uint32_t got = ethervox_audio_ring_read(ring, out, want, NULL);
+        assert(got == want);
+        for (uint32_t i = 0; i < got; i++, expected++) {
+            assert(out[i] == (float)(expected & 0xFFFF));
+        }
+    }
+    pthread_join(producer, NULL);
+
+    ethervox_audio_ring_stats_t stats;
+    ethervox_audio_ring_get_stats(ring, &stats);
+    assert(stats.written == STRESS_SAMPLES && stats.read == STRESS_SAMPLES);
+    assert(stats.overruns == 0 && stats.underruns == 0);
+
+    ethervox_audio_ring_destroy(ring);
+    printf("  ✓ %u samples crossed threads in order\n", STRESS_SAMPLES);
+}
+
+int main(void) {
+    printf("=== Audio Ring Buffer Unit Tests ===\n\n");
+
+    test_capacity_and_copy();
+    test_spans();
+    test_overrun_underrun();
+    test_timestamps();
+    test_flush();
+    test_threaded_stress();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
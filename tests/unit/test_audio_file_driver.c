@@ -0,0 +1,335 @@
+/**
+ * @file test_audio_file_driver.c
+ * @brief Unit tests for the file-backed virtual audio device
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/audio_file_driver.h"
+#include "ethervox/audio_buffer.h"
+#include "ethervox/audio_recording.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RATE 16000
+#define PERIOD 160  // 10 ms
+#define PI_D 3.14159265358979323846
+#define CAPTURE_WAV "test_file_driver_capture.wav"
+#define SINK_WAV "test_file_driver_sink.wav"
+
+// Sample i of the capture file: a ramp that never repeats within the test
+static int16_t ramp(uint32_t i) {
+    return (int16_t)((int32_t)(i % 20000) - 10000);
+}
+
+static void write_capture_file(uint32_t frames) {
+    FILE* fp = fopen(CAPTURE_WAV, "wb");
+    assert(fp != NULL);
+    assert(ethervox_audio_write_wav_header(fp, RATE, 1, frames * sizeof(int16_t)) == ETHERVOX_SUCCESS);
+    for (uint32_t i = 0; i < frames; i++) {
+        int16_t s = ramp(i);
+        fwrite(&s, sizeof(s), 1, fp);
+    }
+    fclose(fp);
+}
+
+static void write_tone_file(uint32_t rate, uint32_t frames, float hz) {
+    FILE* fp = fopen(CAPTURE_WAV, "wb");
+    assert(fp != NULL);
+    assert(ethervox_audio_write_wav_header(fp, (int)rate, 1, frames * sizeof(int16_t)) == ETHERVOX_SUCCESS);
+    for (uint32_t i = 0; i < frames; i++) {
+        int16_t s = (int16_t)(16384.0 * sin(2.0 * PI_D * hz * i / rate));
+        fwrite(&s, sizeof(s), 1, fp);
+    }
+    fclose(fp);
+}
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static void open_runtime(ethervox_audio_runtime_t* runtime, const ethervox_audio_file_config_t* file_config) {
+    memset(runtime, 0, sizeof(*runtime));
+    ethervox_audio_config_t config = {0};
+    config.sample_rate = RATE;
+    config.channels = 1;
+    config.bits_per_sample = 16;
+    config.buffer_size = 4096;
+    runtime->config = config;
+    assert(ethervox_audio_register_file_driver(runtime, file_config) == ETHERVOX_SUCCESS);
+    assert(runtime->driver.init(runtime, &config) == ETHERVOX_SUCCESS);
+    assert(runtime->driver.start_capture(runtime) == ETHERVOX_SUCCESS);
+}
+
+// Read until end of stream; returns frames delivered
+static uint32_t drain(ethervox_audio_runtime_t* runtime, float* out, uint32_t capacity, uint64_t* first_ts) {
+    uint32_t total = 0;
+    float chunk[PERIOD];
+    for (;;) {
+        ethervox_audio_buffer_t buffer = {.data = chunk, .size = PERIOD};
+        assert(runtime->driver.read_audio(runtime, &buffer) == ETHERVOX_SUCCESS);
+        if (buffer.size == 0) {
+            break;
+        }
+        if (total == 0 && first_ts) {
+            *first_ts = buffer.timestamp_us;
+        }
+        if (out && total + buffer.size <= capacity) {
+            memcpy(out + total, chunk, buffer.size * sizeof(float));
+        }
+        total += buffer.size;
+    }
+    return total;
+}
+
+void test_fast_replay_is_exact(void) {
+    printf("Testing fast replay of the capture file...\n");
+
+    const uint32_t frames = RATE / 2;
+    write_capture_file(frames);
+
+    ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+    config.capture_path = CAPTURE_WAV;
+    config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+    config.tail_silence_ms = 50;
+
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, &config);
+
+    float* out = (float*)malloc((frames + RATE) * sizeof(float));
+    assert(out != NULL);
+    uint64_t first_ts = 0;
+    uint32_t total = drain(&runtime, out, frames + RATE, &first_ts);
+    assert(total == frames + RATE * 50 / 1000);
+    assert(first_ts != 0);
+    for (uint32_t i = 0; i < frames; i++) {
+        assert(out[i] == (float)ramp(i) / 32768.0f);
+    }
+    for (uint32_t i = frames; i < total; i++) {
+        assert(out[i] == 0.0f);
+    }
+    assert(ethervox_audio_file_capture_finished(&runtime));
+
+    ethervox_audio_capture_stats_t stats;
+    assert(ethervox_audio_get_capture_stats(&runtime, &stats) == ETHERVOX_SUCCESS);
+    assert(stats.frames_captured == total);
+    assert(stats.xruns == 0);
+
+    runtime.driver.cleanup(&runtime);
+    assert(runtime.platform_data == NULL);
+    free(out);
+    printf("  ✓ %u frames sample-exact, then %u of tail silence\n", frames, total - frames);
+}
+
+void test_resampled_capture(void) {
+    printf("Testing a 48 kHz capture file in a 16 kHz runtime...\n");
+
+    const uint32_t file_frames = 48000 / 2;
+    write_tone_file(48000, file_frames, 440.0f);
+
+    ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+    config.capture_path = CAPTURE_WAV;
+    config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+    config.tail_silence_ms = 0;
+
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, &config);
+
+    // No buffer: the driver hands out one of config.buffer_size frames
+    ethervox_audio_buffer_t buffer = {0};
+    assert(runtime.driver.read_audio(&runtime, &buffer) == ETHERVOX_SUCCESS);
+    assert(buffer.data != NULL && buffer.size == 4096);
+    float first[4096];
+    memcpy(first, buffer.data, sizeof(first));
+    ethervox_audio_buffer_free(&buffer);
+
+    float out[RATE / 2];
+    memcpy(out, first, sizeof(first));
+    uint32_t total = 4096 + drain(&runtime, out + 4096, RATE / 2 - 4096, NULL);
+    assert(total == RATE / 2);
+
+    // In phase with the tone sampled at 16 kHz (edges hold the filter's ramp)
+    float max_error = 0.0f;
+    for (uint32_t i = 100; i < total - 100; i++) {
+        float expected = 0.5f * (float)sin(2.0 * PI_D * 440.0 * i / RATE);
+        float error = fabsf(out[i] - expected);
+        if (error > max_error) max_error = error;
+    }
+    assert(max_error < 0.01f);
+
+    runtime.driver.cleanup(&runtime);
+    remove(CAPTURE_WAV);
+    printf("  ✓ %u frames in, %u out, max error %.5f\n", file_frames, total, max_error);
+}
+
+void test_injected_xruns(void) {
+    printf("Testing injected xruns...\n");
+
+    const uint32_t frames = RATE;
+    write_capture_file(frames);
+
+    ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+    config.capture_path = CAPTURE_WAV;
+    config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+    config.tail_silence_ms = 0;
+    config.xrun_every_ms = 100;
+
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, &config);
+
+    float* out = (float*)malloc(frames * sizeof(float));
+    assert(out != NULL);
+    uint32_t total = drain(&runtime, out, frames, NULL);
+
+    // One 10 ms period lost at 100, 200, ... 900 ms
+    assert(total == frames - 9 * PERIOD);
+    assert(out[1599] == (float)ramp(1599) / 32768.0f);
+    assert(out[1600] == (float)ramp(1600 + PERIOD) / 32768.0f);
+
+    ethervox_audio_capture_stats_t stats;
+    assert(ethervox_audio_get_capture_stats(&runtime, &stats) == ETHERVOX_SUCCESS);
+    assert(stats.xruns == 9);
+
+    runtime.driver.cleanup(&runtime);
+    free(out);
+    printf("  ✓ %llu periods lost, the rest continues from the device position\n",
+           (unsigned long long)stats.xruns);
+}
+
+void test_playback_sink(void) {
+    printf("Testing the playback sink file...\n");
+
+    ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+    config.playback_path = SINK_WAV;
+    config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, &config);
+
+    // Played audio uses the int16 contract of the hardware drivers
+    int16_t pcm[1000];
+    for (uint32_t i = 0; i < 1000; i++) {
+        pcm[i] = ramp(i * 7);
+    }
+    ethervox_audio_buffer_t buffer = {.data = (float*)pcm, .size = sizeof(pcm), .channels = 1};
+    assert(runtime.driver.start_playback(&runtime) == ETHERVOX_SUCCESS);
+    assert(runtime.driver.write_audio(&runtime, &buffer) == ETHERVOX_SUCCESS);
+    assert(runtime.driver.write_audio(&runtime, &buffer) == ETHERVOX_SUCCESS);
+    runtime.driver.cleanup(&runtime);
+
+    float* samples = NULL;
+    uint32_t frames = 0, rate = 0;
+    uint16_t channels = 0;
+    assert(ethervox_audio_read_wav(SINK_WAV, &samples, &frames, &rate, &channels) == ETHERVOX_SUCCESS);
+    assert(frames == 2000 && rate == RATE && channels == 1);
+    for (uint32_t i = 0; i < 2000; i++) {
+        int16_t s = (int16_t)(samples[i] * 32768.0f);
+        assert(s - pcm[i % 1000] >= -1 && s - pcm[i % 1000] <= 1);
+    }
+    free(samples);
+    remove(SINK_WAV);
+    printf("  ✓ Both writes recorded with a valid header\n");
+}
+
+void test_realtime_pacing(void) {
+    printf("Testing real-time pacing with jitter...\n");
+
+    ethervox_audio_file_config_t config = ethervox_audio_file_default_config();
+    config.jitter_us = 4000;
+    config.seed = 42;
+    config.playback_path = SINK_WAV;
+
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, &config);
+    assert(runtime.playback_ring != NULL);
+
+    // 200 ms queued for playback drains over the same wall time as capture
+    int16_t pcm[RATE / 5] = {0};
+    pcm[0] = 1000;
+    ethervox_audio_buffer_t out = {.data = (float*)pcm, .size = sizeof(pcm), .channels = 1};
+    assert(runtime.driver.write_audio(&runtime, &out) == ETHERVOX_SUCCESS);
+
+    const uint32_t wanted = RATE * 3 / 10;  // 300 ms
+    float chunk[PERIOD * 4];
+    uint32_t total = 0;
+    uint64_t start = now_ms();
+    while (total < wanted) {
+        ethervox_audio_buffer_t buffer = {.data = chunk, .size = PERIOD * 4};
+        assert(runtime.driver.read_audio(&runtime, &buffer) == ETHERVOX_SUCCESS);
+        total += buffer.size;
+    }
+    uint64_t elapsed = now_ms() - start;
+    assert(elapsed >= 280 && elapsed < 1000);
+    assert(ethervox_audio_ring_available(runtime.playback_ring) == 0);
+
+    ethervox_audio_capture_stats_t stats;
+    assert(ethervox_audio_get_capture_stats(&runtime, &stats) == ETHERVOX_SUCCESS);
+    assert(stats.period_frames == PERIOD);
+    assert(!ethervox_audio_file_capture_finished(&runtime));  // Silence never ends
+
+    runtime.driver.cleanup(&runtime);
+    assert(runtime.playback_ring == NULL);
+
+    float* samples = NULL;
+    uint32_t frames = 0, rate = 0;
+    uint16_t channels = 0;
+    assert(ethervox_audio_read_wav(SINK_WAV, &samples, &frames, &rate, &channels) == ETHERVOX_SUCCESS);
+    assert(frames == RATE / 5);
+    free(samples);
+    remove(SINK_WAV);
+    printf("  ✓ 300 ms delivered in %llu ms, max period gap %u us\n", (unsigned long long)elapsed,
+           stats.max_wakeup_gap_us);
+}
+
+void test_errors(void) {
+    printf("Testing configuration errors...\n");
+
+    ethervox_audio_runtime_t runtime;
+    memset(&runtime, 0, sizeof(runtime));
+    ethervox_audio_config_t config = {0};
+    config.sample_rate = RATE;
+    config.channels = 1;
+
+    ethervox_audio_file_config_t file_config = ethervox_audio_file_default_config();
+    file_config.capture_path = "does_not_exist.wav";
+    assert(ethervox_audio_register_file_driver(&runtime, &file_config) == ETHERVOX_SUCCESS);
+    assert(runtime.driver.start_capture(&runtime) != ETHERVOX_SUCCESS);
+    assert(runtime.driver.init(&runtime, &config) == ETHERVOX_ERROR_FILE_NOT_FOUND);
+    runtime.driver.cleanup(&runtime);
+
+    // A mono file cannot feed a stereo runtime
+    write_capture_file(RATE / 10);
+    file_config.capture_path = CAPTURE_WAV;
+    config.channels = 2;
+    assert(ethervox_audio_register_file_driver(&runtime, &file_config) == ETHERVOX_SUCCESS);
+    assert(runtime.driver.init(&runtime, &config) == ETHERVOX_ERROR_AUDIO_FORMAT_UNSUPPORTED);
+    runtime.driver.cleanup(&runtime);
+
+    assert(ethervox_audio_register_file_driver(NULL, NULL) != ETHERVOX_SUCCESS);
+    assert(!ethervox_audio_file_capture_finished(NULL));
+    remove(CAPTURE_WAV);
+    printf("  ✓ Missing file and channel mismatch rejected at init\n");
+}
+
+int main(void) {
+    printf("=== File Audio Driver Unit Tests ===\n\n");
+
+    test_fast_replay_is_exact();
+    test_resampled_capture();
+    test_injected_xruns();
+    test_playback_sink();
+    test_realtime_pacing();
+    test_errors();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
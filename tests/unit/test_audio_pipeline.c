@@ -0,0 +1,483 @@
+/**
+ * @file test_audio_pipeline.c
+ * @brief Unit tests for the declarative audio front end
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // pthread_getaffinity_np
+#endif
+
+#include "ethervox/audio_pipeline.h"
+#include "ethervox/audio_file_driver.h"
+#include "ethervox/audio_recording.h"
+#include "ethervox/config.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PI_F 3.14159265f
+#define RATE 16000
+#define BLOCK 160  // 10 ms at RATE
+#define CAPTURE_WAV "test_pipeline_capture.wav"
+
+// 0.5 s silence, 1 s of a 440 Hz tone, 0.5 s silence
+static void write_capture_file(uint32_t rate) {
+    const uint32_t frames = rate * 2;
+    FILE* fp = fopen(CAPTURE_WAV, "wb");
+    assert(fp != NULL);
+    assert(ethervox_audio_write_wav_header(fp, (int)rate, 1, frames * sizeof(int16_t)) == ETHERVOX_SUCCESS);
+    for (uint32_t i = 0; i < frames; i++) {
+        float t = (float)i / (float)rate;
+        float x = (t >= 0.5f && t < 1.5f) ? 0.3f * sinf(2.0f * PI_F * 440.0f * t) : 0.0f;
+        int16_t s = (int16_t)(x * 32767.0f);
+        fwrite(&s, sizeof(s), 1, fp);
+    }
+    fclose(fp);
+}
+
+// 4-mic circular array: 0.5 s of mic noise, then a broadband talker at 45 degrees joins
+static void write_array_capture_file(const ethervox_beamformer_config_t* array) {
+    const uint32_t frames = RATE * 2;
+    const uint32_t channels = array->channels;
+    double freq[48], phase[48];
+    for (int p = 0; p < 48; p++) {
+        freq[p] = 200.0 + 4800.0 * (double)((p * 7919) % 48) / 48.0 + (double)p;
+        phase[p] = (double)((p * 104729) % 628) / 100.0;
+    }
+    FILE* fp = fopen(CAPTURE_WAV, "wb");
+    assert(fp != NULL);
+    assert(ethervox_audio_write_wav_header(fp, RATE, (int)channels, frames * channels * sizeof(int16_t)) ==
+           ETHERVOX_SUCCESS);
+    uint32_t seed = 99;
+    const double azimuth = 45.0 * PI_F / 180.0;
+    for (uint32_t n = 0; n < frames; n++) {
+        for (uint32_t i = 0; i < channels; i++) {
+            double tau = -(array->mics[i].x * cos(azimuth) + array->mics[i].y * sin(azimuth)) /
+                         ETHERVOX_BEAMFORMER_SPEED_OF_SOUND;
+            double t = (double)n / RATE - tau;
+            double x = 0.0;
+            if (n >= RATE / 2) {
+                for (int p = 0; p < 48; p++) x += 0.04 * sin(2.0 * PI_F * freq[p] * t + phase[p]);
+            }
+            seed = seed * 1103515245u + 12345u;
+            x += 0.01 * ((double)((seed >> 8) & 0xFFFF) / 32768.0 - 1.0);
+            int16_t s = (int16_t)(x * 32767.0);
+            fwrite(&s, sizeof(s), 1, fp);
+        }
+    }
+    fclose(fp);
+}
+
+static void open_runtime(ethervox_audio_runtime_t* runtime, uint32_t rate, uint32_t channels) {
+    memset(runtime, 0, sizeof(*runtime));
+    ethervox_audio_file_config_t file_config = ethervox_audio_file_default_config();
+    file_config.capture_path = CAPTURE_WAV;
+    file_config.pacing = ETHERVOX_AUDIO_FILE_FAST;
+    file_config.tail_silence_ms = 0;
+
+    runtime->config.sample_rate = rate;
+    runtime->config.channels = channels;
+    runtime->config.bits_per_sample = 16;
+    runtime->config.buffer_size = 4096;
+    assert(ethervox_audio_register_file_driver(runtime, &file_config) == ETHERVOX_SUCCESS);
+    assert(runtime->driver.init(runtime, &runtime->config) == ETHERVOX_SUCCESS);
+}
+
+static void wait_for_end(ethervox_audio_runtime_t* runtime) {
+    for (int i = 0; i < 2000 && !ethervox_audio_file_capture_finished(runtime); i++) {
+        usleep(1000);
+    }
+    assert(ethervox_audio_file_capture_finished(runtime));
+    usleep(50000);  // Let the last blocks through the stage threads
+}
+
+typedef struct {
+    atomic_uint blocks;
+    atomic_uint speech_blocks;
+    atomic_uint calls;
+    atomic_uint bad_size;
+    uint64_t next_position;
+    atomic_uint out_of_order;
+    atomic_uint frames;
+    atomic_uint bad_frames;
+    uint64_t last_frame_end;
+    unsigned sleep_us;
+} sink_state_t;
+
+// VAD frames tile the stream: each ends one frame after the last, inside the block
+static unsigned check_frames(const ethervox_pipeline_block_t* block, uint64_t* last_frame_end) {
+    unsigned bad = 0;
+    for (uint32_t i = 0; i < block->vad_frame_count; i++) {
+        const ethervox_vad_frame_t* frame = &block->vad_frames[i];
+        uint64_t end = block->position + frame->end_offset;
+        if (frame->end_offset == 0 || frame->end_offset > block->audio.size ||
+            end != *last_frame_end + frame->length) {
+            bad++;
+        }
+        *last_frame_end = end;
+    }
+    return bad;
+}
+
+static void count_sink(const ethervox_pipeline_block_t* block, void* user_data) {
+    sink_state_t* state = (sink_state_t*)user_data;
+    if (block->audio.size % BLOCK != 0 || block->audio.channels != 1) {
+        atomic_fetch_add(&state->bad_size, 1);
+    }
+    if (block->position != state->next_position) {
+        atomic_fetch_add(&state->out_of_order, 1);
+    }
+    state->next_position = block->position + block->audio.size;
+    atomic_fetch_add(&state->blocks, block->audio.size / BLOCK);
+    atomic_fetch_add(&state->calls, 1);
+    atomic_fetch_add(&state->frames, block->vad_frame_count);
+    atomic_fetch_add(&state->bad_frames, check_frames(block, &state->last_frame_end));
+    if (block->is_speech) {
+        atomic_fetch_add(&state->speech_blocks, 1);
+    }
+    if (state->sleep_us) {
+        usleep(state->sleep_us);
+    }
+}
+
+void test_tap_and_sinks(void) {
+    printf("Testing 48 kHz capture through a tap, an inline sink and a threaded sink...\n");
+
+    write_capture_file(48000);
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, 48000, 1);
+
+    sink_state_t inline_state = {0}, thread_state = {0};
+    ethervox_pipeline_config_t config = ethervox_pipeline_default_config(&runtime);
+    config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].rt_priority = 0;
+    config.threads[ETHERVOX_PIPELINE_STAGE_VAD].own_thread = true;
+
+    ethervox_pipeline_sink_config_t tap = {.name = "tap"};
+    ethervox_pipeline_sink_config_t inline_sink = {.name = "inline", .process = count_sink, .user_data = &inline_state};
+    ethervox_pipeline_sink_config_t thread_sink = {
+        .name = "stt", .process = count_sink, .user_data = &thread_state, .block_ms = 100};
+    thread_sink.thread.own_thread = true;
+    thread_sink.thread.cpu = -1;
+    assert(ethervox_pipeline_add_sink(&config, &tap) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_add_sink(&config, &inline_sink) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_add_sink(&config, &thread_sink) == ETHERVOX_SUCCESS);
+
+    ethervox_pipeline_t* pipeline = NULL;
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_start(pipeline) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_is_running(pipeline));
+    wait_for_end(&runtime);
+
+    // Drain the tap: two seconds at 16 kHz, give or take the resampler
+    float* audio = (float*)malloc(RATE * 3 * sizeof(float));
+    assert(audio != NULL);
+    uint32_t total = 0;
+    uint32_t tap_frames = 0;
+    uint64_t tap_frame_end = 0;
+    uint64_t first_ts = 0;
+    ethervox_pipeline_block_t block;
+    for (;;) {
+        assert(ethervox_pipeline_read(pipeline, 0, audio + total, 10 * BLOCK, 20, &block) == ETHERVOX_SUCCESS);
+        if (block.audio.size == 0) {
+            break;
+        }
+        assert(block.position == total);
+        assert(check_frames(&block, &tap_frame_end) == 0);
+        tap_frames += block.vad_frame_count;
+        if (total == 0) {
+            first_ts = block.audio.timestamp_us;
+        }
+        total += block.audio.size;
+    }
+    assert(total >= 2 * RATE - 2 * BLOCK && total <= 2 * RATE);
+    assert(first_ts != 0);
+
+    // The tone came through the resampler at 440 Hz (about 36 samples a period)
+    int crossings = 0;
+    for (uint32_t i = RATE * 3 / 4; i < RATE * 5 / 4; i++) {
+        crossings += (audio[i - 1] < 0.0f) != (audio[i] < 0.0f);
+    }
+    assert(crossings >= 430 && crossings <= 450);
+
+    ethervox_pipeline_metrics_t metrics;
+    assert(ethervox_pipeline_get_metrics(pipeline, &metrics) == ETHERVOX_SUCCESS);
+    const uint32_t blocks = total / BLOCK;
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].blocks == blocks);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].active);
+    assert(!metrics.stages[ETHERVOX_PIPELINE_STAGE_AEC].active);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_NOISE_SUPPRESSION].blocks == blocks);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_VAD].blocks == blocks);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_VAD].own_thread);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_VAD].queue_high_water >= 1);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_VAD].dropped == 0);
+    assert(metrics.sink_count == 3);
+    assert(metrics.sinks[0].blocks == blocks && metrics.sinks[0].queue_depth == 0);
+    assert(metrics.sinks[1].blocks == blocks && !metrics.sinks[1].own_thread);
+
+    // The inline sink saw every block in order; the threaded one whole 100 ms calls
+    assert(atomic_load(&inline_state.blocks) == blocks);
+    assert(atomic_load(&inline_state.out_of_order) == 0 && atomic_load(&inline_state.bad_size) == 0);
+    assert(atomic_load(&thread_state.blocks) == blocks - blocks % 10);
+    assert(atomic_load(&thread_state.calls) == blocks / 10);
+    assert(atomic_load(&thread_state.out_of_order) == 0 && atomic_load(&thread_state.bad_size) == 0);
+
+    // Speech only around the tone
+    unsigned speech = atomic_load(&inline_state.speech_blocks);
+    assert(speech >= 80 && speech < blocks - 40);
+
+    for (int s = 0; s < ETHERVOX_PIPELINE_STAGE_COUNT; s++) {
+        const ethervox_pipeline_stage_metrics_t* m = &metrics.stages[s];
+        printf("  %-17s blocks %4llu  avg %4u us  max latency %6u us  queue high water %u\n",
+               ethervox_pipeline_stage_name((ethervox_pipeline_stage_t)s), (unsigned long long)m->blocks,
+               m->avg_process_us, m->max_latency_us, m->queue_high_water);
+    }
+
+    // Stopping hands the threaded sink its last, short call
+    assert(ethervox_pipeline_stop(pipeline) == ETHERVOX_SUCCESS);
+    assert(!ethervox_pipeline_is_running(pipeline));
+    assert(atomic_load(&thread_state.blocks) == blocks);
+    assert(atomic_load(&thread_state.calls) == (blocks + 9) / 10);
+    assert(atomic_load(&thread_state.out_of_order) == 0 && atomic_load(&thread_state.bad_size) == 0);
+
+    // One VAD pass, handed to every sink: same frames, tiling the stream
+    const uint32_t frame = RATE * ETHERVOX_VAD_FRAME_MS / 1000;
+    assert(tap_frames == total / frame);
+    assert(atomic_load(&inline_state.frames) == tap_frames && atomic_load(&inline_state.bad_frames) == 0);
+    assert(atomic_load(&thread_state.frames) == tap_frames && atomic_load(&thread_state.bad_frames) == 0);
+    assert(ethervox_pipeline_read(pipeline, 0, audio, BLOCK, 10, &block) == ETHERVOX_ERROR_NOT_INITIALIZED);
+    ethervox_pipeline_destroy(pipeline);
+    runtime.driver.cleanup(&runtime);
+    free(audio);
+    printf("  ✓ %u blocks reached every sink; %u flagged as speech\n", blocks, speech);
+}
+
+void test_slow_sink_drops_without_stalling(void) {
+    printf("Testing that a slow sink drops blocks instead of stalling capture...\n");
+
+    write_capture_file(RATE);
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, RATE, 1);
+
+    sink_state_t slow = {.sleep_us = 20000};
+    ethervox_pipeline_config_t config = ethervox_pipeline_default_config(&runtime);
+    config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].rt_priority = 0;
+    config.queue_ms = 100;
+    config.vad = false;
+
+    ethervox_pipeline_sink_config_t tap = {.name = "tap"};
+    ethervox_pipeline_sink_config_t slow_sink = {.name = "slow", .process = count_sink, .user_data = &slow};
+    slow_sink.thread.own_thread = true;
+    slow_sink.thread.cpu = -1;
+    assert(ethervox_pipeline_add_sink(&config, &slow_sink) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_add_sink(&config, &tap) == ETHERVOX_SUCCESS);
+
+    ethervox_pipeline_t* pipeline = NULL;
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_start(pipeline) == ETHERVOX_SUCCESS);
+    wait_for_end(&runtime);
+
+    ethervox_pipeline_metrics_t metrics;
+    assert(ethervox_pipeline_get_metrics(pipeline, &metrics) == ETHERVOX_SUCCESS);
+    const uint64_t blocks = metrics.stages[ETHERVOX_PIPELINE_STAGE_CAPTURE].blocks;
+    assert(blocks == 2 * RATE / BLOCK);
+    assert(!metrics.stages[ETHERVOX_PIPELINE_STAGE_VAD].active);
+    assert(metrics.sinks[0].dropped > 0);
+    assert(metrics.sinks[0].queue_high_water <= 16);  // 100 ms queue, ring rounded up
+    assert(metrics.sinks[1].dropped > 0);             // The tap was not drained either
+    printf("  ✓ Capture kept all %llu blocks; slow sink dropped %llu, undrained tap %llu\n",
+           (unsigned long long)blocks, (unsigned long long)metrics.sinks[0].dropped,
+           (unsigned long long)metrics.sinks[1].dropped);
+
+    // Without a VAD stage every block counts as speech
+    ethervox_pipeline_block_t block;
+    float audio[BLOCK];
+    assert(ethervox_pipeline_read(pipeline, 1, audio, BLOCK, 10, &block) == ETHERVOX_SUCCESS);
+    assert(block.audio.size == BLOCK && block.is_speech);
+
+    // Whatever the slow sink had queued at the stop still reaches it
+    assert(ethervox_pipeline_stop(pipeline) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_get_metrics(pipeline, &metrics) == ETHERVOX_SUCCESS);
+    assert(atomic_load(&slow.blocks) + metrics.sinks[0].dropped == blocks);
+
+    ethervox_pipeline_destroy(pipeline);
+    runtime.driver.cleanup(&runtime);
+}
+
+#if defined(__linux__)
+typedef struct {
+    atomic_uint calls;
+    atomic_uint pinned;  // Calls made on a thread whose affinity is exactly CPU 0
+} pin_state_t;
+
+static void pin_sink(const ethervox_pipeline_block_t* block, void* user_data) {
+    (void)block;
+    pin_state_t* state = (pin_state_t*)user_data;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) == 1 &&
+        CPU_ISSET(0, &cpus)) {
+        atomic_fetch_add(&state->pinned, 1);
+    }
+    atomic_fetch_add(&state->calls, 1);
+}
+
+void test_cpu_pinning(void) {
+    printf("Testing that a sink thread asked for CPU 0 runs pinned there...\n");
+
+    write_capture_file(RATE);
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, RATE, 1);
+
+    pin_state_t state = {0};
+    ethervox_pipeline_config_t config = ethervox_pipeline_default_config(&runtime);
+    config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].rt_priority = 0;
+    config.vad = false;
+    ethervox_pipeline_sink_config_t sink = {.name = "pinned", .process = pin_sink, .user_data = &state};
+    sink.thread.own_thread = true;
+    sink.thread.cpu = 0;
+    assert(ethervox_pipeline_add_sink(&config, &sink) == ETHERVOX_SUCCESS);
+
+    ethervox_pipeline_t* pipeline = NULL;
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_start(pipeline) == ETHERVOX_SUCCESS);
+    wait_for_end(&runtime);
+    assert(ethervox_pipeline_stop(pipeline) == ETHERVOX_SUCCESS);
+
+    unsigned calls = atomic_load(&state.calls);
+    assert(calls > 0);
+    assert(atomic_load(&state.pinned) == calls);
+
+    ethervox_pipeline_destroy(pipeline);
+    runtime.driver.cleanup(&runtime);
+    printf("  ✓ All %u sink calls ran with affinity {0}\n", calls);
+}
+#endif
+
+void test_beamformed_capture(void) {
+    printf("Testing 4-channel capture through the beamforming stage...\n");
+
+    ethervox_beamformer_config_t array = ethervox_beamformer_default_config(4, RATE);
+    write_array_capture_file(&array);
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, RATE, 4);
+
+    ethervox_pipeline_config_t config = ethervox_pipeline_default_config(&runtime);
+    config.threads[ETHERVOX_PIPELINE_STAGE_CAPTURE].rt_priority = 0;
+    config.vad = false;
+    assert(config.beamforming && config.beamformer_config.channels == 4);
+    ethervox_pipeline_sink_config_t tap = {.name = "tap"};
+    assert(ethervox_pipeline_add_sink(&config, &tap) == ETHERVOX_SUCCESS);
+
+    // The geometry has to describe every capture channel
+    ethervox_pipeline_t* pipeline = NULL;
+    config.beamformer_config.channels = 2;
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    config.beamformer_config.channels = 4;
+
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_SUCCESS);
+    ethervox_doa_t doa;
+    assert(ethervox_pipeline_get_doa(pipeline, &doa) == ETHERVOX_SUCCESS);
+    assert(doa.updates == 0);
+    assert(ethervox_pipeline_start(pipeline) == ETHERVOX_SUCCESS);
+    wait_for_end(&runtime);
+
+    float* audio = (float*)malloc(RATE * 3 * sizeof(float));
+    assert(audio != NULL);
+    uint32_t total = 0;
+    ethervox_pipeline_block_t block;
+    do {
+        assert(ethervox_pipeline_read(pipeline, 0, audio + total, 10 * BLOCK, 20, &block) == ETHERVOX_SUCCESS);
+        assert(block.audio.channels == 1);
+        total += block.audio.size;
+    } while (block.audio.size > 0);
+    assert(total == 2 * RATE);
+
+    ethervox_pipeline_metrics_t metrics;
+    assert(ethervox_pipeline_get_metrics(pipeline, &metrics) == ETHERVOX_SUCCESS);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].active);
+    assert(metrics.stages[ETHERVOX_PIPELINE_STAGE_BEAMFORM].blocks == total / BLOCK);
+    assert(!metrics.stages[ETHERVOX_PIPELINE_STAGE_RESAMPLE].active);
+
+    assert(ethervox_pipeline_get_doa(pipeline, &doa) == ETHERVOX_SUCCESS);
+    float error = fabsf(doa.azimuth_deg - 45.0f);
+    assert(doa.updates > 0 && error <= 5.0f);
+
+    ethervox_pipeline_destroy(pipeline);
+    runtime.driver.cleanup(&runtime);
+    free(audio);
+    printf("  ✓ %u mono samples out of 4 channels; talker located at %.1f degrees (%u estimates)\n", total,
+           doa.azimuth_deg, doa.updates);
+}
+
+void test_errors(void) {
+    printf("Testing configuration errors...\n");
+
+    write_capture_file(RATE);
+    ethervox_audio_runtime_t runtime;
+    open_runtime(&runtime, RATE, 1);
+
+    ethervox_pipeline_t* pipeline = (ethervox_pipeline_t*)&runtime;
+    ethervox_pipeline_config_t config = ethervox_pipeline_default_config(&runtime);
+    config.block_ms = 0;
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(pipeline == NULL);
+
+    config = ethervox_pipeline_default_config(&runtime);
+    ethervox_pipeline_sink_config_t sink = {.name = "odd", .block_ms = 15};
+    assert(ethervox_pipeline_add_sink(&config, &sink) == ETHERVOX_SUCCESS);
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+
+    config = ethervox_pipeline_default_config(&runtime);
+    sink.block_ms = 0;
+    for (int i = 0; i < ETHERVOX_PIPELINE_MAX_SINKS; i++) {
+        assert(ethervox_pipeline_add_sink(&config, &sink) == ETHERVOX_SUCCESS);
+    }
+    assert(ethervox_pipeline_add_sink(&config, &sink) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+
+    // Reads need a tap index and room for a block
+    assert(ethervox_pipeline_create(&config, &pipeline) == ETHERVOX_SUCCESS);
+    float audio[BLOCK];
+    ethervox_pipeline_block_t block;
+    assert(ethervox_pipeline_read(pipeline, 7, audio, BLOCK, 0, &block) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(ethervox_pipeline_read(pipeline, 0, audio, BLOCK - 1, 0, &block) == ETHERVOX_ERROR_BUFFER_TOO_SMALL);
+    assert(ethervox_pipeline_read(pipeline, 0, audio, BLOCK, 0, &block) == ETHERVOX_ERROR_NOT_INITIALIZED);
+
+    // Mono capture has no beamforming stage to ask for a direction
+    ethervox_doa_t doa;
+    assert(ethervox_pipeline_get_doa(pipeline, &doa) == ETHERVOX_ERROR_NOT_SUPPORTED);
+    ethervox_pipeline_destroy(pipeline);
+    ethervox_pipeline_destroy(NULL);
+
+    assert(strcmp(ethervox_pipeline_stage_name(ETHERVOX_PIPELINE_STAGE_NOISE_SUPPRESSION), "noise_suppression") == 0);
+    assert(strcmp(ethervox_pipeline_stage_name(ETHERVOX_PIPELINE_STAGE_COUNT), "unknown") == 0);
+    runtime.driver.cleanup(&runtime);
+    printf("  ✓ Bad block sizes, too many sinks and bad reads rejected\n");
+}
+
+int main(void) {
+    printf("=== Audio Pipeline Unit Tests ===\n\n");
+
+    test_tap_and_sinks();
+    test_slow_sink_drops_without_stalling();
+    test_beamformed_capture();
+#if defined(__linux__)
+    test_cpu_pinning();
+#endif
+    test_errors();
+
+    remove(CAPTURE_WAV);
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file test_delay_estimator.c
+ * @brief Unit tests for the GCC-PHAT echo delay estimator
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/delay_estimator.h"
+#include "ethervox/config.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 16000
+#define CHUNK 160
+#define PI_F 3.14159265f
+
+static uint32_t g_seed = 777;
+
+static float noise_sample(float amplitude) {
+    g_seed = g_seed * 1103515245u + 12345u;
+    return amplitude * (((float)((g_seed >> 8) & 0xFFFF) / 32768.0f) - 1.0f);
+}
+
+// Speech-like far end: low-passed noise with a 4 Hz syllable envelope
+static float* make_reference(uint32_t count) {
+    float* ref = (float*)malloc(count * sizeof(float));
+    assert(ref != NULL);
+    float lp = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        lp = 0.7f * lp + 0.3f * noise_sample(1.0f);
+        float envelope = 0.55f + 0.45f * sinf(2.0f * PI_F * 4.0f * (float)i / RATE);
+        ref[i] = 0.4f * envelope * lp;
+    }
+    return ref;
+}
+
+// Mic hears the far end after `delay` samples plus a short room reflection
+static void make_echo(const float* ref, float* mic, uint32_t start, uint32_t end, uint32_t delay) {
+    for (uint32_t i = start; i < end; i++) {
+        float direct = i >= delay ? ref[i - delay] : 0.0f;
+        float reflection = i >= delay + 37 ? ref[i - delay - 37] : 0.0f;
+        mic[i] = 0.5f * direct + 0.2f * reflection + noise_sample(0.01f);
+    }
+}
+
+// Feed in capture-sized chunks; return the sample index where the estimate changed last
+static uint32_t feed(ethervox_delay_estimator_t* est, const float* ref, const float* mic,
+                     uint32_t start, uint32_t end) {
+    uint32_t changed_at = 0;
+    for (uint32_t pos = start; pos < end; pos += CHUNK) {
+        uint32_t n = end - pos < CHUNK ? end - pos : CHUNK;
+        if (ethervox_delay_estimator_process(est, ref + pos, mic + pos, n)) {
+            changed_at = pos + n;
+        }
+    }
+    return changed_at;
+}
+
+void test_locks_to_delay(void) {
+    printf("Testing lock onto a fixed echo delay...\n");
+
+    ethervox_delay_estimator_t* est = ethervox_delay_estimator_create(NULL);
+    assert(est != NULL);
+    assert(ethervox_delay_estimator_get_delay(est) == -1);
+
+    const uint32_t count = 4 * RATE, delay = 1234;  // 77 ms
+    float* ref = make_reference(count);
+    float* mic = (float*)malloc(count * sizeof(float));
+    assert(mic != NULL);
+    make_echo(ref, mic, 0, count, delay);
+
+    uint32_t locked_at = feed(est, ref, mic, 0, count);
+    assert(locked_at > 0 && locked_at < 2 * RATE);
+    assert(ethervox_delay_estimator_get_delay(est) == (int)delay);
+    assert(ethervox_delay_estimator_get_confidence(est) >= ETHERVOX_AEC_DELAY_CONFIDENCE);
+
+    free(ref);
+    free(mic);
+    ethervox_delay_estimator_destroy(est);
+    printf("  ✓ Found %u samples after %.2f s of far-end audio\n", delay, (float)locked_at / RATE);
+}
+
+void test_tracks_delay_change(void) {
+    printf("Testing re-lock after the path delay changes...\n");
+
+    ethervox_delay_estimator_t* est = ethervox_delay_estimator_create(NULL);
+    assert(est != NULL);
+
+    // Output switches to a Bluetooth headset: 40 ms becomes 250 ms
+    const uint32_t count = 10 * RATE, before = 640, after = 4000;
+    float* ref = make_reference(count);
+    float* mic = (float*)malloc(count * sizeof(float));
+    assert(mic != NULL);
+    make_echo(ref, mic, 0, 4 * RATE, before);
+    make_echo(ref, mic, 4 * RATE, count, after);
+
+    feed(est, ref, mic, 0, 4 * RATE);
+    assert(ethervox_delay_estimator_get_delay(est) == (int)before);
+    uint32_t relocked_at = feed(est, ref, mic, 4 * RATE, count);
+    assert(ethervox_delay_estimator_get_delay(est) == (int)after);
+    assert(relocked_at - 4 * RATE < 4 * RATE);
+
+    free(ref);
+    free(mic);
+    ethervox_delay_estimator_destroy(est);
+    printf("  ✓ Moved from %u to %u samples within %.2f s\n", before, after,
+           (float)(relocked_at - 4 * RATE) / RATE);
+}
+
+void test_no_false_lock(void) {
+    printf("Testing silence and unrelated audio...\n");
+
+    ethervox_delay_estimator_t* est = ethervox_delay_estimator_create(NULL);
+    assert(est != NULL);
+
+    // Far end silent: nothing is analysed
+    const uint32_t count = 3 * RATE;
+    float* ref = (float*)calloc(count, sizeof(float));
+    float* mic = (float*)malloc(count * sizeof(float));
+    assert(ref && mic);
+    for (uint32_t i = 0; i < count; i++) mic[i] = noise_sample(0.2f);
+    assert(feed(est, ref, mic, 0, count) == 0);
+    assert(ethervox_delay_estimator_get_confidence(est) == 0.0f);
+
+    // Far end playing but the mic only hears the user (no echo path)
+    free(ref);
+    ref = make_reference(count);
+    assert(feed(est, ref, mic, 0, count) == 0);
+    assert(ethervox_delay_estimator_get_delay(est) == -1);
+
+    free(ref);
+    free(mic);
+    ethervox_delay_estimator_destroy(est);
+    printf("  ✓ No estimate without a correlated echo\n");
+}
+
+void test_config_and_reset(void) {
+    printf("Testing configuration, block size and reset...\n");
+
+    ethervox_delay_estimator_config_t config = ethervox_delay_estimator_default_config();
+    assert(config.sample_rate == ETHERVOX_AUDIO_SAMPLE_RATE);
+    assert(config.max_delay_ms == ETHERVOX_AEC_MAX_DELAY_MS);
+
+    // 320 ms of lag plus >=100 ms of new audio fits an 8192-point FFT
+    ethervox_delay_estimator_t* est = ethervox_delay_estimator_create(&config);
+    assert(est != NULL);
+    assert(ethervox_delay_estimator_block_size(est) == 8192 - 5120);
+
+    const uint32_t count = 2 * RATE;
+    float* ref = make_reference(count);
+    float* mic = (float*)malloc(count * sizeof(float));
+    assert(mic != NULL);
+    make_echo(ref, mic, 0, count, 300);
+    feed(est, ref, mic, 0, count);
+    assert(ethervox_delay_estimator_get_delay(est) == 300);
+    ethervox_delay_estimator_reset(est);
+    assert(ethervox_delay_estimator_get_delay(est) == -1);
+    ethervox_delay_estimator_destroy(est);
+
+    config.max_delay_ms = 0;
+    assert(ethervox_delay_estimator_create(&config) == NULL);
+    config = ethervox_delay_estimator_default_config();
+    config.smoothing = 1.0f;
+    assert(ethervox_delay_estimator_create(&config) == NULL);
+
+    assert(!ethervox_delay_estimator_process(NULL, ref, mic, 10));
+    assert(ethervox_delay_estimator_get_delay(NULL) == -1);
+    ethervox_delay_estimator_destroy(NULL);
+
+    free(ref);
+    free(mic);
+    printf("  ✓ Block sized from max delay, bad config rejected, reset clears lock\n");
+}
+
+int main(void) {
+    printf("=== Echo Delay Estimator Unit Tests ===\n\n");
+
+    test_locks_to_delay();
+    test_tracks_delay_change();
+    test_no_false_lock();
+    test_config_and_reset();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file test_diarization.c
+ * @brief Unit tests for speaker diarization
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/diarization.h"
+#include "ethervox/config.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 16000
+#define PI_F 3.14159265f
+
+typedef struct {
+    float f0;           // Pitch in Hz
+    float formants[3];  // Vocal tract resonances in Hz
+} voice_t;
+
+static const voice_t VOICES[] = {
+    {110.0f, {700.0f, 1200.0f, 2600.0f}},   // Low male
+    {210.0f, {450.0f, 2100.0f, 3000.0f}},   // Female
+    {150.0f, {350.0f, 900.0f, 2300.0f}},    // Darker mid voice
+};
+
+/**
+ * Harmonic source shaped by formant peaks, with slow vibrato and
+ * syllable-rate amplitude modulation
+ */
+static void synth_voice(float* out, uint32_t count, const voice_t* v, uint32_t seed) {
+    double phase = 0.0;
+    for (uint32_t n = 0; n < count; n++) {
+        float t = (float)n / RATE;
+        float f0 = v->f0 * (1.0f + 0.02f * sinf(2.0f * PI_F * 5.0f * t + (float)seed));
+        phase += 2.0 * PI_F * f0 / RATE;
+        float sample = 0.0f;
+        for (int h = 1; h * f0 < 5000.0f; h++) {
+            float hz = h * f0;
+            float gain = 0.0f;
+            for (int f = 0; f < 3; f++) {
+                float d = (hz - v->formants[f]) / (80.0f + 0.05f * v->formants[f]);
+                gain += expf(-0.5f * d * d) / (float)(f + 1);
+            }
+            sample += (gain + 0.02f) * sinf((float)(h * phase));
+        }
+        float envelope = 0.6f + 0.4f * sinf(2.0f * PI_F * 4.0f * t);
+        out[n] = 0.05f * envelope * sample;
+    }
+}
+
+void test_yin_f0(void) {
+    printf("Testing YIN pitch tracking...\n");
+
+    float window[ETHERVOX_SPEAKER_YIN_WINDOW + RATE / ETHERVOX_SPEAKER_F0_MIN + 1];
+    uint32_t len = sizeof(window) / sizeof(window[0]);
+    const float pitches[] = {85.0f, 120.0f, 200.0f, 310.0f};
+    for (size_t p = 0; p < sizeof(pitches) / sizeof(pitches[0]); p++) {
+        for (uint32_t n = 0; n < len; n++) {
+            float phase = 2.0f * PI_F * pitches[p] * n / RATE;
+            window[n] = sinf(phase) + 0.5f * sinf(2.0f * phase) + 0.3f * sinf(3.0f * phase);
+        }
+        float f0 = ethervox_diarizer_yin_f0(window);
+        assert(fabsf(f0 - pitches[p]) < pitches[p] * 0.02f);
+    }
+
+    // Noise has no pitch
+    srand(7);
+    for (uint32_t n = 0; n < len; n++) {
+        window[n] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    assert(ethervox_diarizer_yin_f0(window) == 0.0f);
+
+    printf("  ✓ F0 within 2%% for 85-310 Hz, noise unvoiced\n");
+}
+
+void test_stable_speaker_ids(void) {
+    printf("Testing speaker clustering...\n");
+
+    ethervox_diarizer_t* d = ethervox_diarizer_create(ETHERVOX_SPEAKER_MAX_SPEAKERS);
+    assert(d != NULL);
+
+    // Three speakers take turns twice; returning speakers keep their IDs
+    const uint32_t seg = RATE * 2;
+    float* audio = (float*)malloc(seg * 6 * sizeof(float));
+    assert(audio != NULL);
+    for (int s = 0; s < 6; s++) {
+        synth_voice(audio + s * seg, seg, &VOICES[s % 3], (uint32_t)s);
+    }
+
+    // Submitted in two chunks, as the STT backend does per window
+    int ids[6];
+    for (int chunk = 0; chunk < 2; chunk++) {
+        assert(ethervox_diarizer_submit(d, audio + chunk * 3 * seg, 3 * seg) == ETHERVOX_SUCCESS);
+        for (int s = 0; s < 3; s++) {
+            ids[chunk * 3 + s] = ethervox_diarizer_assign(d, s * seg, (s + 1) * seg);
+        }
+    }
+    for (int s = 0; s < 6; s++) {
+        assert(ids[s] == s % 3);
+    }
+    assert(ethervox_diarizer_speaker_count(d) == 3);
+
+    // Same speaker, different utterance: close; different speakers: far
+    ethervox_speaker_embedding_t a, a2, b;
+    assert(ethervox_diarizer_submit(d, audio, 6 * seg) == ETHERVOX_SUCCESS);
+    assert(ethervox_diarizer_embed(d, 0, seg, &a) == ETHERVOX_SUCCESS);
+    assert(ethervox_diarizer_embed(d, 3 * seg, 4 * seg, &a2) == ETHERVOX_SUCCESS);
+    assert(ethervox_diarizer_embed(d, seg, 2 * seg, &b) == ETHERVOX_SUCCESS);
+    assert(a.voiced_frames > a.speech_frames / 2);
+    assert(fabsf(expf(a.log_f0) - VOICES[0].f0) < 10.0f);
+    assert(ethervox_diarizer_distance(d, &a, &a2) < ETHERVOX_SPEAKER_MERGE_THRESHOLD);
+    assert(ethervox_diarizer_distance(d, &a, &b) > ETHERVOX_SPEAKER_NEW_THRESHOLD);
+
+    ethervox_diarizer_reset(d);
+    assert(ethervox_diarizer_speaker_count(d) == 0);
+
+    free(audio);
+    ethervox_diarizer_destroy(d);
+    printf("  ✓ A B C A B C labelled 0 1 2 0 1 2\n");
+}
+
+void test_identify_without_enrolling(void) {
+    printf("Testing speaker lookup...\n");
+
+    ethervox_diarizer_t* d = ethervox_diarizer_create(ETHERVOX_SPEAKER_MAX_SPEAKERS);
+    assert(d != NULL);
+
+    const uint32_t seg = RATE * 2;
+    float* audio = (float*)malloc(seg * 3 * sizeof(float));
+    assert(audio != NULL);
+    synth_voice(audio, seg, &VOICES[0], 0);
+    synth_voice(audio + seg, seg, &VOICES[0], 3);
+    synth_voice(audio + 2 * seg, seg, &VOICES[1], 1);
+
+    assert(ethervox_diarizer_submit(d, audio, 3 * seg) == ETHERVOX_SUCCESS);
+    assert(ethervox_diarizer_identify(d, 0, seg) == ETHERVOX_DIARIZER_NEW_SPEAKER);
+    assert(ethervox_diarizer_assign(d, 0, seg) == 0);
+
+    // A known voice is found, an unheard one is reported, neither is enrolled
+    assert(ethervox_diarizer_identify(d, seg, 2 * seg) == 0);
+    assert(ethervox_diarizer_identify(d, 2 * seg, 3 * seg) == ETHERVOX_DIARIZER_NEW_SPEAKER);
+    assert(ethervox_diarizer_speaker_count(d) == 1);
+    assert(ethervox_diarizer_assign(d, 2 * seg, 3 * seg) == 1);
+
+    free(audio);
+    ethervox_diarizer_destroy(d);
+    printf("  ✓ identify() matches A, flags B as new, adds no speaker\n");
+}
+
+void test_too_little_speech(void) {
+    printf("Testing silence and short segments...\n");
+
+    ethervox_diarizer_t* d = ethervox_diarizer_create(2);
+    assert(d != NULL);
+
+    float* audio = (float*)calloc(RATE, sizeof(float));
+    assert(audio != NULL);
+    assert(ethervox_diarizer_submit(d, audio, RATE) == ETHERVOX_SUCCESS);
+    assert(ethervox_diarizer_assign(d, 0, RATE) == -1);
+
+    // 100 ms of speech is below ETHERVOX_SPEAKER_MIN_SPEECH_MS
+    synth_voice(audio, RATE / 10, &VOICES[0], 0);
+    assert(ethervox_diarizer_submit(d, audio, RATE) == ETHERVOX_SUCCESS);
+    ethervox_speaker_embedding_t e;
+    assert(ethervox_diarizer_embed(d, 0, RATE, &e) == ETHERVOX_ERROR_NOT_FOUND);
+    assert(ethervox_diarizer_speaker_count(d) == 0);
+
+    // More voices than slots join the nearest speaker
+    float* voice = (float*)malloc(RATE * sizeof(float));
+    assert(voice != NULL);
+    for (int v = 0; v < 3; v++) {
+        synth_voice(voice, RATE, &VOICES[v], 0);
+        assert(ethervox_diarizer_submit(d, voice, RATE) == ETHERVOX_SUCCESS);
+        int id = ethervox_diarizer_assign(d, 0, RATE);
+        assert(id >= 0 && id < 2);
+    }
+    assert(ethervox_diarizer_speaker_count(d) <= 2);
+
+    assert(ethervox_diarizer_submit(NULL, audio, RATE) == ETHERVOX_ERROR_NULL_POINTER);
+    assert(ethervox_diarizer_create(0) == NULL);
+
+    free(voice);
+    free(audio);
+    ethervox_diarizer_destroy(d);
+    printf("  ✓ Silence and short spans get no speaker\n");
+}
+
+int main(void) {
+    printf("=== Diarization Unit Tests ===\n\n");
+
+    test_yin_f0();
+    test_stable_speaker_ids();
+    test_identify_without_enrolling();
+    test_too_little_speech();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 void test_init_cleanup(void) {
     printf("Testing init/cleanup...\n");
@@ -188,6 +189,394 @@ void test_summarize(void) {
     printf("  ✓ Summarize works\n");
 }
 
+void test_parallel_import(void) {
+    printf("Testing parallel JSONL import...\n");
+    
+    // Build a session log with ADD records plus delete/update ops
+    const char* path = "/tmp/test_parallel_import.jsonl";
+    FILE* fp = fopen(path, "w");
+    assert(fp != NULL);
+    for (int i = 0; i < 2000; i++) {
+        fprintf(fp, "{\"id\":%d,\"turn\":%d,\"ts\":%d,\"user\":%s,\"imp\":0.50,"
+                    "\"text\":\"Entry number %d with \\\"quotes\\\"\",\"tags\":[\"bulk\",\"t%d\"]}\n",
+                i, i, 1700000000 + i, (i % 2) ? "true" : "false", i, i % 7);
+        if (i % 100 == 50) {
+            fprintf(fp, "{\"op\":\"delete\",\"id\":%d}\n", i - 1);
+        }
+        if (i % 250 == 10) {
+            fprintf(fp, "{\"op\":\"update_text\",\"id\":%d,\"text\":\"rewritten %d\"}\n", i, i);
+            fprintf(fp, "{\"op\":\"update\",\"id\":%d,\"tags\":[\"changed\"]}\n", i);
+        }
+    }
+    fclose(fp);
+    
+    // Sequential import (file is below the fast-path threshold)
+    ethervox_memory_store_t seq;
+    ethervox_result_t result = ethervox_memory_init(&seq, "seq", NULL);
+    assert(ethervox_is_success(result));
+    uint32_t loaded = 0;
+    result = ethervox_memory_import(&seq, path, &loaded);
+    assert(ethervox_is_success(result));
+    
+    // Parallel import must produce the same entries in the same order
+    ethervox_memory_store_t par;
+    result = ethervox_memory_init(&par, "par", NULL);
+    assert(ethervox_is_success(result));
+    ethervox_memory_import_stats_t stats;
+    result = ethervox_memory_import_parallel(&par, path, 4, &stats);
+    assert(ethervox_is_success(result));
+    
+    assert(stats.entries_loaded == 2000);
+    assert(stats.ops_applied == 20 + 8 + 8);
+    assert(stats.bytes_processed > 0);
+    assert(par.entry_count == seq.entry_count);
+    assert(par.entry_count == 2000 - 20);
+    
+    for (uint32_t i = 0; i < par.entry_count; i++) {
+        assert(par.entries[i].memory_id == seq.entries[i].memory_id);
+        assert(par.entries[i].timestamp == seq.entries[i].timestamp);
+        assert(par.entries[i].is_user_message == seq.entries[i].is_user_message);
+        assert(strcmp(par.entries[i].text, seq.entries[i].text) == 0);
+        assert(par.entries[i].tag_count == seq.entries[i].tag_count);
+        for (uint32_t t = 0; t < par.entries[i].tag_count; t++) {
+            assert(strcmp(par.entries[i].tags[t], seq.entries[i].tags[t]) == 0);
+        }
+    }
+    
+    // Tag index is rebuilt once at the end
+    const char* filter[] = {"changed"};
+    ethervox_memory_search_result_t* results = NULL;
+    uint32_t count = 0;
+    result = ethervox_memory_search(&par, NULL, filter, 1, 100, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 8);
+    free(results);
+    
+    // New IDs continue after the imported ones
+    const char* tags[] = {"after"};
+    uint64_t id;
+    result = ethervox_memory_store_add(&par, "After import", tags, 1, 0.5f, true, &id);
+    assert(ethervox_is_success(result));
+    assert(id == 2000);
+    
+    printf("  (%.1f MB/s, %u threads, %u chunks)\n",
+           stats.throughput_mb_s, stats.threads_used, stats.chunks);
+    
+    ethervox_memory_cleanup(&seq);
+    ethervox_memory_cleanup(&par);
+    remove(path);
+    printf("  ✓ Parallel import works\n");
+}
+
+void test_tag_bitmap_filter(void) {
+    printf("Testing tag bitmap filtering...\n");
+    
+    ethervox_memory_store_t store;
+    ethervox_result_t result = ethervox_memory_init(&store, NULL, NULL);
+    assert(ethervox_is_success(result));
+    result = ethervox_memory_set_dedup(&store, ETHERVOX_MEMORY_DEDUP_OFF, 0.0f);
+    assert(ethervox_is_success(result));
+    
+    // More entries per tag than an array container holds, so "popular" becomes a bitset
+    char mod_tag[16];
+    uint64_t id;
+    for (int i = 0; i < 4500; i++) {
+        snprintf(mod_tag, sizeof(mod_tag), "t%d", i % 3);
+        const char* tags[] = {"popular", mod_tag, "even"};
+        uint32_t tag_count = (i % 2 == 0) ? 3 : 2;
+        float importance = (i % 10 == 0) ? 0.2f : 0.8f;
+        result = ethervox_memory_store_add(&store, "Bitmap entry", tags, tag_count, importance, true, &id);
+        assert(ethervox_is_success(result));
+    }
+    assert(store.tag_index_count == 5);
+    
+    ethervox_memory_search_result_t* results = NULL;
+    uint32_t count = 0;
+    
+    const char* popular_even[] = {"popular", "even"};
+    result = ethervox_memory_search(&store, NULL, popular_even, 2, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 2250);
+    free(results);
+    
+    const char* even_t0[] = {"even", "t0"};
+    result = ethervox_memory_search(&store, NULL, even_t0, 2, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 750);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.memory_id % 6 == 0);
+    }
+    free(results);
+    
+    const char* unknown[] = {"popular", "missing"};
+    result = ethervox_memory_search(&store, NULL, unknown, 2, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 0);
+    free(results);
+    
+    // Retagging moves the entry between bitmaps
+    const char* retag[] = {"popular"};
+    result = ethervox_memory_update_tags(&store, 0, retag, 1);
+    assert(ethervox_is_success(result));
+    result = ethervox_memory_search(&store, NULL, popular_even, 2, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 2249);
+    free(results);
+    
+    // Pruning compacts the entries array and re-indexes the shifted ordinals
+    uint32_t pruned = 0;
+    result = ethervox_memory_forget(&store, 0, 0.5f, &pruned);
+    assert(ethervox_is_success(result));
+    assert(pruned == 450);
+    
+    result = ethervox_memory_search(&store, NULL, retag, 1, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 4050);
+    free(results);
+    
+    result = ethervox_memory_search(&store, NULL, popular_even, 2, 10000, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 1800);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.memory_id % 2 == 0);
+        assert(results[i].entry.memory_id % 10 != 0);
+    }
+    free(results);
+    
+    ethervox_memory_cleanup(&store);
+    printf("  ✓ Tag bitmap filtering works\n");
+}
+
+void test_time_index(void) {
+    printf("Testing time-ordered index...\n");
+    
+    // Import entries whose timestamps arrive out of order: ts = 1000 + 10 * ((i * 37) % 100)
+    const char* path = "/tmp/test_time_index.jsonl";
+    FILE* fp = fopen(path, "w");
+    assert(fp != NULL);
+    for (int i = 0; i < 100; i++) {
+        fprintf(fp, "{\"id\":%d,\"turn\":%d,\"ts\":%d,\"user\":true,\"imp\":0.50,"
+                    "\"text\":\"Slot %d\",\"tags\":[\"%s\"]}\n",
+                i, i, 1000 + 10 * ((i * 37) % 100), (i * 37) % 100, (i % 2) ? "odd" : "even");
+    }
+    fclose(fp);
+    
+    ethervox_memory_store_t store;
+    ethervox_result_t result = ethervox_memory_init(&store, NULL, NULL);
+    assert(ethervox_is_success(result));
+    uint32_t loaded = 0;
+    result = ethervox_memory_import(&store, path, &loaded);
+    assert(ethervox_is_success(result));
+    assert(loaded == 100);
+    
+    ethervox_memory_search_result_t* results = NULL;
+    uint32_t count = 0;
+    
+    // Inclusive range, oldest first
+    result = ethervox_memory_get_range(&store, 1000, 1090, NULL, 0, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 10);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.timestamp == (time_t)(1000 + 10 * i));
+    }
+    free(results);
+    
+    // Last N, newest first
+    result = ethervox_memory_get_recent(&store, NULL, 0, 5, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 5);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.timestamp == (time_t)(1990 - 10 * i));
+    }
+    free(results);
+    
+    // Tag-filtered recency: slot s holds entry i = s * 73 % 100, which is even iff s is even
+    const char* even[] = {"even"};
+    result = ethervox_memory_get_recent(&store, even, 1, 3, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 3);
+    assert(results[0].entry.timestamp == 1980);
+    assert(results[2].entry.timestamp == 1940);
+    free(results);
+    
+    // Tag-filtered range walks the tag's time-ordered postings inside the window
+    result = ethervox_memory_get_range(&store, 1000, 1090, even, 1, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 5);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.timestamp == (time_t)(1000 + 20 * i));
+    }
+    free(results);
+    result = ethervox_memory_get_range(&store, 1005, 1990, even, 1, 3, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 3);
+    assert(results[0].entry.timestamp == 1020);
+    assert(results[2].entry.timestamp == 1060);
+    free(results);
+    
+    // Every filter tag must match; unknown tags match nothing
+    const char* both[] = {"even", "odd"};
+    result = ethervox_memory_get_range(&store, 1000, 1990, both, 2, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 0);
+    free(results);
+    const char* unknown[] = {"missing"};
+    result = ethervox_memory_get_recent(&store, unknown, 1, 5, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 0);
+    free(results);
+    
+    // Deleting compacts the entries array; the index follows
+    uint64_t doomed[] = {0, 1};  // Slots 0 and 37
+    uint32_t deleted = 0;
+    result = ethervox_memory_delete_by_ids(&store, doomed, 2, &deleted);
+    assert(ethervox_is_success(result));
+    assert(deleted == 2);
+    result = ethervox_memory_get_range(&store, 1000, 1400, NULL, 0, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 39);
+    assert(results[0].entry.timestamp == 1010);
+    free(results);
+    result = ethervox_memory_get_range(&store, 1000, 1400, even, 1, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 20);
+    assert(results[0].entry.timestamp == 1020);
+    free(results);
+    
+    // Retagging moves the entry between postings: id 2 sits in slot 74
+    const char* retag[] = {"odd", "pinned"};
+    result = ethervox_memory_update_tags(&store, 2, retag, 2);
+    assert(ethervox_is_success(result));
+    result = ethervox_memory_get_range(&store, 1700, 1790, even, 1, 0, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 4);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(results[i].entry.timestamp != 1740);
+    }
+    free(results);
+    result = ethervox_memory_get_recent(&store, retag, 2, 5, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 1);
+    assert(results[0].entry.memory_id == 2);
+    free(results);
+    
+    // Search without a query ranks equal-importance entries by recency
+    result = ethervox_memory_search(&store, NULL, NULL, 0, 1, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 1);
+    assert(results[0].entry.timestamp == 1990);
+    free(results);
+    
+    // Summaries window over the newest entries by timestamp
+    char* summary = NULL;
+    result = ethervox_memory_summarize(&store, 2, NULL, &summary, NULL, NULL);
+    assert(ethervox_is_success(result));
+    assert(strstr(summary, "Slot 99") != NULL);
+    assert(strstr(summary, "Slot 98") != NULL);
+    assert(strstr(summary, "Slot 97") == NULL);
+    free(summary);
+    
+    ethervox_memory_cleanup(&store);
+    remove(path);
+    printf("  ✓ Time-ordered index works\n");
+}
+
+void test_dedup(void) {
+    printf("Testing near-duplicate detection...\n");
+    
+    const char* dir = "/tmp/test_memory_dedup";
+    mkdir(dir, 0755);
+    
+    ethervox_memory_store_t store;
+    ethervox_result_t result = ethervox_memory_init(&store, NULL, dir);
+    assert(ethervox_is_success(result));
+    assert(store.dedup_mode == ETHERVOX_MEMORY_DEDUP_MERGE);
+    
+    // Case and punctuation differences merge into the existing entry
+    const char* pref[] = {"preference"};
+    const char* food[] = {"food"};
+    uint64_t first_id = 0;
+    uint64_t second_id = 0;
+    result = ethervox_memory_store_add(&store, "User likes green tea in the morning",
+                                       pref, 1, 0.6f, true, &first_id);
+    assert(ethervox_is_success(result));
+    result = ethervox_memory_store_add(&store, "user likes green tea in the morning.",
+                                       food, 1, 0.5f, true, &second_id);
+    assert(ethervox_is_success(result));
+    assert(second_id == first_id);
+    assert(store.entry_count == 1);
+    assert(store.total_duplicates == 1);
+    assert(store.entries[0].tag_count == 2);
+    assert(store.entries[0].importance > 0.6f);
+    
+    // Merged tags are searchable
+    ethervox_memory_search_result_t* results = NULL;
+    uint32_t count = 0;
+    result = ethervox_memory_search(&store, NULL, food, 1, 10, &results, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 1);
+    free(results);
+    
+    // Unrelated text is still stored
+    uint64_t other_id = 0;
+    result = ethervox_memory_store_add(&store, "Meeting with the design team on Friday",
+                                       pref, 1, 0.5f, true, &other_id);
+    assert(ethervox_is_success(result));
+    assert(other_id != first_id);
+    assert(store.entry_count == 2);
+    
+    // Conversation turns are exempt
+    const char* conv[] = {"conversation"};
+    result = ethervox_memory_store_add(&store, "User likes green tea in the morning",
+                                       conv, 1, 0.5f, true, &other_id);
+    assert(ethervox_is_success(result));
+    assert(store.entry_count == 3);
+    
+    // Reminders that differ only in their time are distinct reminders
+    const char* reminder[] = {"reminder"};
+    uint64_t five_id = 0;
+    uint64_t seven_id = 0;
+    result = ethervox_memory_store_add(&store, "Remind me to call mom about the birthday dinner reservation at 5pm",
+                                       reminder, 1, 0.9f, true, &five_id);
+    assert(ethervox_is_success(result));
+    result = ethervox_memory_store_add(&store, "Remind me to call mom about the birthday dinner reservation at 7pm",
+                                       reminder, 1, 0.9f, true, &seven_id);
+    assert(ethervox_is_success(result));
+    assert(seven_id != five_id);
+    assert(store.entry_count == 5);
+    
+    // Reject mode keeps the existing entry untouched
+    float importance = store.entries[0].importance;
+    result = ethervox_memory_set_dedup(&store, ETHERVOX_MEMORY_DEDUP_REJECT, 0.0f);
+    assert(ethervox_is_success(result));
+    const char* misc[] = {"misc"};
+    result = ethervox_memory_store_add(&store, "User likes green tea in the morning!",
+                                       misc, 1, 0.9f, true, &second_id);
+    assert(ethervox_is_success(result));
+    assert(second_id == first_id);
+    assert(store.entry_count == 5);
+    assert(store.entries[0].tag_count == 2);
+    assert(store.entries[0].importance == importance);
+    
+    // The merge was logged as an update and replays on import
+    char path[512];
+    snprintf(path, sizeof(path), "%s", store.storage_filepath);
+    ethervox_memory_cleanup(&store);
+    
+    result = ethervox_memory_init(&store, NULL, NULL);
+    assert(ethervox_is_success(result));
+    uint32_t loaded = 0;
+    result = ethervox_memory_import(&store, path, &loaded);
+    assert(ethervox_is_success(result));
+    assert(store.entry_count == 5);
+    assert(store.entries[0].tag_count == 2);
+    assert(store.entries[0].importance > 0.6f);
+    
+    ethervox_memory_cleanup(&store);
+    remove(path);
+    printf("  ✓ Near-duplicate detection works\n");
+}
+
 int main(void) {
     printf("=== Memory Tools Unit Tests ===\n\n");
     
@@ -197,6 +586,10 @@ int main(void) {
     test_export_import();
     test_forget();
     test_summarize();
+    test_parallel_import();
+    test_tag_bitmap_filter();
+    test_time_index();
+    test_dedup();
     
     printf("\n=== All tests passed! ===\n");
     return ETHERVOX_SUCCESS;
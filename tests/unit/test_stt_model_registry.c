@@ -0,0 +1,254 @@
+/**
+ * @file test_stt_model_registry.c
+ * @brief Unit tests for the shared STT model registry
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/stt.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int g_loads = 0;
+static int g_frees = 0;
+
+static void* fake_load(const char* model_path) {
+    if (strstr(model_path, "missing")) {
+        return NULL;
+    }
+    g_loads++;
+    return strdup(model_path);
+}
+
+static void fake_free(void* model) {
+    g_frees++;
+    free(model);
+}
+
+static void* other_load(const char* model_path) {
+    g_loads++;
+    return strdup(model_path);
+}
+
+// Loader that blocks until the test opens the gate
+static pthread_mutex_t g_gate_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_gate_cond = PTHREAD_COND_INITIALIZER;
+static bool g_gate_open = false;
+static int g_slow_entered = 0;
+static int g_slow_loads = 0;
+
+static void* slow_load(const char* model_path) {
+    pthread_mutex_lock(&g_gate_lock);
+    g_slow_entered++;
+    pthread_cond_broadcast(&g_gate_cond);
+    while (!g_gate_open) {
+        pthread_cond_wait(&g_gate_cond, &g_gate_lock);
+    }
+    pthread_mutex_unlock(&g_gate_lock);
+    if (strstr(model_path, "missing")) {
+        return NULL;
+    }
+    pthread_mutex_lock(&g_gate_lock);
+    g_slow_loads++;
+    pthread_mutex_unlock(&g_gate_lock);
+    return strdup(model_path);
+}
+
+typedef struct {
+    const char* path;
+    void* model;
+    ethervox_result_t result;
+} acquire_job_t;
+
+static void* acquire_thread(void* arg) {
+    acquire_job_t* job = (acquire_job_t*)arg;
+    job->result = ethervox_stt_model_acquire(job->path, slow_load, fake_free, &job->model);
+    return NULL;
+}
+
+static void run_gated_load(const char* path, acquire_job_t* loader, acquire_job_t* waiter) {
+    g_gate_open = false;
+    g_slow_entered = 0;
+    loader->path = path;
+    waiter->path = path;
+    pthread_t loader_thread;
+    pthread_t waiter_thread;
+    assert(pthread_create(&loader_thread, NULL, acquire_thread, loader) == 0);
+
+    pthread_mutex_lock(&g_gate_lock);
+    while (g_slow_entered == 0) {
+        pthread_cond_wait(&g_gate_cond, &g_gate_lock);
+    }
+    pthread_mutex_unlock(&g_gate_lock);
+
+    // The registry stays usable while the load runs
+    void* other = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/", fake_load, fake_free, &other)));
+    assert(ethervox_stt_model_loaded_count() == 1);  // The pending load is not counted
+    ethervox_stt_model_release(other);
+    ethervox_stt_model_trim(0);
+
+    // A second session for the same model waits for the first load
+    assert(pthread_create(&waiter_thread, NULL, acquire_thread, waiter) == 0);
+    usleep(20000);
+
+    pthread_mutex_lock(&g_gate_lock);
+    g_gate_open = true;
+    pthread_cond_broadcast(&g_gate_cond);
+    pthread_mutex_unlock(&g_gate_lock);
+    pthread_join(loader_thread, NULL);
+    pthread_join(waiter_thread, NULL);
+}
+
+void test_concurrent_load(void) {
+    printf("Testing loads outside the registry lock...\n");
+
+    acquire_job_t loader = {0};
+    acquire_job_t waiter = {0};
+    run_gated_load("/tmp", &loader, &waiter);
+    assert(ethervox_is_success(loader.result) && ethervox_is_success(waiter.result));
+    assert(loader.model && loader.model == waiter.model);
+    assert(g_slow_loads == 1 && g_slow_entered == 1);
+    ethervox_stt_model_release(loader.model);
+    ethervox_stt_model_release(waiter.model);
+    ethervox_stt_model_trim(0);
+    assert(ethervox_stt_model_loaded_count() == 0);
+
+    // A failed load fails its waiters too and leaves nothing behind
+    memset(&loader, 0, sizeof(loader));
+    memset(&waiter, 0, sizeof(waiter));
+    run_gated_load("/nonexistent/missing.bin", &loader, &waiter);
+    assert(loader.result == ETHERVOX_ERROR_STT_INIT && loader.model == NULL);
+    assert(waiter.result == ETHERVOX_ERROR_STT_INIT && waiter.model == NULL);
+    assert(ethervox_stt_model_loaded_count() == 0);
+
+    printf("  ✓ Loads do not block unrelated sessions\n");
+}
+
+void test_sharing(void) {
+    printf("Testing model sharing...\n");
+
+    void* a = NULL;
+    void* b = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp", fake_load, fake_free, &a)));
+    // Same model through a different spelling of the path
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp/../tmp/", fake_load, fake_free, &b)));
+    assert(a == b);
+    assert(g_loads == 1);
+    assert(ethervox_stt_model_loaded_count() == 1);
+
+    // Another backend on the same path gets its own model
+    void* c = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp", other_load, fake_free, &c)));
+    assert(c != a && g_loads == 2);
+
+    // The newest model for a loader is visible to sessions picking a path
+    char path[256];
+    assert(ethervox_stt_model_find_loaded(fake_load, path, sizeof(path)));
+    assert(strcmp(path, "/tmp") == 0);
+    assert(!ethervox_stt_model_find_loaded(fake_load, path, 2));
+
+    ethervox_stt_model_release(a);
+    ethervox_stt_model_release(c);
+    ethervox_stt_model_trim(0);
+    assert(ethervox_stt_model_loaded_count() == 1);  // b still holds its model
+
+    ethervox_stt_model_release(b);
+    ethervox_stt_model_trim(0);
+    assert(ethervox_stt_model_loaded_count() == 0);
+    assert(g_frees == 2);
+
+    printf("  ✓ Sessions share one loaded model\n");
+}
+
+void test_idle_reuse(void) {
+    printf("Testing idle reuse and eviction...\n");
+
+    g_loads = 0;
+    g_frees = 0;
+    void* a = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp", fake_load, fake_free, &a)));
+    ethervox_stt_model_release(a);
+
+    // A session starting soon after the last one ended reuses the model
+    void* b = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp", fake_load, fake_free, &b)));
+    if (ETHERVOX_STT_MODEL_IDLE_EVICT_MS > 0) {
+        assert(b == a && g_loads == 1);
+    }
+    ethervox_stt_model_release(b);
+
+    // Not idle long enough yet
+    if (ETHERVOX_STT_MODEL_IDLE_EVICT_MS > 0) {
+        assert(ethervox_stt_model_trim(60 * 60 * 1000) == 0);
+    }
+    ethervox_stt_model_trim(0);
+    assert(ethervox_stt_model_loaded_count() == 0);
+    assert(g_frees == g_loads);
+
+    printf("  ✓ Idle models are reused, then evicted\n");
+}
+
+void test_idle_sweeper(void) {
+    printf("Testing background eviction...\n");
+
+    // Only builds with a short idle window can wait it out here
+    if (ETHERVOX_STT_MODEL_IDLE_EVICT_MS == 0 || ETHERVOX_STT_MODEL_IDLE_EVICT_MS > 2000) {
+        printf("  - Skipped (idle window %d ms)\n", (int)ETHERVOX_STT_MODEL_IDLE_EVICT_MS);
+        return;
+    }
+
+    void* a = NULL;
+    assert(ethervox_is_success(ethervox_stt_model_acquire("/tmp", fake_load, fake_free, &a)));
+    ethervox_stt_model_release(a);
+    assert(ethervox_stt_model_loaded_count() == 1);
+
+    // No further registry calls: the sweeper alone frees the model
+    int waited_ms = 0;
+    while (ethervox_stt_model_loaded_count() > 0 && waited_ms < 4 * ETHERVOX_STT_MODEL_IDLE_EVICT_MS + 1000) {
+        usleep(10000);
+        waited_ms += 10;
+    }
+    assert(ethervox_stt_model_loaded_count() == 0);
+    assert(g_frees == g_loads);
+
+    printf("  ✓ Idle models are freed without further registry calls\n");
+}
+
+void test_errors(void) {
+    printf("Testing load failures...\n");
+
+    void* model = (void*)1;
+    assert(ethervox_stt_model_acquire("/nonexistent/missing.bin", fake_load, fake_free, &model) ==
+           ETHERVOX_ERROR_STT_INIT);
+    assert(model == NULL);
+    assert(ethervox_stt_model_loaded_count() == 0);
+    assert(ethervox_stt_model_acquire(NULL, fake_load, fake_free, &model) ==
+           ETHERVOX_ERROR_NULL_POINTER);
+
+    // Releasing something the registry does not hold is ignored
+    int unrelated = 0;
+    ethervox_stt_model_release(&unrelated);
+    ethervox_stt_model_release(NULL);
+
+    printf("  ✓ Failed loads leave nothing behind\n");
+}
+
+int main(void) {
+    printf("=== STT Model Registry Unit Tests ===\n\n");
+
+    test_sharing();
+    test_idle_reuse();
+    test_idle_sweeper();
+    test_errors();
+    test_concurrent_load();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_stt_offline.c
+ * @brief Unit tests for offline transcription VAD splitting
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/stt_offline.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 16000
+
+// Low hiss with 220 Hz "speech" in the given [start, end) second ranges
+static float* make_audio(double seconds, const double* ranges, int range_count, uint32_t* count) {
+    *count = (uint32_t)(seconds * RATE);
+    float* audio = (float*)malloc(*count * sizeof(float));
+    assert(audio);
+    unsigned int seed = 1;
+    for (uint32_t i = 0; i < *count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        audio[i] = 0.002f * ((float)((seed >> 16) & 0x7fff) / 16384.0f - 1.0f);
+    }
+    for (int r = 0; r < range_count; r++) {
+        for (uint32_t i = (uint32_t)(ranges[2 * r] * RATE); i < (uint32_t)(ranges[2 * r + 1] * RATE); i++) {
+            audio[i] += 0.3f * sinf(2.0f * 3.14159265f * 220.0f * (float)i / RATE);
+        }
+    }
+    return audio;
+}
+
+static bool covers(const ethervox_stt_offline_span_t* spans, uint32_t n, double start, double end) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (spans[i].start <= start * RATE && spans[i].start + spans[i].length >= end * RATE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_packing(void) {
+    printf("Testing utterance packing...\n");
+
+    const double ranges[] = { 1.0, 3.0, 4.0, 6.0, 20.0, 24.0, 40.0, 42.0 };
+    uint32_t count = 0;
+    float* audio = make_audio(60.0, ranges, 4, &count);
+
+    ethervox_stt_offline_span_t* spans = NULL;
+    uint32_t n = 0;
+    assert(ethervox_is_success(ethervox_stt_offline_split(audio, count, 28000, 300, &spans, &n)));
+
+    // 1-24 s fits one 28 s span; 40-42 s does not
+    assert(n == 2);
+    assert(covers(spans, n, 1.0, 24.0));
+    assert(covers(spans, n, 40.0, 42.0));
+    for (uint32_t i = 0; i < n; i++) {
+        assert(spans[i].length <= 28000u * RATE / 1000);
+        if (i > 0) {
+            assert(spans[i].start >= spans[i - 1].start + spans[i - 1].length);
+        }
+    }
+    // Padding, not the surrounding silence
+    assert(spans[1].start > 39 * RATE && spans[1].start + spans[1].length < 43 * RATE);
+    free(spans);
+
+    // A short limit keeps utterances apart
+    assert(ethervox_is_success(ethervox_stt_offline_split(audio, count, 5000, 300, &spans, &n)));
+    assert(n == 4);
+    free(spans);
+    free(audio);
+
+    printf("  ✓ Utterances are packed up to the segment limit\n");
+}
+
+void test_long_utterance(void) {
+    printf("Testing long utterance cuts...\n");
+
+    // 70 s of unbroken speech must still fit the segment limit
+    const double ranges[] = { 2.0, 72.0 };
+    uint32_t count = 0;
+    float* audio = make_audio(75.0, ranges, 1, &count);
+
+    ethervox_stt_offline_span_t* spans = NULL;
+    uint32_t n = 0;
+    assert(ethervox_is_success(ethervox_stt_offline_split(audio, count, 28000, 300, &spans, &n)));
+    assert(n == 3);
+    uint32_t covered = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        assert(spans[i].length <= 28000u * RATE / 1000);
+        covered += spans[i].length;
+    }
+    assert(covers(spans, n, 2.0, 2.0) && covers(spans, n, 71.9, 72.0));
+    assert(covered >= 70u * RATE);
+    free(spans);
+    free(audio);
+
+    printf("  ✓ Long utterances are cut within the limit\n");
+}
+
+void test_silence_and_arguments(void) {
+    printf("Testing silence and arguments...\n");
+
+    uint32_t count = 0;
+    float* audio = make_audio(10.0, NULL, 0, &count);
+    ethervox_stt_offline_span_t* spans = NULL;
+    uint32_t n = 99;
+    assert(ethervox_is_success(ethervox_stt_offline_split(audio, count, 28000, 300, &spans, &n)));
+    assert(n == 0 && spans == NULL);
+
+    // A 40 ms click is not speech
+    for (uint32_t i = 5 * RATE; i < 5 * RATE + 640; i++) {
+        audio[i] = 0.5f;
+    }
+    assert(ethervox_is_success(ethervox_stt_offline_split(audio, count, 28000, 300, &spans, &n)));
+    assert(n == 0);
+
+    assert(ethervox_stt_offline_split(audio, count, 0, 300, &spans, &n) ==
+           ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(ethervox_stt_offline_split(NULL, count, 28000, 300, &spans, &n) ==
+           ETHERVOX_ERROR_NULL_POINTER);
+    free(audio);
+
+    ethervox_stt_offline_config_t config = ethervox_stt_offline_get_default_config();
+    assert(config.max_segment_ms > 0 && config.min_silence_ms > 0);
+    assert(strcmp(config.language, "auto") == 0);
+
+    printf("  ✓ Silence yields no spans\n");
+}
+
+int main(void) {
+    printf("=== Offline Transcription Unit Tests ===\n\n");
+
+    test_packing();
+    test_long_utterance();
+    test_silence_and_arguments();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file test_tool_args.c
+ * @brief Unit tests for the shared tool argument parser
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/tool_args.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_tokenize(void) {
+    printf("Testing JSON tokenizer...\n");
+
+    const char* json = "{\"a\": [1, \"two\", {\"b\": null}], \"c\": true} trailing";
+    ethervox_json_token_t tokens[16];
+    uint32_t count = 0;
+    ethervox_result_t result = ethervox_json_tokenize(json, strlen(json), tokens, 16, &count);
+    assert(ethervox_is_success(result));
+    assert(count == 10);
+    assert(tokens[0].type == ETHERVOX_JSON_OBJECT);
+    assert(tokens[0].size == 4);
+    assert(tokens[2].type == ETHERVOX_JSON_ARRAY);
+    assert(tokens[2].size == 3);
+    assert(tokens[4].type == ETHERVOX_JSON_STRING);
+    assert(strncmp(json + tokens[4].start, "two", 3) == 0);
+
+    // Malformed and oversized input
+    result = ethervox_json_tokenize("{\"a\": [1, 2}", 12, tokens, 16, &count);
+    assert(result == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    result = ethervox_json_tokenize("{\"a\": \"open", 11, tokens, 16, &count);
+    assert(result == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    result = ethervox_json_tokenize(json, strlen(json), tokens, 4, &count);
+    assert(result == ETHERVOX_ERROR_BUFFER_TOO_SMALL);
+
+    printf("  ✓ Tokenizer works\n");
+}
+
+void test_accessors(void) {
+    printf("Testing typed accessors...\n");
+
+    ethervox_tool_args_t args;
+    ethervox_result_t result = ethervox_tool_args_parse(&args,
+        "{\"text\": \"say \\\"hi\\\"\\nbye \\u00e9\", \"n\": 42, \"id\": \"17\", \"f\": 0.25,"
+        " \"flag\": false, \"tags\": [\"x\", \"\", \"y\"], \"ids\": [3, \"4\", 5],"
+        " \"nested\": {\"text\": \"inner\"}, \"none\": null}");
+    assert(ethervox_is_success(result));
+
+    char buf[64];
+    assert(ethervox_tool_args_get_string(&args, "text", buf, sizeof(buf)));
+    assert(strcmp(buf, "say \"hi\"\nbye \xc3\xa9") == 0);
+
+    // Truncation keeps the buffer terminated
+    char small[4];
+    assert(ethervox_tool_args_get_string(&args, "text", small, sizeof(small)));
+    assert(strcmp(small, "say") == 0);
+
+    int64_t n = 0;
+    assert(ethervox_tool_args_get_int(&args, "n", &n) && n == 42);
+    assert(ethervox_tool_args_get_int(&args, "id", &n) && n == 17);
+    assert(!ethervox_tool_args_get_int(&args, "text", &n));
+    assert(!ethervox_tool_args_get_int(&args, "missing", &n));
+
+    double f = 0.0;
+    assert(ethervox_tool_args_get_double(&args, "f", &f) && f == 0.25);
+
+    bool flag = true;
+    assert(ethervox_tool_args_get_bool(&args, "flag", &flag) && !flag);
+
+    // Keys are only matched at the top level
+    assert(ethervox_tool_args_type(&args, "nested") == ETHERVOX_JSON_OBJECT);
+    assert(!ethervox_tool_args_has(&args, "none"));
+    assert(!ethervox_tool_args_has(&args, "inner"));
+
+    char tags[4][16];
+    assert(ethervox_tool_args_get_string_array(&args, "tags", tags[0], sizeof(tags[0]), 4) == 2);
+    assert(strcmp(tags[0], "x") == 0 && strcmp(tags[1], "y") == 0);
+    assert(ethervox_tool_args_get_string_array(&args, "text", tags[0], sizeof(tags[0]), 4) == 1);
+
+    int64_t ids[2];
+    assert(ethervox_tool_args_get_int_array(&args, "ids", ids, 2) == 2);
+    assert(ids[0] == 3 && ids[1] == 4);
+
+    char* dup = ethervox_tool_args_dup_string(&args, "text");
+    assert(dup && strcmp(dup, buf) == 0);
+    free(dup);
+
+    // Empty input is an empty object
+    result = ethervox_tool_args_parse(&args, "");
+    assert(ethervox_is_success(result));
+    assert(!ethervox_tool_args_has(&args, "text"));
+
+    printf("  ✓ Typed accessors work\n");
+}
+
+typedef struct {
+    int count;
+    uint32_t limit;
+    float weight;
+    bool enabled;
+    char label[8];
+} bind_target_t;
+
+static const ethervox_tool_arg_spec_t bind_spec[] = {
+    ETHERVOX_TOOL_ARG_FIELD("count", bind_target_t, count, ETHERVOX_TOOL_ARG_INT, true),
+    ETHERVOX_TOOL_ARG_FIELD("limit", bind_target_t, limit, ETHERVOX_TOOL_ARG_UINT, false),
+    ETHERVOX_TOOL_ARG_FIELD("weight", bind_target_t, weight, ETHERVOX_TOOL_ARG_REAL, false),
+    ETHERVOX_TOOL_ARG_FIELD("enabled", bind_target_t, enabled, ETHERVOX_TOOL_ARG_BOOL, false),
+    ETHERVOX_TOOL_ARG_FIELD("label", bind_target_t, label, ETHERVOX_TOOL_ARG_STRING, false),
+};
+
+void test_bind(void) {
+    printf("Testing schema binding...\n");
+
+    ethervox_tool_args_t args;
+    bind_target_t target = { .count = 0, .limit = 10, .weight = 1.0f, .enabled = false, .label = "def" };
+    const char* failed = NULL;
+
+    assert(ethervox_is_success(ethervox_tool_args_parse(&args,
+        "{\"count\": -3, \"weight\": 0.5, \"enabled\": \"true\", \"label\": \"truncated\"}")));
+    assert(ethervox_is_success(ethervox_tool_args_bind(&args, bind_spec, 5, &target, &failed)));
+    assert(target.count == -3);
+    assert(target.limit == 10);  // Absent: default kept
+    assert(target.weight == 0.5f);
+    assert(target.enabled);
+    assert(strcmp(target.label, "truncat") == 0);
+
+    // Missing required key
+    assert(ethervox_is_success(ethervox_tool_args_parse(&args, "{\"limit\": 5}")));
+    assert(ethervox_tool_args_bind(&args, bind_spec, 5, &target, &failed) ==
+           ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(strcmp(failed, "count") == 0);
+
+    // Negative value for an unsigned member
+    assert(ethervox_is_success(ethervox_tool_args_parse(&args, "{\"count\": 1, \"limit\": -5}")));
+    assert(ethervox_tool_args_bind(&args, bind_spec, 5, &target, &failed) ==
+           ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(strcmp(failed, "limit") == 0);
+
+    printf("  ✓ Schema binding works\n");
+}
+
+void test_published_view(void) {
+    printf("Testing governor view hand-off...\n");
+
+    const char* call = "{\"name\": \"calc\", \"arguments\": {\"expression\": \"2 + 2\", \"n\": [1, 2]}}";
+    ethervox_tool_args_t envelope;
+    assert(ethervox_is_success(ethervox_tool_args_parse(&envelope, call)));
+
+    char text[128];
+    ethervox_tool_args_t arguments;
+    assert(ethervox_is_success(ethervox_tool_args_object(&envelope, "arguments", text,
+                                                         sizeof(text), &arguments)));
+    assert(strcmp(text, "{\"expression\": \"2 + 2\", \"n\": [1, 2]}") == 0);
+    assert(arguments.token_count == 7);
+
+    // A tool parsing the published text borrows the envelope's tokens
+    ethervox_tool_args_publish(&arguments);
+    ethervox_tool_args_t view;
+    assert(ethervox_is_success(ethervox_tool_args_parse(&view, text)));
+    assert(view.tokens == arguments.tokens);
+    char expr[32];
+    assert(ethervox_tool_args_get_string(&view, "expression", expr, sizeof(expr)));
+    assert(strcmp(expr, "2 + 2") == 0);
+
+    // Any other string is tokenized afresh
+    assert(ethervox_is_success(ethervox_tool_args_parse(&view, "{\"expression\": \"1\"}")));
+    assert(view.tokens == view.storage);
+    ethervox_tool_args_publish(NULL);
+
+    assert(ethervox_tool_args_object(&envelope, "name", text, sizeof(text), &arguments) ==
+           ETHERVOX_ERROR_NOT_FOUND);
+    assert(ethervox_tool_args_object(&envelope, "arguments", text, 8, &arguments) ==
+           ETHERVOX_ERROR_BUFFER_TOO_SMALL);
+
+    printf("  ✓ View hand-off works\n");
+}
+
+void test_growable(void) {
+    printf("Testing heap token growth...\n");
+
+    // More tokens than the fixed storage holds, e.g. a long ID list
+    size_t size = 16 + 8 * 1000;
+    char* json = malloc(size);
+    assert(json);
+    size_t n = (size_t)snprintf(json, size, "{\"node_ids\": [");
+    for (int i = 0; i < 1000; i++) {
+        n += (size_t)snprintf(json + n, size - n, i ? ", %d" : "%d", i);
+    }
+    snprintf(json + n, size - n, "]}");
+
+    ethervox_tool_args_t args;
+    assert(ethervox_tool_args_parse(&args, json) == ETHERVOX_ERROR_BUFFER_TOO_SMALL);
+    assert(ethervox_is_success(ethervox_tool_args_parse_growable(&args, json)));
+    assert(args.heap && args.tokens == args.heap);
+    assert(args.token_count == 1003);
+    int64_t ids[1000];
+    assert(ethervox_tool_args_get_int_array(&args, "node_ids", ids, 1000) == 1000);
+    assert(ids[0] == 0 && ids[999] == 999);
+    ethervox_tool_args_release(&args);
+    assert(!args.heap && args.token_count == 0);
+
+    // Truncated after spilling: still rejected, nothing leaked
+    json[n - 3] = '\0';
+    assert(ethervox_tool_args_parse_growable(&args, json) == ETHERVOX_ERROR_INVALID_ARGUMENT);
+    assert(!args.heap);
+    free(json);
+
+    // Small documents stay in the fixed storage
+    assert(ethervox_is_success(ethervox_tool_args_parse_growable(&args, "{\"a\": 1}")));
+    assert(!args.heap && args.tokens == args.storage);
+    ethervox_tool_args_release(&args);
+
+    // Truncated model output, which the old substring scan accepted, is
+    // rejected instead of running the tool with partial arguments
+    const char* truncated =
+        "{\"name\": \"calculator_compute\", \"arguments\": {\"expression\": \"1+";
+    assert(ethervox_tool_args_parse_growable(&args, truncated) ==
+           ETHERVOX_ERROR_INVALID_ARGUMENT);
+    truncated = "{\"name\": \"calculator_compute\", \"arguments\": {\"expression\": \"1+1\"}";
+    assert(ethervox_tool_args_parse_growable(&args, truncated) ==
+           ETHERVOX_ERROR_INVALID_ARGUMENT);
+
+    printf("  ✓ Heap growth works\n");
+}
+
+void test_escape(void) {
+    printf("Testing JSON escaping...\n");
+
+    // Round-trips an unescaped argument back into a valid document
+    ethervox_tool_args_t args;
+    const char* json = "{\"expression\": \"\\\"1\\\\2\\n\\u0001\\\"\"}";
+    assert(ethervox_is_success(ethervox_tool_args_parse(&args, json)));
+    char* raw = ethervox_tool_args_dup_string(&args, "expression");
+    assert(raw && strcmp(raw, "\"1\\2\n\x01\"") == 0);
+
+    char* escaped = ethervox_json_escape(raw);
+    assert(escaped && strcmp(escaped, "\\\"1\\\\2\\n\\u0001\\\"") == 0);
+
+    char echo[128];
+    snprintf(echo, sizeof(echo), "{\"expression\": \"%s\"}", escaped);
+    ethervox_tool_args_t round_trip;
+    assert(ethervox_is_success(ethervox_tool_args_parse(&round_trip, echo)));
+    char* again = ethervox_tool_args_dup_string(&round_trip, "expression");
+    assert(again && strcmp(again, raw) == 0);
+    free(raw);
+    free(escaped);
+    free(again);
+
+    escaped = ethervox_json_escape(NULL);
+    assert(escaped && escaped[0] == '\0');
+    free(escaped);
+
+    printf("  ✓ Escaping works\n");
+}
+
+int main(void) {
+    printf("=== Tool Argument Parser Unit Tests ===\n\n");
+
+    test_tokenize();
+    test_accessors();
+    test_bind();
+    test_published_view();
+    test_growable();
+    test_escape();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
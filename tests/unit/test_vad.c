@@ -0,0 +1,240 @@
+/**
+ * @file test_vad.c
+ * @brief Unit tests for the shared frame-level VAD
+ *
+ * Copyright (c) 2024-2025 EthervoxAI Team
+ * SPDX-License-Identifier: CC-BY-NC-SA-4.0
+ */
+
+#include "ethervox/vad.h"
+#include "ethervox/config.h"
+#include "ethervox/error.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 16000
+#define PI_F 3.14159265f
+
+static uint32_t g_seed = 12345;
+
+static float noise_sample(float amplitude) {
+    g_seed = g_seed * 1103515245u + 12345u;
+    return amplitude * (((float)((g_seed >> 8) & 0xFFFF) / 32768.0f) - 1.0f);
+}
+
+/**
+ * Low-frequency harmonic tone (voiced-speech-like) over a noise bed
+ */
+static void synth(float* out, uint32_t count, float tone, float noise) {
+    for (uint32_t n = 0; n < count; n++) {
+        float t = (float)n / RATE;
+        float s = sinf(2.0f * PI_F * 150.0f * t) + 0.5f * sinf(2.0f * PI_F * 300.0f * t) +
+                  0.25f * sinf(2.0f * PI_F * 450.0f * t);
+        out[n] = tone * s + noise_sample(noise);
+    }
+}
+
+void test_features(void) {
+    printf("Testing frame features...\n");
+
+    float frame[480];
+    ethervox_vad_frame_t f;
+
+    for (int i = 0; i < 480; i++) frame[i] = 0.5f * sinf(2.0f * PI_F * 200.0f * i / RATE);
+    ethervox_vad_frame_features(frame, 480, 0.0f, &f);
+    assert(fabsf(f.rms - 0.5f / sqrtf(2.0f)) < 0.01f);
+    assert(fabsf(f.log_energy - 10.0f * log10f(0.125f)) < 0.2f);
+    assert(f.tilt < 0.05f);
+    // 200 Hz crosses zero 400 times a second
+    assert(fabsf(f.zcr - 400.0f / RATE) < 0.005f);
+
+    for (int i = 0; i < 480; i++) frame[i] = noise_sample(0.5f);
+    ethervox_vad_frame_features(frame, 480, 0.0f, &f);
+    assert(f.tilt > 0.8f && f.tilt < 1.2f);
+    assert(f.zcr > 0.4f);
+
+    // Odd lengths exercise the scalar tail
+    for (int i = 0; i < 37; i++) frame[i] = (i % 2) ? 0.25f : -0.25f;
+    ethervox_vad_frame_features(frame, 37, 0.25f, &f);
+    assert(fabsf(f.rms - 0.25f) < 1e-4f);
+    assert(fabsf(f.zcr - 1.0f) < 1e-4f);
+
+    memset(frame, 0, sizeof(frame));
+    ethervox_vad_frame_features(frame, 480, 0.0f, &f);
+    assert(f.rms == 0.0f && f.tilt == 0.0f);
+    printf("  ✓ RMS, log-energy, ZCR and tilt\n");
+}
+
+void test_speech_probability(void) {
+    printf("Testing speech probabilities and hangover...\n");
+
+    float* audio = (float*)malloc(2 * RATE * sizeof(float));
+    assert(audio != NULL);
+    ethervox_vad_t* vad = ethervox_vad_create(NULL);
+    assert(vad != NULL);
+    const uint32_t frame = ethervox_vad_frame_samples(vad);
+    assert(frame == RATE * ETHERVOX_VAD_FRAME_MS / 1000);
+
+    // 1 s of background, 0.5 s of tone, 0.5 s of background
+    synth(audio, RATE, 0.0f, 0.005f);
+    synth(audio + RATE, RATE / 2, 0.1f, 0.005f);
+    synth(audio + RATE + RATE / 2, RATE / 2, 0.0f, 0.005f);
+
+    const ethervox_vad_frame_t* frames = NULL;
+    uint32_t count = 0;
+    assert(ethervox_vad_process(vad, audio, 2 * RATE, &frames, &count) == ETHERVOX_SUCCESS);
+    assert(count == 2 * RATE / frame);
+    assert(frames[count - 1].end_offset == count * frame);
+
+    uint32_t tone_start = RATE / frame;
+    uint32_t tone_end = (RATE + RATE / 2) / frame;
+    uint32_t hangover = ETHERVOX_VAD_HANGOVER_MS / ETHERVOX_VAD_FRAME_MS;
+    for (uint32_t i = 5; i < tone_start; i++) {
+        assert(frames[i].probability < 0.2f);
+        assert(!frames[i].voiced && !frames[i].is_speech);
+    }
+    for (uint32_t i = tone_start + 1; i < tone_end; i++) {
+        assert(frames[i].probability > 0.9f);
+        assert(frames[i].voiced && frames[i].is_speech);
+    }
+    for (uint32_t i = tone_end + 1; i < count; i++) {
+        assert(!frames[i].voiced);
+        assert(frames[i].is_speech == (i < tone_end + hangover));
+    }
+
+    // The floor stays at the background level through the tone
+    assert(frames[tone_end - 1].noise_floor < 0.01f);
+    assert(frames[count - 1].noise_floor < 0.01f);
+
+    free(audio);
+    ethervox_vad_destroy(vad);
+    printf("  ✓ Tone is speech, background is not, hangover holds %u frames\n", hangover);
+}
+
+void test_noise_floor_adaptation(void) {
+    printf("Testing noise floor adaptation...\n");
+
+    float* audio = (float*)malloc(3 * RATE * sizeof(float));
+    assert(audio != NULL);
+    ethervox_vad_t* vad = ethervox_vad_create(NULL);
+    assert(vad != NULL);
+
+    // Quiet room, then a fan switches on: louder, but flat and steady
+    synth(audio, RATE, 0.0f, 0.002f);
+    synth(audio + RATE, 2 * RATE, 0.0f, 0.04f);
+
+    const ethervox_vad_frame_t* frames = NULL;
+    uint32_t count = 0;
+    assert(ethervox_vad_process(vad, audio, 3 * RATE, &frames, &count) == ETHERVOX_SUCCESS);
+    const ethervox_vad_frame_t* last = &frames[count - 1];
+    assert(last->noise_floor > 0.015f);
+    assert(!last->voiced && !last->is_speech);
+
+    // A stream that opens with loud audio recovers at the first quiet frame
+    ethervox_vad_reset(vad);
+    synth(audio, RATE / 2, 0.2f, 0.0f);
+    synth(audio + RATE / 2, RATE / 2, 0.0f, 0.002f);
+    assert(ethervox_vad_process(vad, audio, RATE, &frames, &count) == ETHERVOX_SUCCESS);
+    assert(frames[count - 1].noise_floor < 0.005f);
+
+    free(audio);
+    ethervox_vad_destroy(vad);
+    printf("  ✓ Floor follows a rising background and drops to quiet frames\n");
+}
+
+void test_frame_lengths_and_streaming(void) {
+    printf("Testing 10/20/30 ms frames and partial-frame carry...\n");
+
+    float* audio = (float*)malloc(RATE * sizeof(float));
+    assert(audio != NULL);
+    synth(audio, RATE, 0.1f, 0.005f);
+
+    const uint32_t lengths[] = {10, 20, 30};
+    for (int l = 0; l < 3; l++) {
+        ethervox_vad_config_t config = ethervox_vad_get_default_config();
+        config.frame_ms = lengths[l];
+        ethervox_vad_t* whole = ethervox_vad_create(&config);
+        ethervox_vad_t* pieces = ethervox_vad_create(&config);
+        assert(whole && pieces);
+        assert(ethervox_vad_frame_samples(whole) == RATE * lengths[l] / 1000);
+
+        const ethervox_vad_frame_t* frames = NULL;
+        uint32_t count = 0;
+        assert(ethervox_vad_process(whole, audio, RATE, &frames, &count) == ETHERVOX_SUCCESS);
+        ethervox_vad_frame_t* expected = (ethervox_vad_frame_t*)malloc(count * sizeof(*expected));
+        assert(expected != NULL);
+        memcpy(expected, frames, count * sizeof(*expected));
+
+        // Odd-sized chunks must give the same frames
+        uint32_t seen = 0;
+        for (uint32_t pos = 0; pos < RATE; pos += 333) {
+            uint32_t n = RATE - pos < 333 ? RATE - pos : 333;
+            uint32_t got = 0;
+            assert(ethervox_vad_process(pieces, audio + pos, n, &frames, &got) == ETHERVOX_SUCCESS);
+            for (uint32_t i = 0; i < got; i++, seen++) {
+                assert(fabsf(frames[i].rms - expected[seen].rms) < 1e-5f);
+                assert(frames[i].voiced == expected[seen].voiced);
+                assert(frames[i].end_offset > 0 && frames[i].end_offset <= n);
+            }
+        }
+        assert(seen == count);
+
+        free(expected);
+        ethervox_vad_destroy(whole);
+        ethervox_vad_destroy(pieces);
+    }
+
+    ethervox_vad_config_t bad = ethervox_vad_get_default_config();
+    bad.frame_ms = 25;
+    assert(ethervox_vad_create(&bad) == NULL);
+
+    free(audio);
+    printf("  ✓ Chunked input matches whole-buffer analysis for every frame length\n");
+}
+
+void test_frame_handoff(void) {
+    printf("Testing frames handed to downstream consumers...\n");
+
+    float audio[1000];
+    synth(audio, 1000, 0.1f, 0.005f);
+
+    ethervox_vad_t* vad = ethervox_vad_create(NULL);
+    assert(vad != NULL);
+    const uint32_t n = ethervox_vad_frame_samples(vad);
+
+    // Every call analyzes its samples once; consumers get the frames, not the audio
+    const ethervox_vad_frame_t* frames = NULL;
+    uint32_t count = 0;
+    assert(ethervox_vad_process(vad, audio, 1000, &frames, &count) == ETHERVOX_SUCCESS);
+    assert(count == 1000 / n);
+    assert(ethervox_vad_frames_analyzed(vad) == count);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(frames[i].length == n);
+        assert(frames[i].end_offset == (i + 1) * n);
+    }
+
+    // The partial frame completes on the next call, with its end in that buffer
+    assert(ethervox_vad_process(vad, audio, n, &frames, &count) == ETHERVOX_SUCCESS);
+    assert(count == 1 && frames[0].length == n && frames[0].end_offset == n - 1000 % n);
+    assert(ethervox_vad_frames_analyzed(vad) == 1000 / n + 1);
+
+    assert(ethervox_vad_process(NULL, audio, n, &frames, &count) == ETHERVOX_ERROR_NULL_POINTER);
+    ethervox_vad_destroy(vad);
+    printf("  ✓ Frames carry their length and end offset\n");
+}
+
+int main(void) {
+    printf("=== VAD Unit Tests ===\n\n");
+
+    test_features();
+    test_speech_probability();
+    test_noise_floor_adaptation();
+    test_frame_lengths_and_streaming();
+    test_frame_handoff();
+
+    printf("\n=== All tests passed! ===\n");
+    return ETHERVOX_SUCCESS;
+}
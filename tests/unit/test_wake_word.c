@@ -197,6 +197,14 @@ static int test_wake_word_errors(void) {
     result = ethervox_wake_process(&runtime, &buffer, NULL);
     assert(result != 0);
     
+    // Frames from the stream's VAD: a count without frames is rejected,
+    // a buffer that completed no frame is fine
+    memset(audio, 0, sizeof(audio));
+    result = ethervox_wake_process_frames(&runtime, &buffer, NULL, 2, &wake_result);
+    assert(result != 0);
+    result = ethervox_wake_process_frames(&runtime, &buffer, NULL, 0, &wake_result);
+    assert(result == 0 && !wake_result.detected);
+    
     ethervox_wake_cleanup(&runtime);
     
     printf("PASS\n");